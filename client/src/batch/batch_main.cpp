@@ -0,0 +1,363 @@
+/*
+ * VEX IQ Batch Runner
+ *
+ * Runs one scene many times with parameters from a sweep spec (parameter
+ * grid and/or random draws, see batch/sweep.h) and writes per-run summary
+ * metrics: final robot poses, contact counts, cylinder positions, sim time.
+ *
+ * The scene is loaded once into a template world. Every run steps a shared
+ * world built from it (sim_world_create_shared), so runs read nothing from
+ * disk and meshes, part OBBs and robotdefs exist once. Runs are spread over
+ * a job system with one world per thread, reused run after run: memory
+ * grows with --jobs, not with the number of runs. Each world steps serially,
+ * so results do not depend on --jobs.
+ *
+ * Robots drive with constant motor percentages from the spec
+ * (robotN.left / robotN.right / robotN.strafe); robot programs are not run.
+ *
+ * Usage:
+ *   vexiq_batch <scene_file> <sweep_file> [--out <file.csv|file.json>] [--jobs <n>] [--models <dir>]
+ */
+
+#include "../sim/sim_world.h"
+#include "../sim/job_system.h"
+#include "../scene/scene.h"
+#include "sweep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#define PATH_SEP "\\"
+#else
+#include <unistd.h>
+#include <libgen.h>
+#define PATH_SEP "/"
+#endif
+
+#define BATCH_DEFAULT_OUT "batch_results.csv"
+#define RAD_TO_DEG_CONST (180.0f / 3.14159265359f)
+#define BATCH_ROBOT_MOTORS 3  // Motor floats per robot (left, right, strafe %)
+
+// Final state of one robot
+struct BatchRobotResult {
+    float x, z, heading;          // Inches, degrees
+    uint32_t wall_contacts;       // Steps with a contact of each kind
+    uint32_t robot_contacts;
+    uint32_t cylinder_contacts;
+};
+
+// Summary of one run
+struct BatchRunResult {
+    float values[SWEEP_MAX_PARAMS];           // Swept parameters (SweepSpec order)
+    std::vector<BatchRobotResult> robots;     // Indexed like the template's robots
+    std::vector<float> cylinders;             // Final x, z per cylinder
+    double sim_time;
+    uint64_t steps;
+    double wall_ms;
+};
+
+struct BatchContext {
+    const Scene* scene;
+    const SweepSpec* spec;
+    const SimWorld* templ;
+    std::vector<SimWorld>* worlds;            // One per job thread
+    std::vector<Scene>* scenes;               // One per job thread: the scene of its run
+    std::vector<BatchRunResult>* results;     // One per run
+};
+
+// Get the directory containing the executable
+static void get_exe_dir(char* buffer, size_t size) {
+#ifdef _WIN32
+    GetModuleFileNameA(NULL, buffer, (DWORD)size);
+    char* last_sep = strrchr(buffer, '\\');
+    if (last_sep) *last_sep = '\0';
+#else
+    ssize_t len = readlink("/proc/self/exe", buffer, size - 1);
+    if (len > 0) {
+        buffer[len] = '\0';
+        char* dir = dirname(buffer);
+        memmove(buffer, dir, strlen(dir) + 1);
+    } else {
+        buffer[0] = '.';
+        buffer[1] = '\0';
+    }
+#endif
+}
+
+// Check robot/cylinder indices of the spec against the scene
+static bool validate_spec(const SweepSpec* spec, const Scene* scene) {
+    bool ok = true;
+    for (int p = 0; p < spec->param_count; p++) {
+        const SweepParam* param = &spec->params[p];
+        bool cylinder = param->target == SWEEP_CYLINDER_X || param->target == SWEEP_CYLINDER_Z;
+        bool robot = param->target >= SWEEP_ROBOT_X && param->target <= SWEEP_ROBOT_STRAFE;
+        if ((robot && param->index >= (int)scene->robot_count) ||
+            (cylinder && param->index >= (int)scene->cylinder_count)) {
+            fprintf(stderr, "[Batch] '%s': the scene has %u %s\n", param->name,
+                    robot ? scene->robot_count : scene->cylinder_count, robot ? "robots" : "cylinders");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Build, step and summarize one run in world
+static void run_one(const BatchContext* ctx, uint32_t run, SimWorld* world, Scene* run_scene) {
+    const SweepSpec* spec = ctx->spec;
+    BatchRunResult* result = &(*ctx->results)[run];
+    auto wall_start = std::chrono::steady_clock::now();
+
+    // Parameters that live in the scene go in before the world is built
+    sweep_run_values(spec, run, result->values);
+    Scene& scene = *run_scene;
+    scene_copy(&scene, ctx->scene);
+    std::vector<float> motors(scene.robot_count * BATCH_ROBOT_MOTORS, 0.0f);
+    for (int p = 0; p < spec->param_count; p++) {
+        const SweepParam* param = &spec->params[p];
+        float v = result->values[p];
+        switch (param->target) {
+            case SWEEP_FRICTION: scene.physics.friction_coeff = v; break;
+            case SWEEP_ROBOT_X: scene.robots[param->index].x = v; break;
+            case SWEEP_ROBOT_Z: scene.robots[param->index].z = v; break;
+            case SWEEP_ROBOT_ROTATION: scene.robots[param->index].rotation_y = v; break;
+            case SWEEP_ROBOT_LEFT: motors[param->index * BATCH_ROBOT_MOTORS] = v; break;
+            case SWEEP_ROBOT_RIGHT: motors[param->index * BATCH_ROBOT_MOTORS + 1] = v; break;
+            case SWEEP_ROBOT_STRAFE: motors[param->index * BATCH_ROBOT_MOTORS + 2] = v; break;
+            case SWEEP_CYLINDER_X: scene.cylinders[param->index].x = v; break;
+            case SWEEP_CYLINDER_Z: scene.cylinders[param->index].z = v; break;
+            default: break;
+        }
+    }
+    sim_world_create_shared(world, ctx->templ, &scene);
+
+    // Drivetrain tuning and motor commands per robot
+    for (int i = 0; i < sim_world_robot_count(world); i++) {
+        RobotInstance* robot = &world->robots[i];
+        for (int p = 0; p < spec->param_count; p++) {
+            if (spec->params[p].target == SWEEP_FORWARD_SPEED_SCALE) {
+                robot->drivetrain.config.forward_speed_scale = result->values[p];
+            } else if (spec->params[p].target == SWEEP_TURN_SPEED_SCALE) {
+                robot->drivetrain.config.turn_speed_scale = result->values[p];
+            }
+        }
+        const float* robot_motors = &motors[robot->scene_index * BATCH_ROBOT_MOTORS];
+        sim_world_set_motors(world, i, robot_motors[0], robot_motors[1]);
+        sim_world_set_strafe(world, i, robot_motors[2]);
+    }
+    sim_world_update_drivetrains(world);
+
+    uint64_t step_count = (uint64_t)ceil(spec->duration / spec->dt);
+    for (uint64_t step = 0; step < step_count; step++) {
+        sim_world_step(world, spec->dt);
+    }
+
+    result->robots.resize(world->robots.size());
+    for (int i = 0; i < sim_world_robot_count(world); i++) {
+        const RobotInstance* robot = &world->robots[i];
+        BatchRobotResult* out = &result->robots[i];
+        float heading;
+        sim_world_get_robot_pose(world, i, &out->x, &out->z, &heading);
+        out->heading = heading * RAD_TO_DEG_CONST;
+        out->wall_contacts = robot->wall_contact_steps;
+        out->robot_contacts = robot->robot_contact_steps;
+        out->cylinder_contacts = robot->cylinder_contact_steps;
+    }
+    result->cylinders.resize(sim_world_cylinder_count(world) * 2);
+    for (uint32_t c = 0; c < sim_world_cylinder_count(world); c++) {
+        const SceneCylinder* cyl = sim_world_get_cylinder(world, c);
+        result->cylinders[c * 2] = cyl->x;
+        result->cylinders[c * 2 + 1] = cyl->z;
+    }
+    result->sim_time = world->time;
+    result->steps = world->step_count;
+    result->wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+}
+
+static void run_job(void* user_data, int begin, int end, int thread) {
+    const BatchContext* ctx = (const BatchContext*)user_data;
+    for (int run = begin; run < end; run++) {
+        run_one(ctx, (uint32_t)run, &(*ctx->worlds)[thread], &(*ctx->scenes)[thread]);
+    }
+}
+
+// One row per run; robots are named by scene index
+static void write_csv(FILE* out, const BatchContext* ctx) {
+    const SweepSpec* spec = ctx->spec;
+    const SimWorld* templ = ctx->templ;
+
+    fprintf(out, "run");
+    for (int p = 0; p < spec->param_count; p++) fprintf(out, ",%s", spec->params[p].name);
+    fprintf(out, ",sim_time,steps,wall_ms");
+    for (const RobotInstance& robot : templ->robots) {
+        int r = robot.scene_index;
+        fprintf(out, ",robot%d_x,robot%d_z,robot%d_heading,robot%d_wall_contacts,robot%d_robot_contacts,robot%d_cylinder_contacts",
+                r, r, r, r, r, r);
+    }
+    for (uint32_t c = 0; c < ctx->scene->cylinder_count; c++) fprintf(out, ",cylinder%u_x,cylinder%u_z", c, c);
+    fprintf(out, "\n");
+
+    for (size_t run = 0; run < ctx->results->size(); run++) {
+        const BatchRunResult* result = &(*ctx->results)[run];
+        fprintf(out, "%zu", run);
+        for (int p = 0; p < spec->param_count; p++) fprintf(out, ",%g", result->values[p]);
+        fprintf(out, ",%.4f,%llu,%.3f", result->sim_time, (unsigned long long)result->steps, result->wall_ms);
+        for (size_t i = 0; i < templ->robots.size(); i++) {
+            const BatchRobotResult* robot = &result->robots[i];
+            fprintf(out, ",%.4f,%.4f,%.3f,%u,%u,%u", robot->x, robot->z, robot->heading,
+                    robot->wall_contacts, robot->robot_contacts, robot->cylinder_contacts);
+        }
+        for (uint32_t c = 0; c < ctx->scene->cylinder_count; c++) {
+            fprintf(out, ",%.4f,%.4f", result->cylinders[c * 2], result->cylinders[c * 2 + 1]);
+        }
+        fprintf(out, "\n");
+    }
+}
+
+// {"scene": ..., "runs": [{"run", "params", "sim_time", "steps", "wall_ms", "robots", "cylinders"}]}
+static void write_json(FILE* out, const BatchContext* ctx, const char* scene_path, const char* sweep_path) {
+    const SweepSpec* spec = ctx->spec;
+    const SimWorld* templ = ctx->templ;
+
+    // Paths are written as given; escape the characters JSON reserves
+    fprintf(out, "{\n  \"scene\": \"");
+    for (const char* c = scene_path; *c; c++) fprintf(out, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+    fprintf(out, "\",\n  \"sweep\": \"");
+    for (const char* c = sweep_path; *c; c++) fprintf(out, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+    fprintf(out, "\",\n  \"runs\": [\n");
+
+    for (size_t run = 0; run < ctx->results->size(); run++) {
+        const BatchRunResult* result = &(*ctx->results)[run];
+        fprintf(out, "    {\"run\": %zu, \"params\": {", run);
+        for (int p = 0; p < spec->param_count; p++) {
+            fprintf(out, "%s\"%s\": %g", p ? ", " : "", spec->params[p].name, result->values[p]);
+        }
+        fprintf(out, "}, \"sim_time\": %.4f, \"steps\": %llu, \"wall_ms\": %.3f,\n     \"robots\": [",
+                result->sim_time, (unsigned long long)result->steps, result->wall_ms);
+        for (size_t i = 0; i < templ->robots.size(); i++) {
+            const BatchRobotResult* robot = &result->robots[i];
+            fprintf(out, "%s{\"scene_index\": %d, \"x\": %.4f, \"z\": %.4f, \"heading\": %.3f, "
+                         "\"wall_contacts\": %u, \"robot_contacts\": %u, \"cylinder_contacts\": %u}",
+                    i ? ", " : "", templ->robots[i].scene_index, robot->x, robot->z, robot->heading,
+                    robot->wall_contacts, robot->robot_contacts, robot->cylinder_contacts);
+        }
+        fprintf(out, "],\n     \"cylinders\": [");
+        for (uint32_t c = 0; c < ctx->scene->cylinder_count; c++) {
+            fprintf(out, "%s{\"x\": %.4f, \"z\": %.4f}", c ? ", " : "", result->cylinders[c * 2], result->cylinders[c * 2 + 1]);
+        }
+        fprintf(out, "]}%s\n", run + 1 < ctx->results->size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void print_usage(const char* exe) {
+    printf("Usage: %s <scene_file> <sweep_file> [--out <file>] [--jobs <n>] [--models <dir>]\n", exe);
+    printf("  --out <file>    Results file, CSV or JSON by extension (default %s)\n", BATCH_DEFAULT_OUT);
+    printf("  --jobs <n>      Worlds stepped at once (default: hardware threads)\n");
+    printf("  --models <dir>  Directory with robots/ and parts/ (default: ../../models next to the executable)\n");
+}
+
+int main(int argc, char** argv) {
+    const char* scene_path = NULL;
+    const char* sweep_path = NULL;
+    const char* out_path = BATCH_DEFAULT_OUT;
+    const char* models_arg = NULL;
+    int job_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            job_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--models") == 0 && i + 1 < argc) {
+            models_arg = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] == '-' || (scene_path && sweep_path)) {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        } else if (!scene_path) {
+            scene_path = argv[i];
+        } else {
+            sweep_path = argv[i];
+        }
+    }
+    if (!scene_path || !sweep_path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Scene scene;
+    SweepSpec spec;
+    if (!scene_load(scene_path, &scene) || !sweep_load(sweep_path, &spec) || !validate_spec(&spec, &scene)) {
+        return 1;
+    }
+
+    char models_dir[600];
+    if (models_arg) {
+        snprintf(models_dir, sizeof(models_dir), "%s", models_arg);
+    } else {
+        char exe_dir[512];
+        get_exe_dir(exe_dir, sizeof(exe_dir));
+        snprintf(models_dir, sizeof(models_dir), "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "models", exe_dir);
+    }
+
+    // Load the scene once; every run shares its read-only data
+    static SimWorld templ;
+    sim_world_set_threads(&templ, 1);
+    sim_world_create(&templ, &scene, models_dir, NULL);
+    if (templ.robots.empty()) {
+        fprintf(stderr, "[Batch] No robots loaded from %s\n", scene_path);
+        sim_world_destroy(&templ);
+        return 1;
+    }
+
+    uint32_t run_count = sweep_run_count(&spec);
+    JobSystem* jobs = job_system_create(job_count);
+    int thread_count = job_system_thread_count(jobs);
+    std::vector<SimWorld> worlds(thread_count);
+    for (SimWorld& world : worlds) sim_world_set_threads(&world, 1);
+    std::vector<Scene> run_scenes(thread_count, Scene{});
+    std::vector<BatchRunResult> results(run_count);
+
+    printf("\n[Batch] %u run%s of %.2f s at dt=%.5f s on %d thread%s\n", run_count, run_count == 1 ? "" : "s",
+           spec.duration, spec.dt, thread_count, thread_count == 1 ? "" : "s");
+
+    auto wall_start = std::chrono::steady_clock::now();
+    BatchContext ctx = { &scene, &spec, &templ, &worlds, &run_scenes, &results };
+    job_system_parallel_for(jobs, (int)run_count, 1, run_job, &ctx);
+    double wall_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    printf("[Batch] Done in %.3f s wall (%.1f runs/s)\n", wall_sec, wall_sec > 0.0 ? run_count / wall_sec : 0.0);
+
+    for (SimWorld& world : worlds) sim_world_destroy(&world);
+    for (Scene& run_scene : run_scenes) scene_free(&run_scene);
+    job_system_destroy(jobs);
+
+    FILE* out = fopen(out_path, "w");
+    bool written = out != NULL;
+    if (out) {
+        const char* ext = strrchr(out_path, '.');
+        if (ext && strcmp(ext, ".json") == 0) {
+            write_json(out, &ctx, scene_path, sweep_path);
+        } else {
+            write_csv(out, &ctx);
+        }
+        written = fclose(out) == 0;
+    }
+    if (written) {
+        printf("[Batch] Wrote %s\n", out_path);
+    } else {
+        fprintf(stderr, "[Batch] Failed to write %s\n", out_path);
+    }
+
+    sim_world_destroy(&templ);
+    scene_free(&scene);
+    return written ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+/*
+ * Sweep Spec Loader Implementation
+ * Parses YAML-like sweep files (same layout rules as .scene files)
+ */
+
+#include "sweep.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// Trim leading/trailing whitespace in place
+static char* trim(char* str) {
+    while (isspace((unsigned char)*str)) str++;
+    if (*str == 0) return str;
+    char* end = str + strlen(str) - 1;
+    while (end > str && isspace((unsigned char)*end)) end--;
+    end[1] = '\0';
+    return str;
+}
+
+// Parse array like [0.6, 0.7, 0.8]; a bare number counts as one value
+static int parse_values(const char* str, float* out, int max_count) {
+    if (*str != '[') {
+        char* end;
+        out[0] = strtof(str, &end);
+        return end != str ? 1 : 0;
+    }
+    str++;
+
+    int count = 0;
+    while (*str && *str != ']' && count < max_count) {
+        while (*str && (isspace((unsigned char)*str) || *str == ',')) str++;
+        if (*str == ']') break;
+
+        char* end;
+        out[count] = strtof(str, &end);
+        if (end == str) break;
+        count++;
+        str = end;
+    }
+    return count;
+}
+
+// Map a parameter name to its target; false if unknown
+static bool parse_target(const char* name, SweepParam* param) {
+    param->index = 0;
+    if (strcmp(name, "friction") == 0) { param->target = SWEEP_FRICTION; return true; }
+    if (strcmp(name, "forward_speed_scale") == 0) { param->target = SWEEP_FORWARD_SPEED_SCALE; return true; }
+    if (strcmp(name, "turn_speed_scale") == 0) { param->target = SWEEP_TURN_SPEED_SCALE; return true; }
+
+    int index, consumed = 0;
+    if (sscanf(name, "robot%d.%n", &index, &consumed) == 1 && consumed > 0 && index >= 0) {
+        const char* field = name + consumed;
+        param->index = index;
+        if (strcmp(field, "x") == 0) { param->target = SWEEP_ROBOT_X; return true; }
+        if (strcmp(field, "z") == 0) { param->target = SWEEP_ROBOT_Z; return true; }
+        if (strcmp(field, "rotation") == 0) { param->target = SWEEP_ROBOT_ROTATION; return true; }
+        if (strcmp(field, "left") == 0) { param->target = SWEEP_ROBOT_LEFT; return true; }
+        if (strcmp(field, "right") == 0) { param->target = SWEEP_ROBOT_RIGHT; return true; }
+        if (strcmp(field, "strafe") == 0) { param->target = SWEEP_ROBOT_STRAFE; return true; }
+        return false;
+    }
+    if (sscanf(name, "cylinder%d.%n", &index, &consumed) == 1 && consumed > 0 && index >= 0) {
+        const char* field = name + consumed;
+        param->index = index;
+        if (strcmp(field, "x") == 0) { param->target = SWEEP_CYLINDER_X; return true; }
+        if (strcmp(field, "z") == 0) { param->target = SWEEP_CYLINDER_Z; return true; }
+        return false;
+    }
+    return false;
+}
+
+bool sweep_load(const char* path, SweepSpec* spec) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "[Sweep] Failed to open: %s\n", path);
+        return false;
+    }
+
+    memset(spec, 0, sizeof(SweepSpec));
+    spec->duration = 120.0;
+    spec->dt = 1.0f / 60.0f;
+    spec->samples = 1;
+    spec->seed = 1;
+
+    char line[512];
+    int line_num = 0;
+    bool in_section = false;
+    SweepMode mode = SWEEP_SET;
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_num++;
+
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        bool indented = line[0] == ' ' || line[0] == '\t';
+        char* trimmed = trim(line);
+        if (trimmed[0] == '\0') continue;
+
+        char* colon = strchr(trimmed, ':');
+        if (!colon) {
+            fprintf(stderr, "[Sweep] %s:%d: expected key: value\n", path, line_num);
+            ok = false;
+            continue;
+        }
+        *colon = '\0';
+        char* key = trim(trimmed);
+        char* value = trim(colon + 1);
+
+        // Top-level settings and section headers
+        if (!indented) {
+            in_section = false;
+            if (strcmp(key, "duration") == 0) spec->duration = atof(value);
+            else if (strcmp(key, "dt") == 0) spec->dt = (float)atof(value);
+            else if (strcmp(key, "samples") == 0) spec->samples = (uint32_t)strtoul(value, NULL, 10);
+            else if (strcmp(key, "seed") == 0) spec->seed = strtoull(value, NULL, 10);
+            else if (strcmp(key, "grid") == 0) { in_section = true; mode = SWEEP_GRID; }
+            else if (strcmp(key, "random") == 0) { in_section = true; mode = SWEEP_RANDOM; }
+            else if (strcmp(key, "set") == 0) { in_section = true; mode = SWEEP_SET; }
+            else {
+                fprintf(stderr, "[Sweep] %s:%d: unknown setting '%s'\n", path, line_num, key);
+                ok = false;
+            }
+            continue;
+        }
+
+        // Parameters inside grid/random/set
+        if (!in_section) {
+            fprintf(stderr, "[Sweep] %s:%d: parameter outside a grid/random/set section\n", path, line_num);
+            ok = false;
+            continue;
+        }
+        if (spec->param_count >= SWEEP_MAX_PARAMS) {
+            fprintf(stderr, "[Sweep] %s:%d: too many parameters (max %d)\n", path, line_num, SWEEP_MAX_PARAMS);
+            ok = false;
+            continue;
+        }
+
+        SweepParam* param = &spec->params[spec->param_count];
+        memset(param, 0, sizeof(SweepParam));
+        strncpy(param->name, key, SWEEP_MAX_NAME - 1);
+        param->mode = mode;
+        if (!parse_target(key, param)) {
+            fprintf(stderr, "[Sweep] %s:%d: unknown parameter '%s'\n", path, line_num, key);
+            ok = false;
+            continue;
+        }
+        for (int p = 0; p < spec->param_count; p++) {
+            if (strcmp(spec->params[p].name, param->name) == 0) {
+                fprintf(stderr, "[Sweep] %s:%d: '%s' given twice\n", path, line_num, key);
+                ok = false;
+            }
+        }
+
+        param->value_count = parse_values(value, param->values, SWEEP_MAX_VALUES);
+        int expected = mode == SWEEP_SET ? 1 : mode == SWEEP_RANDOM ? 2 : -1;
+        if (param->value_count == 0 || (expected > 0 && param->value_count != expected)) {
+            fprintf(stderr, "[Sweep] %s:%d: '%s' needs %s\n", path, line_num, key,
+                    mode == SWEEP_SET ? "one value" : mode == SWEEP_RANDOM ? "[min, max]" : "a list of values");
+            ok = false;
+            continue;
+        }
+        spec->param_count++;
+    }
+
+    fclose(file);
+
+    if (spec->duration <= 0.0 || spec->dt <= 0.0f || spec->dt > 0.1f || spec->samples == 0) {
+        fprintf(stderr, "[Sweep] %s: duration must be > 0, dt in (0, 0.1], samples >= 1\n", path);
+        ok = false;
+    }
+    return ok;
+}
+
+uint32_t sweep_run_count(const SweepSpec* spec) {
+    uint64_t count = spec->samples;
+    for (int p = 0; p < spec->param_count; p++) {
+        if (spec->params[p].mode == SWEEP_GRID) count *= (uint64_t)spec->params[p].value_count;
+    }
+    return count > UINT32_MAX ? UINT32_MAX : (uint32_t)count;
+}
+
+// SplitMix64: one well-mixed 64-bit value per (seed, run, param)
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+void sweep_run_values(const SweepSpec* spec, uint32_t run, float* values) {
+    // Grid coordinates: the last grid parameter varies fastest
+    uint32_t point = run / spec->samples;
+    for (int p = spec->param_count - 1; p >= 0; p--) {
+        const SweepParam* param = &spec->params[p];
+        if (param->mode != SWEEP_GRID) continue;
+        values[p] = param->values[point % (uint32_t)param->value_count];
+        point /= (uint32_t)param->value_count;
+    }
+
+    for (int p = 0; p < spec->param_count; p++) {
+        const SweepParam* param = &spec->params[p];
+        if (param->mode == SWEEP_SET) {
+            values[p] = param->values[0];
+        } else if (param->mode == SWEEP_RANDOM) {
+            uint64_t bits = mix64(mix64(spec->seed ^ mix64(run)) + (uint64_t)p);
+            double u = (double)(bits >> 11) * (1.0 / 9007199254740992.0);  // [0, 1)
+            values[p] = (float)(param->values[0] + (param->values[1] - param->values[0]) * u);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Sweep Spec Loader
+ * Parameter grids and Monte Carlo draws for vexiq_batch
+ *
+ * Sweep File Format (.sweep):
+ *   duration: 20            # Simulated seconds per run (default 120)
+ *   dt: 0.0166667           # Fixed physics step (default 1/60)
+ *   samples: 50             # Random draws per grid point (default 1)
+ *   seed: 1                 # Base seed of the random draws
+ *
+ *   grid:                   # Every combination is run
+ *     friction: [0.6, 0.7, 0.8]
+ *     robot0.x: [-20, -10, 0]
+ *
+ *   random:                 # Uniform in [min, max], drawn per run
+ *     robot0.z: [-10, 10]
+ *     robot0.rotation: [0, 360]
+ *
+ *   set:                    # Same value in every run
+ *     robot0.left: 60
+ *     robot0.right: 55
+ *
+ * Parameters:
+ *   friction                  Wheel-ground friction (scene physics.friction)
+ *   forward_speed_scale       Drivetrain forward force scale (VEXIQ_FORWARD_SPEED_SCALE)
+ *   turn_speed_scale          Drivetrain turn torque scale (VEXIQ_TURN_SPEED_SCALE)
+ *   robotN.x, .z, .rotation   Starting pose of scene robot N (inches, degrees)
+ *   robotN.left, .right       Constant motor percentages of robot N (default 0)
+ *   robotN.strafe             Constant strafe percentage of a mecanum/omni robot N (default 0)
+ *   cylinderN.x, .z           Starting position of scene cylinder N
+ *
+ * Runs are numbered grid point major (run = point * samples + sample), the
+ * first grid parameter varying slowest. A run's random draws depend only on
+ * seed and the run number, so any run can be repeated on its own.
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SWEEP_MAX_PARAMS 32
+#define SWEEP_MAX_VALUES 64
+#define SWEEP_MAX_NAME 32
+
+typedef enum {
+    SWEEP_FRICTION,
+    SWEEP_FORWARD_SPEED_SCALE,
+    SWEEP_TURN_SPEED_SCALE,
+    SWEEP_ROBOT_X,
+    SWEEP_ROBOT_Z,
+    SWEEP_ROBOT_ROTATION,
+    SWEEP_ROBOT_LEFT,
+    SWEEP_ROBOT_RIGHT,
+    SWEEP_ROBOT_STRAFE,
+    SWEEP_CYLINDER_X,
+    SWEEP_CYLINDER_Z
+} SweepTarget;
+
+typedef enum {
+    SWEEP_SET,      // values[0]
+    SWEEP_GRID,     // values[0 .. value_count)
+    SWEEP_RANDOM    // Uniform in [values[0], values[1]]
+} SweepMode;
+
+typedef struct {
+    char name[SWEEP_MAX_NAME];   // As written in the spec (result column name)
+    SweepTarget target;
+    int index;                   // Robot or cylinder index (robotN / cylinderN)
+    SweepMode mode;
+    float values[SWEEP_MAX_VALUES];
+    int value_count;
+} SweepParam;
+
+typedef struct {
+    double duration;             // Simulated seconds per run
+    float dt;                    // Fixed physics step in seconds
+    uint32_t samples;            // Random draws per grid point
+    uint64_t seed;
+    SweepParam params[SWEEP_MAX_PARAMS];
+    int param_count;
+} SweepSpec;
+
+// Load a sweep spec from file
+// Returns true on success
+bool sweep_load(const char* path, SweepSpec* spec);
+
+// Number of runs (grid points * samples)
+uint32_t sweep_run_count(const SweepSpec* spec);
+
+// Parameter values of one run (values[param_count], in spec order)
+void sweep_run_values(const SweepSpec* spec, uint32_t run, float* values);
+
+#endif // SWEEP_H
@@ -0,0 +1,443 @@
+/*
+ * VEX IQ Microbenchmarks
+ *
+ * Google Benchmark suite for the step's hot paths and the loaders, on the
+ * shipped ClawbotIQ and Ike models:
+ *   - OBB tests (obb_intersects_obb, obb_intersects_circle) on real part sets
+ *   - Robot-robot part tests, the collision response pass, the cylinder pass
+ *     (sim_world_* single phases, see sim/sim_world.h) and a full step, with
+ *     the step's work counters (SimStepStats) as benchmark counters
+ *   - drivetrain_update
+ *   - glb_load / mpd_load on the models' files
+ *   - Python bridge JSON state parsing
+ *
+ * Inputs are fixed (no random placement), so runs on the same machine are
+ * comparable. Track results between releases with Google Benchmark's JSON
+ * output:
+ *   vexiq_bench --benchmark_out=bench.json --benchmark_out_format=json
+ *   vexiq_bench --models <dir> --benchmark_filter=Obb
+ *
+ * --models defaults to ../../models next to the executable (client/build/).
+ */
+
+#include "../sim/sim_world.h"
+#include "../physics/drivetrain.h"
+#include "../physics/obb.h"
+#include "../render/glb_loader.h"
+#include "../render/mpd_loader.h"
+#include "../scene/scene.h"
+#include "../ipc/python_bridge.h"
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#define PATH_SEP "\\"
+#else
+#include <unistd.h>
+#include <libgen.h>
+#define PATH_SEP "/"
+#endif
+
+static char g_models_dir[600];
+
+// Get executable directory
+static void get_exe_dir(char* buffer, size_t size) {
+#ifdef _WIN32
+    GetModuleFileNameA(NULL, buffer, (DWORD)size);
+    char* last_sep = strrchr(buffer, '\\');
+    if (last_sep) *last_sep = '\0';
+#else
+    ssize_t len = readlink("/proc/self/exe", buffer, size - 1);
+    if (len > 0) {
+        buffer[len] = '\0';
+        char* dir = dirname(buffer);
+        memmove(buffer, dir, strlen(dir) + 1);
+    } else {
+        buffer[0] = '.';
+        buffer[1] = '\0';
+    }
+#endif
+}
+
+// =============================================================================
+// Bench World
+// =============================================================================
+
+// Two ClawbotIQs and two Ikes, each pair overlapping, with cylinders pressed
+// against them. Loaded once and shared by all benchmarks.
+struct BenchWorld {
+    bool loaded;
+    Scene scene;
+    SimWorld world;
+    std::vector<Drivetrain> start_drivetrains;   // Poses to restore between iterations
+    Scene start_scene;
+};
+
+static void bench_add_robot(Scene* scene, const char* mpd_file, float x, float z, float rotation_y) {
+    SceneRobot* robot = scene_add_robot(scene);
+    snprintf(robot->mpd_file, sizeof(robot->mpd_file), "%s", mpd_file);
+    robot->x = x;
+    robot->z = z;
+    robot->rotation_y = rotation_y;
+}
+
+static void bench_add_cylinder(Scene* scene, float x, float z) {
+    SceneCylinder* cyl = scene_add_cylinder(scene);
+    cyl->x = x;
+    cyl->z = z;
+    cyl->radius = 1.5f;
+    cyl->height = 3.0f;
+    cyl->r = cyl->g = cyl->b = 0.8f;
+    cyl->mass = 0.1f;
+}
+
+static BenchWorld* bench_world() {
+    static BenchWorld bench;
+    if (bench.loaded) return &bench;
+
+    memset(&bench.scene, 0, sizeof(bench.scene));
+    snprintf(bench.scene.name, sizeof(bench.scene.name), "bench");
+    bench.scene.physics.friction_coeff = 0.8f;
+    bench.scene.physics.cylinder_friction = 0.5f;
+    bench.scene.physics.gravity = 386.1f;
+    bench_add_robot(&bench.scene, "ClawbotIQ.mpd", -28.0f, 0.0f, 0.0f);
+    bench_add_robot(&bench.scene, "ClawbotIQ.mpd", -22.0f, 2.0f, 30.0f);
+    bench_add_robot(&bench.scene, "Ike.mpd", 22.0f, 0.0f, 0.0f);
+    bench_add_robot(&bench.scene, "Ike.mpd", 27.0f, 2.0f, 30.0f);
+    bench_add_cylinder(&bench.scene, -25.0f, 6.0f);
+    bench_add_cylinder(&bench.scene, 24.0f, 5.0f);
+    bench_add_cylinder(&bench.scene, 0.0f, 0.0f);
+
+    sim_world_set_threads(&bench.world, 1);
+    sim_world_create(&bench.world, &bench.scene, g_models_dir, NULL);
+    if (bench.world.robots.size() != 4) {
+        fprintf(stderr, "[Bench] Failed to load ClawbotIQ/Ike from %s\n", g_models_dir);
+        exit(1);
+    }
+    for (const RobotInstance& robot : bench.world.robots) bench.start_drivetrains.push_back(robot.drivetrain);
+    scene_copy(&bench.start_scene, &bench.world.scene);
+    bench.loaded = true;
+    return &bench;
+}
+
+// Put robots and cylinders back where the scene placed them
+static void bench_restore(BenchWorld* bench) {
+    for (size_t i = 0; i < bench->world.robots.size(); i++) {
+        bench->world.robots[i].drivetrain = bench->start_drivetrains[i];
+    }
+    memcpy(bench->world.scene.cylinders, bench->start_scene.cylinders,
+           sizeof(SceneCylinder) * bench->start_scene.cylinder_count);
+    sim_world_wake_all(&bench->world);
+}
+
+// World-space part OBBs of one robot
+static std::vector<OBB> robot_part_obbs(SimWorld* world, int robot_index) {
+    RobotInstance* robot = &world->robots[robot_index];
+    std::vector<OBB> obbs;
+    for (size_t p = robot->parts_start_index; p < robot->parts_start_index + robot->parts_count; p++) {
+        obbs.push_back(*sim_part_world_obb(robot, &world->parts.collision[p]));
+    }
+    return obbs;
+}
+
+// =============================================================================
+// OBB Tests
+// =============================================================================
+
+// Every part of one robot against every part of its overlapping neighbour
+static void BM_ObbIntersectsObb(benchmark::State& state, int robot_a, int robot_b) {
+    BenchWorld* bench = bench_world();
+    std::vector<OBB> a = robot_part_obbs(&bench->world, robot_a);
+    std::vector<OBB> b = robot_part_obbs(&bench->world, robot_b);
+
+    int64_t hits = 0;
+    for (auto _ : state) {
+        for (const OBB& obb_a : a) {
+            for (const OBB& obb_b : b) hits += obb_intersects_obb(&obb_a, &obb_b);
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations() * (int64_t)(a.size() * b.size()));
+}
+BENCHMARK_CAPTURE(BM_ObbIntersectsObb, ClawbotIQ, 0, 1);
+BENCHMARK_CAPTURE(BM_ObbIntersectsObb, Ike, 2, 3);
+
+// Every part of a robot against a cylinder at its pushing position
+static void BM_ObbIntersectsCircle(benchmark::State& state, int robot_index, int cylinder_index) {
+    BenchWorld* bench = bench_world();
+    std::vector<OBB> parts = robot_part_obbs(&bench->world, robot_index);
+    const SceneCylinder& cyl = bench->world.scene.cylinders[cylinder_index];
+
+    int64_t hits = 0;
+    for (auto _ : state) {
+        for (const OBB& obb : parts) hits += obb_intersects_circle(&obb, cyl.x, cyl.z, cyl.radius);
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations() * (int64_t)parts.size());
+}
+BENCHMARK_CAPTURE(BM_ObbIntersectsCircle, ClawbotIQ, 0, 0);
+BENCHMARK_CAPTURE(BM_ObbIntersectsCircle, Ike, 2, 1);
+
+// =============================================================================
+// Step Phases
+// =============================================================================
+
+// Report the world's step counters (inputs are fixed, so every iteration does the same work)
+static void bench_step_counters(benchmark::State& state, const SimStepStats* stats) {
+    state.counters["pairs"] = stats->broadphase_pairs;
+    state.counters["builds"] = stats->broadphase_builds;
+    state.counters["submodel_tests"] = stats->submodel_tests;
+    state.counters["submodel_hits"] = stats->submodel_hits;
+    state.counters["part_tests"] = stats->part_tests;
+    state.counters["iterations"] = stats->response_iterations;
+    state.counters["corrections"] = stats->corrections;
+}
+
+static void BM_CheckRobotRobotCollision(benchmark::State& state, int robot_a, int robot_b) {
+    BenchWorld* bench = bench_world();
+    int hits = 0;
+    for (auto _ : state) {
+        hits += sim_world_check_robot_pair(&bench->world, robot_a, robot_b);
+    }
+    benchmark::DoNotOptimize(hits);
+}
+BENCHMARK_CAPTURE(BM_CheckRobotRobotCollision, ClawbotIQ, 0, 1);
+BENCHMARK_CAPTURE(BM_CheckRobotRobotCollision, Ike, 2, 3);
+
+// Full response pass from the same overlapping start every iteration
+static void BM_RunCollisionResponse(benchmark::State& state) {
+    BenchWorld* bench = bench_world();
+    for (auto _ : state) {
+        bench_restore(bench);
+        sim_world_collision_response(&bench->world);
+    }
+    bench_step_counters(state, &bench->world.stats);
+    bench_restore(bench);
+}
+BENCHMARK(BM_RunCollisionResponse);
+
+// One whole step with every robot driving forward into its neighbour
+static void BM_SimWorldStep(benchmark::State& state) {
+    BenchWorld* bench = bench_world();
+    int robot_count = sim_world_robot_count(&bench->world);
+    for (auto _ : state) {
+        bench_restore(bench);
+        for (int i = 0; i < robot_count; i++) sim_world_set_motors(&bench->world, i, 80.0f, 80.0f);
+        sim_world_step(&bench->world, 1.0f / 60.0f);
+    }
+    bench_step_counters(state, &bench->world.stats);
+    state.counters["cylinders_moved"] = bench->world.stats.cylinders_moved;
+    bench_restore(bench);
+}
+BENCHMARK(BM_SimWorldStep);
+
+// Moving cylinders on a grid with touching neighbours, reset every iteration
+static void BM_UpdateCylinderPhysics(benchmark::State& state) {
+    int count = (int)state.range(0);
+    int columns = 1;
+    while (columns * columns < count) columns++;
+    float spacing = 2.9f;   // Radius 1.5: neighbours overlap slightly
+
+    std::vector<SceneCylinder> start(count);
+    memset(start.data(), 0, start.size() * sizeof(SceneCylinder));
+    for (int c = 0; c < count; c++) {
+        SceneCylinder& cyl = start[c];
+        cyl.x = ((c % columns) - columns * 0.5f) * spacing;
+        cyl.z = ((c / columns) - columns * 0.5f) * spacing;
+        cyl.radius = 1.5f;
+        cyl.height = 3.0f;
+        cyl.mass = 0.1f;
+        cyl.vel_x = (c % 3 == 0) ? 5.0f : 0.0f;
+        cyl.vel_z = (c % 5 == 0) ? -4.0f : 0.0f;
+    }
+
+    static Broadphase broadphase;
+    std::vector<SceneCylinder> cylinders(start);
+    for (auto _ : state) {
+        memcpy(cylinders.data(), start.data(), start.size() * sizeof(SceneCylinder));
+        sim_cylinders_update(&broadphase, cylinders.data(), (uint32_t)count, 1.0f / 60.0f,
+                             SIM_FIELD_WIDTH / 2.0f, SIM_FIELD_DEPTH / 2.0f);
+    }
+    benchmark::DoNotOptimize(cylinders.data());
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_UpdateCylinderPhysics)->Arg(32)->Arg(128)->Arg(256)->Arg(1024);
+
+// Resting cylinders on the same grid once they have fallen asleep
+static void BM_UpdateRestingCylinders(benchmark::State& state) {
+    int count = (int)state.range(0);
+    int columns = 1;
+    while (columns * columns < count) columns++;
+
+    std::vector<SceneCylinder> cylinders(count);
+    memset(cylinders.data(), 0, cylinders.size() * sizeof(SceneCylinder));
+    for (int c = 0; c < count; c++) {
+        SceneCylinder& cyl = cylinders[c];
+        cyl.x = ((c % columns) - columns * 0.5f) * 3.2f;
+        cyl.z = ((c / columns) - columns * 0.5f) * 3.2f;
+        cyl.radius = 1.5f;
+        cyl.height = 3.0f;
+        cyl.mass = 0.1f;
+    }
+
+    static Broadphase broadphase;
+    float dt = 1.0f / 60.0f;
+    for (float t = 0.0f; t <= SIM_SLEEP_SECONDS + dt; t += dt) {
+        sim_cylinders_update(&broadphase, cylinders.data(), (uint32_t)count, dt,
+                             SIM_FIELD_WIDTH / 2.0f, SIM_FIELD_DEPTH / 2.0f);
+    }
+    for (auto _ : state) {
+        sim_cylinders_update(&broadphase, cylinders.data(), (uint32_t)count, dt,
+                             SIM_FIELD_WIDTH / 2.0f, SIM_FIELD_DEPTH / 2.0f);
+    }
+    benchmark::DoNotOptimize(cylinders.data());
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_UpdateRestingCylinders)->Arg(32)->Arg(256)->Arg(1024);
+
+static void BM_DrivetrainUpdate(benchmark::State& state) {
+    Drivetrain dt;
+    drivetrain_init(&dt);
+    drivetrain_set_friction(&dt, 0.8f);
+    drivetrain_set_motors(&dt, 80.0f, 60.0f);
+    for (auto _ : state) {
+        drivetrain_update(&dt, 1.0f / 240.0f);
+        benchmark::DoNotOptimize(dt.pos_x);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DrivetrainUpdate);
+
+// One drive batch of Arg robots through the Type kernel, as in a world step
+template <DrivetrainType Type>
+static void BM_DriveKernel(benchmark::State& state) {
+    int count = (int)state.range(0);
+    std::vector<Drivetrain> drivetrains(count);
+    DriveBatch batch;
+    for (int i = 0; i < count; i++) {
+        Drivetrain& dt = drivetrains[i];
+        drivetrain_init(&dt);
+        drivetrain_set_friction(&dt, 0.8f);
+        drivetrain_set_motors(&dt, 80.0f, 60.0f + (float)(i % 20));
+        drivetrain_set_strafe(&dt, 40.0f);
+        drive_batch_add(&batch, i, &dt);
+    }
+    for (auto _ : state) {
+        for (int k = 0; k < count; k++) {
+            drive_step<Type>(&drivetrains[batch.robots[k]], drive_batch_coeffs(batch, k), 1.0f / 240.0f);
+        }
+        benchmark::DoNotOptimize(drivetrains.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_DriveKernel, DRIVETRAIN_TANK)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_DriveKernel, DRIVETRAIN_MECANUM)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_DriveKernel, DRIVETRAIN_OMNI)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_DriveKernel, DRIVETRAIN_ACKERMANN)->Arg(1024);
+
+// =============================================================================
+// Loaders
+// =============================================================================
+
+// Every part file the bench robots use, one per iteration
+static void BM_GlbLoad(benchmark::State& state) {
+    BenchWorld* bench = bench_world();
+    std::vector<std::string> paths;
+    for (const auto& entry : bench->world.asset_index) {
+        if (entry.second < 0) continue;
+        paths.push_back(std::string(g_models_dir) + PATH_SEP "parts" PATH_SEP + entry.first);
+    }
+    if (paths.empty()) {
+        state.SkipWithError("no part files");
+        return;
+    }
+
+    size_t next = 0;
+    int64_t triangles = 0;
+    for (auto _ : state) {
+        MeshData mesh;
+        if (glb_load(paths[next].c_str(), &mesh)) {
+            triangles += mesh.index_count / 3;
+            mesh_data_free(&mesh);
+        }
+        next = (next + 1) % paths.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["tris_per_file"] = benchmark::Counter((double)triangles / (double)state.iterations());
+}
+BENCHMARK(BM_GlbLoad);
+
+static void BM_MpdLoad(benchmark::State& state, const char* mpd_file) {
+    std::string path = std::string(g_models_dir) + PATH_SEP "robots" PATH_SEP + mpd_file;
+    int64_t parts = 0;
+    for (auto _ : state) {
+        MpdDocument doc;
+        if (!mpd_load(path.c_str(), &doc)) {
+            state.SkipWithError("mpd_load failed");
+            return;
+        }
+        parts += doc.part_count;
+        mpd_free(&doc);
+    }
+    state.SetItemsProcessed(parts);
+}
+BENCHMARK_CAPTURE(BM_MpdLoad, ClawbotIQ, "ClawbotIQ.mpd");
+BENCHMARK_CAPTURE(BM_MpdLoad, Ike, "Ike.mpd");
+
+// =============================================================================
+// Python Bridge
+// =============================================================================
+
+// One "state" line as sent by ipc_bridge.py every tick
+static void BM_BridgeParseState(benchmark::State& state) {
+    static PythonBridge bridge;
+    memset(&bridge, 0, sizeof(bridge));
+    const char* json =
+        "{\"type\":\"state\",\"seq\":1234,\"motors\":{"
+        "\"1\":{\"speed\":75,\"spinning\":true,\"position\":1234.5},"
+        "\"2\":{\"speed\":0,\"spinning\":false,\"position\":0.0},"
+        "\"6\":{\"speed\":-75,\"spinning\":true,\"position\":-988.25},"
+        "\"10\":{\"speed\":40,\"spinning\":true,\"position\":17.0}},"
+        "\"pneumatics\":{\"9\":{\"extended\":true,\"pump\":false}}}";
+
+    for (auto _ : state) {
+        python_bridge_process_message(&bridge, json);
+        benchmark::DoNotOptimize(bridge.state.motor_count);
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)strlen(json));
+}
+BENCHMARK(BM_BridgeParseState);
+
+int main(int argc, char** argv) {
+    // Take --models <dir> out before Google Benchmark parses the rest
+    const char* models_arg = NULL;
+    int out = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--models") == 0 && i + 1 < argc) {
+            models_arg = argv[++i];
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+
+    if (models_arg) {
+        snprintf(g_models_dir, sizeof(g_models_dir), "%s", models_arg);
+    } else {
+        char exe_dir[512];
+        get_exe_dir(exe_dir, sizeof(exe_dir));
+        snprintf(g_models_dir, sizeof(g_models_dir), "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "models", exe_dir);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    bench_world();   // Load the models before the first timing is printed
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,381 @@
+/*
+ * I/O Reactor implementation
+ * epoll (Linux), I/O completion port (Windows) or poll() (other POSIX)
+ */
+
+#include "io_reactor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+#endif
+
+// ============================================================================
+// Ring buffer
+// ============================================================================
+
+// Double the ring until at least min_free bytes are free
+static bool ring_reserve(IoChannel* channel, size_t min_free) {
+    size_t used = channel->tail - channel->head;
+    if (channel->capacity - used >= min_free) return true;
+
+    size_t capacity = channel->capacity ? channel->capacity : IO_REACTOR_RING_SIZE;
+    while (capacity - used < min_free) capacity *= 2;
+
+    char* ring = (char*)malloc(capacity);
+    if (!ring) return false;
+
+    // Linearize the old contents at the start of the new ring
+    size_t copied = 0;
+    if (channel->ring) {
+        copied = io_channel_read(channel, ring, used);
+        free(channel->ring);
+    }
+    channel->ring = ring;
+    channel->capacity = capacity;
+    channel->head = 0;
+    channel->tail = copied;
+    return true;
+}
+
+// Free space as up to two contiguous spans (the second wraps to the start)
+static int ring_free_spans(IoChannel* channel, char** ptr, size_t* len) {
+    size_t mask = channel->capacity - 1;
+    size_t free_bytes = channel->capacity - (channel->tail - channel->head);
+    size_t start = channel->tail & mask;
+    size_t first = channel->capacity - start;
+    if (first > free_bytes) first = free_bytes;
+
+    ptr[0] = channel->ring + start;
+    len[0] = first;
+    if (first == free_bytes) return 1;
+    ptr[1] = channel->ring;
+    len[1] = free_bytes - first;
+    return 2;
+}
+
+static bool ring_write(IoChannel* channel, const char* data, size_t size) {
+    if (!ring_reserve(channel, size)) return false;
+    char* ptr[2];
+    size_t len[2];
+    int spans = ring_free_spans(channel, ptr, len);
+    size_t n = size < len[0] ? size : len[0];
+    memcpy(ptr[0], data, n);
+    if (size > n && spans > 1) memcpy(ptr[1], data + n, size - n);
+    channel->tail += size;
+    return true;
+}
+
+int io_channel_read(IoChannel* channel, char* buffer, size_t size) {
+    size_t available = channel->tail - channel->head;
+    size_t n = size < available ? size : available;
+    if (n == 0) return 0;
+
+    size_t mask = channel->capacity - 1;
+    size_t start = channel->head & mask;
+    size_t first = channel->capacity - start;
+    if (first > n) first = n;
+    memcpy(buffer, channel->ring + start, first);
+    if (n > first) memcpy(buffer + first, channel->ring, n - first);
+    channel->head += n;
+    return (int)n;
+}
+
+// Add the channel to the ready list once per poll
+static void mark_ready(IoChannel* channel, IoChannel** ready, int max_ready, int* count) {
+    for (int i = 0; i < *count; i++) {
+        if (ready[i] == channel) return;
+    }
+    if (*count < max_ready) ready[(*count)++] = channel;
+}
+
+#ifdef _WIN32
+// ============================================================================
+// Windows: I/O completion port
+// ============================================================================
+
+// Queue the next overlapped read; completion (or EOF) arrives on the port
+static void channel_issue_read(IoChannel* channel) {
+    memset(&channel->overlapped, 0, sizeof(channel->overlapped));
+    if (ReadFile(channel->process->stdout_read, channel->chunk, IO_REACTOR_CHUNK, NULL,
+                 &channel->overlapped) ||
+        GetLastError() == ERROR_IO_PENDING) {
+        channel->read_pending = true;
+    } else {
+        channel->read_pending = false;
+        channel->eof = true;
+    }
+}
+
+// Handle one completion packet: append the chunk and re-arm the read
+static void channel_complete(IoChannel* channel) {
+    DWORD bytes = 0;
+    channel->read_pending = false;
+    if (!GetOverlappedResult(channel->process->stdout_read, &channel->overlapped, &bytes, FALSE)) {
+        channel->eof = true;
+        return;
+    }
+    if (bytes > 0) ring_write(channel, channel->chunk, bytes);
+    channel_issue_read(channel);
+}
+
+bool io_reactor_init(IoReactor* reactor) {
+    memset(reactor, 0, sizeof(IoReactor));
+    reactor->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (!reactor->port) {
+        fprintf(stderr, "[Reactor] CreateIoCompletionPort failed: %lu\n", GetLastError());
+        return false;
+    }
+    return true;
+}
+
+static bool platform_add(IoReactor* reactor, IoChannel* channel) {
+    if (!CreateIoCompletionPort(channel->process->stdout_read, reactor->port, (ULONG_PTR)channel, 0)) {
+        fprintf(stderr, "[Reactor] Failed to add pipe to completion port: %lu\n", GetLastError());
+        return false;
+    }
+    channel_issue_read(channel);
+    return true;
+}
+
+static void platform_remove(IoReactor* reactor, IoChannel* channel) {
+    if (!channel->read_pending) return;
+
+    // The cancelled read still posts a packet; pull packets until it arrives
+    // (other channels' packets are handled normally on the way)
+    CancelIoEx(channel->process->stdout_read, &channel->overlapped);
+    for (;;) {
+        DWORD bytes;
+        ULONG_PTR key;
+        LPOVERLAPPED ov;
+        BOOL ok = GetQueuedCompletionStatus(reactor->port, &bytes, &key, &ov, 1000);
+        if (!ok && !ov) break;  // Timed out
+        if ((IoChannel*)key == channel) break;
+        if (key) channel_complete((IoChannel*)key);
+    }
+    channel->read_pending = false;
+}
+
+int io_reactor_poll(IoReactor* reactor, int timeout_ms, IoChannel** ready, int max_ready) {
+    int count = 0;
+    DWORD timeout = (DWORD)timeout_ms;
+    for (;;) {
+        OVERLAPPED_ENTRY entries[IO_REACTOR_MAX_CHANNELS];
+        ULONG removed = 0;
+        if (!GetQueuedCompletionStatusEx(reactor->port, entries, IO_REACTOR_MAX_CHANNELS, &removed,
+                                         timeout, FALSE)) {
+            break;  // Timeout (or error) with nothing dequeued
+        }
+        for (ULONG i = 0; i < removed; i++) {
+            IoChannel* channel = (IoChannel*)entries[i].lpCompletionKey;
+            if (!channel) continue;
+            channel_complete(channel);
+            mark_ready(channel, ready, max_ready, &count);
+        }
+        timeout = 0;  // Collect reads that completed meanwhile, without waiting again
+    }
+    return count;
+}
+
+void io_reactor_destroy(IoReactor* reactor) {
+    while (reactor->channel_count > 0) {
+        io_reactor_remove(reactor, reactor->channels[reactor->channel_count - 1]);
+    }
+    if (reactor->port) CloseHandle(reactor->port);
+    memset(reactor, 0, sizeof(IoReactor));
+}
+
+#else
+// ============================================================================
+// POSIX: epoll (Linux) or poll()
+// ============================================================================
+
+// Read until the pipe is drained. Returns true if data arrived or the pipe closed.
+static bool channel_fill(IoChannel* channel) {
+    bool got = false;
+    for (;;) {
+        if (!ring_reserve(channel, IO_REACTOR_RING_SIZE / 4)) return got;
+
+        char* ptr[2];
+        size_t len[2];
+        int spans = ring_free_spans(channel, ptr, len);
+        struct iovec iov[2];
+        size_t space = 0;
+        for (int i = 0; i < spans; i++) {
+            iov[i].iov_base = ptr[i];
+            iov[i].iov_len = len[i];
+            space += len[i];
+        }
+
+        ssize_t bytes = readv(channel->process->stdout_fd, iov, spans);
+        if (bytes > 0) {
+            channel->tail += (size_t)bytes;
+            got = true;
+            if ((size_t)bytes < space) return true;  // Short read: pipe drained
+            continue;
+        }
+        if (bytes == -1 && errno == EINTR) continue;
+        if (bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) return got;
+
+        channel->eof = true;  // EOF or error
+        return true;
+    }
+}
+
+bool io_reactor_init(IoReactor* reactor) {
+    memset(reactor, 0, sizeof(IoReactor));
+#ifdef __linux__
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor->epoll_fd == -1) {
+        perror("[Reactor] epoll_create1");
+        return false;
+    }
+#endif
+    return true;
+}
+
+static bool platform_add(IoReactor* reactor, IoChannel* channel) {
+#ifdef __linux__
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = channel;
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, channel->process->stdout_fd, &ev) == -1) {
+        perror("[Reactor] epoll_ctl add");
+        return false;
+    }
+#else
+    (void)reactor;
+    (void)channel;
+#endif
+    return true;
+}
+
+static void platform_remove(IoReactor* reactor, IoChannel* channel) {
+#ifdef __linux__
+    // Already removed at EOF
+    if (!channel->eof) {
+        epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, channel->process->stdout_fd, NULL);
+    }
+#else
+    (void)reactor;
+    (void)channel;
+#endif
+}
+
+int io_reactor_poll(IoReactor* reactor, int timeout_ms, IoChannel** ready, int max_ready) {
+    int count = 0;
+
+#ifdef __linux__
+    struct epoll_event events[IO_REACTOR_MAX_CHANNELS];
+    int n;
+    do {
+        n = epoll_wait(reactor->epoll_fd, events, IO_REACTOR_MAX_CHANNELS, timeout_ms);
+    } while (n == -1 && errno == EINTR);
+    if (n == -1) return -1;
+
+    for (int i = 0; i < n; i++) {
+        IoChannel* channel = (IoChannel*)events[i].data.ptr;
+        if (!channel_fill(channel)) continue;
+        if (channel->eof) {
+            // A closed pipe stays readable; stop waking up for it
+            epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, channel->process->stdout_fd, NULL);
+        }
+        mark_ready(channel, ready, max_ready, &count);
+    }
+#else
+    struct pollfd fds[IO_REACTOR_MAX_CHANNELS];
+    IoChannel* polled[IO_REACTOR_MAX_CHANNELS];
+    int n = 0;
+    for (int i = 0; i < reactor->channel_count; i++) {
+        IoChannel* channel = reactor->channels[i];
+        if (channel->eof) continue;
+        fds[n].fd = channel->process->stdout_fd;
+        fds[n].events = POLLIN;
+        fds[n].revents = 0;
+        polled[n++] = channel;
+    }
+    if (n == 0) return 0;
+
+    int result;
+    do {
+        result = poll(fds, n, timeout_ms);
+    } while (result == -1 && errno == EINTR);
+    if (result == -1) return -1;
+
+    for (int i = 0; i < n; i++) {
+        if (fds[i].revents == 0) continue;
+        if (channel_fill(polled[i])) mark_ready(polled[i], ready, max_ready, &count);
+    }
+#endif
+    return count;
+}
+
+void io_reactor_destroy(IoReactor* reactor) {
+    while (reactor->channel_count > 0) {
+        io_reactor_remove(reactor, reactor->channels[reactor->channel_count - 1]);
+    }
+#ifdef __linux__
+    if (reactor->epoll_fd > 0) close(reactor->epoll_fd);
+#endif
+    memset(reactor, 0, sizeof(IoReactor));
+}
+
+#endif
+
+// ============================================================================
+// Registration (shared)
+// ============================================================================
+
+bool io_reactor_add(IoReactor* reactor, IoChannel* channel, Subprocess* proc, void* user) {
+    if (reactor->channel_count >= IO_REACTOR_MAX_CHANNELS) {
+        fprintf(stderr, "[Reactor] Too many channels (max %d)\n", IO_REACTOR_MAX_CHANNELS);
+        return false;
+    }
+
+    memset(channel, 0, sizeof(IoChannel));
+    channel->process = proc;
+    channel->user = user;
+    if (!ring_reserve(channel, IO_REACTOR_RING_SIZE)) return false;
+
+    // Keep byte order: read-ahead from subprocess_read_line comes first
+    int buffered = proc->line_end - proc->line_start;
+    if (buffered > 0) {
+        ring_write(channel, proc->line_buffer + proc->line_start, (size_t)buffered);
+        proc->line_start = proc->line_end = 0;
+    }
+
+    if (!platform_add(reactor, channel)) {
+        free(channel->ring);
+        memset(channel, 0, sizeof(IoChannel));
+        return false;
+    }
+
+    channel->reactor = reactor;
+    reactor->channels[reactor->channel_count++] = channel;
+    return true;
+}
+
+void io_reactor_remove(IoReactor* reactor, IoChannel* channel) {
+    if (channel->reactor != reactor) return;
+
+    platform_remove(reactor, channel);
+    for (int i = 0; i < reactor->channel_count; i++) {
+        if (reactor->channels[i] == channel) {
+            reactor->channels[i] = reactor->channels[--reactor->channel_count];
+            break;
+        }
+    }
+
+    free(channel->ring);
+    memset(channel, 0, sizeof(IoChannel));
+}
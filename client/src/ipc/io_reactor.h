@@ -0,0 +1,94 @@
+/*
+ * I/O Reactor - multiplexed subprocess stdout reading
+ *
+ * Registers the stdout pipe of many subprocesses in one wait set (epoll on
+ * Linux, an I/O completion port on Windows, poll() on other POSIX systems)
+ * and reads whatever arrives in large chunks into a ring buffer per
+ * channel. One io_reactor_poll() per frame replaces a read attempt per
+ * subprocess, and reports which channels actually received data; owners
+ * then drain their ring with io_channel_read() (no system call).
+ *
+ * Usage:
+ *   IoReactor reactor;
+ *   io_reactor_init(&reactor);
+ *   io_reactor_add(&reactor, &channel, &proc, owner);
+ *   IoChannel* ready[IO_REACTOR_MAX_CHANNELS];
+ *   int n = io_reactor_poll(&reactor, 0, ready, IO_REACTOR_MAX_CHANNELS);
+ *   for (int i = 0; i < n; i++) {
+ *       int bytes = io_channel_read(ready[i], buffer, sizeof(buffer));
+ *       ...                                            // ready[i]->user is owner
+ *   }
+ *   io_reactor_remove(&reactor, &channel);             // before subprocess_destroy
+ *   io_reactor_destroy(&reactor);
+ */
+
+#ifndef IO_REACTOR_H
+#define IO_REACTOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "subprocess.h"
+
+#define IO_REACTOR_MAX_CHANNELS 64
+#define IO_REACTOR_RING_SIZE 16384     // Initial ring capacity (power of two, grows when full)
+#define IO_REACTOR_CHUNK 16384         // Windows: bytes per overlapped read
+
+struct IoReactor;
+
+typedef struct IoChannel {
+    struct IoReactor* reactor;     // NULL when not registered
+    Subprocess* process;
+    void* user;                    // Owner (e.g. the PythonBridge)
+
+    // Ring buffer of received bytes (head/tail are running byte counts)
+    char* ring;
+    size_t capacity;
+    size_t head;                   // Next byte to hand out
+    size_t tail;                   // Next byte to fill
+
+    bool eof;                      // Pipe closed or failed; no more data will arrive
+
+#ifdef _WIN32
+    OVERLAPPED overlapped;
+    bool read_pending;             // An overlapped read into chunk is outstanding
+    char chunk[IO_REACTOR_CHUNK];
+#endif
+} IoChannel;
+
+typedef struct IoReactor {
+#ifdef _WIN32
+    HANDLE port;                   // I/O completion port
+#elif defined(__linux__)
+    int epoll_fd;
+#endif
+    IoChannel* channels[IO_REACTOR_MAX_CHANNELS];
+    int channel_count;
+} IoReactor;
+
+// Create the wait set. Returns false if the platform call fails.
+bool io_reactor_init(IoReactor* reactor);
+
+// Remove every channel and close the wait set
+void io_reactor_destroy(IoReactor* reactor);
+
+// Register proc's stdout; user is stored in channel->user
+// Bytes already buffered by subprocess_read_line are moved into the ring.
+bool io_reactor_add(IoReactor* reactor, IoChannel* channel, Subprocess* proc, void* user);
+
+// Unregister a channel and free its ring (call before destroying its subprocess)
+void io_reactor_remove(IoReactor* reactor, IoChannel* channel);
+
+// Wait up to timeout_ms (0 = don't block) for data, then read everything
+// available. Fills ready with the channels that received data or hit EOF.
+// Returns the number of ready channels, or -1 on error.
+int io_reactor_poll(IoReactor* reactor, int timeout_ms, IoChannel** ready, int max_ready);
+
+// Copy up to size buffered bytes out of the ring. Returns bytes copied.
+int io_channel_read(IoChannel* channel, char* buffer, size_t size);
+
+// Bytes waiting in the ring
+static inline size_t io_channel_available(const IoChannel* channel) {
+    return channel->tail - channel->head;
+}
+
+#endif // IO_REACTOR_H
@@ -0,0 +1,555 @@
+/*
+ * Network Match Stream Implementation
+ */
+
+#include "net_stream.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mstcpip.h>
+typedef SOCKET NetSocket;
+#define NET_INVALID_SOCKET INVALID_SOCKET
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int NetSocket;
+#define NET_INVALID_SOCKET (-1)
+#endif
+
+// =============================================================================
+// Sockets
+// =============================================================================
+
+static double wall_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool socket_startup() {
+#ifdef _WIN32
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+static void socket_cleanup() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+static void socket_close(NetSocket sock) {
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+// Nonblocking IPv4 UDP socket, bound to port on all interfaces (0 = any port)
+static NetSocket socket_open(int port) {
+    NetSocket sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == NET_INVALID_SOCKET) return NET_INVALID_SOCKET;
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    bool ok = bind(sock, (const sockaddr*)&addr, sizeof(addr)) == 0;
+#ifdef _WIN32
+    u_long nonblocking = 1;
+    ok = ok && ioctlsocket(sock, FIONBIO, &nonblocking) == 0;
+
+    // A viewer that quit answers with ICMP port unreachable, which Windows
+    // would report as a receive error on this socket
+    BOOL report_reset = FALSE;
+    DWORD returned = 0;
+    WSAIoctl(sock, SIO_UDP_CONNRESET, &report_reset, sizeof(report_reset), NULL, 0, &returned, NULL, NULL);
+#else
+    ok = ok && fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+        socket_close(sock);
+        return NET_INVALID_SOCKET;
+    }
+    return sock;
+}
+
+// Payload bytes received, or -1 when nothing is queued
+static int socket_receive(NetSocket sock, uint8_t* buffer, int size, sockaddr_in* from) {
+#ifdef _WIN32
+    int from_size = sizeof(*from);
+#else
+    socklen_t from_size = sizeof(*from);
+#endif
+    int received = (int)recvfrom(sock, (char*)buffer, size, 0, (sockaddr*)from, &from_size);
+    return received >= 0 ? received : -1;
+}
+
+static int socket_send(NetSocket sock, const uint8_t* data, size_t size, const sockaddr_in* to) {
+    return (int)sendto(sock, (const char*)data, (int)size, 0, (const sockaddr*)to, sizeof(*to));
+}
+
+static bool same_address(const sockaddr_in* a, const sockaddr_in* b) {
+    return a->sin_addr.s_addr == b->sin_addr.s_addr && a->sin_port == b->sin_port;
+}
+
+static void packet_begin(std::vector<uint8_t>& out, uint8_t type, uint8_t flags) {
+    NetStreamPacket packet;
+    packet.magic = NET_STREAM_MAGIC;
+    packet.version = NET_STREAM_VERSION;
+    packet.type = type;
+    packet.flags = flags;
+    out.assign((const uint8_t*)&packet, (const uint8_t*)&packet + sizeof(packet));
+}
+
+// Packet header of a received datagram (NULL if not this protocol)
+static const NetStreamPacket* packet_header(const uint8_t* data, int size) {
+    if (size < (int)sizeof(NetStreamPacket)) return NULL;
+    const NetStreamPacket* packet = (const NetStreamPacket*)data;
+    if (packet->magic != NET_STREAM_MAGIC || packet->version != NET_STREAM_VERSION) return NULL;
+    return packet;
+}
+
+// =============================================================================
+// Server
+// =============================================================================
+
+struct NetStreamViewerSlot {
+    sockaddr_in address;
+    double last_hello;           // Wall clock
+};
+
+struct NetStreamServer {
+    NetSocket sock;
+    int port;
+    std::vector<uint8_t> info;   // INFO packet
+    ReplayLayout layout;
+    float interval;              // Simulated seconds between frames
+    uint32_t keyframe_interval;  // Frames between scheduled keyframes
+
+    std::vector<NetStreamViewerSlot> viewers;
+    std::vector<uint8_t> receive;
+    std::vector<uint8_t> packet;
+    std::vector<int32_t> store;
+    std::vector<int32_t> values, previous;
+    double next_time;            // Simulated time of the next frame
+    uint32_t frame;
+    uint32_t since_keyframe;
+    bool keyframe_due;
+    NetStreamStats stats;
+};
+
+NetStreamServer* net_stream_server_open(int port, const SimWorld* world, const char* scene_path, float rate) {
+    if (!world || rate <= 0.0f || port <= 0 || port > 65535) return NULL;
+    if (!socket_startup()) return NULL;
+
+    NetSocket sock = socket_open(port);
+    if (sock == NET_INVALID_SOCKET) {
+        fprintf(stderr, "[Stream] Can't bind UDP port %d\n", port);
+        socket_cleanup();
+        return NULL;
+    }
+
+    NetStreamServer* server = new NetStreamServer();
+    server->sock = sock;
+    server->port = port;
+    server->interval = 1.0f / rate;
+    server->keyframe_interval = (uint32_t)std::max(1.0f, floorf(REPLAY_KEYFRAME_SECONDS * rate + 0.5f));
+    server->receive.resize(NET_STREAM_MAX_DATAGRAM);
+    server->next_time = world->time;
+    server->frame = 0;
+    server->since_keyframe = 0;
+    server->keyframe_due = true;
+    memset(&server->stats, 0, sizeof(server->stats));
+
+    // INFO: the replay header and robot list describe the stream as well
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.dt = server->interval;
+    header.robot_count = (uint32_t)world->robots.size();
+    header.cylinder_count = world->scene.cylinder_count;
+    header.keyframe_interval = server->keyframe_interval;
+    header.start_time = world->time;
+    snprintf(header.scene_path, sizeof(header.scene_path), "%s", scene_path ? scene_path : "");
+
+    packet_begin(server->info, NET_STREAM_INFO, 0);
+    server->info.insert(server->info.end(), (const uint8_t*)&header, (const uint8_t*)&header + sizeof(header));
+    std::vector<uint32_t> wheel_counts(world->robots.size());
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        const RobotInstance& robot = world->robots[i];
+        ReplayRobotInfo info;
+        memset(&info, 0, sizeof(info));
+        snprintf(info.mpd_file, sizeof(info.mpd_file), "%s", world->scene.robots[robot.scene_index].mpd_file);
+        info.wheel_count = (uint32_t)robot.wheel_count;
+        wheel_counts[i] = info.wheel_count;
+        server->info.insert(server->info.end(), (const uint8_t*)&info, (const uint8_t*)&info + sizeof(info));
+    }
+
+    replay_layout_build(&server->layout, wheel_counts.data(), header.robot_count, header.cylinder_count, true);
+    server->store.resize(server->layout.channel_count);
+
+    printf("[Stream] Serving on UDP port %d at %.0f Hz (keyframe every %u frames)\n", port, rate,
+           server->keyframe_interval);
+    return server;
+}
+
+// Answer HELLO and BYE packets
+static void server_receive(NetStreamServer* server, double now) {
+    sockaddr_in from;
+    int size;
+    while ((size = socket_receive(server->sock, server->receive.data(), (int)server->receive.size(), &from)) >= 0) {
+        const NetStreamPacket* packet = packet_header(server->receive.data(), size);
+        if (!packet) continue;
+
+        auto it = std::find_if(server->viewers.begin(), server->viewers.end(),
+                               [&from](const NetStreamViewerSlot& v) { return same_address(&v.address, &from); });
+        if (packet->type == NET_STREAM_BYE) {
+            if (it != server->viewers.end()) {
+                printf("[Stream] Viewer %s:%d left\n", inet_ntoa(from.sin_addr), ntohs(from.sin_port));
+                server->viewers.erase(it);
+            }
+            continue;
+        }
+        if (packet->type != NET_STREAM_HELLO) continue;
+
+        bool joined = it == server->viewers.end();
+        if (joined) {
+            if (server->viewers.size() >= NET_STREAM_MAX_VIEWERS) continue;
+            NetStreamViewerSlot slot = { from, now };
+            server->viewers.push_back(slot);
+            it = server->viewers.end() - 1;
+            printf("[Stream] Viewer %s:%d joined (%zu watching)\n", inet_ntoa(from.sin_addr), ntohs(from.sin_port),
+                   server->viewers.size());
+        }
+        it->last_hello = now;
+
+        if (joined || (packet->flags & NET_STREAM_WANT_INFO)) {
+            socket_send(server->sock, server->info.data(), server->info.size(), &from);
+            server->stats.bytes += server->info.size();
+        }
+        if (joined || (packet->flags & NET_STREAM_WANT_KEYFRAME)) server->keyframe_due = true;
+    }
+
+    // Drop viewers that went quiet
+    for (size_t i = 0; i < server->viewers.size();) {
+        if (now - server->viewers[i].last_hello > NET_STREAM_VIEWER_TIMEOUT) {
+            const sockaddr_in* addr = &server->viewers[i].address;
+            printf("[Stream] Viewer %s:%d timed out\n", inet_ntoa(addr->sin_addr), ntohs(addr->sin_port));
+            server->viewers.erase(server->viewers.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    server->stats.viewers = (int)server->viewers.size();
+}
+
+void net_stream_server_step(NetStreamServer* server, const SimWorld* world, const ReplayActuators* actuators,
+                            int active_robot) {
+    if (!server || world->robots.size() != server->layout.robot_first.size()) return;
+    server_receive(server, wall_seconds());
+
+    if (world->time + 1e-9 < server->next_time) return;
+    server->next_time += server->interval;
+    if (server->next_time <= world->time) server->next_time = world->time + server->interval;   // Rewound or fell behind
+
+    // Nobody to code for: the next viewer starts from a keyframe anyway
+    if (server->viewers.empty()) {
+        server->keyframe_due = true;
+        return;
+    }
+
+    bool keyframe = server->keyframe_due || server->since_keyframe + 1 >= server->keyframe_interval;
+    replay_layout_store(&server->layout, world, actuators, server->store.data());
+
+    packet_begin(server->packet, NET_STREAM_FRAME, keyframe ? NET_STREAM_KEYFRAME : 0);
+    NetStreamFrame frame;
+    frame.frame = server->frame++;
+    frame.active_robot = active_robot;
+    frame.time = world->time;
+    server->packet.insert(server->packet.end(), (const uint8_t*)&frame, (const uint8_t*)&frame + sizeof(frame));
+    replay_encode_frame(&server->layout, server->store.data(), keyframe, server->values, server->previous,
+                        server->packet);
+
+    for (const NetStreamViewerSlot& viewer : server->viewers) {
+        if (socket_send(server->sock, server->packet.data(), server->packet.size(), &viewer.address) > 0) {
+            server->stats.bytes += server->packet.size();
+        }
+    }
+    server->stats.frames++;
+    if (keyframe) {
+        server->stats.keyframes++;
+        server->since_keyframe = 0;
+        server->keyframe_due = false;
+    } else {
+        server->since_keyframe++;
+    }
+}
+
+const NetStreamStats* net_stream_server_stats(const NetStreamServer* server) {
+    return &server->stats;
+}
+
+void net_stream_server_close(NetStreamServer* server) {
+    if (!server) return;
+    std::vector<uint8_t> bye;
+    packet_begin(bye, NET_STREAM_BYE, 0);
+    for (const NetStreamViewerSlot& viewer : server->viewers) {
+        socket_send(server->sock, bye.data(), bye.size(), &viewer.address);
+    }
+    printf("[Stream] Sent %llu frames (%llu keyframes), %.1f KB\n", (unsigned long long)server->stats.frames,
+           (unsigned long long)server->stats.keyframes, server->stats.bytes / 1024.0);
+    socket_close(server->sock);
+    socket_cleanup();
+    delete server;
+}
+
+// =============================================================================
+// Viewer
+// =============================================================================
+
+struct NetStreamViewer {
+    NetSocket sock;
+    sockaddr_in server;
+    ReplayHeader header;
+    std::vector<ReplayRobotInfo> robots;
+    ReplayLayout layout;
+
+    std::vector<uint8_t> receive;
+    std::vector<uint8_t> packet;
+    std::vector<int32_t> values, previous;
+    bool synced;                 // values/previous hold the last frame received
+    uint32_t last_frame;
+    double last_hello;           // Wall clock
+    double last_keyframe_request;
+    double last_receive;
+    bool ended;
+    NetStreamStats stats;
+};
+
+static void viewer_send(NetStreamViewer* viewer, uint8_t type, uint8_t flags) {
+    packet_begin(viewer->packet, type, flags);
+    socket_send(viewer->sock, viewer->packet.data(), viewer->packet.size(), &viewer->server);
+}
+
+// Store an INFO packet. Returns false if it isn't a valid stream description.
+static bool viewer_take_info(NetStreamViewer* viewer, const uint8_t* data, int size) {
+    size_t offset = sizeof(NetStreamPacket);
+    if ((size_t)size < offset + sizeof(ReplayHeader)) return false;
+    ReplayHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    offset += sizeof(header);
+    if (header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION || header.dt <= 0.0f ||
+        header.cylinder_count > NET_STREAM_MAX_DATAGRAM / 2 ||   // A keyframe holds a byte or more per channel
+        (size_t)size != offset + header.robot_count * sizeof(ReplayRobotInfo) ||
+        !memchr(header.scene_path, '\0', sizeof(header.scene_path))) {
+        return false;
+    }
+
+    std::vector<ReplayRobotInfo> robots(header.robot_count);
+    std::vector<uint32_t> wheel_counts(header.robot_count);
+    for (uint32_t i = 0; i < header.robot_count; i++) {
+        memcpy(&robots[i], data + offset + i * sizeof(ReplayRobotInfo), sizeof(ReplayRobotInfo));
+        if (robots[i].wheel_count > ROBOTDEF_MAX_WHEELS ||
+            !memchr(robots[i].mpd_file, '\0', sizeof(robots[i].mpd_file))) {
+            return false;
+        }
+        wheel_counts[i] = robots[i].wheel_count;
+    }
+
+    viewer->header = header;
+    viewer->robots = robots;
+    replay_layout_build(&viewer->layout, wheel_counts.data(), header.robot_count, header.cylinder_count, true);
+    viewer->synced = false;
+    return true;
+}
+
+NetStreamViewer* net_stream_viewer_open(const char* address, double timeout) {
+    char host[256];
+    int port = NET_STREAM_DEFAULT_PORT;
+    snprintf(host, sizeof(host), "%s", address);
+    char* colon = strrchr(host, ':');
+    if (colon) {
+        *colon = '\0';
+        port = atoi(colon + 1);
+    }
+    if (host[0] == '\0' || port <= 0 || port > 65535) {
+        fprintf(stderr, "[Stream] Invalid server address: %s\n", address);
+        return NULL;
+    }
+    if (!socket_startup()) return NULL;
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = NULL;
+    char port_text[16];
+    snprintf(port_text, sizeof(port_text), "%d", port);
+    NetSocket sock = NET_INVALID_SOCKET;
+    if (getaddrinfo(host, port_text, &hints, &found) != 0 || !found) {
+        fprintf(stderr, "[Stream] Can't resolve %s\n", host);
+    } else if ((sock = socket_open(0)) == NET_INVALID_SOCKET) {
+        fprintf(stderr, "[Stream] Can't open a UDP socket\n");
+    }
+    if (sock == NET_INVALID_SOCKET) {
+        if (found) freeaddrinfo(found);
+        socket_cleanup();
+        return NULL;
+    }
+
+    NetStreamViewer* viewer = new NetStreamViewer();
+    viewer->sock = sock;
+    memcpy(&viewer->server, found->ai_addr, sizeof(viewer->server));
+    freeaddrinfo(found);
+    viewer->receive.resize(NET_STREAM_MAX_DATAGRAM);
+    viewer->synced = false;
+    viewer->last_frame = 0;
+    viewer->ended = false;
+    memset(&viewer->stats, 0, sizeof(viewer->stats));
+
+    // Ask until the server describes the stream
+    printf("[Stream] Joining %s:%d...\n", host, port);
+    double start = wall_seconds();
+    double last_ask = -1.0;
+    bool joined = false;
+    while (!joined && wall_seconds() - start < timeout) {
+        double now = wall_seconds();
+        if (now - last_ask >= NET_STREAM_KEYFRAME_RETRY) {
+            viewer_send(viewer, NET_STREAM_HELLO, NET_STREAM_WANT_INFO | NET_STREAM_WANT_KEYFRAME);
+            last_ask = now;
+        }
+        sockaddr_in from;
+        int size;
+        while (!joined && (size = socket_receive(sock, viewer->receive.data(), (int)viewer->receive.size(), &from)) >= 0) {
+            const NetStreamPacket* packet = packet_header(viewer->receive.data(), size);
+            joined = packet && packet->type == NET_STREAM_INFO && same_address(&from, &viewer->server) &&
+                     viewer_take_info(viewer, viewer->receive.data(), size);
+        }
+        if (!joined) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!joined) {
+        fprintf(stderr, "[Stream] No answer from %s:%d\n", host, port);
+        net_stream_viewer_close(viewer);
+        return NULL;
+    }
+
+    viewer->last_hello = wall_seconds();
+    viewer->last_keyframe_request = viewer->last_hello;
+    viewer->last_receive = viewer->last_hello;
+    printf("[Stream] Joined %s:%d: %u robots, %u cylinders at %.0f Hz, scene %s\n", host, port,
+           viewer->header.robot_count, viewer->header.cylinder_count, 1.0 / viewer->header.dt,
+           viewer->header.scene_path);
+    return viewer;
+}
+
+const ReplayHeader* net_stream_viewer_header(const NetStreamViewer* viewer) {
+    return &viewer->header;
+}
+
+bool net_stream_viewer_matches_world(const NetStreamViewer* viewer, const SimWorld* world) {
+    return replay_robots_match(viewer->robots.data(), viewer->header.robot_count, viewer->header.cylinder_count,
+                               world);
+}
+
+bool net_stream_viewer_poll(NetStreamViewer* viewer, ReplayFrame* out, int* active_robot) {
+    double now = wall_seconds();
+    bool updated = false;
+    NetStreamFrame newest = {};
+    sockaddr_in from;
+    int size;
+    while ((size = socket_receive(viewer->sock, viewer->receive.data(), (int)viewer->receive.size(), &from)) >= 0) {
+        const NetStreamPacket* packet = packet_header(viewer->receive.data(), size);
+        if (!packet || !same_address(&from, &viewer->server)) continue;
+        viewer->stats.bytes += (uint64_t)size;
+        viewer->last_receive = now;
+
+        if (packet->type == NET_STREAM_BYE) {
+            if (!viewer->ended) printf("[Stream] Server ended the stream\n");
+            viewer->ended = true;
+            continue;
+        }
+        if (packet->type != NET_STREAM_FRAME || size < (int)(sizeof(NetStreamPacket) + sizeof(NetStreamFrame))) {
+            continue;
+        }
+        viewer->ended = false;
+
+        NetStreamFrame frame;
+        memcpy(&frame, viewer->receive.data() + sizeof(NetStreamPacket), sizeof(frame));
+        bool keyframe = (packet->flags & NET_STREAM_KEYFRAME) != 0;
+        if (!keyframe) {
+            if (viewer->synced && frame.frame != viewer->last_frame + 1) {
+                if ((int32_t)(frame.frame - viewer->last_frame) <= 0) continue;   // Late duplicate
+                viewer->synced = false;   // A delta went missing
+            }
+            if (!viewer->synced) {
+                viewer->stats.frames_lost++;
+                continue;
+            }
+        }
+
+        const uint8_t* p = viewer->receive.data() + sizeof(NetStreamPacket) + sizeof(NetStreamFrame);
+        const uint8_t* end = viewer->receive.data() + size;
+        viewer->synced = replay_decode_frame(&viewer->layout, &p, end, keyframe, viewer->values, viewer->previous);
+        if (!viewer->synced) continue;
+        viewer->last_frame = frame.frame;
+        viewer->stats.frames++;
+        if (keyframe) viewer->stats.keyframes++;
+        newest = frame;
+        updated = true;
+    }
+
+    // Keep the server sending; ask for a keyframe when out of sync
+    if (!viewer->synced && now - viewer->last_keyframe_request >= NET_STREAM_KEYFRAME_RETRY) {
+        viewer_send(viewer, NET_STREAM_HELLO, NET_STREAM_WANT_KEYFRAME);
+        viewer->last_keyframe_request = now;
+        viewer->last_hello = now;
+    } else if (now - viewer->last_hello >= NET_STREAM_HELLO_INTERVAL) {
+        viewer_send(viewer, NET_STREAM_HELLO, 0);
+        viewer->last_hello = now;
+    }
+
+    if (!updated) return false;
+    out->frame = newest.frame;
+    out->time = newest.time;
+    replay_layout_load(&viewer->layout, viewer->values.data(), out);
+    if (active_robot) *active_robot = newest.active_robot;
+    return true;
+}
+
+double net_stream_viewer_idle(const NetStreamViewer* viewer) {
+    return wall_seconds() - viewer->last_receive;
+}
+
+bool net_stream_viewer_ended(const NetStreamViewer* viewer) {
+    return viewer->ended;
+}
+
+const NetStreamStats* net_stream_viewer_stats(const NetStreamViewer* viewer) {
+    return &viewer->stats;
+}
+
+void net_stream_viewer_close(NetStreamViewer* viewer) {
+    if (!viewer) return;
+    viewer_send(viewer, NET_STREAM_BYE, 0);
+    socket_close(viewer->sock);
+    socket_cleanup();
+    delete viewer;
+}
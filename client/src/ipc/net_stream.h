@@ -0,0 +1,135 @@
+/*
+ * Network Match Stream
+ * One simulation streams its state to any number of viewers over UDP.
+ *
+ * A viewer runs no physics and no robot programs: it loads the scene and
+ * robot models named by the server, then only poses them from the frames
+ * it receives (like a replay). Frames use the replay codec (sim/replay.h)
+ * with a HUD group per robot added: quantized poses, wheel spin, motor and
+ * pneumatic state, cylinders and drivetrain telemetry, delta coded against
+ * a prediction from the previous two frames. A robot driving steadily or
+ * parked costs a few bytes per frame; two robots driving at 60 Hz take about
+ * 4 KB/s per viewer including UDP/IP headers.
+ *
+ * Every datagram starts with a NetStreamPacket header:
+ *   HELLO  viewer -> server, once a second while viewing (keepalive); flags
+ *          ask for the INFO packet and/or a keyframe
+ *   INFO   server -> viewer: ReplayHeader (dt = seconds between frames) and
+ *          one ReplayRobotInfo per robot
+ *   FRAME  server -> viewer: NetStreamFrame and the coded frame
+ *   BYE    either way: stop sending to me / the stream ended
+ *
+ * A keyframe goes out every REPLAY_KEYFRAME_SECONDS and whenever a viewer
+ * asks for one. Deltas only decode on top of the frame before them, so a
+ * viewer that misses a datagram drops deltas until the next keyframe and
+ * asks for one at once; a lost packet costs a frame or two, never a wrong
+ * pose. Viewers that stop sending HELLO are dropped after
+ * NET_STREAM_VIEWER_TIMEOUT. Sockets are nonblocking on both sides: a full
+ * send buffer drops the datagram like the network would.
+ *
+ * Server (on the stepping thread, before every step):
+ *   NetStreamServer* server = net_stream_server_open(port, &world, scene_path, 60.0f);
+ *   each step: net_stream_server_step(server, &world, actuators, active_robot);
+ *   net_stream_server_close(server);
+ *
+ * Viewer:
+ *   NetStreamViewer* viewer = net_stream_viewer_open("host:port", timeout);   // blocks for INFO
+ *   load net_stream_viewer_header(viewer)->scene_path, check net_stream_viewer_matches_world()
+ *   each frame: if (net_stream_viewer_poll(viewer, &frame, &active_robot)) replay_apply_frame(&frame, &world);
+ *   net_stream_viewer_close(viewer);
+ */
+
+#ifndef NET_STREAM_H
+#define NET_STREAM_H
+
+#include "../sim/replay.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NET_STREAM_MAGIC 0x54535856          // "VXST"
+#define NET_STREAM_VERSION 1
+#define NET_STREAM_DEFAULT_PORT 47600
+#define NET_STREAM_DEFAULT_RATE 60.0f        // Frames per second
+#define NET_STREAM_MAX_VIEWERS 64
+#define NET_STREAM_HELLO_INTERVAL 1.0        // Seconds between viewer keepalives
+#define NET_STREAM_VIEWER_TIMEOUT 5.0        // Seconds without a HELLO before a viewer is dropped
+#define NET_STREAM_KEYFRAME_RETRY 0.25       // Seconds between a viewer's keyframe requests
+#define NET_STREAM_MAX_DATAGRAM 65507        // Largest UDP payload
+
+enum NetStreamPacketType {
+    NET_STREAM_HELLO = 1,
+    NET_STREAM_INFO = 2,
+    NET_STREAM_FRAME = 3,
+    NET_STREAM_BYE = 4
+};
+
+// NetStreamPacket::flags
+#define NET_STREAM_WANT_INFO 0x01            // HELLO: send INFO
+#define NET_STREAM_WANT_KEYFRAME 0x02        // HELLO: next frame is a keyframe
+#define NET_STREAM_KEYFRAME 0x04             // FRAME: coded as a keyframe
+
+typedef struct NetStreamPacket {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t type;                            // NetStreamPacketType
+    uint8_t flags;
+} NetStreamPacket;
+
+typedef struct NetStreamFrame {
+    uint32_t frame;                          // Stream frame number (consecutive)
+    int32_t active_robot;                    // Robot receiving gamepad input (-1 = none)
+    double time;                             // Simulated seconds
+} NetStreamFrame;
+
+// Traffic counters
+typedef struct NetStreamStats {
+    int viewers;                             // Server: viewers now
+    uint64_t frames;                         // Frames sent / received and applied
+    uint64_t keyframes;
+    uint64_t frames_lost;                    // Viewer: deltas dropped out of sync
+    uint64_t bytes;                          // Sent / received, UDP payload only
+} NetStreamStats;
+
+struct NetStreamServer;
+struct NetStreamViewer;
+
+// Serve world on UDP port (all interfaces) at rate frames per second of
+// simulated time. Returns NULL if the socket can't be bound.
+NetStreamServer* net_stream_server_open(int port, const SimWorld* world, const char* scene_path, float rate);
+
+// Answer viewers and send the world's current state when a frame is due.
+// actuators: one per robot (indexed like world->robots), or NULL.
+void net_stream_server_step(NetStreamServer* server, const SimWorld* world, const ReplayActuators* actuators,
+                            int active_robot);
+
+const NetStreamStats* net_stream_server_stats(const NetStreamServer* server);
+
+// Tell every viewer the stream ended and free the server (NULL is ignored)
+void net_stream_server_close(NetStreamServer* server);
+
+// Join the server at address ("host" or "host:port"), waiting up to
+// timeout seconds for its INFO packet. Returns NULL on failure.
+NetStreamViewer* net_stream_viewer_open(const char* address, double timeout);
+
+// Stream description: scene, robot count, frame dt
+const ReplayHeader* net_stream_viewer_header(const NetStreamViewer* viewer);
+
+// True if world has the stream's robots and cylinders
+bool net_stream_viewer_matches_world(const NetStreamViewer* viewer, const SimWorld* world);
+
+// Receive everything queued and decode the newest frame into out (and its
+// active robot). Returns false if no new frame arrived.
+bool net_stream_viewer_poll(NetStreamViewer* viewer, ReplayFrame* out, int* active_robot);
+
+// Seconds since the last frame arrived
+double net_stream_viewer_idle(const NetStreamViewer* viewer);
+
+// The server sent BYE
+bool net_stream_viewer_ended(const NetStreamViewer* viewer);
+
+const NetStreamStats* net_stream_viewer_stats(const NetStreamViewer* viewer);
+
+// Leave the stream and free the viewer (NULL is ignored)
+void net_stream_viewer_close(NetStreamViewer* viewer);
+
+#endif // NET_STREAM_H
@@ -1,205 +1,206 @@
 /*
  * Python Bridge implementation
- * Handles subprocess management and JSON message parsing
+ * Handles subprocess management, JSON message parsing and binary framing
  */
 
 #include "python_bridge.h"
+#include "python_embed.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <unistd.h>
+#include <time.h>
 #endif
 
-// Simple JSON parsing helpers (no external dependencies)
-static const char* json_find_key(const char* json, const char* key) {
-    char search[128];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    return strstr(json, search);
+// Single-pass JSON reader (no external dependencies)
+// Walks a message once, left to right; values are decoded straight into
+// their destination. Any syntax error clears ok and the caller discards
+// the whole message.
+typedef struct JsonReader {
+    const char* p;
+    bool ok;
+} JsonReader;
+
+static void json_skip_ws(JsonReader* r) {
+    while (*r->p && isspace((unsigned char)*r->p)) r->p++;
 }
 
-static int json_get_int(const char* json, const char* key, int default_val) {
-    const char* pos = json_find_key(json, key);
-    if (!pos) return default_val;
-
-    pos = strchr(pos, ':');
-    if (!pos) return default_val;
-    pos++;
-
-    while (*pos && isspace(*pos)) pos++;
-    return atoi(pos);
+static bool json_expect(JsonReader* r, char c) {
+    json_skip_ws(r);
+    if (*r->p != c) { r->ok = false; return false; }
+    r->p++;
+    return true;
 }
 
-static float json_get_float(const char* json, const char* key, float default_val) {
-    const char* pos = json_find_key(json, key);
-    if (!pos) return default_val;
-
-    pos = strchr(pos, ':');
-    if (!pos) return default_val;
-    pos++;
-
-    while (*pos && isspace(*pos)) pos++;
-    return (float)atof(pos);
+static char json_peek(JsonReader* r) {
+    json_skip_ws(r);
+    return *r->p;
 }
 
-static bool json_get_bool(const char* json, const char* key, bool default_val) {
-    const char* pos = json_find_key(json, key);
-    if (!pos) return default_val;
-
-    pos = strchr(pos, ':');
-    if (!pos) return default_val;
-    pos++;
-
-    while (*pos && isspace(*pos)) pos++;
-    return (strncmp(pos, "true", 4) == 0);
+// Consume c if it is next (for optional separators / closers)
+static bool json_accept(JsonReader* r, char c) {
+    json_skip_ws(r);
+    if (*r->p != c) return false;
+    r->p++;
+    return true;
 }
 
-static void json_get_string(const char* json, const char* key, char* out, size_t out_size) {
-    out[0] = '\0';
-    const char* pos = json_find_key(json, key);
-    if (!pos) return;
-
-    pos = strchr(pos, ':');
-    if (!pos) return;
-    pos++;
-
-    while (*pos && isspace(*pos)) pos++;
-    if (*pos != '"') return;
-    pos++;
-
+// Read a string into out (truncated to out_size, may be NULL to skip)
+static void json_read_string(JsonReader* r, char* out, size_t out_size) {
     size_t i = 0;
-    while (*pos && *pos != '"' && i < out_size - 1) {
-        out[i++] = *pos++;
+    if (!json_expect(r, '"')) return;
+    while (*r->p && *r->p != '"') {
+        char c = *r->p++;
+        if (c == '\\') {
+            c = *r->p++;
+            switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'u':  // Non-ASCII escapes are replaced, not decoded
+                    for (int k = 0; k < 4 && *r->p; k++) r->p++;
+                    c = '?';
+                    break;
+                case '\0': r->ok = false; return;
+                default: break;  // \" \\ \/ map to themselves
+            }
+        }
+        if (out && i + 1 < out_size) out[i++] = c;
     }
-    out[i] = '\0';
+    if (out && out_size > 0) out[i] = '\0';
+    if (*r->p != '"') { r->ok = false; return; }
+    r->p++;
 }
 
-// Parse motor states from JSON
-static void parse_motors(const char* json, RobotState* state) {
-    state->motor_count = 0;
+static double json_read_number(JsonReader* r) {
+    json_skip_ws(r);
+    char* end;
+    double v = strtod(r->p, &end);
+    if (end == r->p) { r->ok = false; return 0.0; }
+    r->p = end;
+    return v;
+}
+
+static bool json_read_bool(JsonReader* r) {
+    json_skip_ws(r);
+    if (strncmp(r->p, "true", 4) == 0) { r->p += 4; return true; }
+    if (strncmp(r->p, "false", 5) == 0) { r->p += 5; return false; }
+    r->ok = false;
+    return false;
+}
 
-    const char* motors_pos = json_find_key(json, "motors");
-    if (!motors_pos) return;
-
-    // Find the opening brace for motors object
-    motors_pos = strchr(motors_pos, '{');
-    if (!motors_pos) return;
-    motors_pos++;
-
-    // Simple parsing: look for "port":{...} patterns
-    // Format: "1":{"speed":0,"spinning":false,"position":0.0}
-    while (*motors_pos && state->motor_count < MAX_MOTORS) {
-        // Skip whitespace
-        while (*motors_pos && isspace(*motors_pos)) motors_pos++;
-
-        if (*motors_pos == '}') break;  // End of motors object
-        if (*motors_pos == ',') { motors_pos++; continue; }
-
-        // Look for port number in quotes
-        if (*motors_pos == '"') {
-            motors_pos++;
-            int port = atoi(motors_pos);
-            if (port > 0) {
-                // Find the motor object
-                const char* motor_start = strchr(motors_pos, '{');
-                if (motor_start) {
-                    // Find matching closing brace
-                    const char* motor_end = strchr(motor_start, '}');
-                    if (motor_end) {
-                        char motor_json[256];
-                        size_t len = motor_end - motor_start + 1;
-                        if (len < sizeof(motor_json)) {
-                            memcpy(motor_json, motor_start, len);
-                            motor_json[len] = '\0';
-
-                            MotorState* m = &state->motors[state->motor_count];
-                            m->port = port;
-                            m->speed = json_get_int(motor_json, "speed", 0);
-                            m->spinning = json_get_bool(motor_json, "spinning", false);
-                            m->position = json_get_float(motor_json, "position", 0.0f);
-                            state->motor_count++;
-                        }
-                        motors_pos = motor_end + 1;
-                        continue;
-                    }
-                }
+// Skip any value (nested objects/arrays included)
+static void json_skip_value(JsonReader* r) {
+    json_skip_ws(r);
+    char c = *r->p;
+    if (c == '"') {
+        json_read_string(r, NULL, 0);
+    } else if (c == '{' || c == '[') {
+        char close = (c == '{') ? '}' : ']';
+        r->p++;
+        if (json_accept(r, close)) return;
+        do {
+            if (c == '{') {
+                json_read_string(r, NULL, 0);
+                json_expect(r, ':');
             }
-        }
-        motors_pos++;
+            json_skip_value(r);
+        } while (r->ok && json_accept(r, ','));
+        json_expect(r, close);
+    } else if (c == 't' || c == 'f') {
+        json_read_bool(r);
+    } else if (strncmp(r->p, "null", 4) == 0) {
+        r->p += 4;
+    } else {
+        json_read_number(r);
     }
 }
 
-// Parse pneumatic states from JSON
-static void parse_pneumatics(const char* json, RobotState* state) {
-    state->pneumatic_count = 0;
+// Iterate the members of an object: call with the reader positioned at '{'
+// (first = true) and after each value (first = false). Returns false at
+// the closing brace or on error; otherwise the key is in key.
+static bool json_next_key(JsonReader* r, bool first, char* key, size_t key_size) {
+    if (first) {
+        if (!json_expect(r, '{')) return false;
+        if (json_accept(r, '}')) return false;
+    } else {
+        if (json_accept(r, '}')) return false;
+        if (!json_expect(r, ',')) return false;
+    }
+    json_read_string(r, key, key_size);
+    json_expect(r, ':');
+    return r->ok;
+}
 
-    const char* pneu_pos = json_find_key(json, "pneumatics");
-    if (!pneu_pos) return;
-
-    pneu_pos = strchr(pneu_pos, '{');
-    if (!pneu_pos) return;
-    pneu_pos++;
-
-    while (*pneu_pos && state->pneumatic_count < MAX_PNEUMATICS) {
-        while (*pneu_pos && isspace(*pneu_pos)) pneu_pos++;
-
-        if (*pneu_pos == '}') break;
-        if (*pneu_pos == ',') { pneu_pos++; continue; }
-
-        if (*pneu_pos == '"') {
-            pneu_pos++;
-            int port = atoi(pneu_pos);
-            if (port > 0) {
-                const char* pneu_start = strchr(pneu_pos, '{');
-                if (pneu_start) {
-                    const char* pneu_end = strchr(pneu_start, '}');
-                    if (pneu_end) {
-                        char pneu_json[128];
-                        size_t len = pneu_end - pneu_start + 1;
-                        if (len < sizeof(pneu_json)) {
-                            memcpy(pneu_json, pneu_start, len);
-                            pneu_json[len] = '\0';
-
-                            PneumaticState* p = &state->pneumatics[state->pneumatic_count];
-                            p->port = port;
-                            p->extended = json_get_bool(pneu_json, "extended", false);
-                            p->pump_on = json_get_bool(pneu_json, "pump", false);
-                            state->pneumatic_count++;
-                        }
-                        pneu_pos = pneu_end + 1;
-                        continue;
-                    }
-                }
-            }
+// "motors":{"1":{"speed":0,"spinning":false,"position":0.0},...}
+static void json_read_motors(JsonReader* r, MotorState* motors, int* count) {
+    char key[16];
+    *count = 0;
+    for (bool first = true; json_next_key(r, first, key, sizeof(key)); first = false) {
+        int port = atoi(key);
+        if (port <= 0 || *count >= MAX_MOTORS) { json_skip_value(r); continue; }
+
+        MotorState* m = &motors[(*count)++];
+        m->port = port;
+        m->speed = 0;
+        m->spinning = false;
+        m->position = 0.0f;
+
+        char field[16];
+        for (bool f = true; json_next_key(r, f, field, sizeof(field)); f = false) {
+            if (strcmp(field, "speed") == 0) m->speed = (int)json_read_number(r);
+            else if (strcmp(field, "spinning") == 0) m->spinning = json_read_bool(r);
+            else if (strcmp(field, "position") == 0) m->position = (float)json_read_number(r);
+            else json_skip_value(r);
         }
-        pneu_pos++;
     }
 }
 
-// Process a complete JSON message from Python
-static void process_message(PythonBridge* bridge, const char* json) {
-    char type[32];
-    json_get_string(json, "type", type, sizeof(type));
+// "pneumatics":{"9":{"extended":true,"pump":false},...}
+static void json_read_pneumatics(JsonReader* r, PneumaticState* pneumatics, int* count) {
+    char key[16];
+    *count = 0;
+    for (bool first = true; json_next_key(r, first, key, sizeof(key)); first = false) {
+        int port = atoi(key);
+        if (port <= 0 || *count >= MAX_PNEUMATICS) { json_skip_value(r); continue; }
+
+        PneumaticState* p = &pneumatics[(*count)++];
+        p->port = port;
+        p->extended = false;
+        p->pump_on = false;
+
+        char field[16];
+        for (bool f = true; json_next_key(r, f, field, sizeof(field)); f = false) {
+            if (strcmp(field, "extended") == 0) p->extended = json_read_bool(r);
+            else if (strcmp(field, "pump") == 0) p->pump_on = json_read_bool(r);
+            else json_skip_value(r);
+        }
+    }
+}
 
+// Apply a ready/status/error/shutdown message (JSON or embedded)
+static void apply_message(PythonBridge* bridge, const char* type, const char* project,
+                          const char* protocol, const char* message) {
     if (strcmp(type, "ready") == 0) {
-        json_get_string(json, "project", bridge->project_name, sizeof(bridge->project_name));
+        snprintf(bridge->project_name, sizeof(bridge->project_name), "%s", project);
         bridge->robot_ready = true;
-        printf("[Bridge] Robot ready: %s\n", bridge->project_name);
-    }
-    else if (strcmp(type, "state") == 0) {
-        parse_motors(json, &bridge->state);
-        parse_pneumatics(json, &bridge->state);
+
+        bridge->binary = (strcmp(protocol, "binary") == 0);
+        printf("[Bridge] Robot ready: %s (%s protocol)\n", bridge->project_name,
+               bridge->embed ? "embedded" : bridge->binary ? "binary" : "JSON");
     }
     else if (strcmp(type, "status") == 0) {
-        json_get_string(json, "message", bridge->state.status, sizeof(bridge->state.status));
+        snprintf(bridge->state.status, sizeof(bridge->state.status), "%s", message);
         printf("[Bridge] Status: %s\n", bridge->state.status);
     }
     else if (strcmp(type, "error") == 0) {
-        json_get_string(json, "message", bridge->state.error, sizeof(bridge->state.error));
+        snprintf(bridge->state.error, sizeof(bridge->state.error), "%s", message);
         fprintf(stderr, "[Bridge] Error: %s\n", bridge->state.error);
     }
     else if (strcmp(type, "shutdown") == 0) {
@@ -208,15 +209,141 @@ static void process_message(PythonBridge* bridge, const char* json) {
     }
 }
 
-bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const char* simulator_dir) {
-    memset(bridge, 0, sizeof(PythonBridge));
-    bridge->tick_interval = 1.0 / 60.0;  // 60 Hz default
+// Process a complete JSON message from Python
+// Fields are collected in one pass, then applied only if the whole
+// message parsed, so a malformed line never clobbers the last good state.
+static void process_message(PythonBridge* bridge, const char* json) {
+    char type[32] = "";
+    char project[sizeof(bridge->project_name)] = "";
+    char protocol[16] = "";
+    char message[sizeof(bridge->state.error)] = "";
+    MotorState motors[MAX_MOTORS];
+    PneumaticState pneumatics[MAX_PNEUMATICS];
+    int motor_count = 0, pneumatic_count = 0;
+    double seq = -1.0;
+
+    JsonReader r = {json, true};
+    char key[32];
+    for (bool first = true; json_next_key(&r, first, key, sizeof(key)); first = false) {
+        if (strcmp(key, "type") == 0) json_read_string(&r, type, sizeof(type));
+        else if (strcmp(key, "project") == 0) json_read_string(&r, project, sizeof(project));
+        else if (strcmp(key, "protocol") == 0) json_read_string(&r, protocol, sizeof(protocol));
+        else if (strcmp(key, "message") == 0) json_read_string(&r, message, sizeof(message));
+        else if (strcmp(key, "seq") == 0) seq = json_read_number(&r);
+        // "ready" lists motors/pneumatics as arrays; only "state" maps are read
+        else if (strcmp(key, "motors") == 0 && json_peek(&r) == '{')
+            json_read_motors(&r, motors, &motor_count);
+        else if (strcmp(key, "pneumatics") == 0 && json_peek(&r) == '{')
+            json_read_pneumatics(&r, pneumatics, &pneumatic_count);
+        else json_skip_value(&r);
+    }
+    if (!r.ok) {
+        fprintf(stderr, "[Bridge] Ignoring malformed message: %.64s\n", json);
+        return;
+    }
+
+    if (strcmp(type, "state") == 0) {
+        RobotState* state = &bridge->state;
+        state->motor_count = motor_count;
+        memcpy(state->motors, motors, motor_count * sizeof(MotorState));
+        state->pneumatic_count = pneumatic_count;
+        memcpy(state->pneumatics, pneumatics, pneumatic_count * sizeof(PneumaticState));
+        if (seq >= 0.0) bridge->acked_seq = (uint32_t)seq;
+    }
+    else {
+        apply_message(bridge, type, project, protocol, message);
+    }
+}
 
+// Little-endian field access for binary frames
+static uint32_t frame_get_u32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void frame_put_u32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static float frame_get_f32(const unsigned char* p) {
+    uint32_t bits = frame_get_u32(p);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static void frame_put_f32(unsigned char* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    frame_put_u32(p, bits);
+}
+
+// Parse a binary STATE frame (layout in python_bridge.h)
+// seq is set to the answered tick if the frame carries one
+static void parse_state_frame(const unsigned char* payload, int len, RobotState* state, uint32_t* seq) {
+    if (len < 2) return;
+    int motor_count = payload[0];
+    int pneumatic_count = payload[1];
+    int body_len = 2 + motor_count * 10 + pneumatic_count * 2;
+    if (len < body_len) return;
+    if (len >= body_len + 4) *seq = frame_get_u32(payload + body_len);
+
+    const unsigned char* p = payload + 2;
+    state->motor_count = 0;
+    for (int i = 0; i < motor_count; i++, p += 10) {
+        if (state->motor_count >= MAX_MOTORS) continue;
+        MotorState* m = &state->motors[state->motor_count++];
+        m->port = p[0];
+        m->spinning = p[1] != 0;
+        m->speed = (int)frame_get_f32(p + 2);  // Truncated like the JSON path
+        m->position = frame_get_f32(p + 6);
+    }
+
+    state->pneumatic_count = 0;
+    for (int i = 0; i < pneumatic_count; i++, p += 2) {
+        if (state->pneumatic_count >= MAX_PNEUMATICS) continue;
+        PneumaticState* pn = &state->pneumatics[state->pneumatic_count++];
+        pn->port = p[0];
+        pn->extended = (p[1] & 1) != 0;
+        pn->pump_on = (p[1] & 2) != 0;
+    }
+}
+
+// Process a complete binary frame from Python
+static void process_frame(PythonBridge* bridge, int type, const unsigned char* payload, int len) {
+    if (type == BRIDGE_FRAME_STATE) {
+        parse_state_frame(payload, len, &bridge->state, &bridge->acked_seq);
+    }
+}
+
+// Largest C++ -> Python payload: a TICK with MAX_SENSORS readings
+#define BRIDGE_FRAME_MAX_OUT 128
+static_assert(9 + MAX_SENSORS * 9 <= BRIDGE_FRAME_MAX_OUT, "tick frame must fit");
+
+static void send_frame(PythonBridge* bridge, int type, const unsigned char* payload, int len) {
+    unsigned char frame[BRIDGE_FRAME_HEADER + BRIDGE_FRAME_MAX_OUT];
+    frame[0] = BRIDGE_FRAME_MAGIC;
+    frame[1] = (unsigned char)type;
+    frame[2] = (unsigned char)len;
+    frame[3] = (unsigned char)(len >> 8);
+    memcpy(frame + BRIDGE_FRAME_HEADER, payload, len);
+    subprocess_write(&bridge->process, (const char*)frame, BRIDGE_FRAME_HEADER + len);
+}
+
+static signed char clamp_axis(int v) {
+    if (v < -127) return -127;
+    if (v > 127) return 127;
+    return (signed char)v;
+}
+
+bool python_bridge_command(char* command, size_t command_size, const char* simulator_dir,
+                           const char* args) {
     // Get path to bundled Python
     // Exe is at: client/build-*/vexiq_sim
     // Python is at: python-linux/bin/python3 or python-win/python.exe
     char python_path[512];
-    char command[1024];
 
 #ifdef _WIN32
     // Get exe directory
@@ -238,8 +365,8 @@ bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const c
         printf("[Bridge] Using bundled Python: %s\n", python_path);
     }
 
-    snprintf(command, sizeof(command), "\"%s\" \"%s\\ipc_bridge.py\" \"%s\"",
-             python_path, simulator_dir, iqpython_path);
+    int n = snprintf(command, command_size, "\"%s\" \"%s\\ipc_bridge.py\" %s",
+                     python_path, simulator_dir, args);
 #else
     // Get exe directory via /proc/self/exe
     char exe_dir[512];
@@ -264,9 +391,36 @@ bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const c
         printf("[Bridge] Using bundled Python: %s\n", python_path);
     }
 
-    snprintf(command, sizeof(command), "\"%s\" \"%s/ipc_bridge.py\" \"%s\"",
-             python_path, simulator_dir, iqpython_path);
+    int n = snprintf(command, command_size, "\"%s\" \"%s/ipc_bridge.py\" %s",
+                     python_path, simulator_dir, args);
 #endif
+    return n > 0 && (size_t)n < command_size;
+}
+
+bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const char* simulator_dir,
+                        bool lockstep) {
+    memset(bridge, 0, sizeof(PythonBridge));
+    bridge->tick_interval = 1.0 / 60.0;  // 60 Hz default
+    bridge->lockstep = lockstep;
+
+    if (PYTHON_BRIDGE_EMBEDDED) {
+        bridge->embed = python_embed_start(iqpython_path, simulator_dir, lockstep);
+        if (bridge->embed) {
+            bridge->connected = true;
+            printf("[Bridge] Running %s in-process\n", iqpython_path);
+            return true;
+        }
+        fprintf(stderr, "[Bridge] Embedded Python unavailable, spawning a process\n");
+    }
+
+    char args[1100];
+    char command[2048];
+    snprintf(args, sizeof(args), "\"%s\"%s%s", iqpython_path,
+             PYTHON_BRIDGE_BINARY ? " --binary" : "", lockstep ? " --lockstep" : "");
+    if (!python_bridge_command(command, sizeof(command), simulator_dir, args)) {
+        fprintf(stderr, "[Bridge] Command line too long\n");
+        return false;
+    }
 
     printf("[Bridge] Spawning: %s\n", command);
 
@@ -281,9 +435,65 @@ bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const c
     return true;
 }
 
+// Escape a path for a JSON string value
+static void json_escape(const char* in, char* out, size_t out_size) {
+    size_t o = 0;
+    for (const char* p = in; *p && o + 2 < out_size; p++) {
+        if (*p == '"' || *p == '\\') out[o++] = '\\';
+        out[o++] = *p;
+    }
+    out[o] = '\0';
+}
+
+bool python_bridge_init_pooled(PythonBridge* bridge, PythonPool* pool, const char* iqpython_path,
+                               bool lockstep) {
+    memset(bridge, 0, sizeof(PythonBridge));
+    bridge->tick_interval = 1.0 / 60.0;  // 60 Hz default
+    bridge->lockstep = lockstep;
+
+    if (!python_pool_lease(pool, &bridge->process, PYTHON_POOL_LEASE_TIMEOUT_MS)) {
+        fprintf(stderr, "[Bridge] No pooled Python worker available\n");
+        return false;
+    }
+    bridge->pool = pool;
+
+    char path[2048];
+    char message[2200];
+    json_escape(iqpython_path, path, sizeof(path));
+    snprintf(message, sizeof(message), "{\"type\":\"load\",\"path\":\"%s\",\"lockstep\":%s}\n",
+             path, lockstep ? "true" : "false");
+    subprocess_write_str(&bridge->process, message);
+
+    bridge->connected = true;
+    printf("[Bridge] Loaded %s into pooled worker\n", iqpython_path);
+    return true;
+}
+
 void python_bridge_send_gamepad(PythonBridge* bridge, Gamepad* gamepad) {
     if (!bridge->connected) return;
 
+    if (bridge->binary || bridge->embed) {
+        unsigned char payload[5];
+        payload[0] = (unsigned char)clamp_axis(gamepad->axes.a);
+        payload[1] = (unsigned char)clamp_axis(gamepad->axes.b);
+        payload[2] = (unsigned char)clamp_axis(gamepad->axes.c);
+        payload[3] = (unsigned char)clamp_axis(gamepad->axes.d);
+        payload[4] = (unsigned char)((gamepad->buttons.l_up   ? 1 << 0 : 0) |
+                                     (gamepad->buttons.l_down ? 1 << 1 : 0) |
+                                     (gamepad->buttons.r_up   ? 1 << 2 : 0) |
+                                     (gamepad->buttons.r_down ? 1 << 3 : 0) |
+                                     (gamepad->buttons.e_up   ? 1 << 4 : 0) |
+                                     (gamepad->buttons.e_down ? 1 << 5 : 0) |
+                                     (gamepad->buttons.f_up   ? 1 << 6 : 0) |
+                                     (gamepad->buttons.f_down ? 1 << 7 : 0));
+        if (bridge->embed) {
+            python_embed_send_gamepad(bridge->embed, (const signed char*)payload, payload[4]);
+            return;
+        }
+        send_frame(bridge, BRIDGE_FRAME_GAMEPAD, payload, sizeof(payload));
+        return;
+    }
+
     char buffer[512];
     gamepad_to_json(gamepad, buffer, sizeof(buffer));
 
@@ -292,66 +502,307 @@ void python_bridge_send_gamepad(PythonBridge* bridge, Gamepad* gamepad) {
     subprocess_write_str(&bridge->process, buffer);
 }
 
+void python_bridge_set_sensors(PythonBridge* bridge, const SensorReading* sensors, int count) {
+    if (count > MAX_SENSORS) count = MAX_SENSORS;
+    if (count < 0) count = 0;
+    memcpy(bridge->sensors, sensors, (size_t)count * sizeof(SensorReading));
+    bridge->sensor_count = count;
+}
+
+// Color channel (0-1) as a byte
+static unsigned char color_byte(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return (unsigned char)(v * 255.0f + 0.5f);
+}
+
 void python_bridge_send_tick(PythonBridge* bridge, float dt) {
     if (!bridge->connected) return;
 
-    char buffer[64];
-    snprintf(buffer, sizeof(buffer), "{\"type\":\"tick\",\"dt\":%.4f}\n", dt);
+    bridge->tick_seq++;
+
+    if (bridge->embed) {
+        python_embed_send_tick(bridge->embed, dt, bridge->tick_seq, bridge->sensors, bridge->sensor_count);
+        return;
+    }
+
+    if (bridge->binary) {
+        unsigned char payload[9 + MAX_SENSORS * 9];
+        frame_put_f32(payload, dt);
+        frame_put_u32(payload + 4, bridge->tick_seq);
+        payload[8] = (unsigned char)bridge->sensor_count;
+        unsigned char* p = payload + 9;
+        for (int i = 0; i < bridge->sensor_count; i++, p += 9) {
+            const SensorReading* sensor = &bridge->sensors[i];
+            p[0] = (unsigned char)sensor->port;
+            p[1] = (unsigned char)sensor->object;
+            frame_put_f32(p + 2, sensor->distance_mm);
+            p[6] = color_byte(sensor->rgb[0]);
+            p[7] = color_byte(sensor->rgb[1]);
+            p[8] = color_byte(sensor->rgb[2]);
+        }
+        send_frame(bridge, BRIDGE_FRAME_TICK, payload, (int)(p - payload));
+        return;
+    }
+
+    // Full float precision: in lockstep mode dt drives the robot clock
+    char buffer[96 + MAX_SENSORS * 48];
+    int len = snprintf(buffer, sizeof(buffer), "{\"type\":\"tick\",\"dt\":%.9g,\"seq\":%u",
+                       dt, (unsigned)bridge->tick_seq);
+    if (bridge->sensor_count > 0) {
+        // "sensors":[[port, object, distance_mm, r, g, b], ...]
+        len += snprintf(buffer + len, sizeof(buffer) - len, ",\"sensors\":[");
+        for (int i = 0; i < bridge->sensor_count; i++) {
+            const SensorReading* sensor = &bridge->sensors[i];
+            len += snprintf(buffer + len, sizeof(buffer) - len, "%s[%d,%d,%.1f,%.3f,%.3f,%.3f]",
+                            i > 0 ? "," : "", sensor->port, sensor->object, sensor->distance_mm,
+                            sensor->rgb[0], sensor->rgb[1], sensor->rgb[2]);
+        }
+        len += snprintf(buffer + len, sizeof(buffer) - len, "]");
+    }
+    snprintf(buffer + len, sizeof(buffer) - len, "}\n");
     subprocess_write_str(&bridge->process, buffer);
 }
 
+bool python_bridge_send_camera(PythonBridge* bridge, int port, int width, int height, uint32_t frame,
+                               const uint8_t* rgb) {
+    if (!bridge->connected || width <= 0 || height <= 0 || width * height > BRIDGE_CAMERA_MAX_PIXELS) return false;
+
+    if (bridge->embed) {
+        python_embed_send_camera(bridge->embed, port, width, height, frame, rgb);
+        return true;
+    }
+    if (!bridge->binary) return false;
+
+    // Header and image go as two writes; the pipe is blocking, so the frame stays whole
+    int len = BRIDGE_CAMERA_HEADER + width * height * 3;
+    unsigned char header[BRIDGE_FRAME_HEADER + BRIDGE_CAMERA_HEADER];
+    header[0] = BRIDGE_FRAME_MAGIC;
+    header[1] = BRIDGE_FRAME_CAMERA;
+    header[2] = (unsigned char)len;
+    header[3] = (unsigned char)(len >> 8);
+    unsigned char* p = header + BRIDGE_FRAME_HEADER;
+    p[0] = (unsigned char)port;
+    p[1] = (unsigned char)width;
+    p[2] = (unsigned char)(width >> 8);
+    p[3] = (unsigned char)height;
+    p[4] = (unsigned char)(height >> 8);
+    frame_put_u32(p + 5, frame);
+    subprocess_write(&bridge->process, (const char*)header, sizeof(header));
+    subprocess_write(&bridge->process, (const char*)rgb, (size_t)width * height * 3);
+    return true;
+}
+
+// Process complete messages in the read buffer (binary frames and
+// JSON/log lines). Returns the number of bytes consumed.
+static int process_buffer(PythonBridge* bridge, bool* got_message) {
+    int pos = 0;
+    while (pos < bridge->read_pos) {
+        char* msg = bridge->read_buffer + pos;
+        int available = bridge->read_pos - pos;
+
+        // Rest of a discarded oversized message
+        if (bridge->skip_line) {
+            char* newline = (char*)memchr(msg, '\n', available);
+            if (!newline) return bridge->read_pos;
+            bridge->skip_line = false;
+            pos += (int)(newline - msg) + 1;
+            continue;
+        }
+
+        if ((unsigned char)msg[0] == BRIDGE_FRAME_MAGIC) {
+            if (available < BRIDGE_FRAME_HEADER) break;
+            const unsigned char* header = (const unsigned char*)msg;
+            int len = header[2] | (header[3] << 8);
+            if (available < BRIDGE_FRAME_HEADER + len) break;
+
+            process_frame(bridge, header[1], header + BRIDGE_FRAME_HEADER, len);
+            *got_message = true;
+            pos += BRIDGE_FRAME_HEADER + len;
+            continue;
+        }
+
+        char* newline = (char*)memchr(msg, '\n', available);
+        if (!newline) break;
+        *newline = '\0';
+
+        // Process this message
+        if (msg[0] == '{') {
+            process_message(bridge, msg);
+            *got_message = true;
+        }
+
+        pos += (int)(newline - msg) + 1;
+    }
+    return pos;
+}
+
+// Next chunk of stdout: from the reactor ring when attached, else the pipe
+static int bridge_read(PythonBridge* bridge, char* buffer, size_t size) {
+    if (bridge->channel.reactor) return io_channel_read(&bridge->channel, buffer, size);
+    return subprocess_read(&bridge->process, buffer, size);
+}
+
+// Embedded: take posted state and messages straight from the shared structs
+static bool update_embedded(PythonBridge* bridge) {
+    bool got_message = python_embed_take_state(bridge->embed, &bridge->state, &bridge->acked_seq);
+
+    char type[32];
+    char text[sizeof(bridge->state.error)];
+    while (python_embed_next_message(bridge->embed, type, sizeof(type), text, sizeof(text))) {
+        apply_message(bridge, type, text, "embedded", text);
+        got_message = true;
+    }
+
+    if (python_embed_finished(bridge->embed)) bridge->connected = false;
+    return got_message;
+}
+
 bool python_bridge_update(PythonBridge* bridge) {
     if (!bridge->connected) return false;
+    if (bridge->embed) return update_embedded(bridge);
 
-    // Check if process is still running
-    if (!subprocess_is_running(&bridge->process)) {
+    // Check if process is still running (attached bridges: only once the
+    // pipe has closed, after the last buffered messages are processed below)
+    bool attached = bridge->channel.reactor != NULL;
+    if (!attached && !subprocess_is_running(&bridge->process)) {
         bridge->connected = false;
         return false;
     }
 
     bool got_message = false;
 
-    // Read available data
-    char temp[1024];
-    int bytes = subprocess_read(&bridge->process, temp, sizeof(temp) - 1);
-    if (bytes > 0) {
-        temp[bytes] = '\0';
-
-        // Append to read buffer
-        int space = MAX_MESSAGE_SIZE - bridge->read_pos - 1;
-        if (bytes < space) {
-            memcpy(bridge->read_buffer + bridge->read_pos, temp, bytes);
-            bridge->read_pos += bytes;
-            bridge->read_buffer[bridge->read_pos] = '\0';
+    // Drain the pipe; a full buffer is processed and compacted before
+    // reading more, so bursts larger than MAX_MESSAGE_SIZE are not lost
+    for (;;) {
+        int bytes = bridge_read(bridge, bridge->read_buffer + bridge->read_pos,
+                                MAX_MESSAGE_SIZE - bridge->read_pos);
+        if (bytes > 0) bridge->read_pos += bytes;
+
+        int pos = process_buffer(bridge, &got_message);
+
+        // A full buffer without a complete message can never make progress:
+        // drop it and resynchronize at the next line
+        if (pos == 0 && bridge->read_pos == MAX_MESSAGE_SIZE) {
+            fprintf(stderr, "[Bridge] Message exceeds %d bytes, discarding\n", MAX_MESSAGE_SIZE);
+            bridge->skip_line = true;
+            pos = bridge->read_pos;
         }
-    }
 
-    // Process complete lines
-    char* line_start = bridge->read_buffer;
-    char* newline;
-    while ((newline = strchr(line_start, '\n')) != NULL) {
-        *newline = '\0';
-
-        // Process this message
-        if (line_start[0] == '{') {
-            process_message(bridge, line_start);
-            got_message = true;
+        // Move remaining data to start of buffer
+        if (pos > 0) {
+            int remaining = bridge->read_pos - pos;
+            memmove(bridge->read_buffer, bridge->read_buffer + pos, remaining);
+            bridge->read_pos = remaining;
         }
 
-        line_start = newline + 1;
+        if (bytes <= 0) break;
     }
 
-    // Move remaining data to start of buffer
-    if (line_start > bridge->read_buffer) {
-        size_t remaining = bridge->read_pos - (line_start - bridge->read_buffer);
-        memmove(bridge->read_buffer, line_start, remaining);
-        bridge->read_pos = (int)remaining;
-        bridge->read_buffer[bridge->read_pos] = '\0';
+    if (attached && bridge->channel.eof && io_channel_available(&bridge->channel) == 0 &&
+        !subprocess_is_running(&bridge->process)) {
+        bridge->connected = false;
     }
 
     return got_message;
 }
 
+void python_bridge_process_message(PythonBridge* bridge, const char* json) {
+    process_message(bridge, json);
+}
+
+bool python_bridge_attach(PythonBridge* bridge, IoReactor* reactor) {
+    if (!bridge->connected || bridge->embed) return false;  // Embedded: nothing to read
+    return io_reactor_add(reactor, &bridge->channel, &bridge->process, bridge);
+}
+
+int python_bridge_poll(IoReactor* reactor, int timeout_ms) {
+    IoChannel* ready[IO_REACTOR_MAX_CHANNELS];
+    int n = io_reactor_poll(reactor, timeout_ms, ready, IO_REACTOR_MAX_CHANNELS);
+
+    int updated = 0;
+    for (int i = 0; i < reactor->channel_count; i++) {
+        ((PythonBridge*)reactor->channels[i]->user)->updated = false;
+    }
+    for (int i = 0; i < n; i++) {
+        PythonBridge* bridge = (PythonBridge*)ready[i]->user;
+        bridge->updated = python_bridge_update(bridge);
+        if (bridge->updated) updated++;
+    }
+    return updated;
+}
+
+// Monotonic wall clock in milliseconds
+static double bridge_time_ms(void) {
+#ifdef _WIN32
+    return (double)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+// Bridges still owing a tick reply, after draining what already arrived
+static int collect_pending(PythonBridge* const* bridges, int count, PythonBridge** pending, int max_pending) {
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        PythonBridge* bridge = bridges[i];
+        if (!bridge || !bridge->connected || bridge->acked_seq == bridge->tick_seq) continue;
+
+        python_bridge_update(bridge);
+        if (bridge->connected && bridge->acked_seq != bridge->tick_seq && n < max_pending) {
+            pending[n++] = bridge;
+        }
+    }
+    return n;
+}
+
+bool python_bridge_wait_ticks(PythonBridge* const* bridges, int count, int timeout_ms) {
+    double deadline = bridge_time_ms() + timeout_ms;
+
+    // Wait on all pipes at once; each process computes its tick in parallel
+    PythonBridge* pending[64];
+    Subprocess* direct[64];
+    PythonEmbed* embedded[64];
+    for (;;) {
+        int n = collect_pending(bridges, count, pending, 64);
+        if (n == 0) return true;
+
+        int remaining = (int)(deadline - bridge_time_ms());
+        if (remaining <= 0) break;
+
+        // Attached bridges wait in their reactor, which also reads the data,
+        // the rest wait on their pipes; embedded bridges wait for their
+        // threads to post state (mixed sets poll with a short timeout)
+        IoReactor* reactor = NULL;
+        int direct_count = 0, embedded_count = 0;
+        for (int i = 0; i < n; i++) {
+            if (pending[i]->embed) embedded[embedded_count++] = pending[i]->embed;
+            else if (pending[i]->channel.reactor) reactor = pending[i]->channel.reactor;
+            else direct[direct_count++] = &pending[i]->process;
+        }
+        if (embedded_count == n) {
+            python_embed_wait(embedded, embedded_count, remaining);
+        } else if (direct_count == 0) {
+            python_bridge_poll(reactor, embedded_count ? 1 : remaining);
+        } else {
+            subprocess_wait_readable(direct, direct_count, (reactor || embedded_count) ? 1 : remaining);
+            if (reactor) python_bridge_poll(reactor, 0);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        PythonBridge* bridge = bridges[i];
+        if (bridge && bridge->connected && bridge->acked_seq != bridge->tick_seq) {
+            fprintf(stderr, "[Bridge] %s: tick %u not answered within %d ms (last ack %u)\n",
+                    bridge->project_name, (unsigned)bridge->tick_seq, timeout_ms,
+                    (unsigned)bridge->acked_seq);
+        }
+    }
+    return false;
+}
+
 bool python_bridge_is_ready(PythonBridge* bridge) {
     return bridge->connected && bridge->robot_ready;
 }
@@ -361,6 +812,25 @@ RobotState* python_bridge_get_state(PythonBridge* bridge) {
 }
 
 void python_bridge_destroy(PythonBridge* bridge) {
+    if (bridge->embed) {
+        python_embed_stop(bridge->embed);
+        memset(bridge, 0, sizeof(PythonBridge));
+        return;
+    }
+
+    // Pooled: unload the program and hand the worker back for the next run
+    if (bridge->pool) {
+        if (bridge->channel.reactor) io_reactor_remove(bridge->channel.reactor, &bridge->channel);
+        if (bridge->connected) {
+            subprocess_write_str(&bridge->process, "{\"type\":\"unload\"}\n");
+            python_pool_release(bridge->pool, &bridge->process);
+        } else {
+            subprocess_destroy(&bridge->process);
+        }
+        memset(bridge, 0, sizeof(PythonBridge));
+        return;
+    }
+
     if (bridge->connected) {
         // Send shutdown message
         subprocess_write_str(&bridge->process, "{\"type\":\"shutdown\"}\n");
@@ -373,6 +843,7 @@ void python_bridge_destroy(PythonBridge* bridge) {
 #endif
     }
 
+    if (bridge->channel.reactor) io_reactor_remove(bridge->channel.reactor, &bridge->channel);
     subprocess_destroy(&bridge->process);
     memset(bridge, 0, sizeof(PythonBridge));
 }
@@ -3,19 +3,100 @@
  *
  * Manages the Python subprocess and handles JSON message exchange
  * for the VEX IQ robot harness.
+ *
+ * The per-frame traffic (gamepad, tick, motor/pneumatic state) can use a
+ * compact binary framing instead of JSON lines. The client requests it with
+ * --binary on the ipc_bridge.py command line and switches once the "ready"
+ * message confirms it; both sides accept JSON lines and binary frames on
+ * the same pipe, so an older ipc_bridge.py just keeps talking JSON.
+ *
+ * Lockstep mode (--lockstep): every tick carries a sequence number and
+ * robot code runs on simulated time - wait() returns only when ticks have
+ * advanced the clock far enough. Python answers each tick once the robot
+ * threads are blocked again, echoing the sequence number with the state.
+ * The simulator sends ticks to all bridges, then python_bridge_wait_ticks()
+ * collects every reply in one pass, so N robots cost one round trip.
+ *   for each bridge: python_bridge_send_tick(bridge, dt);
+ *   python_bridge_wait_ticks(bridges, count, PYTHON_BRIDGE_TICK_TIMEOUT_MS);
+ *
+ * Bridges attached to an IoReactor never read their pipe themselves: one
+ * python_bridge_poll() per frame reads every bridge's stdout through the
+ * reactor and parses the bridges that received data, and
+ * python_bridge_update() only drains what the reactor already buffered.
+ *   python_bridge_attach(bridge, &reactor);          // once, after init
+ *   python_bridge_poll(&reactor, 0);                 // each frame
+ *
+ * Simulated sensor readings (distance, color/optical) ride on the tick:
+ * python_bridge_set_sensors() before python_bridge_send_tick() sends them
+ * with it, and vex_stub's sensor classes answer from the latest ones.
+ * Robot camera images are too large for a tick and go as CAMERA frames of
+ * their own (python_bridge_send_camera; binary framing or embedded only).
+ *
+ * Pooled bridges (python_bridge_init_pooled) lease a pre-warmed worker from
+ * a PythonPool instead of spawning a process; destroying the bridge unloads
+ * the program and returns the worker to the pool.
+ *
+ * Built with -DVEXIQ_EMBED_PYTHON=ON, python_bridge_init runs the program
+ * inside vexiq_sim instead (python_embed.h): same calls, but input and state
+ * go through shared structs, not a pipe. If the interpreter cannot start,
+ * the bridge falls back to a subprocess.
  */
 
 #ifndef PYTHON_BRIDGE_H
 #define PYTHON_BRIDGE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "subprocess.h"
+#include "io_reactor.h"
+#include "python_pool.h"
 #include "gamepad.h"
 
 #define MAX_MOTORS 12
 #define MAX_PNEUMATICS 12
+#define MAX_SENSORS 12
 #define MAX_MESSAGE_SIZE 4096
 
+// Request binary framing at init (0 = always JSON)
+#ifndef PYTHON_BRIDGE_BINARY
+#define PYTHON_BRIDGE_BINARY 1
+#endif
+
+// Binary frame: magic, type, payload length (u16 little-endian), payload.
+// The magic byte never starts a JSON line ('{') or a log line (ASCII).
+#define BRIDGE_FRAME_MAGIC 0xB1
+#define BRIDGE_FRAME_HEADER 4
+
+// Frame types and payloads (all little-endian, no padding):
+//   GAMEPAD  C++ -> Python  i8 axes[4] (A,B,C,D), u8 buttons (LUp,LDown,RUp,RDown,EUp,EDown,FUp,FDown = bits 0-7)
+//   TICK     C++ -> Python  f32 dt, u32 seq, u8 sensor_count,
+//                           sensor_count x {u8 port, u8 object, f32 distance_mm, u8 r, u8 g, u8 b}
+//   STATE    Python -> C++  u8 motor_count, u8 pneumatic_count,
+//                           motor_count x {u8 port, u8 spinning, f32 speed, f32 position},
+//                           pneumatic_count x {u8 port, u8 flags (extended = bit 0, pump = bit 1)},
+//                           u32 seq (tick being answered)
+//   CAMERA   C++ -> Python  u8 port, u16 width, u16 height, u32 frame, width x height x {u8 r, g, b}
+//                           (rows top to bottom)
+#define BRIDGE_FRAME_GAMEPAD 1
+#define BRIDGE_FRAME_TICK    2
+#define BRIDGE_FRAME_STATE   3
+#define BRIDGE_FRAME_CAMERA  4
+
+// Largest camera image one CAMERA frame holds (the payload length is 16-bit),
+// e.g. 160 x 120
+#define BRIDGE_CAMERA_HEADER 9
+#define BRIDGE_CAMERA_MAX_PIXELS ((0xFFFF - BRIDGE_CAMERA_HEADER) / 3)
+
+// In-process backend compiled in (pools are unnecessary then)
+#ifdef VEXIQ_EMBED_PYTHON
+#define PYTHON_BRIDGE_EMBEDDED 1
+#else
+#define PYTHON_BRIDGE_EMBEDDED 0
+#endif
+
+// Lockstep wait limit per tick (a tick that times out is skipped, not retried)
+#define PYTHON_BRIDGE_TICK_TIMEOUT_MS 1000
+
 // Motor state received from Python
 typedef struct MotorState {
     int port;
@@ -31,6 +112,21 @@ typedef struct PneumaticState {
     bool pump_on;      // Pump running
 } PneumaticState;
 
+// Sensor reading sent to Python with each tick
+// object: what the sensor sees (SENSOR_OBJECT_*, same values as sim/raycast.h SimRayObject)
+#define SENSOR_OBJECT_NONE     0
+#define SENSOR_OBJECT_FLOOR    1
+#define SENSOR_OBJECT_WALL     2
+#define SENSOR_OBJECT_CYLINDER 3
+#define SENSOR_OBJECT_ROBOT    4
+
+typedef struct SensorReading {
+    int port;
+    int object;          // SENSOR_OBJECT_*
+    float distance_mm;   // Distance to the object (-1 = nothing in range)
+    float rgb[3];        // Color of the object (0-1)
+} SensorReading;
+
 // Robot state received from Python
 typedef struct RobotState {
     MotorState motors[MAX_MOTORS];
@@ -44,17 +140,36 @@ typedef struct RobotState {
     char error[256];   // Error message (if any)
 } RobotState;
 
+struct PythonEmbed;
+
 typedef struct PythonBridge {
     Subprocess process;
+    struct PythonEmbed* embed;  // In-process runtime (NULL: subprocess backend)
+    PythonPool* pool;      // Worker's pool (NULL: process owned by this bridge)
     bool connected;
     bool robot_ready;
+    bool binary;           // Python accepted binary framing
+    bool lockstep;         // Robot code runs on simulated time
+
+    // Tick sequence numbers (lockstep acks)
+    uint32_t tick_seq;     // Last tick sent
+    uint32_t acked_seq;    // Last tick answered with state
 
     char project_name[128];
     RobotState state;
 
+    // Readings sent with the next tick (python_bridge_set_sensors)
+    SensorReading sensors[MAX_SENSORS];
+    int sensor_count;
+
+    // Reactor registration (channel.reactor is NULL when reading the pipe directly)
+    IoChannel channel;
+    bool updated;          // Complete message parsed by the last python_bridge_poll
+
     // Internal buffer for reading
     char read_buffer[MAX_MESSAGE_SIZE];
     int read_pos;
+    bool skip_line;        // Dropping the rest of an oversized message
 
     // Tick timing
     double last_tick_time;
@@ -64,18 +179,56 @@ typedef struct PythonBridge {
 // Initialize and spawn Python bridge
 // iqpython_path: Path to the .iqpython file to run
 // simulator_dir: Path to the simulator directory containing ipc_bridge.py
-bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const char* simulator_dir);
+// lockstep: run robot code on simulated time (see python_bridge_wait_ticks)
+bool python_bridge_init(PythonBridge* bridge, const char* iqpython_path, const char* simulator_dir,
+                        bool lockstep);
+
+// Initialize on a worker leased from pool (waits for one to become idle)
+// The worker loads iqpython_path; the bridge then behaves like python_bridge_init's
+bool python_bridge_init_pooled(PythonBridge* bridge, PythonPool* pool, const char* iqpython_path,
+                               bool lockstep);
+
+// Build the command line running ipc_bridge.py with args (bundled Python if present)
+bool python_bridge_command(char* command, size_t command_size, const char* simulator_dir,
+                           const char* args);
 
 // Send gamepad state to Python
 void python_bridge_send_gamepad(PythonBridge* bridge, Gamepad* gamepad);
 
-// Send tick message (triggers Python to send state back)
+// Set the sensor readings sent with every following tick (count <= MAX_SENSORS)
+void python_bridge_set_sensors(PythonBridge* bridge, const SensorReading* sensors, int count);
+
+// Send tick message with the sensor readings (triggers Python to send state back)
 void python_bridge_send_tick(PythonBridge* bridge, float dt);
 
+// Send a robot camera image (width * height RGB bytes, rows top to bottom)
+// to the camera on port. Returns false, sending nothing, on a JSON-only
+// pipe or when the image exceeds BRIDGE_CAMERA_MAX_PIXELS.
+bool python_bridge_send_camera(PythonBridge* bridge, int port, int width, int height, uint32_t frame,
+                               const uint8_t* rgb);
+
+// Lockstep: block until every bridge has answered its last tick
+// bridges may contain NULL or disconnected entries (skipped).
+// Returns false if some bridge did not answer within timeout_ms.
+bool python_bridge_wait_ticks(PythonBridge* const* bridges, int count, int timeout_ms);
+
 // Process incoming messages from Python (call each frame)
 // Returns true if new state was received
 bool python_bridge_update(PythonBridge* bridge);
 
+// Parse and apply one JSON protocol line (no trailing newline) as if it had
+// been read from the program's stdout (benchmarks, protocol tests)
+void python_bridge_process_message(PythonBridge* bridge, const char* json);
+
+// Read the bridge's stdout through reactor from now on
+// Returns false (bridge keeps reading its pipe directly) if registration fails
+bool python_bridge_attach(PythonBridge* bridge, IoReactor* reactor);
+
+// Read all attached bridges' pipes at once and process bridges that got data
+// Sets bridge->updated on bridges that received a complete message.
+// Returns the number of such bridges.
+int python_bridge_poll(IoReactor* reactor, int timeout_ms);
+
 // Check if bridge is connected and robot is ready
 bool python_bridge_is_ready(PythonBridge* bridge);
 
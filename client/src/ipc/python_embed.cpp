@@ -0,0 +1,491 @@
+/*
+ * Python Embed implementation
+ * Interpreter lifetime, per-robot threads and the _vexiq_embed module
+ */
+
+// Python.h first: it may redefine feature macros the C headers depend on
+#ifdef VEXIQ_EMBED_PYTHON
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#endif
+
+#include "python_embed.h"
+
+#ifdef VEXIQ_EMBED_PYTHON
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef struct EmbedMessage {
+    char type[32];
+    char text[256];
+} EmbedMessage;
+
+// Latest image of one robot camera
+struct EmbedCamera {
+    int port;
+    int width, height;
+    uint32_t frame;
+    std::vector<uint8_t> rgb;
+};
+
+struct PythonEmbed {
+    std::thread thread;
+    std::condition_variable input;   // Wakes the harness's wait() (uses g_embed_lock)
+
+    char path[1024];
+    char simulator_dir[1024];
+    bool lockstep;
+
+    // Simulator -> Python
+    bool stop;
+    bool gamepad_dirty;
+    signed char axes[4];
+    uint8_t buttons;
+    bool tick_pending;
+    float tick_dt;
+    uint32_t tick_seq;               // Last tick sent
+    SensorReading sensors[MAX_SENSORS];  // Readings of the last tick sent
+    int sensor_count;
+    std::vector<EmbedCamera> cameras;    // One per camera port that sent an image
+
+    // Python -> simulator
+    bool state_dirty;
+    MotorState motors[MAX_MOTORS];
+    int motor_count;
+    PneumaticState pneumatics[MAX_PNEUMATICS];
+    int pneumatic_count;
+    uint32_t acked_seq;              // Tick the posted state answers
+
+    EmbedMessage messages[PYTHON_EMBED_MAX_MESSAGES];
+    int message_count;
+
+    bool finished;                   // Harness returned (thread about to exit)
+};
+
+// One lock for every embed's exchange fields, so the simulator can wait on
+// all robots' acks with a single condition variable
+static std::mutex g_embed_lock;
+static std::condition_variable g_embed_acked;
+
+static PyThreadState* g_main_state = NULL;   // Main interpreter, GIL released
+static bool g_python_failed = false;
+
+// Post a message for python_bridge_update (caller holds g_embed_lock)
+static void embed_post_locked(PythonEmbed* embed, const char* type, const char* text) {
+    if (embed->message_count == PYTHON_EMBED_MAX_MESSAGES) return;  // Rare messages; drop on overflow
+    EmbedMessage* msg = &embed->messages[embed->message_count++];
+    snprintf(msg->type, sizeof(msg->type), "%s", type);
+    snprintf(msg->text, sizeof(msg->text), "%s", text);
+}
+
+// ---- _vexiq_embed module (one instance per sub-interpreter) ----
+
+static PythonEmbed* embed_from_module(PyObject* module) {
+    PythonEmbed* embed = *(PythonEmbed**)PyModule_GetState(module);
+    if (!embed) PyErr_SetString(PyExc_RuntimeError, "_vexiq_embed is not attached to a robot");
+    return embed;
+}
+
+// wait(timeout) -> None on timeout, else (stop, gamepad | None, tick | None)
+//   gamepad = (a, b, c, d, button_bits), tick = (dt, seq, sensors)
+//   sensors = ((port, object, distance_mm, r, g, b), ...)
+static PyObject* embed_wait(PyObject* module, PyObject* args) {
+    double timeout;
+    if (!PyArg_ParseTuple(args, "d", &timeout)) return NULL;
+    PythonEmbed* embed = embed_from_module(module);
+    if (!embed) return NULL;
+
+    bool woke, stop = false, has_gamepad = false, has_tick = false;
+    signed char axes[4] = {0, 0, 0, 0};
+    uint8_t buttons = 0;
+    float dt = 0.0f;
+    uint32_t seq = 0;
+    SensorReading sensors[MAX_SENSORS];
+    int sensor_count = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    {
+        std::unique_lock<std::mutex> lock(g_embed_lock);
+        woke = embed->input.wait_for(lock, std::chrono::duration<double>(timeout), [embed] {
+            return embed->stop || embed->gamepad_dirty || embed->tick_pending;
+        });
+        if (woke) {
+            stop = embed->stop;
+            has_gamepad = embed->gamepad_dirty;
+            memcpy(axes, embed->axes, sizeof(axes));
+            buttons = embed->buttons;
+            has_tick = embed->tick_pending;
+            dt = embed->tick_dt;
+            seq = embed->tick_seq;
+            sensor_count = embed->sensor_count;
+            memcpy(sensors, embed->sensors, (size_t)sensor_count * sizeof(SensorReading));
+            embed->gamepad_dirty = false;
+            embed->tick_pending = false;
+            embed->tick_dt = 0.0f;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (!woke) Py_RETURN_NONE;
+
+    PyObject* gamepad = has_gamepad
+        ? Py_BuildValue("(iiiii)", axes[0], axes[1], axes[2], axes[3], buttons)
+        : (Py_INCREF(Py_None), Py_None);
+    PyObject* tick = Py_None;
+    if (has_tick) {
+        PyObject* readings = PyTuple_New(sensor_count);
+        for (int i = 0; readings && i < sensor_count; i++) {
+            const SensorReading* r = &sensors[i];
+            PyObject* reading = Py_BuildValue("(iidddd)", r->port, r->object, (double)r->distance_mm,
+                                              (double)r->rgb[0], (double)r->rgb[1], (double)r->rgb[2]);
+            if (!reading) {
+                Py_CLEAR(readings);
+                break;
+            }
+            PyTuple_SET_ITEM(readings, i, reading);
+        }
+        tick = readings ? Py_BuildValue("(dkN)", (double)dt, (unsigned long)seq, readings) : NULL;
+    } else {
+        Py_INCREF(Py_None);
+    }
+    if (!gamepad || !tick) {
+        Py_XDECREF(gamepad);
+        Py_XDECREF(tick);
+        return NULL;
+    }
+    return Py_BuildValue("(ONN)", stop ? Py_True : Py_False, gamepad, tick);
+}
+
+// set_state(seq, [(port, spinning, speed, position)], [(port, extended, pump)])
+static PyObject* embed_set_state(PyObject* module, PyObject* args) {
+    unsigned long seq;
+    PyObject* motor_list;
+    PyObject* pneumatic_list;
+    if (!PyArg_ParseTuple(args, "kOO", &seq, &motor_list, &pneumatic_list)) return NULL;
+    PythonEmbed* embed = embed_from_module(module);
+    if (!embed) return NULL;
+
+    // Convert with the GIL held, then publish under the lock
+    MotorState motors[MAX_MOTORS];
+    PneumaticState pneumatics[MAX_PNEUMATICS];
+    int motor_count = 0, pneumatic_count = 0;
+
+    PyObject* items = PySequence_Fast(motor_list, "motors must be a sequence");
+    if (!items) return NULL;
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(items) && motor_count < MAX_MOTORS; i++) {
+        int port, spinning;
+        double speed, position;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(items, i), "ipdd", &port, &spinning, &speed, &position)) {
+            Py_DECREF(items);
+            return NULL;
+        }
+        MotorState* m = &motors[motor_count++];
+        m->port = port;
+        m->spinning = spinning != 0;
+        m->speed = (int)(float)speed;      // Rounded and truncated like the binary STATE frame
+        m->position = (float)position;
+    }
+    Py_DECREF(items);
+
+    items = PySequence_Fast(pneumatic_list, "pneumatics must be a sequence");
+    if (!items) return NULL;
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(items) && pneumatic_count < MAX_PNEUMATICS; i++) {
+        int port, extended, pump;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(items, i), "ipp", &port, &extended, &pump)) {
+            Py_DECREF(items);
+            return NULL;
+        }
+        PneumaticState* p = &pneumatics[pneumatic_count++];
+        p->port = port;
+        p->extended = extended != 0;
+        p->pump_on = pump != 0;
+    }
+    Py_DECREF(items);
+
+    {
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        memcpy(embed->motors, motors, motor_count * sizeof(MotorState));
+        embed->motor_count = motor_count;
+        memcpy(embed->pneumatics, pneumatics, pneumatic_count * sizeof(PneumaticState));
+        embed->pneumatic_count = pneumatic_count;
+        embed->acked_seq = (uint32_t)seq;
+        embed->state_dirty = true;
+    }
+    g_embed_acked.notify_all();
+    Py_RETURN_NONE;
+}
+
+// post(type, text): "ready" (text = project), "status", "error", "shutdown"
+static PyObject* embed_post(PyObject* module, PyObject* args) {
+    const char* type;
+    const char* text;
+    if (!PyArg_ParseTuple(args, "ss", &type, &text)) return NULL;
+    PythonEmbed* embed = embed_from_module(module);
+    if (!embed) return NULL;
+
+    std::lock_guard<std::mutex> lock(g_embed_lock);
+    embed_post_locked(embed, type, text);
+    Py_RETURN_NONE;
+}
+
+// camera(port) -> None before the first image, else (width, height, frame, rgb bytes)
+static PyObject* embed_camera(PyObject* module, PyObject* args) {
+    int port;
+    if (!PyArg_ParseTuple(args, "i", &port)) return NULL;
+    PythonEmbed* embed = embed_from_module(module);
+    if (!embed) return NULL;
+
+    EmbedCamera image = {port, 0, 0, 0, {}};
+    {
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        for (const EmbedCamera& camera : embed->cameras) {
+            if (camera.port == port) image = camera;
+        }
+    }
+    if (image.rgb.empty()) Py_RETURN_NONE;
+    return Py_BuildValue("(iiky#)", image.width, image.height, (unsigned long)image.frame,
+                         (const char*)image.rgb.data(), (Py_ssize_t)image.rgb.size());
+}
+
+static PyMethodDef embed_methods[] = {
+    {"wait", embed_wait, METH_VARARGS, "Wait for simulator input (releases the GIL)."},
+    {"set_state", embed_set_state, METH_VARARGS, "Publish motor/pneumatic state for a tick."},
+    {"post", embed_post, METH_VARARGS, "Send a ready/status/error/shutdown message."},
+    {"camera", embed_camera, METH_VARARGS, "Latest image of a robot camera."},
+    {NULL, NULL, 0, NULL}
+};
+
+// Multi-phase init: each sub-interpreter gets its own module and state slot
+static PyModuleDef_Slot embed_slots[] = {
+    {0, NULL}
+};
+
+static PyModuleDef embed_module = {
+    PyModuleDef_HEAD_INIT,
+    "_vexiq_embed",
+    "vexiq_sim in-process bridge (see client/src/ipc/python_embed.h)",
+    sizeof(PythonEmbed*),
+    embed_methods,
+    embed_slots,
+    NULL, NULL, NULL
+};
+
+static PyObject* embed_module_init(void) {
+    return PyModuleDef_Init(&embed_module);
+}
+
+// ---- Interpreter and robot threads ----
+
+static bool embed_python_init(void) {
+    if (g_main_state) return true;
+    if (g_python_failed) return false;
+
+    PyImport_AppendInittab("_vexiq_embed", embed_module_init);
+
+    PyConfig config;
+    PyConfig_InitPythonConfig(&config);
+    config.install_signal_handlers = 0;  // Ctrl+C stays with the simulator
+    config.parse_argv = 0;
+    PyStatus status = Py_InitializeFromConfig(&config);
+    PyConfig_Clear(&config);
+    if (PyStatus_Exception(status)) {
+        fprintf(stderr, "[Embed] Python failed to initialize: %s\n",
+                status.err_msg ? status.err_msg : "unknown error");
+        g_python_failed = true;
+        return false;
+    }
+
+    printf("[Embed] Python %s embedded\n", Py_GetVersion());
+    g_main_state = PyEval_SaveThread();  // Robot threads take the GIL from here on
+    return true;
+}
+
+// Import the harness and run embedded_main (sub-interpreter current, GIL held)
+// Returns false if robot code is still running afterwards.
+static bool run_harness(PythonEmbed* embed) {
+    PyObject* module = PyImport_ImportModule("_vexiq_embed");
+    if (!module) {
+        PyErr_Print();
+        return true;
+    }
+    *(PythonEmbed**)PyModule_GetState(module) = embed;
+
+    bool stopped = true;
+    PyObject* sys_path = PySys_GetObject("path");  // Borrowed
+    PyObject* dir = PyUnicode_DecodeFSDefault(embed->simulator_dir);
+    PyObject* harness = NULL;
+    if (sys_path && dir && PyList_Insert(sys_path, 0, dir) == 0) {
+        harness = PyImport_ImportModule("ipc_bridge");
+    }
+    Py_XDECREF(dir);
+
+    if (harness) {
+        PyObject* result = PyObject_CallMethod(harness, "embedded_main", "sO", embed->path,
+                                               embed->lockstep ? Py_True : Py_False);
+        if (result) {
+            stopped = PyObject_IsTrue(result) != 0;
+            Py_DECREF(result);
+        } else {
+            PyErr_Print();
+        }
+        Py_DECREF(harness);
+    } else {
+        PyErr_Print();
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        embed_post_locked(embed, "error", "Failed to import ipc_bridge.py");
+    }
+
+    // Robot code left running must not reach a freed embed
+    *(PythonEmbed**)PyModule_GetState(module) = NULL;
+    Py_DECREF(module);
+    return stopped;
+}
+
+static void embed_thread(PythonEmbed* embed) {
+    PyThreadState* thread_state = PyThreadState_New(PyThreadState_GetInterpreter(g_main_state));
+    PyEval_RestoreThread(thread_state);
+
+    PyThreadState* sub = Py_NewInterpreter();
+    if (sub) {
+        if (run_harness(embed)) {
+            Py_EndInterpreter(sub);
+        } else {
+            fprintf(stderr, "[Embed] %s: robot code did not stop; leaving its interpreter running\n",
+                    embed->path);
+        }
+    } else {
+        fprintf(stderr, "[Embed] Failed to create a sub-interpreter\n");
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        embed_post_locked(embed, "error", "Failed to create a Python sub-interpreter");
+    }
+
+    PyThreadState_Swap(thread_state);
+    PyThreadState_Clear(thread_state);
+    PyThreadState_DeleteCurrent();  // Releases the GIL
+
+    {
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        embed->finished = true;
+    }
+    g_embed_acked.notify_all();
+}
+
+PythonEmbed* python_embed_start(const char* iqpython_path, const char* simulator_dir, bool lockstep) {
+    if (!embed_python_init()) return NULL;
+
+    PythonEmbed* embed = new PythonEmbed();
+    snprintf(embed->path, sizeof(embed->path), "%s", iqpython_path);
+    snprintf(embed->simulator_dir, sizeof(embed->simulator_dir), "%s", simulator_dir);
+    embed->lockstep = lockstep;
+    embed->thread = std::thread(embed_thread, embed);
+    return embed;
+}
+
+void python_embed_stop(PythonEmbed* embed) {
+    {
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        embed->stop = true;
+    }
+    embed->input.notify_all();
+    embed->thread.join();
+    delete embed;
+}
+
+void python_embed_send_gamepad(PythonEmbed* embed, const signed char axes[4], uint8_t buttons) {
+    {
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        if (memcmp(embed->axes, axes, 4) == 0 && embed->buttons == buttons) return;  // Unchanged
+        memcpy(embed->axes, axes, 4);
+        embed->buttons = buttons;
+        embed->gamepad_dirty = true;
+    }
+    embed->input.notify_all();
+}
+
+void python_embed_send_tick(PythonEmbed* embed, float dt, uint32_t seq,
+                            const SensorReading* sensors, int sensor_count) {
+    {
+        std::lock_guard<std::mutex> lock(g_embed_lock);
+        embed->tick_dt += dt;
+        embed->tick_seq = seq;
+        embed->sensor_count = sensor_count;
+        memcpy(embed->sensors, sensors, (size_t)sensor_count * sizeof(SensorReading));
+        embed->tick_pending = true;
+    }
+    embed->input.notify_all();
+}
+
+void python_embed_send_camera(PythonEmbed* embed, int port, int width, int height, uint32_t frame,
+                              const uint8_t* rgb) {
+    std::lock_guard<std::mutex> lock(g_embed_lock);
+    EmbedCamera* camera = NULL;
+    for (EmbedCamera& c : embed->cameras) {
+        if (c.port == port) camera = &c;
+    }
+    if (!camera) {
+        embed->cameras.push_back(EmbedCamera{port, 0, 0, 0, {}});
+        camera = &embed->cameras.back();
+    }
+    camera->width = width;
+    camera->height = height;
+    camera->frame = frame;
+    camera->rgb.assign(rgb, rgb + (size_t)width * height * 3);
+}
+
+bool python_embed_take_state(PythonEmbed* embed, RobotState* state, uint32_t* acked_seq) {
+    std::lock_guard<std::mutex> lock(g_embed_lock);
+    if (!embed->state_dirty) return false;
+    memcpy(state->motors, embed->motors, embed->motor_count * sizeof(MotorState));
+    state->motor_count = embed->motor_count;
+    memcpy(state->pneumatics, embed->pneumatics, embed->pneumatic_count * sizeof(PneumaticState));
+    state->pneumatic_count = embed->pneumatic_count;
+    *acked_seq = embed->acked_seq;
+    embed->state_dirty = false;
+    return true;
+}
+
+bool python_embed_next_message(PythonEmbed* embed, char* type, size_t type_size,
+                               char* text, size_t text_size) {
+    std::lock_guard<std::mutex> lock(g_embed_lock);
+    if (embed->message_count == 0) return false;
+    snprintf(type, type_size, "%s", embed->messages[0].type);
+    snprintf(text, text_size, "%s", embed->messages[0].text);
+    embed->message_count--;
+    memmove(embed->messages, embed->messages + 1, embed->message_count * sizeof(EmbedMessage));
+    return true;
+}
+
+bool python_embed_finished(PythonEmbed* embed) {
+    std::lock_guard<std::mutex> lock(g_embed_lock);
+    return embed->finished && !embed->state_dirty && embed->message_count == 0;
+}
+
+bool python_embed_wait(PythonEmbed* const* embeds, int count, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(g_embed_lock);
+    return g_embed_acked.wait_for(lock, std::chrono::milliseconds(timeout_ms), [embeds, count] {
+        for (int i = 0; i < count; i++) {
+            if (!embeds[i]->finished && embeds[i]->acked_seq != embeds[i]->tick_seq) return false;
+        }
+        return true;
+    });
+}
+
+#else  // !VEXIQ_EMBED_PYTHON: subprocess backend only
+
+PythonEmbed* python_embed_start(const char*, const char*, bool) { return NULL; }
+void python_embed_stop(PythonEmbed*) {}
+void python_embed_send_gamepad(PythonEmbed*, const signed char*, uint8_t) {}
+void python_embed_send_tick(PythonEmbed*, float, uint32_t, const SensorReading*, int) {}
+void python_embed_send_camera(PythonEmbed*, int, int, int, uint32_t, const uint8_t*) {}
+bool python_embed_take_state(PythonEmbed*, RobotState*, uint32_t*) { return false; }
+bool python_embed_next_message(PythonEmbed*, char*, size_t, char*, size_t) { return false; }
+bool python_embed_finished(PythonEmbed*) { return true; }
+bool python_embed_wait(PythonEmbed* const*, int, int) { return true; }
+
+#endif // VEXIQ_EMBED_PYTHON
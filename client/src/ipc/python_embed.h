@@ -0,0 +1,71 @@
+/*
+ * Python Embed - in-process runtime for robot programs
+ *
+ * Built with -DVEXIQ_EMBED_PYTHON=ON, vexiq_sim links libpython and runs
+ * ipc_bridge.py's harness (EmbeddedBridge) itself: every robot gets its own
+ * thread and sub-interpreter, so vex_stub's module state stays per robot as
+ * it is per process with the subprocess backend. There is no pipe and no
+ * serialization: gamepad and tick input are written into the PythonEmbed
+ * and picked up by the harness's _vexiq_embed.wait(); motor/pneumatic state
+ * is written back by _vexiq_embed.set_state() and copied into the bridge's
+ * RobotState by python_bridge_update().
+ *
+ * python_bridge.cpp is the only caller; main.cpp keeps using PythonBridge.
+ * Without VEXIQ_EMBED_PYTHON, python_embed_start() returns NULL and the
+ * bridge spawns ipc_bridge.py as before.
+ *
+ * Sub-interpreters share one GIL: robot code runs one robot at a time, but
+ * every harness waits with the GIL released, so idle robots cost nothing.
+ * Robot code that never reaches a wait() cannot be stopped; its interpreter
+ * is left running (the subprocess backend kills the process instead).
+ */
+
+#ifndef PYTHON_EMBED_H
+#define PYTHON_EMBED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "python_bridge.h"
+
+#define PYTHON_EMBED_MAX_MESSAGES 16   // ready/status/error/shutdown queued between updates
+
+typedef struct PythonEmbed PythonEmbed;
+
+// Start iqpython_path on a new thread and sub-interpreter (the interpreter
+// itself starts on first use; call from the main thread)
+// Returns NULL if embedding is unavailable or Python failed to initialize.
+PythonEmbed* python_embed_start(const char* iqpython_path, const char* simulator_dir, bool lockstep);
+
+// Stop the program and its thread, then free embed
+void python_embed_stop(PythonEmbed* embed);
+
+// Latest gamepad state (axes A-D, buttons as in BRIDGE_FRAME_GAMEPAD)
+void python_embed_send_gamepad(PythonEmbed* embed, const signed char axes[4], uint8_t buttons);
+
+// Queue a tick with the current sensor readings (unanswered ticks coalesce,
+// their dt adds up and the newest readings win)
+void python_embed_send_tick(PythonEmbed* embed, float dt, uint32_t seq,
+                            const SensorReading* sensors, int sensor_count);
+
+// Latest image of the camera on port (width * height RGB bytes), replacing
+// the previous one; the harness reads it with _vexiq_embed.camera(port)
+void python_embed_send_camera(PythonEmbed* embed, int port, int width, int height, uint32_t frame,
+                              const uint8_t* rgb);
+
+// Copy state posted since the last call into state; acked_seq gets its tick
+// Returns false if nothing new was posted.
+bool python_embed_take_state(PythonEmbed* embed, RobotState* state, uint32_t* acked_seq);
+
+// Pop the next message posted by the harness; false when none remain
+bool python_embed_next_message(PythonEmbed* embed, char* type, size_t type_size,
+                               char* text, size_t text_size);
+
+// Harness returned and everything it posted has been taken
+bool python_embed_finished(PythonEmbed* embed);
+
+// Block until every embed answered its last tick or finished
+// Returns false on timeout.
+bool python_embed_wait(PythonEmbed* const* embeds, int count, int timeout_ms);
+
+#endif // PYTHON_EMBED_H
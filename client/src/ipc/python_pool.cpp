@@ -0,0 +1,223 @@
+/*
+ * Python Worker Pool implementation
+ */
+
+#include "python_pool.h"
+#include "python_bridge.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <time.h>
+#endif
+
+// Monotonic wall clock in milliseconds
+static double pool_time_ms(void) {
+#ifdef _WIN32
+    return (double)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+static bool spawn_worker(PythonPool* pool, PythonWorker* worker) {
+    memset(worker, 0, sizeof(PythonWorker));
+    if (!subprocess_spawn(&worker->process, pool->command, NULL)) {
+        fprintf(stderr, "[Pool] Failed to spawn Python worker\n");
+        return false;
+    }
+    worker->state = PYTHON_WORKER_STARTING;
+    return true;
+}
+
+static PythonWorker* find_worker(PythonPool* pool, PythonWorkerState state) {
+    for (int i = 0; i < PYTHON_POOL_MAX_WORKERS; i++) {
+        if (pool->workers[i].state == state) return &pool->workers[i];
+    }
+    return NULL;
+}
+
+// Read what a STARTING worker printed; true once it sent "worker_ready"
+// Binary frames and JSON lines left over from its previous run are skipped.
+static bool scan_worker(PythonWorker* worker) {
+    for (;;) {
+        int bytes = subprocess_read(&worker->process, worker->buffer + worker->buffer_pos,
+                                    PYTHON_POOL_SCAN_BUFFER - worker->buffer_pos);
+        if (bytes > 0) worker->buffer_pos += bytes;
+
+        int pos = 0;
+        while (pos < worker->buffer_pos) {
+            char* msg = worker->buffer + pos;
+            int available = worker->buffer_pos - pos;
+
+            if (worker->skip_line) {
+                char* newline = (char*)memchr(msg, '\n', available);
+                if (!newline) { pos = worker->buffer_pos; break; }
+                worker->skip_line = false;
+                pos += (int)(newline - msg) + 1;
+                continue;
+            }
+
+            if ((unsigned char)msg[0] == BRIDGE_FRAME_MAGIC) {
+                if (available < BRIDGE_FRAME_HEADER) break;
+                int len = (unsigned char)msg[2] | ((unsigned char)msg[3] << 8);
+                if (available < BRIDGE_FRAME_HEADER + len) break;
+                pos += BRIDGE_FRAME_HEADER + len;
+                continue;
+            }
+
+            char* newline = (char*)memchr(msg, '\n', available);
+            if (!newline) break;
+            *newline = '\0';
+            if (strstr(msg, "\"type\":\"worker_ready\"")) {
+                // Nothing follows until the worker gets a load message
+                worker->buffer_pos = 0;
+                worker->state = PYTHON_WORKER_IDLE;
+                return true;
+            }
+            pos += (int)(newline - msg) + 1;
+        }
+
+        if (pos == 0 && worker->buffer_pos == PYTHON_POOL_SCAN_BUFFER) {
+            worker->skip_line = true;
+            pos = worker->buffer_pos;
+        }
+        if (pos > 0) {
+            int remaining = worker->buffer_pos - pos;
+            memmove(worker->buffer, worker->buffer + pos, remaining);
+            worker->buffer_pos = remaining;
+        }
+
+        if (bytes <= 0) return false;
+    }
+}
+
+bool python_pool_init(PythonPool* pool, const char* simulator_dir, int size) {
+    memset(pool, 0, sizeof(PythonPool));
+    if (size > PYTHON_POOL_MAX_WORKERS) size = PYTHON_POOL_MAX_WORKERS;
+
+    if (!python_bridge_command(pool->command, sizeof(pool->command), simulator_dir,
+                               PYTHON_BRIDGE_BINARY ? "--worker --binary" : "--worker")) {
+        fprintf(stderr, "[Pool] Command line too long\n");
+        return false;
+    }
+
+    printf("[Pool] Starting %d Python worker%s: %s\n", size, size == 1 ? "" : "s", pool->command);
+    for (int i = 0; i < size; i++) {
+        if (spawn_worker(pool, &pool->workers[pool->size])) pool->size++;
+    }
+    return pool->size > 0;
+}
+
+void python_pool_update(PythonPool* pool) {
+    int alive = 0;
+    for (int i = 0; i < PYTHON_POOL_MAX_WORKERS; i++) {
+        PythonWorker* worker = &pool->workers[i];
+        if (worker->state == PYTHON_WORKER_EMPTY) continue;
+        if (worker->state == PYTHON_WORKER_LEASED) { alive++; continue; }
+
+        if (worker->state == PYTHON_WORKER_STARTING) scan_worker(worker);
+        if (!subprocess_is_running(&worker->process)) {
+            subprocess_destroy(&worker->process);
+            memset(worker, 0, sizeof(PythonWorker));
+            continue;
+        }
+        alive++;
+    }
+
+    // Replace workers that exited
+    for (; alive < pool->size; alive++) {
+        PythonWorker* slot = find_worker(pool, PYTHON_WORKER_EMPTY);
+        if (!slot || !spawn_worker(pool, slot)) break;
+        printf("[Pool] Replaced an exited Python worker\n");
+    }
+}
+
+int python_pool_idle_count(const PythonPool* pool) {
+    int count = 0;
+    for (int i = 0; i < PYTHON_POOL_MAX_WORKERS; i++) {
+        if (pool->workers[i].state == PYTHON_WORKER_IDLE) count++;
+    }
+    return count;
+}
+
+bool python_pool_lease(PythonPool* pool, Subprocess* out, int timeout_ms) {
+    double deadline = pool_time_ms() + timeout_ms;
+    for (;;) {
+        PythonWorker* idle = find_worker(pool, PYTHON_WORKER_IDLE);
+        if (!idle) {
+            python_pool_update(pool);
+            idle = find_worker(pool, PYTHON_WORKER_IDLE);
+        }
+        if (idle) {
+            *out = idle->process;
+            memset(&idle->process, 0, sizeof(Subprocess));
+            idle->state = PYTHON_WORKER_LEASED;
+            return true;
+        }
+
+        // Everyone is leased: grow the pool by one
+        Subprocess* starting[PYTHON_POOL_MAX_WORKERS];
+        int n = 0;
+        for (int i = 0; i < PYTHON_POOL_MAX_WORKERS; i++) {
+            if (pool->workers[i].state == PYTHON_WORKER_STARTING) starting[n++] = &pool->workers[i].process;
+        }
+        if (n == 0) {
+            PythonWorker* slot = find_worker(pool, PYTHON_WORKER_EMPTY);
+            if (!slot || !spawn_worker(pool, slot)) return false;
+            pool->size++;
+            starting[n++] = &slot->process;
+        }
+
+        int remaining = (int)(deadline - pool_time_ms());
+        if (remaining <= 0) return false;
+        subprocess_wait_readable(starting, n, remaining);
+    }
+}
+
+void python_pool_release(PythonPool* pool, Subprocess* proc) {
+    PythonWorker* slot = find_worker(pool, PYTHON_WORKER_LEASED);
+    if (!slot) {
+        // Not ours (pool was reset); just stop it
+        subprocess_destroy(proc);
+        return;
+    }
+
+    memset(slot, 0, sizeof(PythonWorker));
+    slot->process = *proc;
+    slot->state = PYTHON_WORKER_STARTING;
+    memset(proc, 0, sizeof(Subprocess));
+}
+
+void python_pool_destroy(PythonPool* pool) {
+    bool any = false;
+    for (int i = 0; i < PYTHON_POOL_MAX_WORKERS; i++) {
+        PythonWorker* worker = &pool->workers[i];
+        if (worker->state == PYTHON_WORKER_STARTING || worker->state == PYTHON_WORKER_IDLE) {
+            subprocess_write_str(&worker->process, "{\"type\":\"shutdown\"}\n");
+            any = true;
+        }
+    }
+
+    // Give workers time to exit on their own (resetting ones finish first)
+    if (any) {
+#ifdef _WIN32
+        Sleep(100);
+#else
+        usleep(100000);
+#endif
+    }
+
+    for (int i = 0; i < PYTHON_POOL_MAX_WORKERS; i++) {
+        PythonWorker* worker = &pool->workers[i];
+        if (worker->state == PYTHON_WORKER_STARTING || worker->state == PYTHON_WORKER_IDLE) {
+            subprocess_destroy(&worker->process);
+        }
+    }
+    memset(pool, 0, sizeof(PythonPool));
+}
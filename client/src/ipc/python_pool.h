@@ -0,0 +1,75 @@
+/*
+ * Python Worker Pool - pre-warmed ipc_bridge.py processes
+ *
+ * Starting a robot program normally costs a full interpreter start plus the
+ * vex_stub / iqpython_parser imports. Pool workers run
+ * "ipc_bridge.py --worker", pay that once and then wait for programs: a
+ * bridge leases an idle worker, sends it a load message and, when done,
+ * releases it. The worker stops the program, resets the vex stub and
+ * announces itself ready again. Workers that exit (robot code that can't be
+ * stopped) are replaced so the pool stays at its size.
+ *
+ * Usage:
+ *   PythonPool* pool = new PythonPool();
+ *   python_pool_init(pool, simulator_dir, robot_count);  // spawns and starts importing
+ *   python_bridge_init_pooled(bridge, pool, iqpython_path, lockstep);
+ *   ...
+ *   python_bridge_destroy(bridge);                       // worker goes back to the pool
+ *   python_pool_destroy(pool);
+ */
+
+#ifndef PYTHON_POOL_H
+#define PYTHON_POOL_H
+
+#include <stdbool.h>
+#include "subprocess.h"
+
+#define PYTHON_POOL_MAX_WORKERS 32
+#define PYTHON_POOL_SCAN_BUFFER 1024        // Longest line scanned while waiting for "worker_ready"
+#define PYTHON_POOL_LEASE_TIMEOUT_MS 10000  // Covers a cold interpreter start
+
+typedef enum PythonWorkerState {
+    PYTHON_WORKER_EMPTY = 0,   // Free slot
+    PYTHON_WORKER_STARTING,    // Spawned or resetting; waiting for "worker_ready"
+    PYTHON_WORKER_IDLE,        // Ready to load a program
+    PYTHON_WORKER_LEASED       // Process handed to a bridge
+} PythonWorkerState;
+
+typedef struct PythonWorker {
+    PythonWorkerState state;
+    Subprocess process;
+
+    // Output scanned while STARTING (leftovers of the previous run are skipped)
+    char buffer[PYTHON_POOL_SCAN_BUFFER];
+    int buffer_pos;
+    bool skip_line;            // Dropping the rest of an oversized line
+} PythonWorker;
+
+typedef struct PythonPool {
+    PythonWorker workers[PYTHON_POOL_MAX_WORKERS];
+    int size;                  // Workers kept alive (leased ones included)
+    char command[2048];        // ipc_bridge.py --worker command line
+} PythonPool;
+
+// Spawn size workers (they start importing immediately)
+// Returns false if no worker could be started
+bool python_pool_init(PythonPool* pool, const char* simulator_dir, int size);
+
+// Shut down every worker not currently leased
+void python_pool_destroy(PythonPool* pool);
+
+// Move an idle worker's process into out, waiting up to timeout_ms for one
+// Spawns an extra worker if every worker is leased
+bool python_pool_lease(PythonPool* pool, Subprocess* out, int timeout_ms);
+
+// Take back a leased process after its bridge sent "unload"
+void python_pool_release(PythonPool* pool, Subprocess* proc);
+
+// Non-blocking: mark workers that finished starting/resetting as idle and
+// replace workers that exited
+void python_pool_update(PythonPool* pool);
+
+// Workers ready to lease right now
+int python_pool_idle_count(const PythonPool* pool);
+
+#endif // PYTHON_POOL_H
@@ -8,10 +8,46 @@
 #include <string.h>
 #include <stdlib.h>
 
+// Hand out bytes buffered by subprocess_read_line before reading the pipe
+static int take_buffered(Subprocess* proc, char* buffer, size_t buffer_size) {
+    int available = proc->line_end - proc->line_start;
+    if (available <= 0) return 0;
+    int n = (size_t)available < buffer_size ? available : (int)buffer_size;
+    memcpy(buffer, proc->line_buffer + proc->line_start, n);
+    proc->line_start += n;
+    if (proc->line_start == proc->line_end) proc->line_start = proc->line_end = 0;
+    return n;
+}
+
+// Blocking read of whatever is available (at least one byte)
+// Returns bytes read, 0 on EOF, -1 on error
+static int read_blocking(Subprocess* proc, char* buffer, size_t buffer_size);
+
 #ifdef _WIN32
 // Windows implementation
 #include <io.h>
 
+// stdout is an overlapped named pipe so it can be added to an I/O completion
+// port (io_reactor.h); anonymous pipes don't support overlapped I/O
+static LONG s_pipe_serial = 0;
+
+// Synchronous read on the overlapped stdout handle
+static BOOL read_overlapped(HANDLE handle, void* buffer, DWORD size, DWORD* read_bytes) {
+    HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (!event) return FALSE;
+
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    // Low bit set: don't post this read to a completion port the handle joined
+    ov.hEvent = (HANDLE)((ULONG_PTR)event | 1);
+
+    BOOL ok = ReadFile(handle, buffer, size, NULL, &ov);
+    if (!ok && GetLastError() == ERROR_IO_PENDING) ok = TRUE;
+    if (ok) ok = GetOverlappedResult(handle, &ov, read_bytes, TRUE);
+    CloseHandle(event);
+    return ok;
+}
+
 bool subprocess_spawn(Subprocess* proc, const char* command, const char* working_dir) {
     memset(proc, 0, sizeof(Subprocess));
 
@@ -30,14 +66,27 @@ bool subprocess_spawn(Subprocess* proc, const char* command, const char* working
     }
     SetHandleInformation(stdin_write, HANDLE_FLAG_INHERIT, 0);
 
-    // Create pipes for stdout
-    if (!CreatePipe(&stdout_read, &stdout_write, &sa, 0)) {
-        fprintf(stderr, "CreatePipe stdout failed\n");
+    // Create a uniquely named overlapped pipe for stdout
+    char pipe_name[64];
+    snprintf(pipe_name, sizeof(pipe_name), "\\\\.\\pipe\\vexiq_sim_%lu_%ld",
+             GetCurrentProcessId(), InterlockedIncrement(&s_pipe_serial));
+    stdout_read = CreateNamedPipeA(pipe_name,
+                                   PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                   PIPE_TYPE_BYTE | PIPE_WAIT, 1, 65536, 65536, 0, NULL);
+    if (stdout_read == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "CreateNamedPipe stdout failed: %lu\n", GetLastError());
+        CloseHandle(stdin_read);
+        CloseHandle(stdin_write);
+        return false;
+    }
+    stdout_write = CreateFileA(pipe_name, GENERIC_WRITE, 0, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (stdout_write == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "Open stdout pipe failed: %lu\n", GetLastError());
         CloseHandle(stdin_read);
         CloseHandle(stdin_write);
+        CloseHandle(stdout_read);
         return false;
     }
-    SetHandleInformation(stdout_read, HANDLE_FLAG_INHERIT, 0);
 
     STARTUPINFOA si;
     PROCESS_INFORMATION pi;
@@ -104,6 +153,9 @@ bool subprocess_write_str(Subprocess* proc, const char* str) {
 int subprocess_read(Subprocess* proc, char* buffer, size_t buffer_size) {
     if (!proc->running) return -1;
 
+    int buffered = take_buffered(proc, buffer, buffer_size);
+    if (buffered > 0) return buffered;
+
     DWORD available;
     if (!PeekNamedPipe(proc->stdout_read, NULL, 0, NULL, &available, NULL)) {
         return -1;
@@ -113,39 +165,36 @@ int subprocess_read(Subprocess* proc, char* buffer, size_t buffer_size) {
 
     DWORD to_read = (available < buffer_size) ? available : (DWORD)buffer_size;
     DWORD read_bytes;
-    if (!ReadFile(proc->stdout_read, buffer, to_read, &read_bytes, NULL)) {
+    if (!read_overlapped(proc->stdout_read, buffer, to_read, &read_bytes)) {
         return -1;
     }
 
     return (int)read_bytes;
 }
 
-bool subprocess_read_line(Subprocess* proc, char* buffer, size_t buffer_size) {
-    if (!proc->running || buffer_size == 0) return false;
+static int read_blocking(Subprocess* proc, char* buffer, size_t buffer_size) {
+    DWORD read_bytes;
+    if (!read_overlapped(proc->stdout_read, buffer, (DWORD)buffer_size, &read_bytes)) {
+        return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+    }
+    return (int)read_bytes;
+}
 
-    size_t pos = 0;
-    while (pos < buffer_size - 1) {
-        DWORD read_bytes;
-        char c;
-        if (!ReadFile(proc->stdout_read, &c, 1, &read_bytes, NULL) || read_bytes == 0) {
-            if (pos > 0) {
-                buffer[pos] = '\0';
-                return true;
+bool subprocess_wait_readable(Subprocess* const* procs, int count, int timeout_ms) {
+    // Anonymous pipes can't be waited on; poll them with short sleeps
+    DWORD start = GetTickCount();
+    for (;;) {
+        for (int i = 0; i < count; i++) {
+            DWORD available = 0;
+            if (!procs[i]->running) continue;
+            if (!PeekNamedPipe(procs[i]->stdout_read, NULL, 0, NULL, &available, NULL) ||
+                available > 0) {
+                return true;  // Data, or a broken pipe the reader will notice
             }
-            return false;
-        }
-
-        if (c == '\n') {
-            buffer[pos] = '\0';
-            return true;
-        }
-        if (c != '\r') {
-            buffer[pos++] = c;
         }
+        if ((int)(GetTickCount() - start) >= timeout_ms) return false;
+        Sleep(1);
     }
-
-    buffer[pos] = '\0';
-    return true;
 }
 
 bool subprocess_is_running(Subprocess* proc) {
@@ -184,6 +233,7 @@ void subprocess_destroy(Subprocess* proc) {
 #include <signal.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
 
 bool subprocess_spawn(Subprocess* proc, const char* command, const char* working_dir) {
     memset(proc, 0, sizeof(Subprocess));
@@ -267,6 +317,9 @@ bool subprocess_write_str(Subprocess* proc, const char* str) {
 int subprocess_read(Subprocess* proc, char* buffer, size_t buffer_size) {
     if (!proc->running) return -1;
 
+    int buffered = take_buffered(proc, buffer, buffer_size);
+    if (buffered > 0) return buffered;
+
     ssize_t bytes = read(proc->stdout_fd, buffer, buffer_size);
     if (bytes == -1) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -277,40 +330,41 @@ int subprocess_read(Subprocess* proc, char* buffer, size_t buffer_size) {
     return (int)bytes;
 }
 
-bool subprocess_read_line(Subprocess* proc, char* buffer, size_t buffer_size) {
-    if (!proc->running || buffer_size == 0) return false;
-
-    // Temporarily set to blocking for line read
-    int flags = fcntl(proc->stdout_fd, F_GETFL, 0);
-    fcntl(proc->stdout_fd, F_SETFL, flags & ~O_NONBLOCK);
-
-    size_t pos = 0;
-    while (pos < buffer_size - 1) {
-        char c;
-        ssize_t bytes = read(proc->stdout_fd, &c, 1);
-        if (bytes <= 0) {
-            // Restore non-blocking
-            fcntl(proc->stdout_fd, F_SETFL, flags);
-            if (pos > 0) {
-                buffer[pos] = '\0';
-                return true;
-            }
-            return false;
-        }
+static int read_blocking(Subprocess* proc, char* buffer, size_t buffer_size) {
+    for (;;) {
+        ssize_t bytes = read(proc->stdout_fd, buffer, buffer_size);
+        if (bytes >= 0) return (int)bytes;
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+
+        // Wait for data instead of flipping the fd to blocking mode
+        struct pollfd pfd;
+        pfd.fd = proc->stdout_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, -1) == -1 && errno != EINTR) return -1;
+    }
+}
 
-        if (c == '\n') {
-            buffer[pos] = '\0';
-            fcntl(proc->stdout_fd, F_SETFL, flags);
-            return true;
-        }
-        if (c != '\r') {
-            buffer[pos++] = c;
-        }
+bool subprocess_wait_readable(Subprocess* const* procs, int count, int timeout_ms) {
+    struct pollfd fds[64];
+    if (count > 64) count = 64;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (!procs[i]->running) continue;
+        fds[n].fd = procs[i]->stdout_fd;
+        fds[n].events = POLLIN;
+        fds[n].revents = 0;
+        n++;
     }
+    if (n == 0) return false;
 
-    buffer[pos] = '\0';
-    fcntl(proc->stdout_fd, F_SETFL, flags);
-    return true;
+    int result;
+    do {
+        result = poll(fds, n, timeout_ms);
+    } while (result == -1 && errno == EINTR);
+    return result > 0;
 }
 
 bool subprocess_is_running(Subprocess* proc) {
@@ -343,3 +397,35 @@ void subprocess_destroy(Subprocess* proc) {
 }
 
 #endif
+
+bool subprocess_read_line(Subprocess* proc, char* buffer, size_t buffer_size) {
+    if (!proc->running || buffer_size == 0) return false;
+
+    size_t pos = 0;
+    for (;;) {
+        // Copy buffered bytes up to the newline
+        while (proc->line_start < proc->line_end) {
+            char c = proc->line_buffer[proc->line_start++];
+            if (c == '\n') {
+                buffer[pos] = '\0';
+                return true;
+            }
+            if (c != '\r') {
+                buffer[pos++] = c;
+                if (pos == buffer_size - 1) {
+                    buffer[pos] = '\0';
+                    return true;
+                }
+            }
+        }
+
+        // Refill in one chunk
+        proc->line_start = proc->line_end = 0;
+        int bytes = read_blocking(proc, proc->line_buffer, sizeof(proc->line_buffer));
+        if (bytes <= 0) {
+            buffer[pos] = '\0';
+            return pos > 0;
+        }
+        proc->line_end = bytes;
+    }
+}
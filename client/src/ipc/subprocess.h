@@ -15,6 +15,9 @@
 #include <sys/types.h>
 #endif
 
+// Read-ahead buffer for subprocess_read_line
+#define SUBPROCESS_LINE_BUFFER 4096
+
 typedef struct Subprocess {
     bool running;
 
@@ -22,12 +25,17 @@ typedef struct Subprocess {
     HANDLE process;
     HANDLE thread;
     HANDLE stdin_write;
-    HANDLE stdout_read;
+    HANDLE stdout_read;    // Overlapped named pipe (can join an I/O completion port)
 #else
     pid_t pid;
     int stdin_fd;   // Write to child's stdin
-    int stdout_fd;  // Read from child's stdout
+    int stdout_fd;  // Read from child's stdout (non-blocking)
 #endif
+
+    // Bytes read ahead by subprocess_read_line; subprocess_read returns them first
+    char line_buffer[SUBPROCESS_LINE_BUFFER];
+    int line_start;
+    int line_end;
 } Subprocess;
 
 // Spawn a subprocess with piped stdin/stdout
@@ -47,9 +55,14 @@ bool subprocess_write_str(Subprocess* proc, const char* str);
 int subprocess_read(Subprocess* proc, char* buffer, size_t buffer_size);
 
 // Read a line from subprocess stdout (blocks until newline or EOF)
+// Reads in chunks; bytes past the newline are kept for the next read
 // Returns true if a line was read, false on error/EOF
 bool subprocess_read_line(Subprocess* proc, char* buffer, size_t buffer_size);
 
+// Wait until at least one subprocess has stdout data (or EOF) to read
+// Returns true if one is readable, false on timeout/error
+bool subprocess_wait_readable(Subprocess* const* procs, int count, int timeout_ms);
+
 // Check if subprocess is still running
 bool subprocess_is_running(Subprocess* proc);
 
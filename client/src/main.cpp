@@ -32,7 +32,7 @@
  * TRANSFORMATION PIPELINE:
  *   1. MPD file specifies part positions/rotations in LDraw coordinates (LDU)
  *   2. MPD loader parses and flattens the submodel hierarchy
- *   3. build_ldraw_model_matrix() converts LDraw -> OpenGL:
+ *   3. sim_part_world_matrix() (sim/sim_world.cpp) converts LDraw -> OpenGL:
  *      - Position: Multiply by LDU_SCALE (0.02), flip Y and Z
  *      - Rotation: Apply C*M*C where C = diag(1, -1, -1)
  *   4. GLB meshes are already in OpenGL coordinates (from Blender export)
@@ -57,7 +57,7 @@
  *   - models/<name>.robotdef    - Robot definition files (kinematics, ports, etc.)
  *
  * FOR CUSTOM (NON-LDRAW) GLB OBJECTS:
- *   - Use build_model_matrix() instead of build_ldraw_model_matrix()
+ *   - Use build_model_matrix() instead of sim_part_world_matrix()
  *   - No coordinate conversion needed - GLB is already in OpenGL coords
  *   - Position directly in world units (inches)
  *
@@ -70,29 +70,42 @@
 #include "render/camera.h"
 #include "render/floor.h"
 #include "render/glb_loader.h"
+#include "render/mesh_cache.h"
 #include "render/mesh.h"
 #include "render/mpd_loader.h"
 #include "render/text.h"
 #include "render/debug.h"
+#include "render/frustum.h"
 #include "render/objects.h"
+#include "render/gpu_field.h"
+#include "render/offscreen.h"
+#include "render/render_queue.h"
 #include "scene/scene.h"
-#include "physics/drivetrain.h"
-#include "physics/robotdef.h"
+#include "scene/scene_reload.h"
 #include "physics/obb.h"
 #include "ipc/gamepad.h"
 #include "ipc/python_bridge.h"
-#include "physics/robot_config.h"
+#include "sim/sim_world.h"
+#include "sim/sim_thread.h"
+#include "sim/profiler.h"
+#include "sim/arena.h"
+#include "sim/replay.h"
+#include "ipc/net_stream.h"
+#include "sim/snapshot.h"
 
 #include <GL/glew.h>
 #include <SDL.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <map>
-#include <string>
 #include <vector>
-#include <cfloat>  // FLT_MAX
+#include <map>
+#include <algorithm>  // std::stable_sort
 #include <cmath>   // cosf, sinf
+#include <cfloat>  // FLT_MAX
+#include <chrono>  // headless wall-clock timing
+#include <mutex>
+#include <thread>  // frame rate cap
 
 #ifdef _WIN32
 #include <windows.h>
@@ -109,14 +122,20 @@
 
 // World scale: 1 unit = 1 inch
 // VEX IQ field is 8ft x 6ft = 96" x 72"
-#define FIELD_WIDTH 96.0f   // 8 feet in inches
-#define FIELD_DEPTH 72.0f   // 6 feet in inches
+#define FIELD_WIDTH SIM_FIELD_WIDTH   // 8 feet in inches
+#define FIELD_DEPTH SIM_FIELD_DEPTH   // 6 feet in inches
 #define GRID_SIZE 12.0f     // 1 foot grid (12 inches)
 #define WALL_HEIGHT 4.0f    // 4 inch walls around field
 
 // UI Panel dimensions
 #define PANEL_WIDTH 220     // Left side panel width in pixels
 
+// Part meshes uploaded per frame with --stream-meshes
+#define MESH_STREAM_PER_FRAME 16
+
+// Initial frame arena chunk (grows to the largest frame)
+#define FRAME_ARENA_SIZE (256 * 1024)
+
 // Degrees to radians conversion
 #define DEG_TO_RAD_CONST (3.14159265359f / 180.0f)
 
@@ -291,82 +310,6 @@ static void axis_gizmo_destroy(AxisGizmo* axis) {
 }
 // ============================================================================
 
-// Wheel assembly for a robot (runtime data)
-struct WheelAssembly {
-    float world_position[3];   // LDU - center of wheel
-    float spin_axis[3];        // Rotation axis (normalized)
-    float diameter_mm;         // For calculating spin rate
-    float spin_angle;          // Current rotation angle (radians)
-    char part_numbers[ROBOTDEF_MAX_WHEEL_PARTS][32];
-    int part_count;
-    bool is_left;
-};
-
-// Maximum submodels and parts for collision
-#define MAX_ROBOT_SUBMODELS 64
-#define MAX_ROBOT_PARTS 512
-
-// Collision state for hierarchical detection
-enum CollisionState {
-    COLLISION_NONE = 0,       // No collision (green)
-    COLLISION_SUBMODEL = 1,   // Submodel boundary hit (yellow)
-    COLLISION_PART = 2,       // Part collision (red)
-    COLLISION_EXTERNAL = 3    // External object (orange)
-};
-
-// Robot instance (loaded from scene)
-struct RobotInstance {
-    float offset[3];      // World position offset (inches)
-    float rotation_y;     // Rotation around Y axis (radians)
-    float ground_offset;  // Computed ground offset for this robot
-    Drivetrain drivetrain; // Physics drivetrain for this robot
-
-    // Python IPC bridge (for robots with iqpython programs)
-    PythonBridge* bridge;     // NULL if no program
-    RobotConfig motor_config; // Motor port assignments
-
-    // From robotdef
-    float rotation_center[3];  // Drivetrain center in LDU (converted to world coords for rotation)
-    float rotation_axis[3];    // Rotation axis (default: [0,1,0] = vertical)
-    float track_width;         // Track width in LDU
-    bool has_robotdef;         // Whether robotdef was loaded
-
-    // Wheel assemblies
-    WheelAssembly wheels[ROBOTDEF_MAX_WHEELS];
-    int wheel_count;
-
-    // Hierarchical OBB collision data (in robot-local OpenGL coordinates)
-    OBB submodel_obbs[MAX_ROBOT_SUBMODELS];  // OBBs for each submodel
-    int submodel_collision_state[MAX_ROBOT_SUBMODELS];  // Collision state per submodel
-    char submodel_names[MAX_ROBOT_SUBMODELS][128];  // Submodel names for debugging
-    int submodel_count;
-
-    // Part indices for each submodel (for hierarchical lookup)
-    int submodel_part_start[MAX_ROBOT_SUBMODELS];  // First part index for this submodel
-    int submodel_part_count[MAX_ROBOT_SUBMODELS];  // Number of parts in this submodel
-
-    // First part index in global parts array (for this robot)
-    size_t parts_start_index;
-    size_t parts_count;
-};
-
-// Part instance for rendering
-struct PartInstance {
-    Mesh* mesh;           // Pointer to cached mesh
-    float position[3];    // Position in LDraw units (before robot offset)
-    float rotation[9];    // 3x3 rotation matrix (row-major)
-    float color[3];       // RGB color (0-1)
-    bool has_color;       // Whether to apply color override
-    int robot_index;      // Which robot this part belongs to (-1 = no robot)
-    int wheel_index;      // Which wheel assembly this part belongs to (-1 = not a wheel)
-    char part_number[32]; // Part number for wheel matching
-
-    // Collision data
-    int submodel_index;   // Which submodel this part belongs to (-1 = none)
-    OBB local_obb;        // OBB in robot-local OpenGL coordinates
-    int collision_state;  // Current collision state (for debug coloring)
-};
-
 // Get the directory containing the executable
 static void get_exe_dir(char* buffer, size_t size) {
 #ifdef _WIN32
@@ -400,18 +343,6 @@ static void get_models_dir(char* buffer, size_t size) {
     snprintf(buffer, size, "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "models", exe_dir);
 }
 
-// Convert .dat part name to .glb path
-static std::string part_name_to_glb(const char* part_name) {
-    std::string name(part_name);
-    // Replace .dat with .glb (case insensitive)
-    size_t pos = name.rfind(".dat");
-    if (pos == std::string::npos) pos = name.rfind(".DAT");
-    if (pos != std::string::npos) {
-        name = name.substr(0, pos) + ".glb";
-    }
-    return name;
-}
-
 // Build model matrix for standard GLB objects (no coordinate conversion)
 // pos: world position, rot_y: rotation around Y axis in radians, scale: uniform scale
 static Mat4 build_model_matrix(Vec3 pos, float rot_y, float scale) {
@@ -428,944 +359,931 @@ static Mat4 build_model_matrix(Vec3 pos, float rot_y, float scale) {
     return m;
 }
 
-// Build model matrix for LDraw parts (converts from LDraw to OpenGL coordinates)
-// pos: position in LDU, rot: 3x3 rotation matrix (row-major) from MPD file
-// robot: robot instance with offset and ground offset (can be NULL for no robot)
-// wheel: wheel assembly for spin rotation (can be NULL for no wheel spin)
-static Mat4 build_ldraw_model_matrix(const float* pos, const float* rot, const RobotInstance* robot,
-                                      const WheelAssembly* wheel = nullptr) {
-    // LDraw rotation matrix is row-major: [a b c] [d e f] [g h i]
-    float a = rot[0], b = rot[1], c = rot[2];
-    float d = rot[3], e = rot[4], f = rot[5];
-    float g = rot[6], h = rot[7], i = rot[8];
-
-    // Part position in LDU (LDraw coordinates)
-    float px = pos[0];
-    float py = pos[1];
-    float pz = pos[2];
-
-    // Apply wheel spin rotation if present (before robot rotation)
-    // Only rotate the orientation matrix - wheels spin in place, position doesn't change
-    if (wheel && wheel->spin_angle != 0.0f) {
-        // Rotation axis (already normalized)
-        float ax = wheel->spin_axis[0];
-        float ay = wheel->spin_axis[1];
-        float az = wheel->spin_axis[2];
-
-        float cos_a = cosf(wheel->spin_angle);
-        float sin_a = sinf(wheel->spin_angle);
-        float one_minus_cos = 1.0f - cos_a;
-
-        // Rotate the orientation matrix using Rodrigues' formula
-        // For each column of the rotation matrix, rotate it around the axis
-        // Column 0 (a, d, g)
-        float c0_cross_x = ay * g - az * d;
-        float c0_cross_y = az * a - ax * g;
-        float c0_cross_z = ax * d - ay * a;
-        float c0_dot = ax * a + ay * d + az * g;
-        float na = a * cos_a + c0_cross_x * sin_a + ax * c0_dot * one_minus_cos;
-        float nd = d * cos_a + c0_cross_y * sin_a + ay * c0_dot * one_minus_cos;
-        float ng = g * cos_a + c0_cross_z * sin_a + az * c0_dot * one_minus_cos;
-
-        // Column 1 (b, e, h)
-        float c1_cross_x = ay * h - az * e;
-        float c1_cross_y = az * b - ax * h;
-        float c1_cross_z = ax * e - ay * b;
-        float c1_dot = ax * b + ay * e + az * h;
-        float nb = b * cos_a + c1_cross_x * sin_a + ax * c1_dot * one_minus_cos;
-        float ne = e * cos_a + c1_cross_y * sin_a + ay * c1_dot * one_minus_cos;
-        float nh = h * cos_a + c1_cross_z * sin_a + az * c1_dot * one_minus_cos;
-
-        // Column 2 (c, f, i)
-        float c2_cross_x = ay * i - az * f;
-        float c2_cross_y = az * c - ax * i;
-        float c2_cross_z = ax * f - ay * c;
-        float c2_dot = ax * c + ay * f + az * i;
-        float nc = c * cos_a + c2_cross_x * sin_a + ax * c2_dot * one_minus_cos;
-        float nf = f * cos_a + c2_cross_y * sin_a + ay * c2_dot * one_minus_cos;
-        float ni = i * cos_a + c2_cross_z * sin_a + az * c2_dot * one_minus_cos;
-
-        a = na; b = nb; c = nc;
-        d = nd; e = ne; f = nf;
-        g = ng; h = nh; i = ni;
-    }
-
-    // Apply robot rotation if present (in LDraw space, before coordinate conversion)
-    if (robot) {
-        // Rotation center in LDU
-        float pivot_x = robot->rotation_center[0];
-        float pivot_y = robot->rotation_center[1];
-        float pivot_z = robot->rotation_center[2];
-
-        // Part position relative to pivot (in LDU)
-        float rel_x = px - pivot_x;
-        float rel_y = py - pivot_y;
-        float rel_z = pz - pivot_z;
-
-        // Rotate around Y axis in LDraw space
-        // Note: In LDraw, Y is down, so rotation around Y is still around the vertical axis
-        // But the rotation direction might be inverted relative to OpenGL
-        float cos_r = cosf(robot->rotation_y);
-        float sin_r = sinf(robot->rotation_y);
-
-        // Rotate position (in LDraw XZ plane)
-        // Using Ry_ldraw: [cos 0 -sin; 0 1 0; sin 0 cos]
-        float rx = rel_x * cos_r - rel_z * sin_r;
-        float rz = rel_x * sin_r + rel_z * cos_r;
-
-        // Update position relative to pivot
-        px = rx + pivot_x;
-        py = rel_y + pivot_y;
-        pz = rz + pivot_z;
-
-        // Rotate the orientation matrix (left-multiply by Ry in LDraw space)
-        // Ry_ldraw = [cos 0 -sin; 0 1 0; sin 0 cos] (note: different from OpenGL Ry)
-        // Because in LDraw, Z points back, so positive rotation is opposite
-        float na = cos_r * a - sin_r * g;
-        float nb = cos_r * b - sin_r * h;
-        float nc = cos_r * c - sin_r * i;
-        float ng = sin_r * a + cos_r * g;
-        float nh = sin_r * b + cos_r * h;
-        float ni = sin_r * c + cos_r * i;
-        a = na; b = nb; c = nc;
-        g = ng; h = nh; i = ni;
-        // d, e, f unchanged (Y row doesn't change for Y-axis rotation)
-    }
-
-    // Now convert from LDraw to OpenGL coordinates
-    // LDraw: Y-down, Z-back; OpenGL: Y-up, Z-front
-    // Apply coordinate change: C * M * C where C = diag(1, -1, -1)
-    float a2 = a,  b2 = -b, c2 = -c;
-    float d2 = -d, e2 = e,  f2 = f;
-    float g2 = -g, h2 = h,  i2 = i;
-
-    // Convert position to OpenGL coordinates
-    float wx = px * LDU_SCALE;
-    float wy = -py * LDU_SCALE;
-    float wz = -pz * LDU_SCALE;
-
-    // Apply robot world offset
-    if (robot) {
-        // Pivot position in OpenGL coords
-        float pivot_gl_x = robot->rotation_center[0] * LDU_SCALE;
-        float pivot_gl_y = -robot->rotation_center[1] * LDU_SCALE;
-        float pivot_gl_z = -robot->rotation_center[2] * LDU_SCALE;
-
-        // wx, wy, wz is the rotated position relative to robot origin, in OpenGL coords
-        // Offset so that the pivot point ends up at robot->offset
-        wx = wx - pivot_gl_x + robot->offset[0];
-        wy = wy - pivot_gl_y + robot->offset[1] + robot->ground_offset;
-        wz = wz - pivot_gl_z + robot->offset[2];
-    }
-
-    // OpenGL column-major matrix
-    Mat4 m;
-    // Column 0
-    m.m[0]  = a2;
-    m.m[1]  = d2;
-    m.m[2]  = g2;
-    m.m[3]  = 0;
-    // Column 1
-    m.m[4]  = b2;
-    m.m[5]  = e2;
-    m.m[6]  = h2;
-    m.m[7]  = 0;
-    // Column 2
-    m.m[8]  = c2;
-    m.m[9]  = f2;
-    m.m[10] = i2;
-    m.m[11] = 0;
-    // Column 3 (translation)
-    m.m[12] = wx;
-    m.m[13] = wy;
-    m.m[14] = wz;
-    m.m[15] = 1;
-
-    return m;
-}
-
-// Compute ground offset for a specific robot from bounding boxes
-// Finds the minimum Y value across all parts belonging to robot_index
-static float compute_ground_offset(const std::vector<PartInstance>& parts, int robot_index) {
-    if (parts.empty()) return 0.0f;
-
-    float min_y = FLT_MAX;
-
-    for (const auto& part : parts) {
-        if (!part.mesh) continue;
-        if (part.robot_index != robot_index) continue;
-
-        // Transform local bounding box to world space using the same transform as rendering
-        // Apply C*M*C rotation (flip Y and Z)
-        float d = part.rotation[3], e = part.rotation[4], f = part.rotation[5];
-        float d2 = -d, e2 = e,  f2 = f;  // Only need row 2 for Y calculation
-
-        // Transform all 8 corners of bounding box to find true minimum Y
-        float min_x = part.mesh->min_bounds[0], max_x = part.mesh->max_bounds[0];
-        float min_y_local = part.mesh->min_bounds[1], max_y_local = part.mesh->max_bounds[1];
-        float min_z = part.mesh->min_bounds[2], max_z = part.mesh->max_bounds[2];
-
-        float corners[8][3];
-        int idx = 0;
-        for (int xi = 0; xi < 2; xi++) {
-            for (int yi = 0; yi < 2; yi++) {
-                for (int zi = 0; zi < 2; zi++) {
-                    corners[idx][0] = (xi == 0) ? min_x : max_x;
-                    corners[idx][1] = (yi == 0) ? min_y_local : max_y_local;
-                    corners[idx][2] = (zi == 0) ? min_z : max_z;
-                    idx++;
-                }
-            }
-        }
-
-        // Transform each corner and find minimum Y
-        for (int ci = 0; ci < 8; ci++) {
-            float lx = corners[ci][0], ly = corners[ci][1], lz = corners[ci][2];
-
-            // Rotated point (using transformed rotation matrix)
-            float ry = d2 * lx + e2 * ly + f2 * lz;
+// =============================================================================
+// Part Meshes
+// =============================================================================
 
-            // World Y = rotated Y + translated Y (without ground offset)
-            float world_y = ry + (-part.position[1] * LDU_SCALE);
+// GPU meshes for parts, indexed by PartRender::mesh_id
+struct MeshStore {
+    std::vector<Mesh*> meshes;
+
+    // Identical geometry under different part names shares one mesh
+    std::map<uint64_t, int> mesh_by_hash;   // mesh_data_hash -> mesh_id
+    uint32_t merged_count;                  // Parts resolved to an existing mesh
+    size_t gpu_bytes;
+
+    // Instanced rendering: part indices sorted by mesh, so each mesh's
+    // instances are contiguous and drawn with one call
+    bool instanced;
+    std::vector<uint32_t> draw_order;
+    std::vector<MeshInstance> instances;
+
+    // Level of detail picked per part each frame (indexed like parts,
+    // MESH_LOD_CULLED for parts outside the view)
+    bool lod_enabled;
+    std::vector<uint8_t> part_lod;
+    std::vector<uint32_t> visible_order;   // draw_order minus culled parts
+    uint32_t visible_count;
+
+    // Robot-local bounds of each robot's parts, for whole-robot culling
+    std::vector<OBB> robot_bounds;
+    std::vector<uint8_t> submodel_visible;  // Scratch of mesh_store_select_lods (one robot)
+};
 
-            if (world_y < min_y) {
-                min_y = world_y;
-            }
-        }
+#define MESH_LOD_CULLED 0xFF          // part_lod of parts not drawn this frame
+#define PART_CULL_MIN_PIXELS 1.0f     // Parts smaller than this on screen are skipped
+
+// SimWorld asset resolver: upload a loaded part mesh as a render mesh
+static bool resolve_part_mesh(void* user_data, const char* glb_name,
+                              const MeshData* mesh_data, SimPartAsset* out) {
+    MeshStore* store = (MeshStore*)user_data;
+    (void)glb_name;
+
+    uint64_t hash = mesh_data_hash(mesh_data);
+    auto it = store->mesh_by_hash.find(hash);
+    if (it != store->mesh_by_hash.end()) {
+        out->mesh_id = it->second;
+        store->merged_count++;
+        return true;
     }
 
-    // Return offset to lift robot so min_y becomes 0
-    return (min_y == FLT_MAX) ? 0.0f : -min_y;
-}
-
-// Compute a part's local OBB in robot-local OpenGL coordinates
-// This transforms the mesh bounding box by the part's LDraw transform,
-// converts to OpenGL coordinates, and makes it relative to the robot's rotation center
-static void compute_part_local_obb(PartInstance* part, const float* rotation_center_ldu) {
-    if (!part->mesh) {
-        // Default empty OBB
-        part->local_obb.center = vec3(0, 0, 0);
-        part->local_obb.half_extents = vec3(0, 0, 0);
-        part->local_obb.rotation[0] = 1; part->local_obb.rotation[1] = 0; part->local_obb.rotation[2] = 0;
-        part->local_obb.rotation[3] = 0; part->local_obb.rotation[4] = 1; part->local_obb.rotation[5] = 0;
-        part->local_obb.rotation[6] = 0; part->local_obb.rotation[7] = 0; part->local_obb.rotation[8] = 1;
-        return;
+    Mesh* mesh = new Mesh();
+    if (!mesh_create(mesh, mesh_data)) {
+        delete mesh;
+        return false;
     }
 
-    // LDraw rotation matrix (row-major)
-    float a = part->rotation[0], b = part->rotation[1], c = part->rotation[2];
-    float d = part->rotation[3], e = part->rotation[4], f = part->rotation[5];
-    float g = part->rotation[6], h = part->rotation[7], i = part->rotation[8];
-
-    // Convert rotation from LDraw to OpenGL: C*M*C where C = diag(1,-1,-1)
-    float a2 = a,  b2 = -b, c2 = -c;
-    float d2 = -d, e2 = e,  f2 = f;
-    float g2 = -g, h2 = h,  i2 = i;
-
-    // Store converted rotation in OBB (row-major)
-    part->local_obb.rotation[0] = a2; part->local_obb.rotation[1] = b2; part->local_obb.rotation[2] = c2;
-    part->local_obb.rotation[3] = d2; part->local_obb.rotation[4] = e2; part->local_obb.rotation[5] = f2;
-    part->local_obb.rotation[6] = g2; part->local_obb.rotation[7] = h2; part->local_obb.rotation[8] = i2;
-
-    // Mesh bounds (in GLB/OpenGL space)
-    Vec3 mesh_min = vec3(part->mesh->min_bounds[0], part->mesh->min_bounds[1], part->mesh->min_bounds[2]);
-    Vec3 mesh_max = vec3(part->mesh->max_bounds[0], part->mesh->max_bounds[1], part->mesh->max_bounds[2]);
-
-    // Half extents from mesh bounds (don't change - they're in local mesh space)
-    part->local_obb.half_extents.x = (mesh_max.x - mesh_min.x) * 0.5f;
-    part->local_obb.half_extents.y = (mesh_max.y - mesh_min.y) * 0.5f;
-    part->local_obb.half_extents.z = (mesh_max.z - mesh_min.z) * 0.5f;
-
-    // Center of mesh bounds (in mesh local space)
-    Vec3 mesh_center;
-    mesh_center.x = (mesh_min.x + mesh_max.x) * 0.5f;
-    mesh_center.y = (mesh_min.y + mesh_max.y) * 0.5f;
-    mesh_center.z = (mesh_min.z + mesh_max.z) * 0.5f;
-
-    // Transform mesh center by part rotation (in OpenGL space)
-    float cx = a2 * mesh_center.x + b2 * mesh_center.y + c2 * mesh_center.z;
-    float cy = d2 * mesh_center.x + e2 * mesh_center.y + f2 * mesh_center.z;
-    float cz = g2 * mesh_center.x + h2 * mesh_center.y + i2 * mesh_center.z;
-
-    // Part position converted from LDraw to OpenGL, relative to rotation center
-    float px = (part->position[0] - rotation_center_ldu[0]) * LDU_SCALE;
-    float py = -(part->position[1] - rotation_center_ldu[1]) * LDU_SCALE;  // Y flipped
-    float pz = -(part->position[2] - rotation_center_ldu[2]) * LDU_SCALE;  // Z flipped
-
-    // Final center = part position + rotated mesh center
-    part->local_obb.center.x = px + cx;
-    part->local_obb.center.y = py + cy;
-    part->local_obb.center.z = pz + cz;
+    out->mesh_id = (int)store->meshes.size();
+    store->meshes.push_back(mesh);
+    store->mesh_by_hash[hash] = out->mesh_id;
+    store->gpu_bytes += mesh->gpu_bytes;
+    return true;
 }
 
-// Compute submodel OBB by combining all part OBBs in that submodel
-// Uses AABB encompassing all parts, then creates OBB with identity rotation
-static void compute_submodel_obb(RobotInstance* robot, int submodel_idx,
-                                  const std::vector<PartInstance>& parts) {
-    if (submodel_idx < 0 || submodel_idx >= robot->submodel_count) return;
-
-    int start = robot->submodel_part_start[submodel_idx];
-    int count = robot->submodel_part_count[submodel_idx];
-
-    if (count == 0) {
-        // Empty submodel
-        robot->submodel_obbs[submodel_idx].center = vec3(0, 0, 0);
-        robot->submodel_obbs[submodel_idx].half_extents = vec3(0, 0, 0);
-        return;
+// Group parts by mesh for instanced rendering (call after the world is loaded)
+static void mesh_store_build_draw_order(MeshStore* store, const SimWorld* world) {
+    const std::vector<PartRender>& parts = world->parts.render;
+    store->draw_order.clear();
+    for (uint32_t i = 0; i < (uint32_t)parts.size(); i++) {
+        if (parts[i].mesh_id >= 0) store->draw_order.push_back(i);
     }
-
-    // Find AABB encompassing all parts in this submodel
-    float min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
-    float max_x = -FLT_MAX, max_y = -FLT_MAX, max_z = -FLT_MAX;
-
-    for (int i = 0; i < count; i++) {
-        size_t part_idx = robot->parts_start_index + start + i;
-        if (part_idx >= parts.size()) continue;
-
-        const PartInstance& part = parts[part_idx];
-        if (!part.mesh) continue;
-
-        // Get corners of part OBB
-        Vec3 corners[8];
-        obb_get_corners(&part.local_obb, corners);
-
-        for (int c = 0; c < 8; c++) {
-            if (corners[c].x < min_x) min_x = corners[c].x;
-            if (corners[c].y < min_y) min_y = corners[c].y;
-            if (corners[c].z < min_z) min_z = corners[c].z;
-            if (corners[c].x > max_x) max_x = corners[c].x;
-            if (corners[c].y > max_y) max_y = corners[c].y;
-            if (corners[c].z > max_z) max_z = corners[c].z;
+    std::stable_sort(store->draw_order.begin(), store->draw_order.end(),
+                     [&parts](uint32_t a, uint32_t b) { return parts[a].mesh_id < parts[b].mesh_id; });
+    store->instances.resize(store->draw_order.size());
+
+    store->robot_bounds.resize(world->robots.size());
+    for (size_t ri = 0; ri < world->robots.size(); ri++) {
+        const RobotInstance& robot = world->robots[ri];
+        AABB bounds;
+        bounds.min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        bounds.max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (size_t i = robot.parts_start_index; i < robot.parts_start_index + robot.parts_count && i < parts.size(); i++) {
+            AABB part_aabb;
+            obb_get_enclosing_aabb(&world->parts.collision[i].local_obb, &part_aabb);
+            bounds.min = vec3(fminf(bounds.min.x, part_aabb.min.x), fminf(bounds.min.y, part_aabb.min.y),
+                              fminf(bounds.min.z, part_aabb.min.z));
+            bounds.max = vec3(fmaxf(bounds.max.x, part_aabb.max.x), fmaxf(bounds.max.y, part_aabb.max.y),
+                              fmaxf(bounds.max.z, part_aabb.max.z));
         }
+        if (bounds.min.x > bounds.max.x) bounds.min = bounds.max = vec3(0, 0, 0);
+        obb_from_bounds(&store->robot_bounds[ri], bounds.min, bounds.max);
     }
+}
 
-    // Create AABB-style OBB (identity rotation)
-    OBB* obb = &robot->submodel_obbs[submodel_idx];
-    obb->center.x = (min_x + max_x) * 0.5f;
-    obb->center.y = (min_y + max_y) * 0.5f;
-    obb->center.z = (min_z + max_z) * 0.5f;
-    obb->half_extents.x = (max_x - min_x) * 0.5f;
-    obb->half_extents.y = (max_y - min_y) * 0.5f;
-    obb->half_extents.z = (max_z - min_z) * 0.5f;
-
-    // Identity rotation (submodel OBB is axis-aligned in robot local space)
-    obb->rotation[0] = 1; obb->rotation[1] = 0; obb->rotation[2] = 0;
-    obb->rotation[3] = 0; obb->rotation[4] = 1; obb->rotation[5] = 0;
-    obb->rotation[6] = 0; obb->rotation[7] = 0; obb->rotation[8] = 1;
+static void mesh_store_print_stats(const MeshStore* store) {
+    printf("[Mesh] %zu meshes (%u part types merged), %.1f KB of vertex/index buffers\n",
+           store->meshes.size(), store->merged_count, store->gpu_bytes / 1024.0);
 }
 
-// Transform a robot's local OBB to world space
-static void transform_obb_to_world(const OBB* local_obb, const RobotInstance* robot, OBB* world_obb) {
-    // Robot world position (offset from drivetrain)
-    Vec3 robot_pos = vec3(robot->offset[0], robot->ground_offset, robot->offset[2]);
+// World-space bounding sphere of a part's mesh bounds under its model matrix
+static void part_world_sphere(const PartRender* part, const float* model, Vec3* center, float* radius) {
+    const float* c = part->bound_center;
+    *center = vec3(model[0] * c[0] + model[4] * c[1] + model[8] * c[2] + model[12],
+                   model[1] * c[0] + model[5] * c[1] + model[9] * c[2] + model[13],
+                   model[2] * c[0] + model[6] * c[1] + model[10] * c[2] + model[14]);
+    float scale = sqrtf(model[0] * model[0] + model[1] * model[1] + model[2] * model[2]);
+    *radius = part->bound_radius * scale;
+}
 
-    // Get robot's Y rotation matrix
-    float rot[9];
-    mat3_rotation_y(robot->rotation_y, rot);
+// Cull parts against the view (whole robots, then submodels, then parts
+// and sub-pixel parts) and pick a LOD for the rest. Culled parts get
+// MESH_LOD_CULLED; visible ones full detail when LOD is disabled.
+static void mesh_store_select_lods(MeshStore* store, SimWorld* world, const Frustum* frustum,
+                                   const Mat4* view, Vec3 eye, float pixel_scale) {
+    const SimParts& parts = world->parts;
+    store->part_lod.assign(parts.size(), MESH_LOD_CULLED);
+    store->visible_count = 0;
+
+    for (size_t ri = 0; ri < world->robots.size(); ri++) {
+        RobotInstance* robot = &world->robots[ri];
+        sim_robot_update_transform(robot);
+        if (ri < store->robot_bounds.size()) {
+            OBB robot_obb;
+            Vec3 pos = vec3(robot->pose_x, robot->pose_y, robot->pose_z);
+            obb_transform_matrix(&store->robot_bounds[ri], pos, robot->world_rotation, &robot_obb);
+            if (!frustum_test_obb(frustum, &robot_obb)) continue;
+        }
 
-    // Transform OBB to world space
-    obb_transform_matrix(local_obb, robot_pos, rot, world_obb);
-}
+        std::vector<uint8_t>& submodel_visible = store->submodel_visible;
+        submodel_visible.resize(robot->submodel_count);
+        for (int sm = 0; sm < robot->submodel_count; sm++) {
+            submodel_visible[sm] = frustum_test_obb(frustum, sim_submodel_world_obb(robot, sm));
+        }
 
-// Hierarchical collision detection between two robots
-// Returns true if any collision detected, updates collision states
-static bool check_robot_robot_collision(
-    RobotInstance* robot_a, int robot_a_idx,
-    RobotInstance* robot_b, int robot_b_idx,
-    std::vector<PartInstance>& parts)
-{
-    bool any_collision = false;
-
-    // Reset collision states for both robots
-    for (int sm = 0; sm < robot_a->submodel_count; sm++) {
-        robot_a->submodel_collision_state[sm] = COLLISION_NONE;
-    }
-    for (int sm = 0; sm < robot_b->submodel_count; sm++) {
-        robot_b->submodel_collision_state[sm] = COLLISION_NONE;
-    }
-
-    // Check submodel-submodel collisions (Level 1)
-    for (int sm_a = 0; sm_a < robot_a->submodel_count; sm_a++) {
-        OBB world_obb_a;
-        transform_obb_to_world(&robot_a->submodel_obbs[sm_a], robot_a, &world_obb_a);
-
-        for (int sm_b = 0; sm_b < robot_b->submodel_count; sm_b++) {
-            OBB world_obb_b;
-            transform_obb_to_world(&robot_b->submodel_obbs[sm_b], robot_b, &world_obb_b);
-
-            if (obb_intersects_obb(&world_obb_a, &world_obb_b)) {
-                // Submodels intersect - mark as yellow (checking parts)
-                robot_a->submodel_collision_state[sm_a] = COLLISION_SUBMODEL;
-                robot_b->submodel_collision_state[sm_b] = COLLISION_SUBMODEL;
-                any_collision = true;
-
-                // Level 2: Check part-part collisions within these submodels
-                int start_a = robot_a->submodel_part_start[sm_a];
-                int count_a = robot_a->submodel_part_count[sm_a];
-                int start_b = robot_b->submodel_part_start[sm_b];
-                int count_b = robot_b->submodel_part_count[sm_b];
-
-                for (int pa = 0; pa < count_a; pa++) {
-                    size_t idx_a = robot_a->parts_start_index + start_a + pa;
-                    if (idx_a >= parts.size()) continue;
-                    PartInstance& part_a = parts[idx_a];
-                    if (!part_a.mesh) continue;
-
-                    OBB world_part_a;
-                    transform_obb_to_world(&part_a.local_obb, robot_a, &world_part_a);
-
-                    for (int pb = 0; pb < count_b; pb++) {
-                        size_t idx_b = robot_b->parts_start_index + start_b + pb;
-                        if (idx_b >= parts.size()) continue;
-                        PartInstance& part_b = parts[idx_b];
-                        if (!part_b.mesh) continue;
-
-                        OBB world_part_b;
-                        transform_obb_to_world(&part_b.local_obb, robot_b, &world_part_b);
-
-                        if (obb_intersects_obb(&world_part_a, &world_part_b)) {
-                            // Part collision - mark as red
-                            part_a.collision_state = COLLISION_PART;
-                            part_b.collision_state = COLLISION_PART;
-                        }
-                    }
-                }
-            }
+        size_t end = robot->parts_start_index + robot->parts_count;
+        for (size_t i = robot->parts_start_index; i < end && i < parts.size(); i++) {
+            const PartRender* part = &parts.render[i];
+            if (part->mesh_id < 0) continue;
+            int sm = parts.collision[i].submodel_index;
+            if (sm >= 0 && sm < robot->submodel_count && !submodel_visible[sm]) continue;
+
+            const float* model = sim_part_world_matrix(world, i);
+            Vec3 center;
+            float radius;
+            part_world_sphere(part, model, &center, &radius);
+            if (!frustum_test_sphere(frustum, center, radius)) continue;
+            if (frustum_sphere_pixels(eye, center, radius, pixel_scale) < PART_CULL_MIN_PIXELS) continue;
+
+            store->part_lod[i] = store->lod_enabled
+                ? (uint8_t)mesh_select_lod(store->meshes[part->mesh_id], model, view, pixel_scale) : 0;
+            store->visible_count++;
         }
     }
-
-    return any_collision;
 }
 
-// Check robot collision against field walls (AABB)
-static bool check_robot_wall_collision(
-    RobotInstance* robot, int robot_idx,
-    std::vector<PartInstance>& parts,
-    float field_half_width, float field_half_depth)
-{
-    bool any_collision = false;
-
-    // Create AABBs for each wall
-    AABB walls[4];
-    // Left wall (min X)
-    walls[0].min = vec3(-field_half_width - 1.0f, 0.0f, -field_half_depth);
-    walls[0].max = vec3(-field_half_width, 10.0f, field_half_depth);
-    // Right wall (max X)
-    walls[1].min = vec3(field_half_width, 0.0f, -field_half_depth);
-    walls[1].max = vec3(field_half_width + 1.0f, 10.0f, field_half_depth);
-    // Back wall (min Z)
-    walls[2].min = vec3(-field_half_width, 0.0f, -field_half_depth - 1.0f);
-    walls[2].max = vec3(field_half_width, 10.0f, -field_half_depth);
-    // Front wall (max Z)
-    walls[3].min = vec3(-field_half_width, 0.0f, field_half_depth);
-    walls[3].max = vec3(field_half_width, 10.0f, field_half_depth + 1.0f);
-
-    // Check each submodel against walls
-    for (int sm = 0; sm < robot->submodel_count; sm++) {
-        OBB world_obb;
-        transform_obb_to_world(&robot->submodel_obbs[sm], robot, &world_obb);
-
-        for (int w = 0; w < 4; w++) {
-            if (obb_intersects_aabb(&world_obb, &walls[w])) {
-                // Submodel hits wall - mark as checking
-                if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
-                    robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
-                }
-                any_collision = true;
-
-                // Check parts in this submodel
-                int start = robot->submodel_part_start[sm];
-                int count = robot->submodel_part_count[sm];
+// Queue all parts with one instanced draw call per unique mesh and LOD
+static void queue_parts_instanced(MeshStore* store, SimWorld* world, RenderQueue* queue) {
+    const std::vector<PartRender>& parts = world->parts.render;
+    std::vector<uint8_t>& part_lod = store->part_lod;
 
-                for (int p = 0; p < count; p++) {
-                    size_t idx = robot->parts_start_index + start + p;
-                    if (idx >= parts.size()) continue;
-                    PartInstance& part = parts[idx];
-                    if (!part.mesh) continue;
+    // Visible parts only (still sorted by mesh)
+    std::vector<uint32_t>& order = store->visible_order;
+    order.clear();
+    for (uint32_t i : store->draw_order) {
+        if (part_lod[i] != MESH_LOD_CULLED) order.push_back(i);
+    }
+    uint32_t count = (uint32_t)order.size();
+    if (count == 0) return;
+
+    // Group each mesh's instances by LOD
+    uint32_t group_start = 0;
+    while (group_start < count) {
+        int mesh_id = parts[order[group_start]].mesh_id;
+        uint32_t group_end = group_start + 1;
+        while (group_end < count && parts[order[group_end]].mesh_id == mesh_id) group_end++;
+        std::stable_sort(order.begin() + group_start, order.begin() + group_end,
+                         [&part_lod](uint32_t a, uint32_t b) { return part_lod[a] < part_lod[b]; });
+        group_start = group_end;
+    }
 
-                    OBB world_part;
-                    transform_obb_to_world(&part.local_obb, robot, &world_part);
+    // Fill instance data in mesh order
+    for (uint32_t i = 0; i < count; i++) {
+        const PartRender& part = parts[order[i]];
+        MeshInstance* inst = &store->instances[i];
+        memcpy(inst->model, sim_part_world_matrix(world, order[i]), sizeof(inst->model));
+        inst->color[0] = part.has_color ? part.color[0] : 1.0f;
+        inst->color[1] = part.has_color ? part.color[1] : 1.0f;
+        inst->color[2] = part.has_color ? part.color[2] : 1.0f;
+        inst->color[3] = part.has_color ? 1.0f : 0.0f;
+    }
 
-                    if (obb_intersects_aabb(&world_part, &walls[w])) {
-                        part.collision_state = COLLISION_EXTERNAL;
-                    }
-                }
-            }
+    mesh_instances_upload(store->instances.data(), count);
+
+    // One draw per run of parts sharing a mesh and LOD
+    uint32_t run_start = 0;
+    while (run_start < count) {
+        uint32_t first = order[run_start];
+        int mesh_id = parts[first].mesh_id;
+        uint8_t lod = part_lod[first];
+        uint32_t run_end = run_start + 1;
+        while (run_end < count && parts[order[run_end]].mesh_id == mesh_id &&
+               part_lod[order[run_end]] == lod) {
+            run_end++;
         }
+        mesh_queue_instanced(queue, store->meshes[mesh_id], run_start, run_end - run_start, lod);
+        run_start = run_end;
     }
-
-    return any_collision;
 }
 
-// Check robot collision against cylinders
-static bool check_robot_cylinder_collision(
-    RobotInstance* robot, int robot_idx,
-    std::vector<PartInstance>& parts,
-    const Scene* scene)
-{
-    bool any_collision = false;
+// Draw the field, game objects and parts as seen from eye with view and
+// projection into the bound framebuffer (viewport_height in pixels, for LOD).
+// Everything goes through queue in one sorted submit; frustum receives the
+// culling frustum.
+static void render_scene_view(MeshStore* store, SimWorld* world, Floor* floor, GameObjects* objects,
+                              RenderQueue* queue, Mat4 view, Mat4 projection, Vec3 eye, float viewport_height,
+                              Frustum* frustum) {
+    Vec3 light_dir = vec3_normalize(vec3(0.5f, 1.0f, 0.3f));
+    render_queue_begin(queue, &view, &projection, eye, light_dir);
+
+    // Camera frustum for culling objects and parts
+    Mat4 view_projection = mat4_mul(projection, view);
+    frustum_from_matrix(frustum, &view_projection);
+    float pixel_scale = mesh_lod_pixel_scale(&projection, viewport_height);
+
+    floor_queue(floor, queue);
+    objects_queue(objects, queue, frustum);
+
+    // All parts
+    mesh_store_select_lods(store, world, frustum, &view, eye, pixel_scale);
+    if (store->instanced) {
+        queue_parts_instanced(store, world, queue);
+    } else {
+        const SimParts& parts = world->parts;
+        for (size_t pi = 0; pi < parts.size(); pi++) {
+            const PartRender& part = parts.render[pi];
+            if (part.mesh_id < 0) continue;
+            int lod = store->part_lod[pi];
+            if (lod == MESH_LOD_CULLED) continue;
+            const float* color = part.has_color ? part.color : nullptr;
+            mesh_queue(queue, store->meshes[part.mesh_id], sim_part_world_matrix(world, pi), color, lod);
+        }
+    }
 
-    for (uint32_t c = 0; c < scene->cylinder_count; c++) {
-        const SceneCylinder& cyl = scene->cylinders[c];
+    render_queue_submit(queue);
+}
 
-        // Check each submodel against this cylinder
-        for (int sm = 0; sm < robot->submodel_count; sm++) {
-            OBB world_obb;
-            transform_obb_to_world(&robot->submodel_obbs[sm], robot, &world_obb);
+// =============================================================================
+// Robot Cameras
+// Camera sensors of the robot configs render the scene into low-resolution
+// offscreen targets at a fixed rate. Readbacks are asynchronous
+// (render/offscreen.h): an image arrives a frame or two after it was drawn
+// and goes to the robot's Python bridge and/or a PPM file per image. In
+// headless runs (--cameras) the targets live on an offscreen context.
+// =============================================================================
 
-            if (obb_intersects_circle(&world_obb, cyl.x, cyl.z, cyl.radius)) {
-                // Submodel hits cylinder - mark as checking
-                if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
-                    robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
-                }
-                any_collision = true;
+#define CAMERA_DEFAULT_WIDTH 160
+#define CAMERA_DEFAULT_HEIGHT 120
+#define CAMERA_DEFAULT_RATE 15.0f     // Images per second
+#define CAMERA_NEAR 0.25f             // Inches
+
+// Command line options (--cameras, --camera-size, --camera-rate, --camera-out)
+struct CameraOptions {
+    bool headless;          // Render cameras in headless runs
+    int width, height;
+    float rate;             // Images per second (simulated time headless, else wall clock)
+    const char* out_dir;    // Write every image as a PPM file here (NULL = off)
+};
 
-                // Check parts in this submodel
-                int start = robot->submodel_part_start[sm];
-                int count = robot->submodel_part_count[sm];
+struct RobotCamera {
+    int robot;              // Index into world->robots
+    int sensor;             // Index into the robot's sensors
+    OffscreenTarget target;
+    uint32_t frame;         // Images rendered so far (tags the readbacks)
+};
 
-                for (int p = 0; p < count; p++) {
-                    size_t idx = robot->parts_start_index + start + p;
-                    if (idx >= parts.size()) continue;
-                    PartInstance& part = parts[idx];
-                    if (!part.mesh) continue;
+// Finished image on its way to a robot's bridge
+struct CameraImage {
+    int robot;
+    int port;
+    int width, height;
+    uint32_t frame;
+    std::vector<uint8_t> rgb;
+};
 
-                    OBB world_part;
-                    transform_obb_to_world(&part.local_obb, robot, &world_part);
+struct CameraRig {
+    CameraOptions options;
+    std::vector<RobotCamera> cameras;
+    std::vector<bool> has_bridge;   // Indexed like world->robots: images go to the robot's program
+    double next_time;           // Render the next images at or after this time
+    std::vector<uint8_t> pixels;
+
+    // Scene renderers shared with the window (or set up for headless runs)
+    MeshStore* meshes;
+    Floor* floor;
+    GameObjects* objects;
+    RenderQueue* queue;
+};
 
-                    if (obb_intersects_circle(&world_part, cyl.x, cyl.z, cyl.radius)) {
-                        part.collision_state = COLLISION_EXTERNAL;
-                    }
-                }
-            }
+// One target per camera sensor of every robot that runs a program (of every
+// robot with --camera-out); false if there are none
+static bool camera_rig_init(CameraRig* rig, const SimWorld* world, const std::vector<PythonBridge*>& bridges,
+                            const CameraOptions* options, MeshStore* meshes, Floor* floor, GameObjects* objects,
+                            RenderQueue* queue) {
+    rig->options = *options;
+    rig->cameras.clear();
+    rig->has_bridge.assign(world->robots.size(), false);
+    rig->next_time = 0.0;
+    rig->meshes = meshes;
+    rig->floor = floor;
+    rig->objects = objects;
+    rig->queue = queue;
+
+    for (size_t ri = 0; ri < world->robots.size(); ri++) {
+        const RobotInstance& robot = world->robots[ri];
+        rig->has_bridge[ri] = ri < bridges.size() && bridges[ri] != nullptr;
+        if (!rig->has_bridge[ri] && !options->out_dir) continue;
+        for (int k = 0; k < robot.sensor_count; k++) {
+            if (robot.sensors[k].type != SIM_SENSOR_CAMERA) continue;
+            RobotCamera camera;
+            camera.robot = (int)ri;
+            camera.sensor = k;
+            camera.frame = 0;
+            if (!offscreen_target_init(&camera.target, options->width, options->height)) continue;
+            rig->cameras.push_back(camera);
         }
     }
-
-    return any_collision;
+    if (rig->cameras.empty()) return false;
+
+    rig->pixels.resize((size_t)options->width * options->height * 3);
+    printf("[Camera] %zu robot cameras at %dx%d, %.0f Hz", rig->cameras.size(), options->width, options->height,
+           options->rate);
+    if (options->out_dir) printf(", images to %s", options->out_dir);
+    printf("\n");
+    if (options->width * options->height > BRIDGE_CAMERA_MAX_PIXELS) {
+        printf("[Camera] Images over %d pixels are not sent to robot programs\n", BRIDGE_CAMERA_MAX_PIXELS);
+    }
+    return true;
 }
 
-// Reset all collision states for all robots
-static void reset_collision_states(std::vector<RobotInstance>& robots, std::vector<PartInstance>& parts) {
-    for (auto& robot : robots) {
-        for (int sm = 0; sm < robot.submodel_count; sm++) {
-            robot.submodel_collision_state[sm] = COLLISION_NONE;
-        }
-    }
-    for (auto& part : parts) {
-        part.collision_state = COLLISION_NONE;
-    }
+static void camera_rig_destroy(CameraRig* rig) {
+    for (RobotCamera& camera : rig->cameras) offscreen_target_destroy(&camera.target);
+    rig->cameras.clear();
 }
 
-// Run full hierarchical collision detection
-static void run_hierarchical_collision_detection(
-    std::vector<RobotInstance>& robots,
-    std::vector<PartInstance>& parts,
-    const Scene* scene,
-    float field_half_width, float field_half_depth)
-{
-    // Reset all collision states
-    reset_collision_states(robots, parts);
-
-    // Check robot-robot collisions
-    for (size_t i = 0; i < robots.size(); i++) {
-        for (size_t j = i + 1; j < robots.size(); j++) {
-            check_robot_robot_collision(&robots[i], (int)i, &robots[j], (int)j, parts);
-        }
+// Render every camera whose target has a free readback slot, once per
+// 1 / rate seconds of time. Leaves the default framebuffer bound.
+static void camera_rig_render(CameraRig* rig, SimWorld* world, double time) {
+    if (rig->cameras.empty() || time < rig->next_time) return;
+    double interval = 1.0 / rig->options.rate;
+    rig->next_time += interval;
+    if (rig->next_time <= time) rig->next_time = time + interval;   // Fell behind: don't catch up
+
+    for (uint32_t i = 0; i < sim_world_cylinder_count(world); i++) {
+        const SceneCylinder* cyl = sim_world_get_cylinder(world, i);
+        objects_update_cylinder(rig->objects, i, cyl->x, cyl->z);
     }
 
-    // Check robot-wall and robot-cylinder collisions
-    for (size_t i = 0; i < robots.size(); i++) {
-        check_robot_wall_collision(&robots[i], (int)i, parts, field_half_width, field_half_depth);
-        check_robot_cylinder_collision(&robots[i], (int)i, parts, scene);
+    float aspect = (float)rig->options.width / (float)rig->options.height;
+    for (RobotCamera& camera : rig->cameras) {
+        if (!offscreen_target_ready(&camera.target)) continue;
+        RobotInstance* robot = &world->robots[camera.robot];
+        const SimSensor* sensor = &robot->sensors[camera.sensor];
+        sim_robot_update_joints(robot);
+        float eye[3], dir[3], up[3];
+        sim_robot_sensor_pose(robot, sensor, eye, dir, up);
+
+        Vec3 eye_pos = vec3(eye[0], eye[1], eye[2]);
+        Mat4 view = mat4_look_at(eye_pos, vec3(eye[0] + dir[0], eye[1] + dir[1], eye[2] + dir[2]),
+                                 vec3(up[0], up[1], up[2]));
+        Mat4 projection = mat4_perspective(sensor->fov, aspect, CAMERA_NEAR, sensor->range);
+
+        offscreen_target_begin(&camera.target, 0.15f, 0.15f, 0.18f);
+        Frustum frustum;
+        render_scene_view(rig->meshes, world, rig->floor, rig->objects, rig->queue, view, projection, eye_pos,
+                          (float)rig->options.height, &frustum);
+        offscreen_target_end(&camera.target, camera.frame++);
     }
 }
 
-// =============================================================================
-// Collision Response Functions (Hierarchical: submodel broad-phase, part narrow-phase)
-// =============================================================================
-
-// Collision dead zone - only correct if penetration exceeds this threshold
-// This breaks the feedback loop that causes jitter
-static const float COLLISION_TOLERANCE = 0.15f;  // 0.15 inches - acceptable penetration
-
-// Apply wall collision response using hierarchical detection
-// Broad phase: submodel OBBs, Narrow phase: part OBBs
-static void apply_wall_collision_response(
-    RobotInstance* robot,
-    std::vector<PartInstance>& parts,
-    float field_half_width, float field_half_depth)
-{
-    // Create wall AABBs
-    AABB walls[4];
-    walls[0].min = vec3(-field_half_width - 1.0f, 0.0f, -field_half_depth);  // Left
-    walls[0].max = vec3(-field_half_width, 10.0f, field_half_depth);
-    walls[1].min = vec3(field_half_width, 0.0f, -field_half_depth);          // Right
-    walls[1].max = vec3(field_half_width + 1.0f, 10.0f, field_half_depth);
-    walls[2].min = vec3(-field_half_width, 0.0f, -field_half_depth - 1.0f);  // Back
-    walls[2].max = vec3(field_half_width, 10.0f, -field_half_depth);
-    walls[3].min = vec3(-field_half_width, 0.0f, field_half_depth);          // Front
-    walls[3].max = vec3(field_half_width, 10.0f, field_half_depth + 1.0f);
-
-    float max_push_x = 0.0f, max_push_z = 0.0f;
-
-    // For each submodel (broad phase)
-    for (int sm = 0; sm < robot->submodel_count; sm++) {
-        OBB world_submodel_obb;
-        transform_obb_to_world(&robot->submodel_obbs[sm], robot, &world_submodel_obb);
-
-        for (int w = 0; w < 4; w++) {
-            // Broad phase: does submodel OBB hit this wall?
-            if (!obb_intersects_aabb(&world_submodel_obb, &walls[w])) continue;
-
-            // Mark submodel as colliding (for visualization)
-            if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
-                robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
-            }
-
-            // Narrow phase: check individual parts in this submodel
-            int start = robot->submodel_part_start[sm];
-            int count = robot->submodel_part_count[sm];
-
-            for (int p = 0; p < count; p++) {
-                size_t idx = robot->parts_start_index + start + p;
-                if (idx >= parts.size()) continue;
-                PartInstance& part = parts[idx];
-                if (!part.mesh) continue;
-
-                OBB world_part_obb;
-                transform_obb_to_world(&part.local_obb, robot, &world_part_obb);
-
-                if (!obb_intersects_aabb(&world_part_obb, &walls[w])) continue;
-
-                // Mark part as colliding (for visualization)
-                part.collision_state = COLLISION_EXTERNAL;
-
-                // Part actually hits wall - calculate penetration
-                AABB part_aabb;
-                obb_get_enclosing_aabb(&world_part_obb, &part_aabb);
-
-                float push_x = 0.0f, push_z = 0.0f;
-                float penetration = 0.0f;
-                if (w == 0 && part_aabb.min.x < -field_half_width) {  // Left
-                    penetration = -field_half_width - part_aabb.min.x;
-                    if (penetration > COLLISION_TOLERANCE) push_x = penetration - COLLISION_TOLERANCE;
-                } else if (w == 1 && part_aabb.max.x > field_half_width) {  // Right
-                    penetration = part_aabb.max.x - field_half_width;
-                    if (penetration > COLLISION_TOLERANCE) push_x = -(penetration - COLLISION_TOLERANCE);
-                } else if (w == 2 && part_aabb.min.z < -field_half_depth) {  // Back
-                    penetration = -field_half_depth - part_aabb.min.z;
-                    if (penetration > COLLISION_TOLERANCE) push_z = penetration - COLLISION_TOLERANCE;
-                } else if (w == 3 && part_aabb.max.z > field_half_depth) {  // Front
-                    penetration = part_aabb.max.z - field_half_depth;
-                    if (penetration > COLLISION_TOLERANCE) push_z = -(penetration - COLLISION_TOLERANCE);
-                }
-
-                // Track maximum penetration
-                if (fabsf(push_x) > fabsf(max_push_x)) max_push_x = push_x;
-                if (fabsf(push_z) > fabsf(max_push_z)) max_push_z = push_z;
-            }
-        }
-    }
-
-    // Apply the maximum push needed (position correction only)
-    if (max_push_x != 0.0f || max_push_z != 0.0f) {
-        robot->drivetrain.pos_x += max_push_x;
-        robot->drivetrain.pos_z += max_push_z;
-        robot->offset[0] = robot->drivetrain.pos_x;
-        robot->offset[2] = robot->drivetrain.pos_z;
+// Binary PPM of one image
+static void write_camera_image(const char* dir, int robot, int port, uint32_t frame, int width, int height,
+                               const uint8_t* rgb) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s" PATH_SEP "robot%d_port%d_%06u.ppm", dir, robot, port, frame);
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "[Camera] Can't write %s\n", path);
+        return;
     }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    fwrite(rgb, 1, (size_t)width * height * 3, file);
+    fclose(file);
 }
 
-// Apply robot-robot collision response using hierarchical detection
-static void apply_robot_collision_response(
-    RobotInstance* robot_a,
-    RobotInstance* robot_b,
-    std::vector<PartInstance>& parts)
-{
-    (void)parts;  // No longer used - submodel-level collision only for performance
-
-    float total_push_x = 0.0f, total_push_z = 0.0f;
-    int collision_count = 0;
-
-    // Submodel-level collision only (no part drilling for performance)
-    // This is O(s1 * s2) instead of O(s1 * s2 * p1 * p2) when parts are checked
-    for (int sm_a = 0; sm_a < robot_a->submodel_count; sm_a++) {
-        OBB world_sm_a;
-        transform_obb_to_world(&robot_a->submodel_obbs[sm_a], robot_a, &world_sm_a);
-
-        for (int sm_b = 0; sm_b < robot_b->submodel_count; sm_b++) {
-            OBB world_sm_b;
-            transform_obb_to_world(&robot_b->submodel_obbs[sm_b], robot_b, &world_sm_b);
-
-            // Do submodel OBBs intersect?
-            if (!obb_intersects_obb(&world_sm_a, &world_sm_b)) continue;
-
-            // Mark submodels as colliding (for visualization)
-            robot_a->submodel_collision_state[sm_a] = COLLISION_SUBMODEL;
-            robot_b->submodel_collision_state[sm_b] = COLLISION_SUBMODEL;
-
-            // Use submodel AABBs for collision response (fast approximation)
-            AABB aabb_a, aabb_b;
-            obb_get_enclosing_aabb(&world_sm_a, &aabb_a);
-            obb_get_enclosing_aabb(&world_sm_b, &aabb_b);
-
-            // Calculate overlap
-            float overlap_x = fminf(aabb_a.max.x, aabb_b.max.x) - fmaxf(aabb_a.min.x, aabb_b.min.x);
-            float overlap_z = fminf(aabb_a.max.z, aabb_b.max.z) - fmaxf(aabb_a.min.z, aabb_b.min.z);
-
-            if (overlap_x > 0 && overlap_z > 0) {
-                // Push along axis of minimum penetration
-                float center_a_x = (aabb_a.min.x + aabb_a.max.x) * 0.5f;
-                float center_a_z = (aabb_a.min.z + aabb_a.max.z) * 0.5f;
-                float center_b_x = (aabb_b.min.x + aabb_b.max.x) * 0.5f;
-                float center_b_z = (aabb_b.min.z + aabb_b.max.z) * 0.5f;
-
-                float penetration = fminf(overlap_x, overlap_z);
-                // Only correct if penetration exceeds tolerance
-                if (penetration > COLLISION_TOLERANCE) {
-                    float push = penetration - COLLISION_TOLERANCE;
-                    if (overlap_x < overlap_z) {
-                        total_push_x += (center_a_x < center_b_x) ? -push : push;
-                    } else {
-                        total_push_z += (center_a_z < center_b_z) ? -push : push;
-                    }
-                    collision_count++;
-                }
+// Take every finished readback: write it to the file sink and, for robots
+// with a bridge, append it to images
+static void camera_rig_collect(CameraRig* rig, const SimWorld* world, std::vector<CameraImage>* images) {
+    const CameraOptions& options = rig->options;
+    for (RobotCamera& camera : rig->cameras) {
+        uint64_t frame;
+        while (offscreen_target_take(&camera.target, rig->pixels.data(), &frame)) {
+            int port = world->robots[camera.robot].sensors[camera.sensor].port;
+            if (options.out_dir) {
+                write_camera_image(options.out_dir, camera.robot, port, (uint32_t)frame, options.width,
+                                   options.height, rig->pixels.data());
+            }
+            if (rig->has_bridge[camera.robot]) {
+                images->push_back(CameraImage{camera.robot, port, options.width, options.height, (uint32_t)frame,
+                                              rig->pixels});
             }
         }
     }
+}
 
-    // Apply averaged push (split between both robots) - position correction only
-    if (collision_count > 0) {
-        float push_x = (total_push_x / collision_count) * 0.5f;
-        float push_z = (total_push_z / collision_count) * 0.5f;
-
-        robot_a->drivetrain.pos_x += push_x;
-        robot_a->drivetrain.pos_z += push_z;
-        robot_a->offset[0] = robot_a->drivetrain.pos_x;
-        robot_a->offset[2] = robot_a->drivetrain.pos_z;
-
-        robot_b->drivetrain.pos_x -= push_x;
-        robot_b->drivetrain.pos_z -= push_z;
-        robot_b->offset[0] = robot_b->drivetrain.pos_x;
-        robot_b->offset[2] = robot_b->drivetrain.pos_z;
+// Hand images to their robots' bridges (call from the thread that ticks them)
+static void send_camera_images(std::vector<PythonBridge*>& bridges, const std::vector<CameraImage>& images) {
+    for (const CameraImage& image : images) {
+        PythonBridge* bridge = (size_t)image.robot < bridges.size() ? bridges[image.robot] : nullptr;
+        if (bridge) python_bridge_send_camera(bridge, image.port, image.width, image.height, image.frame,
+                                              image.rgb.data());
     }
 }
 
-// Apply cylinder collision response using hierarchical detection
-// Cylinders are light movable objects that get pushed by the robot
-static void apply_cylinder_collision_response(
-    RobotInstance* robot,
-    std::vector<PartInstance>& parts,
-    Scene* scene)  // Non-const to modify cylinder positions
-{
-    for (uint32_t c = 0; c < scene->cylinder_count; c++) {
-        SceneCylinder& cyl = scene->cylinders[c];
-
-        float max_penetration = 0.0f;
-        float contact_nx = 0.0f, contact_nz = 0.0f;
-        bool any_contact = false;
-
-        // For each submodel (broad phase)
-        for (int sm = 0; sm < robot->submodel_count; sm++) {
-            OBB world_sm;
-            transform_obb_to_world(&robot->submodel_obbs[sm], robot, &world_sm);
-
-            // Broad phase: does submodel OBB hit cylinder?
-            if (!obb_intersects_circle(&world_sm, cyl.x, cyl.z, cyl.radius)) continue;
+// =============================================================================
+// Python Bridges (shared by the windowed loop and headless mode)
+// =============================================================================
 
-            // Mark submodel as colliding (for visualization)
-            if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
-                robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
+// Service Python bridges: send gamepad to the active robot, tick all bridges
+// with their robot's sensor readings, and apply reported motor states to
+// each drivetrain.
+// bridges is indexed like world->robots (NULL = no program).
+// active_robot_index is a scene robot index (-1 = none).
+// gamepad may be NULL (headless mode) - no controller input is sent then.
+// Lockstep bridges are all ticked first, then waited on together.
+// reactor (may be NULL) reads all attached bridges' output in one poll.
+static void update_robot_bridges(SimWorld* world, std::vector<PythonBridge*>& bridges,
+                                 IoReactor* reactor, int active_robot_index, Gamepad* gamepad,
+                                 float dt, bool debug_print) {
+    PROFILE_ZONE("ipc");
+    bool lockstep = false;
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        const RobotInstance& robot = world->robots[i];
+        PythonBridge* bridge = bridges[i];
+        if (!bridge) continue;
+
+        // Send gamepad only to active robot
+        if (gamepad && robot.scene_index == active_robot_index) {
+            python_bridge_send_gamepad(bridge, gamepad);
+            if (debug_print) {
+                printf("[DEBUG] Sent gamepad to robot %zu: A=%d B=%d\n",
+                       i, gamepad->axes.a, gamepad->axes.b);
             }
+        }
 
-            // Narrow phase: check individual parts
-            int start = robot->submodel_part_start[sm];
-            int count = robot->submodel_part_count[sm];
-
-            for (int p = 0; p < count; p++) {
-                size_t idx = robot->parts_start_index + start + p;
-                if (idx >= parts.size()) continue;
-                PartInstance& part = parts[idx];
-                if (!part.mesh) continue;
+        // Send tick (with the last step's sensor readings) to all robots with bridges
+        // (cameras send images of their own, see send_camera_images)
+        SensorReading readings[MAX_SENSORS];
+        int reading_count = 0;
+        for (int k = 0; k < robot.sensor_count && reading_count < MAX_SENSORS; k++) {
+            const SimSensor& sensor = robot.sensors[k];
+            if (sensor.type == SIM_SENSOR_CAMERA) continue;
+            SensorReading* reading = &readings[reading_count++];
+            reading->port = sensor.port;
+            reading->object = sensor.reading.object;
+            reading->distance_mm = sensor.reading.object != SIM_RAY_NONE ? sensor.reading.distance * 25.4f : -1.0f;
+            sim_world_ray_hit_color(world, &sensor.reading, reading->rgb);
+        }
+        python_bridge_set_sensors(bridge, readings, reading_count);
+        python_bridge_send_tick(bridge, dt);
+        lockstep |= bridge->lockstep;
+    }
 
-                OBB world_part;
-                transform_obb_to_world(&part.local_obb, robot, &world_part);
+    if (lockstep) {
+        python_bridge_wait_ticks(bridges.data(), (int)bridges.size(), PYTHON_BRIDGE_TICK_TIMEOUT_MS);
+    }
 
-                if (!obb_intersects_circle(&world_part, cyl.x, cyl.z, cyl.radius)) continue;
+    // Read whatever arrived on all attached pipes at once
+    if (reactor) python_bridge_poll(reactor, 0);
 
-                // Mark part as colliding (for visualization)
-                part.collision_state = COLLISION_EXTERNAL;
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        const RobotInstance& robot = world->robots[i];
+        PythonBridge* bridge = bridges[i];
 
-                // Part hits cylinder - calculate penetration
-                AABB part_aabb;
-                obb_get_enclosing_aabb(&world_part, &part_aabb);
+        if (debug_print && i == 0) {
+            printf("[DEBUG] Robot %zu: bridge=%p, config: left_port=%d, right_port=%d\n",
+                   i, (void*)bridge,
+                   robot.motor_config.left_motor_port,
+                   robot.motor_config.right_motor_port);
+        }
 
-                float part_cx = (part_aabb.min.x + part_aabb.max.x) * 0.5f;
-                float part_cz = (part_aabb.min.z + part_aabb.max.z) * 0.5f;
-                float part_rx = (part_aabb.max.x - part_aabb.min.x) * 0.5f;
-                float part_rz = (part_aabb.max.z - part_aabb.min.z) * 0.5f;
-                float part_radius = sqrtf(part_rx * part_rx + part_rz * part_rz) * 0.5f;
+        if (!bridge) continue;
 
-                float dx = part_cx - cyl.x;
-                float dz = part_cz - cyl.z;
-                float dist = sqrtf(dx * dx + dz * dz);
+        // Update bridge (read incoming messages; attached bridges only drain the reactor's buffer)
+        python_bridge_update(bridge);
 
-                float combined_radius = cyl.radius + part_radius;
-                if (dist < combined_radius && dist > 0.001f) {
-                    float penetration = combined_radius - dist;
+        if (debug_print) {
+            printf("[DEBUG] Robot %zu bridge: connected=%d, ready=%d\n",
+                   i, bridge->connected, bridge->robot_ready);
+        }
 
-                    // Track contact direction (from cylinder toward robot)
-                    if (!any_contact || penetration > max_penetration) {
-                        contact_nx = dx / dist;  // Points from cylinder to robot
-                        contact_nz = dz / dist;
-                    }
-                    any_contact = true;
+        // Apply motor states to drivetrain
+        if (python_bridge_is_ready(bridge)) {
+            RobotState* state = python_bridge_get_state(bridge);
+            float left_pct = 0.0f;
+            float right_pct = 0.0f;
+            float strafe_pct = 0.0f;
 
-                    // Track max penetration
-                    if (penetration > max_penetration) {
-                        max_penetration = penetration;
-                    }
+            if (debug_print) {
+                printf("[DEBUG] Robot %zu: motor_count=%d\n", i, state->motor_count);
+                for (int m = 0; m < state->motor_count; m++) {
+                    printf("[DEBUG]   Motor port=%d speed=%d spinning=%d\n",
+                           state->motors[m].port, state->motors[m].speed,
+                           state->motors[m].spinning);
                 }
             }
-        }
 
-        // If contact, transfer momentum to cylinder (push it away)
-        if (any_contact && max_penetration > 0.01f) {
-            // Get robot velocity toward cylinder
-            float robot_vel_into = robot->drivetrain.vel_x * (-contact_nx) + robot->drivetrain.vel_z * (-contact_nz);
+            // Find motors matching our config ports
+            for (int m = 0; m < state->motor_count; m++) {
+                MotorState* motor = &state->motors[m];
+                if (motor->port == robot.motor_config.left_motor_port) {
+                    left_pct = (float)motor->speed;
+                }
+                if (motor->port == robot.motor_config.right_motor_port) {
+                    right_pct = (float)motor->speed;
+                }
+                if (motor->port == robot.motor_config.strafe_motor_port) {
+                    strafe_pct = (float)motor->speed;
+                }
+            }
 
-            // Transfer velocity to cylinder (push it away)
-            if (robot_vel_into > 0) {
-                // Match cylinder velocity to robot's (smooth push, no bounce)
-                cyl.vel_x = -contact_nx * robot_vel_into * 0.8f;
-                cyl.vel_z = -contact_nz * robot_vel_into * 0.8f;
+            // Motors assigned to a submodel joint in the robotdef set its
+            // angle from their position (direct drive, no gear ratio)
+            for (int k = 0; k < robot.joint_order_count; k++) {
+                int sm = robot.joint_order[k];
+                int port = robot.submodel_joints[sm].motor_port;
+                if (port == 0) continue;
+                for (int m = 0; m < state->motor_count; m++) {
+                    if (state->motors[m].port != port) continue;
+                    sim_world_set_joint_angle(world, (int)i, sm, state->motors[m].position * DEG_TO_RAD_CONST);
+                    break;
+                }
             }
 
-            // Position correction with tolerance
-            if (max_penetration > COLLISION_TOLERANCE) {
-                float correction = max_penetration - COLLISION_TOLERANCE;
-                cyl.x -= contact_nx * correction;
-                cyl.z -= contact_nz * correction;
+            if (debug_print) {
+                printf("[DEBUG] Robot %zu: left_pct=%.1f right_pct=%.1f strafe_pct=%.1f\n",
+                       i, left_pct, right_pct, strafe_pct);
             }
+
+            sim_world_set_motors(world, (int)i, left_pct, right_pct);
+            sim_world_set_strafe(world, (int)i, strafe_pct);
+        } else if (debug_print) {
+            printf("[DEBUG] Robot %zu: bridge not ready\n", i);
         }
     }
 }
 
-// Update cylinder physics (friction, position integration, cylinder-cylinder collision)
-static void update_cylinder_physics(Scene* scene, float dt_sec, float field_half_width, float field_half_depth) {
-    const float CYLINDER_FRICTION = 0.85f;  // Friction damping per frame
-    const float WALL_BOUNCE = 0.0f;         // No bounce off walls (soft stop)
-    const float CYLINDER_TOLERANCE = 0.1f;  // Allow slight overlap before correcting
-
-    // Cylinder-cylinder collision
-    for (uint32_t i = 0; i < scene->cylinder_count; i++) {
-        for (uint32_t j = i + 1; j < scene->cylinder_count; j++) {
-            SceneCylinder& a = scene->cylinders[i];
-            SceneCylinder& b = scene->cylinders[j];
-
-            float dx = b.x - a.x;
-            float dz = b.z - a.z;
-            float dist = sqrtf(dx * dx + dz * dz);
-            float min_dist = a.radius + b.radius;
-
-            if (dist < min_dist && dist > 0.001f) {
-                float overlap = min_dist - dist;
-                float nx = dx / dist;
-                float nz = dz / dist;
-                float total_mass = a.mass + b.mass;
-                float a_ratio = b.mass / total_mass;
-                float b_ratio = a.mass / total_mass;
-
-                // Always cancel approaching velocity immediately (prevents bounce buildup)
-                float rel_vel = (b.vel_x - a.vel_x) * nx + (b.vel_z - a.vel_z) * nz;
-                if (rel_vel < 0) {
-                    // Cancel relative velocity completely - no bounce
-                    a.vel_x += rel_vel * nx * a_ratio;
-                    a.vel_z += rel_vel * nz * a_ratio;
-                    b.vel_x -= rel_vel * nx * b_ratio;
-                    b.vel_z -= rel_vel * nz * b_ratio;
-                }
-
-                // Position correction only if exceeds tolerance
-                if (overlap > CYLINDER_TOLERANCE) {
-                    float correction = overlap - CYLINDER_TOLERANCE;
-                    a.x -= nx * correction * a_ratio;
-                    a.z -= nz * correction * a_ratio;
-                    b.x += nx * correction * b_ratio;
-                    b.z += nz * correction * b_ratio;
-                }
-            }
+static_assert(MAX_MOTORS <= REPLAY_MAX_MOTORS && MAX_PNEUMATICS <= REPLAY_MAX_PNEUMATICS,
+              "replays must hold every motor and pneumatic");
+
+// Record and/or stream the world's current state and each robot's latest
+// motor/pneumatic state as the next replay frame (actuators: scratch, one per
+// robot). recorder and stream may be NULL.
+static void record_replay_frame(ReplayWriter* recorder, NetStreamServer* stream, const SimWorld* world,
+                                const std::vector<PythonBridge*>& bridges, std::vector<ReplayActuators>& actuators,
+                                int active_robot_index) {
+    if (!recorder && !stream) return;
+    actuators.assign(world->robots.size(), ReplayActuators{});
+    for (size_t i = 0; i < world->robots.size() && i < bridges.size(); i++) {
+        if (!bridges[i]) continue;
+        const RobotState* state = python_bridge_get_state(bridges[i]);
+        ReplayActuators& out = actuators[i];
+        out.motor_count = state->motor_count;
+        for (int m = 0; m < state->motor_count && m < MAX_MOTORS; m++) {
+            const MotorState& motor = state->motors[m];
+            out.motors[m] = { motor.port, motor.speed, motor.spinning, motor.position };
+        }
+        out.pneumatic_count = state->pneumatic_count;
+        for (int p = 0; p < state->pneumatic_count && p < MAX_PNEUMATICS; p++) {
+            const PneumaticState& pneumatic = state->pneumatics[p];
+            out.pneumatics[p] = { pneumatic.port, pneumatic.extended, pneumatic.pump_on };
         }
     }
+    if (recorder) replay_writer_frame(recorder, world, actuators.data());
+    if (stream) net_stream_server_step(stream, world, actuators.data(), active_robot_index);
+}
 
-    // Apply friction and integrate position
-    for (uint32_t c = 0; c < scene->cylinder_count; c++) {
-        SceneCylinder& cyl = scene->cylinders[c];
-
-        // Apply friction (damping)
-        cyl.vel_x *= CYLINDER_FRICTION;
-        cyl.vel_z *= CYLINDER_FRICTION;
+// How robot programs are started (pool and reactor may be NULL)
+struct BridgeLaunch {
+    PythonPool* pool;
+    IoReactor* reactor;
+    const char* simulator_dir;
+    bool lockstep;
+};
 
-        // Stop if very slow
-        if (fabsf(cyl.vel_x) < 0.1f) cyl.vel_x = 0.0f;
-        if (fabsf(cyl.vel_z) < 0.1f) cyl.vel_z = 0.0f;
+// Start a Python bridge for a scene robot's iqpython program (NULL if it has
+// none or it fails to start). Without a free pooled worker a process is spawned.
+static PythonBridge* start_robot_bridge(const BridgeLaunch* launch, const SceneRobot* scene_robot) {
+    if (!scene_robot->has_program || scene_robot->iqpython_file[0] == '\0') return nullptr;
+
+    // iqpython files are in <project>/iqpython/, not models/robots/
+    char iqpython_path[1024];
+    char exe_dir_buf[512];
+    get_exe_dir(exe_dir_buf, sizeof(exe_dir_buf));
+    snprintf(iqpython_path, sizeof(iqpython_path), "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "iqpython" PATH_SEP "%s",
+             exe_dir_buf, scene_robot->iqpython_file);
+
+    PythonBridge* bridge = new PythonBridge();
+    bool started = launch->pool && python_bridge_init_pooled(bridge, launch->pool, iqpython_path, launch->lockstep);
+    if (!started) started = python_bridge_init(bridge, iqpython_path, launch->simulator_dir, launch->lockstep);
+    if (!started) {
+        fprintf(stderr, "  Failed to start Python bridge for: %s\n", scene_robot->iqpython_file);
+        delete bridge;
+        return nullptr;
+    }
+    printf("  Started Python bridge for: %s\n", scene_robot->iqpython_file);
+    if (launch->reactor) python_bridge_attach(bridge, launch->reactor);
+    return bridge;
+}
 
-        // Integrate position
-        cyl.x += cyl.vel_x * dt_sec;
-        cyl.z += cyl.vel_z * dt_sec;
+// Hand the bridges to the robots of an edited scene (world already holds
+// them). Robots are matched by scene index: one whose program didn't change
+// keeps its bridge, the others get a new one (or none). Bridges no robot
+// keeps shut down first, so their pooled workers can serve the new programs.
+// old_scene_indices: scene index of each bridge's robot.
+static void update_scene_bridges(std::vector<PythonBridge*>& bridges, const std::vector<int>& old_scene_indices,
+                                 const SimWorld* world, const SceneDiff* diff, const BridgeLaunch* launch) {
+    size_t scene_robots = world->scene.robot_count;
+    for (int index : old_scene_indices) scene_robots = std::max(scene_robots, (size_t)index + 1);
+    std::vector<PythonBridge*> by_scene_index(scene_robots, nullptr);
+    for (size_t i = 0; i < bridges.size() && i < old_scene_indices.size(); i++) {
+        by_scene_index[old_scene_indices[i]] = bridges[i];
+    }
+    std::vector<bool> kept(scene_robots, false);
+    for (const RobotInstance& robot : world->robots) {
+        kept[robot.scene_index] = !diff->program_changed[robot.scene_index];
+    }
+    for (size_t si = 0; si < scene_robots; si++) {
+        if (!by_scene_index[si] || kept[si]) continue;
+        python_bridge_destroy(by_scene_index[si]);
+        delete by_scene_index[si];
+        by_scene_index[si] = nullptr;
+    }
 
-        // Cylinder-wall collision with bounce
-        float bound_x = field_half_width - cyl.radius;
-        float bound_z = field_half_depth - cyl.radius;
+    bridges.assign(world->robots.size(), nullptr);
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        int scene_index = world->robots[i].scene_index;
+        bridges[i] = kept[scene_index] ? by_scene_index[scene_index]
+                                       : start_robot_bridge(launch, &world->scene.robots[scene_index]);
+    }
+}
 
-        if (cyl.x < -bound_x) {
-            cyl.x = -bound_x;
-            cyl.vel_x = -cyl.vel_x * WALL_BOUNCE;
-        } else if (cyl.x > bound_x) {
-            cyl.x = bound_x;
-            cyl.vel_x = -cyl.vel_x * WALL_BOUNCE;
+// Shut down and free all Python bridges, then their reactor and worker pool (may be NULL)
+static void destroy_bridges(std::vector<PythonBridge*>& bridges, IoReactor* reactor, PythonPool* pool) {
+    for (PythonBridge*& bridge : bridges) {
+        if (bridge) {
+            python_bridge_destroy(bridge);
+            delete bridge;
+            bridge = nullptr;
         }
+    }
+    if (reactor) io_reactor_destroy(reactor);
+    if (pool) {
+        python_pool_destroy(pool);
+        delete pool;
+    }
+}
 
-        if (cyl.z < -bound_z) {
-            cyl.z = -bound_z;
-            cyl.vel_z = -cyl.vel_z * WALL_BOUNCE;
-        } else if (cyl.z > bound_z) {
-            cyl.z = bound_z;
-            cyl.vel_z = -cyl.vel_z * WALL_BOUNCE;
-        }
+// --gpu-pieces field: steps per frame before the field drops behind, and
+// the piece size and color when the scene has no cylinder to copy
+#define GPU_FIELD_MAX_STEPS_PER_FRAME 8
+#define GPU_FIELD_DEFAULT_RADIUS 1.5f
+#define GPU_FIELD_DEFAULT_HEIGHT 3.0f
+
+// Step the GPU game-piece field at the physics rate, then let world's robots
+// push the pieces around them: only those are read back, resolved against the
+// robot parts on the CPU and written back. Robots don't feel the pieces.
+// lag: seconds of field time owed (carried between frames)
+static void update_gpu_field(GpuField* field, SimWorld* world, float step_dt, float frame_dt, float* lag) {
+    PROFILE_ZONE("gpu field");
+    *lag += frame_dt;
+    int steps = 0;
+    while (*lag >= step_dt && steps < GPU_FIELD_MAX_STEPS_PER_FRAME) {
+        gpu_field_step(field, step_dt);
+        *lag -= step_dt;
+        steps++;
+    }
+    if (*lag >= step_dt) *lag = 0.0f;   // Too far behind: slow down instead of catching up
+
+    float footprints[GPU_FIELD_MAX_ROBOTS][4];
+    int footprint_count = 0;
+    for (int i = 0; i < sim_world_robot_count(world) && footprint_count < GPU_FIELD_MAX_ROBOTS; i++) {
+        AABB bounds;
+        if (!sim_world_robot_footprint(world, i, &bounds)) continue;
+        footprints[footprint_count][0] = bounds.min.x;
+        footprints[footprint_count][1] = bounds.min.z;
+        footprints[footprint_count][2] = bounds.max.x;
+        footprints[footprint_count][3] = bounds.max.z;
+        footprint_count++;
+    }
+
+    uint32_t near = gpu_field_select(field, footprints, footprint_count);
+    uint32_t pushed = 0;
+    for (uint32_t k = 0; k < near; k++) {
+        GpuFieldContact contact = field->contacts[k];
+        SceneCylinder cyl;
+        memset(&cyl, 0, sizeof(cyl));
+        cyl.x = contact.piece.x;
+        cyl.z = contact.piece.z;
+        cyl.vel_x = contact.piece.vel_x;
+        cyl.vel_z = contact.piece.vel_z;
+        cyl.radius = field->radius;
+        cyl.height = field->height;
+        if (!sim_world_push_cylinder(world, &cyl)) continue;
+        contact.piece.x = cyl.x;
+        contact.piece.z = cyl.z;
+        contact.piece.vel_x = cyl.vel_x;
+        contact.piece.vel_z = cyl.vel_z;
+        field->contacts[pushed++] = contact;
     }
+    gpu_field_write(field, field->contacts, pushed);
 }
 
-// Run all collision responses (hierarchical: submodel broad-phase, part narrow-phase)
-// Uses sub-stepping to resolve collisions iteratively and prevent jitter
-static void run_collision_response(
-    std::vector<RobotInstance>& robots,
-    std::vector<PartInstance>& parts,
-    Scene* scene,  // Non-const to allow cylinder movement
-    float field_half_width, float field_half_depth)
-{
-    // Sub-stepping: run collision response multiple times to converge to stable state
-    const int MAX_ITERATIONS = 4;
-
-    for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
-        // Robot-robot collision response
-        for (size_t i = 0; i < robots.size(); i++) {
-            for (size_t j = i + 1; j < robots.size(); j++) {
-                apply_robot_collision_response(&robots[i], &robots[j], parts);
-            }
+// Seconds of world snapshots kept for rewinding (R key)
+#define REWIND_HISTORY_SECONDS 10.0f
+#define REWIND_STEP_SECONDS 5.0
+
+#define VIEW_JOIN_TIMEOUT 10.0          // Seconds to wait for the --serve simulator to answer
+
+// Input the render thread hands to the simulation thread's bridges
+struct SimControl {
+    std::mutex lock;
+    Gamepad gamepad;            // Latest polled state (guarded by lock)
+    int active_robot_index;     // Guarded by lock
+    double rewind_seconds;      // Pending rewind (guarded by lock, 0 = none)
+    std::vector<CameraImage> camera_images;   // Rendered, not yet sent (guarded by lock)
+    SimSnapshotRing history;    // World before each step (sim thread only)
+    std::vector<PythonBridge*>* bridges;
+    IoReactor* reactor;
+    ReplayWriter* recorder;     // --record (NULL = off)
+    NetStreamServer* stream;    // --serve (NULL = off)
+    NetStreamStats stream_stats;   // Copy for the HUD (guarded by lock)
+    std::vector<ReplayActuators> actuators;   // Recorder scratch
+    uint64_t step_count;
+    uint64_t debug_interval;    // Steps between debug prints (once per second)
+};
+
+// SimThreadControlFn: tick the robot programs before every fixed step
+static void sim_control_step(void* user_data, SimWorld* world, float dt) {
+    SimControl* control = (SimControl*)user_data;
+    Gamepad gamepad;
+    int active_robot_index;
+    double rewind_seconds;
+    std::vector<CameraImage> camera_images;
+    {
+        std::lock_guard<std::mutex> guard(control->lock);
+        gamepad = control->gamepad;
+        active_robot_index = control->active_robot_index;
+        rewind_seconds = control->rewind_seconds;
+        control->rewind_seconds = 0.0;
+        camera_images.swap(control->camera_images);
+    }
+
+    // Branch from an earlier world state. Robot programs can't be rewound,
+    // so they keep running and their ticks keep counting forward.
+    if (rewind_seconds > 0.0) {
+        int age = sim_snapshot_ring_find(&control->history, world->time - rewind_seconds);
+        const SimSnapshotHeader* snapshot = sim_snapshot_ring_get(&control->history, age);
+        uint64_t tick = snapshot ? snapshot->tag : 0;
+        if (sim_snapshot_ring_rewind(&control->history, age, world)) {
+            printf("[Main] Rewound to t=%.2f s (tick %llu)\n", world->time, (unsigned long long)tick);
         }
+    }
 
-        // Robot-wall collision response
-        for (auto& robot : robots) {
-            apply_wall_collision_response(&robot, parts, field_half_width, field_half_depth);
+    // Tag snapshots with the programs' tick (every bridge gets one per step)
+    uint64_t tick = 0;
+    for (PythonBridge* bridge : *control->bridges) {
+        if (bridge) {
+            tick = bridge->tick_seq;
+            break;
         }
+    }
+    sim_snapshot_ring_push(&control->history, world, tick);
+
+    // Images go out on this thread so they never interleave with a tick
+    send_camera_images(*control->bridges, camera_images);
+
+    bool debug_print = ++control->step_count % control->debug_interval == 0;
+    update_robot_bridges(world, *control->bridges, control->reactor, active_robot_index, &gamepad, dt, debug_print);
+    record_replay_frame(control->recorder, control->stream, world, *control->bridges, control->actuators,
+                        active_robot_index);
+    if (control->stream) {
+        std::lock_guard<std::mutex> guard(control->lock);
+        control->stream_stats = *net_stream_server_stats(control->stream);
+    }
+}
+
+// =============================================================================
+// Headless Mode
+// =============================================================================
+
+// Command line options for batch runs (--headless, --duration, --dt)
+struct HeadlessOptions {
+    bool enabled;
+    double duration;   // Simulated seconds to run
+    float dt;          // Fixed physics step in seconds
+};
 
-        // Robot-cylinder collision response
-        for (auto& robot : robots) {
-            apply_cylinder_collision_response(&robot, parts, scene);
+#define HEADLESS_DEFAULT_DURATION 120.0   // One full match
+#define HEADLESS_DEFAULT_DT (1.0f / 60.0f)
+
+// Run the simulation at a fixed step as fast as possible (no window; no GL
+// unless cameras is set), recording every step if recorder is set.
+// Cameras render on simulated time after each step.
+// Prints a summary with final robot and cylinder poses when done.
+static int run_headless(const HeadlessOptions* opts, SimWorld* world,
+                        std::vector<PythonBridge*>& bridges, IoReactor* reactor, ReplayWriter* recorder,
+                        CameraRig* cameras) {
+    uint64_t step_count = (uint64_t)ceil(opts->duration / opts->dt);
+    printf("\n[Headless] Running %.2f s at dt=%.5f s (%llu steps)\n",
+           opts->duration, opts->dt, (unsigned long long)step_count);
+
+    auto wall_start = std::chrono::steady_clock::now();
+    ProfilerWindow profile;
+    profiler_window(&profile);   // Start the window at the first step
+
+    // Step counter totals
+    uint64_t pairs = 0, builds = 0, submodel_tests = 0, submodel_hits = 0, part_tests = 0;
+    uint64_t corrections = 0, iterations = 0, cylinders_moved = 0, bodies_asleep = 0;
+    uint32_t peak_part_tests = 0;
+    std::vector<ReplayActuators> actuators;
+    std::vector<CameraImage> camera_images;
+
+    for (uint64_t step = 0; step < step_count; step++) {
+        update_robot_bridges(world, bridges, reactor, -1, nullptr, opts->dt, false);
+        record_replay_frame(recorder, nullptr, world, bridges, actuators, -1);
+        sim_world_step(world, opts->dt);
+
+        if (cameras) {
+            PROFILE_BEGIN(camera, "cameras");
+            camera_rig_render(cameras, world, world->time);
+            camera_images.clear();
+            camera_rig_collect(cameras, world, &camera_images);
+            send_camera_images(bridges, camera_images);
+            PROFILE_END(camera);
         }
+
+        const SimStepStats* stats = &world->stats;
+        pairs += stats->broadphase_pairs;
+        builds += stats->broadphase_builds;
+        submodel_tests += stats->submodel_tests;
+        submodel_hits += stats->submodel_hits;
+        part_tests += stats->part_tests;
+        corrections += stats->corrections;
+        iterations += stats->response_iterations;
+        cylinders_moved += stats->cylinders_moved;
+        bodies_asleep += stats->robots_asleep + stats->cylinders_asleep;
+        if (stats->part_tests > peak_part_tests) peak_part_tests = stats->part_tests;
+    }
+
+    double wall_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    double sim_sec = (double)step_count * opts->dt;
+
+    printf("[Headless] Done: %.2f s simulated in %.3f s wall (%.1fx realtime, %.1f us/step)\n",
+           sim_sec, wall_sec, wall_sec > 0.0 ? sim_sec / wall_sec : 0.0,
+           step_count > 0 ? wall_sec * 1e6 / (double)step_count : 0.0);
+
+    // Physics work per step
+    double steps = step_count > 0 ? (double)step_count : 1.0;
+    printf("[Headless] Per step: %.1f broad-phase pairs (%.2f rebuilds), %.1f/%.1f submodel hits/tests, "
+           "%.1f part tests (peak %u)\n",
+           pairs / steps, builds / steps, submodel_hits / steps, submodel_tests / steps, part_tests / steps, peak_part_tests);
+    printf("[Headless] Per step: %.2f/%d response iterations, %.2f corrections, %.2f cylinders moved, "
+           "%.2f bodies asleep\n",
+           iterations / steps, SIM_RESPONSE_ITERATIONS, corrections / steps, cylinders_moved / steps,
+           bodies_asleep / steps);
+
+    // Per-phase breakdown (profiling builds)
+    profiler_window(&profile);
+    if (PROFILE_ENABLED) {
+        printf("[Headless] Heap allocations: %llu (%.2f/step)\n", (unsigned long long)profile.allocations,
+               profile.allocations / steps);
+    }
+    for (int i = 0; i < profile.zone_count; i++) {
+        const ProfilerZoneStats* zone = &profile.zones[i];
+        if (zone->calls == 0) continue;
+        printf("[Headless] %-10s %8.3f ms total, %7.1f us/call, %4.1f%% of wall\n", zone->name, zone->total_ms,
+               zone->avg_ms * 1000.0, wall_sec > 0.0 ? zone->total_ms / (wall_sec * 10.0) : 0.0);
+    }
+
+    for (int i = 0; i < sim_world_robot_count(world); i++) {
+        float x, z, heading;
+        sim_world_get_robot_pose(world, i, &x, &z, &heading);
+        printf("[Headless] Robot %d: pos=(%.2f, %.2f) heading=%.1f deg\n",
+               i, x, z, heading / DEG_TO_RAD_CONST);
+    }
+    for (uint32_t i = 0; i < sim_world_cylinder_count(world); i++) {
+        const SceneCylinder* cyl = sim_world_get_cylinder(world, i);
+        printf("[Headless] Cylinder %u: pos=(%.2f, %.2f)\n", i, cyl->x, cyl->z);
     }
+
+    return 0;
+}
+
+static void print_usage(const char* exe) {
+    printf("Usage: %s [scene_file] [--headless] [--duration <sec>] [--dt <sec>] [--lockstep] [--threads <n>] [--sim-rate <hz>] [--max-fps <n>] [--trace <file>] [--record <file>] [--replay <file>] [--cook-meshes] [--stream-meshes] [--compact-meshes] [--cameras] [--camera-size <w>x<h>] [--camera-rate <hz>] [--camera-out <dir>] [--serve <port>] [--serve-rate <hz>] [--view <host[:port]>] [--gpu-pieces <n>]\n", exe);
+    printf("  --headless        Run without a window at a fixed step, as fast as possible\n");
+    printf("  --duration <sec>  Simulated time for headless runs (default %.0f)\n", HEADLESS_DEFAULT_DURATION);
+    printf("  --dt <sec>        Fixed physics step for headless runs (default %.4f)\n", HEADLESS_DEFAULT_DT);
+    printf("  --lockstep        Run robot programs on simulated time, one reply per tick (reproducible)\n");
+    printf("  --threads <n>     Physics worker threads (default: hardware threads, 1 = serial)\n");
+    printf("  --sim-rate <hz>   Fixed physics rate of the windowed simulation thread (default %.0f)\n", SIM_THREAD_DEFAULT_RATE);
+    printf("  --max-fps <n>     Cap the frame rate below vsync (default: no cap)\n");
+    printf("  --trace <file>    Record profiler zones and write Chrome trace JSON on exit (profiling builds)\n");
+    printf("  --record <file>   Record robot poses, motor state and cylinders of every step for --replay\n");
+    printf("  --replay <file>   Play back a recording (scene from the recording unless given)\n");
+    printf("  --cook-meshes     Rebuild the part mesh cache (models/%s) and exit\n", MESH_CACHE_FILE);
+    printf("  --stream-meshes   Start drawing at once, with placeholder boxes until part meshes are uploaded\n");
+    printf("  --compact-meshes  Upload part meshes with quantized positions and packed normals (less GPU memory)\n");
+    printf("  --cameras         Render robot cameras in headless runs (offscreen GL context)\n");
+    printf("  --camera-size <w>x<h>  Robot camera resolution (default %dx%d)\n", CAMERA_DEFAULT_WIDTH, CAMERA_DEFAULT_HEIGHT);
+    printf("  --camera-rate <hz>     Robot camera images per second (default %.0f)\n", CAMERA_DEFAULT_RATE);
+    printf("  --camera-out <dir>     Write every robot camera image to dir as PPM (implies --cameras)\n");
+    printf("  --serve <port>    Stream the match to --view clients over UDP\n");
+    printf("  --serve-rate <hz> Frames per second streamed (default %.0f)\n", NET_STREAM_DEFAULT_RATE);
+    printf("  --view <host[:port]>  Show a match streamed by --serve (no physics or programs, default port %d)\n",
+           NET_STREAM_DEFAULT_PORT);
+    printf("  --gpu-pieces <n>  Stress test: n extra game pieces simulated in compute shaders (OpenGL 4.3, up to %d)\n",
+           GPU_FIELD_MAX_PIECES);
 }
 
 int main(int argc, char** argv) {
@@ -1374,72 +1292,247 @@ int main(int argc, char** argv) {
 
     // Parse command line - accept scene file or default to default.scene
     const char* scene_path = NULL;
-    if (argc >= 2) {
-        scene_path = argv[1];
+    HeadlessOptions headless;
+    headless.enabled = false;
+    headless.duration = HEADLESS_DEFAULT_DURATION;
+    headless.dt = HEADLESS_DEFAULT_DT;
+    bool lockstep = false;
+    int physics_threads = 0;
+    float sim_rate = SIM_THREAD_DEFAULT_RATE;
+    float max_fps = 0.0f;
+    const char* trace_path = NULL;
+    const char* record_path = NULL;
+    const char* replay_path = NULL;
+    bool cook_meshes = false;
+    bool stream_meshes = false;
+    bool compact_meshes = false;
+    int serve_port = 0;
+    float serve_rate = NET_STREAM_DEFAULT_RATE;
+    const char* view_address = NULL;
+    int gpu_pieces = 0;
+    CameraOptions camera_options;
+    camera_options.headless = false;
+    camera_options.width = CAMERA_DEFAULT_WIDTH;
+    camera_options.height = CAMERA_DEFAULT_HEIGHT;
+    camera_options.rate = CAMERA_DEFAULT_RATE;
+    camera_options.out_dir = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless.enabled = true;
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            headless.duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            headless.dt = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--lockstep") == 0) {
+            lockstep = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            physics_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sim-rate") == 0 && i + 1 < argc) {
+            sim_rate = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-fps") == 0 && i + 1 < argc) {
+            max_fps = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--cook-meshes") == 0) {
+            cook_meshes = true;
+        } else if (strcmp(argv[i], "--stream-meshes") == 0) {
+            stream_meshes = true;
+        } else if (strcmp(argv[i], "--compact-meshes") == 0) {
+            compact_meshes = true;
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--serve-rate") == 0 && i + 1 < argc) {
+            serve_rate = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--view") == 0 && i + 1 < argc) {
+            view_address = argv[++i];
+        } else if (strcmp(argv[i], "--gpu-pieces") == 0 && i + 1 < argc) {
+            gpu_pieces = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cameras") == 0) {
+            camera_options.headless = true;
+        } else if (strcmp(argv[i], "--camera-size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &camera_options.width, &camera_options.height) != 2) {
+                camera_options.width = 0;
+            }
+        } else if (strcmp(argv[i], "--camera-rate") == 0 && i + 1 < argc) {
+            camera_options.rate = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--camera-out") == 0 && i + 1 < argc) {
+            camera_options.out_dir = argv[++i];
+            camera_options.headless = true;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] == '-' || scene_path) {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            scene_path = argv[i];
+        }
+    }
+
+    if (gpu_pieces > 0 && headless.enabled) {
+        fprintf(stderr, "Warning: --gpu-pieces needs the window, ignored in headless runs\n");
+    }
+
+    if (headless.duration <= 0.0 || headless.dt <= 0.0f || headless.dt > 0.1f) {
+        fprintf(stderr, "Invalid headless timing: duration must be > 0, dt in (0, 0.1]\n");
+        return 1;
+    }
+    if (sim_rate < 10.0f || sim_rate > 2000.0f || max_fps < 0.0f) {
+        fprintf(stderr, "Invalid timing: sim rate must be in [10, 2000] Hz, max fps >= 0\n");
+        return 1;
+    }
+    if (camera_options.width <= 0 || camera_options.height <= 0 || camera_options.width > OFFSCREEN_MAX_SIZE ||
+        camera_options.height > OFFSCREEN_MAX_SIZE || camera_options.rate <= 0.0f) {
+        fprintf(stderr, "Invalid camera options: size must be <w>x<h> up to %d, rate > 0\n", OFFSCREEN_MAX_SIZE);
+        return 1;
+    }
+    if (replay_path && (headless.enabled || record_path)) {
+        fprintf(stderr, "--replay plays back in the window and can't be combined with --headless or --record\n");
+        return 1;
+    }
+    if ((serve_port != 0 || view_address) && (headless.enabled || replay_path)) {
+        fprintf(stderr, "--serve and --view run in the window and can't be combined with --headless or --replay\n");
+        return 1;
+    }
+    if (view_address && (serve_port != 0 || record_path)) {
+        fprintf(stderr, "--view only shows a remote match and can't be combined with --serve or --record\n");
+        return 1;
+    }
+    if (serve_port < 0 || serve_port > 65535 || serve_rate <= 0.0f || serve_rate > sim_rate) {
+        fprintf(stderr, "Invalid stream options: port must be in [1, 65535], rate in (0, sim rate]\n");
+        return 1;
+    }
+    if (trace_path && !PROFILE_ENABLED) {
+        fprintf(stderr, "Warning: built without VEXIQ_PROFILE, --trace ignored\n");
+        trace_path = NULL;
+    }
+    profiler_set_thread_name("main");
+
+    // Offline cooking step (the cache is also re-cooked on demand at load)
+    if (cook_meshes) {
+        char models_dir[512], parts_dir[600], cache_path[600];
+        get_models_dir(models_dir, sizeof(models_dir));
+        snprintf(parts_dir, sizeof(parts_dir), "%s" PATH_SEP "parts", models_dir);
+        snprintf(cache_path, sizeof(cache_path), "%s" PATH_SEP MESH_CACHE_FILE, models_dir);
+        return mesh_cache_cook(parts_dir, cache_path) >= 0 ? 0 : 1;
+    }
+
+    // Recording to play back; it names the scene it was recorded in
+    ReplayReader replay;
+    bool replaying = replay_path != NULL;
+    if (replaying) {
+        if (!replay_open(&replay, replay_path)) return 1;
+        if (!scene_path && replay.header->scene_path[0] != '\0') scene_path = replay.header->scene_path;
+    }
+
+    // Or a match streamed by another simulator, which also names its scene
+    NetStreamViewer* viewer = NULL;
+    if (view_address) {
+        viewer = net_stream_viewer_open(view_address, VIEW_JOIN_TIMEOUT);
+        if (!viewer) return 1;
+        const ReplayHeader* stream = net_stream_viewer_header(viewer);
+        if (!scene_path && stream->scene_path[0] != '\0') scene_path = stream->scene_path;
+    }
+    bool posed_only = replaying || viewer;   // No physics or robot programs, robots posed from frames
+
+    if (scene_path) {
         printf("Scene file: %s\n", scene_path);
     } else {
         scene_path = "../scenes/default.scene";
         printf("Using default scene: %s\n", scene_path);
     }
 
-    // Initialize platform (SDL + OpenGL)
+    // Window, input, and render state (left untouched in headless mode,
+    // except the render state for --cameras)
+    bool rendering = !headless.enabled || camera_options.headless;
     Platform platform;
-    if (!platform_init(&platform, WINDOW_TITLE, WINDOW_WIDTH, WINDOW_HEIGHT)) {
-        fprintf(stderr, "Failed to initialize platform\n");
-        return 1;
-    }
-
-    // Initialize input state
+    memset(&platform, 0, sizeof(platform));
     InputState input;
     memset(&input, 0, sizeof(input));
-
-    // Initialize camera
     FlyCamera camera;
-    camera_init(&camera);
-
-    // Initialize floor
     Floor floor;
-    if (!floor_init(&floor, FIELD_WIDTH, GRID_SIZE, FIELD_WIDTH, FIELD_DEPTH, WALL_HEIGHT, "../textures/vex-tile.png")) {
-        fprintf(stderr, "Failed to initialize floor\n");
-        platform_shutdown(&platform);
-        return 1;
-    }
+    GameObjects game_objects = {};
+    AxisGizmo axis_gizmo;
+    Shader mesh_shader;
+    RenderQueue scene_queue = {};
+
+    if (rendering) {
+        // Initialize platform (SDL + OpenGL, or an offscreen context for headless cameras)
+        bool platform_ready = headless.enabled ? platform_init_offscreen(&platform)
+                                               : platform_init(&platform, WINDOW_TITLE, WINDOW_WIDTH, WINDOW_HEIGHT);
+        if (!platform_ready) {
+            fprintf(stderr, "Failed to initialize platform\n");
+            return 1;
+        }
 
-    // Initialize game objects
-    GameObjects game_objects;
-    if (!objects_init(&game_objects)) {
-        fprintf(stderr, "Failed to initialize game objects\n");
-        floor_destroy(&floor);
-        platform_shutdown(&platform);
-        return 1;
-    }
+        // Initialize camera
+        camera_init(&camera);
 
-    // Initialize axis gizmo (normalized 1.0 length for screen-space rendering)
-    AxisGizmo axis_gizmo;
-    axis_gizmo_init(&axis_gizmo, 1.0f);
+        // Initialize floor
+        if (!floor_init(&floor, FIELD_WIDTH, GRID_SIZE, FIELD_WIDTH, FIELD_DEPTH, WALL_HEIGHT, "../textures/vex-tile.png")) {
+            fprintf(stderr, "Failed to initialize floor\n");
+            platform_shutdown(&platform);
+            return 1;
+        }
 
-    // Initialize mesh shader
-    Shader mesh_shader;
-    if (!mesh_shader_create(&mesh_shader)) {
-        fprintf(stderr, "Failed to create mesh shader\n");
-        floor_destroy(&floor);
-        platform_shutdown(&platform);
-        return 1;
+        // Initialize game objects
+        if (!objects_init(&game_objects)) {
+            fprintf(stderr, "Failed to initialize game objects\n");
+            floor_destroy(&floor);
+            platform_shutdown(&platform);
+            return 1;
+        }
+
+        // Initialize axis gizmo (normalized 1.0 length for screen-space rendering)
+        axis_gizmo_init(&axis_gizmo, 1.0f);
+
+        // Initialize mesh shader
+        if (!mesh_shader_create(&mesh_shader)) {
+            fprintf(stderr, "Failed to create mesh shader\n");
+            floor_destroy(&floor);
+            platform_shutdown(&platform);
+            return 1;
+        }
+        mesh_set_shader(&mesh_shader);
+        mesh_set_compact(compact_meshes);
+
+        // Instanced part rendering (falls back to one draw per part)
+        if (!mesh_instancing_init(1024)) {
+            fprintf(stderr, "Warning: Instanced rendering unavailable, drawing parts individually\n");
+        }
+
+        // Sorted scene submission and the per-view camera/light uniform buffer
+        if (!render_queue_init(&scene_queue)) {
+            objects_destroy(&game_objects);
+            floor_destroy(&floor);
+            platform_shutdown(&platform);
+            return 1;
+        }
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (headless.enabled) {
+        printf("Headless mode: no window, fixed dt=%.5f s, duration=%.2f s\n",
+               headless.dt, headless.duration);
     }
-    mesh_set_shader(&mesh_shader);
 
     // Get paths
     char models_dir[512];
     get_models_dir(models_dir, sizeof(models_dir));
     printf("Models dir: %s\n", models_dir);
 
-    // Mesh cache: part name -> mesh
-    std::map<std::string, Mesh*> mesh_cache;
-
-    // Part instances to render
-    std::vector<PartInstance> parts;
-    std::vector<RobotInstance> robots;
-    uint32_t total_triangles = 0;
+    // Render meshes, indexed by PartRender::mesh_id
+    MeshStore mesh_store;
+    mesh_store.instanced = false;
+    mesh_store.merged_count = 0;
+    mesh_store.gpu_bytes = 0;
+    mesh_store.lod_enabled = true;
+    mesh_store.visible_count = 0;
 
     // Active robot tracking (which robot receives gamepad input)
     // -1 = no active robot, 0-3 = robot index
@@ -1447,304 +1540,79 @@ int main(int argc, char** argv) {
 
     // Load scene file
     Scene scene;
-    if (scene_load(scene_path, &scene)) {
+    memset(&scene, 0, sizeof(scene));
+    bool scene_loaded = scene_load(scene_path, &scene);
+    if (scene_loaded) {
         scene_print(&scene);
+    } else {
+        printf("No scene loaded - running with empty scene\n");
+    }
 
-        // Load each robot in the scene
-        for (uint32_t robot_idx = 0; robot_idx < scene.robot_count; robot_idx++) {
-            const SceneRobot* scene_robot = &scene.robots[robot_idx];
-
-            // Build full path to MPD file
-            char mpd_path[1024];
-            snprintf(mpd_path, sizeof(mpd_path), "%s" PATH_SEP "robots" PATH_SEP "%s",
-                     models_dir, scene_robot->mpd_file);
-
-            printf("\nLoading robot %u: %s at (%.1f, %.1f, %.1f) rot=%.1f°\n",
-                   robot_idx, scene_robot->mpd_file,
-                   scene_robot->x, scene_robot->y, scene_robot->z, scene_robot->rotation_y);
-
-            MpdDocument doc;
-            if (!mpd_load(mpd_path, &doc)) {
-                fprintf(stderr, "  Failed to load: %s\n", mpd_path);
-                continue;
-            }
-
-            // Create robot instance
-            RobotInstance robot;
-            robot.offset[0] = scene_robot->x;
-            robot.offset[1] = scene_robot->y;
-            robot.offset[2] = scene_robot->z;
-            robot.rotation_y = scene_robot->rotation_y * DEG_TO_RAD_CONST;
-            robot.ground_offset = 0.0f;  // Will compute after loading parts
-            robot.bridge = nullptr;      // Will init if robot has iqpython
-            robot_config_init(&robot.motor_config);
-            robot.has_robotdef = false;
-            robot.rotation_center[0] = 0.0f;
-            robot.rotation_center[1] = 0.0f;
-            robot.rotation_center[2] = 0.0f;
-            robot.rotation_axis[0] = 0.0f;
-            robot.rotation_axis[1] = 1.0f;  // Default: vertical rotation
-            robot.rotation_axis[2] = 0.0f;
-            robot.track_width = 0.0f;
-
-            // Try to load robotdef file
-            char robotdef_path[1024];
-            {
-                // Replace .mpd extension with .robotdef
-                strncpy(robotdef_path, mpd_path, sizeof(robotdef_path) - 1);
-                char* ext = strrchr(robotdef_path, '.');
-                if (ext) {
-                    strcpy(ext, ".robotdef");
-                } else {
-                    strncat(robotdef_path, ".robotdef", sizeof(robotdef_path) - strlen(robotdef_path) - 1);
-                }
-
-                RobotDef def;
-                if (robotdef_load(robotdef_path, &def)) {
-                    robot.has_robotdef = true;
-                    // Store rotation center (in LDU - will convert during rendering)
-                    robot.rotation_center[0] = def.drivetrain.rotation_center[0];
-                    robot.rotation_center[1] = def.drivetrain.rotation_center[1];
-                    robot.rotation_center[2] = def.drivetrain.rotation_center[2];
-                    // Store rotation axis
-                    robot.rotation_axis[0] = def.drivetrain.rotation_axis[0];
-                    robot.rotation_axis[1] = def.drivetrain.rotation_axis[1];
-                    robot.rotation_axis[2] = def.drivetrain.rotation_axis[2];
-                    robot.track_width = def.drivetrain.track_width;
-
-                    // Load wheel assemblies
-                    robot.wheel_count = def.wheel_count;
-                    for (int w = 0; w < def.wheel_count && w < ROBOTDEF_MAX_WHEELS; w++) {
-                        const RobotDefWheelAssembly* src = &def.wheel_assemblies[w];
-                        WheelAssembly* dst = &robot.wheels[w];
-                        dst->world_position[0] = src->world_position[0];
-                        dst->world_position[1] = src->world_position[1];
-                        dst->world_position[2] = src->world_position[2];
-                        dst->spin_axis[0] = src->spin_axis[0];
-                        dst->spin_axis[1] = src->spin_axis[1];
-                        dst->spin_axis[2] = src->spin_axis[2];
-                        dst->diameter_mm = src->outer_diameter_mm;
-                        dst->spin_angle = 0.0f;
-                        dst->is_left = src->is_left;
-                        dst->part_count = src->part_count;
-                        for (int p = 0; p < src->part_count && p < ROBOTDEF_MAX_WHEEL_PARTS; p++) {
-                            strncpy(dst->part_numbers[p], src->part_numbers[p], 31);
-                        }
-                    }
-
-                    printf("  Loaded robotdef: rotation_center=[%.1f, %.1f, %.1f] LDU, rotation_axis=[%.1f, %.1f, %.1f], track_width=%.1f LDU, wheels=%d\n",
-                           robot.rotation_center[0], robot.rotation_center[1], robot.rotation_center[2],
-                           robot.rotation_axis[0], robot.rotation_axis[1], robot.rotation_axis[2],
-                           robot.track_width, robot.wheel_count);
-                } else {
-                    printf("  No robotdef found (tried: %s)\n", robotdef_path);
-                }
-            }
-
-            // Initialize drivetrain at robot's starting position
-            drivetrain_init(&robot.drivetrain);
-            drivetrain_set_position(&robot.drivetrain, scene_robot->x, scene_robot->z, robot.rotation_y);
-            drivetrain_set_friction(&robot.drivetrain, scene.physics.friction_coeff);
-
-            // Load config file if specified in scene
-            if (scene_robot->config_file[0] != '\0') {
-                char config_path[1024];
-                snprintf(config_path, sizeof(config_path), "%s" PATH_SEP "robots" PATH_SEP "%s",
-                         models_dir, scene_robot->config_file);
-                if (robot_config_load(config_path, &robot.motor_config)) {
-                    printf("  Loaded config: %s\n", scene_robot->config_file);
-                } else {
-                    fprintf(stderr, "  Failed to load config: %s\n", config_path);
-                }
-            }
-
-            // Initialize Python bridge if robot has an iqpython program
-            if (scene_robot->has_program && scene_robot->iqpython_file[0] != '\0') {
-                char iqpython_path[1024];
-                char simulator_dir[1024];
-                char exe_dir_buf[512];
-                get_exe_dir(exe_dir_buf, sizeof(exe_dir_buf));
-                // iqpython files are in <project>/iqpython/, not models/robots/
-                snprintf(iqpython_path, sizeof(iqpython_path), "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "iqpython" PATH_SEP "%s",
-                         exe_dir_buf, scene_robot->iqpython_file);
-                snprintf(simulator_dir, sizeof(simulator_dir), "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "simulator",
-                         exe_dir_buf);
-
-                robot.bridge = new PythonBridge();
-                if (python_bridge_init(robot.bridge, iqpython_path, simulator_dir)) {
-                    printf("  Started Python bridge for: %s\n", scene_robot->iqpython_file);
-                } else {
-                    fprintf(stderr, "  Failed to start Python bridge for: %s\n", scene_robot->iqpython_file);
-                    delete robot.bridge;
-                    robot.bridge = nullptr;
-                }
-            }
-
-            int current_robot_index = (int)robots.size();
-            robots.push_back(robot);
-
-            // Load meshes for all parts in this robot
-            size_t robot_part_start = parts.size();
-            for (uint32_t i = 0; i < doc.part_count; i++) {
-                const MpdPart* part = &doc.parts[i];
-                std::string glb_name = part_name_to_glb(part->part_name);
-
-                // Check cache
-                Mesh* mesh = nullptr;
-                auto it = mesh_cache.find(glb_name);
-                if (it != mesh_cache.end()) {
-                    mesh = it->second;
-                } else {
-                    // Load the GLB file
-                    char glb_path[1024];
-                    snprintf(glb_path, sizeof(glb_path), "%s" PATH_SEP "parts" PATH_SEP "%s",
-                             models_dir, glb_name.c_str());
-
-                    MeshData mesh_data;
-                    if (glb_load(glb_path, &mesh_data)) {
-                        mesh = new Mesh();
-                        if (mesh_create(mesh, &mesh_data)) {
-                            mesh_cache[glb_name] = mesh;
-                        } else {
-                            delete mesh;
-                            mesh = nullptr;
-                        }
-                        mesh_data_free(&mesh_data);
-                    } else {
-                        // File not found - store nullptr to avoid retrying
-                        mesh_cache[glb_name] = nullptr;
-                    }
-                }
-
-                if (mesh) {
-                    PartInstance inst;
-                    inst.mesh = mesh;
-                    inst.position[0] = part->x;
-                    inst.position[1] = part->y;
-                    inst.position[2] = part->z;
-                    memcpy(inst.rotation, part->rotation, 9 * sizeof(float));
-
-                    // Get color from LDraw color code
-                    ldraw_get_color(part->color_code, &inst.color[0], &inst.color[1], &inst.color[2]);
-
-                    // Color 16 means "main color" - use default, don't override
-                    inst.has_color = (part->color_code != 16);
-                    inst.robot_index = current_robot_index;
-                    inst.wheel_index = -1;
-
-                    // Store normalized part number (strip .dat and variants)
-                    strncpy(inst.part_number, part->part_name, 31);
-                    inst.part_number[31] = '\0';
-                    // Strip .dat extension
-                    char* dot = strrchr(inst.part_number, '.');
-                    if (dot) *dot = '\0';
-                    // Strip c## suffix (LDraw composite parts)
-                    size_t len = strlen(inst.part_number);
-                    if (len > 3 && inst.part_number[len-3] == 'c' &&
-                        isdigit(inst.part_number[len-2]) && isdigit(inst.part_number[len-1])) {
-                        inst.part_number[len-3] = '\0';
-                    }
-
-                    // Store submodel index from MPD for hierarchical collision
-                    inst.submodel_index = part->submodel_index;
-                    inst.collision_state = COLLISION_NONE;
-
-                    parts.push_back(inst);
-                    total_triangles += mesh->index_count / 3;
-                }
-            }
-
-            // Store submodel info from MPD before freeing it
-            RobotInstance& r_submodel = robots[current_robot_index];
-            r_submodel.submodel_count = (int)doc.submodel_count;
-            r_submodel.parts_start_index = robot_part_start;
-            r_submodel.parts_count = parts.size() - robot_part_start;
-
-            // Initialize submodel tracking arrays
-            for (int sm = 0; sm < MAX_ROBOT_SUBMODELS; sm++) {
-                r_submodel.submodel_part_start[sm] = 0;
-                r_submodel.submodel_part_count[sm] = 0;
-                r_submodel.submodel_collision_state[sm] = COLLISION_NONE;
-                r_submodel.submodel_names[sm][0] = '\0';
-            }
-
-            // Copy submodel names and part ranges from MPD
-            for (uint32_t sm = 0; sm < doc.submodel_count && sm < MAX_ROBOT_SUBMODELS; sm++) {
-                strncpy(r_submodel.submodel_names[sm], doc.submodels[sm].name, 127);
-                r_submodel.submodel_names[sm][127] = '\0';
-                r_submodel.submodel_part_start[sm] = (int)doc.submodels[sm].part_start;
-                r_submodel.submodel_part_count[sm] = (int)doc.submodels[sm].part_count;
-            }
-
-            // Compute local OBBs for all parts in this robot
-            for (size_t pi = robot_part_start; pi < parts.size(); pi++) {
-                compute_part_local_obb(&parts[pi], robots[current_robot_index].rotation_center);
-            }
-
-            // Compute submodel OBBs from part OBBs
-            for (int sm = 0; sm < r_submodel.submodel_count; sm++) {
-                compute_submodel_obb(&robots[current_robot_index], sm, parts);
-            }
-
-            printf("  Submodels: %d, Parts with OBBs: %zu\n",
-                   r_submodel.submodel_count, parts.size() - robot_part_start);
-
-            mpd_free(&doc);
-
-            // Compute ground offset for this robot
-            robots[current_robot_index].ground_offset = compute_ground_offset(parts, current_robot_index);
-
-            // Adjust ground offset for rotation center Y position
-            // Rendering applies: wy = wy - pivot_gl_y + ground_offset
-            // The pivot_gl_y offset shifts all parts, so ground_offset must compensate
-            float pivot_gl_y = -robots[current_robot_index].rotation_center[1] * LDU_SCALE;
-            robots[current_robot_index].ground_offset += pivot_gl_y;
-
-            // Match parts to wheel assemblies by part number
-            int wheel_parts_matched = 0;
-            RobotInstance& r = robots[current_robot_index];
-            // Note: For now, use wheel 0 for left side, wheel 2 for right side (first of each)
-            // This makes all same-side wheels spin together (correct for tank drive)
-            int left_wheel_idx = -1, right_wheel_idx = -1;
-            for (int wi = 0; wi < r.wheel_count; wi++) {
-                if (r.wheels[wi].is_left && left_wheel_idx < 0) left_wheel_idx = wi;
-                if (!r.wheels[wi].is_left && right_wheel_idx < 0) right_wheel_idx = wi;
-            }
+    // Start pre-warmed Python workers for the scripted robots now, so their
+    // interpreter startup overlaps building the world (embedded builds run
+    // programs in-process and need none)
+    char simulator_dir[1024];
+    {
+        char exe_dir_buf[512];
+        get_exe_dir(exe_dir_buf, sizeof(exe_dir_buf));
+        snprintf(simulator_dir, sizeof(simulator_dir), "%s" PATH_SEP ".." PATH_SEP ".." PATH_SEP "simulator",
+                 exe_dir_buf);
+    }
+    int program_count = 0;
+    for (uint32_t i = 0; scene_loaded && !posed_only && i < scene.robot_count; i++) {
+        if (scene.robots[i].has_program && scene.robots[i].iqpython_file[0] != '\0') program_count++;
+    }
+    PythonPool* python_pool = nullptr;
+    if (program_count > 0 && !PYTHON_BRIDGE_EMBEDDED) {
+        python_pool = new PythonPool();
+        if (!python_pool_init(python_pool, simulator_dir, program_count)) {
+            fprintf(stderr, "Warning: Python worker pool unavailable, spawning a process per robot\n");
+            delete python_pool;
+            python_pool = nullptr;
+        }
+    }
 
-            for (size_t pi = robot_part_start; pi < parts.size(); pi++) {
-                PartInstance& p = parts[pi];
-                // Check all wheels for matching part number
-                for (int wi = 0; wi < r.wheel_count; wi++) {
-                    WheelAssembly& w = r.wheels[wi];
-                    for (int wpi = 0; wpi < w.part_count; wpi++) {
-                        if (strcmp(p.part_number, w.part_numbers[wpi]) == 0) {
-                            // Assign to left or right wheel based on part X position
-                            // Negative X = left side, Positive X = right side
-                            p.wheel_index = (p.position[0] < 0) ? left_wheel_idx : right_wheel_idx;
-                            if (p.wheel_index >= 0) wheel_parts_matched++;
-                            break;
-                        }
-                    }
-                    if (p.wheel_index >= 0) break;
-                }
-            }
+    // Build the simulation world (robots, parts, collision data)
+    // Headless mode only needs part bounds, so it uses the built-in resolver
+    // (unless it renders cameras); meshes stream only into the window
+    // Windowed mode steps a shared copy on the simulation thread and only
+    // poses this one for drawing, so it needs no physics workers
+    SimWorld world;
+    sim_world_set_threads(&world, headless.enabled ? physics_threads : 1);
+    SimAssetResolver mesh_resolver = { resolve_part_mesh, &mesh_store, stream_meshes && !headless.enabled };
+    sim_world_create(&world, &scene, models_dir, rendering ? &mesh_resolver : nullptr);
+    std::vector<RobotInstance>& robots = world.robots;
+    SimParts& parts = world.parts;
+
+    if (rendering) {
+        mesh_store_build_draw_order(&mesh_store, &world);
+        mesh_store.instanced = mesh_instancing_ready();
+        if (!sim_world_meshes_pending(&world)) mesh_store_print_stats(&mesh_store);
+    }
 
-            printf("  Loaded %zu parts, ground offset: %.3f inches (pivot_y: %.3f), wheel parts: %d\n",
-                   parts.size() - robot_part_start,
-                   robots[current_robot_index].ground_offset,
-                   pivot_gl_y,
-                   wheel_parts_matched);
+    // Python IPC bridges, indexed like robots (NULL if no program)
+    // All bridge output is read through one reactor (NULL: each bridge reads its own pipe)
+    std::vector<PythonBridge*> bridges(robots.size(), nullptr);
+    IoReactor bridge_reactor_storage;
+    IoReactor* bridge_reactor = io_reactor_init(&bridge_reactor_storage) ? &bridge_reactor_storage : nullptr;
+    BridgeLaunch bridge_launch = { python_pool, bridge_reactor, simulator_dir, lockstep };
+
+    if (scene_loaded) {
+        // Start a Python bridge for each robot with an iqpython program
+        // (a replay or viewer only poses the robots)
+        for (size_t i = 0; i < robots.size() && !posed_only; i++) {
+            bridges[i] = start_robot_bridge(&bridge_launch, &scene.robots[robots[i].scene_index]);
         }
 
-        // Load cylinders from scene
-        for (uint32_t i = 0; i < scene.cylinder_count; i++) {
+        // Load cylinders from scene (physics state lives in world.scene.cylinders)
+        for (uint32_t i = 0; i < scene.cylinder_count && rendering; i++) {
             const SceneCylinder* cyl = &scene.cylinders[i];
             objects_add_cylinder(&game_objects, cyl->x, cyl->z, cyl->radius, cyl->height,
                                 cyl->r, cyl->g, cyl->b);
         }
 
         printf("\nScene loaded: %zu robots, %zu total parts, %zu unique meshes, %u triangles, %u cylinders\n",
-               robots.size(), parts.size(), mesh_cache.size(), total_triangles, scene.cylinder_count);
+               robots.size(), parts.size(), world.asset_index.size(), world.total_triangles, scene.cylinder_count);
 
         // Auto-select first robot with a program
         for (uint32_t i = 0; i < scene.robot_count; i++) {
@@ -1757,8 +1625,81 @@ int main(int argc, char** argv) {
         if (active_robot_index < 0) {
             printf("No controllable robots found (no iqpython files assigned)\n");
         }
-    } else {
-        printf("No scene loaded - running with empty scene\n");
+    }
+
+    if (replaying && !replay_matches_world(&replay, &world)) {
+        fprintf(stderr, "Recording %s doesn't match the robots and cylinders of %s\n", replay_path, scene_path);
+        replay_close(&replay);
+        sim_world_destroy(&world);
+        platform_shutdown(&platform);
+        return 1;
+    }
+    if (viewer && !net_stream_viewer_matches_world(viewer, &world)) {
+        fprintf(stderr, "Stream from %s doesn't match the robots and cylinders of %s\n", view_address, scene_path);
+        net_stream_viewer_close(viewer);
+        sim_world_destroy(&world);
+        platform_shutdown(&platform);
+        return 1;
+    }
+
+    // Every step is recorded: headless steps, or the simulation thread's
+    ReplayWriter* recorder = NULL;
+    if (record_path) {
+        float record_dt = headless.enabled ? headless.dt : 1.0f / sim_rate;
+        recorder = replay_writer_open(record_path, &world, scene_path, record_dt);
+        if (!recorder) {
+            destroy_bridges(bridges, bridge_reactor, python_pool);
+            sim_world_destroy(&world);
+            if (rendering) platform_shutdown(&platform);
+            return 1;
+        }
+    }
+
+    // Viewers are fed from the simulation thread's steps, like the recorder
+    NetStreamServer* stream_server = NULL;
+    if (serve_port != 0) {
+        stream_server = net_stream_server_open(serve_port, &world, scene_path, serve_rate);
+        if (!stream_server) {
+            replay_writer_close(recorder);
+            destroy_bridges(bridges, bridge_reactor, python_pool);
+            sim_world_destroy(&world);
+            platform_shutdown(&platform);
+            return 1;
+        }
+    }
+
+    // Robot cameras: always in the window, with --cameras in headless runs
+    CameraRig camera_rig;
+    bool cameras = rendering && camera_rig_init(&camera_rig, &world, bridges, &camera_options, &mesh_store, &floor,
+                                                &game_objects, &scene_queue);
+
+    if (headless.enabled) {
+        if (trace_path) profiler_trace_start();
+        int result = run_headless(&headless, &world, bridges, bridge_reactor, recorder,
+                                  cameras ? &camera_rig : nullptr);
+        if (trace_path) profiler_trace_write(trace_path);
+        if (!replay_writer_close(recorder)) result = 1;
+
+        destroy_bridges(bridges, bridge_reactor, python_pool);
+        sim_world_destroy(&world);
+
+        if (rendering) {
+            camera_rig_destroy(&camera_rig);
+            for (Mesh* mesh : mesh_store.meshes) {
+                mesh_destroy(mesh);
+                delete mesh;
+            }
+            mesh_instancing_destroy();
+            shader_destroy(&mesh_shader);
+            render_queue_destroy(&scene_queue);
+            axis_gizmo_destroy(&axis_gizmo);
+            objects_destroy(&game_objects);
+            floor_destroy(&floor);
+            platform_shutdown(&platform);
+        }
+
+        printf("Shutdown complete.\n");
+        return result;
     }
 
     // Initialize gamepad
@@ -1788,13 +1729,14 @@ int main(int argc, char** argv) {
     }
 
     // OpenGL setup
-    glEnable(GL_DEPTH_TEST);
     glClearColor(0.15f, 0.15f, 0.18f, 1.0f);
 
     // Initialize text renderer
     if (!text_init()) {
         fprintf(stderr, "Warning: Failed to initialize text renderer\n");
     }
+    TextLayer* stats_layer = text_layer_create();   // Top-right stats overlay
+    TextLayer* panel_layer = text_layer_create();   // Left UI panel
 
     // Initialize debug renderer
     if (!debug_init()) {
@@ -1812,15 +1754,91 @@ int main(int argc, char** argv) {
     printf("  Shift + MMB + Drag   - Pan camera\n");
     printf("  Scroll Wheel         - Zoom in/out\n");
     printf("  B                    - Toggle bounding boxes\n");
+    printf("  L                    - Toggle level of detail\n");
+    if (!posed_only) printf("  R                    - Rewind %.0f s\n", REWIND_STEP_SECONDS);
+    if (replaying) {
+        printf("  Space                - Pause/resume replay\n");
+        printf("  Left / Right         - Seek replay -/+ 5 s\n");
+        printf("  Backspace            - Restart replay\n");
+    }
     printf("  F11                  - Toggle fullscreen\n");
     printf("  Escape               - Quit\n\n");
 
+    // Physics, collision response and robot programs step on their own thread
+    // at a fixed rate on a shared copy of the world; this thread sends input
+    // and draws `world` posed between the last two steps
+    SimWorld sim;
+    sim_world_set_threads(&sim, physics_threads);
+    sim_world_create_shared(&sim, &world, &scene);
+
+    SimControl sim_control;
+    sim_control.gamepad = gamepad;
+    sim_control.active_robot_index = active_robot_index;
+    sim_control.rewind_seconds = 0.0;
+    int history_steps = posed_only ? 0 : (int)(REWIND_HISTORY_SECONDS * sim_rate + 0.5f);
+    sim_snapshot_ring_init(&sim_control.history, &sim, history_steps);   // 0 = no history (replay, viewer)
+    sim_control.bridges = &bridges;
+    sim_control.reactor = bridge_reactor;
+    sim_control.recorder = recorder;
+    sim_control.stream = stream_server;
+    memset(&sim_control.stream_stats, 0, sizeof(sim_control.stream_stats));
+    sim_control.step_count = 0;
+    sim_control.debug_interval = (uint64_t)(sim_rate + 0.5f);
+
+    // A replay or viewer poses `world` from its frames instead
+    SimThread* sim_thread = posed_only ? NULL : sim_thread_start(&sim, sim_rate, sim_control_step, &sim_control);
+    if (!sim_thread && !posed_only) {
+        fprintf(stderr, "Failed to start the simulation thread\n");
+        platform.should_quit = true;
+    }
+
+    // Scene hot-reload: edits to the scene file apply to the running match.
+    // Recordings and viewers hold one layout, so --record and --serve keep it.
+    SceneWatch scene_watch;
+    bool watching = sim_thread && scene_loaded && !recorder && !stream_server && scene_watch_init(&scene_watch, scene_path);
+    if (watching) printf("[Scene] Watching %s for edits\n", scene_path);
+
+    // GPU game-piece field (stress test): sized and colored like the scene's
+    // first cylinder, stepped on this thread at the physics rate
+    GpuField gpu_field;
+    memset(&gpu_field, 0, sizeof(gpu_field));
+    float gpu_field_lag = 0.0f;
+    float gpu_field_color[3] = { 0.9f, 0.55f, 0.1f };
+    if (gpu_pieces > 0) {
+        float radius = GPU_FIELD_DEFAULT_RADIUS, height = GPU_FIELD_DEFAULT_HEIGHT;
+        if (scene.cylinder_count > 0) {
+            radius = scene.cylinders[0].radius;
+            height = scene.cylinders[0].height;
+            gpu_field_color[0] = scene.cylinders[0].r;
+            gpu_field_color[1] = scene.cylinders[0].g;
+            gpu_field_color[2] = scene.cylinders[0].b;
+        }
+        if (!gpu_field_init(&gpu_field, (uint32_t)gpu_pieces, radius, height, world.field_half_width,
+                            world.field_half_depth)) {
+            fprintf(stderr, "Warning: --gpu-pieces unavailable, running without the piece field\n");
+        }
+    }
+
     // Timing and FPS tracking
+    if (trace_path) profiler_trace_start();
+    ProfilerWindow profile;
+    profiler_window(&profile);
     double last_time = platform_get_time();
     double fps_update_time = last_time;
     int frame_count = 0;
+    int profile_frames = 0;   // Frames in the profile window
     float current_fps = 0.0f;
 
+    // Transient render data (debug batches, text uploads), reset every frame
+    Arena frame_arena;
+    arena_init(&frame_arena, "frame", FRAME_ARENA_SIZE);
+
+    // Replay playback position (simulated seconds since the recording started)
+    double replay_time = 0.0;
+    bool replay_paused = false;
+    ReplayFrame replay_frame;
+    replay_frame.time = 0.0;
+
     // Main loop
     while (!platform.should_quit) {
         // Calculate delta time
@@ -1828,18 +1846,21 @@ int main(int argc, char** argv) {
         float dt = (float)(current_time - last_time);
         last_time = current_time;
 
-        // Cap dt to prevent physics explosions on lag spikes
+        // Cap dt to keep the camera from jumping on lag spikes
         if (dt > 0.1f) dt = 0.1f;
 
         // Update FPS counter
         frame_count++;
         if (current_time - fps_update_time >= 0.5) {
             current_fps = frame_count / (float)(current_time - fps_update_time);
+            profiler_window(&profile);
+            profile_frames = frame_count;
             frame_count = 0;
             fps_update_time = current_time;
         }
 
         // Poll events (with gamepad event callback)
+        PROFILE_BEGIN(events, "events");
         platform_poll_events_ex(&platform, &input,
             [](void* sdl_event, void* user_data) {
                 Gamepad* gp = (Gamepad*)user_data;
@@ -1848,6 +1869,7 @@ int main(int argc, char** argv) {
 
         // Update gamepad state
         gamepad_update(&gamepad);
+        PROFILE_END(events);
 
         // Handle keyboard input
         if (input.keys_pressed[KEY_ESCAPE]) {
@@ -1864,6 +1886,12 @@ int main(int argc, char** argv) {
             printf("Bounding boxes: %s\n", show_bounding_boxes ? "ON" : "OFF");
         }
 
+        // Toggle level of detail
+        if (input.keys_pressed[SDL_SCANCODE_L]) {
+            mesh_store.lod_enabled = !mesh_store.lod_enabled;
+            printf("Level of detail: %s\n", mesh_store.lod_enabled ? "ON" : "OFF");
+        }
+
         // Switch active robot with 1-4 keys
         for (int key = SDL_SCANCODE_1; key <= SDL_SCANCODE_4; key++) {
             if (input.keys_pressed[key]) {
@@ -1879,158 +1907,134 @@ int main(int argc, char** argv) {
             }
         }
 
-        // Motor control driven by IQPython via IPC
-        // Send gamepad to active robot, update all bridges, apply motor states
-        static int debug_frame = 0;
-        debug_frame++;
-        bool debug_print = (debug_frame % 60 == 0);  // Print once per second
-
-        for (size_t i = 0; i < robots.size(); i++) {
-            RobotInstance& robot = robots[i];
-
-            if (debug_print && i == 0) {
-                printf("[DEBUG] Robot %zu: bridge=%p, config: left_port=%d, right_port=%d\n",
-                       i, (void*)robot.bridge,
-                       robot.motor_config.left_motor_port,
-                       robot.motor_config.right_motor_port);
-            }
-
-            if (!robot.bridge) continue;
-
-            // Send gamepad only to active robot
-            if ((int)i == active_robot_index) {
-                python_bridge_send_gamepad(robot.bridge, &gamepad);
-                if (debug_print) {
-                    printf("[DEBUG] Sent gamepad to robot %zu: A=%d B=%d\n",
-                           i, gamepad.axes.a, gamepad.axes.b);
+        // Apply a saved scene edit with the simulation thread stopped (it owns
+        // the stepped world and the bridges while it runs)
+        Scene edited = {};
+        if (watching && scene_watch_poll(&scene_watch, current_time) && scene_load(scene_path, &edited)) {
+            SceneDiff diff = {};
+            scene_diff(&scene, &edited, &diff);
+            scene_diff_print(&diff, &edited);
+            if (diff.flags != 0) {
+                double edit_start = platform_get_time();
+                sim_thread_stop(sim_thread);
+
+                std::vector<int> old_scene_indices;
+                for (const RobotInstance& robot : robots) old_scene_indices.push_back(robot.scene_index);
+                bool reload = (diff.flags & SCENE_DIFF_ROBOTS) != 0;
+                if (reload) {
+                    sim_world_reload(&world, &edited, models_dir, &mesh_resolver);
+                    sim_world_create_shared(&sim, &world, &edited);
+                    mesh_store_build_draw_order(&mesh_store, &world);
+                } else {
+                    sim_world_apply_scene(&sim, &edited, &diff);
+                    sim_world_apply_scene(&world, &edited, &diff);
                 }
-            }
-
-            // Send tick to all robots with bridges
-            python_bridge_send_tick(robot.bridge, dt);
-
-            // Update bridge (read incoming messages)
-            python_bridge_update(robot.bridge);
-
-            if (debug_print) {
-                printf("[DEBUG] Robot %zu bridge: connected=%d, ready=%d\n",
-                       i, robot.bridge->connected, robot.bridge->robot_ready);
-            }
-
-            // Apply motor states to drivetrain
-            if (python_bridge_is_ready(robot.bridge)) {
-                RobotState* state = python_bridge_get_state(robot.bridge);
-                float left_pct = 0.0f;
-                float right_pct = 0.0f;
-
-                if (debug_print) {
-                    printf("[DEBUG] Robot %zu: motor_count=%d\n", i, state->motor_count);
-                    for (int m = 0; m < state->motor_count; m++) {
-                        printf("[DEBUG]   Motor port=%d speed=%d spinning=%d\n",
-                               state->motors[m].port, state->motors[m].speed,
-                               state->motors[m].spinning);
+                if (reload || (diff.flags & SCENE_DIFF_PROGRAMS)) {
+                    update_scene_bridges(bridges, old_scene_indices, &world, &diff, &bridge_launch);
+                    if (cameras) camera_rig_destroy(&camera_rig);
+                    cameras = camera_rig_init(&camera_rig, &world, bridges, &camera_options, &mesh_store, &floor,
+                                              &game_objects, &scene_queue);
+                }
+                if (reload || (diff.flags & SCENE_DIFF_CYLINDERS)) {
+                    objects_clear(&game_objects);
+                    for (uint32_t i = 0; i < world.scene.cylinder_count; i++) {
+                        const SceneCylinder* cyl = &world.scene.cylinders[i];
+                        objects_add_cylinder(&game_objects, cyl->x, cyl->z, cyl->radius, cyl->height,
+                                             cyl->r, cyl->g, cyl->b);
                     }
                 }
 
-                // Find motors matching our config ports
-                for (int m = 0; m < state->motor_count; m++) {
-                    MotorState* motor = &state->motors[m];
-                    if (motor->port == robot.motor_config.left_motor_port) {
-                        left_pct = (float)motor->speed;
-                    }
-                    if (motor->port == robot.motor_config.right_motor_port) {
-                        right_pct = (float)motor->speed;
+                // Rewinding can't cross an edit: history starts over
+                scene_free(&scene);
+                scene = edited;   // Takes over the edited arrays
+                edited = Scene{};
+                sim_snapshot_ring_init(&sim_control.history, &sim, history_steps);
+                if (active_robot_index >= (int)scene.robot_count ||
+                    (active_robot_index >= 0 && !scene.robots[active_robot_index].has_program)) {
+                    active_robot_index = -1;
+                    for (uint32_t i = 0; i < scene.robot_count && active_robot_index < 0; i++) {
+                        if (scene.robots[i].has_program) active_robot_index = (int)i;
                     }
                 }
 
-                if (debug_print) {
-                    printf("[DEBUG] Robot %zu: left_pct=%.1f right_pct=%.1f\n",
-                           i, left_pct, right_pct);
+                sim_thread = sim_thread_start(&sim, sim_rate, sim_control_step, &sim_control);
+                if (!sim_thread) {
+                    fprintf(stderr, "Failed to restart the simulation thread\n");
+                    platform.should_quit = true;
+                    watching = false;
                 }
-
-                drivetrain_set_motors(&robot.drivetrain, left_pct, right_pct);
-            } else if (debug_print) {
-                printf("[DEBUG] Robot %zu: bridge not ready\n", i);
+                printf("[Scene] Edit applied in %.0f ms\n", (platform_get_time() - edit_start) * 1000.0);
             }
+            scene_diff_free(&diff);
         }
-
-        // =====================================================================
-        // Physics update order:
-        // 1. Update drivetrain physics (motor forces)
-        // 2. Apply OBB-based collision response
-        // 3. Sync positions for rendering
-        // 4. Run hierarchical OBB collision detection (for debug visualization)
-        // =====================================================================
-
-        // Step 1: Update drivetrain physics
-        for (auto& robot : robots) {
-            drivetrain_update(&robot.drivetrain, dt);
+        scene_free(&edited);
+
+        // Motor control driven by IQPython via IPC runs on the simulation
+        // thread; hand it the gamepad, active robot and rewinds for its next step
+        {
+            std::lock_guard<std::mutex> guard(sim_control.lock);
+            sim_control.gamepad = gamepad;
+            sim_control.active_robot_index = active_robot_index;
+            if (!posed_only && input.keys_pressed[SDL_SCANCODE_R]) sim_control.rewind_seconds += REWIND_STEP_SECONDS;
         }
 
-        // Step 2: Apply collision response (walls, robots, cylinders)
-        run_collision_response(robots, parts, &scene, FIELD_WIDTH / 2.0f, FIELD_DEPTH / 2.0f);
+        // Pose robots and cylinders between the two newest physics steps
+        if (sim_thread) sim_thread_interpolate(sim_thread, &world);
 
-        // Step 2b: Update cylinder physics (friction, position)
-        update_cylinder_physics(&scene, dt, FIELD_WIDTH / 2.0f, FIELD_DEPTH / 2.0f);
+        // Or from the recording: seeking only decodes from the nearest keyframe
+        if (replaying) {
+            if (input.keys_pressed[KEY_SPACE]) replay_paused = !replay_paused;
+            if (input.keys_pressed[KEY_LEFT]) replay_time -= 5.0;
+            if (input.keys_pressed[KEY_RIGHT]) replay_time += 5.0;
+            if (input.keys_pressed[KEY_BACKSPACE]) replay_time = 0.0;
+            if (!replay_paused) replay_time += dt;
+            replay_time = std::min(std::max(replay_time, 0.0), replay_duration(&replay));
 
-        // Step 2c: Sync cylinder positions to rendering objects
-        for (uint32_t i = 0; i < scene.cylinder_count; i++) {
-            objects_update_cylinder(&game_objects, i, scene.cylinders[i].x, scene.cylinders[i].z);
+            uint32_t frame = replay_frame_at(&replay, replay.header->start_time + replay_time);
+            if (replay_read_frame(&replay, frame, &replay_frame)) replay_apply_frame(&replay_frame, &world);
         }
 
-        // Step 3: Sync drivetrain positions back to robot for rendering
-        for (auto& robot : robots) {
-            robot.offset[0] = robot.drivetrain.pos_x;
-            robot.offset[2] = robot.drivetrain.pos_z;
-            robot.rotation_y = robot.drivetrain.heading;
-
-            // Update wheel spin angles based on drivetrain velocity
-            for (int w = 0; w < robot.wheel_count; w++) {
-                WheelAssembly& wheel = robot.wheels[w];
-                // Get wheel velocity (left or right side)
-                float wheel_vel = wheel.is_left ?
-                    robot.drivetrain.left_velocity :
-                    robot.drivetrain.right_velocity;
-                // Convert diameter mm to radius in inches
-                float radius_in = (wheel.diameter_mm / 25.4f) / 2.0f;
-                if (radius_in > 0.0f) {
-                    // Angular velocity = linear velocity / radius
-                    float angular_vel = wheel_vel / radius_in;
-                    // Account for spin axis direction: if axis points in negative
-                    // principal direction, negate to keep consistent visual rotation
-                    float ax = fabsf(wheel.spin_axis[0]);
-                    float ay = fabsf(wheel.spin_axis[1]);
-                    float az = fabsf(wheel.spin_axis[2]);
-                    if (ax >= ay && ax >= az) {
-                        if (wheel.spin_axis[0] < 0) angular_vel = -angular_vel;
-                    } else if (ay >= ax && ay >= az) {
-                        if (wheel.spin_axis[1] < 0) angular_vel = -angular_vel;
-                    } else {
-                        if (wheel.spin_axis[2] < 0) angular_vel = -angular_vel;
-                    }
-                    // During turning (opposite velocities), flip spin direction
-                    if (robot.drivetrain.left_velocity * robot.drivetrain.right_velocity < 0) {
-                        angular_vel = -angular_vel;
-                    }
-                    wheel.spin_angle += angular_vel * dt;
-                    // Keep angle in reasonable range
-                    while (wheel.spin_angle > 6.28318f) wheel.spin_angle -= 6.28318f;
-                    while (wheel.spin_angle < -6.28318f) wheel.spin_angle += 6.28318f;
-                }
+        // Or from the newest streamed frame, following the server's active robot
+        if (viewer) {
+            int remote_active = -1;
+            if (net_stream_viewer_poll(viewer, &replay_frame, &remote_active)) {
+                replay_apply_frame(&replay_frame, &world);
+                if (remote_active < (int)scene.robot_count) active_robot_index = remote_active;
             }
         }
 
-        // Step 4: Hierarchical collision detection (for debug visualization)
+        // Sync cylinder positions to rendering objects
+        for (uint32_t i = 0; i < sim_world_cylinder_count(&world); i++) {
+            const SceneCylinder* cyl = sim_world_get_cylinder(&world, i);
+            objects_update_cylinder(&game_objects, i, cyl->x, cyl->z);
+        }
+
+        // GPU pieces, pushed by the robots as drawn this frame
+        if (gpu_field.valid) {
+            update_gpu_field(&gpu_field, &world, sim_thread ? sim_thread_dt(sim_thread) : 1.0f / SIM_THREAD_DEFAULT_RATE,
+                             dt, &gpu_field_lag);
+            objects_set_field(&game_objects, gpu_field_buffer(&gpu_field), gpu_field.count, gpu_field.radius,
+                              gpu_field.height, gpu_field_color[0], gpu_field_color[1], gpu_field_color[2]);
+        }
+
+        // Hierarchical collision detection (for debug visualization)
         // This detects which parts are colliding but doesn't affect physics yet
         if (show_bounding_boxes) {
-            run_hierarchical_collision_detection(robots, parts, &scene,
-                                                  FIELD_WIDTH / 2.0f, FIELD_DEPTH / 2.0f);
+            sim_world_detect_collisions(&world);
+        }
+
+        // Upload streamed part meshes (parts draw as placeholders until then)
+        if (sim_world_meshes_pending(&world) &&
+            sim_world_resolve_meshes(&world, &mesh_resolver, MESH_STREAM_PER_FRAME) > 0) {
+            mesh_store_build_draw_order(&mesh_store, &world);
+            if (!sim_world_meshes_pending(&world)) mesh_store_print_stats(&mesh_store);
         }
 
         // Update camera
         camera_update(&camera, &input, dt);
 
         // Render - clear full screen first
+        PROFILE_BEGIN(render, "render");
         glViewport(0, 0, platform.width, platform.height);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -2044,34 +2048,36 @@ int main(int argc, char** argv) {
         Mat4 view = camera_view_matrix(&camera);
         Mat4 projection = camera_projection_matrix(&camera, aspect);
 
-        // Render floor
-        floor_render(&floor, &view, &projection, camera_position(&camera));
-
-        // Render game objects
-        objects_render(&game_objects, &view, &projection, camera_position(&camera));
-
-        // Render all parts
-        Vec3 light_dir = vec3_normalize(vec3(0.5f, 1.0f, 0.3f));
-
-        for (const auto& part : parts) {
-            // Get robot instance for this part (if any)
-            const RobotInstance* robot = nullptr;
-            const WheelAssembly* wheel = nullptr;
-            if (part.robot_index >= 0 && part.robot_index < (int)robots.size()) {
-                robot = &robots[part.robot_index];
-                // Get wheel assembly if this is a wheel part
-                if (part.wheel_index >= 0 && part.wheel_index < robot->wheel_count) {
-                    wheel = &robot->wheels[part.wheel_index];
-                }
+        // Floor, game objects and all parts; the frustum also culls debug geometry
+        Frustum frustum;
+        mesh_draw_stats_reset();
+        render_scene_view(&mesh_store, &world, &floor, &game_objects, &scene_queue, view, projection,
+                          camera_position(&camera), (float)platform.height, &frustum);
+
+        MeshDrawStats part_draws = mesh_draw_stats();
+
+        // Placeholder boxes for parts whose meshes are still streaming in
+        if (sim_world_meshes_pending(&world)) {
+            debug_begin(&view, &projection, &frame_arena);
+            Vec3 placeholder_color = vec3(0.6f, 0.6f, 0.6f);
+            for (size_t pi = 0; pi < parts.size(); pi++) {
+                const PartRender& part = parts.render[pi];
+                if (part.mesh_id >= 0) continue;
+                Mat4 model;
+                memcpy(model.m, sim_part_world_matrix(&world, pi), sizeof(model.m));
+                Vec3 center;
+                float radius;
+                part_world_sphere(&part, model.m, &center, &radius);
+                if (!frustum_test_sphere(&frustum, center, radius)) continue;
+                debug_draw_box_transformed(&model, parts.info[pi].min_bounds, parts.info[pi].max_bounds,
+                                           placeholder_color);
             }
-            Mat4 model = build_ldraw_model_matrix(part.position, part.rotation, robot, wheel);
-            const float* color = part.has_color ? part.color : nullptr;
-            mesh_render(part.mesh, &model, &view, &projection, light_dir, color);
+            debug_end();
         }
 
         // Debug rendering (hierarchical OBB collision visualization)
         if (show_bounding_boxes) {
-            debug_begin(&view, &projection);
+            debug_begin(&view, &projection, &frame_arena);
 
             // Collision state colors:
             // Green = no collision, Yellow = submodel boundary hit (checking parts)
@@ -2083,12 +2089,12 @@ int main(int argc, char** argv) {
 
             // Draw submodel OBBs for each robot
             for (size_t ri = 0; ri < robots.size(); ri++) {
-                const RobotInstance& robot = robots[ri];
+                RobotInstance& robot = robots[ri];
 
                 for (int sm = 0; sm < robot.submodel_count; sm++) {
-                    // Transform submodel OBB to world space
-                    OBB world_obb;
-                    transform_obb_to_world(&robot.submodel_obbs[sm], &robot, &world_obb);
+                    // Submodel OBB in world space (cached per robot pose)
+                    const OBB& world_obb = *sim_submodel_world_obb(&robot, sm);
+                    if (!frustum_test_obb(&frustum, &world_obb)) continue;
 
                     // Get color based on collision state
                     Vec3 color;
@@ -2099,19 +2105,8 @@ int main(int argc, char** argv) {
                         default: color = color_none; break;
                     }
 
-                    // Draw submodel OBB
-                    Vec3 corners[8];
-                    obb_get_corners(&world_obb, corners);
-
-                    // Draw the 12 edges of the OBB
-                    int edges[12][2] = {
-                        {0,1}, {1,2}, {2,3}, {3,0},  // Bottom face
-                        {4,5}, {5,6}, {6,7}, {7,4},  // Top face
-                        {0,4}, {1,5}, {2,6}, {3,7}   // Vertical edges
-                    };
-                    for (int e = 0; e < 12; e++) {
-                        debug_draw_line(corners[edges[e][0]], corners[edges[e][1]], color);
-                    }
+                    // Draw submodel OBB (instanced unit box)
+                    debug_draw_obb(&world_obb, color);
                 }
 
                 // Draw robot origin axes
@@ -2120,41 +2115,37 @@ int main(int argc, char** argv) {
             }
 
             // Draw part OBBs only for parts with collisions (to avoid clutter)
-            for (const auto& part : parts) {
-                if (!part.mesh) continue;
-                if (part.collision_state == COLLISION_NONE) continue;  // Skip non-colliding parts
+            for (size_t pi = 0; pi < parts.size(); pi++) {
+                int collision_state = parts.collision_state[pi];
+                if (collision_state == COLLISION_NONE) continue;  // Skip non-colliding parts
 
-                if (part.robot_index < 0 || part.robot_index >= (int)robots.size()) continue;
-                const RobotInstance* robot = &robots[part.robot_index];
+                int robot_index = parts.transforms[pi].robot_index;
+                if (robot_index < 0 || robot_index >= (int)robots.size()) continue;
+                RobotInstance* robot = &robots[robot_index];
 
-                // Transform part OBB to world space
-                OBB world_obb;
-                transform_obb_to_world(&part.local_obb, robot, &world_obb);
+                // Part OBB in world space (cached per robot pose)
+                const OBB& world_obb = *sim_part_world_obb(robot, &parts.collision[pi]);
+                if (!frustum_test_obb(&frustum, &world_obb)) continue;
 
                 // Get color based on collision state
                 Vec3 color;
-                switch (part.collision_state) {
+                switch (collision_state) {
                     case COLLISION_PART: color = color_part; break;
                     case COLLISION_EXTERNAL: color = color_external; break;
                     default: color = vec3(0.5f, 0.5f, 0.5f); break;  // Gray fallback
                 }
 
                 // Draw part OBB
-                Vec3 corners[8];
-                obb_get_corners(&world_obb, corners);
-                int edges[12][2] = {
-                    {0,1}, {1,2}, {2,3}, {3,0},
-                    {4,5}, {5,6}, {6,7}, {7,4},
-                    {0,4}, {1,5}, {2,6}, {3,7}
-                };
-                for (int e = 0; e < 12; e++) {
-                    debug_draw_line(corners[edges[e][0]], corners[edges[e][1]], color);
-                }
+                debug_draw_obb(&world_obb, color);
             }
 
             // Draw cylinder collision shapes
-            for (uint32_t i = 0; i < scene.cylinder_count; i++) {
-                const SceneCylinder* cyl = &scene.cylinders[i];
+            for (uint32_t i = 0; i < sim_world_cylinder_count(&world); i++) {
+                const SceneCylinder* cyl = sim_world_get_cylinder(&world, i);
+                AABB cyl_bounds;
+                cyl_bounds.min = vec3(cyl->x - cyl->radius, 0.0f, cyl->z - cyl->radius);
+                cyl_bounds.max = vec3(cyl->x + cyl->radius, cyl->height, cyl->z + cyl->radius);
+                if (!frustum_test_aabb(&frustum, &cyl_bounds)) continue;
                 Vec3 cyl_center = vec3(cyl->x, cyl->height / 2.0f, cyl->z);
                 debug_draw_cylinder(cyl_center, cyl->radius, cyl->height / 2.0f, vec3(1.0f, 0.5f, 0.0f));
             }
@@ -2181,10 +2172,34 @@ int main(int argc, char** argv) {
         axis_gizmo_render(&axis_gizmo, &view, viewport_width, platform.height);
 
         // Render stats overlay (top-right of 3D viewport)
-        char stats[128];
-        snprintf(stats, sizeof(stats), "FPS: %.0f  Parts: %zu  Tris: %u",
-                 current_fps, parts.size(), total_triangles);
-        text_render_right(stats, 10.0f, 10.0f, viewport_width, platform.height);
+        char stats[256];
+        char sim_status[64];
+        if (replaying) {
+            snprintf(sim_status, sizeof(sim_status), "Replay: %.1f/%.1f s%s", replay_time, replay_duration(&replay),
+                     replay_paused ? " (paused)" : "");
+        } else if (viewer) {
+            const char* state = net_stream_viewer_ended(viewer) ? " (ended)"
+                                : net_stream_viewer_idle(viewer) > 1.0 ? " (no data)" : "";
+            snprintf(sim_status, sizeof(sim_status), "View: %.1f s%s", replay_frame.time, state);
+        } else if (stream_server) {
+            int viewers;
+            {
+                std::lock_guard<std::mutex> guard(sim_control.lock);
+                viewers = sim_control.stream_stats.viewers;
+            }
+            snprintf(sim_status, sizeof(sim_status), "Sim: %.0f Hz  Viewers: %d",
+                     sim_thread ? sim_thread_step_rate(sim_thread) : 0.0f, viewers);
+        } else {
+            snprintf(sim_status, sizeof(sim_status), "Sim: %.0f Hz",
+                     sim_thread ? sim_thread_step_rate(sim_thread) : 0.0f);
+        }
+        snprintf(stats, sizeof(stats), "FPS: %.0f  %s  Parts: %u/%zu  Draws: %u  Binds: %u/%u  Tris: %llu/%u",
+                 current_fps, sim_status, mesh_store.visible_count, parts.size(), part_draws.draw_calls,
+                 scene_queue.stats.program_binds, scene_queue.stats.vao_binds,
+                 (unsigned long long)part_draws.triangles, world.total_triangles);
+        text_layer_begin(stats_layer);
+        text_layer_add_right(stats_layer, stats, 10.0f, 10.0f, viewport_width);
+        text_layer_render(stats_layer, viewport_width, platform.height, &frame_arena);
 
         // =========================================================
         // Render UI Panel (left side) - switch to full screen viewport
@@ -2200,21 +2215,22 @@ int main(int argc, char** argv) {
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);  // Restore default clear color
         glDisable(GL_SCISSOR_TEST);
 
-        // Panel text rendering (font is 8px * 1.25 scale = 10px)
+        // Panel text (font is 8px * 1.25 scale = 10px), retained between frames
+        text_layer_begin(panel_layer);
         float panel_x = 8.0f;
         float panel_y = 8.0f;
         float line_height = 12.0f;
 
         // Header
-        text_render("GAMEPAD", panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, "GAMEPAD", panel_x, panel_y);
         panel_y += line_height + 4.0f;
 
         // Connection status
         char line[64];
         if (gamepad.connected) {
-            text_render("Connected", panel_x, panel_y, platform.width, platform.height);
+            text_layer_add(panel_layer, "Connected", panel_x, panel_y);
         } else {
-            text_render("Not Connected", panel_x, panel_y, platform.width, platform.height);
+            text_layer_add(panel_layer, "Not Connected", panel_x, panel_y);
         }
         panel_y += line_height;
 
@@ -2223,25 +2239,25 @@ int main(int argc, char** argv) {
             char short_name[20];
             strncpy(short_name, gamepad.name, 19);
             short_name[19] = '\0';
-            text_render(short_name, panel_x, panel_y, platform.width, platform.height);
+            text_layer_add(panel_layer, short_name, panel_x, panel_y);
             panel_y += line_height;
         }
         panel_y += 8.0f;  // spacing
 
         // Axes section
-        text_render("Axes", panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, "Axes", panel_x, panel_y);
         panel_y += line_height;
 
         snprintf(line, sizeof(line), "A:%4d  B:%4d", gamepad.axes.a, gamepad.axes.b);
-        text_render(line, panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
         panel_y += line_height;
 
         snprintf(line, sizeof(line), "C:%4d  D:%4d", gamepad.axes.c, gamepad.axes.d);
-        text_render(line, panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
         panel_y += line_height + 8.0f;
 
         // Buttons section
-        text_render("Buttons", panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, "Buttons", panel_x, panel_y);
         panel_y += line_height;
 
         snprintf(line, sizeof(line), "L: %s %s  R: %s %s",
@@ -2249,7 +2265,7 @@ int main(int argc, char** argv) {
                  gamepad.buttons.l_down ? "D" : "-",
                  gamepad.buttons.r_up ? "U" : "-",
                  gamepad.buttons.r_down ? "D" : "-");
-        text_render(line, panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
         panel_y += line_height;
 
         snprintf(line, sizeof(line), "E: %s %s  F: %s %s",
@@ -2257,11 +2273,11 @@ int main(int argc, char** argv) {
                  gamepad.buttons.e_down ? "D" : "-",
                  gamepad.buttons.f_up ? "U" : "-",
                  gamepad.buttons.f_down ? "D" : "-");
-        text_render(line, panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
         panel_y += line_height + 12.0f;
 
         // Active robot section
-        text_render("ROBOT", panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, "ROBOT", panel_x, panel_y);
         panel_y += line_height + 4.0f;
 
         if (active_robot_index >= 0 && active_robot_index < (int)scene.robot_count) {
@@ -2274,53 +2290,156 @@ int main(int argc, char** argv) {
             if (ext) *ext = '\0';
 
             snprintf(line, sizeof(line), "[%d] %s", active_robot_index + 1, robot_name);
-            text_render(line, panel_x, panel_y, platform.width, platform.height);
+            text_layer_add(panel_layer, line, panel_x, panel_y);
             panel_y += line_height;
 
+            // Live drivetrain telemetry
+            for (const RobotInstance& robot : robots) {
+                if (robot.scene_index != active_robot_index) continue;
+                const Drivetrain* dt = &robot.drivetrain;
+                snprintf(line, sizeof(line), "Motors L:%4.0f R:%4.0f", dt->left_motor_pct, dt->right_motor_pct);
+                text_layer_add(panel_layer, line, panel_x, panel_y);
+                panel_y += line_height;
+                snprintf(line, sizeof(line), "Wheels L:%5.1f R:%5.1f", dt->left_wheel_vel, dt->right_wheel_vel);
+                text_layer_add(panel_layer, line, panel_x, panel_y);
+                panel_y += line_height;
+                break;
+            }
+
             if (active->has_program) {
-                text_render("Program: Active", panel_x, panel_y, platform.width, platform.height);
+                text_layer_add(panel_layer, "Program: Active", panel_x, panel_y);
             } else {
-                text_render("Program: None", panel_x, panel_y, platform.width, platform.height);
+                text_layer_add(panel_layer, "Program: None", panel_x, panel_y);
             }
             panel_y += line_height;
         } else {
-            text_render("None selected", panel_x, panel_y, platform.width, platform.height);
+            text_layer_add(panel_layer, "None selected", panel_x, panel_y);
             panel_y += line_height;
         }
         panel_y += 4.0f;
 
         // Robot list hint
         snprintf(line, sizeof(line), "Press 1-%u to switch", scene.robot_count > 4 ? 4 : scene.robot_count);
-        text_render(line, panel_x, panel_y, platform.width, platform.height);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height + 12.0f;
+
+        // Work counters of the newest physics step
+        const SimStepStats& step_stats = world.stats;
+        text_layer_add(panel_layer, "PHYSICS", panel_x, panel_y);
+        panel_y += line_height + 4.0f;
+        snprintf(line, sizeof(line), "Pairs    %u%s", step_stats.broadphase_pairs,
+                 step_stats.broadphase_builds > 0 ? " (rebuilt)" : "");
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height;
+        snprintf(line, sizeof(line), "Submodel %u/%u", step_stats.submodel_hits, step_stats.submodel_tests);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height;
+        snprintf(line, sizeof(line), "Part SAT %u", step_stats.part_tests);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height;
+        snprintf(line, sizeof(line), "Iters    %u/%d", step_stats.response_iterations, SIM_RESPONSE_ITERATIONS);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height;
+        snprintf(line, sizeof(line), "Moved    %u cyl", step_stats.cylinders_moved);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height;
+        snprintf(line, sizeof(line), "Asleep   %u rob %u cyl", step_stats.robots_asleep, step_stats.cylinders_asleep);
+        text_layer_add(panel_layer, line, panel_x, panel_y);
+        panel_y += line_height;
+        if (gpu_field.valid) {
+            snprintf(line, sizeof(line), "GPU      %u pcs %u near", gpu_field.count, gpu_field.contact_count);
+            text_layer_add(panel_layer, line, panel_x, panel_y);
+            panel_y += line_height;
+        }
+        panel_y += 12.0f;
+
+        // Profiler breakdown: ms per call over the last half second
+        // and share of wall time (sim zones run on the simulation thread)
+        if (PROFILE_ENABLED) {
+            text_layer_add(panel_layer, "PROFILE", panel_x, panel_y);
+            panel_y += line_height + 4.0f;
+            snprintf(line, sizeof(line), "Allocs   %.1f/frame",
+                     profile_frames > 0 ? (double)profile.allocations / profile_frames : 0.0);
+            text_layer_add(panel_layer, line, panel_x, panel_y);
+            panel_y += line_height;
+            snprintf(line, sizeof(line), "Arena    %zu/%zu KB", frame_arena.peak / 1024, frame_arena.capacity / 1024);
+            text_layer_add(panel_layer, line, panel_x, panel_y);
+            panel_y += line_height;
+            for (int i = 0; i < profile.zone_count; i++) {
+                const ProfilerZoneStats* zone = &profile.zones[i];
+                if (zone->calls == 0) continue;
+                double share = profile.window_sec > 0.0 ? zone->total_ms / (profile.window_sec * 10.0) : 0.0;
+                snprintf(line, sizeof(line), "%-9s%5.2f %3.0f%%", zone->name, zone->avg_ms, share);
+                text_layer_add(panel_layer, line, panel_x, panel_y);
+                panel_y += line_height;
+            }
+        }
+        text_layer_render(panel_layer, platform.width, platform.height, &frame_arena);
 
         glEnable(GL_DEPTH_TEST);
+        PROFILE_END(render);
+
+        // Robot cameras (images for the sim thread to send with its next tick)
+        if (cameras) {
+            PROFILE_BEGIN(camera, "cameras");
+            camera_rig_render(&camera_rig, &world, current_time);
+            std::vector<CameraImage> camera_images;
+            camera_rig_collect(&camera_rig, &world, &camera_images);
+            if (!camera_images.empty()) {
+                std::lock_guard<std::mutex> guard(sim_control.lock);
+                for (CameraImage& image : camera_images) sim_control.camera_images.push_back(std::move(image));
+            }
+            PROFILE_END(camera);
+        }
 
         // Swap buffers
+        PROFILE_BEGIN(swap, "swap");
         platform_swap_buffers(&platform);
+        arena_reset(&frame_arena);
+        PROFILE_END(swap);
+
+        // Optional frame cap (simulation results don't depend on it)
+        if (max_fps > 0.0f) {
+            double frame_end = current_time + 1.0 / max_fps;
+            double remaining = frame_end - platform_get_time();
+            if (remaining > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+        }
     }
 
+    // Stop physics before tearing down the bridges it ticks, then finish
+    // the recording it fed
+    sim_thread_stop(sim_thread);
+    sim_snapshot_ring_free(&sim_control.history);
+    replay_writer_close(recorder);
+    net_stream_server_close(stream_server);
+    if (replaying) replay_close(&replay);
+    net_stream_viewer_close(viewer);
+    if (trace_path) profiler_trace_write(trace_path);
+    if (PROFILE_ENABLED) arena_report(&frame_arena);
+    arena_destroy(&frame_arena);
+
     // Cleanup
-    for (auto& pair : mesh_cache) {
-        if (pair.second) {
-            mesh_destroy(pair.second);
-            delete pair.second;
-        }
+    for (Mesh* mesh : mesh_store.meshes) {
+        mesh_destroy(mesh);
+        delete mesh;
     }
-    mesh_cache.clear();
-    parts.clear();
+    mesh_store.meshes.clear();
 
+    mesh_instancing_destroy();
     shader_destroy(&mesh_shader);
+    render_queue_destroy(&scene_queue);
+    if (cameras) camera_rig_destroy(&camera_rig);
+    if (gpu_field.valid) gpu_field_destroy(&gpu_field);
+    text_layer_destroy(panel_layer);
+    text_layer_destroy(stats_layer);
     text_destroy();
     debug_destroy();
 
     // Cleanup Python bridges
-    for (auto& robot : robots) {
-        if (robot.bridge) {
-            python_bridge_destroy(robot.bridge);
-            delete robot.bridge;
-            robot.bridge = nullptr;
-        }
-    }
+    destroy_bridges(bridges, bridge_reactor, python_pool);
+    sim_world_destroy(&sim);
+    sim_world_destroy(&world);
+    scene_free(&scene);
 
     gamepad_destroy(&gamepad);
     axis_gizmo_destroy(&axis_gizmo);
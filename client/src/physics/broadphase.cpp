@@ -0,0 +1,226 @@
+/*
+ * Broad Phase Implementation
+ */
+
+#include "broadphase.h"
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+// Cell column/row for a coordinate, clamped to the grid
+// (bodies outside the field are binned into the edge cells)
+static int cell_coord(float v, float half_extent, int count) {
+    int c = (int)((v + half_extent) / BROADPHASE_CELL_SIZE);
+    if (c < 0) return 0;
+    if (c >= count) return count - 1;
+    return c;
+}
+
+static bool bodies_overlap(const BroadphaseBody* a, const BroadphaseBody* b) {
+    return a->min_x <= b->max_x && a->max_x >= b->min_x &&
+           a->min_z <= b->max_z && a->max_z >= b->min_z;
+}
+
+static int compare_pairs(const void* pa, const void* pb) {
+    const BroadphasePair* a = (const BroadphasePair*)pa;
+    const BroadphasePair* b = (const BroadphasePair*)pb;
+    if (a->a != b->a) return (int)a->a - (int)b->a;
+    return (int)a->b - (int)b->b;
+}
+
+// Grow a malloc'd array to hold at least needed elements
+static bool grow_array(void** data, uint32_t* capacity, uint32_t needed, size_t elem_size) {
+    if (needed <= *capacity) return true;
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < needed) new_capacity *= 2;
+    void* grown = realloc(*data, (size_t)new_capacity * elem_size);
+    if (!grown) return false;
+    *data = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static void add_pair(Broadphase* bp, int a, int b) {
+    if (!grow_array((void**)&bp->pairs, &bp->pair_capacity, (uint32_t)bp->pair_count + 1, sizeof(BroadphasePair))) {
+        return;
+    }
+    BroadphasePair* pair = &bp->pairs[bp->pair_count++];
+    pair->a = (uint32_t)(a < b ? a : b);
+    pair->b = (uint32_t)(a < b ? b : a);
+}
+
+void broadphase_begin(Broadphase* bp, float field_half_width, float field_half_depth) {
+    bp->half_width = field_half_width;
+    bp->half_depth = field_half_depth;
+
+    bp->cols = (int)(2.0f * field_half_width / BROADPHASE_CELL_SIZE) + 1;
+    bp->rows = (int)(2.0f * field_half_depth / BROADPHASE_CELL_SIZE) + 1;
+    if (bp->cols > BROADPHASE_MAX_COLS) bp->cols = BROADPHASE_MAX_COLS;
+    if (bp->rows > BROADPHASE_MAX_ROWS) bp->rows = BROADPHASE_MAX_ROWS;
+    if (bp->cols < 1) bp->cols = 1;
+    if (bp->rows < 1) bp->rows = 1;
+
+    bp->body_count = 0;
+    bp->pair_count = 0;
+    bp->brute_force = false;
+}
+
+int broadphase_add(Broadphase* bp, BroadphaseBodyType type, int index,
+                   float min_x, float min_z, float max_x, float max_z) {
+    if (!grow_array((void**)&bp->bodies, &bp->body_capacity, (uint32_t)bp->body_count + 1, sizeof(BroadphaseBody))) {
+        return -1;
+    }
+
+    BroadphaseBody* body = &bp->bodies[bp->body_count];
+    body->min_x = min_x - BROADPHASE_MARGIN;
+    body->min_z = min_z - BROADPHASE_MARGIN;
+    body->max_x = max_x + BROADPHASE_MARGIN;
+    body->max_z = max_z + BROADPHASE_MARGIN;
+    body->type = type;
+    body->index = index;
+
+    body->walls = 0;
+    if (body->min_x <= -bp->half_width) body->walls |= BROADPHASE_WALL_LEFT;
+    if (body->max_x >=  bp->half_width) body->walls |= BROADPHASE_WALL_RIGHT;
+    if (body->min_z <= -bp->half_depth) body->walls |= BROADPHASE_WALL_BACK;
+    if (body->max_z >=  bp->half_depth) body->walls |= BROADPHASE_WALL_FRONT;
+
+    return bp->body_count++;
+}
+
+void broadphase_build(Broadphase* bp) {
+    int cell_count = bp->cols * bp->rows;
+    bp->pair_count = 0;
+
+    // Count entries per cell
+    uint32_t counts[BROADPHASE_MAX_COLS * BROADPHASE_MAX_ROWS];
+    memset(counts, 0, sizeof(counts));
+    uint32_t total = 0;
+    for (int i = 0; i < bp->body_count; i++) {
+        const BroadphaseBody* body = &bp->bodies[i];
+        int c0 = cell_coord(body->min_x, bp->half_width, bp->cols);
+        int c1 = cell_coord(body->max_x, bp->half_width, bp->cols);
+        int r0 = cell_coord(body->min_z, bp->half_depth, bp->rows);
+        int r1 = cell_coord(body->max_z, bp->half_depth, bp->rows);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                counts[r * bp->cols + c]++;
+            }
+        }
+        total += (uint32_t)((c1 - c0 + 1) * (r1 - r0 + 1));
+    }
+
+    bp->brute_force = !grow_array((void**)&bp->entries, &bp->entry_capacity, total, sizeof(uint32_t));
+    if (bp->brute_force) {
+        // No room for the cell references - fall back to testing every pair
+        for (int i = 0; i < bp->body_count; i++) {
+            for (int j = i + 1; j < bp->body_count; j++) {
+                if (bodies_overlap(&bp->bodies[i], &bp->bodies[j])) add_pair(bp, i, j);
+            }
+        }
+        return;
+    }
+
+    // Prefix sum, then fill cells
+    bp->cell_start[0] = 0;
+    for (int c = 0; c < cell_count; c++) {
+        bp->cell_start[c + 1] = bp->cell_start[c] + counts[c];
+        counts[c] = bp->cell_start[c];  // Reuse as write cursor
+    }
+    for (int i = 0; i < bp->body_count; i++) {
+        const BroadphaseBody* body = &bp->bodies[i];
+        int c0 = cell_coord(body->min_x, bp->half_width, bp->cols);
+        int c1 = cell_coord(body->max_x, bp->half_width, bp->cols);
+        int r0 = cell_coord(body->min_z, bp->half_depth, bp->rows);
+        int r1 = cell_coord(body->max_z, bp->half_depth, bp->rows);
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                bp->entries[counts[r * bp->cols + c]++] = (uint32_t)i;
+            }
+        }
+    }
+
+    // Test pairs within each cell. A pair sharing several cells is only
+    // reported from the cell holding the max corner of both mins.
+    for (int r = 0; r < bp->rows; r++) {
+        for (int c = 0; c < bp->cols; c++) {
+            int cell = r * bp->cols + c;
+            for (uint32_t ei = bp->cell_start[cell]; ei < bp->cell_start[cell + 1]; ei++) {
+                const BroadphaseBody* a = &bp->bodies[bp->entries[ei]];
+                for (uint32_t ej = ei + 1; ej < bp->cell_start[cell + 1]; ej++) {
+                    const BroadphaseBody* b = &bp->bodies[bp->entries[ej]];
+                    if (!bodies_overlap(a, b)) continue;
+
+                    float owner_x = a->min_x > b->min_x ? a->min_x : b->min_x;
+                    float owner_z = a->min_z > b->min_z ? a->min_z : b->min_z;
+                    if (cell_coord(owner_x, bp->half_width, bp->cols) != c ||
+                        cell_coord(owner_z, bp->half_depth, bp->rows) != r) continue;
+
+                    add_pair(bp, (int)bp->entries[ei], (int)bp->entries[ej]);
+                }
+            }
+        }
+    }
+
+    // Deterministic order regardless of cell layout
+    if (bp->pair_count > 1) qsort(bp->pairs, bp->pair_count, sizeof(BroadphasePair), compare_pairs);
+}
+
+void broadphase_free(Broadphase* bp) {
+    free(bp->bodies);
+    free(bp->pairs);
+    free(bp->entries);
+    bp->bodies = NULL;
+    bp->pairs = NULL;
+    bp->entries = NULL;
+    bp->body_count = bp->pair_count = 0;
+    bp->body_capacity = bp->pair_capacity = bp->entry_capacity = 0;
+}
+
+// Next cell boundary along one axis and the t step between boundaries
+// (FLT_MAX once the ray runs parallel or off the grid on this axis)
+static void ray_axis_setup(float v, float d, float half_extent, int cell, int count,
+                           int* step, float* t_next, float* t_delta) {
+    *step = d > 0.0f ? 1 : -1;
+    bool off_grid = (d > 0.0f && cell == count - 1) || (d < 0.0f && cell == 0);
+    if (d == 0.0f || off_grid) {
+        *t_next = FLT_MAX;
+        *t_delta = FLT_MAX;
+        return;
+    }
+    float boundary = -half_extent + (float)(cell + (d > 0.0f ? 1 : 0)) * BROADPHASE_CELL_SIZE;
+    *t_next = (boundary - v) / d;
+    *t_delta = BROADPHASE_CELL_SIZE / (d > 0.0f ? d : -d);
+}
+
+int broadphase_ray_cells(const Broadphase* bp, float x, float z, float dx, float dz, float max_t,
+                         int* cells, float* exits, int max_cells) {
+    if (bp->brute_force || max_cells <= 0) return 0;
+
+    int c = cell_coord(x, bp->half_width, bp->cols);
+    int r = cell_coord(z, bp->half_depth, bp->rows);
+    int step_c, step_r;
+    float next_c, next_r, delta_c, delta_r;
+    ray_axis_setup(x, dx, bp->half_width, c, bp->cols, &step_c, &next_c, &delta_c);
+    ray_axis_setup(z, dz, bp->half_depth, r, bp->rows, &step_r, &next_r, &delta_r);
+
+    int count = 0;
+    while (count < max_cells) {
+        float exit = next_c < next_r ? next_c : next_r;
+        if (exit > max_t) exit = max_t;
+        cells[count] = r * bp->cols + c;
+        exits[count] = exit;
+        count++;
+        if (exit >= max_t) break;
+
+        // Step into the neighbor; an axis that reaches the grid edge stays there
+        if (next_c < next_r) {
+            c += step_c;
+            next_c = (c == 0 || c == bp->cols - 1) ? FLT_MAX : next_c + delta_c;
+        } else {
+            r += step_r;
+            next_r = (r == 0 || r == bp->rows - 1) ? FLT_MAX : next_r + delta_r;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,119 @@
+/*
+ * Broad Phase (uniform grid over the field)
+ *
+ * Finds candidate collision pairs between robots and cylinders so the
+ * narrow phase (submodel/part OBB tests) only runs where bodies are close.
+ *
+ * Usage (once per collision pass):
+ *   broadphase_begin(&bp, field_half_width, field_half_depth);
+ *   broadphase_add(&bp, BROADPHASE_ROBOT, i, min_x, min_z, max_x, max_z);
+ *   broadphase_add(&bp, BROADPHASE_CYLINDER, c, ...);
+ *   broadphase_build(&bp);   // fills bp.pairs, sorted by body index
+ *
+ * Bodies are kept in insertion order and pairs are sorted (a < b), so
+ * callers that add robots first then cylinders see pairs in the same order
+ * as the old nested loops.
+ *
+ * Bodies, pairs and cell entries are growable arrays kept across passes, so
+ * after the first few passes a broad phase doesn't allocate; release them
+ * with broadphase_free(). A Broadphase must start zeroed.
+ *
+ * Wall contact is a per-body flag mask: a body can only touch a wall if
+ * its AABB reaches that field edge.
+ *
+ * Ray queries walk the grid cells a ray crosses, nearest first, so a caller
+ * can stop once it has a hit closer than the next cell:
+ *   int n = broadphase_ray_cells(&bp, x, z, dx, dz, max_t, cells, exits, BROADPHASE_MAX_RAY_CELLS);
+ *   for cell i: bodies are bp.entries[bp.cell_start[cells[i]] .. bp.cell_start[cells[i] + 1])
+ */
+
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BROADPHASE_CELL_SIZE 12.0f    // Inches (VEX IQ field = 8 x 6 cells)
+#define BROADPHASE_MAX_COLS 16
+#define BROADPHASE_MAX_ROWS 16
+#define BROADPHASE_MAX_RAY_CELLS (BROADPHASE_MAX_COLS + BROADPHASE_MAX_ROWS)  // Cells one ray can cross
+
+// Bodies are grown by this much (inches) so pairs created by position
+// corrections later in the same pass are still found
+#define BROADPHASE_MARGIN 1.0f
+
+// Wall flags (match wall order used by the collision passes)
+#define BROADPHASE_WALL_LEFT  (1 << 0)  // -X
+#define BROADPHASE_WALL_RIGHT (1 << 1)  // +X
+#define BROADPHASE_WALL_BACK  (1 << 2)  // -Z
+#define BROADPHASE_WALL_FRONT (1 << 3)  // +Z
+
+typedef enum {
+    BROADPHASE_ROBOT,
+    BROADPHASE_CYLINDER
+} BroadphaseBodyType;
+
+// Body footprint on the XZ plane
+typedef struct {
+    float min_x, min_z;
+    float max_x, max_z;
+    BroadphaseBodyType type;
+    int index;          // Index into robots/cylinders array
+    uint8_t walls;      // BROADPHASE_WALL_* flags this body may touch
+} BroadphaseBody;
+
+// Candidate pair (indices into Broadphase::bodies, a < b)
+typedef struct {
+    uint32_t a, b;
+} BroadphasePair;
+
+typedef struct {
+    float half_width, half_depth;
+    int cols, rows;
+
+    BroadphaseBody* bodies;
+    int body_count;
+    uint32_t body_capacity;
+
+    BroadphasePair* pairs;
+    int pair_count;
+    uint32_t pair_capacity;
+
+    // Grid cells (counting sort: cell c holds entries[cell_start[c]..cell_start[c+1]))
+    uint32_t cell_start[BROADPHASE_MAX_COLS * BROADPHASE_MAX_ROWS + 1];
+    uint32_t* entries;
+    uint32_t entry_capacity;
+
+    bool brute_force;   // Out of memory for the grid - pairs were generated by testing all bodies
+} Broadphase;
+
+// Reset for a new pass over a field of the given half-size (inches)
+void broadphase_begin(Broadphase* bp, float field_half_width, float field_half_depth);
+
+// Add a body (AABB on the XZ plane, grown by BROADPHASE_MARGIN)
+// Returns body index, or -1 if out of memory
+int broadphase_add(Broadphase* bp, BroadphaseBodyType type, int index,
+                   float min_x, float min_z, float max_x, float max_z);
+
+// Bin bodies into the grid and collect overlapping pairs
+void broadphase_build(Broadphase* bp);
+
+// Release the body, pair and entry arrays
+void broadphase_free(Broadphase* bp);
+
+// Cells crossed by the ray (x, z) + t * (dx, dz), 0 <= t <= max_t, in order;
+// exits[i] is the t at which the ray leaves cells[i]. Positions outside the
+// field are in the edge cells, as bodies are binned. Returns the cell count
+// (0 if the grid was not built: brute_force is set).
+int broadphase_ray_cells(const Broadphase* bp, float x, float z, float dx, float dz, float max_t,
+                         int* cells, float* exits, int max_cells);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BROADPHASE_H
@@ -6,6 +6,7 @@
 #include <math.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 void collision_init(CollisionWorld* world, float field_width, float field_depth) {
     memset(world, 0, sizeof(CollisionWorld));
@@ -19,9 +20,30 @@ void collision_init(CollisionWorld* world, float field_width, float field_depth)
     printf("[Collision] Initialized field: %.0f x %.0f inches\n", field_width, field_depth);
 }
 
+void collision_free(CollisionWorld* world) {
+    free(world->robots);
+    free(world->cylinders);
+    world->robots = NULL;
+    world->cylinders = NULL;
+    world->robot_count = world->robot_capacity = 0;
+    world->cylinder_count = world->cylinder_capacity = 0;
+}
+
+// Grow a collider array to hold at least needed circles
+static bool grow_circles(CollisionCircle** circles, int* capacity, int needed) {
+    if (needed <= *capacity) return true;
+    int grown_capacity = *capacity ? *capacity : 16;
+    while (grown_capacity < needed) grown_capacity *= 2;
+    CollisionCircle* grown = (CollisionCircle*)realloc(*circles, (size_t)grown_capacity * sizeof(CollisionCircle));
+    if (!grown) return false;
+    *circles = grown;
+    *capacity = grown_capacity;
+    return true;
+}
+
 int collision_add_robot(CollisionWorld* world, float x, float z, float radius) {
-    if (world->robot_count >= COLLISION_MAX_ROBOTS) {
-        fprintf(stderr, "[Collision] Max robots reached\n");
+    if (!grow_circles(&world->robots, &world->robot_capacity, world->robot_count + 1)) {
+        fprintf(stderr, "[Collision] Out of memory for robots\n");
         return -1;
     }
 
@@ -39,8 +61,8 @@ int collision_add_robot(CollisionWorld* world, float x, float z, float radius) {
 }
 
 int collision_add_cylinder(CollisionWorld* world, float x, float z, float radius) {
-    if (world->cylinder_count >= COLLISION_MAX_CYLINDERS) {
-        fprintf(stderr, "[Collision] Max cylinders reached\n");
+    if (!grow_circles(&world->cylinders, &world->cylinder_capacity, world->cylinder_count + 1)) {
+        fprintf(stderr, "[Collision] Out of memory for cylinders\n");
         return -1;
     }
 
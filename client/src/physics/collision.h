@@ -16,9 +16,6 @@
 extern "C" {
 #endif
 
-#define COLLISION_MAX_ROBOTS 16
-#define COLLISION_MAX_CYLINDERS 32
-
 // Collision body types
 typedef enum {
     COLLISION_BODY_ROBOT,
@@ -40,18 +37,23 @@ typedef struct {
     float min_z, max_z;
 } CollisionField;
 
-// Collision world
+// Collision world (robots and cylinders grow as they are added)
 typedef struct {
     CollisionField field;
-    CollisionCircle robots[COLLISION_MAX_ROBOTS];
+    CollisionCircle* robots;
     int robot_count;
-    CollisionCircle cylinders[COLLISION_MAX_CYLINDERS];
+    int robot_capacity;
+    CollisionCircle* cylinders;
     int cylinder_count;
+    int cylinder_capacity;
 } CollisionWorld;
 
 // Initialize collision world with field boundaries
 void collision_init(CollisionWorld* world, float field_width, float field_depth);
 
+// Release the colliders (the world can be initialized again)
+void collision_free(CollisionWorld* world);
+
 // Add a robot collider (returns index, or -1 on failure)
 int collision_add_robot(CollisionWorld* world, float x, float z, float radius);
 
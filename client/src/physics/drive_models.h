@@ -0,0 +1,314 @@
+/*
+ * Drive Models
+ * One force-based kernel per robotdef drivetrain type, specialized at compile
+ * time so a batch of robots of one type steps without per-robot branches.
+ *
+ *   Tank       Left and right wheel sides, torque from their difference
+ *              (the model of drivetrain_update)
+ *   Mecanum    Tank plus a strafe command; the rollers lose some of the
+ *              sideways force
+ *   Omni       X-drive: wheels at 45 degrees, so both axes see a share of
+ *              every wheel's force at a higher top speed
+ *   Ackermann  One throttle on the rear axle; the command difference steers
+ *              the front wheels and the yaw rate follows the steering geometry,
+ *              plus whatever spin collisions add (Drivetrain::yaw_slip)
+ *
+ * Inputs map onto the two motor commands (and strafe_motor_pct for holonomic
+ * drives). For Ackermann, throttle = (left + right) / 2 and
+ * steer = (right - left) / 2, so a tank-style controller still turns it.
+ *
+ * The type is chosen once per robot at load time (RobotInstance::drive_type).
+ * SimWorld groups its robots into one DriveBatch per type, holding the
+ * per-robot constants derived from DrivetrainConfig as arrays, and runs
+ * drive_step<Type> over each batch.
+ *
+ *   DriveCoeffs coeffs = drive_coeffs(&dt);
+ *   drive_step<DRIVETRAIN_MECANUM>(&dt, coeffs, 1.0f / 240.0f);
+ */
+
+#ifndef DRIVE_MODELS_H
+#define DRIVE_MODELS_H
+
+#include "drivetrain.h"
+#include "physics_config.h"
+#include "robotdef.h"
+#include <math.h>
+#include <stddef.h>
+#include <vector>
+
+// Drive kernels, one per DrivetrainType after DRIVETRAIN_UNKNOWN
+#define DRIVE_MODEL_COUNT 4
+
+// Unknown drivetrains (no robotdef, or an unnamed type) drive as tanks
+static inline DrivetrainType drive_model_type(DrivetrainType type) {
+    return type == DRIVETRAIN_UNKNOWN ? DRIVETRAIN_TANK : type;
+}
+
+// DriveBatch slot of a drivetrain type
+static inline int drive_model_index(DrivetrainType type) {
+    return (int)drive_model_type(type) - (int)DRIVETRAIN_TANK;
+}
+
+// Per-robot constants of a drive kernel, from DrivetrainConfig and friction
+struct DriveCoeffs {
+    float wheel_radius;        // inches
+    float max_wheel_velocity;  // Wheel surface speed at no-load RPM (in/s)
+    float max_friction;        // Grip of one side's wheels (lbf)
+    float mass_slugs;
+    float moment_of_inertia;
+    float track_half;          // inches
+    float forward_scale;
+    float turn_scale;
+    float wheelbase;           // Ackermann: front to rear axle (inches)
+    float max_steer_angle;     // Ackermann: front wheel angle at full steer (radians)
+};
+
+// Compile-time properties of a drive type (tank by default)
+template <DrivetrainType Type>
+struct DriveTraits {
+    static constexpr bool holonomic = false;     // Takes strafe_motor_pct
+    static constexpr bool steered = false;       // Yaw from steering geometry, not wheel torque
+    static constexpr float forward_ratio = 1.0f; // Wheel surface speed per robot forward speed
+    static constexpr float strafe_ratio = 0.0f;  // Wheel surface speed per robot sideways speed
+    static constexpr float strafe_efficiency = 0.0f;
+};
+
+template <>
+struct DriveTraits<DRIVETRAIN_MECANUM> {
+    static constexpr bool holonomic = true;
+    static constexpr bool steered = false;
+    static constexpr float forward_ratio = 1.0f;
+    static constexpr float strafe_ratio = 1.0f;
+    static constexpr float strafe_efficiency = VEXIQ_MECANUM_STRAFE_EFFICIENCY;
+};
+
+template <>
+struct DriveTraits<DRIVETRAIN_OMNI> {
+    static constexpr bool holonomic = true;
+    static constexpr bool steered = false;
+    static constexpr float forward_ratio = 0.70710678f;  // cos(45°)
+    static constexpr float strafe_ratio = 0.70710678f;
+    static constexpr float strafe_efficiency = 1.0f;
+};
+
+template <>
+struct DriveTraits<DRIVETRAIN_ACKERMANN> {
+    static constexpr bool holonomic = false;
+    static constexpr bool steered = true;
+    static constexpr float forward_ratio = 1.0f;
+    static constexpr float strafe_ratio = 0.0f;
+    static constexpr float strafe_efficiency = 0.0f;
+};
+
+inline DriveCoeffs drive_coeffs(const Drivetrain* dt) {
+    const DrivetrainConfig& config = dt->config;
+    DriveCoeffs c;
+    c.wheel_radius = config.wheel_diameter / 2.0f;
+    c.max_wheel_velocity = (config.max_rpm / 60.0f) * (3.14159265358979323846f * config.wheel_diameter);
+    // Weight per side (four wheels, two per side); lbf = lbs in imperial units
+    c.max_friction = (config.robot_mass / 2.0f) * dt->friction_coeff;
+    c.mass_slugs = config.robot_mass / 386.1f;
+    c.moment_of_inertia = config.moment_of_inertia;
+    c.track_half = config.track_width / 2.0f;
+    c.forward_scale = config.forward_speed_scale;
+    c.turn_scale = config.turn_speed_scale;
+    c.wheelbase = config.wheelbase;
+    c.max_steer_angle = config.max_steer_angle;
+    return c;
+}
+
+// Motor force at the wheel surface: a linear torque curve, full stall torque
+// at rest and none at the no-load speed
+inline float drive_motor_force(float percent, float wheel_speed, const DriveCoeffs& c) {
+    float speed_ratio = wheel_speed / c.max_wheel_velocity;
+    if (speed_ratio > 1.0f) speed_ratio = 1.0f;
+    float available_torque = VEXIQ_MOTOR_STALL_TORQUE * (1.0f - speed_ratio);
+    return (percent / 100.0f) * (available_torque / c.wheel_radius);
+}
+
+// Clamp a wheel force to the friction limit (the wheels slip past it)
+inline float drive_grip(float force, float max_friction, bool* slipping) {
+    *slipping = fabsf(force) > max_friction;
+    if (*slipping) return (force > 0) ? max_friction : -max_friction;
+    return force;
+}
+
+// Advance one drivetrain by dt_sec with the Type model
+template <DrivetrainType Type>
+inline void drive_step(Drivetrain* dt, const DriveCoeffs& c, float dt_sec) {
+    typedef DriveTraits<Type> Traits;
+    const float pi = 3.14159265358979323846f;
+
+    float cos_h = cosf(dt->heading);
+    float sin_h = sinf(dt->heading);
+
+    // Current velocity in robot frame (forward = +Z)
+    float vel_forward = dt->vel_z * cos_h + dt->vel_x * sin_h;
+    float vel_lateral = -dt->vel_z * sin_h + dt->vel_x * cos_h;
+
+    // Wheel forces, limited by friction, into robot-frame force and torque
+    float forward_force, drive_torque = 0.0f;
+    float steer_rate = 0.0f;   // Ackermann: yaw rate per unit forward speed
+    if constexpr (Traits::steered) {
+        float throttle = (dt->left_motor_pct + dt->right_motor_pct) * 0.5f;
+        float steer = (dt->right_motor_pct - dt->left_motor_pct) * 0.5f;
+        float force = drive_motor_force(throttle, fabsf(dt->linear_velocity), c) * 2.0f;
+        forward_force = drive_grip(force, c.max_friction * 2.0f, &dt->left_wheels_slipping);
+        dt->right_wheels_slipping = dt->left_wheels_slipping;
+        forward_force *= c.forward_scale;
+        steer_rate = tanf((steer / 100.0f) * c.max_steer_angle) / c.wheelbase;
+    } else {
+        // Speeds from last step's wheel velocities
+        float left_force = drive_grip(drive_motor_force(dt->left_motor_pct, fabsf(dt->left_wheel_vel), c),
+                                      c.max_friction, &dt->left_wheels_slipping);
+        float right_force = drive_grip(drive_motor_force(dt->right_motor_pct, fabsf(dt->right_wheel_vel), c),
+                                       c.max_friction, &dt->right_wheels_slipping);
+        forward_force = left_force + right_force;
+        drive_torque = (right_force - left_force) * c.track_half;
+        forward_force *= c.forward_scale;
+        drive_torque *= c.turn_scale;
+        if constexpr (Traits::forward_ratio != 1.0f) forward_force *= Traits::forward_ratio;
+    }
+
+    // External forces (collisions) from world to robot frame
+    float ext_forward = dt->ext_force_z * cos_h + dt->ext_force_x * sin_h;
+    float ext_lateral = -dt->ext_force_z * sin_h + dt->ext_force_x * cos_h;
+    forward_force += ext_forward;
+    float lateral_force = ext_lateral;   // Robot can be pushed sideways
+
+    if constexpr (Traits::holonomic) {
+        // Every wheel strafes: both sides' grip, through the rollers
+        float wheel_speed = fabsf(vel_lateral) * Traits::strafe_ratio;
+        float force = drive_motor_force(dt->strafe_motor_pct, wheel_speed, c) * 2.0f;
+        bool slipping;
+        force = drive_grip(force, c.max_friction * 2.0f, &slipping);
+        lateral_force += force * (Traits::strafe_ratio * Traits::strafe_efficiency) * c.forward_scale;
+        dt->left_wheels_slipping = dt->left_wheels_slipping || slipping;
+        dt->right_wheels_slipping = dt->right_wheels_slipping || slipping;
+    }
+
+    float total_torque = drive_torque + dt->ext_torque;
+    dt->ext_force_x = 0.0f;
+    dt->ext_force_z = 0.0f;
+    dt->ext_torque = 0.0f;
+
+    // F = ma, then integrate velocities with damping
+    vel_forward += (forward_force / c.mass_slugs) * dt_sec;
+    vel_lateral += (lateral_force / c.mass_slugs) * dt_sec;
+    // Ackermann: the steering sets the yaw rate, collision torque spins on top of it
+    float& spin = Traits::steered ? dt->yaw_slip : dt->angular_vel;
+    spin += (total_torque / c.moment_of_inertia) * dt_sec;
+
+    if constexpr (Traits::steered) {
+        // Tires resist sliding sideways up to their grip (mu * g)
+        float grip = dt->friction_coeff * 386.1f * dt_sec;
+        if (fabsf(vel_lateral) <= grip) vel_lateral = 0.0f;
+        else vel_lateral -= (vel_lateral > 0) ? grip : -grip;
+    }
+
+    vel_forward *= VEXIQ_LINEAR_DAMPING;
+    vel_lateral *= VEXIQ_LINEAR_DAMPING;
+    spin *= VEXIQ_ANGULAR_DAMPING;
+
+    // Unpowered VEX motors brake (back-EMF): stop quickly, and completely
+    // when very slow (prevents drift)
+    bool motors_off;
+    if constexpr (Traits::steered) {
+        motors_off = fabsf(dt->left_motor_pct + dt->right_motor_pct) * 0.5f < 1.0f;
+    } else {
+        motors_off = (fabsf(dt->left_motor_pct) < 1.0f && fabsf(dt->right_motor_pct) < 1.0f);
+        if constexpr (Traits::holonomic) motors_off = motors_off && fabsf(dt->strafe_motor_pct) < 1.0f;
+    }
+    if (motors_off) {
+        float brake_factor = 0.85f;
+        vel_forward *= brake_factor;
+        spin *= brake_factor;
+        if (fabsf(vel_forward) < 0.5f) vel_forward = 0.0f;
+        if (fabsf(spin) < 0.01f) spin = 0.0f;
+        if constexpr (Traits::holonomic) {
+            vel_lateral *= brake_factor;
+            if (fabsf(vel_lateral) < 0.5f) vel_lateral = 0.0f;
+        }
+    }
+
+    // Front wheels hold the yaw rate to the steering geometry
+    if constexpr (Traits::steered) dt->angular_vel = vel_forward * steer_rate + dt->yaw_slip;
+
+    // Back to world frame, then integrate the pose
+    dt->vel_x = vel_forward * sin_h + vel_lateral * cos_h;
+    dt->vel_z = vel_forward * cos_h - vel_lateral * sin_h;
+    dt->pos_x += dt->vel_x * dt_sec;
+    dt->pos_z += dt->vel_z * dt_sec;
+    dt->heading += dt->angular_vel * dt_sec;
+    while (dt->heading > pi) dt->heading -= 2.0f * pi;
+    while (dt->heading < -pi) dt->heading += 2.0f * pi;
+
+    // Derived values: forward speed and wheel surface velocities (animation)
+    dt->linear_velocity = vel_forward;
+    float wheel_forward = vel_forward;
+    if constexpr (Traits::forward_ratio != 1.0f) wheel_forward *= Traits::forward_ratio;
+    dt->left_wheel_vel = wheel_forward - dt->angular_vel * c.track_half;
+    dt->right_wheel_vel = wheel_forward + dt->angular_vel * c.track_half;
+}
+
+// Robots of one drive type, with their kernel constants as arrays (indexed
+// like robots)
+struct DriveBatch {
+    std::vector<int> robots;   // Robot indices
+    std::vector<float> wheel_radius;
+    std::vector<float> max_wheel_velocity;
+    std::vector<float> max_friction;
+    std::vector<float> mass_slugs;
+    std::vector<float> moment_of_inertia;
+    std::vector<float> track_half;
+    std::vector<float> forward_scale;
+    std::vector<float> turn_scale;
+    std::vector<float> wheelbase;
+    std::vector<float> max_steer_angle;
+};
+
+inline void drive_batch_clear(DriveBatch* batch) {
+    batch->robots.clear();
+    batch->wheel_radius.clear();
+    batch->max_wheel_velocity.clear();
+    batch->max_friction.clear();
+    batch->mass_slugs.clear();
+    batch->moment_of_inertia.clear();
+    batch->track_half.clear();
+    batch->forward_scale.clear();
+    batch->turn_scale.clear();
+    batch->wheelbase.clear();
+    batch->max_steer_angle.clear();
+}
+
+inline void drive_batch_add(DriveBatch* batch, int robot_index, const Drivetrain* dt) {
+    DriveCoeffs c = drive_coeffs(dt);
+    batch->robots.push_back(robot_index);
+    batch->wheel_radius.push_back(c.wheel_radius);
+    batch->max_wheel_velocity.push_back(c.max_wheel_velocity);
+    batch->max_friction.push_back(c.max_friction);
+    batch->mass_slugs.push_back(c.mass_slugs);
+    batch->moment_of_inertia.push_back(c.moment_of_inertia);
+    batch->track_half.push_back(c.track_half);
+    batch->forward_scale.push_back(c.forward_scale);
+    batch->turn_scale.push_back(c.turn_scale);
+    batch->wheelbase.push_back(c.wheelbase);
+    batch->max_steer_angle.push_back(c.max_steer_angle);
+}
+
+inline DriveCoeffs drive_batch_coeffs(const DriveBatch& batch, size_t k) {
+    DriveCoeffs c;
+    c.wheel_radius = batch.wheel_radius[k];
+    c.max_wheel_velocity = batch.max_wheel_velocity[k];
+    c.max_friction = batch.max_friction[k];
+    c.mass_slugs = batch.mass_slugs[k];
+    c.moment_of_inertia = batch.moment_of_inertia[k];
+    c.track_half = batch.track_half[k];
+    c.forward_scale = batch.forward_scale[k];
+    c.turn_scale = batch.turn_scale[k];
+    c.wheelbase = batch.wheelbase[k];
+    c.max_steer_angle = batch.max_steer_angle[k];
+    return c;
+}
+
+#endif // DRIVE_MODELS_H
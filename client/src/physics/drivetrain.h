@@ -2,6 +2,9 @@
  * Drivetrain Physics
  *
  * Force-based tank drive (differential drive) physics for VEX IQ robots.
+ * drivetrain_update() steps one robot as a tank; the mecanum, omni and
+ * Ackermann models, and the batched kernels the simulation steps, are in
+ * drive_models.h.
  *
  * Physics Model:
  *   - Motors apply torque to wheels
@@ -34,6 +37,10 @@ typedef struct {
     float max_rpm;          // Maximum motor RPM (typically 120 for VEX IQ)
     float robot_mass;       // Robot mass in pounds
     float moment_of_inertia; // Rotational inertia (slug·in²)
+    float forward_speed_scale; // Forward force scale for tuning feel (VEXIQ_FORWARD_SPEED_SCALE)
+    float turn_speed_scale;    // Turn torque scale (VEXIQ_TURN_SPEED_SCALE)
+    float wheelbase;           // Ackermann: front to rear axle (inches)
+    float max_steer_angle;     // Ackermann: front wheel angle at full steer (radians)
 } DrivetrainConfig;
 
 // Drivetrain state
@@ -44,11 +51,13 @@ typedef struct {
     // Motor commands (percentage -100 to +100)
     float left_motor_pct;
     float right_motor_pct;
+    float strafe_motor_pct; // Sideways command of holonomic drives (mecanum, omni)
 
     // Robot velocity (actual physics velocity, not motor command)
     float vel_x;            // X velocity (inches/s)
     float vel_z;            // Z velocity (inches/s) - forward axis
     float angular_vel;      // Angular velocity (radians/s)
+    float yaw_slip;         // Ackermann: collision spin on top of the steering yaw (radians/s)
 
     // Robot pose in world space
     float pos_x;            // X position (inches)
@@ -88,7 +97,11 @@ void drivetrain_init_config(Drivetrain* dt, const DrivetrainConfig* config);
 // This is how VEX IQ motors are controlled: motor.spin(FORWARD, 50, PERCENT)
 void drivetrain_set_motors(Drivetrain* dt, float left_percent, float right_percent);
 
-// Stop both motors
+// Set the sideways command of a holonomic drive (-100 to +100, positive = robot's
+// right, +X at heading 0); other drive types ignore it
+void drivetrain_set_strafe(Drivetrain* dt, float strafe_percent);
+
+// Stop all motors
 // mode: 0 = coast (let friction slow down), 1 = brake (active braking)
 void drivetrain_stop(Drivetrain* dt, int mode);
 
@@ -101,7 +114,7 @@ void drivetrain_apply_torque(Drivetrain* dt, float torque);
 // Set friction coefficient (from scene physics)
 void drivetrain_set_friction(Drivetrain* dt, float friction_coeff);
 
-// Update drivetrain physics
+// Update drivetrain physics as a tank drive (see drive_models.h for the others)
 // dt_sec: time step in seconds
 void drivetrain_update(Drivetrain* dt, float dt_sec);
 
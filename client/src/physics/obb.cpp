@@ -8,6 +8,7 @@
 #include "obb.h"
 #include <math.h>
 #include <float.h>
+#include <string.h>
 
 // Helper: absolute value
 static inline float absf(float x) { return x < 0 ? -x : x; }
@@ -44,6 +45,17 @@ void mat3_rotation_y(float angle_rad, float* out) {
     out[6] = -s; out[7] = 0;  out[8] = c;
 }
 
+void mat3_rotation_axis(const float* axis, float angle_rad, float* out) {
+    float c = cosf(angle_rad);
+    float s = sinf(angle_rad);
+    float t = 1.0f - c;
+    float x = axis[0], y = axis[1], z = axis[2];
+    // Rodrigues' formula, row-major
+    out[0] = t * x * x + c;      out[1] = t * x * y - s * z;  out[2] = t * x * z + s * y;
+    out[3] = t * x * y + s * z;  out[4] = t * y * y + c;      out[5] = t * y * z - s * x;
+    out[6] = t * x * z - s * y;  out[7] = t * y * z + s * x;  out[8] = t * z * z + c;
+}
+
 // Transform point by 3x3 rotation matrix
 static void mat3_transform_point(const float* rot, float x, float y, float z,
                                   float* ox, float* oy, float* oz) {
@@ -164,7 +176,8 @@ bool obb_intersects_obb(const OBB* a, const OBB* b) {
         float be[3] = {b->half_extents.x, b->half_extents.y, b->half_extents.z};
         ra = ae[0]*AbsR[0][i] + ae[1]*AbsR[1][i] + ae[2]*AbsR[2][i];
         rb = be[i];
-        float tb = t.x*bx[i] + t.y*by[i] + t.z*bz[i];
+        const float* b_axis = (i == 0) ? bx : (i == 1) ? by : bz;
+        float tb = t.x*b_axis[0] + t.y*b_axis[1] + t.z*b_axis[2];
         if (absf(tb) > ra + rb) return false;
     }
 
@@ -242,6 +255,54 @@ bool obb_intersects_aabb(const OBB* obb, const AABB* aabb) {
     return obb_intersects_obb(obb, &aabb_obb);
 }
 
+// ============================================================================
+// Ray Tests (slabs)
+// ============================================================================
+
+// Ray against the box [-half, half] in its own frame (o, d in that frame)
+static float ray_box_local(const float* o, const float* d, const float* half, float max_distance) {
+    float t_enter = 0.0f, t_exit = max_distance;
+    for (int a = 0; a < 3; a++) {
+        if (absf(d[a]) < 1e-8f) {
+            // Parallel to this slab: inside it or never
+            if (o[a] < -half[a] || o[a] > half[a]) return -1.0f;
+            continue;
+        }
+        float inv = 1.0f / d[a];
+        float t0 = (-half[a] - o[a]) * inv;
+        float t1 = (half[a] - o[a]) * inv;
+        if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+        t_enter = maxf(t_enter, t0);
+        t_exit = minf(t_exit, t1);
+        if (t_enter > t_exit) return -1.0f;
+    }
+    return t_enter;
+}
+
+float aabb_raycast(const AABB* aabb, Vec3 origin, Vec3 dir, float radius, float max_distance) {
+    float o[3] = {origin.x - (aabb->min.x + aabb->max.x) * 0.5f,
+                  origin.y - (aabb->min.y + aabb->max.y) * 0.5f,
+                  origin.z - (aabb->min.z + aabb->max.z) * 0.5f};
+    float d[3] = {dir.x, dir.y, dir.z};
+    float half[3] = {(aabb->max.x - aabb->min.x) * 0.5f + radius,
+                     (aabb->max.y - aabb->min.y) * 0.5f + radius,
+                     (aabb->max.z - aabb->min.z) * 0.5f + radius};
+    return ray_box_local(o, d, half, max_distance);
+}
+
+float obb_raycast(const OBB* obb, Vec3 origin, Vec3 dir, float radius, float max_distance) {
+    // Into the box frame: project onto its axes (rotation columns)
+    const float* r = obb->rotation;
+    float px = origin.x - obb->center.x, py = origin.y - obb->center.y, pz = origin.z - obb->center.z;
+    float o[3], d[3];
+    for (int a = 0; a < 3; a++) {
+        o[a] = r[a] * px + r[3 + a] * py + r[6 + a] * pz;
+        d[a] = r[a] * dir.x + r[3 + a] * dir.y + r[6 + a] * dir.z;
+    }
+    float half[3] = {obb->half_extents.x + radius, obb->half_extents.y + radius, obb->half_extents.z + radius};
+    return ray_box_local(o, d, half, max_distance);
+}
+
 // ============================================================================
 // OBB-Circle Intersection (for top-down cylinder collision)
 // ============================================================================
@@ -284,6 +345,284 @@ bool obb_intersects_circle(const OBB* obb, float circle_x, float circle_z, float
     return dist_sq <= circle_radius * circle_radius;
 }
 
+// ============================================================================
+// Batched Tests (SoA, SIMD)
+// ============================================================================
+
+// Lane abstraction: OBB_LANES floats processed per instruction
+#if defined(__AVX__)
+#include <immintrin.h>
+#define OBB_LANES 8
+typedef __m256 lane_f;
+static inline lane_f lane_set1(float v) { return _mm256_set1_ps(v); }
+static inline lane_f lane_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline lane_f lane_add(lane_f a, lane_f b) { return _mm256_add_ps(a, b); }
+static inline lane_f lane_sub(lane_f a, lane_f b) { return _mm256_sub_ps(a, b); }
+static inline lane_f lane_mul(lane_f a, lane_f b) { return _mm256_mul_ps(a, b); }
+static inline lane_f lane_min(lane_f a, lane_f b) { return _mm256_min_ps(a, b); }
+static inline lane_f lane_max(lane_f a, lane_f b) { return _mm256_max_ps(a, b); }
+static inline lane_f lane_abs(lane_f a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline lane_f lane_neg(lane_f a) { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+static inline unsigned int lane_gt(lane_f a, lane_f b) { return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+static inline unsigned int lane_le(lane_f a, lane_f b) { return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)); }
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OBB_LANES 4
+typedef __m128 lane_f;
+static inline lane_f lane_set1(float v) { return _mm_set1_ps(v); }
+static inline lane_f lane_load(const float* p) { return _mm_loadu_ps(p); }
+static inline lane_f lane_add(lane_f a, lane_f b) { return _mm_add_ps(a, b); }
+static inline lane_f lane_sub(lane_f a, lane_f b) { return _mm_sub_ps(a, b); }
+static inline lane_f lane_mul(lane_f a, lane_f b) { return _mm_mul_ps(a, b); }
+static inline lane_f lane_min(lane_f a, lane_f b) { return _mm_min_ps(a, b); }
+static inline lane_f lane_max(lane_f a, lane_f b) { return _mm_max_ps(a, b); }
+static inline lane_f lane_abs(lane_f a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline lane_f lane_neg(lane_f a) { return _mm_xor_ps(_mm_set1_ps(-0.0f), a); }
+static inline unsigned int lane_gt(lane_f a, lane_f b) { return (unsigned int)_mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+static inline unsigned int lane_le(lane_f a, lane_f b) { return (unsigned int)_mm_movemask_ps(_mm_cmple_ps(a, b)); }
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OBB_LANES 4
+typedef float32x4_t lane_f;
+static inline lane_f lane_set1(float v) { return vdupq_n_f32(v); }
+static inline lane_f lane_load(const float* p) { return vld1q_f32(p); }
+static inline lane_f lane_add(lane_f a, lane_f b) { return vaddq_f32(a, b); }
+static inline lane_f lane_sub(lane_f a, lane_f b) { return vsubq_f32(a, b); }
+static inline lane_f lane_mul(lane_f a, lane_f b) { return vmulq_f32(a, b); }
+static inline lane_f lane_min(lane_f a, lane_f b) { return vbslq_f32(vcltq_f32(a, b), a, b); }
+static inline lane_f lane_max(lane_f a, lane_f b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+static inline lane_f lane_abs(lane_f a) { return vabsq_f32(a); }
+static inline lane_f lane_neg(lane_f a) { return vnegq_f32(a); }
+static inline unsigned int lane_bits(uint32x4_t m) {
+    const uint32_t bit_values[4] = {1, 2, 4, 8};
+    uint32x4_t bits = vandq_u32(m, vld1q_u32(bit_values));
+    return vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) |
+           vgetq_lane_u32(bits, 2) | vgetq_lane_u32(bits, 3);
+}
+static inline unsigned int lane_gt(lane_f a, lane_f b) { return lane_bits(vcgtq_f32(a, b)); }
+static inline unsigned int lane_le(lane_f a, lane_f b) { return lane_bits(vcleq_f32(a, b)); }
+#else
+#define OBB_LANES 1
+typedef float lane_f;
+static inline lane_f lane_set1(float v) { return v; }
+static inline lane_f lane_load(const float* p) { return *p; }
+static inline lane_f lane_add(lane_f a, lane_f b) { return a + b; }
+static inline lane_f lane_sub(lane_f a, lane_f b) { return a - b; }
+static inline lane_f lane_mul(lane_f a, lane_f b) { return a * b; }
+static inline lane_f lane_min(lane_f a, lane_f b) { return minf(a, b); }
+static inline lane_f lane_max(lane_f a, lane_f b) { return maxf(a, b); }
+static inline lane_f lane_abs(lane_f a) { return absf(a); }
+static inline lane_f lane_neg(lane_f a) { return -a; }
+static inline unsigned int lane_gt(lane_f a, lane_f b) { return a > b ? 1u : 0u; }
+static inline unsigned int lane_le(lane_f a, lane_f b) { return a <= b ? 1u : 0u; }
+#endif
+
+// OBB fields for one group of lanes (single OBBs are broadcast)
+typedef struct {
+    lane_f center[3];
+    lane_f half_extents[3];
+    lane_f rotation[9];
+} LaneObb;
+
+static void lane_obb_broadcast(const OBB* obb, LaneObb* out) {
+    out->center[0] = lane_set1(obb->center.x);
+    out->center[1] = lane_set1(obb->center.y);
+    out->center[2] = lane_set1(obb->center.z);
+    out->half_extents[0] = lane_set1(obb->half_extents.x);
+    out->half_extents[1] = lane_set1(obb->half_extents.y);
+    out->half_extents[2] = lane_set1(obb->half_extents.z);
+    for (int i = 0; i < 9; i++) out->rotation[i] = lane_set1(obb->rotation[i]);
+}
+
+static void lane_obb_load(const ObbBatch* batch, int first, LaneObb* out) {
+    for (int i = 0; i < 3; i++) {
+        out->center[i] = lane_load(&batch->center[i][first]);
+        out->half_extents[i] = lane_load(&batch->half_extents[i][first]);
+    }
+    for (int i = 0; i < 9; i++) out->rotation[i] = lane_load(&batch->rotation[i][first]);
+}
+
+// dot(u, v) for 3 lane vectors, summed in the same order as the scalar test
+static inline lane_f lane_dot3(lane_f u0, lane_f u1, lane_f u2, lane_f v0, lane_f v1, lane_f v2) {
+    return lane_add(lane_add(lane_mul(u0, v0), lane_mul(u1, v1)), lane_mul(u2, v2));
+}
+
+// SAT on OBB_LANES pairs (same math as obb_intersects_obb)
+// live: lanes still to test; returns lanes with no separating axis
+static unsigned int sat_lanes(const LaneObb* a, const LaneObb* b, unsigned int live) {
+    // Axes are the columns of the rotation matrices
+    const lane_f* ra_m = a->rotation;
+    const lane_f* rb_m = b->rotation;
+
+    // R[i][j] = dot(A_axis_i, B_axis_j)
+    lane_f R[3][3], AbsR[3][3];
+    const lane_f eps = lane_set1(1e-6f);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            R[i][j] = lane_dot3(ra_m[i], ra_m[3 + i], ra_m[6 + i], rb_m[j], rb_m[3 + j], rb_m[6 + j]);
+            AbsR[i][j] = lane_add(lane_abs(R[i][j]), eps);
+        }
+    }
+
+    // Translation, and in A's coordinate frame
+    lane_f t[3];
+    for (int k = 0; k < 3; k++) t[k] = lane_sub(b->center[k], a->center[k]);
+    lane_f ta[3];
+    for (int i = 0; i < 3; i++) ta[i] = lane_dot3(t[0], t[1], t[2], ra_m[i], ra_m[3 + i], ra_m[6 + i]);
+
+    const lane_f* ae = a->half_extents;
+    const lane_f* be = b->half_extents;
+
+    // Mark lanes separated on this axis; stop once every lane is out
+#define SAT_AXIS(dist, ra, rb) \
+    do { \
+        live &= ~lane_gt(lane_abs(dist), lane_add((ra), (rb))); \
+        if (!live) return 0; \
+    } while (0)
+
+    // L = A0, A1, A2
+    for (int i = 0; i < 3; i++) {
+        lane_f rb = lane_add(lane_add(lane_mul(be[0], AbsR[i][0]), lane_mul(be[1], AbsR[i][1])),
+                             lane_mul(be[2], AbsR[i][2]));
+        SAT_AXIS(ta[i], ae[i], rb);
+    }
+
+    // L = B0, B1, B2
+    for (int i = 0; i < 3; i++) {
+        lane_f ra = lane_add(lane_add(lane_mul(ae[0], AbsR[0][i]), lane_mul(ae[1], AbsR[1][i])),
+                             lane_mul(ae[2], AbsR[2][i]));
+        lane_f tb = lane_dot3(t[0], t[1], t[2], rb_m[i], rb_m[3 + i], rb_m[6 + i]);
+        SAT_AXIS(tb, ra, be[i]);
+    }
+
+    // 9 cross product axes L = Ai x Bj
+
+    SAT_AXIS(lane_sub(lane_mul(ta[2], R[1][0]), lane_mul(ta[1], R[2][0])),   // A0 x B0
+             lane_add(lane_mul(ae[1], AbsR[2][0]), lane_mul(ae[2], AbsR[1][0])),
+             lane_add(lane_mul(be[1], AbsR[0][2]), lane_mul(be[2], AbsR[0][1])));
+    SAT_AXIS(lane_sub(lane_mul(ta[2], R[1][1]), lane_mul(ta[1], R[2][1])),   // A0 x B1
+             lane_add(lane_mul(ae[1], AbsR[2][1]), lane_mul(ae[2], AbsR[1][1])),
+             lane_add(lane_mul(be[0], AbsR[0][2]), lane_mul(be[2], AbsR[0][0])));
+    SAT_AXIS(lane_sub(lane_mul(ta[2], R[1][2]), lane_mul(ta[1], R[2][2])),   // A0 x B2
+             lane_add(lane_mul(ae[1], AbsR[2][2]), lane_mul(ae[2], AbsR[1][2])),
+             lane_add(lane_mul(be[0], AbsR[0][1]), lane_mul(be[1], AbsR[0][0])));
+    SAT_AXIS(lane_sub(lane_mul(ta[0], R[2][0]), lane_mul(ta[2], R[0][0])),   // A1 x B0
+             lane_add(lane_mul(ae[0], AbsR[2][0]), lane_mul(ae[2], AbsR[0][0])),
+             lane_add(lane_mul(be[1], AbsR[1][2]), lane_mul(be[2], AbsR[1][1])));
+    SAT_AXIS(lane_sub(lane_mul(ta[0], R[2][1]), lane_mul(ta[2], R[0][1])),   // A1 x B1
+             lane_add(lane_mul(ae[0], AbsR[2][1]), lane_mul(ae[2], AbsR[0][1])),
+             lane_add(lane_mul(be[0], AbsR[1][2]), lane_mul(be[2], AbsR[1][0])));
+    SAT_AXIS(lane_sub(lane_mul(ta[0], R[2][2]), lane_mul(ta[2], R[0][2])),   // A1 x B2
+             lane_add(lane_mul(ae[0], AbsR[2][2]), lane_mul(ae[2], AbsR[0][2])),
+             lane_add(lane_mul(be[0], AbsR[1][1]), lane_mul(be[1], AbsR[1][0])));
+    SAT_AXIS(lane_sub(lane_mul(ta[1], R[0][0]), lane_mul(ta[0], R[1][0])),   // A2 x B0
+             lane_add(lane_mul(ae[0], AbsR[1][0]), lane_mul(ae[1], AbsR[0][0])),
+             lane_add(lane_mul(be[1], AbsR[2][2]), lane_mul(be[2], AbsR[2][1])));
+    SAT_AXIS(lane_sub(lane_mul(ta[1], R[0][1]), lane_mul(ta[0], R[1][1])),   // A2 x B1
+             lane_add(lane_mul(ae[0], AbsR[1][1]), lane_mul(ae[1], AbsR[0][1])),
+             lane_add(lane_mul(be[0], AbsR[2][2]), lane_mul(be[2], AbsR[2][0])));
+    SAT_AXIS(lane_sub(lane_mul(ta[1], R[0][2]), lane_mul(ta[0], R[1][2])),   // A2 x B2
+             lane_add(lane_mul(ae[0], AbsR[1][2]), lane_mul(ae[1], AbsR[0][2])),
+             lane_add(lane_mul(be[0], AbsR[2][1]), lane_mul(be[1], AbsR[2][0])));
+#undef SAT_AXIS
+
+    return live;
+}
+
+void obb_batch_clear(ObbBatch* batch) {
+    // Zero so unused lanes hold finite values
+    memset(batch, 0, sizeof(*batch));
+}
+
+int obb_batch_add(ObbBatch* batch, const OBB* obb) {
+    if (batch->count >= OBB_BATCH_MAX) return -1;
+    int i = batch->count++;
+    batch->center[0][i] = obb->center.x;
+    batch->center[1][i] = obb->center.y;
+    batch->center[2][i] = obb->center.z;
+    batch->half_extents[0][i] = obb->half_extents.x;
+    batch->half_extents[1][i] = obb->half_extents.y;
+    batch->half_extents[2][i] = obb->half_extents.z;
+    for (int k = 0; k < 9; k++) batch->rotation[k][i] = obb->rotation[k];
+    return i;
+}
+
+// Lanes of [first, first + OBB_LANES) that hold batch entries
+static inline unsigned int lanes_valid(const ObbBatch* batch, int first) {
+    int n = batch->count - first;
+    if (n >= OBB_LANES) return (1u << OBB_LANES) - 1u;
+    return (1u << n) - 1u;
+}
+
+unsigned int obb_intersects_obb_batch(const OBB* a, const ObbBatch* batch) {
+    LaneObb la, lb;
+    lane_obb_broadcast(a, &la);
+
+    unsigned int hits = 0;
+    for (int first = 0; first < batch->count; first += OBB_LANES) {
+        lane_obb_load(batch, first, &lb);
+        hits |= sat_lanes(&la, &lb, lanes_valid(batch, first)) << first;
+    }
+    return hits;
+}
+
+unsigned int obb_batch_intersects_obb(const ObbBatch* batch, const OBB* b) {
+    LaneObb la, lb;
+    lane_obb_broadcast(b, &lb);
+
+    unsigned int hits = 0;
+    for (int first = 0; first < batch->count; first += OBB_LANES) {
+        lane_obb_load(batch, first, &la);
+        hits |= sat_lanes(&la, &lb, lanes_valid(batch, first)) << first;
+    }
+    return hits;
+}
+
+unsigned int obb_batch_intersects_aabb(const ObbBatch* batch, const AABB* aabb) {
+    // Same AABB-as-OBB conversion as obb_intersects_aabb
+    OBB aabb_obb;
+    obb_from_bounds(&aabb_obb, aabb->min, aabb->max);
+    return obb_batch_intersects_obb(batch, &aabb_obb);
+}
+
+unsigned int obb_intersects_circle_batch(const ObbBatch* batch, float circle_x, float circle_z,
+                                         float circle_radius) {
+    const lane_f cx = lane_set1(circle_x);
+    const lane_f cz = lane_set1(circle_z);
+    const lane_f r_sq = lane_set1(circle_radius * circle_radius);
+
+    unsigned int hits = 0;
+    for (int first = 0; first < batch->count; first += OBB_LANES) {
+        // OBB's X and Z axes projected on the XZ plane
+        lane_f ax_x = lane_load(&batch->rotation[0][first]);
+        lane_f ax_z = lane_load(&batch->rotation[6][first]);
+        lane_f az_x = lane_load(&batch->rotation[2][first]);
+        lane_f az_z = lane_load(&batch->rotation[8][first]);
+        lane_f ox = lane_load(&batch->center[0][first]);
+        lane_f oz = lane_load(&batch->center[2][first]);
+        lane_f ex = lane_load(&batch->half_extents[0][first]);
+        lane_f ez = lane_load(&batch->half_extents[2][first]);
+
+        // Circle center in OBB local axes, clamped to the extents
+        lane_f dx = lane_sub(cx, ox);
+        lane_f dz = lane_sub(cz, oz);
+        lane_f proj_x = lane_add(lane_mul(dx, ax_x), lane_mul(dz, ax_z));
+        lane_f proj_z = lane_add(lane_mul(dx, az_x), lane_mul(dz, az_z));
+        lane_f clamped_x = lane_max(lane_neg(ex), lane_min(ex, proj_x));
+        lane_f clamped_z = lane_max(lane_neg(ez), lane_min(ez, proj_z));
+
+        // Closest point and distance to the circle center
+        lane_f closest_x = lane_add(lane_add(ox, lane_mul(clamped_x, ax_x)), lane_mul(clamped_z, az_x));
+        lane_f closest_z = lane_add(lane_add(oz, lane_mul(clamped_x, ax_z)), lane_mul(clamped_z, az_z));
+        lane_f dist_x = lane_sub(cx, closest_x);
+        lane_f dist_z = lane_sub(cz, closest_z);
+        lane_f dist_sq = lane_add(lane_mul(dist_x, dist_x), lane_mul(dist_z, dist_z));
+
+        hits |= (lane_le(dist_sq, r_sq) & lanes_valid(batch, first)) << first;
+    }
+    return hits;
+}
+
 // ============================================================================
 // Utility
 // ============================================================================
@@ -61,6 +61,51 @@ bool obb_intersects_aabb(const OBB* obb, const AABB* aabb);
 // Returns true if they intersect
 bool obb_intersects_circle(const OBB* obb, float circle_x, float circle_z, float circle_radius);
 
+// Ray tests (origin, unit direction): distance to where the ray enters the
+// box grown by radius on every side (a conservative sphere cast), 0 if the
+// origin is inside, or -1 if it misses within max_distance
+float aabb_raycast(const AABB* aabb, Vec3 origin, Vec3 dir, float radius, float max_distance);
+float obb_raycast(const OBB* obb, Vec3 origin, Vec3 dir, float radius, float max_distance);
+
+// A box grown along its own axes can poke out of an enclosing box grown the
+// same way when the two are rotated differently; bounding volumes of a shape
+// cast are grown by radius * RAY_BOUNDS_GROWTH (sqrt 3) so they still cover it
+#define RAY_BOUNDS_GROWTH 1.7320508f
+
+// ============================================================================
+// Batched Tests (SoA, SIMD)
+// One OBB / circle against up to OBB_BATCH_MAX OBBs per call. Lanes are
+// processed with AVX (if built with -mavx), SSE2, NEON, or scalar code.
+// Results are bit masks (bit i = obbs[i] hits) and match the single tests.
+// ============================================================================
+
+#define OBB_BATCH_MAX 8
+
+// Structure-of-arrays OBB set
+typedef struct {
+    float center[3][OBB_BATCH_MAX];        // center[axis][i]
+    float half_extents[3][OBB_BATCH_MAX];  // half_extents[axis][i]
+    float rotation[9][OBB_BATCH_MAX];      // rotation[element][i] (row-major elements)
+    int count;
+} ObbBatch;
+
+// Empty a batch
+void obb_batch_clear(ObbBatch* batch);
+
+// Append an OBB (returns its lane index, or -1 if full)
+int obb_batch_add(ObbBatch* batch, const OBB* obb);
+
+// Test a against every OBB in batch (SAT, early-out once all lanes separate)
+unsigned int obb_intersects_obb_batch(const OBB* a, const ObbBatch* batch);
+
+// Test every OBB in batch against b / an AABB (same as obb_intersects_obb(batch[i], b))
+unsigned int obb_batch_intersects_obb(const ObbBatch* batch, const OBB* b);
+unsigned int obb_batch_intersects_aabb(const ObbBatch* batch, const AABB* aabb);
+
+// Test every OBB in batch against a circle on the XZ plane
+unsigned int obb_intersects_circle_batch(const ObbBatch* batch, float circle_x, float circle_z,
+                                         float circle_radius);
+
 // ============================================================================
 // Utility
 // ============================================================================
@@ -77,6 +122,9 @@ void mat3_multiply(const float* a, const float* b, float* out);
 // Create Y-axis rotation matrix (3x3)
 void mat3_rotation_y(float angle_rad, float* out);
 
+// Create rotation matrix (3x3) about a unit axis
+void mat3_rotation_axis(const float* axis, float angle_rad, float* out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -55,6 +55,17 @@ extern "C" {
 // Default wheel diameter
 #define VEXIQ_DEFAULT_WHEEL_DIAMETER 4.0f
 
+// =============================================================================
+// Drive Models (physics/drive_models.h)
+// =============================================================================
+
+// Share of a mecanum wheel's force left when strafing (the rest slips in the rollers)
+#define VEXIQ_MECANUM_STRAFE_EFFICIENCY 0.7f
+
+// Ackermann steering: axle distance and front wheel angle at full steer
+#define VEXIQ_DEFAULT_WHEELBASE 8.0f
+#define VEXIQ_MAX_STEER_ANGLE 0.52f   // ~30 degrees
+
 // =============================================================================
 // Friction and Damping
 // =============================================================================
@@ -2,8 +2,9 @@
  * Robot Configuration Loader Implementation
  *
  * Parses YAML-like .config files to extract motor port assignments.
- * Specifically looks for motors with mechanism: drivetrain.left_wheels
- * and drivetrain.right_wheels
+ * Specifically looks for motors with mechanism: drivetrain.left_wheels,
+ * drivetrain.right_wheels and drivetrain.strafe (mecanum/omni sideways
+ * command), and the entries of the sensors section
  */
 
 #include "robot_config.h"
@@ -15,6 +16,8 @@
 void robot_config_init(RobotConfig* config) {
     config->left_motor_port = 0;
     config->right_motor_port = 0;
+    config->strafe_motor_port = 0;
+    config->sensor_count = 0;
 }
 
 // Trim leading/trailing whitespace
@@ -60,6 +63,41 @@ static const char* parse_key_value(const char* line, char* key_out, size_t key_s
     return value;
 }
 
+// Parse "[x, y, z]" (returns false if not three numbers)
+static bool parse_vec3(const char* value, float* out) {
+    return sscanf(value, " [ %f , %f , %f ]", &out[0], &out[1], &out[2]) == 3;
+}
+
+// Sensor property (indent 4 under a sensor name)
+static void parse_sensor_property(RobotConfigSensor* sensor, const char* key, const char* raw_value) {
+    // Drop an inline "# comment"
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", raw_value);
+    char* comment = strchr(buffer, '#');
+    if (comment) *comment = '\0';
+    const char* value = trim(buffer);
+
+    if (strcmp(key, "port") == 0) {
+        sensor->port = atoi(value);
+    } else if (strcmp(key, "submodel") == 0) {
+        snprintf(sensor->submodel, sizeof(sensor->submodel), "%s", value);
+    } else if (strcmp(key, "part") == 0) {
+        snprintf(sensor->part, sizeof(sensor->part), "%s", value);
+    } else if (strcmp(key, "direction") == 0) {
+        if (!parse_vec3(value, sensor->direction)) {
+            printf("  Config: bad direction for %s: %s\n", sensor->name, value);
+        }
+    } else if (strcmp(key, "range") == 0) {
+        sensor->range_mm = (float)atof(value);
+    } else if (strcmp(key, "offset") == 0) {
+        if (!parse_vec3(value, sensor->offset)) {
+            printf("  Config: bad offset for %s: %s\n", sensor->name, value);
+        }
+    } else if (strcmp(key, "fov") == 0) {
+        sensor->fov_deg = (float)atof(value);
+    }
+}
+
 bool robot_config_load(const char* path, RobotConfig* config) {
     FILE* file = fopen(path, "r");
     if (!file) {
@@ -70,6 +108,8 @@ bool robot_config_load(const char* path, RobotConfig* config) {
 
     char line[512];
     bool in_motors_section = false;
+    bool in_sensors_section = false;
+    RobotConfigSensor* current_sensor = NULL;
     char current_motor_name[128] = {0};
     int current_port = 0;
 
@@ -89,13 +129,38 @@ bool robot_config_load(const char* path, RobotConfig* config) {
         // Check for motors section
         if (indent == 0 && strcmp(key, "motors") == 0) {
             in_motors_section = true;
+            in_sensors_section = false;
             current_motor_name[0] = '\0';
             continue;
         }
 
-        // Exit motors section on other top-level keys
+        // Check for sensors section
+        if (indent == 0 && strcmp(key, "sensors") == 0) {
+            in_sensors_section = true;
+            in_motors_section = false;
+            current_sensor = NULL;
+            continue;
+        }
+
+        // Exit sections on other top-level keys
         if (indent == 0) {
             in_motors_section = false;
+            in_sensors_section = false;
+            continue;
+        }
+
+        if (in_sensors_section) {
+            // Sensor name (indent 2), then its properties (indent 4)
+            if (indent == 2 && value[0] == '\0') {
+                current_sensor = NULL;
+                if (config->sensor_count < ROBOT_CONFIG_MAX_SENSORS) {
+                    current_sensor = &config->sensors[config->sensor_count++];
+                    memset(current_sensor, 0, sizeof(*current_sensor));
+                    snprintf(current_sensor->name, sizeof(current_sensor->name), "%s", key);
+                }
+            } else if (indent == 4 && current_sensor) {
+                parse_sensor_property(current_sensor, key, value);
+            }
             continue;
         }
 
@@ -122,6 +187,9 @@ bool robot_config_load(const char* path, RobotConfig* config) {
                 else if (strstr(value, "drivetrain.right_wheels") || strstr(value, "drivetrain.right")) {
                     config->right_motor_port = current_port;
                 }
+                else if (strstr(value, "drivetrain.strafe")) {
+                    config->strafe_motor_port = current_port;
+                }
             }
         }
     }
@@ -132,6 +200,12 @@ bool robot_config_load(const char* path, RobotConfig* config) {
         printf("  Config: left_motor=port%d, right_motor=port%d\n",
                config->left_motor_port, config->right_motor_port);
     }
+    if (config->strafe_motor_port > 0) {
+        printf("  Config: strafe_motor=port%d\n", config->strafe_motor_port);
+    }
+    if (config->sensor_count > 0) {
+        printf("  Config: %d sensors\n", config->sensor_count);
+    }
 
     return true;
 }
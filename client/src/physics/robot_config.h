@@ -1,7 +1,9 @@
 /*
  * Robot Configuration Loader
  *
- * Parses .config files to get motor port assignments for drivetrain.
+ * Parses .config files to get motor port assignments for drivetrain and
+ * the sensors (port, mounting submodel) the simulator casts rays for or
+ * renders cameras from.
  */
 
 #ifndef ROBOT_CONFIG_H
@@ -13,10 +15,41 @@
 extern "C" {
 #endif
 
-// Motor assignment for drivetrain
+#define ROBOT_CONFIG_MAX_SENSORS 12
+
+// Sensor entry of the sensors section, e.g.
+//   distance_sensor:
+//     submodel: ClawbotIQ.ldr
+//     port: 4
+//     part: 228-3011           (optional: sensor part to mount the ray on)
+//     direction: [0, 0, -1]    (optional: LDraw direction in the robot, default forward)
+//     range: 1000              (optional: mm)
+// Cameras ("camera" or "vision" in the name) have no default part; they
+// take a part or a submodel, usually with an offset to clear the robot:
+//   front_camera:
+//     submodel: Arm.ldr
+//     port: 6
+//     offset: [0, -40, -60]    (optional: LDU from the mount, LDraw axes)
+//     fov: 60                  (optional: vertical field of view, degrees)
+typedef struct {
+    char name[128];           // Sensor key (e.g. "distance_sensor", "color_sensor"), as long as a parsed key
+    char submodel[128];       // Submodel the sensor is mounted in
+    char part[32];            // Sensor part number ("" = default for the sensor type)
+    int port;                 // 1-12, 0 = not assigned
+    float direction[3];       // LDraw units, all 0 = robot forward
+    float range_mm;           // 0 = default for the sensor type
+    float offset[3];          // LDU from the part or submodel center
+    float fov_deg;            // Cameras: 0 = default
+} RobotConfigSensor;
+
+// Motor assignment for drivetrain, and sensors
 typedef struct {
     int left_motor_port;   // Port number for left wheel motor (1-12, 0 = not assigned)
     int right_motor_port;  // Port number for right wheel motor (1-12, 0 = not assigned)
+    int strafe_motor_port; // Sideways motor of mecanum/omni drives (1-12, 0 = not assigned)
+
+    RobotConfigSensor sensors[ROBOT_CONFIG_MAX_SENSORS];
+    int sensor_count;
 } RobotConfig;
 
 // Initialize config with defaults (no assignments)
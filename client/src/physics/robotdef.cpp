@@ -50,6 +50,20 @@ static const char* get_value(const char* line) {
     return trim((char*)(colon + 1));
 }
 
+// Append a zeroed submodel (NULL if out of memory)
+static RobotDefSubmodel* add_submodel(RobotDef* def) {
+    if (def->submodel_count >= def->submodel_capacity) {
+        int capacity = def->submodel_capacity ? def->submodel_capacity * 2 : 16;
+        RobotDefSubmodel* grown = (RobotDefSubmodel*)realloc(def->submodels, (size_t)capacity * sizeof(RobotDefSubmodel));
+        if (!grown) return NULL;
+        def->submodels = grown;
+        def->submodel_capacity = capacity;
+    }
+    RobotDefSubmodel* sm = &def->submodels[def->submodel_count++];
+    memset(sm, 0, sizeof(RobotDefSubmodel));
+    return sm;
+}
+
 void robotdef_init(RobotDef* def) {
     memset(def, 0, sizeof(RobotDef));
     def->version = 1;
@@ -73,7 +87,7 @@ bool robotdef_load(const char* path, RobotDef* def) {
     int indent = 0;
     enum { SECTION_NONE, SECTION_SUMMARY, SECTION_DRIVETRAIN, SECTION_MOTORS, SECTION_SUBMODELS, SECTION_WHEEL_ASSEMBLIES } section = SECTION_NONE;
     int current_motor = -1;
-    int current_submodel = -1;
+    RobotDefSubmodel* current_submodel = NULL;
     int current_wheel = -1;
     bool in_wheel_parts = false;
 
@@ -107,7 +121,7 @@ bool robotdef_load(const char* path, RobotDef* def) {
                 current_motor = -1;
             } else if (starts_with(trimmed, "submodels:")) {
                 section = SECTION_SUBMODELS;
-                current_submodel = -1;
+                current_submodel = NULL;
             } else if (starts_with(trimmed, "wheel_assemblies:")) {
                 section = SECTION_WHEEL_ASSEMBLIES;
                 current_wheel = -1;
@@ -154,6 +168,10 @@ bool robotdef_load(const char* path, RobotDef* def) {
                     def->drivetrain.track_width = (float)atof(get_value(trimmed));
                 } else if (starts_with(trimmed, "wheel_diameter:")) {
                     def->drivetrain.wheel_diameter = (float)atof(get_value(trimmed));
+                } else if (starts_with(trimmed, "wheelbase:")) {
+                    def->drivetrain.wheelbase = (float)atof(get_value(trimmed));
+                } else if (starts_with(trimmed, "max_steer_angle:")) {
+                    def->drivetrain.max_steer_angle = (float)atof(get_value(trimmed));
                 }
                 break;
 
@@ -177,20 +195,21 @@ bool robotdef_load(const char* path, RobotDef* def) {
             case SECTION_SUBMODELS:
                 // Check for new submodel (starts with name ending in .ldr:)
                 if (indent == 2 && strchr(trimmed, ':') && strstr(trimmed, ".ldr:")) {
-                    current_submodel++;
-                    if (current_submodel < ROBOTDEF_MAX_SUBMODELS) {
-                        def->submodel_count = current_submodel + 1;
+                    current_submodel = add_submodel(def);
+                    if (current_submodel) {
                         // Extract name (everything before the colon)
                         char name[ROBOTDEF_MAX_NAME];
                         strncpy(name, trimmed, ROBOTDEF_MAX_NAME - 1);
                         char* colon = strchr(name, ':');
                         if (colon) *colon = '\0';
-                        strncpy(def->submodels[current_submodel].name, name, ROBOTDEF_MAX_NAME - 1);
+                        strncpy(current_submodel->name, name, ROBOTDEF_MAX_NAME - 1);
                     }
-                } else if (current_submodel >= 0 && current_submodel < ROBOTDEF_MAX_SUBMODELS) {
-                    RobotDefSubmodel* sm = &def->submodels[current_submodel];
+                } else if (current_submodel) {
+                    RobotDefSubmodel* sm = current_submodel;
                     if (starts_with(trimmed, "position:")) {
                         parse_float_array(trimmed, sm->position, 3);
+                    } else if (starts_with(trimmed, "parent:")) {
+                        strncpy(sm->parent, get_value(trimmed), ROBOTDEF_MAX_NAME - 1);
                     } else if (starts_with(trimmed, "rotation_axis:")) {
                         parse_float_array(trimmed, sm->rotation_axis, 3);
                         sm->has_kinematics = true;
@@ -261,6 +280,13 @@ bool robotdef_load(const char* path, RobotDef* def) {
     return true;
 }
 
+void robotdef_free(RobotDef* def) {
+    free(def->submodels);
+    def->submodels = NULL;
+    def->submodel_count = 0;
+    def->submodel_capacity = 0;
+}
+
 const RobotDefSubmodel* robotdef_get_submodel(const RobotDef* def, const char* name) {
     for (int i = 0; i < def->submodel_count; i++) {
         if (strcmp(def->submodels[i].name, name) == 0) {
@@ -293,6 +319,10 @@ void robotdef_print(const RobotDef* def) {
            def->drivetrain.rotation_axis[1],
            def->drivetrain.rotation_axis[2]);
     printf("    Track Width: %.1f LDU\n", def->drivetrain.track_width);
+    if (def->drivetrain.type == DRIVETRAIN_ACKERMANN) {
+        printf("    Wheelbase: %.1f LDU, Max Steer: %.1f deg\n",
+               def->drivetrain.wheelbase, def->drivetrain.max_steer_angle);
+    }
 
     if (def->motor_count > 0) {
         printf("  Motors:\n");
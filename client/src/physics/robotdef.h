@@ -16,7 +16,6 @@ extern "C" {
 
 // Maximum lengths for strings
 #define ROBOTDEF_MAX_NAME 128
-#define ROBOTDEF_MAX_SUBMODELS 64
 #define ROBOTDEF_MAX_WHEELS 8
 #define ROBOTDEF_MAX_WHEEL_PARTS 4
 
@@ -38,6 +37,8 @@ typedef struct {
     float rotation_axis[3];    // Axis for robot rotation (default: [0,1,0] = vertical)
     float track_width;         // LDU
     float wheel_diameter;      // mm (0 if not specified)
+    float wheelbase;           // Ackermann: front to rear axle, LDU (0 if not specified)
+    float max_steer_angle;     // Ackermann: front wheel angle at full steer, degrees (0 if not specified)
 } RobotDefDrivetrain;
 
 // Motor configuration
@@ -50,7 +51,8 @@ typedef struct {
 // Submodel kinematics (for articulated parts)
 typedef struct {
     char name[ROBOTDEF_MAX_NAME];
-    float position[3];          // LDU
+    char parent[ROBOTDEF_MAX_NAME];  // Parent submodel name ("" = none)
+    float position[3];          // LDU (relative to the parent)
     float rotation_axis[3];     // Local rotation axis (0,0,0 = none)
     float rotation_origin[3];   // Pivot point in local coords
     float rotation_limits[2];   // [min_deg, max_deg]
@@ -82,9 +84,10 @@ typedef struct {
     RobotDefMotor motors[12];  // Max 12 ports
     int motor_count;
 
-    // Submodels with kinematics
-    RobotDefSubmodel submodels[ROBOTDEF_MAX_SUBMODELS];
+    // Submodels with kinematics (growable array, no count limit)
+    RobotDefSubmodel* submodels;
     int submodel_count;
+    int submodel_capacity;
 
     // Wheel assemblies
     RobotDefWheelAssembly wheel_assemblies[ROBOTDEF_MAX_WHEELS];
@@ -101,9 +104,12 @@ typedef struct {
 void robotdef_init(RobotDef* def);
 
 // Load robot definition from file
-// Returns true on success, false on failure
+// Returns true on success, false on failure (release with robotdef_free())
 bool robotdef_load(const char* path, RobotDef* def);
 
+// Free the submodel array
+void robotdef_free(RobotDef* def);
+
 // Get a submodel by name (returns NULL if not found)
 const RobotDefSubmodel* robotdef_get_submodel(const RobotDef* def, const char* name);
 
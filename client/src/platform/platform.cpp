@@ -3,9 +3,40 @@
 #include <GL/glew.h>
 #include <stdio.h>
 #include <string.h>
+#ifdef VEXIQ_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 static bool sdl_initialized = false;
 
+// GLEW on the current context. An offscreen context has no X display, which
+// GLEW builds using GLX report as an error after loading every GL entry point.
+static bool init_glew(bool offscreen) {
+    glewExperimental = GL_TRUE;
+    GLenum glew_err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (offscreen && glew_err == GLEW_ERROR_NO_GLX_DISPLAY) glew_err = GLEW_OK;
+#else
+    (void)offscreen;
+#endif
+    if (glew_err != GLEW_OK) {
+        fprintf(stderr, "Failed to initialize GLEW: %s\n", glewGetErrorString(glew_err));
+        return false;
+    }
+
+    // Clear any GLEW errors
+    glGetError();
+    return true;
+}
+
+static void print_gl_info(void) {
+    printf("OpenGL Vendor:   %s\n", glGetString(GL_VENDOR));
+    printf("OpenGL Renderer: %s\n", glGetString(GL_RENDERER));
+    printf("OpenGL Version:  %s\n", glGetString(GL_VERSION));
+    printf("GLSL Version:    %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
+}
+
 bool platform_init(Platform* p, const char* title, int width, int height) {
     memset(p, 0, sizeof(Platform));
     p->width = width;
@@ -58,18 +89,12 @@ bool platform_init(Platform* p, const char* title, int width, int height) {
     p->gl_context = gl_context;
 
     // Initialize GLEW
-    glewExperimental = GL_TRUE;
-    GLenum glew_err = glewInit();
-    if (glew_err != GLEW_OK) {
-        fprintf(stderr, "Failed to initialize GLEW: %s\n", glewGetErrorString(glew_err));
+    if (!init_glew(false)) {
         SDL_GL_DeleteContext(gl_context);
         SDL_DestroyWindow(window);
         return false;
     }
 
-    // Clear any GLEW errors
-    glGetError();
-
     // Enable VSync
     SDL_GL_SetSwapInterval(1);
 
@@ -77,15 +102,137 @@ bool platform_init(Platform* p, const char* title, int width, int height) {
     glEnable(GL_MULTISAMPLE);
 
     // Print OpenGL info
-    printf("OpenGL Vendor:   %s\n", glGetString(GL_VENDOR));
-    printf("OpenGL Renderer: %s\n", glGetString(GL_RENDERER));
-    printf("OpenGL Version:  %s\n", glGetString(GL_VERSION));
-    printf("GLSL Version:    %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
+    print_gl_info();
 
     return true;
 }
 
+#ifdef VEXIQ_EGL
+// Surfaceless Mesa display when available (no GPU device or X server needed),
+// else the default display
+static EGLDisplay egl_open_display(void) {
+    const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (client_extensions && strstr(client_extensions, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (get_platform_display) {
+            EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) return display;
+        }
+    }
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) return display;
+    return EGL_NO_DISPLAY;
+}
+
+static bool egl_init_offscreen(Platform* p) {
+    EGLDisplay display = egl_open_display();
+    if (display == EGL_NO_DISPLAY) {
+        fprintf(stderr, "[Platform] No EGL display\n");
+        return false;
+    }
+
+    // A pbuffer config if there is one; surfaceless contexts need none
+    EGLint pbuffer_attribs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_DEPTH_SIZE, 24, EGL_NONE};
+    EGLint any_attribs[] = {EGL_SURFACE_TYPE, 0, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config;
+    EGLint config_count = 0;
+    bool pbuffer = eglChooseConfig(display, pbuffer_attribs, &config, 1, &config_count) && config_count > 0;
+    if (!pbuffer && (!eglChooseConfig(display, any_attribs, &config, 1, &config_count) || config_count == 0)) {
+        fprintf(stderr, "[Platform] No EGL config for desktop OpenGL\n");
+        eglTerminate(display);
+        return false;
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+    EGLint context_attribs[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+                                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+                                EGL_NONE};
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if (context == EGL_NO_CONTEXT) {
+        fprintf(stderr, "[Platform] eglCreateContext failed (0x%x)\n", eglGetError());
+        eglTerminate(display);
+        return false;
+    }
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (pbuffer) {
+        EGLint surface_attribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, surface_attribs);
+    }
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        fprintf(stderr, "[Platform] eglMakeCurrent failed (0x%x)\n", eglGetError());
+        if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        return false;
+    }
+
+    p->egl_display = display;
+    p->egl_surface = surface != EGL_NO_SURFACE ? surface : NULL;
+    p->gl_context = context;
+    return true;
+}
+#endif
+
+bool platform_init_offscreen(Platform* p) {
+    memset(p, 0, sizeof(Platform));
+    p->offscreen = true;
+
+#ifdef VEXIQ_EGL
+    if (!egl_init_offscreen(p)) return false;
+#else
+    // Hidden 1x1 window: still needs a display, but nothing is shown
+    if (!sdl_initialized) {
+        if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) < 0) {
+            fprintf(stderr, "Failed to initialize SDL: %s\n", SDL_GetError());
+            return false;
+        }
+        sdl_initialized = true;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
+    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+    SDL_Window* window = SDL_CreateWindow("vexiq offscreen", 0, 0, 1, 1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (!window) {
+        fprintf(stderr, "Failed to create offscreen window (build with -DVEXIQ_EGL=ON for no display): %s\n",
+                SDL_GetError());
+        return false;
+    }
+    SDL_GLContext gl_context = SDL_GL_CreateContext(window);
+    if (!gl_context) {
+        fprintf(stderr, "Failed to create OpenGL context: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        return false;
+    }
+    p->window = window;
+    p->gl_context = gl_context;
+#endif
+
+    if (!init_glew(true)) {
+        platform_shutdown(p);
+        return false;
+    }
+    print_gl_info();
+    return true;
+}
+
 void platform_shutdown(Platform* p) {
+#ifdef VEXIQ_EGL
+    if (p->egl_display) {
+        EGLDisplay display = (EGLDisplay)p->egl_display;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (p->egl_surface) eglDestroySurface(display, (EGLSurface)p->egl_surface);
+        if (p->gl_context) eglDestroyContext(display, (EGLContext)p->gl_context);
+        eglTerminate(display);
+        p->egl_display = NULL;
+        p->egl_surface = NULL;
+        p->gl_context = NULL;
+        return;
+    }
+#endif
     if (p->gl_context) {
         SDL_GL_DeleteContext(p->gl_context);
         p->gl_context = NULL;
@@ -7,8 +7,11 @@
 #define MAX_KEYS 512
 
 typedef struct Platform {
-    void* window;       // SDL_Window* internally
-    void* gl_context;   // SDL_GLContext internally
+    void* window;       // SDL_Window* internally (NULL for an offscreen context)
+    void* gl_context;   // SDL_GLContext internally (EGLContext when offscreen)
+    void* egl_display;  // EGLDisplay of an offscreen context
+    void* egl_surface;  // Its 1x1 pbuffer (NULL = surfaceless)
+    bool offscreen;     // No window: everything renders into framebuffer objects
     int width;
     int height;
     bool should_quit;
@@ -36,6 +39,11 @@ typedef struct InputState {
 bool platform_init(Platform* p, const char* title, int width, int height);
 void platform_shutdown(Platform* p);
 
+// GL 3.3 context without a window, for headless rendering (robot cameras).
+// Built with VEXIQ_EGL this is an EGL pbuffer or surfaceless context and
+// needs no display server; otherwise a hidden SDL window.
+bool platform_init_offscreen(Platform* p);
+
 // Event callback type (for custom event handlers like gamepad)
 // The event parameter is SDL_Event* but typed as void* to avoid SDL dependency in header
 typedef void (*PlatformEventCallback)(void* event, void* user_data);
@@ -1,17 +1,28 @@
 /*
  * Debug Renderer Implementation
- * Uses immediate-mode style API with batched rendering
+ * Uses immediate-mode style API with batched rendering.
+ * Lines stream through a ring buffer; boxes and cylinders are instanced
+ * draws of static unit shapes.
  */
 
 #include "debug.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <math.h>
 #include <vector>
 
-// Maximum vertices per batch
-#define DEBUG_MAX_VERTICES 65536
+// Initial streaming capacity per ring section (grows on demand)
+#define DEBUG_INITIAL_VERTICES 65536
+#define DEBUG_INITIAL_INSTANCES 4096
+
+// Ring sections in flight (CPU writes one while the GPU reads the others)
+#define DEBUG_RING_SECTIONS 3
+
+// Unit wireframe shapes in the static shape buffer
+#define DEBUG_CYLINDER_SEGMENTS 16
 
 // Vertex: position + color
 struct DebugVertex {
@@ -19,6 +30,24 @@ struct DebugVertex {
     float r, g, b;
 };
 
+// Instanced wireframe: unit shape transformed by a column-major model matrix
+struct DebugInstance {
+    float model[16];
+    float r, g, b;
+};
+
+// Streaming vertex buffer
+// With GL_ARB_buffer_storage the buffer is mapped once (persistent, coherent)
+// and split into DEBUG_RING_SECTIONS sections guarded by fences. Otherwise the
+// whole buffer is orphaned with glBufferData before each upload.
+struct DebugStream {
+    GLuint vbo;
+    size_t stride;
+    size_t capacity;           // Elements per section
+    uint8_t* mapped;           // Persistent mapping (NULL when orphaning)
+    GLsync fences[DEBUG_RING_SECTIONS];
+};
+
 // Shader sources
 static const char* debug_vert_src = R"(
 #version 330 core
@@ -32,6 +61,23 @@ void main() {
 }
 )";
 
+static const char* debug_instanced_vert_src = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec4 aModel0;
+layout (location = 3) in vec4 aModel1;
+layout (location = 4) in vec4 aModel2;
+layout (location = 5) in vec4 aModel3;
+layout (location = 6) in vec3 aColor;
+out vec3 vertColor;
+uniform mat4 viewProjection;
+void main() {
+    vertColor = aColor;
+    mat4 model = mat4(aModel0, aModel1, aModel2, aModel3);
+    gl_Position = viewProjection * model * vec4(aPos, 1.0);
+}
+)";
+
 static const char* debug_frag_src = R"(
 #version 330 core
 in vec3 vertColor;
@@ -45,21 +91,34 @@ void main() {
 static struct {
     GLuint shader;
     GLint vp_loc;
-    GLuint vao;
-    GLuint vbo;
-
-    std::vector<DebugVertex> vertices;
+    GLuint instanced_shader;
+    GLint instanced_vp_loc;
+
+    GLuint vao;                // Lines: stream vertices
+    GLuint instanced_vao;      // Shapes: static unit shapes + stream instances
+    GLuint shape_vbo;
+    GLint box_first, box_count;
+    GLint cylinder_first, cylinder_count;
+
+    bool persistent;           // GL_ARB_buffer_storage available
+    int section;               // Ring section written this batch
+    DebugStream lines;
+    DebugStream instances;
+
+    // Batch lists, in the frame arena passed to debug_begin()
+    ArenaVector<DebugVertex> vertices;
+    ArenaVector<DebugInstance> boxes;
+    ArenaVector<DebugInstance> cylinders;
+    size_t vertex_hint;        // Largest batch so far (reserved up front)
+    size_t instance_hint;
     Mat4 view_projection;
     bool initialized;
     bool in_frame;
 } g_debug;
 
-bool debug_init(void) {
-    if (g_debug.initialized) return true;
-
-    // Compile shaders
+static GLuint compile_program(const char* vert_src, const char* frag_src) {
     GLuint vert = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vert, 1, &debug_vert_src, NULL);
+    glShaderSource(vert, 1, &vert_src, NULL);
     glCompileShader(vert);
 
     GLint success;
@@ -68,11 +127,12 @@ bool debug_init(void) {
         char log[512];
         glGetShaderInfoLog(vert, sizeof(log), NULL, log);
         fprintf(stderr, "[Debug] Vertex shader error: %s\n", log);
-        return false;
+        glDeleteShader(vert);
+        return 0;
     }
 
     GLuint frag = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(frag, 1, &debug_frag_src, NULL);
+    glShaderSource(frag, 1, &frag_src, NULL);
     glCompileShader(frag);
 
     glGetShaderiv(frag, GL_COMPILE_STATUS, &success);
@@ -81,49 +141,218 @@ bool debug_init(void) {
         glGetShaderInfoLog(frag, sizeof(log), NULL, log);
         fprintf(stderr, "[Debug] Fragment shader error: %s\n", log);
         glDeleteShader(vert);
-        return false;
+        glDeleteShader(frag);
+        return 0;
     }
 
-    g_debug.shader = glCreateProgram();
-    glAttachShader(g_debug.shader, vert);
-    glAttachShader(g_debug.shader, frag);
-    glLinkProgram(g_debug.shader);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vert);
+    glAttachShader(program, frag);
+    glLinkProgram(program);
     glDeleteShader(vert);
     glDeleteShader(frag);
 
-    glGetProgramiv(g_debug.shader, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
         char log[512];
-        glGetProgramInfoLog(g_debug.shader, sizeof(log), NULL, log);
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
         fprintf(stderr, "[Debug] Shader link error: %s\n", log);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// (Re)allocate stream storage for capacity elements per section
+static void stream_allocate(DebugStream* stream, size_t capacity) {
+    if (stream->vbo) {
+        if (stream->mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &stream->vbo);
+    }
+    for (int i = 0; i < DEBUG_RING_SECTIONS; i++) {
+        if (stream->fences[i]) glDeleteSync(stream->fences[i]);
+        stream->fences[i] = 0;
+    }
+
+    stream->capacity = capacity;
+    stream->mapped = NULL;
+    glGenBuffers(1, &stream->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+
+    if (g_debug.persistent) {
+        GLsizeiptr size = (GLsizeiptr)(capacity * stream->stride * DEBUG_RING_SECTIONS);
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        stream->mapped = (uint8_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(capacity * stream->stride), NULL, GL_STREAM_DRAW);
+    }
+}
+
+static void stream_init(DebugStream* stream, size_t stride, size_t capacity) {
+    memset(stream, 0, sizeof(*stream));
+    stream->stride = stride;
+    stream_allocate(stream, capacity);
+}
+
+static void stream_destroy(DebugStream* stream) {
+    for (int i = 0; i < DEBUG_RING_SECTIONS; i++) {
+        if (stream->fences[i]) glDeleteSync(stream->fences[i]);
+    }
+    if (stream->mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    if (stream->vbo) glDeleteBuffers(1, &stream->vbo);
+    memset(stream, 0, sizeof(*stream));
+}
+
+// Copy count elements into the current section, growing the buffer if needed
+// Leaves the stream bound to GL_ARRAY_BUFFER; returns the byte offset of the data
+static size_t stream_write(DebugStream* stream, const void* data, size_t count) {
+    if (count > stream->capacity) {
+        size_t capacity = stream->capacity;
+        while (capacity < count) capacity *= 2;
+        stream_allocate(stream, capacity);
+    }
+
+    size_t bytes = count * stream->stride;
+    glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+    if (!stream->mapped) {
+        // Orphan the old storage so the driver doesn't stall on the previous batch
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(stream->capacity * stream->stride), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, data);
+        return 0;
+    }
+
+    // Wait until the GPU has finished reading this section
+    GLsync* fence = &stream->fences[g_debug.section];
+    if (*fence) {
+        GLenum result = glClientWaitSync(*fence, 0, 0);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(*fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+        glDeleteSync(*fence);
+        *fence = 0;
+    }
+
+    size_t offset = (size_t)g_debug.section * stream->capacity * stream->stride;
+    memcpy(stream->mapped + offset, data, bytes);
+    return offset;
+}
+
+// Fence the current section after the draws that read it
+static void stream_fence(DebugStream* stream, bool written) {
+    if (!stream->mapped || !written) return;
+    stream->fences[g_debug.section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// Point the per-instance attributes at offset in the instance stream
+static void bind_instance_attributes(size_t offset) {
+    glBindBuffer(GL_ARRAY_BUFFER, g_debug.instances.vbo);
+    for (int c = 0; c < 4; c++) {
+        glVertexAttribPointer(2 + c, 4, GL_FLOAT, GL_FALSE, sizeof(DebugInstance),
+                              (void*)(offset + c * 4 * sizeof(float)));
+    }
+    glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(DebugInstance),
+                          (void*)(offset + offsetof(DebugInstance, r)));
+}
+
+// Unit box [-1, 1]^3 and unit cylinder (radius 1, y in [-1, 1]) as line lists
+static void build_unit_shapes(std::vector<float>* out) {
+    static const int edges[12][2] = {
+        {0,1}, {1,3}, {3,2}, {2,0},  // Bottom face
+        {4,5}, {5,7}, {7,6}, {6,4},  // Top face
+        {0,4}, {1,5}, {2,6}, {3,7}   // Vertical edges
+    };
+    g_debug.box_first = 0;
+    for (int e = 0; e < 12; e++) {
+        for (int v = 0; v < 2; v++) {
+            int corner = edges[e][v];
+            out->push_back((corner & 1) ? 1.0f : -1.0f);
+            out->push_back((corner & 4) ? 1.0f : -1.0f);
+            out->push_back((corner & 2) ? 1.0f : -1.0f);
+        }
+    }
+    g_debug.box_count = (GLint)(out->size() / 3);
+
+    g_debug.cylinder_first = g_debug.box_count;
+    float prev_x = 1.0f, prev_z = 0.0f;
+    for (int i = 1; i <= DEBUG_CYLINDER_SEGMENTS; i++) {
+        float angle = (float)i / DEBUG_CYLINDER_SEGMENTS * 2.0f * 3.14159265f;
+        float x = cosf(angle), z = sinf(angle);
+        const float lines[3][6] = {
+            {prev_x, 1.0f, prev_z, x, 1.0f, z},    // Top circle
+            {prev_x, -1.0f, prev_z, x, -1.0f, z},  // Bottom circle
+            {x, -1.0f, z, x, 1.0f, z}              // Vertical line
+        };
+        // Vertical lines only every 4th segment
+        int line_count = (i % 4 == 0) ? 3 : 2;
+        for (int l = 0; l < line_count; l++) {
+            out->insert(out->end(), lines[l], lines[l] + 6);
+        }
+        prev_x = x;
+        prev_z = z;
+    }
+    g_debug.cylinder_count = (GLint)(out->size() / 3) - g_debug.cylinder_first;
+}
+
+bool debug_init(void) {
+    if (g_debug.initialized) return true;
+
+    g_debug.shader = compile_program(debug_vert_src, debug_frag_src);
+    if (!g_debug.shader) return false;
+    g_debug.instanced_shader = compile_program(debug_instanced_vert_src, debug_frag_src);
+    if (!g_debug.instanced_shader) {
+        glDeleteProgram(g_debug.shader);
         return false;
     }
 
     g_debug.vp_loc = glGetUniformLocation(g_debug.shader, "viewProjection");
+    g_debug.instanced_vp_loc = glGetUniformLocation(g_debug.instanced_shader, "viewProjection");
 
-    // Create VAO/VBO
-    glGenVertexArrays(1, &g_debug.vao);
-    glGenBuffers(1, &g_debug.vbo);
+    // Persistent mapping needs GL 4.4 or GL_ARB_buffer_storage; otherwise orphan
+    g_debug.persistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+    g_debug.section = 0;
+    stream_init(&g_debug.lines, sizeof(DebugVertex), DEBUG_INITIAL_VERTICES);
+    stream_init(&g_debug.instances, sizeof(DebugInstance), DEBUG_INITIAL_INSTANCES);
 
+    // Line VAO (attribute pointers are refreshed per batch for the ring offset)
+    glGenVertexArrays(1, &g_debug.vao);
     glBindVertexArray(g_debug.vao);
-    glBindBuffer(GL_ARRAY_BUFFER, g_debug.vbo);
-    glBufferData(GL_ARRAY_BUFFER, DEBUG_MAX_VERTICES * sizeof(DebugVertex), NULL, GL_DYNAMIC_DRAW);
-
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)0);
     glEnableVertexAttribArray(0);
-
-    // Color attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)(3 * sizeof(float)));
     glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
 
+    // Static unit shapes
+    std::vector<float> shape_vertices;
+    build_unit_shapes(&shape_vertices);
+    glGenBuffers(1, &g_debug.shape_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, g_debug.shape_vbo);
+    glBufferData(GL_ARRAY_BUFFER, shape_vertices.size() * sizeof(float), shape_vertices.data(), GL_STATIC_DRAW);
+
+    // Instanced VAO: unit shape position + per-instance model matrix and color
+    glGenVertexArrays(1, &g_debug.instanced_vao);
+    glBindVertexArray(g_debug.instanced_vao);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    for (int attr = 2; attr <= 6; attr++) {
+        glEnableVertexAttribArray(attr);
+        glVertexAttribDivisor(attr, 1);
+    }
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    g_debug.vertices.reserve(DEBUG_MAX_VERTICES);
+    g_debug.vertex_hint = 1024;
+    g_debug.instance_hint = 256;
     g_debug.initialized = true;
     g_debug.in_frame = false;
 
-    printf("[Debug] Renderer initialized\n");
+    printf("[Debug] Renderer initialized (%s streaming)\n",
+           g_debug.persistent ? "persistent-mapped" : "orphaned");
     return true;
 }
 
@@ -131,30 +360,61 @@ void debug_destroy(void) {
     if (!g_debug.initialized) return;
 
     glDeleteVertexArrays(1, &g_debug.vao);
-    glDeleteBuffers(1, &g_debug.vbo);
+    glDeleteVertexArrays(1, &g_debug.instanced_vao);
+    glDeleteBuffers(1, &g_debug.shape_vbo);
+    stream_destroy(&g_debug.lines);
+    stream_destroy(&g_debug.instances);
     glDeleteProgram(g_debug.shader);
+    glDeleteProgram(g_debug.instanced_shader);
 
-    g_debug.vertices.clear();
+    g_debug.vertices = ArenaVector<DebugVertex>();
+    g_debug.boxes = ArenaVector<DebugInstance>();
+    g_debug.cylinders = ArenaVector<DebugInstance>();
     g_debug.initialized = false;
 }
 
-void debug_begin(const Mat4* view, const Mat4* projection) {
+void debug_begin(const Mat4* view, const Mat4* projection, Arena* frame) {
     if (!g_debug.initialized) return;
 
     // Compute view-projection matrix
     g_debug.view_projection = mat4_mul(*projection, *view);
-    g_debug.vertices.clear();
+
+    // Fresh lists in this frame's arena, sized like the largest batch so far
+    // (boxes also take the cylinders for the upload)
+    g_debug.vertices = ArenaVector<DebugVertex>(ArenaAllocator<DebugVertex>(frame));
+    g_debug.boxes = ArenaVector<DebugInstance>(ArenaAllocator<DebugInstance>(frame));
+    g_debug.cylinders = ArenaVector<DebugInstance>(ArenaAllocator<DebugInstance>(frame));
+    g_debug.vertices.reserve(g_debug.vertex_hint);
+    g_debug.boxes.reserve(g_debug.instance_hint);
+    g_debug.cylinders.reserve(g_debug.instance_hint);
     g_debug.in_frame = true;
 }
 
 // Add a line to the batch
 static void add_line(float x1, float y1, float z1, float x2, float y2, float z2, float r, float g, float b) {
-    if (g_debug.vertices.size() + 2 > DEBUG_MAX_VERTICES) return;
-
     g_debug.vertices.push_back({x1, y1, z1, r, g, b});
     g_debug.vertices.push_back({x2, y2, z2, r, g, b});
 }
 
+// Queue a unit shape instance; columns are the scaled local axes plus the center
+static void add_instance(ArenaVector<DebugInstance>* list, const float axes[3][3], Vec3 center, Vec3 color) {
+    DebugInstance inst;
+    for (int c = 0; c < 3; c++) {
+        inst.model[c * 4 + 0] = axes[c][0];
+        inst.model[c * 4 + 1] = axes[c][1];
+        inst.model[c * 4 + 2] = axes[c][2];
+        inst.model[c * 4 + 3] = 0.0f;
+    }
+    inst.model[12] = center.x;
+    inst.model[13] = center.y;
+    inst.model[14] = center.z;
+    inst.model[15] = 1.0f;
+    inst.r = color.x;
+    inst.g = color.y;
+    inst.b = color.z;
+    list->push_back(inst);
+}
+
 void debug_draw_line(Vec3 a, Vec3 b, Vec3 color) {
     if (!g_debug.in_frame) return;
     add_line(a.x, a.y, a.z, b.x, b.y, b.z, color.x, color.y, color.z);
@@ -163,74 +423,49 @@ void debug_draw_line(Vec3 a, Vec3 b, Vec3 color) {
 void debug_draw_box(Vec3 center, Vec3 half_extents, Vec3 color) {
     if (!g_debug.in_frame) return;
 
-    float cx = center.x, cy = center.y, cz = center.z;
-    float hx = half_extents.x, hy = half_extents.y, hz = half_extents.z;
-    float r = color.x, g = color.y, b = color.z;
-
-    // 8 corners
-    float x0 = cx - hx, x1 = cx + hx;
-    float y0 = cy - hy, y1 = cy + hy;
-    float z0 = cz - hz, z1 = cz + hz;
-
-    // Bottom face (y0)
-    add_line(x0, y0, z0, x1, y0, z0, r, g, b);
-    add_line(x1, y0, z0, x1, y0, z1, r, g, b);
-    add_line(x1, y0, z1, x0, y0, z1, r, g, b);
-    add_line(x0, y0, z1, x0, y0, z0, r, g, b);
-
-    // Top face (y1)
-    add_line(x0, y1, z0, x1, y1, z0, r, g, b);
-    add_line(x1, y1, z0, x1, y1, z1, r, g, b);
-    add_line(x1, y1, z1, x0, y1, z1, r, g, b);
-    add_line(x0, y1, z1, x0, y1, z0, r, g, b);
-
-    // Vertical edges
-    add_line(x0, y0, z0, x0, y1, z0, r, g, b);
-    add_line(x1, y0, z0, x1, y1, z0, r, g, b);
-    add_line(x1, y0, z1, x1, y1, z1, r, g, b);
-    add_line(x0, y0, z1, x0, y1, z1, r, g, b);
+    const float axes[3][3] = {
+        {half_extents.x, 0.0f, 0.0f},
+        {0.0f, half_extents.y, 0.0f},
+        {0.0f, 0.0f, half_extents.z}
+    };
+    add_instance(&g_debug.boxes, axes, center, color);
 }
 
 void debug_draw_box_transformed(const Mat4* model, const float* min_bounds, const float* max_bounds, Vec3 color) {
     if (!g_debug.in_frame) return;
 
-    float r = color.x, g = color.y, b = color.z;
-
-    // 8 corners in local space
-    float corners[8][3];
-    for (int i = 0; i < 8; i++) {
-        corners[i][0] = (i & 1) ? max_bounds[0] : min_bounds[0];
-        corners[i][1] = (i & 2) ? max_bounds[1] : min_bounds[1];
-        corners[i][2] = (i & 4) ? max_bounds[2] : min_bounds[2];
+    // Local box center and half-size, carried through the model matrix
+    float local_center[3], half[3];
+    for (int k = 0; k < 3; k++) {
+        local_center[k] = (min_bounds[k] + max_bounds[k]) * 0.5f;
+        half[k] = (max_bounds[k] - min_bounds[k]) * 0.5f;
     }
 
-    // Transform corners to world space
-    float world[8][3];
-    for (int i = 0; i < 8; i++) {
-        float x = corners[i][0], y = corners[i][1], z = corners[i][2];
-        world[i][0] = model->m[0]*x + model->m[4]*y + model->m[8]*z + model->m[12];
-        world[i][1] = model->m[1]*x + model->m[5]*y + model->m[9]*z + model->m[13];
-        world[i][2] = model->m[2]*x + model->m[6]*y + model->m[10]*z + model->m[14];
+    const float* m = model->m;
+    float axes[3][3];
+    for (int c = 0; c < 3; c++) {
+        for (int row = 0; row < 3; row++) axes[c][row] = m[c * 4 + row] * half[c];
     }
+    Vec3 center = vec3(
+        m[0]*local_center[0] + m[4]*local_center[1] + m[8]*local_center[2] + m[12],
+        m[1]*local_center[0] + m[5]*local_center[1] + m[9]*local_center[2] + m[13],
+        m[2]*local_center[0] + m[6]*local_center[1] + m[10]*local_center[2] + m[14]);
+    add_instance(&g_debug.boxes, axes, center, color);
+}
+
+void debug_draw_obb(const OBB* obb, Vec3 color) {
+    if (!g_debug.in_frame) return;
 
-    // Draw 12 edges
-    // Bottom face: 0-1, 1-3, 3-2, 2-0
-    add_line(world[0][0], world[0][1], world[0][2], world[1][0], world[1][1], world[1][2], r, g, b);
-    add_line(world[1][0], world[1][1], world[1][2], world[3][0], world[3][1], world[3][2], r, g, b);
-    add_line(world[3][0], world[3][1], world[3][2], world[2][0], world[2][1], world[2][2], r, g, b);
-    add_line(world[2][0], world[2][1], world[2][2], world[0][0], world[0][1], world[0][2], r, g, b);
-
-    // Top face: 4-5, 5-7, 7-6, 6-4
-    add_line(world[4][0], world[4][1], world[4][2], world[5][0], world[5][1], world[5][2], r, g, b);
-    add_line(world[5][0], world[5][1], world[5][2], world[7][0], world[7][1], world[7][2], r, g, b);
-    add_line(world[7][0], world[7][1], world[7][2], world[6][0], world[6][1], world[6][2], r, g, b);
-    add_line(world[6][0], world[6][1], world[6][2], world[4][0], world[4][1], world[4][2], r, g, b);
-
-    // Vertical edges: 0-4, 1-5, 2-6, 3-7
-    add_line(world[0][0], world[0][1], world[0][2], world[4][0], world[4][1], world[4][2], r, g, b);
-    add_line(world[1][0], world[1][1], world[1][2], world[5][0], world[5][1], world[5][2], r, g, b);
-    add_line(world[2][0], world[2][1], world[2][2], world[6][0], world[6][1], world[6][2], r, g, b);
-    add_line(world[3][0], world[3][1], world[3][2], world[7][0], world[7][1], world[7][2], r, g, b);
+    // Local axis k is column k of the row-major rotation
+    const float* r = obb->rotation;
+    const float half[3] = {obb->half_extents.x, obb->half_extents.y, obb->half_extents.z};
+    float axes[3][3];
+    for (int k = 0; k < 3; k++) {
+        axes[k][0] = r[k] * half[k];
+        axes[k][1] = r[3 + k] * half[k];
+        axes[k][2] = r[6 + k] * half[k];
+    }
+    add_instance(&g_debug.boxes, axes, obb->center, color);
 }
 
 void debug_draw_axes(Vec3 pos, float length) {
@@ -247,53 +482,62 @@ void debug_draw_axes(Vec3 pos, float length) {
 void debug_draw_cylinder(Vec3 center, float radius, float half_height, Vec3 color) {
     if (!g_debug.in_frame) return;
 
-    float r = color.x, g = color.y, b = color.z;
-    int segments = 16;
-    float y_top = center.y + half_height;
-    float y_bot = center.y - half_height;
-
-    float prev_x = center.x + radius;
-    float prev_z = center.z;
-
-    for (int i = 1; i <= segments; i++) {
-        float angle = (float)i / segments * 2.0f * 3.14159265f;
-        float x = center.x + radius * cosf(angle);
-        float z = center.z + radius * sinf(angle);
-
-        // Top circle
-        add_line(prev_x, y_top, prev_z, x, y_top, z, r, g, b);
-        // Bottom circle
-        add_line(prev_x, y_bot, prev_z, x, y_bot, z, r, g, b);
-        // Vertical lines (every 4th segment)
-        if (i % 4 == 0) {
-            add_line(x, y_bot, z, x, y_top, z, r, g, b);
-        }
-
-        prev_x = x;
-        prev_z = z;
-    }
+    const float axes[3][3] = {
+        {radius, 0.0f, 0.0f},
+        {0.0f, half_height, 0.0f},
+        {0.0f, 0.0f, radius}
+    };
+    add_instance(&g_debug.cylinders, axes, center, color);
 }
 
 void debug_end(void) {
     if (!g_debug.initialized || !g_debug.in_frame) return;
-    if (g_debug.vertices.empty()) {
-        g_debug.in_frame = false;
-        return;
+    g_debug.in_frame = false;
+
+    size_t line_count = g_debug.vertices.size();
+    size_t box_count = g_debug.boxes.size();
+    size_t instance_count = box_count + g_debug.cylinders.size();
+    if (line_count > g_debug.vertex_hint) g_debug.vertex_hint = line_count;
+    if (instance_count > g_debug.instance_hint) g_debug.instance_hint = instance_count;
+    if (line_count == 0 && instance_count == 0) return;
+
+    // Boxes then cylinders share one instance upload
+    g_debug.boxes.insert(g_debug.boxes.end(), g_debug.cylinders.begin(), g_debug.cylinders.end());
+
+    if (line_count > 0) {
+        size_t offset = stream_write(&g_debug.lines, g_debug.vertices.data(), line_count);
+        glUseProgram(g_debug.shader);
+        glUniformMatrix4fv(g_debug.vp_loc, 1, GL_FALSE, g_debug.view_projection.m);
+
+        glBindVertexArray(g_debug.vao);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offset);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex),
+                              (void*)(offset + 3 * sizeof(float)));
+        glDrawArrays(GL_LINES, 0, (GLsizei)line_count);
     }
 
-    // Upload vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, g_debug.vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0,
-                    g_debug.vertices.size() * sizeof(DebugVertex),
-                    g_debug.vertices.data());
+    if (instance_count > 0) {
+        size_t offset = stream_write(&g_debug.instances, g_debug.boxes.data(), instance_count);
+        glUseProgram(g_debug.instanced_shader);
+        glUniformMatrix4fv(g_debug.instanced_vp_loc, 1, GL_FALSE, g_debug.view_projection.m);
 
-    // Render
-    glUseProgram(g_debug.shader);
-    glUniformMatrix4fv(g_debug.vp_loc, 1, GL_FALSE, g_debug.view_projection.m);
+        glBindVertexArray(g_debug.instanced_vao);
+        // GL 3.3 has no base instance, so cylinders re-point the instance attributes
+        if (box_count > 0) {
+            bind_instance_attributes(offset);
+            glDrawArraysInstanced(GL_LINES, g_debug.box_first, g_debug.box_count, (GLsizei)box_count);
+        }
+        if (instance_count > box_count) {
+            bind_instance_attributes(offset + box_count * sizeof(DebugInstance));
+            glDrawArraysInstanced(GL_LINES, g_debug.cylinder_first, g_debug.cylinder_count,
+                                  (GLsizei)(instance_count - box_count));
+        }
+    }
 
-    glBindVertexArray(g_debug.vao);
-    glDrawArrays(GL_LINES, 0, (GLsizei)g_debug.vertices.size());
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    g_debug.in_frame = false;
+    stream_fence(&g_debug.lines, line_count > 0);
+    stream_fence(&g_debug.instances, instance_count > 0);
+    g_debug.section = (g_debug.section + 1) % DEBUG_RING_SECTIONS;
 }
@@ -1,6 +1,12 @@
 /*
  * Debug Renderer
  * Provides wireframe rendering for debugging collision shapes, bounding boxes, etc.
+ *
+ * Boxes, OBBs and cylinders are queued as instances of unit shapes; lines are
+ * queued as vertices. debug_end() streams both into a triple-buffered ring
+ * (persistently mapped when GL_ARB_buffer_storage is available, orphaned
+ * otherwise) that grows as needed, so large batches are never truncated.
+ * The queued lists live in the frame arena passed to debug_begin().
  */
 
 #ifndef DEBUG_H
@@ -9,6 +15,8 @@
 #include <GL/glew.h>
 #include "../math/mat4.h"
 #include "../math/vec3.h"
+#include "../physics/obb.h"
+#include "../sim/arena.h"
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -22,7 +30,8 @@ bool debug_init(void);
 void debug_destroy(void);
 
 // Begin debug rendering frame (call before any debug draw calls)
-void debug_begin(const Mat4* view, const Mat4* projection);
+// frame: holds the queued shapes until debug_end(); reset it only after that
+void debug_begin(const Mat4* view, const Mat4* projection, Arena* frame);
 
 // Draw a wireframe box (axis-aligned in local space)
 // center: center of box in world coordinates
@@ -36,6 +45,9 @@ void debug_draw_box(Vec3 center, Vec3 half_extents, Vec3 color);
 // color: RGB color (0-1)
 void debug_draw_box_transformed(const Mat4* model, const float* min_bounds, const float* max_bounds, Vec3 color);
 
+// Draw a wireframe oriented bounding box (world-space OBB)
+void debug_draw_obb(const OBB* obb, Vec3 color);
+
 // Draw a line from A to B
 void debug_draw_line(Vec3 a, Vec3 b, Vec3 color);
 
@@ -1,4 +1,5 @@
 #include "floor.h"
+#include "render_queue.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -7,30 +8,25 @@
 #include "../third_party/stb_image.h"
 
 // Floor vertex shader (with texture coords)
-static const char* floor_vert_src = R"(
-#version 330 core
+static const char* floor_vert_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 out vec3 worldPos;
 out vec2 texCoord;
-uniform mat4 view;
-uniform mat4 projection;
 void main() {
     worldPos = aPos;
     texCoord = aTexCoord;
-    gl_Position = projection * view * vec4(aPos, 1.0);
+    gl_Position = u_projection * u_view * vec4(aPos, 1.0);
 }
 )";
 
 // Floor fragment shader - VEX IQ field with optional tile texture
-static const char* floor_frag_src = R"(
-#version 330 core
+static const char* floor_frag_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 in vec3 worldPos;
 in vec2 texCoord;
 out vec4 FragColor;
 
 uniform float gridSize;
-uniform vec3 cameraPos;
 uniform float fieldWidth;   // 96 inches (8 ft)
 uniform float fieldDepth;   // 72 inches (6 ft)
 uniform sampler2D tileTexture;
@@ -81,7 +77,7 @@ void main() {
     baseColor = mix(baseColor, vec3(0.3, 0.3, 1.0), zAxis * 0.5);
 
     // Subtle distance fog
-    float dist = length(worldPos.xz - cameraPos.xz);
+    float dist = length(worldPos.xz - u_camera_pos.xz);
     float fog = 1.0 - exp(-dist * 0.001);
     baseColor = mix(baseColor, vec3(0.15, 0.15, 0.18), fog * 0.3);
 
@@ -90,34 +86,28 @@ void main() {
 )";
 
 // Wall vertex shader
-static const char* wall_vert_src = R"(
-#version 330 core
+static const char* wall_vert_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 out vec3 worldPos;
 out vec3 normal;
-uniform mat4 view;
-uniform mat4 projection;
 void main() {
     worldPos = aPos;
     normal = aNormal;
-    gl_Position = projection * view * vec4(aPos, 1.0);
+    gl_Position = u_projection * u_view * vec4(aPos, 1.0);
 }
 )";
 
 // Wall fragment shader - simple gray walls
-static const char* wall_frag_src = R"(
-#version 330 core
+static const char* wall_frag_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 in vec3 worldPos;
 in vec3 normal;
 out vec4 FragColor;
-uniform vec3 cameraPos;
 uniform float wallHeight;
 
 void main() {
     // Simple directional lighting
-    vec3 lightDir = normalize(vec3(0.5, 1.0, 0.3));
-    float diff = max(dot(normalize(normal), lightDir), 0.0);
+    float diff = max(dot(normalize(normal), u_light_dir.xyz), 0.0);
     float ambient = 0.4;
     float lighting = ambient + diff * 0.6;
 
@@ -257,6 +247,19 @@ bool floor_init(Floor* f, float size, float grid_size, float field_width, float
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 
+    // Constant uniforms are set once; camera and light come from FrameData
+    render_frame_bind_program(f->shader.program);
+    render_frame_bind_program(f->wall_shader.program);
+    shader_use(&f->shader);
+    shader_set_float(&f->shader, "gridSize", f->grid_size);
+    shader_set_float(&f->shader, "fieldWidth", f->field_width);
+    shader_set_float(&f->shader, "fieldDepth", f->field_depth);
+    shader_set_int(&f->shader, "tileTexture", 0);
+    shader_set_int(&f->shader, "useTexture", f->texture ? 1 : 0);
+    shader_use(&f->wall_shader);
+    shader_set_float(&f->wall_shader, "wallHeight", f->wall_height);
+    glUseProgram(0);
+
     printf("[Floor] Initialized: %.0fx%.0f\" field with %.0f\" walls\n",
            field_width, field_depth, wall_height);
     return true;
@@ -274,40 +277,37 @@ void floor_destroy(Floor* f) {
     }
 }
 
-void floor_render(Floor* f, Mat4* view, Mat4* projection, Vec3 camera_pos) {
-    // Render floor
-    shader_use(&f->shader);
-    shader_set_mat4(&f->shader, "view", view);
-    shader_set_mat4(&f->shader, "projection", projection);
-    shader_set_float(&f->shader, "gridSize", f->grid_size);
-    shader_set_float(&f->shader, "fieldWidth", f->field_width);
-    shader_set_float(&f->shader, "fieldDepth", f->field_depth);
-    shader_set_vec3(&f->shader, "cameraPos", camera_pos);
-
-    // Bind texture if available
+// Queued floor surface
+static void floor_draw_surface(const RenderItem* item, bool rebound) {
+    (void)rebound;
+    const Floor* f = (const Floor*)item->object;
     if (f->texture) {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, f->texture);
-        shader_set_int(&f->shader, "tileTexture", 0);
-        shader_set_int(&f->shader, "useTexture", 1);
-    } else {
-        shader_set_int(&f->shader, "useTexture", 0);
     }
-
-    glBindVertexArray(f->vao);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
-
-    // Render walls
-    shader_use(&f->wall_shader);
-    shader_set_mat4(&f->wall_shader, "view", view);
-    shader_set_mat4(&f->wall_shader, "projection", projection);
-    shader_set_vec3(&f->wall_shader, "cameraPos", camera_pos);
-    shader_set_float(&f->wall_shader, "wallHeight", f->wall_height);
+}
 
-    glBindVertexArray(f->wall_vao);
+// Queued walls
+static void floor_draw_walls(const RenderItem* item, bool rebound) {
+    (void)rebound;
+    const Floor* f = (const Floor*)item->object;
     glDrawArrays(GL_TRIANGLES, 0, f->wall_vertex_count);
-    glBindVertexArray(0);
+}
 
-    glUseProgram(0);
+void floor_queue(Floor* f, RenderQueue* queue) {
+    RenderItem item = {};
+    item.object = f;
+
+    item.key = render_queue_key(RENDER_PASS_OPAQUE, f->shader.program, f->vao, 0);
+    item.program = f->shader.program;
+    item.vao = f->vao;
+    item.draw = floor_draw_surface;
+    render_queue_push(queue, &item);
+
+    item.key = render_queue_key(RENDER_PASS_OPAQUE, f->wall_shader.program, f->wall_vao, 0);
+    item.program = f->wall_shader.program;
+    item.vao = f->wall_vao;
+    item.draw = floor_draw_walls;
+    render_queue_push(queue, &item);
 }
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <GL/glew.h>
 #include "shader.h"
+#include "render_queue.h"
 #include "../math/mat4.h"
 #include "../math/vec3.h"
 
@@ -37,7 +38,7 @@ bool floor_init(Floor* f, float size, float grid_size, float field_width, float
 // Cleanup
 void floor_destroy(Floor* f);
 
-// Render floor and walls
-void floor_render(Floor* f, Mat4* view, Mat4* projection, Vec3 camera_pos);
+// Queue the floor and walls
+void floor_queue(Floor* f, RenderQueue* queue);
 
 #endif // FLOOR_H
@@ -0,0 +1,68 @@
+/*
+ * View Frustum Implementation
+ */
+
+#include "frustum.h"
+#include <math.h>
+
+void frustum_from_matrix(Frustum* frustum, const Mat4* view_projection) {
+    // Row r of the matrix is (m[r], m[4 + r], m[8 + r], m[12 + r])
+    const float* m = view_projection->m;
+    for (int i = 0; i < 6; i++) {
+        int row = i / 2;
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        float* plane = frustum->planes[i];
+        for (int c = 0; c < 4; c++) {
+            plane[c] = m[c * 4 + 3] + sign * m[c * 4 + row];
+        }
+
+        float len = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (len > 0.0f) {
+            for (int c = 0; c < 4; c++) plane[c] /= len;
+        }
+    }
+}
+
+static float plane_distance(const float* plane, Vec3 p) {
+    return plane[0] * p.x + plane[1] * p.y + plane[2] * p.z + plane[3];
+}
+
+bool frustum_test_sphere(const Frustum* frustum, Vec3 center, float radius) {
+    for (int i = 0; i < 6; i++) {
+        if (plane_distance(frustum->planes[i], center) < -radius) return false;
+    }
+    return true;
+}
+
+bool frustum_test_aabb(const Frustum* frustum, const AABB* aabb) {
+    Vec3 center = vec3_scale(vec3_add(aabb->min, aabb->max), 0.5f);
+    Vec3 half = vec3_scale(vec3_sub(aabb->max, aabb->min), 0.5f);
+    for (int i = 0; i < 6; i++) {
+        const float* plane = frustum->planes[i];
+        float radius = half.x * fabsf(plane[0]) + half.y * fabsf(plane[1]) + half.z * fabsf(plane[2]);
+        if (plane_distance(plane, center) < -radius) return false;
+    }
+    return true;
+}
+
+bool frustum_test_obb(const Frustum* frustum, const OBB* obb) {
+    const float* r = obb->rotation;
+    for (int i = 0; i < 6; i++) {
+        const float* plane = frustum->planes[i];
+        // Box radius along the plane normal; local axis k is column k of the rotation
+        float radius = 0.0f;
+        const float extents[3] = {obb->half_extents.x, obb->half_extents.y, obb->half_extents.z};
+        for (int k = 0; k < 3; k++) {
+            float d = plane[0] * r[k] + plane[1] * r[3 + k] + plane[2] * r[6 + k];
+            radius += extents[k] * fabsf(d);
+        }
+        if (plane_distance(plane, obb->center) < -radius) return false;
+    }
+    return true;
+}
+
+float frustum_sphere_pixels(Vec3 eye, Vec3 center, float radius, float pixel_scale) {
+    float distance = vec3_length(vec3_sub(center, eye));
+    if (distance <= radius) return INFINITY;  // Camera inside the sphere
+    return 2.0f * radius * pixel_scale / distance;
+}
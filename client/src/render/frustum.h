@@ -0,0 +1,41 @@
+/*
+ * View Frustum
+ * Camera frustum planes for culling parts, game objects and debug geometry.
+ *
+ * Planes are extracted from projection * view, so the frustum matches what
+ * the camera actually draws. All tests are conservative: a volume that
+ * might be visible is reported visible.
+ *
+ * Usage:
+ *   Mat4 view_projection = mat4_mul(projection, view);
+ *   Frustum frustum;
+ *   frustum_from_matrix(&frustum, &view_projection);
+ *   if (frustum_test_obb(&frustum, sim_submodel_world_obb(robot, sm))) { ... }
+ */
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "../math/mat4.h"
+#include "../physics/obb.h"
+#include <stdbool.h>
+
+// Plane order: left, right, bottom, top, near, far
+// Each plane is (nx, ny, nz, d) with unit normal pointing inside: n.p + d >= 0
+typedef struct Frustum {
+    float planes[6][4];
+} Frustum;
+
+// Extract the six planes of a (column-major) view-projection matrix
+void frustum_from_matrix(Frustum* frustum, const Mat4* view_projection);
+
+// Visibility tests (false only if the volume is entirely outside one plane)
+bool frustum_test_sphere(const Frustum* frustum, Vec3 center, float radius);
+bool frustum_test_aabb(const Frustum* frustum, const AABB* aabb);
+bool frustum_test_obb(const Frustum* frustum, const OBB* obb);
+
+// Approximate on-screen diameter in pixels of a sphere seen from eye
+// pixel_scale is mesh_lod_pixel_scale() of the projection
+float frustum_sphere_pixels(Vec3 eye, Vec3 center, float radius, float pixel_scale);
+
+#endif // FRUSTUM_H
@@ -46,7 +46,13 @@
  *   - Vertex positions (VEC3 float)
  *   - Vertex normals (VEC3 float)
  *   - Vertex colors (VEC3 or VEC4 float) - defaults to white if missing
- *   - Triangle indices (SCALAR unsigned short or unsigned int)
+ *   - Triangle indices (SCALAR unsigned byte, short or int)
+ *
+ * LOADING:
+ *   The file is memory-mapped and accessors are decoded straight from the
+ *   mapped BIN chunk into a Vertex/index array sized from the accessor
+ *   counts. The only scratch is the NUL-terminated JSON copy the parser
+ *   needs, kept in a GlbLoader and reused across loads.
  *
  * COORDINATE SYSTEM:
  *   GLB files are in glTF standard coordinates:
@@ -54,7 +60,7 @@
  *     - Y: Up
  *     - Z: Front (toward viewer)
  *   This matches OpenGL, so no conversion needed when rendering.
- *   The coordinate conversion happens in build_ldraw_model_matrix()
+ *   The coordinate conversion happens in sim_part_world_matrix()
  *   which transforms the LDraw positions/rotations to OpenGL space.
  *
  * =============================================================================
@@ -66,6 +72,15 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // GLB constants
 #define GLB_MAGIC 0x46546C67  // "glTF"
 #define GLB_VERSION 2
@@ -144,67 +159,114 @@ static const char* json_array_element(const char* array_start, int index) {
     return NULL;
 }
 
-// Read data from buffer based on accessor info
-static bool read_accessor_data(
-    const uint8_t* bin_data,
-    size_t bin_size,
-    const char* json,
-    int accessor_index,
-    void* out_data,
-    size_t element_size,
-    size_t* out_count
-) {
-    // Find accessor
-    const char* accessors = json_find_key(json, "accessors");
-    if (!accessors) return false;
+// =============================================================================
+// File mapping
+// =============================================================================
 
-    const char* accessor = json_array_element(accessors, accessor_index);
-    if (!accessor) return false;
+typedef struct GlbMapping {
+    const uint8_t* data;
+    size_t size;
+} GlbMapping;
 
-    int buffer_view = json_get_int(accessor, "bufferView", -1);
-    int count = json_get_int(accessor, "count", 0);
-    int component_type = json_get_int(accessor, "componentType", 0);
-    int byte_offset_acc = json_get_int(accessor, "byteOffset", 0);
-
-    if (buffer_view < 0 || count == 0) return false;
-
-    // Find buffer view
-    const char* buffer_views = json_find_key(json, "bufferViews");
-    if (!buffer_views) return false;
+static bool map_file(const char* path, GlbMapping* out) {
+    out->data = NULL;
+    out->size = 0;
 
-    const char* bv = json_array_element(buffer_views, buffer_view);
-    if (!bv) return false;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
 
-    int byte_offset_bv = json_get_int(bv, "byteOffset", 0);
-    int byte_length = json_get_int(bv, "byteLength", 0);
-    int byte_stride = json_get_int(bv, "byteStride", 0);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    // The view keeps the file and mapping referenced
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (!data) return false;
+    out->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    out->size = (size_t)st.st_size;
+#endif
 
-    size_t total_offset = byte_offset_bv + byte_offset_acc;
-    if (total_offset + byte_length > bin_size) return false;
+    out->data = (const uint8_t*)data;
+    return true;
+}
 
-    const uint8_t* src = bin_data + total_offset;
-    uint8_t* dst = (uint8_t*)out_data;
+static void unmap_file(GlbMapping* mapping) {
+    if (mapping->data) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping->data);
+#else
+        munmap((void*)mapping->data, mapping->size);
+#endif
+    }
+    mapping->data = NULL;
+    mapping->size = 0;
+}
 
-    // Calculate actual stride
-    size_t actual_stride = byte_stride > 0 ? byte_stride : element_size;
+static uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
 
-    for (int i = 0; i < count; i++) {
-        memcpy(dst + i * element_size, src + i * actual_stride, element_size);
+// =============================================================================
+// Accessors
+// =============================================================================
+
+// Accessor resolved to a strided view into the BIN chunk
+typedef struct GlbAccessor {
+    const uint8_t* data;    // First element
+    size_t count;
+    size_t stride;          // Bytes between elements
+    int component_type;
+    int components;         // 1 (SCALAR) .. 4 (VEC4)
+} GlbAccessor;
+
+static size_t component_size(int component_type) {
+    switch (component_type) {
+        case COMPONENT_BYTE:
+        case COMPONENT_UNSIGNED_BYTE:  return 1;
+        case COMPONENT_SHORT:
+        case COMPONENT_UNSIGNED_SHORT: return 2;
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT:          return 4;
+        default:                       return 0;
     }
+}
 
-    *out_count = count;
-    return true;
+static int type_components(const char* type) {
+    if (strcmp(type, "SCALAR") == 0) return 1;
+    if (strcmp(type, "VEC2") == 0) return 2;
+    if (strcmp(type, "VEC4") == 0) return 4;
+    return 3;
 }
 
-// Read indices (handles different component types)
-static bool read_indices(
+// Resolve an accessor and check that every element lies inside the BIN chunk
+static bool find_accessor(
     const uint8_t* bin_data,
     size_t bin_size,
     const char* json,
     int accessor_index,
-    uint32_t* out_indices,
-    size_t* out_count
+    GlbAccessor* out
 ) {
+    // Find accessor
     const char* accessors = json_find_key(json, "accessors");
     if (!accessors) return false;
 
@@ -215,36 +277,80 @@ static bool read_indices(
     int count = json_get_int(accessor, "count", 0);
     int component_type = json_get_int(accessor, "componentType", 0);
     int byte_offset_acc = json_get_int(accessor, "byteOffset", 0);
+    char type_str[32] = "";
+    json_get_string(accessor, "type", type_str, sizeof(type_str));
 
-    if (buffer_view < 0 || count == 0) return false;
+    if (buffer_view < 0 || count <= 0 || byte_offset_acc < 0) return false;
 
+    // Find buffer view
     const char* buffer_views = json_find_key(json, "bufferViews");
+    if (!buffer_views) return false;
+
     const char* bv = json_array_element(buffer_views, buffer_view);
     if (!bv) return false;
 
     int byte_offset_bv = json_get_int(bv, "byteOffset", 0);
+    int byte_stride = json_get_int(bv, "byteStride", 0);
+    if (byte_offset_bv < 0 || byte_stride < 0) return false;
+
+    size_t comp_size = component_size(component_type);
+    if (comp_size == 0) return false;
+
+    out->components = type_components(type_str);
+    out->component_type = component_type;
+    out->count = (size_t)count;
+
+    size_t element_size = comp_size * out->components;
+    out->stride = byte_stride > 0 ? (size_t)byte_stride : element_size;
 
-    size_t total_offset = byte_offset_bv + byte_offset_acc;
-    const uint8_t* src = bin_data + total_offset;
-
-    for (int i = 0; i < count; i++) {
-        switch (component_type) {
-            case COMPONENT_UNSIGNED_BYTE:
-                out_indices[i] = src[i];
-                break;
-            case COMPONENT_UNSIGNED_SHORT:
-                out_indices[i] = ((const uint16_t*)src)[i];
-                break;
-            case COMPONENT_UNSIGNED_INT:
-                out_indices[i] = ((const uint32_t*)src)[i];
-                break;
-            default:
-                return false;
+    size_t total_offset = (size_t)byte_offset_bv + (size_t)byte_offset_acc;
+    if (total_offset > bin_size || bin_size - total_offset < element_size) return false;
+    if (out->count - 1 > (bin_size - total_offset - element_size) / out->stride) return false;
+
+    out->data = bin_data + total_offset;
+    return true;
+}
+
+// Component c of element i as a float (normalized for integer types)
+static float accessor_float(const GlbAccessor* acc, size_t i, int c) {
+    const uint8_t* p = acc->data + i * acc->stride;
+    switch (acc->component_type) {
+        case COMPONENT_FLOAT: {
+            float v;
+            memcpy(&v, p + c * sizeof(float), sizeof(v));
+            return v;
+        }
+        case COMPONENT_UNSIGNED_BYTE:
+            return p[c] / 255.0f;
+        case COMPONENT_UNSIGNED_SHORT: {
+            uint16_t v;
+            memcpy(&v, p + c * sizeof(uint16_t), sizeof(v));
+            return v / 65535.0f;
         }
+        default:
+            return 0.0f;
     }
+}
 
-    *out_count = count;
-    return true;
+// Element i of an index accessor
+static bool accessor_index(const GlbAccessor* acc, size_t i, uint32_t* out) {
+    const uint8_t* p = acc->data + i * acc->stride;
+    switch (acc->component_type) {
+        case COMPONENT_UNSIGNED_BYTE:
+            *out = p[0];
+            return true;
+        case COMPONENT_UNSIGNED_SHORT: {
+            uint16_t v;
+            memcpy(&v, p, sizeof(v));
+            *out = v;
+            return true;
+        }
+        case COMPONENT_UNSIGNED_INT:
+            memcpy(out, p, sizeof(*out));
+            return true;
+        default:
+            return false;
+    }
 }
 
 // Find attribute accessor index
@@ -254,85 +360,80 @@ static int find_attribute_accessor(const char* primitive, const char* attr_name)
     return json_get_int(attrs, attr_name, -1);
 }
 
-bool glb_load(const char* path, MeshData* out_mesh) {
-    memset(out_mesh, 0, sizeof(MeshData));
+// =============================================================================
+// Loading
+// =============================================================================
 
-    // Open file
-    FILE* f = fopen(path, "rb");
-    if (!f) {
-        fprintf(stderr, "[GLB] Failed to open: %s\n", path);
-        return false;
-    }
+void glb_loader_init(GlbLoader* loader) {
+    memset(loader, 0, sizeof(GlbLoader));
+}
 
-    // Get file size
-    fseek(f, 0, SEEK_END);
-    size_t file_size = ftell(f);
-    fseek(f, 0, SEEK_SET);
+void glb_loader_free(GlbLoader* loader) {
+    free(loader->json);
+    memset(loader, 0, sizeof(GlbLoader));
+}
 
-    // Read entire file
-    uint8_t* file_data = (uint8_t*)malloc(file_size);
-    if (!file_data) {
-        fclose(f);
-        return false;
+// Copy the JSON chunk into the loader's scratch, NUL-terminated for the parser
+static char* loader_copy_json(GlbLoader* loader, const uint8_t* src, size_t length) {
+    if (length + 1 > loader->json_capacity) {
+        size_t capacity = loader->json_capacity ? loader->json_capacity : 4096;
+        while (capacity < length + 1) capacity *= 2;
+        char* json = (char*)realloc(loader->json, capacity);
+        if (!json) return NULL;
+        loader->json = json;
+        loader->json_capacity = capacity;
     }
-    fread(file_data, 1, file_size, f);
-    fclose(f);
+    memcpy(loader->json, src, length);
+    loader->json[length] = '\0';
+    return loader->json;
+}
 
+// Decode the first primitive of a mapped GLB into out_mesh
+static bool decode_glb(GlbLoader* loader, const uint8_t* file_data, size_t file_size,
+                       MeshData* out_mesh) {
     // Parse header
     if (file_size < 12) {
         fprintf(stderr, "[GLB] File too small\n");
-        free(file_data);
         return false;
     }
 
-    uint32_t magic = *(uint32_t*)(file_data);
-    uint32_t version = *(uint32_t*)(file_data + 4);
-    uint32_t length = *(uint32_t*)(file_data + 8);
+    uint32_t magic = read_u32(file_data);
+    uint32_t version = read_u32(file_data + 4);
 
     if (magic != GLB_MAGIC || version != GLB_VERSION) {
         fprintf(stderr, "[GLB] Invalid header (magic=0x%X, version=%u)\n", magic, version);
-        free(file_data);
         return false;
     }
 
     // Parse JSON chunk
     size_t offset = 12;
-    if (offset + 8 > file_size) {
-        free(file_data);
-        return false;
-    }
+    if (offset + 8 > file_size) return false;
 
-    uint32_t json_length = *(uint32_t*)(file_data + offset);
-    uint32_t json_type = *(uint32_t*)(file_data + offset + 4);
+    uint32_t json_length = read_u32(file_data + offset);
+    uint32_t json_type = read_u32(file_data + offset + 4);
     offset += 8;
 
-    if (json_type != GLB_CHUNK_JSON || offset + json_length > file_size) {
+    if (json_type != GLB_CHUNK_JSON || json_length > file_size - offset) {
         fprintf(stderr, "[GLB] Invalid JSON chunk\n");
-        free(file_data);
         return false;
     }
 
-    char* json = (char*)malloc(json_length + 1);
-    memcpy(json, file_data + offset, json_length);
-    json[json_length] = '\0';
+    const char* json = loader_copy_json(loader, file_data + offset, json_length);
+    if (!json) return false;
     offset += json_length;
 
     // Parse binary chunk
     if (offset + 8 > file_size) {
         fprintf(stderr, "[GLB] Missing binary chunk\n");
-        free(json);
-        free(file_data);
         return false;
     }
 
-    uint32_t bin_length = *(uint32_t*)(file_data + offset);
-    uint32_t bin_type = *(uint32_t*)(file_data + offset + 4);
+    uint32_t bin_length = read_u32(file_data + offset);
+    uint32_t bin_type = read_u32(file_data + offset + 4);
     offset += 8;
 
-    if (bin_type != GLB_CHUNK_BIN || offset + bin_length > file_size) {
+    if (bin_type != GLB_CHUNK_BIN || bin_length > file_size - offset) {
         fprintf(stderr, "[GLB] Invalid binary chunk\n");
-        free(json);
-        free(file_data);
         return false;
     }
 
@@ -361,16 +462,12 @@ bool glb_load(const char* path, MeshData* out_mesh) {
 
     if (!primitives) {
         fprintf(stderr, "[GLB] No primitives found\n");
-        free(json);
-        free(file_data);
         return false;
     }
 
     const char* prim0 = json_array_element(primitives, 0);
     if (!prim0) {
         fprintf(stderr, "[GLB] No primitive[0] found\n");
-        free(json);
-        free(file_data);
         return false;
     }
 
@@ -382,129 +479,78 @@ bool glb_load(const char* path, MeshData* out_mesh) {
 
     if (pos_accessor < 0) {
         fprintf(stderr, "[GLB] No POSITION attribute\n");
-        free(json);
-        free(file_data);
         return false;
     }
 
-    // Read positions
-    float* positions = (float*)malloc(MAX_VERTICES * 3 * sizeof(float));
-    size_t pos_count = 0;
-    if (!read_accessor_data(bin_data, bin_length, json, pos_accessor, positions, 3 * sizeof(float), &pos_count)) {
+    // Positions must be float VEC3; they size the vertex array
+    GlbAccessor positions;
+    if (!find_accessor(bin_data, bin_length, json, pos_accessor, &positions) ||
+        positions.component_type != COMPONENT_FLOAT || positions.components < 3 ||
+        positions.count > UINT32_MAX) {
         fprintf(stderr, "[GLB] Failed to read positions\n");
-        free(positions);
-        free(json);
-        free(file_data);
         return false;
     }
 
-    // Read normals (optional)
-    float* normals = (float*)calloc(MAX_VERTICES * 3, sizeof(float));
+    // Normals (optional, float VEC3)
+    GlbAccessor normals;
     size_t norm_count = 0;
-    if (norm_accessor >= 0) {
-        read_accessor_data(bin_data, bin_length, json, norm_accessor, normals, 3 * sizeof(float), &norm_count);
-    }
-
-    // Read vertex colors (optional) - can be vec3 or vec4, float or normalized byte
-    float* colors = (float*)malloc(MAX_VERTICES * 4 * sizeof(float));
-    for (size_t i = 0; i < MAX_VERTICES; i++) {
-        colors[i * 4 + 0] = 0.7f;  // Default gray
-        colors[i * 4 + 1] = 0.7f;
-        colors[i * 4 + 2] = 0.7f;
-        colors[i * 4 + 3] = 1.0f;
+    if (norm_accessor >= 0 && find_accessor(bin_data, bin_length, json, norm_accessor, &normals) &&
+        normals.component_type == COMPONENT_FLOAT && normals.components >= 3) {
+        norm_count = normals.count;
     }
 
+    // Vertex colors (optional) - can be vec3 or vec4, float or normalized byte/short
+    GlbAccessor colors;
     size_t color_count = 0;
-    if (color_accessor >= 0) {
-        // Check component type and element count
-        const char* accessors = json_find_key(json, "accessors");
-        const char* acc = json_array_element(accessors, color_accessor);
-        if (acc) {
-            int comp_type = json_get_int(acc, "componentType", COMPONENT_FLOAT);
-            char type_str[32] = "";
-            json_get_string(acc, "type", type_str, sizeof(type_str));
-
-            bool is_vec4 = (strcmp(type_str, "VEC4") == 0);
-            int components = is_vec4 ? 4 : 3;
-
-            if (comp_type == COMPONENT_FLOAT) {
-                float* temp_colors = (float*)malloc(MAX_VERTICES * 4 * sizeof(float));
-                if (read_accessor_data(bin_data, bin_length, json, color_accessor, temp_colors, components * sizeof(float), &color_count)) {
-                    for (size_t i = 0; i < color_count; i++) {
-                        colors[i * 4 + 0] = temp_colors[i * components + 0];
-                        colors[i * 4 + 1] = temp_colors[i * components + 1];
-                        colors[i * 4 + 2] = temp_colors[i * components + 2];
-                        colors[i * 4 + 3] = is_vec4 ? temp_colors[i * components + 3] : 1.0f;
-                    }
-                }
-                free(temp_colors);
-            } else if (comp_type == COMPONENT_UNSIGNED_BYTE) {
-                uint8_t* temp_colors = (uint8_t*)malloc(MAX_VERTICES * 4);
-                if (read_accessor_data(bin_data, bin_length, json, color_accessor, temp_colors, components, &color_count)) {
-                    for (size_t i = 0; i < color_count; i++) {
-                        colors[i * 4 + 0] = temp_colors[i * components + 0] / 255.0f;
-                        colors[i * 4 + 1] = temp_colors[i * components + 1] / 255.0f;
-                        colors[i * 4 + 2] = temp_colors[i * components + 2] / 255.0f;
-                        colors[i * 4 + 3] = is_vec4 ? temp_colors[i * components + 3] / 255.0f : 1.0f;
-                    }
-                }
-                free(temp_colors);
-            } else if (comp_type == COMPONENT_UNSIGNED_SHORT) {
-                uint16_t* temp_colors = (uint16_t*)malloc(MAX_VERTICES * 4 * sizeof(uint16_t));
-                if (read_accessor_data(bin_data, bin_length, json, color_accessor, temp_colors, components * sizeof(uint16_t), &color_count)) {
-                    for (size_t i = 0; i < color_count; i++) {
-                        colors[i * 4 + 0] = temp_colors[i * components + 0] / 65535.0f;
-                        colors[i * 4 + 1] = temp_colors[i * components + 1] / 65535.0f;
-                        colors[i * 4 + 2] = temp_colors[i * components + 2] / 65535.0f;
-                        colors[i * 4 + 3] = is_vec4 ? temp_colors[i * components + 3] / 65535.0f : 1.0f;
-                    }
-                }
-                free(temp_colors);
-            }
-        }
+    if (color_accessor >= 0 && find_accessor(bin_data, bin_length, json, color_accessor, &colors) &&
+        (colors.component_type == COMPONENT_FLOAT ||
+         colors.component_type == COMPONENT_UNSIGNED_BYTE ||
+         colors.component_type == COMPONENT_UNSIGNED_SHORT)) {
+        if (colors.components != 4) colors.components = 3;
+        color_count = colors.count;
     }
 
-    // Read indices
-    uint32_t* indices = NULL;
+    // Indices (optional)
+    GlbAccessor indices;
     size_t index_count = 0;
-    if (indices_accessor >= 0) {
-        indices = (uint32_t*)malloc(MAX_INDICES * sizeof(uint32_t));
-        if (!read_indices(bin_data, bin_length, json, indices_accessor, indices, &index_count)) {
-            free(indices);
-            indices = NULL;
-            index_count = 0;
-        }
+    if (indices_accessor >= 0 && find_accessor(bin_data, bin_length, json, indices_accessor, &indices) &&
+        indices.count <= UINT32_MAX) {
+        index_count = indices.count;
     }
 
-    // Build vertex array
-    out_mesh->vertex_count = pos_count;
-    out_mesh->vertices = (Vertex*)malloc(pos_count * sizeof(Vertex));
+    // Build vertex array straight from the BIN chunk
+    size_t vertex_count = positions.count;
+    Vertex* vertices = (Vertex*)malloc(vertex_count * sizeof(Vertex));
+    if (!vertices) return false;
 
     // Initialize bounds
     out_mesh->min_bounds[0] = out_mesh->min_bounds[1] = out_mesh->min_bounds[2] = 1e10f;
     out_mesh->max_bounds[0] = out_mesh->max_bounds[1] = out_mesh->max_bounds[2] = -1e10f;
 
-    for (size_t i = 0; i < pos_count; i++) {
-        Vertex* v = &out_mesh->vertices[i];
+    for (size_t i = 0; i < vertex_count; i++) {
+        Vertex* v = &vertices[i];
 
-        v->position[0] = positions[i * 3 + 0];
-        v->position[1] = positions[i * 3 + 1];
-        v->position[2] = positions[i * 3 + 2];
+        memcpy(v->position, positions.data + i * positions.stride, sizeof(v->position));
 
         if (i < norm_count) {
-            v->normal[0] = normals[i * 3 + 0];
-            v->normal[1] = normals[i * 3 + 1];
-            v->normal[2] = normals[i * 3 + 2];
+            memcpy(v->normal, normals.data + i * normals.stride, sizeof(v->normal));
         } else {
             v->normal[0] = 0;
             v->normal[1] = 1;
             v->normal[2] = 0;
         }
 
-        v->color[0] = colors[i * 4 + 0];
-        v->color[1] = colors[i * 4 + 1];
-        v->color[2] = colors[i * 4 + 2];
-        v->color[3] = colors[i * 4 + 3];
+        if (i < color_count) {
+            v->color[0] = accessor_float(&colors, i, 0);
+            v->color[1] = accessor_float(&colors, i, 1);
+            v->color[2] = accessor_float(&colors, i, 2);
+            v->color[3] = colors.components == 4 ? accessor_float(&colors, i, 3) : 1.0f;
+        } else {
+            v->color[0] = 0.7f;  // Default gray
+            v->color[1] = 0.7f;
+            v->color[2] = 0.7f;
+            v->color[3] = 1.0f;
+        }
 
         // Update bounds
         for (int j = 0; j < 3; j++) {
@@ -513,20 +559,45 @@ bool glb_load(const char* path, MeshData* out_mesh) {
         }
     }
 
-    // Copy indices
-    if (indices && index_count > 0) {
-        out_mesh->index_count = index_count;
-        out_mesh->indices = (uint32_t*)malloc(index_count * sizeof(uint32_t));
-        memcpy(out_mesh->indices, indices, index_count * sizeof(uint32_t));
+    // Decode indices (an unsupported index type drops the index buffer)
+    uint32_t* index_data = NULL;
+    if (index_count > 0) {
+        index_data = (uint32_t*)malloc(index_count * sizeof(uint32_t));
+        for (size_t i = 0; index_data && i < index_count; i++) {
+            if (!accessor_index(&indices, i, &index_data[i])) {
+                free(index_data);
+                index_data = NULL;
+            }
+        }
+        if (!index_data) index_count = 0;
     }
 
-    // Cleanup
-    free(positions);
-    free(normals);
-    free(colors);
-    free(indices);
-    free(json);
-    free(file_data);
+    out_mesh->vertices = vertices;
+    out_mesh->vertex_count = (uint32_t)vertex_count;
+    out_mesh->indices = index_data;
+    out_mesh->index_count = (uint32_t)index_count;
+    if (index_count > 0) {
+        out_mesh->lod_count = 1;
+        out_mesh->lods[0].index_count = (uint32_t)index_count;
+    }
+    return true;
+}
+
+bool glb_load_with(GlbLoader* loader, const char* path, MeshData* out_mesh) {
+    memset(out_mesh, 0, sizeof(MeshData));
+
+    GlbMapping mapping;
+    if (!map_file(path, &mapping)) {
+        fprintf(stderr, "[GLB] Failed to open: %s\n", path);
+        return false;
+    }
+
+    bool ok = decode_glb(loader, mapping.data, mapping.size, out_mesh);
+    unmap_file(&mapping);
+    if (!ok) {
+        mesh_data_free(out_mesh);
+        return false;
+    }
 
     printf("[GLB] Loaded: %s (%u vertices, %u indices)\n",
            out_mesh->name[0] ? out_mesh->name : path,
@@ -535,7 +606,17 @@ bool glb_load(const char* path, MeshData* out_mesh) {
     return true;
 }
 
+bool glb_load(const char* path, MeshData* out_mesh) {
+    // Per-thread scratch, kept between loads
+    static thread_local GlbLoader loader;
+    return glb_load_with(&loader, path, out_mesh);
+}
+
 void mesh_data_free(MeshData* mesh) {
+    if (mesh->borrowed) {
+        mesh->vertices = NULL;
+        mesh->indices = NULL;
+    }
     if (mesh->vertices) {
         free(mesh->vertices);
         mesh->vertices = NULL;
@@ -546,6 +627,26 @@ void mesh_data_free(MeshData* mesh) {
     }
     mesh->vertex_count = 0;
     mesh->index_count = 0;
+    mesh->lod_count = 0;
+    mesh->borrowed = false;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+uint64_t mesh_data_hash(const MeshData* mesh) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = fnv1a(hash, &mesh->vertex_count, sizeof(mesh->vertex_count));
+    hash = fnv1a(hash, &mesh->index_count, sizeof(mesh->index_count));
+    if (mesh->vertices) hash = fnv1a(hash, mesh->vertices, mesh->vertex_count * sizeof(Vertex));
+    if (mesh->indices) hash = fnv1a(hash, mesh->indices, mesh->index_count * sizeof(uint32_t));
+    return hash;
 }
 
 void mesh_data_print_info(const MeshData* mesh) {
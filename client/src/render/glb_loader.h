@@ -11,10 +11,6 @@
 #include <stdint.h>
 #include <stddef.h>
 
-// Maximum vertices/indices we support
-#define MAX_VERTICES 100000
-#define MAX_INDICES  300000
-
 // Vertex with position, normal, and color
 typedef struct Vertex {
     float position[3];
@@ -22,29 +18,66 @@ typedef struct Vertex {
     float color[4];     // RGBA (0-1)
 } Vertex;
 
+// Level-of-detail index range (see mesh_lod.h)
+#define MESH_MAX_LODS 4
+
+typedef struct MeshLod {
+    uint32_t first_index;   // Into MeshData::indices
+    uint32_t index_count;
+    float cell_size;        // Simplification cell / largest bounds extent (0 = full detail)
+} MeshLod;
+
 // Loaded mesh data
 typedef struct MeshData {
     Vertex* vertices;
     uint32_t vertex_count;
 
     uint32_t* indices;
-    uint32_t index_count;
+    uint32_t index_count;   // All levels
+
+    // Index ranges sharing the vertex array, level 0 = full detail
+    // (0 levels for non-indexed meshes)
+    uint32_t lod_count;
+    MeshLod lods[MESH_MAX_LODS];
 
     // Bounding box
     float min_bounds[3];
     float max_bounds[3];
 
     char name[128];
+
+    bool borrowed;      // Arrays point into a mapped MeshCache (not freed)
 } MeshData;
 
+// Reusable loader scratch (one per loading thread)
+typedef struct GlbLoader {
+    char* json;             // NUL-terminated copy of the current JSON chunk
+    size_t json_capacity;
+} GlbLoader;
+
+void glb_loader_init(GlbLoader* loader);
+void glb_loader_free(GlbLoader* loader);
+
 // Load a GLB file and extract mesh data
 // Returns true on success, false on failure
 // Caller must call mesh_data_free() when done
+bool glb_load_with(GlbLoader* loader, const char* path, MeshData* out_mesh);
+
+// glb_load_with() using a per-thread loader
 bool glb_load(const char* path, MeshData* out_mesh);
 
-// Free mesh data
+// Full-detail triangle count
+static inline uint32_t mesh_data_triangle_count(const MeshData* mesh) {
+    return (mesh->lod_count > 0 ? mesh->lods[0].index_count : mesh->index_count) / 3;
+}
+
+// Free mesh data (borrowed arrays are only released by their cache)
 void mesh_data_free(MeshData* mesh);
 
+// 64-bit FNV-1a hash of a mesh's geometry (vertices and indices, not the name)
+// Used to merge identical meshes stored under different part names
+uint64_t mesh_data_hash(const MeshData* mesh);
+
 // Print mesh info for debugging
 void mesh_data_print_info(const MeshData* mesh);
 
@@ -0,0 +1,414 @@
+/*
+ * GPU Game-Piece Field Implementation
+ */
+
+#include "gpu_field.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+// Storage buffer bindings and grid helpers (prepended to every pass)
+static const char* field_glsl = "#version 430\n" R"(
+layout(std430, binding = 0) buffer PiecesIn { vec4 pieces_in[]; };     // x, z, vel_x, vel_z
+layout(std430, binding = 1) buffer PiecesOut { vec4 pieces_out[]; };
+layout(std430, binding = 2) buffer CellCounts { uint cell_count[]; };
+layout(std430, binding = 3) buffer CellStarts { uint cell_start[]; };
+layout(std430, binding = 4) buffer Sorted { uint sorted[]; };
+layout(std430, binding = 5) buffer Slots { uint slot[]; };
+struct Contact { vec4 piece; uvec4 index; };
+layout(std430, binding = 6) buffer Contacts { uint contact_count; Contact contacts[]; };
+
+uniform uint u_count;
+uniform ivec2 u_grid;
+uniform float u_cell_size;
+uniform vec2 u_half;
+uniform float u_radius;
+
+ivec2 cell_of(vec2 pos) {
+    return clamp(ivec2(floor((pos + u_half) / u_cell_size)), ivec2(0), u_grid - 1);
+}
+uint cell_index(ivec2 cell) {
+    return uint(cell.y * u_grid.x + cell.x);
+}
+)";
+
+// Count pieces per cell; each piece keeps its place in the cell
+static const char* bin_src = R"(
+layout(local_size_x = 128) in;
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_count) return;
+    slot[i] = atomicAdd(cell_count[cell_index(cell_of(pieces_in[i].xy))], 1u);
+}
+)";
+
+// Exclusive prefix sum of the cell counts in one work group: each invocation
+// sums a run of cells, the run sums are scanned in shared memory
+static const char* scan_src = R"(
+layout(local_size_x = 1024) in;
+shared uint partial[1024];
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    uint cells = uint(u_grid.x * u_grid.y);
+    uint per = (cells + 1023u) / 1024u;
+    uint begin = min(t * per, cells);
+    uint end = min(begin + per, cells);
+
+    uint sum = 0u;
+    for (uint c = begin; c < end; c++) sum += cell_count[c];
+    partial[t] = sum;
+    barrier();
+
+    for (uint offset = 1u; offset < 1024u; offset <<= 1) {
+        uint add = t >= offset ? partial[t - offset] : 0u;
+        barrier();
+        partial[t] += add;
+        barrier();
+    }
+
+    uint start = t > 0u ? partial[t - 1u] : 0u;
+    for (uint c = begin; c < end; c++) {
+        cell_start[c] = start;
+        start += cell_count[c];
+    }
+}
+)";
+
+// Piece indices sorted by cell
+static const char* scatter_src = R"(
+layout(local_size_x = 128) in;
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_count) return;
+    sorted[cell_start[cell_index(cell_of(pieces_in[i].xy))] + slot[i]] = i;
+}
+)";
+
+// Contacts with the pieces of the 3x3 neighbouring cells (equal masses, so
+// each piece takes half of every correction), then friction, integration and
+// walls; constants as in the CPU cylinder pass
+static const char* step_src = R"(
+layout(local_size_x = 128) in;
+uniform float u_dt;
+const float FRICTION = 0.85;    // Damping per step
+const float TOLERANCE = 0.1;    // Overlap left uncorrected
+const float STOP_SPEED = 0.1;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_count) return;
+    vec2 pos = pieces_in[i].xy;
+    vec2 vel = pieces_in[i].zw;
+    vec2 move = vec2(0.0);
+    vec2 push = vec2(0.0);
+    float min_dist = 2.0 * u_radius;
+
+    ivec2 cell = cell_of(pos);
+    ivec2 lo = max(cell - 1, ivec2(0));
+    ivec2 hi = min(cell + 1, u_grid - 1);
+    for (int cz = lo.y; cz <= hi.y; cz++) {
+        for (int cx = lo.x; cx <= hi.x; cx++) {
+            uint c = cell_index(ivec2(cx, cz));
+            uint end = cell_start[c] + cell_count[c];
+            for (uint k = cell_start[c]; k < end; k++) {
+                uint j = sorted[k];
+                if (j == i) continue;
+                vec4 other = pieces_in[j];
+                vec2 d = other.xy - pos;
+                float dist = length(d);
+                if (dist >= min_dist || dist <= 0.001) continue;
+
+                // Cancel approaching velocity (no bounce), correct past the tolerance
+                vec2 n = d / dist;
+                float rel_vel = dot(other.zw - vel, n);
+                if (rel_vel < 0.0) push += n * (rel_vel * 0.5);
+                float overlap = min_dist - dist;
+                if (overlap > TOLERANCE) move -= n * ((overlap - TOLERANCE) * 0.5);
+            }
+        }
+    }
+    pos += move;
+    vel += push;
+
+    vel *= FRICTION;
+    if (abs(vel.x) < STOP_SPEED) vel.x = 0.0;
+    if (abs(vel.y) < STOP_SPEED) vel.y = 0.0;
+    pos += vel * u_dt;
+
+    // Walls stop pieces dead
+    vec2 bound = u_half - vec2(u_radius);
+    if (pos.x < -bound.x || pos.x > bound.x) vel.x = 0.0;
+    if (pos.y < -bound.y || pos.y > bound.y) vel.y = 0.0;
+    pos = clamp(pos, -bound, bound);
+
+    pieces_out[i] = vec4(pos, vel);
+}
+)";
+
+// Append the pieces overlapping a robot footprint to the contact list
+static const char* select_src = R"(
+layout(local_size_x = 128) in;
+uniform int u_footprint_count;
+uniform vec4 u_footprints[16];   // min x, min z, max x, max z
+uniform uint u_max_contacts;
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_count) return;
+    vec4 piece = pieces_in[i];
+    for (int f = 0; f < u_footprint_count; f++) {
+        vec4 bounds = u_footprints[f];
+        if (piece.x + u_radius < bounds.x || piece.x - u_radius > bounds.z ||
+            piece.y + u_radius < bounds.y || piece.y - u_radius > bounds.w) continue;
+        uint n = atomicAdd(contact_count, 1u);
+        if (n < u_max_contacts) contacts[n] = Contact(piece, uvec4(i, 0u, 0u, 0u));
+        return;
+    }
+}
+)";
+
+// Store the pieces of the contact list back
+static const char* write_src = R"(
+layout(local_size_x = 128) in;
+uniform uint u_write_count;
+void main() {
+    uint k = gl_GlobalInvocationID.x;
+    if (k >= u_write_count) return;
+    pieces_in[contacts[k].index.x] = contacts[k].piece;
+}
+)";
+
+static GLuint piece_groups(uint32_t count) {
+    return (count + GPU_FIELD_GROUP_SIZE - 1) / GPU_FIELD_GROUP_SIZE;
+}
+
+static GLuint create_storage(GLsizeiptr size, const void* data) {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    return buffer;
+}
+
+// Grid constants of every pass (set once, they don't change)
+static void set_constants(const GpuField* field, const Shader* shader) {
+    GLuint program = shader->program;
+    glProgramUniform1ui(program, glGetUniformLocation(program, "u_count"), field->count);
+    glProgramUniform2i(program, glGetUniformLocation(program, "u_grid"), field->grid_width, field->grid_depth);
+    glProgramUniform1f(program, glGetUniformLocation(program, "u_cell_size"), field->cell_size);
+    glProgramUniform2f(program, glGetUniformLocation(program, "u_half"), field->half_width, field->half_depth);
+    glProgramUniform1f(program, glGetUniformLocation(program, "u_radius"), field->radius);
+}
+
+// Pieces in rows across the whole field, each nudged off its grid point so
+// overfull fields don't settle into a symmetric lattice
+static void layout_pieces(const GpuField* field, std::vector<GpuPiece>& pieces) {
+    float usable_w = 2.0f * (field->half_width - field->radius);
+    float usable_d = 2.0f * (field->half_depth - field->radius);
+    uint32_t columns = (uint32_t)ceilf(sqrtf(field->count * usable_w / usable_d));
+    if (columns == 0) columns = 1;
+    uint32_t rows = (field->count + columns - 1) / columns;
+    float spacing_x = usable_w / columns;
+    float spacing_z = usable_d / rows;
+
+    uint32_t seed = 12345u;
+    pieces.resize(field->count);
+    for (uint32_t i = 0; i < field->count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float jitter_x = ((seed >> 8) & 0xFFFF) / 65535.0f - 0.5f;
+        seed = seed * 1664525u + 1013904223u;
+        float jitter_z = ((seed >> 8) & 0xFFFF) / 65535.0f - 0.5f;
+
+        GpuPiece& piece = pieces[i];
+        piece.x = -usable_w * 0.5f + ((i % columns) + 0.5f + jitter_x * 0.2f) * spacing_x;
+        piece.z = -usable_d * 0.5f + ((i / columns) + 0.5f + jitter_z * 0.2f) * spacing_z;
+        piece.vel_x = 0.0f;
+        piece.vel_z = 0.0f;
+    }
+}
+
+bool gpu_field_supported(void) {
+    return GLEW_VERSION_4_3;
+}
+
+bool gpu_field_init(GpuField* field, uint32_t count, float radius, float height,
+                    float half_width, float half_depth) {
+    memset(field, 0, sizeof(GpuField));
+    if (!gpu_field_supported()) {
+        fprintf(stderr, "[GpuField] Compute shaders need OpenGL 4.3 (context is %s)\n", glGetString(GL_VERSION));
+        return false;
+    }
+    if (count == 0 || count > GPU_FIELD_MAX_PIECES || radius <= 0.0f ||
+        half_width <= radius || half_depth <= radius) {
+        fprintf(stderr, "[GpuField] Invalid field: %u pieces of radius %.2f (at most %d)\n", count, radius,
+                GPU_FIELD_MAX_PIECES);
+        return false;
+    }
+    field->count = count;
+    field->radius = radius;
+    field->height = height;
+    field->half_width = half_width;
+    field->half_depth = half_depth;
+
+    // Cells of one diameter, larger if the field would need too many
+    float cell = 2.0f * radius;
+    float min_cell = sqrtf(4.0f * half_width * half_depth / GPU_FIELD_MAX_CELLS);
+    if (cell < min_cell) cell = min_cell;
+    field->grid_width = (int)ceilf(2.0f * half_width / cell);
+    field->grid_depth = (int)ceilf(2.0f * half_depth / cell);
+    while (field->grid_width * field->grid_depth > GPU_FIELD_MAX_CELLS) {
+        cell *= 1.05f;
+        field->grid_width = (int)ceilf(2.0f * half_width / cell);
+        field->grid_depth = (int)ceilf(2.0f * half_depth / cell);
+    }
+    field->cell_size = cell;
+
+    Shader* shaders[] = { &field->bin, &field->scan, &field->scatter, &field->step, &field->select, &field->write };
+    const char* sources[] = { bin_src, scan_src, scatter_src, step_src, select_src, write_src };
+    for (int s = 0; s < 6; s++) {
+        std::string source = std::string(field_glsl) + sources[s];
+        if (!shader_create_compute(shaders[s], source.c_str())) {
+            fprintf(stderr, "[GpuField] Failed to create compute shader %d\n", s);
+            gpu_field_destroy(field);
+            return false;
+        }
+        set_constants(field, shaders[s]);
+    }
+    field->step_dt_loc = glGetUniformLocation(field->step.program, "u_dt");
+    field->select_count_loc = glGetUniformLocation(field->select.program, "u_footprint_count");
+    field->select_footprints_loc = glGetUniformLocation(field->select.program, "u_footprints");
+    field->write_count_loc = glGetUniformLocation(field->write.program, "u_write_count");
+    glProgramUniform1ui(field->select.program, glGetUniformLocation(field->select.program, "u_max_contacts"),
+                        GPU_FIELD_MAX_CONTACTS);
+
+    std::vector<GpuPiece> pieces;
+    layout_pieces(field, pieces);
+    GLsizeiptr piece_bytes = (GLsizeiptr)(count * sizeof(GpuPiece));
+    GLsizeiptr cell_bytes = (GLsizeiptr)(field->grid_width * field->grid_depth * sizeof(uint32_t));
+    field->pieces[0] = create_storage(piece_bytes, pieces.data());
+    field->pieces[1] = create_storage(piece_bytes, NULL);
+    field->cell_counts = create_storage(cell_bytes, NULL);
+    field->cell_starts = create_storage(cell_bytes, NULL);
+    field->sorted = create_storage((GLsizeiptr)(count * sizeof(uint32_t)), NULL);
+    field->slots = create_storage((GLsizeiptr)(count * sizeof(uint32_t)), NULL);
+    field->contact_buffer = create_storage((GLsizeiptr)(16 + GPU_FIELD_MAX_CONTACTS * sizeof(GpuFieldContact)), NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    field->current = 0;
+    field->valid = glGetError() == GL_NO_ERROR;
+    if (!field->valid) {
+        fprintf(stderr, "[GpuField] Failed to create the piece buffers\n");
+        gpu_field_destroy(field);
+        return false;
+    }
+    printf("[GpuField] %u pieces (radius %.2f in), %dx%d grid of %.2f in cells, %.1f MB\n", count, radius,
+           field->grid_width, field->grid_depth, cell,
+           (2.0 * piece_bytes + 2.0 * cell_bytes + 2.0 * count * sizeof(uint32_t)) / (1024.0 * 1024.0));
+    return true;
+}
+
+void gpu_field_destroy(GpuField* field) {
+    GLuint buffers[] = { field->pieces[0], field->pieces[1], field->cell_counts, field->cell_starts,
+                         field->sorted, field->slots, field->contact_buffer };
+    for (GLuint buffer : buffers) {
+        if (buffer) glDeleteBuffers(1, &buffer);
+    }
+    shader_destroy(&field->bin);
+    shader_destroy(&field->scan);
+    shader_destroy(&field->scatter);
+    shader_destroy(&field->step);
+    shader_destroy(&field->select);
+    shader_destroy(&field->write);
+    memset(field, 0, sizeof(GpuField));
+}
+
+// Bind the newest pieces as input (and the other buffer as output) plus the grid
+static void bind_buffers(const GpuField* field) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, field->pieces[field->current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, field->pieces[1 - field->current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, field->cell_counts);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, field->cell_starts);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, field->sorted);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, field->slots);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, field->contact_buffer);
+}
+
+void gpu_field_step(GpuField* field, float dt_sec) {
+    if (!field->valid) return;
+    bind_buffers(field);
+    GLuint groups = piece_groups(field->count);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, field->cell_counts);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glUseProgram(field->bin.program);
+    glDispatchCompute(groups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(field->scan.program);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(field->scatter.program);
+    glDispatchCompute(groups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUseProgram(field->step.program);
+    glUniform1f(field->step_dt_loc, dt_sec);
+    glDispatchCompute(groups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    glUseProgram(0);
+    field->current = 1 - field->current;
+    field->steps++;
+}
+
+uint32_t gpu_field_select(GpuField* field, const float (*footprints)[4], int footprint_count) {
+    field->contact_count = 0;
+    if (!field->valid || footprint_count <= 0) return 0;
+    if (footprint_count > GPU_FIELD_MAX_ROBOTS) footprint_count = GPU_FIELD_MAX_ROBOTS;
+    bind_buffers(field);
+
+    uint32_t zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, field->contact_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+
+    glUseProgram(field->select.program);
+    glUniform1i(field->select_count_loc, footprint_count);
+    glUniform4fv(field->select_footprints_loc, footprint_count, &footprints[0][0]);
+    glDispatchCompute(piece_groups(field->count), 1, 1);
+    glUseProgram(0);
+
+    // The only readback: the count, then just the selected pieces
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    uint32_t count = 0;
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(count), &count);
+    if (count > GPU_FIELD_MAX_CONTACTS) count = GPU_FIELD_MAX_CONTACTS;
+    if (count > 0) glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 16, count * sizeof(GpuFieldContact), field->contacts);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    field->contact_count = count;
+    return count;
+}
+
+void gpu_field_write(GpuField* field, const GpuFieldContact* contacts, uint32_t count) {
+    if (!field->valid || count == 0) return;
+    if (count > GPU_FIELD_MAX_CONTACTS) count = GPU_FIELD_MAX_CONTACTS;
+    bind_buffers(field);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, field->contact_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 16, count * sizeof(GpuFieldContact), contacts);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glUseProgram(field->write.program);
+    glUniform1ui(field->write_count_loc, count);
+    glDispatchCompute(piece_groups(count), 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    glUseProgram(0);
+}
+
+GLuint gpu_field_buffer(const GpuField* field) {
+    return field->valid ? field->pieces[field->current] : 0;
+}
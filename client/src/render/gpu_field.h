@@ -0,0 +1,117 @@
+/*
+ * GPU Game-Piece Field
+ * Compute-shader (GL 4.3) simulation of large game-piece fields for stress
+ * tests, where the CPU cylinder pass (pair by pair from one broad phase)
+ * doesn't scale.
+ *
+ * Piece positions and velocities live in shader storage buffers and never
+ * come back to the CPU as a whole. Each step:
+ *   1. bin:     count the pieces per grid cell (cells are at least one piece
+ *               diameter, so contacts are within the 3x3 neighbouring cells)
+ *   2. scan:    prefix sum of the counts into cell start offsets
+ *   3. scatter: piece indices sorted by cell
+ *   4. step:    piece-piece contacts against the neighbouring cells, then
+ *               friction, integration and wall clamping, into the other
+ *               piece buffer (the constants of the CPU cylinder pass)
+ * Contacts are solved Jacobi style (every piece from the previous positions)
+ * where the CPU pass goes pair by pair, and pieces all share one radius and
+ * mass. Pieces don't sleep and don't touch the scene's cylinders.
+ *
+ * Robots push pieces on the CPU: gpu_field_select() reads back only the
+ * pieces overlapping the given robot footprints, the caller resolves them
+ * against the robot parts (sim_world_push_cylinder) and gpu_field_write()
+ * stores the pushed ones. The current piece buffer is also the per-instance
+ * attribute of the cylinder draw (objects_set_field), so drawing needs no
+ * copy either.
+ *
+ * Usage:
+ *   if (gpu_field_supported() && gpu_field_init(&field, 4096, 1.5f, 3.0f, half_w, half_d)) {
+ *       gpu_field_step(&field, dt);                     // every physics step
+ *       uint32_t near = gpu_field_select(&field, footprints, robot_count);
+ *       ... push field.contacts[0..near), keep the moved ones ...
+ *       gpu_field_write(&field, field.contacts, moved);
+ *       objects_set_field(&objects, gpu_field_buffer(&field), field.count, ...);
+ *   }
+ */
+
+#ifndef GPU_FIELD_H
+#define GPU_FIELD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <GL/glew.h>
+#include "shader.h"
+
+#define GPU_FIELD_MAX_PIECES 262144
+#define GPU_FIELD_MAX_CELLS 16384     // Grid cells (cells grow past one diameter to stay below)
+#define GPU_FIELD_MAX_CONTACTS 256    // Pieces read back per gpu_field_select
+#define GPU_FIELD_MAX_ROBOTS 16       // Footprints per gpu_field_select
+#define GPU_FIELD_GROUP_SIZE 128      // Invocations per work group (per-piece passes)
+
+// One piece (std430 vec4)
+typedef struct GpuPiece {
+    float x, z;           // Position in inches
+    float vel_x, vel_z;   // Velocity in inches/second
+} GpuPiece;
+
+// Piece read back by gpu_field_select (std430 { vec4; uvec4; })
+typedef struct GpuFieldContact {
+    GpuPiece piece;
+    uint32_t index;       // Piece index
+    uint32_t pad[3];
+} GpuFieldContact;
+
+typedef struct GpuField {
+    bool valid;
+    uint32_t count;
+    float radius, height;
+    float half_width, half_depth;
+
+    // Uniform grid over the field
+    int grid_width, grid_depth;
+    float cell_size;
+
+    // Storage buffers
+    GLuint pieces[2];     // Ping-ponged by gpu_field_step
+    int current;          // Index of the newest piece buffer
+    GLuint cell_counts;   // uint per cell
+    GLuint cell_starts;   // uint per cell
+    GLuint sorted;        // Piece indices by cell
+    GLuint slots;         // Per piece: its place within its cell
+    GLuint contact_buffer;  // uint count (padded to 16 bytes), GpuFieldContact[GPU_FIELD_MAX_CONTACTS]
+
+    Shader bin, scan, scatter, step, select, write;
+    GLint step_dt_loc;
+    GLint select_count_loc, select_footprints_loc;
+    GLint write_count_loc;
+
+    uint64_t steps;
+    uint32_t contact_count;                             // Pieces read back by the last select
+    GpuFieldContact contacts[GPU_FIELD_MAX_CONTACTS];
+} GpuField;
+
+// True if the current context runs compute shaders (OpenGL 4.3)
+bool gpu_field_supported(void);
+
+// Create count pieces of radius and height (inches), at rest on a jittered
+// grid covering the field (half extents in inches). Needs gpu_field_supported().
+bool gpu_field_init(GpuField* field, uint32_t count, float radius, float height,
+                    float half_width, float half_depth);
+
+void gpu_field_destroy(GpuField* field);
+
+// Advance all pieces by dt_sec (one physics step)
+void gpu_field_step(GpuField* field, float dt_sec);
+
+// Read back the pieces overlapping any footprint (min x, min z, max x, max z;
+// at most GPU_FIELD_MAX_ROBOTS) into field->contacts. Returns how many, at
+// most GPU_FIELD_MAX_CONTACTS (pieces past that aren't read back this time).
+uint32_t gpu_field_select(GpuField* field, const float (*footprints)[4], int footprint_count);
+
+// Overwrite pieces: contacts[i].piece goes to piece contacts[i].index
+void gpu_field_write(GpuField* field, const GpuFieldContact* contacts, uint32_t count);
+
+// Newest piece buffer (vec4 per piece: x, z, vel_x, vel_z)
+GLuint gpu_field_buffer(const GpuField* field);
+
+#endif // GPU_FIELD_H
@@ -0,0 +1,40 @@
+/*
+ * Load Jobs Implementation
+ */
+
+#include "load_jobs.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int load_jobs_thread_count(void) {
+    int n = (int)std::thread::hardware_concurrency();
+    if (n < 1) n = 1;
+    if (n > LOAD_JOBS_MAX_THREADS) n = LOAD_JOBS_MAX_THREADS;
+    return n;
+}
+
+void load_jobs_run(int count, LoadJobFn job, void* user_data, int thread_count) {
+    if (count <= 0) return;
+    if (thread_count > count) thread_count = count;
+    if (thread_count > LOAD_JOBS_MAX_THREADS) thread_count = LOAD_JOBS_MAX_THREADS;
+
+    if (thread_count <= 1) {
+        for (int i = 0; i < count; i++) job(user_data, i);
+        return;
+    }
+
+    // Jobs are claimed in index order from a shared counter
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            job(user_data, i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (int t = 1; t < thread_count; t++) threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads) t.join();
+}
@@ -0,0 +1,28 @@
+/*
+ * Load Jobs
+ * Minimal worker pool for asset loading (MPD parsing, GLB decoding).
+ *
+ * load_jobs_run() calls job(user_data, i) for every i in [0, count) on up to
+ * thread_count threads, the calling thread included, and returns once all
+ * jobs have finished. Jobs write into per-index result slots, so results do
+ * not depend on scheduling. Jobs must not touch GL - finished buffers are
+ * handed back to the GL thread by the caller.
+ *
+ * Usage:
+ *   load_jobs_run((int)names.size(), decode_job, &ctx, load_jobs_thread_count());
+ */
+
+#ifndef LOAD_JOBS_H
+#define LOAD_JOBS_H
+
+#define LOAD_JOBS_MAX_THREADS 16
+
+typedef void (*LoadJobFn)(void* user_data, int index);
+
+// Worker count for loading (hardware threads, clamped to LOAD_JOBS_MAX_THREADS)
+int load_jobs_thread_count(void);
+
+// Run count jobs and wait for all of them (thread_count <= 1 runs inline)
+void load_jobs_run(int count, LoadJobFn job, void* user_data, int thread_count);
+
+#endif // LOAD_JOBS_H
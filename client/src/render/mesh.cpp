@@ -4,48 +4,142 @@
 
 #include "mesh.h"
 #include "shader.h"
+#include "render_queue.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <math.h>
 
 // Shared shader for all meshes (pointer to external shader)
 static Shader* s_mesh_shader = NULL;
 
-// Vertex shader for mesh rendering
-static const char* mesh_vertex_shader = R"(
-#version 330 core
+// Upload new meshes in the compact layout (see mesh_set_compact)
+static bool s_mesh_compact = false;
+
+// Draws since mesh_draw_stats_reset()
+static MeshDrawStats s_draw_stats = {};
+
+// Compact vertex layouts (position w is padding for 4-byte alignment)
+typedef struct CompactVertex {
+    uint16_t position[4];   // unorm16 within the mesh bounds
+    int16_t normal[2];      // snorm16 octahedral
+} CompactVertex;
+
+typedef struct CompactColorVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    uint8_t color[4];       // RGBA8 unorm
+} CompactColorVertex;
+
+// Uniform locations, looked up once per shader program
+// (camera and light come from the FrameData block, see render_queue.h)
+typedef struct MeshUniforms {
+    GLuint program;       // Program the locations belong to (0 = not cached)
+    GLint model;
+    GLint normal_matrix;
+    GLint color_override;
+    GLint use_override;
+    GLint pos_offset;
+    GLint pos_scale;
+    GLint oct_normals;
+} MeshUniforms;
+
+static MeshUniforms s_mesh_uniforms = {};
+
+// Instanced rendering state (see mesh_instancing_init)
+static struct {
+    Shader shader;
+    MeshUniforms uniforms;
+    GLuint instance_vbo;
+    uint32_t capacity;    // Instances the VBO can hold
+    bool valid;
+} s_instanced = {};
+
+// First vertex attribute used for per-instance data
+// Locations 3-6: model matrix columns, 7: color override (rgb, w = use flag)
+#define MESH_INSTANCE_ATTRIB 3
 
+// Vertex shader for mesh rendering
+static const char* mesh_vertex_shader = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec4 a_color;
 
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
 uniform mat3 u_normal_matrix;
 
+uniform vec3 u_pos_offset;       // Dequantization (0 and 1 for float positions)
+uniform vec3 u_pos_scale;
+uniform float u_oct_normals;     // 1.0 = a_normal.xy is octahedral-encoded
+
+vec3 oct_decode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
 out vec3 v_position;
 out vec3 v_normal;
 out vec4 v_color;
 
 void main() {
-    vec4 world_pos = u_model * vec4(a_position, 1.0);
+    vec3 position = u_pos_offset + a_position * u_pos_scale;
+    vec3 normal = u_oct_normals > 0.5 ? oct_decode(a_normal.xy) : a_normal;
+    vec4 world_pos = u_model * vec4(position, 1.0);
     v_position = world_pos.xyz;
-    v_normal = normalize(u_normal_matrix * a_normal);
+    v_normal = normalize(u_normal_matrix * normal);
     v_color = a_color;
     gl_Position = u_projection * u_view * world_pos;
 }
 )";
 
-// Fragment shader with basic lighting and color override
-static const char* mesh_fragment_shader = R"(
-#version 330 core
+// Instanced vertex shader: model matrix and color override come from the instance buffer
+static const char* mesh_instanced_vertex_shader = "#version 330 core\n" RENDER_FRAME_GLSL R"(
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_normal;
+layout(location = 2) in vec4 a_color;
+layout(location = 3) in mat4 a_model;      // Uses locations 3-6
+layout(location = 7) in vec4 a_override;   // rgb = color, w = 1.0 to apply
+
+uniform vec3 u_pos_offset;       // Dequantization (0 and 1 for float positions)
+uniform vec3 u_pos_scale;
+uniform float u_oct_normals;     // 1.0 = a_normal.xy is octahedral-encoded
+
+vec3 oct_decode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+out vec3 v_position;
+out vec3 v_normal;
+out vec4 v_color;
+out vec4 v_override;
 
+void main() {
+    vec3 position = u_pos_offset + a_position * u_pos_scale;
+    vec3 normal = u_oct_normals > 0.5 ? oct_decode(a_normal.xy) : a_normal;
+    vec4 world_pos = a_model * vec4(position, 1.0);
+    v_position = world_pos.xyz;
+    // Same approximation as the non-instanced path (no non-uniform scale)
+    v_normal = normalize(mat3(a_model) * normal);
+    v_color = a_color;
+    v_override = a_override;
+    gl_Position = u_projection * u_view * world_pos;
+}
+)";
+
+// Fragment shader with basic lighting and color override
+static const char* mesh_fragment_shader = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 in vec3 v_position;
 in vec3 v_normal;
 in vec4 v_color;
 
-uniform vec3 u_light_dir;
-uniform vec3 u_camera_pos;
 uniform vec3 u_color_override;   // RGB override color
 uniform float u_use_override;    // 1.0 = apply override to white vertices, 0.0 = no override
 
@@ -54,8 +148,8 @@ out vec4 frag_color;
 void main() {
     // Normalize inputs
     vec3 N = normalize(v_normal);
-    vec3 L = normalize(u_light_dir);
-    vec3 V = normalize(u_camera_pos - v_position);
+    vec3 L = u_light_dir.xyz;
+    vec3 V = normalize(u_camera_pos.xyz - v_position);
     vec3 H = normalize(L + V);
 
     // Lighting
@@ -80,11 +174,80 @@ void main() {
 }
 )";
 
+// Instanced fragment shader: same lighting, override color per instance
+static const char* mesh_instanced_fragment_shader = "#version 330 core\n" RENDER_FRAME_GLSL R"(
+in vec3 v_position;
+in vec3 v_normal;
+in vec4 v_color;
+in vec4 v_override;              // rgb = override color, w = 1.0 to apply
+
+out vec4 frag_color;
+
+void main() {
+    // Normalize inputs
+    vec3 N = normalize(v_normal);
+    vec3 L = u_light_dir.xyz;
+    vec3 V = normalize(u_camera_pos.xyz - v_position);
+    vec3 H = normalize(L + V);
+
+    // Lighting
+    float ambient = 0.3;
+    float diffuse = max(dot(N, L), 0.0) * 0.6;
+    float specular = pow(max(dot(N, H), 0.0), 32.0) * 0.2;
+
+    // Check if vertex is white (colorable) - threshold 0.95
+    float is_white = step(0.95, v_color.r) * step(0.95, v_color.g) * step(0.95, v_color.b);
+
+    // Apply color override to white vertices when override is enabled
+    vec3 base_color = mix(v_color.rgb, v_override.rgb, is_white * v_override.w);
+
+    // Combine with lighting
+    vec3 color = base_color * (ambient + diffuse) + vec3(specular);
+
+    // Slight fresnel for plastic look
+    float fresnel = pow(1.0 - max(dot(N, V), 0.0), 3.0) * 0.15;
+    color += vec3(fresnel);
+
+    frag_color = vec4(color, v_color.a);
+}
+)";
+
+// Look up and cache uniform locations for a mesh shader program
+static void mesh_cache_uniforms(MeshUniforms* u, GLuint program) {
+    u->program = program;
+    u->model = glGetUniformLocation(program, "u_model");
+    u->normal_matrix = glGetUniformLocation(program, "u_normal_matrix");
+    u->color_override = glGetUniformLocation(program, "u_color_override");
+    u->use_override = glGetUniformLocation(program, "u_use_override");
+    u->pos_offset = glGetUniformLocation(program, "u_pos_offset");
+    u->pos_scale = glGetUniformLocation(program, "u_pos_scale");
+    u->oct_normals = glGetUniformLocation(program, "u_oct_normals");
+}
+
+// Per-mesh vertex layout state: dequantization uniforms and the constant color
+static void mesh_bind_layout(const Mesh* mesh, const MeshUniforms* u) {
+    glUniform3fv(u->pos_offset, 1, mesh->pos_offset);
+    glUniform3fv(u->pos_scale, 1, mesh->pos_scale);
+    glUniform1f(u->oct_normals, mesh->compact ? 1.0f : 0.0f);
+    if (mesh->uniform_color) {
+        // Attribute 2 is disabled in the VAO, so the generic value applies
+        glVertexAttrib4fv(2, mesh->color);
+    }
+}
+
+// Get camera position from inverse view matrix (position is -transpose(R) * t)
+static void mesh_camera_position(const Mat4* view, float* x, float* y, float* z) {
+    *x = -(view->m[0] * view->m[12] + view->m[1] * view->m[13] + view->m[2] * view->m[14]);
+    *y = -(view->m[4] * view->m[12] + view->m[5] * view->m[13] + view->m[6] * view->m[14]);
+    *z = -(view->m[8] * view->m[12] + view->m[9] * view->m[13] + view->m[10] * view->m[14]);
+}
+
 bool mesh_shader_create(Shader* shader) {
     if (!shader_create(shader, mesh_vertex_shader, mesh_fragment_shader)) {
         fprintf(stderr, "[Mesh] Failed to create shader\n");
         return false;
     }
+    render_frame_bind_program(shader->program);
     return true;
 }
 
@@ -92,6 +255,99 @@ void mesh_set_shader(Shader* shader) {
     s_mesh_shader = shader;
 }
 
+void mesh_set_compact(bool enabled) {
+    s_mesh_compact = enabled;
+}
+
+// =============================================================================
+// Compact layout encoding
+// =============================================================================
+
+static int16_t snorm16(float v) {
+    if (v > 1.0f) v = 1.0f;
+    if (v < -1.0f) v = -1.0f;
+    return (int16_t)lroundf(v * 32767.0f);
+}
+
+// Octahedral normal encoding (decoded by oct_decode in the shaders)
+static void oct_encode(const float n[3], int16_t out[2]) {
+    float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    if (l1 <= 0.0f) {
+        out[0] = out[1] = 0;   // Decodes to +Z
+        return;
+    }
+    float x = n[0] / l1;
+    float y = n[1] / l1;
+    if (n[2] < 0.0f) {
+        float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    out[0] = snorm16(x);
+    out[1] = snorm16(y);
+}
+
+static uint16_t quantize_unorm16(float v, float min, float size) {
+    if (size <= 0.0f) return 0;
+    float t = (v - min) / size;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    return (uint16_t)lroundf(t * 65535.0f);
+}
+
+static uint8_t unorm8(float v) {
+    if (v < 0.0f) v = 0.0f;
+    if (v > 1.0f) v = 1.0f;
+    return (uint8_t)lroundf(v * 255.0f);
+}
+
+static bool mesh_has_uniform_color(const MeshData* data) {
+    const float* c0 = data->vertices[0].color;
+    for (uint32_t i = 1; i < data->vertex_count; i++) {
+        if (memcmp(data->vertices[i].color, c0, sizeof(data->vertices[i].color)) != 0) return false;
+    }
+    return true;
+}
+
+// Fill the bound VBO with the compact layout and set up attributes 0-2
+static void mesh_upload_compact(Mesh* mesh, const MeshData* data) {
+    mesh->uniform_color = mesh_has_uniform_color(data);
+    memcpy(mesh->color, data->vertices[0].color, sizeof(mesh->color));
+
+    size_t stride = mesh->uniform_color ? sizeof(CompactVertex) : sizeof(CompactColorVertex);
+    uint8_t* packed = (uint8_t*)malloc(data->vertex_count * stride);
+    for (uint32_t i = 0; i < data->vertex_count; i++) {
+        const Vertex* v = &data->vertices[i];
+        CompactColorVertex* out = (CompactColorVertex*)(packed + i * stride);
+        for (int k = 0; k < 3; k++) {
+            out->position[k] = quantize_unorm16(v->position[k], mesh->pos_offset[k], mesh->pos_scale[k]);
+        }
+        out->position[3] = 0;
+        oct_encode(v->normal, out->normal);
+        if (!mesh->uniform_color) {
+            for (int k = 0; k < 4; k++) out->color[k] = unorm8(v->color[k]);
+        }
+    }
+    glBufferData(GL_ARRAY_BUFFER, data->vertex_count * stride, packed, GL_STATIC_DRAW);
+    free(packed);
+    mesh->gpu_bytes += data->vertex_count * stride;
+
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, (GLsizei)stride,
+                          (void*)offsetof(CompactColorVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, (GLsizei)stride,
+                          (void*)offsetof(CompactColorVertex, normal));
+    glEnableVertexAttribArray(1);
+    if (!mesh->uniform_color) {
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, (GLsizei)stride,
+                              (void*)offsetof(CompactColorVertex, color));
+        glEnableVertexAttribArray(2);
+    } else {
+        glDisableVertexAttribArray(2);
+    }
+}
+
 bool mesh_create(Mesh* mesh, const MeshData* data) {
     memset(mesh, 0, sizeof(Mesh));
 
@@ -113,6 +369,15 @@ bool mesh_create(Mesh* mesh, const MeshData* data) {
     mesh->vertex_count = data->vertex_count;
     mesh->index_count = data->index_count;
 
+    // LOD ranges (an indexed mesh without any is one full-detail level)
+    mesh->lod_count = data->lod_count;
+    memcpy(mesh->lods, data->lods, sizeof(mesh->lods));
+    if (mesh->lod_count == 0 && data->indices && data->index_count > 0) {
+        mesh->lod_count = 1;
+        mesh->lods[0].index_count = data->index_count;
+    }
+    mesh->lod_extent = fmaxf(mesh->size[0], fmaxf(mesh->size[1], mesh->size[2]));
+
     // Create VAO
     glGenVertexArrays(1, &mesh->vao);
     glBindVertexArray(mesh->vao);
@@ -120,25 +385,46 @@ bool mesh_create(Mesh* mesh, const MeshData* data) {
     // Create VBO
     glGenBuffers(1, &mesh->vbo);
     glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
-    glBufferData(GL_ARRAY_BUFFER, data->vertex_count * sizeof(Vertex), data->vertices, GL_STATIC_DRAW);
 
-    // Position attribute (location 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
+    mesh->compact = s_mesh_compact;
+    if (mesh->compact) {
+        memcpy(mesh->pos_offset, mesh->min_bounds, sizeof(mesh->pos_offset));
+        memcpy(mesh->pos_scale, mesh->size, sizeof(mesh->pos_scale));
+        mesh_upload_compact(mesh, data);
+    } else {
+        mesh->pos_scale[0] = mesh->pos_scale[1] = mesh->pos_scale[2] = 1.0f;
+        glBufferData(GL_ARRAY_BUFFER, data->vertex_count * sizeof(Vertex), data->vertices, GL_STATIC_DRAW);
+        mesh->gpu_bytes += data->vertex_count * sizeof(Vertex);
 
-    // Normal attribute (location 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(1);
+        // Position attribute (location 0)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+        glEnableVertexAttribArray(0);
+
+        // Normal attribute (location 1)
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+        glEnableVertexAttribArray(1);
 
-    // Color attribute (location 2)
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-    glEnableVertexAttribArray(2);
+        // Color attribute (location 2)
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+        glEnableVertexAttribArray(2);
+    }
 
-    // Create EBO if we have indices
+    // Create EBO if we have indices (16-bit when every index fits)
+    mesh->index_type = GL_UNSIGNED_INT;
     if (data->indices && data->index_count > 0) {
         glGenBuffers(1, &mesh->ebo);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, data->index_count * sizeof(uint32_t), data->indices, GL_STATIC_DRAW);
+        if (data->vertex_count <= 65536) {
+            uint16_t* indices16 = (uint16_t*)malloc(data->index_count * sizeof(uint16_t));
+            for (uint32_t i = 0; i < data->index_count; i++) indices16[i] = (uint16_t)data->indices[i];
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, data->index_count * sizeof(uint16_t), indices16, GL_STATIC_DRAW);
+            free(indices16);
+            mesh->index_type = GL_UNSIGNED_SHORT;
+            mesh->gpu_bytes += data->index_count * sizeof(uint16_t);
+        } else {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, data->index_count * sizeof(uint32_t), data->indices, GL_STATIC_DRAW);
+            mesh->gpu_bytes += data->index_count * sizeof(uint32_t);
+        }
     }
 
     glBindVertexArray(0);
@@ -146,61 +432,118 @@ bool mesh_create(Mesh* mesh, const MeshData* data) {
     // Use shared shader
     mesh->shader_program = s_mesh_shader ? s_mesh_shader->program : 0;
 
-    printf("[Mesh] Created: %u vertices, %u indices, size=(%.2f, %.2f, %.2f)\n",
-           mesh->vertex_count, mesh->index_count,
-           mesh->size[0], mesh->size[1], mesh->size[2]);
+    printf("[Mesh] Created: %u vertices, %u indices, %u LODs, size=(%.2f, %.2f, %.2f), %zu bytes\n",
+           mesh->vertex_count, mesh->index_count, mesh->lod_count,
+           mesh->size[0], mesh->size[1], mesh->size[2], mesh->gpu_bytes);
 
     return true;
 }
 
-void mesh_render(Mesh* mesh, const Mat4* model, const Mat4* view, const Mat4* projection, Vec3 light_dir, const float* color_override) {
-    if (!mesh->vao || !mesh->shader_program) return;
+// Draw one LOD level (or all vertices for non-indexed meshes) with the bound VAO
+static void mesh_draw_lod(const Mesh* mesh, int lod, uint32_t instance_count) {
+    uint32_t copies = instance_count > 0 ? instance_count : 1;
+    s_draw_stats.draw_calls++;
+    if (mesh->lod_count == 0 || mesh->index_count == 0) {
+        s_draw_stats.triangles += (uint64_t)(mesh->vertex_count / 3) * copies;
+        if (instance_count > 0) {
+            glDrawArraysInstanced(GL_TRIANGLES, 0, mesh->vertex_count, instance_count);
+        } else {
+            glDrawArrays(GL_TRIANGLES, 0, mesh->vertex_count);
+        }
+        return;
+    }
+
+    if (lod < 0) lod = 0;
+    if (lod >= (int)mesh->lod_count) lod = (int)mesh->lod_count - 1;
+    const MeshLod* range = &mesh->lods[lod];
+    s_draw_stats.triangles += (uint64_t)(range->index_count / 3) * copies;
+    size_t index_size = mesh->index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    const void* offset = (const void*)((size_t)range->first_index * index_size);
+    if (instance_count > 0) {
+        glDrawElementsInstanced(GL_TRIANGLES, range->index_count, mesh->index_type, offset, instance_count);
+    } else {
+        glDrawElements(GL_TRIANGLES, range->index_count, mesh->index_type, offset);
+    }
+}
 
-    glUseProgram(mesh->shader_program);
+float mesh_lod_pixel_scale(const Mat4* projection, float viewport_height) {
+    // m[5] = 1 / tan(fov / 2): NDC height 2 spans viewport_height pixels
+    return projection->m[5] * viewport_height * 0.5f;
+}
+
+int mesh_select_lod(const Mesh* mesh, const float* model, const Mat4* view, float pixel_scale) {
+    if (mesh->lod_count <= 1) return 0;
+
+    // World-space center and uniform scale of the instance
+    float cx = model[0] * mesh->center[0] + model[4] * mesh->center[1] + model[8] * mesh->center[2] + model[12];
+    float cy = model[1] * mesh->center[0] + model[5] * mesh->center[1] + model[9] * mesh->center[2] + model[13];
+    float cz = model[2] * mesh->center[0] + model[6] * mesh->center[1] + model[10] * mesh->center[2] + model[14];
+    float scale = sqrtf(model[0] * model[0] + model[1] * model[1] + model[2] * model[2]);
+
+    float cam_x, cam_y, cam_z;
+    mesh_camera_position(view, &cam_x, &cam_y, &cam_z);
+    float dx = cx - cam_x, dy = cy - cam_y, dz = cz - cam_z;
+    float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+    if (distance <= 0.0f) return 0;
+
+    // Projected size of the largest extent, then of each level's cell
+    float extent_px = mesh->lod_extent * scale * pixel_scale / distance;
+    int lod = 0;
+    for (int l = 1; l < (int)mesh->lod_count; l++) {
+        if (extent_px * mesh->lods[l].cell_size > MESH_LOD_PIXEL_ERROR) break;
+        lod = l;
+    }
+    return lod;
+}
 
-    // Set uniforms
-    glUniformMatrix4fv(glGetUniformLocation(mesh->shader_program, "u_model"), 1, GL_FALSE, model->m);
-    glUniformMatrix4fv(glGetUniformLocation(mesh->shader_program, "u_view"), 1, GL_FALSE, view->m);
-    glUniformMatrix4fv(glGetUniformLocation(mesh->shader_program, "u_projection"), 1, GL_FALSE, projection->m);
+// Queued draw of one mesh instance (mesh_queue)
+static void mesh_draw_item(const RenderItem* item, bool rebound) {
+    const Mesh* mesh = (const Mesh*)item->object;
+    const MeshUniforms* u = &s_mesh_uniforms;
+    if (rebound) mesh_bind_layout(mesh, u);
+
+    const float* model = item->model;
+    glUniformMatrix4fv(u->model, 1, GL_FALSE, model);
 
     // Calculate normal matrix (transpose of inverse of upper-left 3x3 of model)
     // For simple transforms (no non-uniform scale), we can just use upper 3x3
     float normal_matrix[9] = {
-        model->m[0], model->m[1], model->m[2],
-        model->m[4], model->m[5], model->m[6],
-        model->m[8], model->m[9], model->m[10]
+        model[0], model[1], model[2],
+        model[4], model[5], model[6],
+        model[8], model[9], model[10]
     };
-    glUniformMatrix3fv(glGetUniformLocation(mesh->shader_program, "u_normal_matrix"), 1, GL_FALSE, normal_matrix);
-
-    glUniform3f(glGetUniformLocation(mesh->shader_program, "u_light_dir"), light_dir.x, light_dir.y, light_dir.z);
-
-    // Get camera position from inverse view matrix (position is -transpose(R) * t)
-    // For simplicity, approximate with view matrix column 3 negated
-    float cam_x = -(view->m[0] * view->m[12] + view->m[1] * view->m[13] + view->m[2] * view->m[14]);
-    float cam_y = -(view->m[4] * view->m[12] + view->m[5] * view->m[13] + view->m[6] * view->m[14]);
-    float cam_z = -(view->m[8] * view->m[12] + view->m[9] * view->m[13] + view->m[10] * view->m[14]);
-    glUniform3f(glGetUniformLocation(mesh->shader_program, "u_camera_pos"), cam_x, cam_y, cam_z);
+    glUniformMatrix3fv(u->normal_matrix, 1, GL_FALSE, normal_matrix);
 
     // Set color override
-    if (color_override) {
-        glUniform3f(glGetUniformLocation(mesh->shader_program, "u_color_override"),
-                    color_override[0], color_override[1], color_override[2]);
-        glUniform1f(glGetUniformLocation(mesh->shader_program, "u_use_override"), 1.0f);
+    if (item->color) {
+        glUniform3f(u->color_override, item->color[0], item->color[1], item->color[2]);
+        glUniform1f(u->use_override, 1.0f);
     } else {
-        glUniform3f(glGetUniformLocation(mesh->shader_program, "u_color_override"), 1.0f, 1.0f, 1.0f);
-        glUniform1f(glGetUniformLocation(mesh->shader_program, "u_use_override"), 0.0f);
+        glUniform3f(u->color_override, 1.0f, 1.0f, 1.0f);
+        glUniform1f(u->use_override, 0.0f);
     }
 
-    // Draw
-    glBindVertexArray(mesh->vao);
+    mesh_draw_lod(mesh, item->lod, 0);
+}
 
-    if (mesh->index_count > 0) {
-        glDrawElements(GL_TRIANGLES, mesh->index_count, GL_UNSIGNED_INT, 0);
-    } else {
-        glDrawArrays(GL_TRIANGLES, 0, mesh->vertex_count);
+void mesh_queue(RenderQueue* queue, const Mesh* mesh, const float* model, const float* color_override, int lod) {
+    if (!mesh->vao || !mesh->shader_program) return;
+
+    MeshUniforms* u = &s_mesh_uniforms;
+    if (u->program != mesh->shader_program) {
+        mesh_cache_uniforms(u, mesh->shader_program);
     }
 
-    glBindVertexArray(0);
+    RenderItem item = {};
+    item.key = render_queue_key(RENDER_PASS_OPAQUE, mesh->shader_program, mesh->vao, color_override ? 1 : 0);
+    item.program = mesh->shader_program;
+    item.vao = mesh->vao;
+    item.draw = mesh_draw_item;
+    item.object = mesh;
+    item.model = model;
+    item.color = color_override;
+    item.lod = lod;
+    render_queue_push(queue, &item);
 }
 
 void mesh_destroy(Mesh* mesh) {
@@ -219,3 +562,98 @@ void mesh_destroy(Mesh* mesh) {
     // Don't delete shader - it's shared
     mesh->shader_program = 0;
 }
+
+// ============================================================================
+// Instanced rendering
+// ============================================================================
+
+bool mesh_instancing_init(uint32_t initial_capacity) {
+    if (s_instanced.valid) return true;
+
+    if (!shader_create(&s_instanced.shader, mesh_instanced_vertex_shader, mesh_instanced_fragment_shader)) {
+        fprintf(stderr, "[Mesh] Failed to create instanced shader\n");
+        return false;
+    }
+    mesh_cache_uniforms(&s_instanced.uniforms, s_instanced.shader.program);
+    render_frame_bind_program(s_instanced.shader.program);
+
+    s_instanced.capacity = initial_capacity > 0 ? initial_capacity : 1024;
+    glGenBuffers(1, &s_instanced.instance_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, s_instanced.instance_vbo);
+    glBufferData(GL_ARRAY_BUFFER, s_instanced.capacity * sizeof(MeshInstance), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    s_instanced.valid = true;
+    return true;
+}
+
+bool mesh_instancing_ready(void) {
+    return s_instanced.valid;
+}
+
+void mesh_instancing_destroy(void) {
+    if (!s_instanced.valid) return;
+    glDeleteBuffers(1, &s_instanced.instance_vbo);
+    shader_destroy(&s_instanced.shader);
+    memset(&s_instanced, 0, sizeof(s_instanced));
+}
+
+void mesh_instances_upload(const MeshInstance* instances, uint32_t count) {
+    if (!s_instanced.valid || count == 0) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, s_instanced.instance_vbo);
+    while (s_instanced.capacity < count) s_instanced.capacity *= 2;
+    // Orphan the old storage so the driver doesn't stall on last frame's draws
+    glBufferData(GL_ARRAY_BUFFER, s_instanced.capacity * sizeof(MeshInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(MeshInstance), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Queued instanced draw (mesh_queue_instanced)
+static void mesh_draw_instanced_item(const RenderItem* item, bool rebound) {
+    const Mesh* mesh = (const Mesh*)item->object;
+    if (rebound) mesh_bind_layout(mesh, &s_instanced.uniforms);
+
+    // Point the per-instance attributes at this range of the instance buffer
+    // (GL 3.3 has no base-instance draw, so the offset goes into the pointers)
+    glBindBuffer(GL_ARRAY_BUFFER, s_instanced.instance_vbo);
+    size_t base = (size_t)item->first * sizeof(MeshInstance);
+    for (int col = 0; col < 4; col++) {
+        GLuint loc = MESH_INSTANCE_ATTRIB + col;
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstance),
+                              (void*)(base + offsetof(MeshInstance, model) + col * 4 * sizeof(float)));
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    GLuint color_loc = MESH_INSTANCE_ATTRIB + 4;
+    glVertexAttribPointer(color_loc, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstance),
+                          (void*)(base + offsetof(MeshInstance, color)));
+    glEnableVertexAttribArray(color_loc);
+    glVertexAttribDivisor(color_loc, 1);
+
+    mesh_draw_lod(mesh, item->lod, item->count);
+}
+
+void mesh_queue_instanced(RenderQueue* queue, const Mesh* mesh, uint32_t first_instance, uint32_t instance_count,
+                          int lod) {
+    if (!s_instanced.valid || !mesh->vao || instance_count == 0) return;
+
+    RenderItem item = {};
+    item.key = render_queue_key(RENDER_PASS_OPAQUE, s_instanced.shader.program, mesh->vao, 0);
+    item.program = s_instanced.shader.program;
+    item.vao = mesh->vao;
+    item.draw = mesh_draw_instanced_item;
+    item.object = mesh;
+    item.first = first_instance;
+    item.count = instance_count;
+    item.lod = lod;
+    render_queue_push(queue, &item);
+}
+
+void mesh_draw_stats_reset(void) {
+    s_draw_stats = MeshDrawStats{};
+}
+
+MeshDrawStats mesh_draw_stats(void) {
+    return s_draw_stats;
+}
@@ -1,6 +1,20 @@
 /*
  * Mesh Renderer
  * Renders mesh data with OpenGL using vertex colors and basic lighting
+ *
+ * Meshes are uploaded either as MeshData's float Vertex layout (40 bytes)
+ * or, with mesh_set_compact(true), as a compact layout:
+ *   - position: unorm16 x3 relative to the mesh bounds (dequantized in the shader)
+ *   - normal:   snorm16 x2 octahedral encoding
+ *   - color:    a constant attribute when every vertex has the same color
+ *               (12 bytes per vertex), otherwise RGBA8 (16 bytes)
+ * Index buffers use 16-bit indices whenever the vertex count allows.
+ *
+ * All LOD levels of a mesh (MeshData::lods) share its buffers. Callers pick
+ * a level per instance with mesh_select_lod() and pass it to the draw calls.
+ *
+ * Draws go through a RenderQueue (render_queue.h): camera and light come
+ * from its FrameData block, and items sort by program and mesh.
  */
 
 #ifndef MESH_H
@@ -9,9 +23,19 @@
 #include <GL/glew.h>
 #include "glb_loader.h"
 #include "shader.h"
+#include "render_queue.h"
 #include "../math/mat4.h"
 #include "../math/vec3.h"
 
+// Per-instance data for instanced rendering (matches the instanced shader layout)
+typedef struct MeshInstance {
+    float model[16];   // Column-major model matrix
+    float color[4];    // RGB override color, w = 1.0 to apply override (0.0 = none)
+} MeshInstance;
+
+// Largest on-screen simplification error (pixels) allowed when selecting a LOD
+#define MESH_LOD_PIXEL_ERROR 1.5f
+
 typedef struct Mesh {
     GLuint vao;
     GLuint vbo;
@@ -20,6 +44,20 @@ typedef struct Mesh {
 
     uint32_t vertex_count;
     uint32_t index_count;
+    GLenum index_type;      // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+
+    // Vertex layout
+    bool compact;           // Quantized positions and octahedral normals
+    bool uniform_color;     // Color attribute disabled, color[] used for all vertices
+    float color[4];
+    float pos_offset[3];    // Position = pos_offset + attribute * pos_scale
+    float pos_scale[3];
+    size_t gpu_bytes;       // Vertex + index buffer size
+
+    // Level-of-detail index ranges (level 0 = full detail, 0 levels = draw arrays)
+    uint32_t lod_count;
+    MeshLod lods[MESH_MAX_LODS];
+    float lod_extent;       // Largest bounds extent (mesh units)
 
     // Bounding box (from MeshData)
     float min_bounds[3];
@@ -31,9 +69,18 @@ typedef struct Mesh {
 // Create mesh from loaded MeshData
 bool mesh_create(Mesh* mesh, const MeshData* data);
 
-// Render mesh with given transform and camera matrices
-// color_override: RGB color to apply to white vertices (NULL = no override)
-void mesh_render(Mesh* mesh, const Mat4* model, const Mat4* view, const Mat4* projection, Vec3 light_dir, const float* color_override);
+// Queue one draw of mesh with the shared shader
+// model: column-major model matrix; color_override: RGB color to apply to
+// white vertices (NULL = no override). Both must stay valid until the submit.
+// lod: level from mesh_select_lod() (0 = full detail)
+void mesh_queue(RenderQueue* queue, const Mesh* mesh, const float* model, const float* color_override, int lod);
+
+// Screen pixels per world unit at distance 1 for a perspective projection
+float mesh_lod_pixel_scale(const Mat4* projection, float viewport_height);
+
+// Coarsest level whose simplification error stays under MESH_LOD_PIXEL_ERROR
+// on screen. model: column-major model matrix; pixel_scale from mesh_lod_pixel_scale()
+int mesh_select_lod(const Mesh* mesh, const float* model, const Mat4* view, float pixel_scale);
 
 // Destroy mesh and free OpenGL resources
 void mesh_destroy(Mesh* mesh);
@@ -44,4 +91,51 @@ bool mesh_shader_create(Shader* shader);
 // Set the shared shader for all meshes
 void mesh_set_shader(Shader* shader);
 
+// Upload meshes created from now on in the compact vertex layout
+void mesh_set_compact(bool enabled);
+
+// ============================================================================
+// Instanced rendering
+// Parts sharing a mesh are drawn with one call per unique mesh:
+//   mesh_instances_upload(all_instances, total);              // once per view
+//   mesh_queue_instanced(&queue, mesh, first, count, lod);    // once per unique mesh
+// Instances for one mesh must be contiguous in the uploaded array.
+// ============================================================================
+
+// Create the instanced shader and instance buffer (call once after GL init)
+// initial_capacity: instances to preallocate (buffer grows as needed)
+bool mesh_instancing_init(uint32_t initial_capacity);
+
+// True once mesh_instancing_init() has succeeded
+bool mesh_instancing_ready(void);
+
+// Free instanced rendering resources
+void mesh_instancing_destroy(void);
+
+// Upload this frame's instance data
+void mesh_instances_upload(const MeshInstance* instances, uint32_t count);
+
+// Queue instance_count copies of mesh using instances [first_instance, first_instance + count)
+void mesh_queue_instanced(RenderQueue* queue, const Mesh* mesh, uint32_t first_instance, uint32_t instance_count,
+                          int lod);
+
+// ============================================================================
+// Draw counters
+// Every queued mesh draw counts one draw call and the triangles of the
+// selected LOD times its instances when the queue is submitted:
+//   mesh_draw_stats_reset();                // before drawing the parts
+//   MeshDrawStats parts = mesh_draw_stats();
+// ============================================================================
+
+typedef struct MeshDrawStats {
+    uint32_t draw_calls;
+    uint64_t triangles;
+} MeshDrawStats;
+
+// Zero the counters
+void mesh_draw_stats_reset(void);
+
+// Draws since the last reset
+MeshDrawStats mesh_draw_stats(void);
+
 #endif // MESH_H
@@ -0,0 +1,480 @@
+/*
+ * Mesh Cache Implementation
+ */
+
+#include "mesh_cache.h"
+#include "load_jobs.h"
+#include "mesh_lod.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#define PATH_SEP "\\"
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PATH_SEP "/"
+#endif
+
+// =============================================================================
+// Platform helpers
+// =============================================================================
+
+// Source GLB stamp used for invalidation
+static bool file_stamp(const char* path, int64_t* mtime, int64_t* size) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attr)) return false;
+    *mtime = (int64_t)(((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) |
+                       attr.ftLastWriteTime.dwLowDateTime) / 10000000;
+    *size = (int64_t)(((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow);
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *mtime = (int64_t)st.st_mtime;
+    *size = (int64_t)st.st_size;
+#endif
+    return true;
+}
+
+static bool has_glb_extension(const char* name) {
+    size_t len = strlen(name);
+    if (len < 4) return false;
+    const char* ext = name + len - 4;
+    return ext[0] == '.' && (ext[1] == 'g' || ext[1] == 'G') &&
+           (ext[2] == 'l' || ext[2] == 'L') && (ext[3] == 'b' || ext[3] == 'B');
+}
+
+// Sorted GLB file names in a directory (empty if it doesn't exist)
+static std::vector<std::string> list_glb_files(const char* dir) {
+    std::vector<std::string> names;
+#ifdef _WIN32
+    char pattern[1024];
+    snprintf(pattern, sizeof(pattern), "%s\\*.glb", dir);
+    WIN32_FIND_DATAA fd;
+    HANDLE find = FindFirstFileA(pattern, &fd);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) names.push_back(fd.cFileName);
+        } while (FindNextFileA(find, &fd));
+        FindClose(find);
+    }
+#else
+    DIR* d = opendir(dir);
+    if (d) {
+        struct dirent* ent;
+        while ((ent = readdir(d)) != NULL) {
+            if (ent->d_name[0] != '.' && has_glb_extension(ent->d_name)) names.push_back(ent->d_name);
+        }
+        closedir(d);
+    }
+#endif
+    std::sort(names.begin(), names.end(), [](const std::string& a, const std::string& b) {
+        return strcmp(a.c_str(), b.c_str()) < 0;
+    });
+    return names;
+}
+
+// =============================================================================
+// Part index
+// =============================================================================
+
+// Length of a part name without a ".dat" or ".glb" extension (any case)
+static size_t part_number_length(const char* name) {
+    size_t len = strlen(name);
+    if (len < 4 || name[len - 4] != '.') return len;
+    char ext[3];
+    for (int i = 0; i < 3; i++) ext[i] = (char)tolower((unsigned char)name[len - 3 + i]);
+    return (memcmp(ext, "dat", 3) == 0 || memcmp(ext, "glb", 3) == 0) ? len - 4 : len;
+}
+
+// FNV-1a of the first len characters
+static uint32_t part_number_hash(const char* name, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Build the part index of cooked entries (at most half full, so probes stay short)
+static std::vector<MeshCacheSlot> build_part_index(const std::vector<MeshCacheEntry>& entries) {
+    uint32_t size = 16;
+    while (size < entries.size() * 2) size *= 2;
+    std::vector<MeshCacheSlot> slots(size, MeshCacheSlot{0, MESH_CACHE_EMPTY_SLOT});
+
+    for (uint32_t i = 0; i < (uint32_t)entries.size(); i++) {
+        const char* name = entries[i].glb_name;
+        size_t len = part_number_length(name);
+        uint32_t hash = part_number_hash(name, len);
+        uint32_t s = hash & (size - 1);
+        for (; slots[s].entry != MESH_CACHE_EMPTY_SLOT; s = (s + 1) & (size - 1)) {
+            const char* other = entries[slots[s].entry].glb_name;
+            if (slots[s].hash == hash && part_number_length(other) == len && strncmp(other, name, len) == 0) break;
+        }
+        // "x.GLB" and "x.glb" share a part number; the lowercase extension wins
+        if (slots[s].entry != MESH_CACHE_EMPTY_SLOT && strcmp(name + len, ".glb") != 0) continue;
+        slots[s].hash = hash;
+        slots[s].entry = i;
+    }
+    return slots;
+}
+
+// =============================================================================
+// Open / Close
+// =============================================================================
+
+static bool validate(const MeshCache* cache) {
+    if (cache->size < sizeof(MeshCacheHeader)) return false;
+    const MeshCacheHeader* h = cache->header;
+    if (h->magic != MESH_CACHE_MAGIC || h->version != MESH_CACHE_VERSION) return false;
+    if (h->vertex_size != sizeof(Vertex) || h->file_size != cache->size) return false;
+
+    size_t toc_end = sizeof(MeshCacheHeader) + (size_t)h->entry_count * sizeof(MeshCacheEntry);
+    if (toc_end > cache->size) return false;
+
+    // The part index needs a free slot to end every probe
+    if ((h->index_size & (h->index_size - 1)) != 0 || h->index_size <= h->entry_count) return false;
+    if (h->index_offset < toc_end || h->index_offset + (uint64_t)h->index_size * sizeof(MeshCacheSlot) > cache->size) {
+        return false;
+    }
+    const MeshCacheSlot* slots = (const MeshCacheSlot*)(cache->data + h->index_offset);
+    for (uint32_t s = 0; s < h->index_size; s++) {
+        if (slots[s].entry != MESH_CACHE_EMPTY_SLOT && slots[s].entry >= h->entry_count) return false;
+    }
+
+    for (uint32_t i = 0; i < h->entry_count; i++) {
+        const MeshCacheEntry* e = &cache->entries[i];
+        if (memchr(e->glb_name, '\0', sizeof(e->glb_name)) == NULL) return false;
+        if (e->vertex_offset + (uint64_t)e->vertex_count * sizeof(Vertex) > cache->size) return false;
+        if (e->index_offset + (uint64_t)e->index_count * sizeof(uint32_t) > cache->size) return false;
+        if (e->lod_count > MESH_MAX_LODS) return false;
+        for (uint32_t l = 0; l < e->lod_count; l++) {
+            if ((uint64_t)e->lods[l].first_index + e->lods[l].index_count > e->index_count) return false;
+        }
+    }
+    return true;
+}
+
+bool mesh_cache_open(MeshCache* cache, const char* path) {
+    memset(cache, 0, sizeof(MeshCache));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    cache->file_handle = file;
+    cache->mapping_handle = mapping;
+    cache->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (data == MAP_FAILED) return false;
+    cache->size = (size_t)st.st_size;
+#endif
+
+    cache->data = (const uint8_t*)data;
+    cache->header = (const MeshCacheHeader*)cache->data;
+    cache->entries = (const MeshCacheEntry*)(cache->data + sizeof(MeshCacheHeader));
+
+    if (!validate(cache)) {
+        fprintf(stderr, "[MeshCache] Ignoring invalid or outdated cache: %s\n", path);
+        mesh_cache_close(cache);
+        return false;
+    }
+    cache->slots = (const MeshCacheSlot*)(cache->data + cache->header->index_offset);
+    return true;
+}
+
+void mesh_cache_close(MeshCache* cache) {
+    if (cache->data) {
+#ifdef _WIN32
+        UnmapViewOfFile(cache->data);
+        if (cache->mapping_handle) CloseHandle((HANDLE)cache->mapping_handle);
+        if (cache->file_handle) CloseHandle((HANDLE)cache->file_handle);
+#else
+        munmap((void*)cache->data, cache->size);
+#endif
+    }
+    memset(cache, 0, sizeof(MeshCache));
+}
+
+// =============================================================================
+// Invalidation
+// =============================================================================
+
+bool mesh_cache_is_current(const MeshCache* cache, const char* parts_dir) {
+    if (!cache->data) return false;
+
+    // Same file set (both sorted by name) with matching stamps
+    std::vector<std::string> names = list_glb_files(parts_dir);
+    if (names.size() != cache->header->entry_count) return false;
+
+    for (size_t i = 0; i < names.size(); i++) {
+        const MeshCacheEntry* e = &cache->entries[i];
+        if (strcmp(names[i].c_str(), e->glb_name) != 0) return false;
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s" PATH_SEP "%s", parts_dir, e->glb_name);
+        int64_t mtime, size;
+        if (!file_stamp(path, &mtime, &size)) return false;
+        if (mtime != e->source_mtime || size != e->source_size) return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Cooking
+// =============================================================================
+
+// Decode one GLB for cooking
+struct CookJobs {
+    const std::vector<std::string>* paths;
+    std::vector<MeshData>* meshes;
+};
+
+static void cook_job(void* user_data, int index) {
+    CookJobs* jobs = (CookJobs*)user_data;
+    MeshData* mesh = &(*jobs->meshes)[index];
+    // Parts that fail to load are cooked as empty entries, so they
+    // are not retried from the GLB on every launch
+    if (!glb_load((*jobs->paths)[index].c_str(), mesh)) memset(mesh, 0, sizeof(MeshData));
+    mesh_lod_generate(mesh);
+}
+
+static uint64_t align16(uint64_t v) {
+    return (v + 15) & ~(uint64_t)15;
+}
+
+int mesh_cache_cook(const char* parts_dir, const char* cache_path) {
+    std::vector<std::string> names = list_glb_files(parts_dir);
+    if (names.empty()) return -1;
+
+    printf("[MeshCache] Cooking %zu parts from %s\n", names.size(), parts_dir);
+
+    std::vector<MeshCacheEntry> entries;
+    std::vector<std::string> paths;
+    entries.reserve(names.size());
+    paths.reserve(names.size());
+
+    for (const std::string& name : names) {
+        if (name.size() >= MESH_CACHE_NAME_SIZE) continue;
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s" PATH_SEP "%s", parts_dir, name.c_str());
+
+        MeshCacheEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        if (!file_stamp(path, &entry.source_mtime, &entry.source_size)) continue;
+
+        snprintf(entry.glb_name, sizeof(entry.glb_name), "%s", name.c_str());
+        entries.push_back(entry);
+        paths.push_back(path);
+    }
+
+    // Decode all parts on the worker pool
+    std::vector<MeshData> meshes(entries.size());
+    CookJobs jobs = { &paths, &meshes };
+    load_jobs_run((int)paths.size(), cook_job, &jobs, load_jobs_thread_count());
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        MeshCacheEntry& entry = entries[i];
+        const MeshData& mesh = meshes[i];
+        memcpy(entry.mesh_name, mesh.name, sizeof(entry.mesh_name));
+        entry.mesh_name[sizeof(entry.mesh_name) - 1] = '\0';
+        entry.vertex_count = mesh.vertex_count;
+        entry.index_count = mesh.index_count;
+        memcpy(entry.min_bounds, mesh.min_bounds, sizeof(entry.min_bounds));
+        memcpy(entry.max_bounds, mesh.max_bounds, sizeof(entry.max_bounds));
+        entry.lod_count = mesh.lod_count;
+        memcpy(entry.lods, mesh.lods, sizeof(entry.lods));
+    }
+
+    std::vector<MeshCacheSlot> slots = build_part_index(entries);
+
+    // Lay out the part index and blobs after the table of contents
+    uint64_t index_offset = align16(sizeof(MeshCacheHeader) + entries.size() * sizeof(MeshCacheEntry));
+    uint64_t offset = align16(index_offset + slots.size() * sizeof(MeshCacheSlot));
+    for (MeshCacheEntry& e : entries) {
+        e.vertex_offset = offset;
+        offset = align16(offset + (uint64_t)e.vertex_count * sizeof(Vertex));
+        e.index_offset = offset;
+        offset = align16(offset + (uint64_t)e.index_count * sizeof(uint32_t));
+    }
+
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MESH_CACHE_MAGIC;
+    header.version = MESH_CACHE_VERSION;
+    header.vertex_size = sizeof(Vertex);
+    header.entry_count = (uint32_t)entries.size();
+    header.file_size = offset;
+    header.index_offset = index_offset;
+    header.index_size = (uint32_t)slots.size();
+
+    // Write to a temporary file, then replace the cache
+    std::string tmp_path = std::string(cache_path) + ".tmp";
+    FILE* f = fopen(tmp_path.c_str(), "wb");
+    bool ok = f != NULL;
+    if (ok) {
+        static const uint8_t zeros[16] = {0};
+        uint64_t pos = 0;
+        auto write_at = [&](uint64_t at, const void* data, size_t size) {
+            if (at > pos) ok = ok && fwrite(zeros, 1, (size_t)(at - pos), f) == at - pos;
+            if (size > 0) ok = ok && fwrite(data, 1, size, f) == size;
+            pos = at + size;
+        };
+
+        write_at(0, &header, sizeof(header));
+        write_at(pos, entries.data(), entries.size() * sizeof(MeshCacheEntry));
+        write_at(index_offset, slots.data(), slots.size() * sizeof(MeshCacheSlot));
+        for (size_t i = 0; i < entries.size(); i++) {
+            write_at(entries[i].vertex_offset, meshes[i].vertices, entries[i].vertex_count * sizeof(Vertex));
+            write_at(entries[i].index_offset, meshes[i].indices, entries[i].index_count * sizeof(uint32_t));
+        }
+        write_at(header.file_size, NULL, 0);
+        ok = (fclose(f) == 0) && ok;
+    }
+
+    for (MeshData& mesh : meshes) mesh_data_free(&mesh);
+
+    if (ok) {
+#ifdef _WIN32
+        ok = MoveFileExA(tmp_path.c_str(), cache_path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        ok = rename(tmp_path.c_str(), cache_path) == 0;
+#endif
+    }
+    if (!ok) {
+        fprintf(stderr, "[MeshCache] Failed to write %s\n", cache_path);
+        remove(tmp_path.c_str());
+        return -1;
+    }
+
+    printf("[MeshCache] Wrote %s (%u meshes, %.1f MB)\n", cache_path, header.entry_count,
+           header.file_size / (1024.0 * 1024.0));
+    return (int)header.entry_count;
+}
+
+bool mesh_cache_prepare(MeshCache* cache, const char* models_dir) {
+    char parts_dir[1024];
+    char cache_path[1024];
+    snprintf(parts_dir, sizeof(parts_dir), "%s" PATH_SEP "parts", models_dir);
+    snprintf(cache_path, sizeof(cache_path), "%s" PATH_SEP MESH_CACHE_FILE, models_dir);
+
+    if (mesh_cache_open(cache, cache_path)) {
+        if (mesh_cache_is_current(cache, parts_dir)) {
+            printf("[MeshCache] Using %s (%u meshes)\n", cache_path, cache->header->entry_count);
+            cache->complete = true;
+            return true;
+        }
+        printf("[MeshCache] Parts catalog changed, re-cooking\n");
+        mesh_cache_close(cache);
+    }
+
+    if (mesh_cache_cook(parts_dir, cache_path) < 0) return false;
+    if (!mesh_cache_open(cache, cache_path)) return false;
+    // Parts the cook skipped (long names, unreadable stamps) still load from their GLB
+    cache->complete = mesh_cache_is_current(cache, parts_dir);
+    return true;
+}
+
+// =============================================================================
+// Lookup
+// =============================================================================
+
+bool mesh_cache_find(const MeshCache* cache, const char* glb_name, MeshData* out) {
+    if (!cache || !cache->data) return false;
+
+    // Binary search (entries are sorted by name)
+    int lo = 0, hi = (int)cache->header->entry_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const MeshCacheEntry* e = &cache->entries[mid];
+        int cmp = strcmp(glb_name, e->glb_name);
+        if (cmp < 0) { hi = mid - 1; continue; }
+        if (cmp > 0) { lo = mid + 1; continue; }
+        return mesh_cache_get(cache, mid, out);
+    }
+    return false;
+}
+
+int mesh_cache_find_part(const MeshCache* cache, const char* part_name) {
+    if (!cache || !cache->data) return -1;
+
+    size_t len = part_number_length(part_name);
+    uint32_t hash = part_number_hash(part_name, len);
+    uint32_t mask = cache->header->index_size - 1;
+    for (uint32_t s = hash & mask;; s = (s + 1) & mask) {
+        const MeshCacheSlot* slot = &cache->slots[s];
+        if (slot->entry == MESH_CACHE_EMPTY_SLOT) return -1;
+        if (slot->hash != hash) continue;
+        const char* glb_name = cache->entries[slot->entry].glb_name;
+        if (strncmp(glb_name, part_name, len) == 0 && part_number_length(glb_name) == len) return (int)slot->entry;
+    }
+}
+
+bool mesh_cache_get(const MeshCache* cache, int entry, MeshData* out) {
+    if (!cache || !cache->data || entry < 0 || (uint32_t)entry >= cache->header->entry_count) return false;
+
+    const MeshCacheEntry* e = &cache->entries[entry];
+    memset(out, 0, sizeof(MeshData));
+    out->vertices = (Vertex*)(cache->data + e->vertex_offset);
+    out->vertex_count = e->vertex_count;
+    out->indices = e->index_count > 0 ? (uint32_t*)(cache->data + e->index_offset) : NULL;
+    out->index_count = e->index_count;
+    memcpy(out->min_bounds, e->min_bounds, sizeof(out->min_bounds));
+    memcpy(out->max_bounds, e->max_bounds, sizeof(out->max_bounds));
+    memcpy(out->name, e->mesh_name, sizeof(out->name));
+    out->lod_count = e->lod_count;
+    memcpy(out->lods, e->lods, sizeof(out->lods));
+    out->borrowed = true;
+    return true;
+}
+
+bool mesh_cache_load(const MeshCache* cache, const char* glb_path, const char* glb_name,
+                     MeshData* out) {
+    if (mesh_cache_find(cache, glb_name, out)) {
+        // Failed loads are cooked as empty entries
+        return out->vertex_count > 0;
+    }
+    if (cache && cache->complete) return false;   // No such GLB in models/parts
+    if (!glb_load(glb_path, out)) return false;
+    mesh_lod_generate(out);
+    return true;
+}
@@ -0,0 +1,127 @@
+/*
+ * Mesh Cache
+ * Single-file cache of cooked part meshes for the whole parts catalog.
+ *
+ * Cooking loads every GLB in models/parts once and writes its interleaved
+ * Vertex array, index array and bounds exactly as mesh_create() uploads
+ * them. At startup the cache file is memory-mapped and parts are looked up
+ * by GLB file name, so no GLB is opened or parsed.
+ *
+ * Cooking also generates the simplified LOD index ranges (mesh_lod.h),
+ * stored after the full-detail indices of each mesh, and a hashed index by
+ * part number, so robot loads resolve LDraw names ("228-2500-208.dat")
+ * without building file names or searching by string.
+ *
+ * Each entry records the source GLB's mtime and size. The cache is rebuilt
+ * when the catalog changes (a GLB added, removed, or modified).
+ *
+ * Usage:
+ *   MeshCache cache;
+ *   mesh_cache_prepare(&cache, models_dir);          // open, cooking if stale
+ *   MeshData mesh;
+ *   if (mesh_cache_load(&cache, glb_path, glb_name, &mesh)) {
+ *       ...                                          // mesh.borrowed if served from the cache
+ *       mesh_data_free(&mesh);
+ *   }
+ *   int part = mesh_cache_find_part(&cache, "228-2500-208.dat");   // -1 if not cooked
+ *   if (part >= 0) mesh_cache_get(&cache, part, &mesh);
+ *   mesh_cache_close(&cache);
+ */
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "glb_loader.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define MESH_CACHE_FILE "parts.meshcache"   // Inside the models directory
+#define MESH_CACHE_MAGIC 0x434D5856         // "VXMC"
+#define MESH_CACHE_VERSION 3                // Bump when Vertex or the layout changes
+#define MESH_CACHE_NAME_SIZE 128
+#define MESH_CACHE_EMPTY_SLOT 0xFFFFFFFFu   // MeshCacheSlot::entry of a free slot
+
+// File layout: header, entries (sorted by name), part index slots, then
+// vertex/index blobs (16-byte aligned, offsets from the start of the file)
+typedef struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_size;      // sizeof(Vertex) at cook time
+    uint32_t entry_count;
+    uint64_t file_size;
+    uint64_t index_offset;     // Part index slots
+    uint32_t index_size;       // Slot count (power of two, at least twice entry_count)
+    uint32_t pad;
+} MeshCacheHeader;
+
+// Part index slot: open addressing with linear probing on the hash of the
+// part number (the GLB name without its extension)
+typedef struct MeshCacheSlot {
+    uint32_t hash;
+    uint32_t entry;            // Index into the entries (MESH_CACHE_EMPTY_SLOT = free)
+} MeshCacheSlot;
+
+typedef struct MeshCacheEntry {
+    char glb_name[MESH_CACHE_NAME_SIZE];   // File name in models/parts (lookup key)
+    char mesh_name[MESH_CACHE_NAME_SIZE];  // MeshData::name
+    int64_t source_mtime;                  // Source GLB modification time (seconds)
+    int64_t source_size;                   // Source GLB size in bytes
+    uint64_t vertex_offset;
+    uint64_t index_offset;
+    uint32_t vertex_count;
+    uint32_t index_count;                  // All LOD levels
+    float min_bounds[3];
+    float max_bounds[3];
+    uint32_t lod_count;
+    MeshLod lods[MESH_MAX_LODS];
+} MeshCacheEntry;
+
+typedef struct MeshCache {
+    const uint8_t* data;       // Mapped file (NULL if not open)
+    size_t size;
+    const MeshCacheHeader* header;
+    const MeshCacheEntry* entries;
+    const MeshCacheSlot* slots;
+    bool complete;             // Holds exactly the GLBs in models/parts (set by mesh_cache_prepare)
+
+    // Platform mapping handles
+    void* file_handle;
+    void* mapping_handle;
+} MeshCache;
+
+// Map a cache file. Returns false if missing or invalid (cache is left closed).
+bool mesh_cache_open(MeshCache* cache, const char* path);
+
+// Unmap the cache. Meshes borrowed from it become invalid.
+void mesh_cache_close(MeshCache* cache);
+
+// True if the cache holds exactly the GLBs in parts_dir with matching mtime/size
+bool mesh_cache_is_current(const MeshCache* cache, const char* parts_dir);
+
+// Cook every GLB in parts_dir into cache_path
+// Returns the number of meshes written, or -1 on failure
+int mesh_cache_cook(const char* parts_dir, const char* cache_path);
+
+// Open models_dir/parts.meshcache, cooking it first if missing or stale
+// Returns false if no cache is available (loads then fall back to GLB files)
+bool mesh_cache_prepare(MeshCache* cache, const char* models_dir);
+
+// Look up a cooked mesh by GLB file name
+// out points into the mapping (out->borrowed = true); nothing to free
+bool mesh_cache_find(const MeshCache* cache, const char* glb_name, MeshData* out);
+
+// Entry index of a part number, or -1 if it isn't cooked. A ".dat" or ".glb"
+// extension (any case) is ignored, so LDraw part names look up directly.
+int mesh_cache_find_part(const MeshCache* cache, const char* part_name);
+
+// Cooked mesh of an entry index (as mesh_cache_find; vertex_count 0 if it failed to cook)
+bool mesh_cache_get(const MeshCache* cache, int entry, MeshData* out);
+
+// Load a part mesh from the cache, falling back to glb_load(glb_path) plus LOD generation
+// (no fallback for a complete cache, which already holds every GLB there is)
+// Caller must call mesh_data_free() when done
+bool mesh_cache_load(const MeshCache* cache, const char* glb_path, const char* glb_name,
+                     MeshData* out);
+
+#endif // MESH_CACHE_H
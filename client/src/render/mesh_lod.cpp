@@ -0,0 +1,145 @@
+/*
+ * Mesh Level of Detail Implementation
+ */
+
+#include "mesh_lod.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+// Cells across the largest bounds extent for levels 1..MESH_MAX_LODS-1
+static const int lod_resolutions[MESH_MAX_LODS - 1] = {32, 12, 4};
+
+// Dominant normal axis and sign (0-5)
+static uint32_t normal_bucket(const float n[3]) {
+    int axis = 0;
+    if (fabsf(n[1]) > fabsf(n[axis])) axis = 1;
+    if (fabsf(n[2]) > fabsf(n[axis])) axis = 2;
+    return (uint32_t)(axis * 2 + (n[axis] < 0.0f ? 1 : 0));
+}
+
+// Small ids for the distinct vertex colors of a mesh
+static void color_ids(const MeshData* mesh, std::vector<uint32_t>* ids) {
+    std::vector<const float*> colors;
+    ids->resize(mesh->vertex_count);
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        const float* c = mesh->vertices[i].color;
+        uint32_t id = 0;
+        while (id < colors.size() && memcmp(colors[id], c, 4 * sizeof(float)) != 0) id++;
+        if (id == colors.size() && colors.size() < 255) colors.push_back(c);
+        (*ids)[i] = id < colors.size() ? id : 255;
+    }
+}
+
+// Remap the full-detail triangles onto one representative vertex per cell
+static void cluster_level(const MeshData* mesh, const std::vector<uint32_t>& colors, float cell,
+                          std::vector<uint32_t>* out) {
+    uint32_t n = mesh->vertex_count;
+
+    // Cell of every vertex
+    std::unordered_map<uint64_t, uint32_t> cluster_of_key;
+    std::vector<uint32_t> cluster(n);
+    std::vector<float> sums;
+    std::vector<uint32_t> counts;
+    for (uint32_t i = 0; i < n; i++) {
+        const Vertex* v = &mesh->vertices[i];
+        uint64_t key = 0;
+        for (int k = 0; k < 3; k++) {
+            int c = (int)floorf((v->position[k] - mesh->min_bounds[k]) / cell);
+            if (c < 0) c = 0;
+            if (c > 0xFFFF) c = 0xFFFF;
+            key |= (uint64_t)c << (16 * k);
+        }
+        key |= (uint64_t)normal_bucket(v->normal) << 48;
+        key |= (uint64_t)colors[i] << 52;
+
+        auto it = cluster_of_key.emplace(key, (uint32_t)counts.size());
+        if (it.second) {
+            sums.push_back(0.0f);
+            sums.push_back(0.0f);
+            sums.push_back(0.0f);
+            counts.push_back(0);
+        }
+        uint32_t c = it.first->second;
+        cluster[i] = c;
+        sums[c * 3 + 0] += v->position[0];
+        sums[c * 3 + 1] += v->position[1];
+        sums[c * 3 + 2] += v->position[2];
+        counts[c]++;
+    }
+
+    // Representative: the member closest to the cell's mean position
+    std::vector<uint32_t> rep(counts.size(), UINT32_MAX);
+    std::vector<float> rep_dist(counts.size(), 0.0f);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t c = cluster[i];
+        float d = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            float e = mesh->vertices[i].position[k] - sums[c * 3 + k] / counts[c];
+            d += e * e;
+        }
+        if (rep[c] == UINT32_MAX || d < rep_dist[c]) {
+            rep[c] = i;
+            rep_dist[c] = d;
+        }
+    }
+
+    // Collapse triangles, dropping degenerate ones
+    out->clear();
+    const uint32_t* src = mesh->indices + mesh->lods[0].first_index;
+    for (uint32_t t = 0; t + 2 < mesh->lods[0].index_count; t += 3) {
+        if (src[t] >= n || src[t + 1] >= n || src[t + 2] >= n) continue;
+        uint32_t a = rep[cluster[src[t]]];
+        uint32_t b = rep[cluster[src[t + 1]]];
+        uint32_t c = rep[cluster[src[t + 2]]];
+        if (a == b || b == c || a == c) continue;
+        out->push_back(a);
+        out->push_back(b);
+        out->push_back(c);
+    }
+}
+
+uint32_t mesh_lod_generate(MeshData* mesh) {
+    if (mesh->borrowed || mesh->lod_count != 1 || !mesh->indices) return mesh->lod_count;
+    if (mesh_data_triangle_count(mesh) < MESH_LOD_MIN_TRIANGLES) return mesh->lod_count;
+
+    float extent = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        extent = fmaxf(extent, mesh->max_bounds[k] - mesh->min_bounds[k]);
+    }
+    if (extent <= 0.0f) return mesh->lod_count;
+
+    std::vector<uint32_t> colors;
+    color_ids(mesh, &colors);
+
+    std::vector<uint32_t> all(mesh->indices, mesh->indices + mesh->index_count);
+    std::vector<uint32_t> level;
+    uint32_t prev_count = mesh->lods[0].index_count;
+    for (int r = 0; r < MESH_MAX_LODS - 1; r++) {
+        float cell_size = 1.0f / lod_resolutions[r];
+        cluster_level(mesh, colors, extent * cell_size, &level);
+        if (level.empty()) break;
+        if (level.size() > prev_count * MESH_LOD_MAX_RATIO) continue;
+
+        MeshLod* lod = &mesh->lods[mesh->lod_count++];
+        lod->first_index = (uint32_t)all.size();
+        lod->index_count = (uint32_t)level.size();
+        lod->cell_size = cell_size;
+        all.insert(all.end(), level.begin(), level.end());
+        prev_count = lod->index_count;
+    }
+
+    if (all.size() != mesh->index_count) {
+        uint32_t* indices = (uint32_t*)realloc(mesh->indices, all.size() * sizeof(uint32_t));
+        if (!indices) {
+            mesh->lod_count = 1;
+            return 1;
+        }
+        memcpy(indices, all.data(), all.size() * sizeof(uint32_t));
+        mesh->indices = indices;
+        mesh->index_count = (uint32_t)all.size();
+    }
+    return mesh->lod_count;
+}
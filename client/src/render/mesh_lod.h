@@ -0,0 +1,34 @@
+/*
+ * Mesh Level of Detail
+ * Builds coarser index ranges for a part mesh by vertex clustering.
+ *
+ * Each level snaps the full-detail triangles onto a uniform grid over the
+ * mesh bounds. Every grid cell keeps the member vertex closest to the
+ * cell's average position. Triangles that collapse are dropped. Levels
+ * are index ranges over the original vertex array (MeshData::lods), so
+ * they cost no extra vertices and share one GPU vertex buffer.
+ *
+ * Vertices with different colors, or normals facing different major
+ * axes, never share a cell. This keeps baked colors and the faces of
+ * boxy parts apart.
+ *
+ * Levels are generated when parts are cooked into the mesh cache. The
+ * renderer picks one per instance from its projected size (mesh.h).
+ */
+
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include "glb_loader.h"
+
+// Meshes with fewer triangles keep only the full-detail level
+#define MESH_LOD_MIN_TRIANGLES 48
+
+// A level is kept only if it has at most this fraction of the previous level's triangles
+#define MESH_LOD_MAX_RATIO 0.7f
+
+// Append simplified levels to a freshly loaded (single-level, non-borrowed) mesh
+// Returns the resulting level count
+uint32_t mesh_lod_generate(MeshData* mesh);
+
+#endif // MESH_LOD_H
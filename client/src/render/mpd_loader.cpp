@@ -71,8 +71,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // VEX IQ LDraw color palette (from LDConfig.ldr by Philo)
@@ -139,7 +139,7 @@ void ldraw_get_color(int color_code, float* r, float* g, float* b) {
 
 // Internal submodel structure
 struct SubmodelRef {
-    std::string name;
+    int target;                           // Index into the parsed submodel list
     int color_code;
     float x, y, z;
     float rotation[9];
@@ -147,10 +147,97 @@ struct SubmodelRef {
 
 struct Submodel {
     std::string name;
+    bool defined;                         // Seen a "0 FILE" line (not only referenced)
     std::vector<MpdPart> parts;           // Direct .dat part references
     std::vector<SubmodelRef> submodels;   // References to other submodels
 };
 
+// Parsed submodels with hashed, case-insensitive lookup (LDraw names are case-insensitive)
+struct SubmodelTable {
+    std::vector<Submodel> list;
+    std::unordered_map<std::string, int> index;  // Lowercase name -> index into list
+};
+
+// Grow a malloc'd array to hold at least needed elements
+static bool grow_array(void** data, uint32_t* capacity, uint32_t needed, size_t elem_size) {
+    if (needed <= *capacity) return true;
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < needed) new_capacity *= 2;
+    void* grown = realloc(*data, (size_t)new_capacity * elem_size);
+    if (!grown) return false;
+    *data = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+// Part name interning: open-addressed hash of name ids over the document's string table
+struct NameInterner {
+    std::vector<uint32_t> slots;          // name_id + 1 (0 = empty)
+    uint32_t data_capacity = 0;
+    uint32_t offset_capacity = 0;
+};
+
+static uint32_t name_hash(const char* name, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Returns the id of name (adding it if new), or UINT32_MAX if out of memory
+static uint32_t intern_name(MpdDocument* doc, NameInterner* interner, const char* name, size_t len) {
+    if (interner->slots.size() < (size_t)(doc->name_count + 1) * 2) {
+        // Rehash at 50% load
+        size_t slot_count = interner->slots.empty() ? 256 : interner->slots.size() * 2;
+        interner->slots.assign(slot_count, 0);
+        for (uint32_t id = 0; id < doc->name_count; id++) {
+            const char* existing = mpd_part_name(doc, id);
+            size_t slot = name_hash(existing, strlen(existing)) & (slot_count - 1);
+            while (interner->slots[slot]) slot = (slot + 1) & (slot_count - 1);
+            interner->slots[slot] = id + 1;
+        }
+    }
+
+    size_t mask = interner->slots.size() - 1;
+    size_t slot = name_hash(name, len) & mask;
+    while (interner->slots[slot]) {
+        const char* existing = mpd_part_name(doc, interner->slots[slot] - 1);
+        if (strncmp(existing, name, len) == 0 && existing[len] == '\0') return interner->slots[slot] - 1;
+        slot = (slot + 1) & mask;
+    }
+
+    if (!grow_array((void**)&doc->name_data, &interner->data_capacity,
+                    doc->name_data_size + (uint32_t)len + 1, 1) ||
+        !grow_array((void**)&doc->name_offsets, &interner->offset_capacity,
+                    doc->name_count + 1, sizeof(uint32_t))) {
+        return UINT32_MAX;
+    }
+    uint32_t id = doc->name_count++;
+    doc->name_offsets[id] = doc->name_data_size;
+    memcpy(doc->name_data + doc->name_data_size, name, len);
+    doc->name_data[doc->name_data_size + len] = '\0';
+    doc->name_data_size += (uint32_t)len + 1;
+    interner->slots[slot] = id + 1;
+    return id;
+}
+
+// Index of a submodel by name, adding an (undefined) entry if new
+static int find_or_add_submodel(SubmodelTable* table, const char* name, size_t len) {
+    std::string key(name, len);
+    for (auto& c : key) c = (char)tolower((unsigned char)c);
+    auto it = table->index.find(key);
+    if (it != table->index.end()) return it->second;
+
+    int idx = (int)table->list.size();
+    table->list.push_back(Submodel());
+    table->list[idx].name.assign(name, len);
+    table->list[idx].defined = false;
+    table->index.emplace(key, idx);
+    return idx;
+}
+
 // Multiply 3x3 rotation matrices (row-major)
 static void matrix_multiply(const float* a, const float* b, float* out) {
     out[0] = a[0]*b[0] + a[1]*b[3] + a[2]*b[6];
@@ -171,66 +258,97 @@ static void transform_point(const float* rot, float x, float y, float z, float*
     *oz = rot[6]*x + rot[7]*y + rot[8]*z;
 }
 
-// Parse a type 1 line
+// Parse a type 1 line in place
+// part_name/name_len point into line (name truncated to MPD_MAX_NAME - 1 characters)
 static bool parse_type1_line(const char* line, int* color, float* x, float* y, float* z,
-                             float* rot, char* part_name, size_t name_size) {
-    while (*line && isspace(*line)) line++;
-    if (line[0] != '1' || !isspace(line[1])) return false;
-
-    int n = sscanf(line, "1 %d %f %f %f %f %f %f %f %f %f %f %f %f %127s",
-                   color, x, y, z,
-                   &rot[0], &rot[1], &rot[2],
-                   &rot[3], &rot[4], &rot[5],
-                   &rot[6], &rot[7], &rot[8],
-                   part_name);
-    return n >= 14;
+                             float* rot, const char** part_name, size_t* name_len) {
+    while (*line && isspace((unsigned char)*line)) line++;
+    if (line[0] != '1' || !isspace((unsigned char)line[1])) return false;
+
+    char* end;
+    const char* p = line + 1;
+    *color = (int)strtol(p, &end, 10);
+    if (end == p) return false;
+    p = end;
+
+    float* values[12] = {x, y, z,
+                         &rot[0], &rot[1], &rot[2],
+                         &rot[3], &rot[4], &rot[5],
+                         &rot[6], &rot[7], &rot[8]};
+    for (int i = 0; i < 12; i++) {
+        *values[i] = strtof(p, &end);
+        if (end == p) return false;
+        p = end;
+    }
+
+    while (*p && isspace((unsigned char)*p)) p++;
+    const char* name = p;
+    while (*p && !isspace((unsigned char)*p)) p++;
+    if (p == name) return false;
+
+    *part_name = name;
+    *name_len = (size_t)(p - name);
+    if (*name_len > MPD_MAX_NAME - 1) *name_len = MPD_MAX_NAME - 1;
+    return true;
 }
 
 // Check if name is a submodel reference (.ldr)
-static bool is_submodel_ref(const char* name) {
-    const char* ext = strrchr(name, '.');
+static bool is_submodel_ref(const char* name, size_t len) {
+    const char* ext = NULL;
+    for (size_t i = 0; i < len; i++) {
+        if (name[i] == '.') ext = name + i;
+    }
     if (!ext) return false;
-    return (strcasecmp(ext, ".ldr") == 0 || strcasecmp(ext, ".mpd") == 0);
+    size_t ext_len = (size_t)(name + len - ext);
+    return ext_len == 4 && (strncasecmp(ext, ".ldr", 4) == 0 || strncasecmp(ext, ".mpd", 4) == 0);
+}
+
+// Read a whole file into a NUL-terminated buffer
+static bool read_file(const char* path, std::vector<char>* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return false;
+    }
+
+    out->resize((size_t)size + 1);
+    size_t read = fread(out->data(), 1, (size_t)size, f);
+    fclose(f);
+    (*out)[read] = '\0';
+    return true;
 }
 
 // Recursively expand submodel into flat part list
 // current_submodel_idx: index of the top-level submodel we're inside (-1 for main or when not tracking)
-static void expand_submodel(const std::string& name,
-                           const std::map<std::string, Submodel>& submodels,
+static void expand_submodel(int index,
+                           const SubmodelTable& submodels,
                            float px, float py, float pz,
                            const float* parent_rot,
                            int parent_color,
                            MpdDocument* out_doc,
                            int depth = 0,
                            int current_submodel_idx = -1) {
+    const Submodel& sub = submodels.list[index];
     if (depth > 20) {
-        fprintf(stderr, "[MPD] Warning: Max recursion depth reached for %s\n", name.c_str());
+        fprintf(stderr, "[MPD] Warning: Max recursion depth reached for %s\n", sub.name.c_str());
         return;
     }
-
-    auto it = submodels.find(name);
-    if (it == submodels.end()) {
-        // Try lowercase
-        std::string lower_name = name;
-        for (auto& c : lower_name) c = tolower(c);
-        it = submodels.find(lower_name);
-        if (it == submodels.end()) {
-            return;
-        }
-    }
-
-    const Submodel& sub = it->second;
+    if (!sub.defined) return;
 
     // Add all direct parts with transformed position and composed rotation
+    if (!grow_array((void**)&out_doc->parts, &out_doc->part_capacity,
+                    out_doc->part_count + (uint32_t)sub.parts.size(), sizeof(MpdPart))) {
+        fprintf(stderr, "[MPD] Warning: Out of memory expanding %s\n", sub.name.c_str());
+        return;
+    }
     for (const auto& part : sub.parts) {
-        if (out_doc->part_count >= MPD_MAX_PARTS) {
-            fprintf(stderr, "[MPD] Warning: Too many parts (max %d)\n", MPD_MAX_PARTS);
-            return;
-        }
-
         MpdPart out_part;
-        strncpy(out_part.part_name, part.part_name, MPD_MAX_NAME - 1);
-        out_part.part_name[MPD_MAX_NAME - 1] = '\0';
+        out_part.name_id = part.name_id;
 
         // Color inheritance: color 16 inherits from parent
         out_part.color_code = (part.color_code == 16) ? parent_color : part.color_code;
@@ -269,17 +387,18 @@ static void expand_submodel(const std::string& name,
 
         // At depth 0 (main model), each submodel reference becomes a top-level submodel
         int submodel_idx = current_submodel_idx;
-        if (depth == 0 && out_doc->submodel_count < MPD_MAX_SUBMODELS) {
+        if (depth == 0 && grow_array((void**)&out_doc->submodels, &out_doc->submodel_capacity,
+                                     out_doc->submodel_count + 1, sizeof(MpdSubmodel))) {
             submodel_idx = (int)out_doc->submodel_count;
             MpdSubmodel* sm = &out_doc->submodels[out_doc->submodel_count++];
-            strncpy(sm->name, ref.name.c_str(), MPD_MAX_NAME - 1);
+            strncpy(sm->name, submodels.list[ref.target].name.c_str(), MPD_MAX_NAME - 1);
             sm->name[MPD_MAX_NAME - 1] = '\0';
             sm->part_start = out_doc->part_count;
             sm->part_count = 0;  // Will be updated after expansion
         }
 
         uint32_t parts_before = out_doc->part_count;
-        expand_submodel(ref.name, submodels, new_x, new_y, new_z, new_rot, new_color, out_doc, depth + 1, submodel_idx);
+        expand_submodel(ref.target, submodels, new_x, new_y, new_z, new_rot, new_color, out_doc, depth + 1, submodel_idx);
 
         // Update part count for top-level submodels
         if (depth == 0 && submodel_idx >= 0 && submodel_idx < (int)out_doc->submodel_count) {
@@ -291,104 +410,106 @@ static void expand_submodel(const std::string& name,
 bool mpd_load(const char* path, MpdDocument* out_doc) {
     memset(out_doc, 0, sizeof(MpdDocument));
 
-    FILE* f = fopen(path, "r");
-    if (!f) {
+    std::vector<char> text;
+    if (!read_file(path, &text)) {
         fprintf(stderr, "[MPD] Failed to open: %s\n", path);
         return false;
     }
 
-    std::map<std::string, Submodel> submodels;
-    std::string main_model;
-    std::string current_model;
+    // One pass over the file: part names are interned into out_doc as they
+    // are seen, submodel references are resolved to indices by name
+    SubmodelTable submodels;
+    NameInterner interner;
+    int main_model = -1;
     Submodel* current = nullptr;
 
-    char line[1024];
-    while (fgets(line, sizeof(line), f)) {
-        // Remove trailing newline
+    char* line = text.data();
+    while (*line) {
+        char* next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+        else next = line + strlen(line);
+
+        // Remove trailing carriage return
         size_t len = strlen(line);
-        while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
+        while (len > 0 && line[len-1] == '\r') {
             line[--len] = '\0';
         }
-        if (len == 0) continue;
+        if (len == 0) {
+            line = next;
+            continue;
+        }
 
         // Check for FILE marker
         if (strncmp(line, "0 FILE ", 7) == 0) {
-            // Save previous model if any
-            if (current) {
-                submodels[current_model] = *current;
-            }
-
-            current_model = line + 7;
             // Trim whitespace
-            while (!current_model.empty() && isspace(current_model.back())) {
-                current_model.pop_back();
-            }
+            size_t name_len = len - 7;
+            while (name_len > 0 && isspace((unsigned char)line[7 + name_len - 1])) name_len--;
 
-            // First FILE is main model
-            if (main_model.empty()) {
-                main_model = current_model;
-            }
+            int idx = find_or_add_submodel(&submodels, line + 7, name_len);
 
-            submodels[current_model] = Submodel();
-            current = &submodels[current_model];
-            current->name = current_model;
+            // First FILE is main model
+            if (main_model < 0) main_model = idx;
+
+            // A repeated FILE replaces the earlier definition
+            current = &submodels.list[idx];
+            current->defined = true;
+            current->parts.clear();
+            current->submodels.clear();
+            line = next;
             continue;
         }
 
-        // Skip if no current model
-        if (!current) continue;
-
-        // Skip meta-commands
-        if (line[0] == '0') continue;
-
-        // Parse type 1 lines
-        if (line[0] == '1') {
+        // Parse type 1 lines (meta-commands and other line types are skipped)
+        if (current && line[0] == '1') {
             int color;
             float x, y, z;
             float rot[9];
-            char part_name[MPD_MAX_NAME];
+            const char* part_name;
+            size_t name_len;
 
-            if (parse_type1_line(line, &color, &x, &y, &z, rot, part_name, sizeof(part_name))) {
-                if (is_submodel_ref(part_name)) {
-                    // Submodel reference
+            if (parse_type1_line(line, &color, &x, &y, &z, rot, &part_name, &name_len)) {
+                if (is_submodel_ref(part_name, name_len)) {
+                    // Submodel reference (may be defined later in the file)
                     SubmodelRef ref;
-                    ref.name = part_name;
                     ref.color_code = color;
                     ref.x = x;
                     ref.y = y;
                     ref.z = z;
                     memcpy(ref.rotation, rot, sizeof(rot));
+                    int current_idx = (int)(current - submodels.list.data());
+                    ref.target = find_or_add_submodel(&submodels, part_name, name_len);
+                    current = &submodels.list[current_idx];  // list may have grown
                     current->submodels.push_back(ref);
                 } else {
                     // Direct part reference
                     MpdPart part;
-                    strncpy(part.part_name, part_name, MPD_MAX_NAME - 1);
-                    part.part_name[MPD_MAX_NAME - 1] = '\0';
+                    part.name_id = intern_name(out_doc, &interner, part_name, name_len);
+                    if (part.name_id == UINT32_MAX) {
+                        fprintf(stderr, "[MPD] Warning: Out of memory interning part names\n");
+                        line = next;
+                        continue;
+                    }
                     part.color_code = color;
                     part.x = x;
                     part.y = y;
                     part.z = z;
                     memcpy(part.rotation, rot, sizeof(rot));
+                    part.submodel_index = -1;
                     current->parts.push_back(part);
                 }
             }
         }
+        line = next;
     }
 
-    // Save last model
-    if (current) {
-        submodels[current_model] = *current;
-    }
-
-    fclose(f);
-
     // Expand main model recursively
-    if (main_model.empty()) {
+    if (main_model < 0) {
         fprintf(stderr, "[MPD] No main model found\n");
+        mpd_free(out_doc);
         return false;
     }
 
-    strncpy(out_doc->name, main_model.c_str(), MPD_MAX_NAME - 1);
+    strncpy(out_doc->name, submodels.list[main_model].name.c_str(), MPD_MAX_NAME - 1);
 
     // Identity rotation for root
     float identity[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
@@ -398,19 +519,24 @@ bool mpd_load(const char* path, MpdDocument* out_doc) {
 
     expand_submodel(main_model, submodels, 0, 0, 0, identity, default_color, out_doc);
 
-    printf("[MPD] Loaded: %s (%u parts, %u top-level submodels from %zu total submodels)\n",
-           out_doc->name, out_doc->part_count, out_doc->submodel_count, submodels.size());
+    printf("[MPD] Loaded: %s (%u parts, %u unique, %u top-level submodels from %zu total submodels)\n",
+           out_doc->name, out_doc->part_count, out_doc->name_count, out_doc->submodel_count,
+           submodels.list.size());
 
     return out_doc->part_count > 0;
 }
 
 void mpd_free(MpdDocument* doc) {
+    free(doc->parts);
+    free(doc->submodels);
+    free(doc->name_data);
+    free(doc->name_offsets);
     memset(doc, 0, sizeof(MpdDocument));
 }
 
 void mpd_print_info(const MpdDocument* doc) {
     printf("MPD Document: %s\n", doc->name[0] ? doc->name : "(unnamed)");
-    printf("  Parts: %u\n", doc->part_count);
+    printf("  Parts: %u (%u unique)\n", doc->part_count, doc->name_count);
     printf("  Submodels: %u\n", doc->submodel_count);
 
     // Print submodel info
@@ -435,14 +561,16 @@ void mpd_print_info(const MpdDocument* doc) {
     printf("  Part list:\n");
     for (uint32_t i = 0; i < show_first; i++) {
         const MpdPart* p = &doc->parts[i];
-        printf("    [%u] %s (color %d, submodel %d)\n", i, p->part_name, p->color_code, p->submodel_index);
+        printf("    [%u] %s (color %d, submodel %d)\n", i, mpd_part_name(doc, p->name_id),
+               p->color_code, p->submodel_index);
     }
 
     if (show_last > 0) {
         printf("    ... (%u more parts) ...\n", doc->part_count - show_first - show_last);
         for (uint32_t i = doc->part_count - show_last; i < doc->part_count; i++) {
             const MpdPart* p = &doc->parts[i];
-            printf("    [%u] %s (color %d, submodel %d)\n", i, p->part_name, p->color_code, p->submodel_index);
+            printf("    [%u] %s (color %d, submodel %d)\n", i, mpd_part_name(doc, p->name_id),
+                   p->color_code, p->submodel_index);
         }
     }
 }
@@ -19,10 +19,9 @@
 extern "C" {
 #endif
 
-// Maximum limits
-#define MPD_MAX_PARTS 1024
+// Name length limit (part, submodel and model names)
+// Parts and submodels are stored in growable arrays with no count limit
 #define MPD_MAX_NAME 128
-#define MPD_MAX_SUBMODELS 64
 
 // LDraw color codes (VEX IQ palette from LDConfig.ldr)
 typedef struct {
@@ -37,11 +36,11 @@ void ldraw_get_color(int color_code, float* r, float* g, float* b);
 
 // Part placement in an MPD file
 typedef struct {
-    char part_name[MPD_MAX_NAME];   // e.g., "228-2500-016.dat"
+    uint32_t name_id;                // Interned part name, see mpd_part_name() (e.g., "228-2500-016.dat")
     int color_code;                  // LDraw color code
     float x, y, z;                   // Position in LDU
     float rotation[9];               // 3x3 rotation matrix (row-major)
-    int submodel_index;              // Index into submodel_names (-1 for parts directly in main)
+    int submodel_index;              // Index into submodels (-1 for parts directly in main)
 } MpdPart;
 
 // Submodel info (for hierarchical collision)
@@ -52,21 +51,36 @@ typedef struct {
 } MpdSubmodel;
 
 // Loaded MPD document
+// Each distinct part name is stored once; parts refer to it by name_id
+// (0 .. name_count - 1, in first-use order)
 typedef struct {
-    char name[MPD_MAX_NAME];                  // Model name
-    MpdPart parts[MPD_MAX_PARTS];             // Part placements
-    uint32_t part_count;                      // Number of parts
-    MpdSubmodel submodels[MPD_MAX_SUBMODELS]; // Submodel info for hierarchy
-    uint32_t submodel_count;                  // Number of submodels
+    char name[MPD_MAX_NAME];         // Model name
+    MpdPart* parts;                  // Part placements
+    uint32_t part_count;
+    uint32_t part_capacity;
+    MpdSubmodel* submodels;          // Top-level submodels, for hierarchy
+    uint32_t submodel_count;
+    uint32_t submodel_capacity;
+
+    // Interned part names: NUL-terminated strings at name_data + name_offsets[id]
+    char* name_data;
+    uint32_t name_data_size;
+    uint32_t* name_offsets;
+    uint32_t name_count;
 } MpdDocument;
 
 // Load an MPD or LDR file
-// Returns true on success, fills out_doc
+// Returns true on success, fills out_doc (release with mpd_free())
 bool mpd_load(const char* path, MpdDocument* out_doc);
 
-// Free MPD document resources (if any dynamic allocation)
+// Free MPD document resources
 void mpd_free(MpdDocument* doc);
 
+// Interned part name for an MpdPart::name_id
+static inline const char* mpd_part_name(const MpdDocument* doc, uint32_t name_id) {
+    return doc->name_data + doc->name_offsets[name_id];
+}
+
 // Print document info
 void mpd_print_info(const MpdDocument* doc);
 
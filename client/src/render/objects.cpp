@@ -1,6 +1,8 @@
 #include "objects.h"
+#include "render_queue.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <vector>
 
@@ -9,35 +11,46 @@
 #endif
 
 // Object vertex shader
-static const char* object_vert_src = R"(
-#version 330 core
+static const char* object_vert_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 out vec3 worldPos;
 out vec3 normal;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 void main() {
     vec4 world = model * vec4(aPos, 1.0);
     worldPos = world.xyz;
     normal = mat3(transpose(inverse(model))) * aNormal;
-    gl_Position = projection * view * world;
+    gl_Position = u_projection * u_view * world;
+}
+)";
+
+// Field vertex shader: one instance per piece, positions from the piece buffer
+static const char* field_vert_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec4 aPiece;   // x, z, vel_x, vel_z
+out vec3 worldPos;
+out vec3 normal;
+uniform vec2 pieceSize;                  // radius, height
+void main() {
+    vec3 scale = vec3(pieceSize.x, pieceSize.y, pieceSize.x);
+    worldPos = aPos * scale + vec3(aPiece.x, 0.0, aPiece.y);
+    normal = aNormal / scale;
+    gl_Position = u_projection * u_view * vec4(worldPos, 1.0);
 }
 )";
 
 // Object fragment shader
-static const char* object_frag_src = R"(
-#version 330 core
+static const char* object_frag_src = "#version 330 core\n" RENDER_FRAME_GLSL R"(
 in vec3 worldPos;
 in vec3 normal;
 out vec4 FragColor;
 uniform vec3 objectColor;
-uniform vec3 cameraPos;
 
 void main() {
     // Simple directional lighting
-    vec3 lightDir = normalize(vec3(0.5, 1.0, 0.3));
+    vec3 lightDir = u_light_dir.xyz;
     vec3 norm = normalize(normal);
     float diff = max(dot(norm, lightDir), 0.0);
     float ambient = 0.3;
@@ -46,7 +59,7 @@ void main() {
     vec3 color = objectColor * lighting;
 
     // Simple specular highlight
-    vec3 viewDir = normalize(cameraPos - worldPos);
+    vec3 viewDir = normalize(u_camera_pos.xyz - worldPos);
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
     color += vec3(0.3) * spec;
@@ -135,17 +148,35 @@ static void generate_cylinder_mesh(std::vector<float>& verts, int segments) {
     }
 }
 
+// Grow objects and models together to hold at least needed entries
+static bool grow_objects(GameObjects* objs, int needed) {
+    if (needed <= objs->capacity) return true;
+    int capacity = objs->capacity ? objs->capacity : 16;
+    while (capacity < needed) capacity *= 2;
+    GameObject* objects = (GameObject*)realloc(objs->objects, (size_t)capacity * sizeof(GameObject));
+    if (!objects) return false;
+    objs->objects = objects;
+    float (*models)[16] = (float (*)[16])realloc(objs->models, (size_t)capacity * sizeof(objs->models[0]));
+    if (!models) return false;
+    objs->models = models;
+    objs->capacity = capacity;
+    return true;
+}
+
 bool objects_init(GameObjects* objs) {
+    objs->objects = NULL;
+    objs->models = NULL;
     objs->count = 0;
-    for (int i = 0; i < MAX_GAME_OBJECTS; i++) {
-        objs->objects[i].active = false;
-    }
+    objs->capacity = 0;
 
     // Create shader
     if (!shader_create(&objs->shader, object_vert_src, object_frag_src)) {
         fprintf(stderr, "Failed to create object shader\n");
         return false;
     }
+    render_frame_bind_program(objs->shader.program);
+    objs->model_loc = glGetUniformLocation(objs->shader.program, "model");
+    objs->color_loc = glGetUniformLocation(objs->shader.program, "objectColor");
 
     // Generate cylinder mesh
     std::vector<float> cylinder_verts;
@@ -170,20 +201,50 @@ bool objects_init(GameObjects* objs) {
 
     glBindVertexArray(0);
 
+    // Field pieces: the same mesh plus a per-instance piece (buffer bound at draw)
+    objs->field_buffer = 0;
+    objs->field_count = 0;
+    if (!shader_create(&objs->field_shader, field_vert_src, object_frag_src)) {
+        fprintf(stderr, "Failed to create object field shader\n");
+        return false;
+    }
+    render_frame_bind_program(objs->field_shader.program);
+    objs->field_size_loc = glGetUniformLocation(objs->field_shader.program, "pieceSize");
+    objs->field_color_loc = glGetUniformLocation(objs->field_shader.program, "objectColor");
+
+    glGenVertexArrays(1, &objs->field_vao);
+    glBindVertexArray(objs->field_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, objs->cylinder_vbo);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+
     printf("[Objects] Initialized with %d cylinder vertices\n", objs->cylinder_vertex_count);
     return true;
 }
 
 void objects_destroy(GameObjects* objs) {
     shader_destroy(&objs->shader);
+    shader_destroy(&objs->field_shader);
+    glDeleteVertexArrays(1, &objs->field_vao);
     glDeleteVertexArrays(1, &objs->cylinder_vao);
     glDeleteBuffers(1, &objs->cylinder_vbo);
+    free(objs->objects);
+    free(objs->models);
+    objs->objects = NULL;
+    objs->models = NULL;
+    objs->count = 0;
+    objs->capacity = 0;
 }
 
 int objects_add_cylinder(GameObjects* objs, float x, float z, float radius, float height,
                          float r, float g, float b) {
-    if (objs->count >= MAX_GAME_OBJECTS) {
-        fprintf(stderr, "[Objects] Max objects reached\n");
+    if (!grow_objects(objs, objs->count + 1)) {
+        fprintf(stderr, "[Objects] Out of memory for objects\n");
         return -1;
     }
 
@@ -206,9 +267,6 @@ int objects_add_cylinder(GameObjects* objs, float x, float z, float radius, floa
 
 void objects_clear(GameObjects* objs) {
     objs->count = 0;
-    for (int i = 0; i < MAX_GAME_OBJECTS; i++) {
-        objs->objects[i].active = false;
-    }
 }
 
 void objects_update_cylinder(GameObjects* objs, int index, float x, float z) {
@@ -218,44 +276,79 @@ void objects_update_cylinder(GameObjects* objs, int index, float x, float z) {
     }
 }
 
-void objects_render(GameObjects* objs, Mat4* view, Mat4* projection, Vec3 camera_pos) {
-    if (objs->count == 0) return;
+void objects_set_field(GameObjects* objs, GLuint buffer, uint32_t count, float radius, float height,
+                       float r, float g, float b) {
+    objs->field_buffer = buffer;
+    objs->field_count = buffer ? count : 0;
+    objs->field_radius = radius;
+    objs->field_height = height;
+    objs->field_color[0] = r;
+    objs->field_color[1] = g;
+    objs->field_color[2] = b;
+}
 
-    shader_use(&objs->shader);
-    shader_set_mat4(&objs->shader, "view", view);
-    shader_set_mat4(&objs->shader, "projection", projection);
-    shader_set_vec3(&objs->shader, "cameraPos", camera_pos);
+// Queued field: every piece in one instanced draw
+static void objects_draw_field(const RenderItem* item, bool rebound) {
+    (void)rebound;
+    const GameObjects* objs = (const GameObjects*)item->object;
+    glBindBuffer(GL_ARRAY_BUFFER, objs->field_buffer);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUniform2f(objs->field_size_loc, objs->field_radius, objs->field_height);
+    glUniform3fv(objs->field_color_loc, 1, objs->field_color);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, objs->cylinder_vertex_count, (GLsizei)objs->field_count);
+}
 
-    glBindVertexArray(objs->cylinder_vao);
+// Queued cylinder (item->first = object index)
+static void objects_draw_item(const RenderItem* item, bool rebound) {
+    (void)rebound;
+    const GameObjects* objs = (const GameObjects*)item->object;
+    glUniformMatrix4fv(objs->model_loc, 1, GL_FALSE, item->model);
+    const GameObject* obj = &objs->objects[item->first];
+    glUniform3f(objs->color_loc, obj->r, obj->g, obj->b);
+    glDrawArrays(GL_TRIANGLES, 0, objs->cylinder_vertex_count);
+}
 
+void objects_queue(GameObjects* objs, RenderQueue* queue, const Frustum* frustum) {
     for (int i = 0; i < objs->count; i++) {
         GameObject* obj = &objs->objects[i];
         if (!obj->active) continue;
 
-        // Create model matrix: translate then scale
-        Mat4 model = mat4_identity();
-
-        // Scale: radius for X/Z, height for Y
-        Mat4 scale = mat4_identity();
-        scale.m[0] = obj->radius;   // X scale
-        scale.m[5] = obj->height;   // Y scale
-        scale.m[10] = obj->radius;  // Z scale
-
-        // Translate to position
-        Mat4 translate = mat4_identity();
-        translate.m[12] = obj->x;
-        translate.m[13] = obj->y;
-        translate.m[14] = obj->z;
-
-        // Model = translate * scale
-        model = mat4_mul(translate, scale);
+        // Skip cylinders outside the view (base at y, top at y + height)
+        AABB bounds;
+        bounds.min = vec3(obj->x - obj->radius, obj->y, obj->z - obj->radius);
+        bounds.max = vec3(obj->x + obj->radius, obj->y + obj->height, obj->z + obj->radius);
+        if (!frustum_test_aabb(frustum, &bounds)) continue;
 
-        shader_set_mat4(&objs->shader, "model", &model);
-        shader_set_vec3(&objs->shader, "objectColor", vec3(obj->r, obj->g, obj->b));
-
-        glDrawArrays(GL_TRIANGLES, 0, objs->cylinder_vertex_count);
+        // Model = translate * scale (radius for X/Z, height for Y)
+        Mat4 model = mat4_identity();
+        model.m[0] = obj->radius;
+        model.m[5] = obj->height;
+        model.m[10] = obj->radius;
+        model.m[12] = obj->x;
+        model.m[13] = obj->y;
+        model.m[14] = obj->z;
+        memcpy(objs->models[i], model.m, sizeof(objs->models[i]));
+
+        RenderItem item = {};
+        item.key = render_queue_key(RENDER_PASS_OPAQUE, objs->shader.program, objs->cylinder_vao, 0);
+        item.program = objs->shader.program;
+        item.vao = objs->cylinder_vao;
+        item.draw = objects_draw_item;
+        item.object = objs;
+        item.model = objs->models[i];
+        item.first = (uint32_t)i;
+        render_queue_push(queue, &item);
     }
 
-    glBindVertexArray(0);
-    glUseProgram(0);
+    // The field covers the floor, so it isn't culled
+    if (objs->field_count > 0) {
+        RenderItem item = {};
+        item.key = render_queue_key(RENDER_PASS_OPAQUE, objs->field_shader.program, objs->field_vao, 0);
+        item.program = objs->field_shader.program;
+        item.vao = objs->field_vao;
+        item.draw = objects_draw_field;
+        item.object = objs;
+        render_queue_push(queue, &item);
+    }
 }
@@ -9,11 +9,11 @@
 #include <stdbool.h>
 #include <GL/glew.h>
 #include "shader.h"
+#include "frustum.h"
+#include "render_queue.h"
 #include "../math/mat4.h"
 #include "../math/vec3.h"
 
-#define MAX_GAME_OBJECTS 32
-
 typedef struct GameObject {
     float x, y, z;        // Position (y is height above ground)
     float radius;         // For cylinders: radius
@@ -23,14 +23,28 @@ typedef struct GameObject {
 } GameObject;
 
 typedef struct GameObjects {
-    GameObject objects[MAX_GAME_OBJECTS];
+    GameObject* objects;  // Growable, count used
     int count;
+    int capacity;         // Entries allocated in objects and models
 
     // OpenGL resources for cylinder
     GLuint cylinder_vao;
     GLuint cylinder_vbo;
     int cylinder_vertex_count;
     Shader shader;
+    GLint model_loc;
+    GLint color_loc;
+    float (*models)[16];  // Model matrices of the queued cylinders (capacity entries)
+
+    // Instanced pieces read straight from a GPU buffer (see objects_set_field)
+    Shader field_shader;
+    GLuint field_vao;
+    GLint field_size_loc;
+    GLint field_color_loc;
+    GLuint field_buffer;      // vec4 per piece: x, z, vel_x, vel_z (0 = none)
+    uint32_t field_count;
+    float field_radius, field_height;
+    float field_color[3];
 } GameObjects;
 
 // Initialize the game objects system
@@ -50,7 +64,13 @@ void objects_clear(GameObjects* objs);
 // Update cylinder position (for movable objects)
 void objects_update_cylinder(GameObjects* objs, int index, float x, float z);
 
-// Render all objects
-void objects_render(GameObjects* objs, Mat4* view, Mat4* projection, Vec3 camera_pos);
+// Draw count cylinders of one size and color from buffer (vec4 per piece:
+// x, z, vel_x, vel_z, e.g. gpu_field_buffer()) in one instanced draw.
+// The buffer is read when the queue is submitted; count 0 removes the field.
+void objects_set_field(GameObjects* objs, GLuint buffer, uint32_t count, float radius, float height,
+                       float r, float g, float b);
+
+// Queue the objects inside frustum and the field (matrices stay valid until the next call)
+void objects_queue(GameObjects* objs, RenderQueue* queue, const Frustum* frustum);
 
 #endif // OBJECTS_H
@@ -0,0 +1,129 @@
+/*
+ * Offscreen Render Targets Implementation
+ */
+
+#include "offscreen.h"
+#include <stdio.h>
+#include <string.h>
+
+bool offscreen_target_init(OffscreenTarget* target, int width, int height) {
+    memset(target, 0, sizeof(*target));
+    if (width <= 0 || height <= 0 || width > OFFSCREEN_MAX_SIZE || height > OFFSCREEN_MAX_SIZE) {
+        fprintf(stderr, "[Offscreen] Invalid target size %dx%d\n", width, height);
+        return false;
+    }
+    target->width = width;
+    target->height = height;
+
+    glGenRenderbuffers(1, &target->color);
+    glBindRenderbuffer(GL_RENDERBUFFER, target->color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &target->depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, target->depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &target->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target->color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target->depth);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[Offscreen] Framebuffer incomplete (0x%x)\n", status);
+        offscreen_target_destroy(target);
+        return false;
+    }
+
+    // Stream-read PBOs, one frame each
+    glGenBuffers(OFFSCREEN_READBACK_RING, target->pbos);
+    for (int i = 0; i < OFFSCREEN_READBACK_RING; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, target->pbos[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+void offscreen_target_destroy(OffscreenTarget* target) {
+    for (int i = 0; i < OFFSCREEN_READBACK_RING; i++) {
+        if (target->fences[i]) glDeleteSync(target->fences[i]);
+        target->fences[i] = 0;
+    }
+    if (target->pbos[0]) glDeleteBuffers(OFFSCREEN_READBACK_RING, target->pbos);
+    if (target->fbo) glDeleteFramebuffers(1, &target->fbo);
+    if (target->color) glDeleteRenderbuffers(1, &target->color);
+    if (target->depth) glDeleteRenderbuffers(1, &target->depth);
+    memset(target, 0, sizeof(*target));
+}
+
+bool offscreen_target_ready(OffscreenTarget* target) {
+    if (target->pending < OFFSCREEN_READBACK_RING) return true;
+    target->frames_skipped++;
+    return false;
+}
+
+void offscreen_target_begin(OffscreenTarget* target, float r, float g, float b) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
+    glViewport(0, 0, target->width, target->height);
+
+    // Keep the window's clear color
+    float saved[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, saved);
+    glClearColor(r, g, b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClearColor(saved[0], saved[1], saved[2], saved[3]);
+}
+
+void offscreen_target_end(OffscreenTarget* target, uint64_t tag) {
+    int slot = (target->tail + target->pending) % OFFSCREEN_READBACK_RING;
+
+    // Into the PBO: glReadPixels returns at once, the copy happens later
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, target->pbos[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, target->width, target->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    target->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    target->tags[slot] = tag;
+    target->pending++;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool offscreen_target_take(OffscreenTarget* target, uint8_t* rgb, uint64_t* tag) {
+    if (target->pending == 0) return false;
+    int slot = target->tail;
+
+    // Poll only: a zero timeout never blocks (flushing so the fence can signal)
+    GLenum wait = glClientWaitSync(target->fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (wait != GL_ALREADY_SIGNALED && wait != GL_CONDITION_SATISFIED) return false;
+    glDeleteSync(target->fences[slot]);
+    target->fences[slot] = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, target->pbos[slot]);
+    const uint8_t* pixels = (const uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                             (GLsizeiptr)target->width * target->height * 4,
+                                                             GL_MAP_READ_BIT);
+    bool ok = pixels != NULL;
+    if (ok) {
+        // GL rows start at the bottom; drop alpha
+        int w = target->width, h = target->height;
+        for (int y = 0; y < h; y++) {
+            const uint8_t* src = pixels + (size_t)(h - 1 - y) * w * 4;
+            uint8_t* dst = rgb + (size_t)y * w * 3;
+            for (int x = 0; x < w; x++, src += 4, dst += 3) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    *tag = target->tags[slot];
+    target->tail = (target->tail + 1) % OFFSCREEN_READBACK_RING;
+    target->pending--;
+    if (ok) target->frames_read++;
+    return ok;
+}
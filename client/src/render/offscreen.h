@@ -0,0 +1,72 @@
+/*
+ * Offscreen Render Targets
+ * Low-resolution framebuffers for robot-mounted cameras, read back to the
+ * CPU without stalling the frame.
+ *
+ * A target is a framebuffer (RGBA8 color + depth renderbuffers) with a ring
+ * of pixel buffer objects. offscreen_target_end() only queues glReadPixels
+ * into the next PBO and drops a fence behind it; the copy runs on the GPU
+ * while the frame goes on. offscreen_target_take() hands back the oldest
+ * readback whose fence has signaled and never waits for one that hasn't.
+ * When every PBO is still in flight the target reports not ready and the
+ * camera skips a frame instead of blocking.
+ *
+ * Usage (each frame, after the main view):
+ *   while (offscreen_target_take(&target, rgb, &frame_id)) ... width * height * 3 bytes
+ *   if (offscreen_target_ready(&target)) {
+ *       offscreen_target_begin(&target, 0.0f, 0.0f, 0.0f);
+ *       ... queue and submit the scene with the camera's matrices
+ *       offscreen_target_end(&target, frame_id);
+ *   }
+ */
+
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <GL/glew.h>
+
+#define OFFSCREEN_READBACK_RING 3     // Readbacks in flight per target
+#define OFFSCREEN_MAX_SIZE 1024       // Largest width or height
+
+typedef struct OffscreenTarget {
+    GLuint fbo;
+    GLuint color;                              // RGBA8 renderbuffer
+    GLuint depth;                              // 24-bit depth renderbuffer
+    int width, height;
+
+    // Readback ring: slots [tail, tail + pending) are in flight, oldest first
+    GLuint pbos[OFFSCREEN_READBACK_RING];
+    GLsync fences[OFFSCREEN_READBACK_RING];
+    uint64_t tags[OFFSCREEN_READBACK_RING];
+    int tail;
+    int pending;
+
+    uint32_t frames_read;                      // Readbacks taken
+    uint32_t frames_skipped;                   // Frames not rendered: ring full
+} OffscreenTarget;
+
+// Create a width x height target (1..OFFSCREEN_MAX_SIZE) on the current context
+bool offscreen_target_init(OffscreenTarget* target, int width, int height);
+
+// Delete the framebuffer, PBOs and fences
+void offscreen_target_destroy(OffscreenTarget* target);
+
+// A PBO is free for the next frame (take finished readbacks first).
+// Counts a skipped frame when it returns false.
+bool offscreen_target_ready(OffscreenTarget* target);
+
+// Bind the target, set its viewport and clear it
+void offscreen_target_begin(OffscreenTarget* target, float r, float g, float b);
+
+// Queue the readback of what was drawn, tagged with tag, and rebind the
+// default framebuffer (the caller restores its viewport). Call only after
+// offscreen_target_ready() returned true.
+void offscreen_target_end(OffscreenTarget* target, uint64_t tag);
+
+// Copy the oldest finished readback into rgb (width * height * 3 bytes, rows
+// top to bottom) and its tag into *tag. Returns false if none has finished.
+bool offscreen_target_take(OffscreenTarget* target, uint8_t* rgb, uint64_t* tag);
+
+#endif // OFFSCREEN_H
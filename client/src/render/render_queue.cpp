@@ -0,0 +1,111 @@
+/*
+ * Render Queue Implementation
+ */
+
+#include "render_queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>  // std::sort
+
+// Sort key bits, most significant first: pass (4), program (12), VAO (20),
+// color mode (4), submission order (24). GL names past the field widths
+// only share a sort bucket; binds still compare the real names.
+#define RENDER_KEY_ORDER_BITS 24
+#define RENDER_KEY_ORDER_MASK ((1u << RENDER_KEY_ORDER_BITS) - 1)
+
+bool render_queue_init(RenderQueue* queue) {
+    queue->items.clear();
+    queue->stats = RenderQueueStats{};
+    glGenBuffers(1, &queue->frame_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, queue->frame_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(RenderFrameData), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    queue->valid = queue->frame_ubo != 0;
+    if (!queue->valid) fprintf(stderr, "[Render] Failed to create the frame uniform buffer\n");
+    return queue->valid;
+}
+
+void render_queue_destroy(RenderQueue* queue) {
+    if (queue->frame_ubo) glDeleteBuffers(1, &queue->frame_ubo);
+    queue->frame_ubo = 0;
+    queue->items.clear();
+    queue->valid = false;
+}
+
+void render_frame_bind_program(GLuint program) {
+    GLuint index = glGetUniformBlockIndex(program, "FrameData");
+    if (index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, RENDER_FRAME_BINDING);
+}
+
+void render_queue_begin(RenderQueue* queue, const Mat4* view, const Mat4* projection, Vec3 camera_pos,
+                        Vec3 light_dir) {
+    queue->items.clear();
+    if (!queue->valid) return;
+
+    RenderFrameData frame;
+    memcpy(frame.view, view->m, sizeof(frame.view));
+    memcpy(frame.projection, projection->m, sizeof(frame.projection));
+    frame.camera_pos[0] = camera_pos.x;
+    frame.camera_pos[1] = camera_pos.y;
+    frame.camera_pos[2] = camera_pos.z;
+    frame.camera_pos[3] = 1.0f;
+    frame.light_dir[0] = light_dir.x;
+    frame.light_dir[1] = light_dir.y;
+    frame.light_dir[2] = light_dir.z;
+    frame.light_dir[3] = 0.0f;
+
+    // Orphan the storage: the previous view's draws may still be reading it
+    glBindBuffer(GL_UNIFORM_BUFFER, queue->frame_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(frame), NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frame), &frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, RENDER_FRAME_BINDING, queue->frame_ubo);
+}
+
+uint64_t render_queue_key(int pass, GLuint program, GLuint vao, int color_mode) {
+    return ((uint64_t)(pass & 0xF) << 60) | ((uint64_t)(program & 0xFFF) << 48) |
+           ((uint64_t)(vao & 0xFFFFF) << 28) | ((uint64_t)(color_mode & 0xF) << 24);
+}
+
+void render_queue_push(RenderQueue* queue, const RenderItem* item) {
+    queue->items.push_back(*item);
+    RenderItem& queued = queue->items.back();
+    queued.key = (queued.key & ~(uint64_t)RENDER_KEY_ORDER_MASK) |
+                 ((uint64_t)(queue->items.size() - 1) & RENDER_KEY_ORDER_MASK);
+}
+
+void render_queue_submit(RenderQueue* queue) {
+    RenderQueueStats stats = {};
+    stats.items = (uint32_t)queue->items.size();
+    if (queue->items.empty()) {
+        queue->stats = stats;
+        return;
+    }
+
+    std::sort(queue->items.begin(), queue->items.end(),
+              [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+
+    GLuint program = 0, vao = 0;
+    bool first = true;
+    for (const RenderItem& item : queue->items) {
+        bool rebound = first;
+        if (first || item.program != program) {
+            glUseProgram(item.program);
+            program = item.program;
+            stats.program_binds++;
+            rebound = true;
+        }
+        if (first || item.vao != vao) {
+            glBindVertexArray(item.vao);
+            vao = item.vao;
+            stats.vao_binds++;
+            rebound = true;
+        }
+        first = false;
+        item.draw(&item, rebound);
+    }
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+    queue->stats = stats;
+}
@@ -0,0 +1,116 @@
+/*
+ * Render Queue
+ * Sorted submission of scene draws, with the camera and light of each view
+ * in one uniform buffer.
+ *
+ * render_queue_begin() uploads the view's FrameData (view and projection
+ * matrices, camera position, light direction) into a UBO bound at
+ * RENDER_FRAME_BINDING. Scene shaders declare the block with
+ * RENDER_FRAME_GLSL and never take those as plain uniforms, so a view costs
+ * one buffer upload however many programs draw in it.
+ *
+ * Draw paths push RenderItems: a sort key (pass, program, VAO, color mode),
+ * the program and VAO to bind, and a callback that sets only per-item state
+ * (model matrix, color, instance range) and draws. render_queue_submit()
+ * sorts by key and binds a program or VAO only when it differs from the
+ * previous item's, so a new kind of object adds its items, not another
+ * round of per-frame state.
+ *
+ *   render_queue_begin(&queue, &view, &projection, eye, light_dir);
+ *   floor_queue(&floor, &queue); objects_queue(&objects, &queue); ...
+ *   render_queue_submit(&queue);
+ *
+ * Overlays with their own viewport or depth state (debug wireframes, the
+ * axis gizmo, text) still draw on their own after the scene.
+ */
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <GL/glew.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <vector>
+#include "../math/mat4.h"
+#include "../math/vec3.h"
+
+#define RENDER_FRAME_BINDING 0
+
+// FrameData block for scene shaders (insert after the #version line)
+#define RENDER_FRAME_GLSL \
+    "layout(std140) uniform FrameData {\n" \
+    "    mat4 u_view;\n" \
+    "    mat4 u_projection;\n" \
+    "    vec4 u_camera_pos;   // xyz\n" \
+    "    vec4 u_light_dir;    // xyz, normalized\n" \
+    "};\n"
+
+// std140 layout of FrameData
+typedef struct RenderFrameData {
+    float view[16];
+    float projection[16];
+    float camera_pos[4];
+    float light_dir[4];
+} RenderFrameData;
+
+// Passes draw in order; items within a pass are sorted by state
+enum RenderPass {
+    RENDER_PASS_OPAQUE = 0,
+    RENDER_PASS_TRANSPARENT = 1
+};
+
+struct RenderItem;
+
+// Draw one item. rebound: the program or VAO was just bound for this item,
+// so state shared by a run of items (per-mesh uniforms) must be set again.
+typedef void (*RenderDrawFn)(const RenderItem* item, bool rebound);
+
+struct RenderItem {
+    uint64_t key;             // render_queue_key() plus submission order
+    GLuint program;
+    GLuint vao;
+    RenderDrawFn draw;
+    const void* object;       // Owner data (Mesh, Floor, ...)
+    const float* model;       // Column-major model matrix (NULL = none)
+    const float* color;       // Override color (NULL = none)
+    uint32_t first;           // Instance range or sub-draw index
+    uint32_t count;
+    int lod;
+};
+
+// Binds and draws of the last submit
+typedef struct RenderQueueStats {
+    uint32_t items;
+    uint32_t program_binds;
+    uint32_t vao_binds;
+} RenderQueueStats;
+
+struct RenderQueue {
+    GLuint frame_ubo;
+    std::vector<RenderItem> items;   // Kept between frames (no steady-state allocations)
+    RenderQueueStats stats;
+    bool valid;
+};
+
+// Create the frame UBO (call once after GL init)
+bool render_queue_init(RenderQueue* queue);
+
+void render_queue_destroy(RenderQueue* queue);
+
+// Attach program's FrameData block to RENDER_FRAME_BINDING (call after linking)
+void render_frame_bind_program(GLuint program);
+
+// Start a view: clear the items and upload its FrameData
+void render_queue_begin(RenderQueue* queue, const Mat4* view, const Mat4* projection, Vec3 camera_pos,
+                        Vec3 light_dir);
+
+// Sort key of an item; color_mode groups items by their per-item uniforms
+uint64_t render_queue_key(int pass, GLuint program, GLuint vao, int color_mode);
+
+// Queue an item (its key gets the submission order, so equal keys keep it)
+void render_queue_push(RenderQueue* queue, const RenderItem* item);
+
+// Sort the items and draw them, binding only state that changes
+void render_queue_submit(RenderQueue* queue);
+
+#endif // RENDER_QUEUE_H
@@ -58,6 +58,32 @@ bool shader_create(Shader* s, const char* vertex_src, const char* fragment_src)
     return true;
 }
 
+bool shader_create_compute(Shader* s, const char* compute_src) {
+    memset(s, 0, sizeof(Shader));
+
+    GLuint comp = compile_shader(GL_COMPUTE_SHADER, compute_src);
+    if (!comp) return false;
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, comp);
+    glLinkProgram(program);
+    glDeleteShader(comp);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        fprintf(stderr, "Compute shader linking failed:\n%s\n", log);
+        glDeleteProgram(program);
+        return false;
+    }
+
+    s->program = program;
+    s->valid = true;
+    return true;
+}
+
 static char* read_file(const char* path) {
     FILE* f = fopen(path, "rb");
     if (!f) {
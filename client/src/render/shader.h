@@ -14,6 +14,9 @@ typedef struct Shader {
 // Create shader from source strings
 bool shader_create(Shader* s, const char* vertex_src, const char* fragment_src);
 
+// Create compute program from source (GL 4.3)
+bool shader_create_compute(Shader* s, const char* compute_src);
+
 // Create shader from files
 bool shader_load(Shader* s, const char* vertex_path, const char* fragment_path);
 
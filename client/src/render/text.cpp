@@ -1,12 +1,17 @@
 /*
  * Simple Text Renderer Implementation
  * Uses a minimal built-in bitmap font (8x8 pixels per character)
+ *
+ * All text goes through vertex streams of (x, y, u, v) triangles: the frame
+ * batch for text_render(), and one retained buffer per TextLayer.
  */
 
 #include "text.h"
 #include <GL/glew.h>
 #include <stdio.h>
 #include <string.h>
+#include <string>
+#include <vector>
 
 // Built-in 8x8 bitmap font (ASCII 32-127)
 // Each character is 8 bytes, one byte per row, MSB = leftmost pixel
@@ -113,6 +118,40 @@ static GLuint s_font_texture = 0;
 static GLuint s_text_shader = 0;
 static GLuint s_text_vao = 0;
 static GLuint s_text_vbo = 0;
+static size_t s_text_capacity = 0;    // Floats allocated in s_text_vbo
+static GLint s_loc_offset = -1;
+static GLint s_loc_scale = -1;
+static GLint s_loc_font = -1;
+
+// Frame batch (text_begin/text_end)
+static std::vector<float> s_batch;
+static bool s_batch_active = false;
+static int s_batch_width = 0;
+static int s_batch_height = 0;
+
+#define TEXT_FLOATS_PER_CHAR (6 * 4)   // 6 vertices of (x, y, u, v)
+#define TEXT_INITIAL_CHARS 1024
+
+// Default scale for panel text (smaller, cleaner look)
+static const float DEFAULT_SCALE = 1.25f;
+
+// One retained line: its text, position and tessellated quads
+struct TextLine {
+    std::string text;
+    float x, y;
+    std::vector<float> vertices;
+};
+
+struct TextLayer {
+    std::vector<TextLine> lines;
+    size_t line_count;         // Lines added since text_layer_begin()
+    bool dirty;                // Lines changed since the last upload
+
+    GLuint vao;
+    GLuint vbo;
+    size_t capacity;           // Floats allocated in vbo
+    size_t vertex_count;
+};
 
 static const char* text_vertex_shader = R"(
 #version 330 core
@@ -141,6 +180,98 @@ void main() {
 }
 )";
 
+// Create a VAO/VBO pair with the (pos, uv) layout
+static void create_vertex_buffer(GLuint* vao, GLuint* vbo, size_t capacity) {
+    glGenVertexArrays(1, vao);
+    glGenBuffers(1, vbo);
+
+    glBindVertexArray(*vao);
+    glBindBuffer(GL_ARRAY_BUFFER, *vbo);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0);
+}
+
+// Upload vertices, growing the buffer (and orphaning the old storage) as needed
+static void upload_vertices(GLuint vbo, size_t* capacity, const float* vertices, size_t count) {
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (count > *capacity) {
+        while (*capacity < count) *capacity *= 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, *capacity * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(float), vertices);
+}
+
+// Append two triangles per character of str, starting at (x, y)
+static void append_quads(std::vector<float>* out, const char* str, float x, float y, float scale) {
+    const float CHAR_WIDTH = 8.0f;
+    const float CHAR_HEIGHT = 8.0f;
+
+    float cx = x;
+    float cy = y;
+
+    for (const char* p = str; *p; p++) {
+        char c = *p;
+        if (c < 32 || c > 127) c = '?';
+
+        int char_index = c - 32;
+        float u0 = (char_index % 16) / 16.0f;
+        float v0 = (char_index / 16) / 6.0f;
+        float u1 = u0 + 1.0f / 16.0f;
+        float v1 = v0 + 1.0f / 6.0f;
+
+        float x0 = cx;
+        float y0 = cy;
+        float x1 = cx + CHAR_WIDTH * scale;
+        float y1 = cy + CHAR_HEIGHT * scale;
+
+        // Two triangles per character
+        const float quad[TEXT_FLOATS_PER_CHAR] = {
+            x0, y0, u0, v0,
+            x1, y0, u1, v0,
+            x1, y1, u1, v1,
+            x0, y0, u0, v0,
+            x1, y1, u1, v1,
+            x0, y1, u0, v1,
+        };
+        out->insert(out->end(), quad, quad + TEXT_FLOATS_PER_CHAR);
+
+        cx += CHAR_WIDTH * scale;
+    }
+}
+
+// Draw vertex_count text vertices from vao in screen pixel space
+static void draw_vertices(GLuint vao, size_t vertex_count, int screen_width, int screen_height) {
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(s_text_shader);
+    glUniform2f(s_loc_offset, 0, 0);
+    glUniform2f(s_loc_scale, 1.0f / screen_width, 1.0f / screen_height);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, s_font_texture);
+    glUniform1i(s_loc_font, 0);
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertex_count);
+    glBindVertexArray(0);
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
+
+static float right_aligned_x(const char* str, float margin, int screen_width) {
+    float text_width = (float)strlen(str) * 8.0f * DEFAULT_SCALE;
+    return screen_width - text_width - margin;
+}
+
 bool text_init(void) {
     // Create font texture (16x6 grid of 8x8 characters = 128x48 pixels)
     const int CHARS_PER_ROW = 16;
@@ -193,20 +324,14 @@ bool text_init(void) {
     glDeleteShader(vs);
     glDeleteShader(fs);
 
-    // Create VAO/VBO for quad rendering
-    glGenVertexArrays(1, &s_text_vao);
-    glGenBuffers(1, &s_text_vbo);
+    s_loc_offset = glGetUniformLocation(s_text_shader, "u_offset");
+    s_loc_scale = glGetUniformLocation(s_text_shader, "u_scale");
+    s_loc_font = glGetUniformLocation(s_text_shader, "u_font");
 
-    glBindVertexArray(s_text_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, s_text_vbo);
-    glBufferData(GL_ARRAY_BUFFER, 6 * 4 * sizeof(float) * 256, NULL, GL_DYNAMIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
+    // Create VAO/VBO for the frame batch
+    s_text_capacity = TEXT_INITIAL_CHARS * TEXT_FLOATS_PER_CHAR;
+    create_vertex_buffer(&s_text_vao, &s_text_vbo, s_text_capacity);
+    s_batch.reserve(s_text_capacity);
 
     printf("[Text] Font texture and shader initialized\n");
     return true;
@@ -218,90 +343,115 @@ void text_destroy(void) {
     if (s_text_shader) glDeleteProgram(s_text_shader);
     if (s_font_texture) glDeleteTextures(1, &s_font_texture);
     s_text_vao = s_text_vbo = s_text_shader = s_font_texture = 0;
+    s_text_capacity = 0;
+    s_batch.clear();
+    s_batch_active = false;
 }
 
-// Internal render function with scale parameter
-static void text_render_internal(const char* str, float x, float y, int screen_width, int screen_height, float scale) {
-    if (!s_text_shader || !str || !*str) return;
-
-    const float CHAR_WIDTH = 8.0f;
-    const float CHAR_HEIGHT = 8.0f;
-
-    // Build vertex data
-    float vertices[256 * 6 * 4];  // Max 256 chars, 6 verts per char, 4 floats per vert
-    int vertex_count = 0;
-
-    float cx = x;
-    float cy = y;
-
-    for (const char* p = str; *p && vertex_count < 256 * 6; p++) {
-        char c = *p;
-        if (c < 32 || c > 127) c = '?';
-
-        int char_index = c - 32;
-        float u0 = (char_index % 16) / 16.0f;
-        float v0 = (char_index / 16) / 6.0f;
-        float u1 = u0 + 1.0f / 16.0f;
-        float v1 = v0 + 1.0f / 6.0f;
+void text_begin(int screen_width, int screen_height) {
+    s_batch.clear();
+    s_batch_width = screen_width;
+    s_batch_height = screen_height;
+    s_batch_active = true;
+}
 
-        float x0 = cx;
-        float y0 = cy;
-        float x1 = cx + CHAR_WIDTH * scale;
-        float y1 = cy + CHAR_HEIGHT * scale;
+void text_end(void) {
+    if (!s_batch_active) return;
+    s_batch_active = false;
+    if (!s_text_shader || s_batch.empty()) return;
 
-        // Two triangles per character
-        float quad[6][4] = {
-            {x0, y0, u0, v0},
-            {x1, y0, u1, v0},
-            {x1, y1, u1, v1},
-            {x0, y0, u0, v0},
-            {x1, y1, u1, v1},
-            {x0, y1, u0, v1},
-        };
+    upload_vertices(s_text_vbo, &s_text_capacity, s_batch.data(), s_batch.size());
+    draw_vertices(s_text_vao, s_batch.size() / 4, s_batch_width, s_batch_height);
+    s_batch.clear();
+}
 
-        memcpy(&vertices[vertex_count * 4], quad, sizeof(quad));
-        vertex_count += 6;
+void text_render(const char* str, float x, float y, int screen_width, int screen_height) {
+    if (!s_text_shader || !str || !*str) return;
 
-        cx += CHAR_WIDTH * scale;
-    }
+    // Outside a batch, draw this string as a batch of its own
+    bool immediate = !s_batch_active;
+    if (immediate) text_begin(screen_width, screen_height);
+    append_quads(&s_batch, str, x, y, DEFAULT_SCALE);
+    if (immediate) text_end();
+}
 
-    if (vertex_count == 0) return;
+void text_render_right(const char* str, float margin, float y, int screen_width, int screen_height) {
+    if (!str) return;
+    text_render(str, right_aligned_x(str, margin, screen_width), y, screen_width, screen_height);
+}
 
-    // Upload vertices
-    glBindBuffer(GL_ARRAY_BUFFER, s_text_vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_count * 4 * sizeof(float), vertices);
+TextLayer* text_layer_create(void) {
+    TextLayer* layer = new TextLayer();
+    layer->line_count = 0;
+    layer->dirty = true;
+    layer->capacity = 64 * TEXT_FLOATS_PER_CHAR;
+    layer->vertex_count = 0;
+    create_vertex_buffer(&layer->vao, &layer->vbo, layer->capacity);
+    return layer;
+}
 
-    // Render
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+void text_layer_destroy(TextLayer* layer) {
+    if (!layer) return;
+    glDeleteVertexArrays(1, &layer->vao);
+    glDeleteBuffers(1, &layer->vbo);
+    delete layer;
+}
 
-    glUseProgram(s_text_shader);
-    glUniform2f(glGetUniformLocation(s_text_shader, "u_offset"), 0, 0);
-    glUniform2f(glGetUniformLocation(s_text_shader, "u_scale"), 1.0f / screen_width, 1.0f / screen_height);
+void text_layer_begin(TextLayer* layer) {
+    if (!layer) return;
+    layer->line_count = 0;
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, s_font_texture);
-    glUniform1i(glGetUniformLocation(s_text_shader, "u_font"), 0);
+void text_layer_add(TextLayer* layer, const char* str, float x, float y) {
+    if (!layer || !str) return;
 
-    glBindVertexArray(s_text_vao);
-    glDrawArrays(GL_TRIANGLES, 0, vertex_count);
+    if (layer->line_count == layer->lines.size()) {
+        layer->lines.push_back(TextLine());
+        layer->lines.back().x = -1.0f;
+        layer->lines.back().y = -1.0f;
+    }
+    TextLine& line = layer->lines[layer->line_count++];
+
+    // Re-tessellate only when the content or position changed
+    if (line.x == x && line.y == y && line.text == str) return;
+    line.text = str;
+    line.x = x;
+    line.y = y;
+    line.vertices.clear();
+    append_quads(&line.vertices, str, x, y, DEFAULT_SCALE);
+    layer->dirty = true;
+}
 
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
+void text_layer_add_right(TextLayer* layer, const char* str, float margin, float y, int screen_width) {
+    if (!str) return;
+    text_layer_add(layer, str, right_aligned_x(str, margin, screen_width), y);
 }
 
-// Default scale for panel text (smaller, cleaner look)
-static const float DEFAULT_SCALE = 1.25f;
+void text_layer_render(TextLayer* layer, int screen_width, int screen_height, Arena* frame) {
+    if (!layer || !s_text_shader) return;
 
-void text_render(const char* str, float x, float y, int screen_width, int screen_height) {
-    text_render_internal(str, x, y, screen_width, screen_height, DEFAULT_SCALE);
-}
+    // Lines not re-added this frame are dropped
+    if (layer->line_count < layer->lines.size()) {
+        layer->lines.resize(layer->line_count);
+        layer->dirty = true;
+    }
 
-void text_render_right(const char* str, float margin, float y, int screen_width, int screen_height) {
-    if (!str) return;
-    int len = (int)strlen(str);
-    float text_width = len * 8.0f * DEFAULT_SCALE;
-    float x = screen_width - text_width - margin;
-    text_render_internal(str, x, y, screen_width, screen_height, DEFAULT_SCALE);
+    if (layer->dirty) {
+        // Lines are combined in the frame arena for one upload
+        size_t count = 0;
+        for (const TextLine& line : layer->lines) count += line.vertices.size();
+        float* vertices = arena_alloc_array<float>(frame, count);
+        size_t offset = 0;
+        for (const TextLine& line : layer->lines) {
+            memcpy(vertices + offset, line.vertices.data(), line.vertices.size() * sizeof(float));
+            offset += line.vertices.size();
+        }
+        layer->vertex_count = count / 4;
+        if (count > 0) upload_vertices(layer->vbo, &layer->capacity, vertices, count);
+        layer->dirty = false;
+    }
+
+    if (layer->vertex_count > 0) {
+        draw_vertices(layer->vao, layer->vertex_count, screen_width, screen_height);
+    }
 }
@@ -1,12 +1,28 @@
 /*
  * Simple Text Renderer
  * Renders text using a built-in bitmap font
+ *
+ * Immediate text: text_render() calls between text_begin() and text_end()
+ * are collected into one vertex stream and drawn with a single draw call
+ * (outside a batch each call draws on its own).
+ *
+ * Retained text: a TextLayer keeps the quads of each line and its own vertex
+ * buffer. Re-add the lines every frame; a line is only re-tessellated when
+ * its text or position changes, and the buffer is only re-uploaded when some
+ * line did, so a static panel costs one draw call and no uploads.
+ *
+ * Usage:
+ *   TextLayer* panel = text_layer_create();
+ *   text_layer_begin(panel);
+ *   text_layer_add(panel, "GAMEPAD", 8.0f, 8.0f);
+ *   text_layer_render(panel, screen_width, screen_height, &frame_arena);
  */
 
 #ifndef TEXT_H
 #define TEXT_H
 
 #include <stdbool.h>
+#include "../sim/arena.h"
 
 // Initialize text rendering system
 bool text_init(void);
@@ -22,4 +38,26 @@ void text_render(const char* str, float x, float y, int screen_width, int screen
 // Render text aligned to right edge
 void text_render_right(const char* str, float margin, float y, int screen_width, int screen_height);
 
+// Batch every text_render() until text_end() into one upload and draw
+void text_begin(int screen_width, int screen_height);
+void text_end(void);
+
+// Retained text layer (lines are re-tessellated only when they change)
+typedef struct TextLayer TextLayer;
+
+TextLayer* text_layer_create(void);
+void text_layer_destroy(TextLayer* layer);
+
+// Start re-adding lines for this frame
+void text_layer_begin(TextLayer* layer);
+
+// Add the next line (same pixel coordinates as text_render)
+void text_layer_add(TextLayer* layer, const char* str, float x, float y);
+void text_layer_add_right(TextLayer* layer, const char* str, float margin, float y, int screen_width);
+
+// Draw the layer, uploading only if a line changed since the last render
+// Lines from the previous frame that were not re-added are dropped.
+// frame: scratch for combining the lines (sim/arena.h)
+void text_layer_render(TextLayer* layer, int screen_width, int screen_height, Arena* frame);
+
 #endif // TEXT_H
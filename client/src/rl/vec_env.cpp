@@ -0,0 +1,258 @@
+/*
+ * Vectorized Environment Implementation
+ */
+
+#include "vec_env.h"
+#include "../sim/sim_world.h"
+#include "../sim/job_system.h"
+#include "../scene/scene.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Envs per job: a step is tens of microseconds per env
+#define VEC_ENV_JOB_GRAIN 4
+
+struct VecEnv {
+    VecEnvConfig config;
+    std::string scene_path, models_dir;   // Owned copies of the config strings
+    Scene scene;
+    std::vector<Scene> start_scenes;      // Per env: the jittered scene of its episode
+    SimWorld templ;                       // Loaded scene; envs share its read-only data
+    std::vector<SimWorld> worlds;         // One per env
+    JobSystem* jobs;
+
+    int robot_count;
+    int cylinder_count;
+    int obs_size;
+    int action_size;
+    uint64_t seed;
+
+    // Per-env arrays (env major)
+    std::vector<float> observations;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+    std::vector<float> goal_distance;     // Robot 0 distance to goal after the last step
+    std::vector<uint32_t> episodes;       // Episodes started (reset jitter stream)
+
+    const float* actions;                 // Input of the step in progress
+};
+
+// SplitMix64 finalizer
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Uniform in [-1, 1) from the state, advancing it
+static float jitter_unit(uint64_t* state) {
+    *state = mix64(*state);
+    return (float)((double)(*state >> 11) * (2.0 / 9007199254740992.0) - 1.0);
+}
+
+static float robot_goal_distance(const VecEnv* env, const SimWorld* world) {
+    float dx = world->robots[0].drivetrain.pos_x - env->config.goal_x;
+    float dz = world->robots[0].drivetrain.pos_z - env->config.goal_z;
+    return sqrtf(dx * dx + dz * dz);
+}
+
+static uint32_t robot_contact_steps(const RobotInstance* robot) {
+    return robot->wall_contact_steps + robot->robot_contact_steps + robot->cylinder_contact_steps;
+}
+
+static void write_observation(VecEnv* env, int index) {
+    const SimWorld* world = &env->worlds[index];
+    float* obs = &env->observations[(size_t)index * env->obs_size];
+    for (const RobotInstance& robot : world->robots) {
+        const Drivetrain* dt = &robot.drivetrain;
+        obs[0] = dt->pos_x;
+        obs[1] = dt->pos_z;
+        obs[2] = sinf(dt->heading);
+        obs[3] = cosf(dt->heading);
+        obs[4] = dt->vel_x;
+        obs[5] = dt->vel_z;
+        obs[6] = dt->angular_vel;
+        obs += VEC_ENV_ROBOT_OBS;
+    }
+    for (uint32_t c = 0; c < world->scene.cylinder_count; c++) {
+        obs[0] = world->scene.cylinders[c].x;
+        obs[1] = world->scene.cylinders[c].z;
+        obs += VEC_ENV_CYLINDER_OBS;
+    }
+}
+
+// Start the next episode of one env at jittered scene poses
+static void reset_env(VecEnv* env, int index) {
+    uint64_t state = mix64(env->seed ^ mix64(((uint64_t)index << 32) | env->episodes[index]));
+    env->episodes[index]++;
+
+    Scene* scene = &env->start_scenes[index];
+    scene_copy(scene, &env->scene);
+    for (uint32_t r = 0; r < scene->robot_count; r++) {
+        scene->robots[r].x += env->config.start_jitter * jitter_unit(&state);
+        scene->robots[r].z += env->config.start_jitter * jitter_unit(&state);
+        scene->robots[r].rotation_y += env->config.heading_jitter * jitter_unit(&state);
+    }
+
+    SimWorld* world = &env->worlds[index];
+    sim_world_create_shared(world, &env->templ, scene);
+    env->goal_distance[index] = robot_goal_distance(env, world);
+    write_observation(env, index);
+}
+
+static void step_job(void* user_data, int begin, int end, int) {
+    VecEnv* env = (VecEnv*)user_data;
+    const VecEnvConfig* config = &env->config;
+
+    for (int i = begin; i < end; i++) {
+        SimWorld* world = &env->worlds[i];
+        const float* action = env->actions + (size_t)i * env->action_size;
+        for (int r = 0; r < env->robot_count; r++) {
+            const float* robot_action = action + r * VEC_ENV_ROBOT_ACTIONS;
+            sim_world_set_motors(world, r, robot_action[0], robot_action[1]);
+            sim_world_set_strafe(world, r, robot_action[2]);
+        }
+
+        uint32_t contacts_before = robot_contact_steps(&world->robots[0]);
+        for (int k = 0; k < config->frame_skip; k++) {
+            sim_world_step(world, config->dt);
+        }
+
+        float distance = robot_goal_distance(env, world);
+        uint32_t contacts = robot_contact_steps(&world->robots[0]) - contacts_before;
+        env->rewards[i] = (env->goal_distance[i] - distance) - config->contact_penalty * (float)contacts;
+        env->goal_distance[i] = distance;
+
+        bool reached = config->goal_radius > 0.0f && distance <= config->goal_radius;
+        bool timed_out = config->episode_seconds > 0.0f && world->time >= config->episode_seconds;
+        env->dones[i] = (reached || timed_out) ? 1 : 0;
+        if (env->dones[i]) {
+            reset_env(env, i);
+        } else {
+            write_observation(env, i);
+        }
+    }
+}
+
+static void reset_job(void* user_data, int begin, int end, int) {
+    VecEnv* env = (VecEnv*)user_data;
+    for (int i = begin; i < end; i++) {
+        reset_env(env, i);
+    }
+}
+
+void vec_env_config_init(VecEnvConfig* config) {
+    memset(config, 0, sizeof(VecEnvConfig));
+    config->env_count = 1;
+    config->dt = 1.0f / 60.0f;
+    config->frame_skip = 1;
+    config->episode_seconds = 20.0f;
+    config->goal_radius = 4.0f;
+}
+
+VecEnv* vec_env_create(const VecEnvConfig* config) {
+    if (!config || !config->scene_path || !config->models_dir || config->env_count <= 0 ||
+        config->dt <= 0.0f || config->frame_skip <= 0) {
+        fprintf(stderr, "[VecEnv] Invalid config\n");
+        return NULL;
+    }
+
+    VecEnv* env = new VecEnv();
+    env->config = *config;
+    env->scene_path = config->scene_path;
+    env->models_dir = config->models_dir;
+    env->config.scene_path = env->scene_path.c_str();
+    env->config.models_dir = env->models_dir.c_str();
+
+    if (!scene_load(env->config.scene_path, &env->scene)) {
+        delete env;
+        return NULL;
+    }
+    sim_world_set_threads(&env->templ, 1);
+    sim_world_create(&env->templ, &env->scene, env->config.models_dir, NULL);
+    if (env->templ.robots.empty()) {
+        fprintf(stderr, "[VecEnv] No robots loaded from %s\n", env->config.scene_path);
+        sim_world_destroy(&env->templ);
+        scene_free(&env->scene);
+        delete env;
+        return NULL;
+    }
+
+    env->robot_count = (int)env->templ.robots.size();
+    env->cylinder_count = (int)env->scene.cylinder_count;
+    env->obs_size = env->robot_count * VEC_ENV_ROBOT_OBS + env->cylinder_count * VEC_ENV_CYLINDER_OBS;
+    env->action_size = env->robot_count * VEC_ENV_ROBOT_ACTIONS;
+    env->seed = 0;
+
+    // Every env steps serially; parallelism is across envs
+    env->jobs = job_system_create(config->threads);
+    env->worlds.resize(config->env_count);
+    env->start_scenes.resize(config->env_count, Scene{});
+    for (SimWorld& world : env->worlds) sim_world_set_threads(&world, 1);
+
+    size_t count = (size_t)config->env_count;
+    env->observations.assign(count * env->obs_size, 0.0f);
+    env->rewards.assign(count, 0.0f);
+    env->dones.assign(count, 0);
+    env->goal_distance.assign(count, 0.0f);
+    env->episodes.assign(count, 0);
+    env->actions = NULL;
+
+    printf("[VecEnv] %d envs of %s: %d robots, obs %d, actions %d, %d threads\n",
+           config->env_count, env->config.scene_path, env->robot_count, env->obs_size, env->action_size,
+           job_system_thread_count(env->jobs));
+    return env;
+}
+
+void vec_env_destroy(VecEnv* env) {
+    if (!env) return;
+    job_system_destroy(env->jobs);
+    for (SimWorld& world : env->worlds) sim_world_destroy(&world);
+    sim_world_destroy(&env->templ);
+    for (Scene& scene : env->start_scenes) scene_free(&scene);
+    scene_free(&env->scene);
+    delete env;
+}
+
+int vec_env_count(const VecEnv* env) {
+    return env->config.env_count;
+}
+
+int vec_env_obs_size(const VecEnv* env) {
+    return env->obs_size;
+}
+
+int vec_env_action_size(const VecEnv* env) {
+    return env->action_size;
+}
+
+void vec_env_reset(VecEnv* env, uint64_t seed) {
+    env->seed = seed;
+    std::fill(env->episodes.begin(), env->episodes.end(), 0u);
+    std::fill(env->rewards.begin(), env->rewards.end(), 0.0f);
+    std::fill(env->dones.begin(), env->dones.end(), (uint8_t)0);
+    job_system_parallel_for(env->jobs, env->config.env_count, VEC_ENV_JOB_GRAIN, reset_job, env);
+}
+
+void vec_env_step(VecEnv* env, const float* actions) {
+    env->actions = actions;
+    job_system_parallel_for(env->jobs, env->config.env_count, VEC_ENV_JOB_GRAIN, step_job, env);
+    env->actions = NULL;
+}
+
+const float* vec_env_observations(const VecEnv* env) {
+    return env->observations.data();
+}
+
+const float* vec_env_rewards(const VecEnv* env) {
+    return env->rewards.data();
+}
+
+const uint8_t* vec_env_dones(const VecEnv* env) {
+    return env->dones.data();
+}
@@ -0,0 +1,106 @@
+/*
+ * Vectorized Environment
+ * N copies of one scene stepped together for reinforcement learning
+ * (gym-style reset / step), without rendering or robot programs.
+ *
+ * The scene is loaded once; every env is a shared world built from it
+ * (sim_world_create_shared), so an episode reset reads nothing from disk.
+ * Actions, observations, rewards and done flags live in contiguous arrays,
+ * env major, and vec_env_step() advances all envs on a job system (each env
+ * steps serially, so results do not depend on the thread count).
+ *
+ * Actions (action_size floats per env): left, right and strafe motor
+ * percentages (-100 to 100) of every robot, in robot order. Strafe only
+ * moves mecanum and omni robots.
+ *
+ * Observations (obs_size floats per env), per robot then per cylinder:
+ *   robot:    x, z, sin(heading), cos(heading), vel_x, vel_z, angular_vel
+ *   cylinder: x, z
+ * Positions in inches, velocities in inches/s and radians/s.
+ *
+ * Reward: progress of robot 0 toward the goal (inches closer this step),
+ * minus contact_penalty per physics step and kind of contact (wall, robot,
+ * cylinder) it had. An episode ends when robot 0 is within goal_radius of
+ * the goal or after episode_seconds; that env is reset at once (done = 1)
+ * and its observation is the first one of the new episode.
+ *
+ * Reset poses are the scene's, jittered per episode by start_jitter inches
+ * and heading_jitter degrees. Draws depend only on seed, the env index and
+ * the episode number.
+ *
+ * Usage:
+ *   VecEnvConfig config;
+ *   vec_env_config_init(&config);
+ *   config.scene_path = "scenes/default.scene";
+ *   config.env_count = 256;
+ *   VecEnv* env = vec_env_create(&config);
+ *   vec_env_reset(env, 0);
+ *   for (;;) {
+ *       fill_actions(actions);                        // env_count * action_size
+ *       vec_env_step(env, actions);
+ *       use(vec_env_observations(env), vec_env_rewards(env), vec_env_dones(env));
+ *   }
+ *   vec_env_destroy(env);
+ */
+
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VEC_ENV_ROBOT_OBS 7      // Observation floats per robot
+#define VEC_ENV_CYLINDER_OBS 2   // Observation floats per cylinder
+#define VEC_ENV_ROBOT_ACTIONS 3  // Action floats per robot (left, right, strafe motor %)
+
+typedef struct VecEnv VecEnv;
+
+typedef struct {
+    const char* scene_path;
+    const char* models_dir;     // Directory with robots/ and parts/
+    int env_count;
+    int threads;                // Job threads (<= 0 = hardware threads)
+    float dt;                   // Physics step in seconds
+    int frame_skip;             // Physics steps per vec_env_step (same action)
+    float episode_seconds;      // Simulated time limit per episode (<= 0 = none)
+    float goal_x, goal_z;       // Goal of robot 0 (inches)
+    float goal_radius;          // Episode ends within this distance (<= 0 = never)
+    float contact_penalty;      // Subtracted per physics step and kind of contact
+    float start_jitter;         // Reset position jitter, +- inches
+    float heading_jitter;       // Reset heading jitter, +- degrees
+} VecEnvConfig;
+
+// Defaults: 1 env, dt 1/60, frame_skip 1, 20 s episodes, goal at the field center
+void vec_env_config_init(VecEnvConfig* config);
+
+// Load the scene and build env_count envs (call vec_env_reset before stepping)
+// Returns NULL if the scene or its robots fail to load.
+VecEnv* vec_env_create(const VecEnvConfig* config);
+
+void vec_env_destroy(VecEnv* env);
+
+// Sizes (floats per env)
+int vec_env_count(const VecEnv* env);
+int vec_env_obs_size(const VecEnv* env);
+int vec_env_action_size(const VecEnv* env);
+
+// Start a new episode in every env; seed picks the reset jitter sequence
+void vec_env_reset(VecEnv* env, uint64_t seed);
+
+// Apply actions (env_count * action_size floats) for frame_skip physics
+// steps in every env, then update observations, rewards and dones
+void vec_env_step(VecEnv* env, const float* actions);
+
+// Results of the last reset/step, valid until the next call
+const float* vec_env_observations(const VecEnv* env);   // env_count * obs_size
+const float* vec_env_rewards(const VecEnv* env);        // env_count
+const uint8_t* vec_env_dones(const VecEnv* env);        // env_count (1 = episode ended, env was reset)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VEC_ENV_H
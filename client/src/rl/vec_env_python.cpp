@@ -0,0 +1,294 @@
+/*
+ * vexiq_env - Python extension around rl/vec_env
+ *
+ *   import numpy as np, vexiq_env
+ *   env = vexiq_env.VecEnv("scenes/default.scene", "models", num_envs=256, frame_skip=4)
+ *   obs = np.asarray(env.reset(seed=0))             # (num_envs, obs_size) float32
+ *   actions = np.zeros((env.num_envs, env.action_size), np.float32)
+ *   obs, rewards, dones = env.step(actions)        # wrap with np.asarray
+ *
+ * reset() and step() return read-only buffer views of the env's own arrays
+ * (no copies); they are overwritten by the next call. step() takes any
+ * C-contiguous float32 buffer and releases the GIL while the envs step.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "vec_env.h"
+#include <string.h>
+
+typedef struct {
+    PyObject_HEAD
+    VecEnv* env;
+    Py_ssize_t buffers;       // Buffer objects alive (they point into env's arrays)
+} VecEnvObject;
+
+// =============================================================================
+// Buffer - read-only view of one result array
+// =============================================================================
+
+typedef struct {
+    PyObject_HEAD
+    VecEnvObject* owner;      // VecEnv keeping the array alive
+    const void* data;
+    const char* format;       // struct format of one item
+    Py_ssize_t itemsize;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+} BufferObject;
+
+static int buffer_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    BufferObject* buffer = (BufferObject*)self;
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "vexiq_env buffers are read-only");
+        view->obj = NULL;
+        return -1;
+    }
+
+    Py_ssize_t len = buffer->itemsize;
+    for (int d = 0; d < buffer->ndim; d++) len *= buffer->shape[d];
+
+    view->buf = (void*)buffer->data;
+    view->obj = self;
+    Py_INCREF(self);
+    view->len = len;
+    view->itemsize = buffer->itemsize;
+    view->readonly = 1;
+    view->ndim = buffer->ndim;
+    view->format = (flags & PyBUF_FORMAT) ? (char*)buffer->format : NULL;
+    view->shape = (flags & PyBUF_ND) ? buffer->shape : NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? buffer->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static void buffer_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    VecEnvObject* owner = ((BufferObject*)self)->owner;
+    owner->buffers--;
+    Py_DECREF(owner);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyType_Slot buffer_slots[] = {
+    {Py_tp_doc, (void*)"Read-only view of a VecEnv result array (use numpy.asarray)"},
+    {Py_tp_dealloc, (void*)buffer_dealloc},
+    {Py_bf_getbuffer, (void*)buffer_getbuffer},
+    {0, NULL}
+};
+
+static PyType_Spec buffer_spec = {
+    "vexiq_env.Buffer", sizeof(BufferObject), 0, Py_TPFLAGS_DEFAULT, buffer_slots
+};
+
+static PyTypeObject* BufferType = NULL;
+
+static PyObject* buffer_new(VecEnvObject* owner, const void* data, const char* format, Py_ssize_t itemsize,
+                            Py_ssize_t rows, Py_ssize_t columns) {
+    BufferObject* buffer = PyObject_New(BufferObject, BufferType);
+    if (!buffer) return NULL;
+    Py_INCREF(owner);
+    owner->buffers++;
+    buffer->owner = owner;
+    buffer->data = data;
+    buffer->format = format;
+    buffer->itemsize = itemsize;
+    buffer->ndim = columns > 0 ? 2 : 1;
+    buffer->shape[0] = rows;
+    buffer->shape[1] = columns;
+    buffer->strides[0] = itemsize * (columns > 0 ? columns : 1);
+    buffer->strides[1] = itemsize;
+    return (PyObject*)buffer;
+}
+
+// =============================================================================
+// VecEnv
+// =============================================================================
+
+static bool env_open(VecEnvObject* self) {
+    if (self->env) return true;
+    PyErr_SetString(PyExc_ValueError, "VecEnv is closed");
+    return false;
+}
+
+static int vecenv_init(PyObject* obj, PyObject* args, PyObject* kwargs) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    static const char* keywords[] = {
+        "scene", "models_dir", "num_envs", "threads", "dt", "frame_skip", "episode_seconds",
+        "goal", "goal_radius", "contact_penalty", "start_jitter", "heading_jitter", NULL
+    };
+
+    VecEnvConfig config;
+    vec_env_config_init(&config);
+    const char* scene_path = NULL;
+    const char* models_dir = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ss|iifif(ff)ffff", (char**)keywords,
+                                     &scene_path, &models_dir, &config.env_count, &config.threads,
+                                     &config.dt, &config.frame_skip, &config.episode_seconds,
+                                     &config.goal_x, &config.goal_z, &config.goal_radius,
+                                     &config.contact_penalty, &config.start_jitter, &config.heading_jitter)) {
+        return -1;
+    }
+    config.scene_path = scene_path;
+    config.models_dir = models_dir;
+
+    if (self->buffers > 0) {
+        PyErr_SetString(PyExc_BufferError, "VecEnv buffers are still referenced");
+        return -1;
+    }
+    vec_env_destroy(self->env);
+    self->env = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    self->env = vec_env_create(&config);
+    Py_END_ALLOW_THREADS
+    if (!self->env) {
+        PyErr_Format(PyExc_RuntimeError, "failed to load scene %s", scene_path);
+        return -1;
+    }
+    return 0;
+}
+
+static void vecenv_dealloc(PyObject* obj) {
+    PyTypeObject* type = Py_TYPE(obj);
+    vec_env_destroy(((VecEnvObject*)obj)->env);
+    type->tp_free(obj);
+    Py_DECREF(type);
+}
+
+static PyObject* observations_buffer(VecEnvObject* self) {
+    return buffer_new(self, vec_env_observations(self->env), "f", sizeof(float),
+                      vec_env_count(self->env), vec_env_obs_size(self->env));
+}
+
+static PyObject* vecenv_reset(PyObject* obj, PyObject* args, PyObject* kwargs) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    static const char* keywords[] = { "seed", NULL };
+    unsigned long long seed = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|K", (char**)keywords, &seed)) return NULL;
+    if (!env_open(self)) return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    vec_env_reset(self->env, (uint64_t)seed);
+    Py_END_ALLOW_THREADS
+    return observations_buffer(self);
+}
+
+static PyObject* vecenv_step(PyObject* obj, PyObject* actions) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    if (!env_open(self)) return NULL;
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(actions, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) return NULL;
+    Py_ssize_t expected = (Py_ssize_t)vec_env_count(self->env) * vec_env_action_size(self->env);
+    const char* format = view.format ? view.format : "B";
+    if (format[0] == '<' || format[0] == '=' || format[0] == '@') format++;
+    if (strcmp(format, "f") != 0 || view.itemsize != sizeof(float) || view.len != expected * (Py_ssize_t)sizeof(float)) {
+        PyErr_Format(PyExc_ValueError, "actions must be %zd contiguous float32 values (num_envs x action_size)", expected);
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    vec_env_step(self->env, (const float*)view.buf);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+
+    PyObject* result = PyTuple_New(3);
+    if (!result) return NULL;
+    PyTuple_SET_ITEM(result, 0, observations_buffer(self));
+    PyTuple_SET_ITEM(result, 1, buffer_new(self, vec_env_rewards(self->env), "f", sizeof(float),
+                                           vec_env_count(self->env), 0));
+    PyTuple_SET_ITEM(result, 2, buffer_new(self, vec_env_dones(self->env), "B", 1,
+                                           vec_env_count(self->env), 0));
+    for (int i = 0; i < 3; i++) {
+        if (!PyTuple_GET_ITEM(result, i)) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+static PyObject* vecenv_close(PyObject* obj, PyObject*) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    if (self->buffers > 0) {
+        PyErr_SetString(PyExc_BufferError, "VecEnv buffers are still referenced");
+        return NULL;
+    }
+    vec_env_destroy(self->env);
+    self->env = NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject* vecenv_get_num_envs(PyObject* obj, void*) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    return env_open(self) ? PyLong_FromLong(vec_env_count(self->env)) : NULL;
+}
+
+static PyObject* vecenv_get_obs_size(PyObject* obj, void*) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    return env_open(self) ? PyLong_FromLong(vec_env_obs_size(self->env)) : NULL;
+}
+
+static PyObject* vecenv_get_action_size(PyObject* obj, void*) {
+    VecEnvObject* self = (VecEnvObject*)obj;
+    return env_open(self) ? PyLong_FromLong(vec_env_action_size(self->env)) : NULL;
+}
+
+static PyMethodDef vecenv_methods[] = {
+    {"reset", (PyCFunction)(void (*)(void))vecenv_reset, METH_VARARGS | METH_KEYWORDS,
+     "reset(seed=0) -> observations\nStart a new episode in every env."},
+    {"step", vecenv_step, METH_O,
+     "step(actions) -> (observations, rewards, dones)\nactions: float32 (num_envs, action_size) motor percentages."},
+    {"close", vecenv_close, METH_NOARGS, "Free the envs (no buffers may be alive)."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef vecenv_getset[] = {
+    {"num_envs", vecenv_get_num_envs, NULL, "Number of envs", NULL},
+    {"obs_size", vecenv_get_obs_size, NULL, "Observation floats per env", NULL},
+    {"action_size", vecenv_get_action_size, NULL, "Action floats per env (left, right, strafe % per robot)", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyType_Slot vecenv_slots[] = {
+    {Py_tp_doc, (void*)"VecEnv(scene, models_dir, num_envs=1, threads=0, dt=1/60, frame_skip=1, "
+                       "episode_seconds=20, goal=(0, 0), goal_radius=4, contact_penalty=0, "
+                       "start_jitter=0, heading_jitter=0)"},
+    {Py_tp_new, (void*)PyType_GenericNew},
+    {Py_tp_init, (void*)vecenv_init},
+    {Py_tp_dealloc, (void*)vecenv_dealloc},
+    {Py_tp_methods, vecenv_methods},
+    {Py_tp_getset, vecenv_getset},
+    {0, NULL}
+};
+
+static PyType_Spec vecenv_spec = {
+    "vexiq_env.VecEnv", sizeof(VecEnvObject), 0, Py_TPFLAGS_DEFAULT, vecenv_slots
+};
+
+// =============================================================================
+// Module
+// =============================================================================
+
+static PyModuleDef vexiq_env_module = {
+    PyModuleDef_HEAD_INIT, "vexiq_env", "Vectorized VEX IQ simulation environments", -1,
+    NULL, NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_vexiq_env(void) {
+    PyObject* module = PyModule_Create(&vexiq_env_module);
+    if (!module) return NULL;
+
+    BufferType = (PyTypeObject*)PyType_FromSpec(&buffer_spec);
+    PyObject* vecenv_type = PyType_FromSpec(&vecenv_spec);
+    if (!BufferType || !vecenv_type || PyModule_AddObject(module, "VecEnv", vecenv_type) < 0) {
+        Py_XDECREF(vecenv_type);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -81,6 +81,67 @@ enum ParseSection {
     SECTION_CYLINDERS
 };
 
+// Grow a malloc'd array to hold at least needed elements
+static bool grow_array(void** data, uint32_t* capacity, uint32_t needed, size_t elem_size) {
+    if (needed <= *capacity) return true;
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 16;
+    while (new_capacity < needed) new_capacity *= 2;
+    void* grown = realloc(*data, (size_t)new_capacity * elem_size);
+    if (!grown) return false;
+    *data = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+SceneRobot* scene_add_robot(Scene* scene) {
+    if (!grow_array((void**)&scene->robots, &scene->robot_capacity, scene->robot_count + 1, sizeof(SceneRobot))) {
+        return NULL;
+    }
+    SceneRobot* robot = &scene->robots[scene->robot_count++];
+    memset(robot, 0, sizeof(SceneRobot));
+    return robot;
+}
+
+SceneCylinder* scene_add_cylinder(Scene* scene) {
+    if (!scene_resize_cylinders(scene, scene->cylinder_count + 1)) return NULL;
+    return &scene->cylinders[scene->cylinder_count - 1];
+}
+
+bool scene_resize_cylinders(Scene* scene, uint32_t count) {
+    if (!grow_array((void**)&scene->cylinders, &scene->cylinder_capacity, count, sizeof(SceneCylinder))) {
+        return false;
+    }
+    if (count > scene->cylinder_count) {
+        memset(&scene->cylinders[scene->cylinder_count], 0, sizeof(SceneCylinder) * (count - scene->cylinder_count));
+    }
+    scene->cylinder_count = count;
+    return true;
+}
+
+bool scene_copy(Scene* dst, const Scene* src) {
+    if (dst == src) return true;
+    if (!grow_array((void**)&dst->robots, &dst->robot_capacity, src->robot_count, sizeof(SceneRobot)) ||
+        !grow_array((void**)&dst->cylinders, &dst->cylinder_capacity, src->cylinder_count, sizeof(SceneCylinder))) {
+        return false;
+    }
+    memcpy(dst->name, src->name, sizeof(dst->name));
+    dst->physics = src->physics;
+    if (src->robot_count) memcpy(dst->robots, src->robots, sizeof(SceneRobot) * src->robot_count);
+    if (src->cylinder_count) memcpy(dst->cylinders, src->cylinders, sizeof(SceneCylinder) * src->cylinder_count);
+    dst->robot_count = src->robot_count;
+    dst->cylinder_count = src->cylinder_count;
+    return true;
+}
+
+void scene_free(Scene* scene) {
+    free(scene->robots);
+    free(scene->cylinders);
+    scene->robots = NULL;
+    scene->cylinders = NULL;
+    scene->robot_count = scene->robot_capacity = 0;
+    scene->cylinder_count = scene->cylinder_capacity = 0;
+}
+
 bool scene_load(const char* path, Scene* scene) {
     FILE* file = fopen(path, "r");
     if (!file) {
@@ -168,14 +229,11 @@ bool scene_load(const char* path, Scene* scene) {
         else if (current_section == SECTION_ROBOTS) {
             // New robot list item
             if (is_list_item && strcmp(key, "mpd") == 0) {
-                if (scene->robot_count >= SCENE_MAX_ROBOTS) {
-                    fprintf(stderr, "[Scene] Warning: Max robots exceeded at line %d\n", line_num);
-                    current_robot = NULL;
+                current_robot = scene_add_robot(scene);
+                if (!current_robot) {
+                    fprintf(stderr, "[Scene] Out of memory for robots at line %d\n", line_num);
                 } else {
-                    current_robot = &scene->robots[scene->robot_count];
-                    memset(current_robot, 0, sizeof(SceneRobot));
                     strncpy(current_robot->mpd_file, value, SCENE_MAX_PATH - 1);
-                    scene->robot_count++;
                 }
             }
             // Robot properties
@@ -203,19 +261,16 @@ bool scene_load(const char* path, Scene* scene) {
         else if (current_section == SECTION_CYLINDERS) {
             // New cylinder list item
             if (is_list_item && strcmp(key, "position") == 0) {
-                if (scene->cylinder_count >= SCENE_MAX_CYLINDERS) {
-                    fprintf(stderr, "[Scene] Warning: Max cylinders exceeded at line %d\n", line_num);
-                    current_cylinder = NULL;
+                current_cylinder = scene_add_cylinder(scene);
+                if (!current_cylinder) {
+                    fprintf(stderr, "[Scene] Out of memory for cylinders at line %d\n", line_num);
                 } else {
-                    current_cylinder = &scene->cylinders[scene->cylinder_count];
-                    memset(current_cylinder, 0, sizeof(SceneCylinder));
                     current_cylinder->mass = 0.1f;  // Default mass
 
                     float pos[2] = {0, 0};
                     parse_float_array(value, pos, 2);
                     current_cylinder->x = pos[0];
                     current_cylinder->z = pos[1];
-                    scene->cylinder_count++;
                 }
             }
             // Cylinder properties
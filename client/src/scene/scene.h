@@ -27,6 +27,8 @@
  *   - Robots without iqpython are static (no motor control)
  *   - Only one robot can be "active" at a time (receives gamepad input)
  *   - Use keys 1-4 to switch active robot
+ *   - Robots and cylinders are stored in growable arrays with no count limit;
+ *     they are referred to by index (pointers move when the arrays grow)
  */
 
 #ifndef SCENE_H
@@ -39,8 +41,6 @@
 extern "C" {
 #endif
 
-#define SCENE_MAX_ROBOTS 16
-#define SCENE_MAX_CYLINDERS 32
 #define SCENE_MAX_NAME 128
 #define SCENE_MAX_PATH 256
 
@@ -63,6 +63,9 @@ typedef struct {
     // Physics state (for movable cylinders)
     float vel_x, vel_z;   // Velocity (inches/s)
     float mass;           // Mass in pounds (light plastic cup ~0.1 lbs)
+    // Sleep state (see SIM_SLEEP_SECONDS in sim/sim_world.h; zero = awake)
+    float still_time;     // Seconds at rest
+    bool asleep;          // Skips integration until something pushes it
 } SceneCylinder;
 
 // Scene-level physics parameters
@@ -75,18 +78,33 @@ typedef struct {
 // Loaded scene
 typedef struct {
     char name[SCENE_MAX_NAME];       // Scene name
-    SceneRobot robots[SCENE_MAX_ROBOTS];
+    SceneRobot* robots;              // Growable array (scene_add_robot)
     uint32_t robot_count;
-    SceneCylinder cylinders[SCENE_MAX_CYLINDERS];
+    uint32_t robot_capacity;
+    SceneCylinder* cylinders;        // Growable array (scene_add_cylinder)
     uint32_t cylinder_count;
+    uint32_t cylinder_capacity;
     ScenePhysics physics;            // Physics parameters
 } Scene;
 
 // Load scene from file
 // robots_dir: directory containing robot MPD files
-// Returns true on success
+// Returns true on success, fills scene (release with scene_free())
 bool scene_load(const char* path, Scene* scene);
 
+// Append a zeroed robot or cylinder (NULL if out of memory)
+SceneRobot* scene_add_robot(Scene* scene);
+SceneCylinder* scene_add_cylinder(Scene* scene);
+
+// Make the cylinder array hold count cylinders (new ones zeroed)
+bool scene_resize_cylinders(Scene* scene, uint32_t count);
+
+// Deep copy: dst is either zeroed or a scene it owns (its arrays are reused)
+bool scene_copy(Scene* dst, const Scene* src);
+
+// Free the robot and cylinder arrays (scene is left empty)
+void scene_free(Scene* scene);
+
 // Print scene info
 void scene_print(const Scene* scene);
 
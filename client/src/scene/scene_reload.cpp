@@ -0,0 +1,160 @@
+/*
+ * Scene Hot-Reload Implementation
+ */
+
+#include "scene_reload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// Modification time (nanoseconds where the platform has them) and size
+static bool file_stamp(const char* path, int64_t* time, int64_t* size) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attr)) return false;
+    *time = (int64_t)(((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime);
+    *size = (int64_t)(((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow);
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+#if defined(__APPLE__)
+    *time = (int64_t)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    *time = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    *size = (int64_t)st.st_size;
+#endif
+    return true;
+}
+
+bool scene_watch_init(SceneWatch* watch, const char* path) {
+    memset(watch, 0, sizeof(SceneWatch));
+    strncpy(watch->path, path, sizeof(watch->path) - 1);
+    if (!file_stamp(path, &watch->stamp_time, &watch->stamp_size)) return false;
+    watch->seen_time = watch->stamp_time;
+    watch->seen_size = watch->stamp_size;
+    return true;
+}
+
+bool scene_watch_poll(SceneWatch* watch, double now) {
+    if (now < watch->next_check) return false;
+    watch->next_check = now + SCENE_WATCH_INTERVAL;
+
+    int64_t time, size;
+    if (!file_stamp(watch->path, &time, &size)) return false;   // Mid-save (replaced by rename)
+
+    bool settled = time == watch->seen_time && size == watch->seen_size;
+    watch->seen_time = time;
+    watch->seen_size = size;
+    if (!settled || (time == watch->stamp_time && size == watch->stamp_size)) return false;
+
+    watch->stamp_time = time;
+    watch->stamp_size = size;
+    return true;
+}
+
+static bool robot_pose_equal(const SceneRobot* a, const SceneRobot* b) {
+    return a->x == b->x && a->y == b->y && a->z == b->z && a->rotation_y == b->rotation_y;
+}
+
+static bool robot_program_equal(const SceneRobot* a, const SceneRobot* b) {
+    return a->has_program == b->has_program && strcmp(a->iqpython_file, b->iqpython_file) == 0;
+}
+
+// Fields a scene file sets (not the simulated state)
+static bool cylinder_equal(const SceneCylinder* a, const SceneCylinder* b) {
+    return a->x == b->x && a->z == b->z && a->radius == b->radius && a->height == b->height &&
+           a->r == b->r && a->g == b->g && a->b == b->b && a->mass == b->mass;
+}
+
+// Grow a bool array to hold at least needed flags
+static bool grow_flags(bool** flags, uint32_t needed, uint32_t capacity) {
+    if (needed <= capacity) return true;
+    bool* grown = (bool*)realloc(*flags, needed * sizeof(bool));
+    if (!grown) return false;
+    *flags = grown;
+    return true;
+}
+
+bool scene_diff(const Scene* from, const Scene* to, SceneDiff* diff) {
+    diff->flags = 0;
+    if (!grow_flags(&diff->robot_moved, to->robot_count, diff->robot_capacity) ||
+        !grow_flags(&diff->program_changed, to->robot_count, diff->robot_capacity)) {
+        return false;
+    }
+    if (to->robot_count > diff->robot_capacity) diff->robot_capacity = to->robot_count;
+    if (!grow_flags(&diff->cylinder_changed, to->cylinder_count, diff->cylinder_capacity)) return false;
+    if (to->cylinder_count > diff->cylinder_capacity) diff->cylinder_capacity = to->cylinder_count;
+    if (to->robot_count) {
+        memset(diff->robot_moved, 0, to->robot_count * sizeof(bool));
+        memset(diff->program_changed, 0, to->robot_count * sizeof(bool));
+    }
+
+    if (strcmp(from->name, to->name) != 0) diff->flags |= SCENE_DIFF_NAME;
+    if (memcmp(&from->physics, &to->physics, sizeof(ScenePhysics)) != 0) diff->flags |= SCENE_DIFF_PHYSICS;
+
+    if (from->robot_count != to->robot_count) diff->flags |= SCENE_DIFF_ROBOTS;
+    for (uint32_t i = 0; i < to->robot_count; i++) {
+        const SceneRobot* robot = &to->robots[i];
+        if (i >= from->robot_count) {
+            diff->program_changed[i] = robot->has_program;
+            continue;
+        }
+        const SceneRobot* old = &from->robots[i];
+        if (strcmp(old->mpd_file, robot->mpd_file) != 0 || strcmp(old->config_file, robot->config_file) != 0) {
+            diff->flags |= SCENE_DIFF_ROBOTS;
+        }
+        diff->robot_moved[i] = !robot_pose_equal(old, robot);
+        diff->program_changed[i] = !robot_program_equal(old, robot);
+    }
+    for (uint32_t i = 0; i < to->robot_count; i++) {
+        if (diff->robot_moved[i]) diff->flags |= SCENE_DIFF_POSES;
+        if (diff->program_changed[i]) diff->flags |= SCENE_DIFF_PROGRAMS;
+    }
+
+    if (from->cylinder_count != to->cylinder_count) diff->flags |= SCENE_DIFF_CYLINDERS;
+    for (uint32_t c = 0; c < to->cylinder_count; c++) {
+        diff->cylinder_changed[c] = c >= from->cylinder_count || !cylinder_equal(&from->cylinders[c], &to->cylinders[c]);
+        if (diff->cylinder_changed[c]) diff->flags |= SCENE_DIFF_CYLINDERS;
+    }
+    return true;
+}
+
+void scene_diff_free(SceneDiff* diff) {
+    free(diff->robot_moved);
+    free(diff->program_changed);
+    free(diff->cylinder_changed);
+    memset(diff, 0, sizeof(SceneDiff));
+}
+
+void scene_diff_print(const SceneDiff* diff, const Scene* to) {
+    if (diff->flags == 0) {
+        printf("[Scene] No changes\n");
+        return;
+    }
+    if (diff->flags & SCENE_DIFF_PHYSICS) {
+        printf("[Scene] Physics: friction=%.2f, cylinder_friction=%.2f\n", to->physics.friction_coeff,
+               to->physics.cylinder_friction);
+    }
+    if (diff->flags & SCENE_DIFF_ROBOTS) printf("[Scene] Robots changed: %u robots reload\n", to->robot_count);
+    for (uint32_t i = 0; i < to->robot_count; i++) {
+        if (diff->robot_moved[i] && !(diff->flags & SCENE_DIFF_ROBOTS)) {
+            printf("[Scene] Robot %u moved to (%.1f, %.1f, %.1f) rot=%.1f\n", i, to->robots[i].x, to->robots[i].y,
+                   to->robots[i].z, to->robots[i].rotation_y);
+        }
+        if (diff->program_changed[i]) {
+            printf("[Scene] Robot %u program: %s\n", i, to->robots[i].has_program ? to->robots[i].iqpython_file : "none");
+        }
+    }
+    if (diff->flags & SCENE_DIFF_CYLINDERS) {
+        uint32_t edited = 0;
+        for (uint32_t c = 0; c < to->cylinder_count; c++) edited += diff->cylinder_changed[c] ? 1 : 0;
+        printf("[Scene] Cylinders: %u, %u placed again\n", to->cylinder_count, edited);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Scene Hot-Reload
+ * Watches a scene file for edits and compares two loads of it, so a running
+ * simulator applies only what changed instead of restarting.
+ *
+ * scene_watch_poll() checks the file's modification stamp (time and size)
+ * at most every SCENE_WATCH_INTERVAL seconds and reports an edit once the
+ * stamp has held still for one check, so a save still being written isn't
+ * read half way.
+ *
+ * scene_diff() sorts the changes by what they cost to apply:
+ *   - Physics parameters and cylinders: applied to the running world
+ *   - Robot poses: the robot is placed again (sim_world_apply_scene)
+ *   - Robot programs: only that robot's Python bridge restarts
+ *   - Robots added or removed, or a changed MPD or config: the robots are
+ *     reloaded, keeping every part mesh already loaded (sim_world_reload)
+ *
+ * Usage:
+ *   SceneWatch watch;
+ *   scene_watch_init(&watch, scene_path);
+ *   each frame: if (scene_watch_poll(&watch, now) && scene_load(scene_path, &edited)) {
+ *       scene_diff(&scene, &edited, &diff);   // SceneDiff diff = {}, reused across edits
+ *       ...
+ *   }
+ *   scene_diff_free(&diff);
+ */
+
+#ifndef SCENE_RELOAD_H
+#define SCENE_RELOAD_H
+
+#include "scene.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCENE_WATCH_INTERVAL 0.25   // Seconds between file checks
+
+// What a scene edit changed (SceneDiff::flags)
+#define SCENE_DIFF_PHYSICS   0x01   // Physics parameters
+#define SCENE_DIFF_CYLINDERS 0x02   // A cylinder was added, removed or edited
+#define SCENE_DIFF_POSES     0x04   // Some robot was moved
+#define SCENE_DIFF_PROGRAMS  0x08   // Some robot's iqpython program changed
+#define SCENE_DIFF_ROBOTS    0x10   // Robots added or removed, or an MPD or config changed
+#define SCENE_DIFF_NAME      0x20   // Scene name
+
+typedef struct {
+    char path[SCENE_MAX_PATH * 4];
+    int64_t stamp_time;      // Modification time of the last reported version
+    int64_t stamp_size;
+    int64_t seen_time;       // Stamp of the last check (an edit in progress)
+    int64_t seen_size;
+    double next_check;       // Wall time of the next check
+} SceneWatch;
+
+// Per-robot and per-cylinder flags are indexed like the edited scene's arrays
+// (growable; kept across scene_diff calls)
+typedef struct {
+    uint32_t flags;            // SCENE_DIFF_*
+    bool* robot_moved;         // Pose changed (same MPD and config)
+    bool* program_changed;     // Program added, removed or replaced
+    uint32_t robot_capacity;
+    bool* cylinder_changed;    // Edited (below both counts) or added
+    uint32_t cylinder_capacity;
+} SceneDiff;
+
+// Start watching path (its current version counts as seen)
+// Returns false if the file can't be read
+bool scene_watch_init(SceneWatch* watch, const char* path);
+
+// True once per edit, when a changed file has held still for a check
+// now: wall time in seconds
+bool scene_watch_poll(SceneWatch* watch, double now);
+
+// Compare scene loads; robots and cylinders are matched by index
+// diff: zeroed or from an earlier scene_diff (release with scene_diff_free())
+// Returns false if out of memory
+bool scene_diff(const Scene* from, const Scene* to, SceneDiff* diff);
+
+void scene_diff_free(SceneDiff* diff);
+
+// Print the changes of diff ("[Scene] ..." lines)
+void scene_diff_print(const SceneDiff* diff, const Scene* to);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCENE_RELOAD_H
@@ -0,0 +1,113 @@
+/*
+ * Arena Implementation
+ */
+
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Chunk header; the chunk's bytes follow it
+struct ArenaChunk {
+    ArenaChunk* next;        // Earlier chunk of this cycle
+    size_t size;
+    size_t offset;           // Next free byte
+};
+
+#define ARENA_HEADER_SIZE ((sizeof(ArenaChunk) + ARENA_DEFAULT_ALIGN - 1) & ~(size_t)(ARENA_DEFAULT_ALIGN - 1))
+
+static unsigned char* chunk_data(ArenaChunk* chunk) {
+    return (unsigned char*)chunk + ARENA_HEADER_SIZE;
+}
+
+static ArenaChunk* chunk_create(Arena* arena, size_t size, ArenaChunk* next) {
+    ArenaChunk* chunk = (ArenaChunk*)malloc(ARENA_HEADER_SIZE + size);
+    if (!chunk) {
+        fprintf(stderr, "[Arena] %s: out of memory (%zu bytes)\n", arena->name, size);
+        return NULL;
+    }
+    chunk->next = next;
+    chunk->size = size;
+    chunk->offset = 0;
+    arena->capacity += size;
+    arena->chunk_allocs++;
+    return chunk;
+}
+
+static void free_chunks(ArenaChunk* chunk) {
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+void arena_init(Arena* arena, const char* name, size_t chunk_size) {
+    arena->name = name;
+    arena->chunk = NULL;
+    arena->chunk_size = chunk_size > 0 ? chunk_size : 64 * 1024;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->capacity = 0;
+    arena->chunk_allocs = 0;
+}
+
+void arena_destroy(Arena* arena) {
+    free_chunks(arena->chunk);
+    arena->chunk = NULL;
+    arena->used = 0;
+    arena->capacity = 0;
+}
+
+void* arena_alloc(Arena* arena, size_t size, size_t align) {
+    ArenaChunk* chunk = arena->chunk;
+    size_t start = 0;
+    if (chunk) start = (chunk->offset + align - 1) & ~(align - 1);
+
+    if (!chunk || start + size > chunk->size) {
+        // New chunk: at least chunk_size, and big enough for oversized requests
+        size_t chunk_size = arena->chunk_size;
+        if (size + align > chunk_size) chunk_size = size + align;
+        chunk = chunk_create(arena, chunk_size, arena->chunk);
+        if (!chunk) return NULL;
+        arena->chunk = chunk;
+        start = (align - ((uintptr_t)chunk_data(chunk) & (align - 1))) & (align - 1);
+    }
+
+    arena->used += start - chunk->offset + size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    chunk->offset = start + size;
+    return chunk_data(chunk) + start;
+}
+
+char* arena_strdup(Arena* arena, const char* str) {
+    size_t length = strlen(str) + 1;
+    char* copy = (char*)arena_alloc(arena, length, 1);
+    if (copy) memcpy(copy, str, length);
+    return copy;
+}
+
+void arena_reset(Arena* arena) {
+    ArenaChunk* chunk = arena->chunk;
+    if (!chunk) return;
+
+    if (chunk->next) {
+        // This cycle overflowed: one chunk that holds all of it from now on
+        size_t total = arena->capacity;
+        free_chunks(chunk);
+        arena->capacity = 0;
+        arena->chunk = chunk_create(arena, total, NULL);
+    } else {
+#ifdef VEXIQ_PROFILE
+        memset(chunk_data(chunk), ARENA_POISON, chunk->offset);
+#endif
+        chunk->offset = 0;
+    }
+    arena->used = 0;
+}
+
+void arena_report(const Arena* arena) {
+    printf("[Arena] %s: peak %.1f KB of %.1f KB (%llu chunk allocations)\n", arena->name,
+           (double)arena->peak / 1024.0, (double)arena->capacity / 1024.0,
+           (unsigned long long)arena->chunk_allocs);
+}
@@ -0,0 +1,99 @@
+/*
+ * Arena
+ * Linear (bump) allocator for memory that dies all at once: per-frame
+ * render batches and load-time scratch.
+ *
+ * arena_alloc() bumps an offset in the current chunk; when a chunk runs out
+ * another one is malloc'd. Nothing is freed individually: arena_reset()
+ * releases everything at once, and if the last cycle needed more than one
+ * chunk it replaces them with a single chunk of their total size, so after
+ * the first few frames a frame arena never touches the heap again.
+ *
+ * The arena tracks its high-water mark (peak bytes used between resets).
+ * In profiling builds (VEXIQ_PROFILE) arena_reset() also fills the released
+ * memory with ARENA_POISON, so a pointer kept past its frame reads garbage
+ * instead of last frame's data.
+ *
+ * Arenas are not thread-safe; each belongs to one thread.
+ *
+ *   Arena frame;
+ *   arena_init(&frame, "frame", 256 * 1024);
+ *   each frame: ArenaVector<float> v{ArenaAllocator<float>(&frame)}; ... arena_reset(&frame);
+ *   arena_destroy(&frame);
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+#define ARENA_DEFAULT_ALIGN 16
+#define ARENA_POISON 0xCD
+
+struct ArenaChunk;
+
+typedef struct Arena {
+    const char* name;        // For reports (string must outlive the arena)
+    ArenaChunk* chunk;       // Current chunk; earlier chunks of this cycle follow it
+    size_t chunk_size;       // Minimum size of a new chunk
+    size_t used;             // Bytes handed out since the last reset (with padding)
+    size_t peak;             // High-water mark of used
+    size_t capacity;         // Bytes in all chunks
+    uint64_t chunk_allocs;   // Chunks malloc'd since arena_init()
+} Arena;
+
+// Start an empty arena; the first chunk is allocated on first use
+void arena_init(Arena* arena, const char* name, size_t chunk_size);
+
+// Free every chunk
+void arena_destroy(Arena* arena);
+
+// size bytes aligned to align (a power of two); never NULL unless out of memory
+void* arena_alloc(Arena* arena, size_t size, size_t align = ARENA_DEFAULT_ALIGN);
+
+// Copy of a string (NUL-terminated)
+char* arena_strdup(Arena* arena, const char* str);
+
+// Release everything allocated since the last reset (one chunk is kept)
+void arena_reset(Arena* arena);
+
+// Print the arena's peak and capacity ("[Arena] frame: ...")
+void arena_report(const Arena* arena);
+
+template <typename T>
+T* arena_alloc_array(Arena* arena, size_t count) {
+    return (T*)arena_alloc(arena, count * sizeof(T), alignof(T) > ARENA_DEFAULT_ALIGN ? alignof(T) : ARENA_DEFAULT_ALIGN);
+}
+
+// Standard allocator drawing from an arena. deallocate() does nothing, so a
+// container that grows leaves its old buffers behind until the reset;
+// reserve() up front where the size is known. Assigning a container moves
+// its arena along; a default-constructed one must be assigned before use.
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    Arena* arena;
+
+    ArenaAllocator() : arena(nullptr) {}
+    explicit ArenaAllocator(Arena* a) : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return arena_alloc_array<T>(arena, count); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // ARENA_H
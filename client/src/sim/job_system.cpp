@@ -0,0 +1,176 @@
+/*
+ * Job System Implementation
+ */
+
+#include "job_system.h"
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Chunks [lo, hi) left in one thread's deque, packed as lo | hi << 32 so the
+// owner (takes lo) and thieves (take hi - 1) can both claim with one CAS.
+// Padded to a cache line so owners don't contend on their neighbours.
+struct alignas(64) JobDeque {
+    std::atomic<uint64_t> range;
+};
+
+struct JobSystem {
+    int thread_count;
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    uint64_t generation = 0;      // Bumped for every batch
+    bool batch_open = false;      // Workers may still join the current batch
+    bool quit = false;
+
+    // Current batch (fixed while any thread is inside it)
+    JobRangeFn fn = NULL;
+    void* user_data = NULL;
+    int count = 0;
+    int grain = 1;
+    JobDeque deques[JOB_SYSTEM_MAX_THREADS];
+    std::atomic<int> remaining{0};  // Chunks not finished yet
+    std::atomic<int> active{0};     // Workers inside the batch
+};
+
+static uint64_t pack_range(uint32_t lo, uint32_t hi) {
+    return (uint64_t)lo | ((uint64_t)hi << 32);
+}
+
+// Claim the first chunk of a deque (owner side)
+static bool pop_front(JobDeque* deque, int* chunk) {
+    uint64_t range = deque->range.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t lo = (uint32_t)range, hi = (uint32_t)(range >> 32);
+        if (lo >= hi) return false;
+        if (deque->range.compare_exchange_weak(range, pack_range(lo + 1, hi), std::memory_order_acq_rel)) {
+            *chunk = (int)lo;
+            return true;
+        }
+    }
+}
+
+// Claim the last chunk of a deque (thief side)
+static bool pop_back(JobDeque* deque, int* chunk) {
+    uint64_t range = deque->range.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t lo = (uint32_t)range, hi = (uint32_t)(range >> 32);
+        if (lo >= hi) return false;
+        if (deque->range.compare_exchange_weak(range, pack_range(lo, hi - 1), std::memory_order_acq_rel)) {
+            *chunk = (int)(hi - 1);
+            return true;
+        }
+    }
+}
+
+// Run chunks until every deque is empty (others may still be finishing theirs)
+static void run_batch(JobSystem* jobs, int thread) {
+    int chunk;
+    for (;;) {
+        if (!pop_front(&jobs->deques[thread], &chunk)) {
+            bool stole = false;
+            for (int k = 1; k < jobs->thread_count && !stole; k++) {
+                stole = pop_back(&jobs->deques[(thread + k) % jobs->thread_count], &chunk);
+            }
+            if (!stole) return;
+        }
+
+        int begin = chunk * jobs->grain;
+        int end = begin + jobs->grain < jobs->count ? begin + jobs->grain : jobs->count;
+        jobs->fn(jobs->user_data, begin, end, thread);
+        jobs->remaining.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+static void worker_main(JobSystem* jobs, int thread) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(jobs->lock);
+            jobs->wake.wait(lock, [&] { return jobs->quit || (jobs->batch_open && jobs->generation != seen); });
+            if (jobs->quit) return;
+            seen = jobs->generation;
+            jobs->active.fetch_add(1, std::memory_order_relaxed);
+        }
+        run_batch(jobs, thread);
+        jobs->active.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+int job_system_default_threads(void) {
+    int n = (int)std::thread::hardware_concurrency();
+    if (n < 1) n = 1;
+    if (n > JOB_SYSTEM_MAX_THREADS) n = JOB_SYSTEM_MAX_THREADS;
+    return n;
+}
+
+JobSystem* job_system_create(int thread_count) {
+    if (thread_count <= 0) thread_count = job_system_default_threads();
+    if (thread_count > JOB_SYSTEM_MAX_THREADS) thread_count = JOB_SYSTEM_MAX_THREADS;
+
+    JobSystem* jobs = new JobSystem();
+    jobs->thread_count = thread_count;
+    for (int t = 0; t < JOB_SYSTEM_MAX_THREADS; t++) jobs->deques[t].range.store(0, std::memory_order_relaxed);
+
+    jobs->workers.reserve(thread_count - 1);
+    for (int t = 1; t < thread_count; t++) jobs->workers.emplace_back(worker_main, jobs, t);
+    return jobs;
+}
+
+void job_system_destroy(JobSystem* jobs) {
+    if (!jobs) return;
+    {
+        std::lock_guard<std::mutex> lock(jobs->lock);
+        jobs->quit = true;
+    }
+    jobs->wake.notify_all();
+    for (std::thread& t : jobs->workers) t.join();
+    delete jobs;
+}
+
+int job_system_thread_count(const JobSystem* jobs) {
+    return jobs ? jobs->thread_count : 1;
+}
+
+void job_system_parallel_for(JobSystem* jobs, int count, int grain, JobRangeFn fn, void* user_data) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    if (!jobs || jobs->thread_count == 1 || count <= grain) {
+        fn(user_data, 0, count, 0);
+        return;
+    }
+
+    // Deal chunks out in contiguous blocks, one block per thread
+    int chunks = (count + grain - 1) / grain;
+    int threads = jobs->thread_count;
+    {
+        std::lock_guard<std::mutex> lock(jobs->lock);
+        jobs->fn = fn;
+        jobs->user_data = user_data;
+        jobs->count = count;
+        jobs->grain = grain;
+        for (int t = 0; t < threads; t++) {
+            uint32_t lo = (uint32_t)((int64_t)chunks * t / threads);
+            uint32_t hi = (uint32_t)((int64_t)chunks * (t + 1) / threads);
+            jobs->deques[t].range.store(pack_range(lo, hi), std::memory_order_relaxed);
+        }
+        jobs->remaining.store(chunks, std::memory_order_relaxed);
+        jobs->generation++;
+        jobs->batch_open = true;
+    }
+    jobs->wake.notify_all();
+
+    run_batch(jobs, 0);
+    while (jobs->remaining.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+
+    // Barrier: no worker may still be scanning deques when the next batch deals them
+    {
+        std::lock_guard<std::mutex> lock(jobs->lock);
+        jobs->batch_open = false;
+    }
+    while (jobs->active.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+}
@@ -0,0 +1,50 @@
+/*
+ * Job System
+ * Persistent work-stealing thread pool for the per-step physics phases.
+ *
+ * job_system_parallel_for() splits [0, count) into chunks of grain items,
+ * deals them out to per-thread deques in contiguous blocks and runs them on
+ * the pool, the calling thread included. A thread that empties its deque
+ * steals single chunks from the far end of the others', so uneven jobs
+ * (robots near walls, robots in contact) balance out. The call returns once
+ * every chunk has finished, acting as the barrier between phases.
+ *
+ * Jobs of one call must be independent (write disjoint data); then results
+ * do not depend on the thread count or on which thread ran which chunk.
+ * Scratch buffers are indexed by the thread argument, which is always in
+ * [0, job_system_thread_count()).
+ *
+ * Usage:
+ *   JobSystem* jobs = job_system_create(0);              // 0 = hardware threads
+ *   job_system_parallel_for(jobs, robot_count, 1, integrate_job, world);
+ *   job_system_destroy(jobs);
+ */
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#define JOB_SYSTEM_MAX_THREADS 16
+
+struct JobSystem;
+
+// Run items [begin, end) on thread (0 = the caller of job_system_parallel_for)
+typedef void (*JobRangeFn)(void* user_data, int begin, int end, int thread);
+
+// Hardware threads, clamped to JOB_SYSTEM_MAX_THREADS
+int job_system_default_threads(void);
+
+// Start thread_count - 1 workers (<= 0 = job_system_default_threads())
+// With one thread every job runs inline on the caller, in index order.
+JobSystem* job_system_create(int thread_count);
+
+// Join the workers and free the pool (NULL is ignored)
+void job_system_destroy(JobSystem* jobs);
+
+// Threads taking part in a parallel_for, the caller included (1 for NULL)
+int job_system_thread_count(const JobSystem* jobs);
+
+// Run fn over [0, count) in chunks of grain items and wait for all of them
+// jobs may be NULL; count <= grain runs inline as one chunk.
+void job_system_parallel_for(JobSystem* jobs, int count, int grain, JobRangeFn fn, void* user_data);
+
+#endif // JOB_SYSTEM_H
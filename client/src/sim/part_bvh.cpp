@@ -0,0 +1,346 @@
+/*
+ * Part Bounding Volume Hierarchy Implementation
+ */
+
+#include "part_bvh.h"
+#include "sim_world.h"
+#include <algorithm>
+#include <cfloat>  // FLT_MAX
+
+// Robot-local AABB of a part's local OBB
+static void part_local_aabb(const PartCollision& part, AABB* out) {
+    obb_get_enclosing_aabb(&part.local_obb, out);
+}
+
+static float aabb_axis(const AABB* aabb, int axis, bool max) {
+    const Vec3& v = max ? aabb->max : aabb->min;
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// Recursively build a node over items[first .. first + count)
+static int build_node(PartBvh* bvh, const std::vector<PartCollision>& parts, int first, int count) {
+    int node_idx = (int)bvh->nodes.size();
+    bvh->nodes.push_back(PartBvhNode());
+
+    // Node bounds and centroid bounds
+    AABB bounds, centroids;
+    bounds.min = centroids.min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+    bounds.max = centroids.max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = first; i < first + count; i++) {
+        AABB part_aabb;
+        part_local_aabb(parts[bvh->items[i]], &part_aabb);
+        bounds.min.x = fminf(bounds.min.x, part_aabb.min.x);
+        bounds.min.y = fminf(bounds.min.y, part_aabb.min.y);
+        bounds.min.z = fminf(bounds.min.z, part_aabb.min.z);
+        bounds.max.x = fmaxf(bounds.max.x, part_aabb.max.x);
+        bounds.max.y = fmaxf(bounds.max.y, part_aabb.max.y);
+        bounds.max.z = fmaxf(bounds.max.z, part_aabb.max.z);
+
+        Vec3 c = parts[bvh->items[i]].local_obb.center;
+        centroids.min.x = fminf(centroids.min.x, c.x);
+        centroids.min.y = fminf(centroids.min.y, c.y);
+        centroids.min.z = fminf(centroids.min.z, c.z);
+        centroids.max.x = fmaxf(centroids.max.x, c.x);
+        centroids.max.y = fmaxf(centroids.max.y, c.y);
+        centroids.max.z = fmaxf(centroids.max.z, c.z);
+    }
+
+    {
+        PartBvhNode& node = bvh->nodes[node_idx];
+        node.bounds = bounds;
+        node.left = node.right = -1;
+        node.first = first;
+        node.count = count;
+        node.batch = -1;
+        node.obb_version = 0;
+    }
+    if (count <= PART_BVH_LEAF_SIZE) {
+        bvh->nodes[node_idx].batch = (int)bvh->leaf_batches.size();
+        bvh->leaf_batches.push_back(ObbBatch());
+        bvh->leaf_batch_version.push_back(0);
+        return node_idx;
+    }
+
+    // Median split along the longest centroid axis
+    int axis = 0;
+    float best = -1.0f;
+    for (int a = 0; a < 3; a++) {
+        float extent = aabb_axis(&centroids, a, true) - aabb_axis(&centroids, a, false);
+        if (extent > best) { best = extent; axis = a; }
+    }
+    int mid = first + count / 2;
+    std::nth_element(bvh->items.begin() + first, bvh->items.begin() + mid,
+                     bvh->items.begin() + first + count,
+                     [&parts, axis](uint32_t a, uint32_t b) {
+                         const Vec3& ca = parts[a].local_obb.center;
+                         const Vec3& cb = parts[b].local_obb.center;
+                         float va = axis == 0 ? ca.x : (axis == 1 ? ca.y : ca.z);
+                         float vb = axis == 0 ? cb.x : (axis == 1 ? cb.y : cb.z);
+                         if (va != vb) return va < vb;
+                         return a < b;  // Deterministic for coincident parts
+                     });
+
+    int left = build_node(bvh, parts, first, mid - first);
+    int right = build_node(bvh, parts, mid, first + count - mid);
+
+    // nodes may have been reallocated during recursion
+    PartBvhNode& node = bvh->nodes[node_idx];
+    node.left = left;
+    node.right = right;
+    node.count = 0;
+    return node_idx;
+}
+
+int part_bvh_build(PartBvh* bvh, const std::vector<PartCollision>& parts, size_t first, int count) {
+    // Gather valid parts of this range
+    int item_start = (int)bvh->items.size();
+    for (int i = 0; i < count; i++) {
+        size_t idx = first + i;
+        if (idx >= parts.size()) break;
+        bvh->items.push_back((uint32_t)idx);
+    }
+    int item_count = (int)bvh->items.size() - item_start;
+    if (item_count == 0) return -1;
+
+    return build_node(bvh, parts, item_start, item_count);
+}
+
+// Bounds of node_idx and everything below it, children first
+static void refit_node(PartBvh* bvh, const std::vector<PartCollision>& parts, int node_idx) {
+    PartBvhNode* node = &bvh->nodes[node_idx];
+    AABB bounds;
+    if (node->left < 0) {
+        bounds.min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        bounds.max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (int i = node->first; i < node->first + node->count; i++) {
+            AABB part_aabb;
+            part_local_aabb(parts[bvh->items[i]], &part_aabb);
+            bounds.min.x = fminf(bounds.min.x, part_aabb.min.x);
+            bounds.min.y = fminf(bounds.min.y, part_aabb.min.y);
+            bounds.min.z = fminf(bounds.min.z, part_aabb.min.z);
+            bounds.max.x = fmaxf(bounds.max.x, part_aabb.max.x);
+            bounds.max.y = fmaxf(bounds.max.y, part_aabb.max.y);
+            bounds.max.z = fmaxf(bounds.max.z, part_aabb.max.z);
+        }
+        bvh->leaf_batch_version[node->batch] = 0;
+    } else {
+        refit_node(bvh, parts, node->left);
+        refit_node(bvh, parts, node->right);
+        const AABB& left = bvh->nodes[node->left].bounds;
+        const AABB& right = bvh->nodes[node->right].bounds;
+        bounds.min = vec3(fminf(left.min.x, right.min.x), fminf(left.min.y, right.min.y), fminf(left.min.z, right.min.z));
+        bounds.max = vec3(fmaxf(left.max.x, right.max.x), fmaxf(left.max.y, right.max.y), fmaxf(left.max.z, right.max.z));
+    }
+    node->bounds = bounds;
+    node->obb_version = 0;
+}
+
+void part_bvh_refit(PartBvh* bvh, const std::vector<PartCollision>& parts, int root) {
+    if (root < 0) return;
+    refit_node(bvh, parts, root);
+}
+
+void part_bvh_clear(PartBvh* bvh) {
+    bvh->nodes.clear();
+    bvh->items.clear();
+    bvh->leaf_batches.clear();
+    bvh->leaf_batch_version.clear();
+}
+
+// World-space OBB of a node, rebuilt when the robot pose changed
+static const OBB* node_world_obb(PartBvhNode* node, RobotInstance* robot) {
+    uint32_t version = sim_robot_update_transform(robot);
+    if (node->obb_version != version) {
+        OBB local_obb;
+        obb_from_bounds(&local_obb, node->bounds.min, node->bounds.max);
+        Vec3 pos = vec3(robot->pose_x, robot->pose_y, robot->pose_z);
+        obb_transform_matrix(&local_obb, pos, robot->world_rotation, &node->world_obb);
+        node->obb_version = version;
+    }
+    return &node->world_obb;
+}
+
+static bool is_leaf(const PartBvhNode* node) {
+    return node->left < 0;
+}
+
+// World OBBs of a leaf's parts in SoA form, refreshed when the robot pose changed
+static const ObbBatch* leaf_world_batch(PartBvh* bvh, std::vector<PartCollision>& parts,
+                                        const PartBvhNode* node, RobotInstance* robot) {
+    uint32_t version = sim_robot_update_transform(robot);
+    ObbBatch* batch = &bvh->leaf_batches[node->batch];
+    if (bvh->leaf_batch_version[node->batch] != version) {
+        obb_batch_clear(batch);
+        for (int i = node->first; i < node->first + node->count; i++) {
+            obb_batch_add(batch, sim_part_world_obb(robot, &parts[bvh->items[i]]));
+        }
+        bvh->leaf_batch_version[node->batch] = version;
+    }
+    return batch;
+}
+
+// Query shapes for single-tree descent
+struct BvhShape {
+    const AABB* aabb;      // Non-NULL for AABB queries
+    float x, z, radius;    // Circle query otherwise
+};
+
+static bool shape_hits(const BvhShape* shape, const OBB* obb) {
+    if (shape->aabb) return obb_intersects_aabb(obb, shape->aabb);
+    return obb_intersects_circle(obb, shape->x, shape->z, shape->radius);
+}
+
+static unsigned int shape_hits_batch(const BvhShape* shape, const ObbBatch* batch) {
+    if (shape->aabb) return obb_batch_intersects_aabb(batch, shape->aabb);
+    return obb_intersects_circle_batch(batch, shape->x, shape->z, shape->radius);
+}
+
+static void query_shape(PartBvh* bvh, std::vector<PartCollision>& parts, RobotInstance* robot,
+                        int node_idx, const BvhShape* shape, PartBvhHits* out) {
+    PartBvhNode* node = &bvh->nodes[node_idx];
+    if (!shape_hits(shape, node_world_obb(node, robot))) return;
+
+    if (is_leaf(node)) {
+        unsigned int mask = shape_hits_batch(shape, leaf_world_batch(bvh, parts, node, robot));
+        out->part_tests += (uint32_t)node->count;
+        for (int i = 0; i < node->count; i++) {
+            if (mask & (1u << i)) out->parts.push_back(bvh->items[node->first + i]);
+        }
+        return;
+    }
+
+    int left = node->left, right = node->right;
+    query_shape(bvh, parts, robot, left, shape, out);
+    query_shape(bvh, parts, robot, right, shape, out);
+}
+
+int part_bvh_query_aabb(PartBvh* bvh, std::vector<PartCollision>& parts,
+                        RobotInstance* robot, int root, const AABB* aabb, PartBvhHits* out) {
+    out->parts.clear();
+    if (root < 0) return 0;
+
+    BvhShape shape = {aabb, 0.0f, 0.0f, 0.0f};
+    query_shape(bvh, parts, robot, root, &shape, out);
+    std::sort(out->parts.begin(), out->parts.end());
+    return (int)out->parts.size();
+}
+
+int part_bvh_query_circle(PartBvh* bvh, std::vector<PartCollision>& parts,
+                          RobotInstance* robot, int root, float x, float z, float radius,
+                          PartBvhHits* out) {
+    out->parts.clear();
+    if (root < 0) return 0;
+
+    BvhShape shape = {nullptr, x, z, radius};
+    query_shape(bvh, parts, robot, root, &shape, out);
+    std::sort(out->parts.begin(), out->parts.end());
+    return (int)out->parts.size();
+}
+
+// Node volume, used to pick which side of a pair to descend
+static float node_volume(const PartBvhNode* node) {
+    return (node->bounds.max.x - node->bounds.min.x) *
+           (node->bounds.max.y - node->bounds.min.y) *
+           (node->bounds.max.z - node->bounds.min.z);
+}
+
+static void query_pairs(PartBvh* bvh, std::vector<PartCollision>& parts,
+                        RobotInstance* robot_a, int idx_a, RobotInstance* robot_b, int idx_b,
+                        PartBvhHits* out) {
+    PartBvhNode* node_a = &bvh->nodes[idx_a];
+    PartBvhNode* node_b = &bvh->nodes[idx_b];
+    if (!obb_intersects_obb(node_world_obb(node_a, robot_a), node_world_obb(node_b, robot_b))) return;
+
+    if (is_leaf(node_a) && is_leaf(node_b)) {
+        // Each part of leaf a against all of leaf b in one batch test
+        const ObbBatch* batch_b = leaf_world_batch(bvh, parts, node_b, robot_b);
+        out->part_tests += (uint32_t)(node_a->count * node_b->count);
+        for (int i = node_a->first; i < node_a->first + node_a->count; i++) {
+            uint32_t part_a = bvh->items[i];
+            unsigned int mask = obb_intersects_obb_batch(sim_part_world_obb(robot_a, &parts[part_a]), batch_b);
+            for (int j = 0; j < node_b->count; j++) {
+                if (!(mask & (1u << j))) continue;
+                PartBvhPair pair = {part_a, bvh->items[node_b->first + j]};
+                out->pairs.push_back(pair);
+            }
+        }
+        return;
+    }
+
+    // Descend the larger node (or the only inner one)
+    bool descend_a = is_leaf(node_b) || (!is_leaf(node_a) && node_volume(node_a) >= node_volume(node_b));
+    if (descend_a) {
+        int left = node_a->left, right = node_a->right;
+        query_pairs(bvh, parts, robot_a, left, robot_b, idx_b, out);
+        query_pairs(bvh, parts, robot_a, right, robot_b, idx_b, out);
+    } else {
+        int left = node_b->left, right = node_b->right;
+        query_pairs(bvh, parts, robot_a, idx_a, robot_b, left, out);
+        query_pairs(bvh, parts, robot_a, idx_a, robot_b, right, out);
+    }
+}
+
+int part_bvh_query_pairs(PartBvh* bvh, std::vector<PartCollision>& parts,
+                         RobotInstance* robot_a, int root_a,
+                         RobotInstance* robot_b, int root_b, PartBvhHits* out) {
+    out->pairs.clear();
+    if (root_a < 0 || root_b < 0) return 0;
+
+    query_pairs(bvh, parts, robot_a, root_a, robot_b, root_b, out);
+    std::sort(out->pairs.begin(), out->pairs.end(),
+              [](const PartBvhPair& x, const PartBvhPair& y) {
+                  return x.a != y.a ? x.a < y.a : x.b < y.b;
+              });
+    return (int)out->pairs.size();
+}
+
+int part_bvh_raycast(const PartBvh* bvh, const std::vector<PartCollision>& parts, int root,
+                     Vec3 origin, Vec3 dir, float radius, float max_distance,
+                     float* distance, uint32_t* part_tests) {
+    int best_part = -1;
+    float best = max_distance;
+    if (root < 0) return -1;
+    float node_radius = radius * RAY_BOUNDS_GROWTH;
+
+    // Depth-first, nearer child first; nodes entered beyond the best hit are skipped
+    struct Entry { int node; float t; };
+    Entry stack[64];
+    int top = 0;
+    float t_root = aabb_raycast(&bvh->nodes[root].bounds, origin, dir, node_radius, best);
+    if (t_root < 0.0f) return -1;
+    stack[top++] = {root, t_root};
+
+    while (top > 0) {
+        Entry entry = stack[--top];
+        if (entry.t > best) continue;
+        const PartBvhNode* node = &bvh->nodes[entry.node];
+
+        if (is_leaf(node)) {
+            *part_tests += (uint32_t)node->count;
+            for (int i = node->first; i < node->first + node->count; i++) {
+                uint32_t part = bvh->items[i];
+                float t = obb_raycast(&parts[part].local_obb, origin, dir, radius, best);
+                if (t >= 0.0f && (t < best || best_part < 0)) {
+                    best = t;
+                    best_part = (int)part;
+                }
+            }
+            continue;
+        }
+
+        float t_left = aabb_raycast(&bvh->nodes[node->left].bounds, origin, dir, node_radius, best);
+        float t_right = aabb_raycast(&bvh->nodes[node->right].bounds, origin, dir, node_radius, best);
+        if (top + 2 > 64) continue;  // Deeper than any tree we build
+        // Push the farther child first so the nearer one is popped next
+        if (t_left >= 0.0f && t_right >= 0.0f && t_left < t_right) {
+            stack[top++] = {node->right, t_right};
+            stack[top++] = {node->left, t_left};
+        } else {
+            if (t_left >= 0.0f) stack[top++] = {node->left, t_left};
+            if (t_right >= 0.0f) stack[top++] = {node->right, t_right};
+        }
+    }
+
+    if (best_part >= 0) *distance = best;
+    return best_part;
+}
@@ -0,0 +1,102 @@
+/*
+ * Part Bounding Volume Hierarchy
+ * Per-submodel trees over part OBBs for the collision narrow phase.
+ *
+ * Built once at load time from each part's robot-local OBB. When a submodel
+ * joint moves its parts, part_bvh_refit recomputes the bounds of that tree
+ * only (the topology is kept). Node bounds are
+ * axis-aligned in robot-local space, so in world space every node is an OBB
+ * with the robot's Y rotation (cached per robot pose, like part OBBs).
+ *
+ * Leaves keep their parts' world OBBs in an ObbBatch so leaf tests run
+ * through the SIMD batch kernels in physics/obb.
+ *
+ * Queries descend the tree(s) and return the parts whose world OBB actually
+ * intersects, sorted by part index, in a caller-owned PartBvhHits:
+ *   int n = part_bvh_query_aabb(&bvh, parts.collision, robot, robot->submodel_bvh_root[sm], &wall, &hits);
+ *   for (int i = 0; i < n; i++) { PartCollision& part = parts.collision[hits.parts[i]]; ... }
+ *
+ * Queries only write caches of the robot they visit, so queries on different
+ * robots may run concurrently, each with its own PartBvhHits. Raycasts work
+ * in robot-local space and write nothing.
+ */
+
+#ifndef PART_BVH_H
+#define PART_BVH_H
+
+#include "../physics/obb.h"
+#include <stdint.h>
+#include <vector>
+
+struct RobotInstance;
+struct PartCollision;
+
+// Maximum parts per leaf (one SSE/NEON batch)
+#define PART_BVH_LEAF_SIZE 4
+static_assert(PART_BVH_LEAF_SIZE <= OBB_BATCH_MAX, "leaf must fit in one ObbBatch");
+
+struct PartBvhNode {
+    AABB bounds;          // Robot-local bounds of all parts below this node
+    int left, right;      // Child node indices (-1 for leaves)
+    int first, count;     // Leaf items: PartBvh::items[first..first+count)
+    int batch;            // Leaf world OBBs: PartBvh::leaf_batches[batch] (-1 for inner nodes)
+
+    OBB world_obb;        // Cached world-space bounds
+    uint32_t obb_version; // Robot pose_version of world_obb (0 = stale)
+};
+
+// Part pair from a tree-vs-tree query (global part indices)
+struct PartBvhPair {
+    uint32_t a, b;
+};
+
+// All trees of a world share one node/item pool
+struct PartBvh {
+    std::vector<PartBvhNode> nodes;
+    std::vector<uint32_t> items;          // Global part indices, grouped by leaf
+    std::vector<ObbBatch> leaf_batches;   // World OBBs of each leaf's parts (SoA)
+    std::vector<uint32_t> leaf_batch_version;  // Robot pose_version of each batch (0 = stale)
+};
+
+// Query results (reused between queries; one per concurrently querying thread)
+struct PartBvhHits {
+    std::vector<uint32_t> parts;       // part_bvh_query_aabb / part_bvh_query_circle
+    std::vector<PartBvhPair> pairs;    // part_bvh_query_pairs
+    uint32_t part_tests = 0;           // Part OBB tests run by queries (accumulates; the caller resets it)
+};
+
+// Build a tree over parts[first .. first + count)
+// Returns the root node index, or -1 if count is 0
+int part_bvh_build(PartBvh* bvh, const std::vector<PartCollision>& parts, size_t first, int count);
+
+// Release all trees
+void part_bvh_clear(PartBvh* bvh);
+
+// Recompute the bounds of the tree at root from its parts' local OBBs and
+// mark its cached world bounds stale (after the parts moved within the robot)
+void part_bvh_refit(PartBvh* bvh, const std::vector<PartCollision>& parts, int root);
+
+// Parts of one tree intersecting a world-space AABB / XZ circle
+// Results in out->parts, returns hit count
+int part_bvh_query_aabb(PartBvh* bvh, std::vector<PartCollision>& parts,
+                        RobotInstance* robot, int root, const AABB* aabb, PartBvhHits* out);
+int part_bvh_query_circle(PartBvh* bvh, std::vector<PartCollision>& parts,
+                          RobotInstance* robot, int root, float x, float z, float radius,
+                          PartBvhHits* out);
+
+// Nearest part of one tree hit by a ray given in robot-local space (origin,
+// unit dir), part OBBs grown by radius (nodes by RAY_BOUNDS_GROWTH times
+// that), within max_distance. Read-only, so
+// any number of threads may cast into the same trees. Returns the global part
+// index (-1 = no hit) and its distance in *distance; counts part tests in *part_tests.
+int part_bvh_raycast(const PartBvh* bvh, const std::vector<PartCollision>& parts, int root,
+                     Vec3 origin, Vec3 dir, float radius, float max_distance,
+                     float* distance, uint32_t* part_tests);
+
+// Intersecting part pairs between two trees (a from robot_a, b from robot_b)
+// Results in out->pairs, returns pair count
+int part_bvh_query_pairs(PartBvh* bvh, std::vector<PartCollision>& parts,
+                         RobotInstance* robot_a, int root_a,
+                         RobotInstance* robot_b, int root_b, PartBvhHits* out);
+
+#endif // PART_BVH_H
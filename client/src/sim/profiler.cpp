@@ -0,0 +1,194 @@
+/*
+ * Profiler Implementation
+ */
+
+#include "profiler.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+// One finished zone in a trace
+struct ProfilerEvent {
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    int zone;
+};
+
+// Trace buffer of one thread (appended only by that thread)
+struct ProfilerThread {
+    int tid;
+    char name[32];
+    std::vector<ProfilerEvent> events;
+    uint64_t dropped;
+};
+
+struct ProfilerZone {
+    const char* name;
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint32_t> calls{0};
+};
+
+static std::mutex g_lock;   // Guards registration and the thread list
+static ProfilerZone g_zones[PROFILER_MAX_ZONES];
+static std::atomic<int> g_zone_count{0};
+static ProfilerThread* g_threads[PROFILER_MAX_THREADS];
+static int g_thread_count = 0;
+static std::atomic<bool> g_tracing{false};
+static uint64_t g_trace_start_ns = 0;
+static std::atomic<uint64_t> g_allocations{0};   // Constant-initialized: counts allocations made before main()
+
+// Window state (profiler_window caller only)
+static uint64_t g_window_start_ns = 0;
+static uint64_t g_window_allocations = 0;
+static uint64_t g_window_total_ns[PROFILER_MAX_ZONES];
+static uint32_t g_window_calls[PROFILER_MAX_ZONES];
+
+static thread_local ProfilerThread* t_thread = NULL;
+
+uint64_t profiler_now_ns(void) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int profiler_zone(const char* name) {
+    std::lock_guard<std::mutex> guard(g_lock);
+    int count = g_zone_count.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(g_zones[i].name, name) == 0) return i;
+    }
+    if (count >= PROFILER_MAX_ZONES) {
+        fprintf(stderr, "[Profiler] Too many zones, ignoring '%s'\n", name);
+        return -1;
+    }
+    g_zones[count].name = name;
+    g_zone_count.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+// Trace buffer of the calling thread, registered on first use (NULL if full)
+static ProfilerThread* profiler_thread(void) {
+    if (t_thread) return t_thread;
+    std::lock_guard<std::mutex> guard(g_lock);
+    if (g_thread_count >= PROFILER_MAX_THREADS) return NULL;
+    ProfilerThread* thread = new ProfilerThread();
+    thread->tid = g_thread_count + 1;
+    snprintf(thread->name, sizeof(thread->name), "thread %d", thread->tid);
+    thread->dropped = 0;
+    g_threads[g_thread_count++] = thread;
+    t_thread = thread;
+    return thread;
+}
+
+void profiler_record(int zone, uint64_t begin_ns, uint64_t end_ns) {
+    if (zone < 0) return;
+    g_zones[zone].total_ns.fetch_add(end_ns - begin_ns, std::memory_order_relaxed);
+    g_zones[zone].calls.fetch_add(1, std::memory_order_relaxed);
+
+    if (!g_tracing.load(std::memory_order_relaxed)) return;
+    ProfilerThread* thread = profiler_thread();
+    if (!thread) return;
+    if (thread->events.size() >= PROFILER_TRACE_EVENTS_PER_THREAD) {
+        thread->dropped++;
+        return;
+    }
+    thread->events.push_back({begin_ns, end_ns, zone});
+}
+
+void profiler_set_thread_name(const char* name) {
+    ProfilerThread* thread = profiler_thread();
+    if (thread) snprintf(thread->name, sizeof(thread->name), "%s", name);
+}
+
+void profiler_count_allocation(void) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t profiler_allocations(void) {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void profiler_window(ProfilerWindow* out) {
+    uint64_t now = profiler_now_ns();
+    out->window_sec = g_window_start_ns ? (double)(now - g_window_start_ns) * 1e-9 : 0.0;
+    g_window_start_ns = now;
+
+    uint64_t allocations = profiler_allocations();
+    out->allocations = allocations - g_window_allocations;
+    g_window_allocations = allocations;
+
+    out->zone_count = g_zone_count.load(std::memory_order_acquire);
+    for (int i = 0; i < out->zone_count; i++) {
+        uint64_t total = g_zones[i].total_ns.load(std::memory_order_relaxed);
+        uint32_t calls = g_zones[i].calls.load(std::memory_order_relaxed);
+        ProfilerZoneStats* stats = &out->zones[i];
+        stats->name = g_zones[i].name;
+        stats->calls = calls - g_window_calls[i];
+        stats->total_ms = (double)(total - g_window_total_ns[i]) * 1e-6;
+        stats->avg_ms = stats->calls ? stats->total_ms / stats->calls : 0.0;
+        g_window_total_ns[i] = total;
+        g_window_calls[i] = calls;
+    }
+}
+
+void profiler_trace_start(void) {
+    std::lock_guard<std::mutex> guard(g_lock);
+    for (int i = 0; i < g_thread_count; i++) {
+        g_threads[i]->events.clear();
+        g_threads[i]->dropped = 0;
+    }
+    g_trace_start_ns = profiler_now_ns();
+    g_tracing.store(true, std::memory_order_relaxed);
+}
+
+// Write s as a JSON string body (zone and thread names are plain ASCII)
+static void write_json_string(FILE* file, const char* s) {
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', file);
+        if ((unsigned char)*s >= 0x20) fputc(*s, file);
+    }
+}
+
+bool profiler_trace_write(const char* path) {
+    g_tracing.store(false, std::memory_order_relaxed);
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "[Profiler] Failed to write trace: %s\n", path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(g_lock);
+    size_t event_count = 0;
+    uint64_t dropped = 0;
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (int t = 0; t < g_thread_count; t++) {
+        const ProfilerThread* thread = g_threads[t];
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+                first ? "" : ",\n", thread->tid);
+        write_json_string(file, thread->name);
+        fprintf(file, "\"}}");
+        first = false;
+
+        // Complete events ("X"), microseconds since the trace started
+        for (const ProfilerEvent& event : thread->events) {
+            fprintf(file, ",\n{\"name\":\"");
+            write_json_string(file, g_zones[event.zone].name);
+            fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", thread->tid,
+                    (double)(int64_t)(event.begin_ns - g_trace_start_ns) * 1e-3,
+                    (double)(event.end_ns - event.begin_ns) * 1e-3);
+        }
+        event_count += thread->events.size();
+        dropped += thread->dropped;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    printf("[Profiler] Wrote %zu events to %s", event_count, path);
+    if (dropped > 0) printf(" (%llu dropped, buffers full)", (unsigned long long)dropped);
+    printf("\n");
+    return true;
+}
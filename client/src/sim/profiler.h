@@ -0,0 +1,113 @@
+/*
+ * Profiler
+ * Scoped timing zones for the step and frame phases, with a rolling
+ * per-zone breakdown and Chrome trace-event export.
+ *
+ * Zones are compiled in only when VEXIQ_PROFILE is defined (Debug builds, or
+ * -DVEXIQ_PROFILE=ON); otherwise PROFILE_ZONE expands to nothing and the
+ * functions below are never called. A zone costs two clock reads and two
+ * relaxed atomic adds; while a trace is recording it also appends one event
+ * to its thread's buffer, so zones belong around phases, not per part.
+ *
+ *   void sim_world_step(SimWorld* world, float dt) {
+ *       PROFILE_ZONE("step");
+ *       ...
+ *   }
+ *
+ * profiler_window() returns the time spent in each zone since the previous
+ * call (the GUI calls it twice a second). A trace started with
+ * profiler_trace_start() records every zone on every thread until
+ * profiler_trace_write(), which saves it for chrome://tracing or Perfetto.
+ *
+ * vexiq_sim also counts heap allocations (profiler_alloc.cpp replaces
+ * operator new in profiling builds); the window reports them, so a
+ * steady-state frame should show zero.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#define PROFILER_MAX_ZONES 32
+#define PROFILER_MAX_THREADS 32
+#define PROFILER_TRACE_EVENTS_PER_THREAD (1 << 20)   // Later events are counted, not stored
+
+// Zone timings over one window
+typedef struct {
+    const char* name;
+    uint32_t calls;
+    double total_ms;
+    double avg_ms;          // Per call
+} ProfilerZoneStats;
+
+typedef struct {
+    double window_sec;      // Wall time since the previous profiler_window()
+    uint64_t allocations;   // operator new calls on all threads (0 unless counted)
+    int zone_count;
+    ProfilerZoneStats zones[PROFILER_MAX_ZONES];   // Registration order
+} ProfilerWindow;
+
+// Register a zone name (string must outlive the program); same name, same id
+// Returns -1 once PROFILER_MAX_ZONES are registered.
+int profiler_zone(const char* name);
+
+// Nanoseconds on a monotonic clock
+uint64_t profiler_now_ns(void);
+
+// Account one finished zone on the calling thread
+void profiler_record(int zone, uint64_t begin_ns, uint64_t end_ns);
+
+// Name the calling thread in traces (e.g. "render", "sim")
+void profiler_set_thread_name(const char* name);
+
+// Count one heap allocation (called by the replaced operator new)
+void profiler_count_allocation(void);
+
+// Heap allocations counted since startup
+uint64_t profiler_allocations(void);
+
+// Zone totals since the previous call (zones without calls have calls = 0)
+void profiler_window(ProfilerWindow* out);
+
+// Record every zone from now on
+void profiler_trace_start(void);
+
+// Stop recording and write Chrome trace-event JSON. Threads that record
+// zones must be idle or stopped. Returns false if the file can't be written.
+bool profiler_trace_write(const char* path);
+
+#ifdef __cplusplus
+// Times its scope into zone (see PROFILE_ZONE)
+struct ProfileScope {
+    int zone;
+    uint64_t begin_ns;
+    explicit ProfileScope(int zone_id) : zone(zone_id), begin_ns(profiler_now_ns()) {}
+    ~ProfileScope() { profiler_record(zone, begin_ns, profiler_now_ns()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef VEXIQ_PROFILE
+// Time the rest of the enclosing scope as zone name (a string literal)
+#define PROFILE_ZONE(name) \
+    static const int PROFILE_CONCAT(profile_zone_, __LINE__) = profiler_zone(name); \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_zone_, __LINE__))
+// Time from PROFILE_BEGIN to PROFILE_END in the same scope (var names the pair)
+#define PROFILE_BEGIN(var, name) \
+    static const int var##_profile_zone = profiler_zone(name); \
+    uint64_t var##_profile_begin = profiler_now_ns()
+#define PROFILE_END(var) profiler_record(var##_profile_zone, var##_profile_begin, profiler_now_ns())
+#define PROFILE_ENABLED 1
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_BEGIN(var, name) ((void)0)
+#define PROFILE_END(var) ((void)0)
+#define PROFILE_ENABLED 0
+#endif
+
+#endif // PROFILER_H
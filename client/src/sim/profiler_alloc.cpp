@@ -0,0 +1,90 @@
+/*
+ * Profiler Allocation Counter
+ * Replaces the global operator new/delete to count heap allocations for
+ * ProfilerWindow::allocations (profiling builds only).
+ *
+ * Linked into vexiq_sim only: the engine library also goes into the Python
+ * module, which must keep the interpreter's allocator. malloc() calls from C
+ * code (GLB decoding, SDL, drivers) are not counted.
+ */
+
+#include "profiler.h"
+
+#ifdef VEXIQ_PROFILE
+
+#include <stdlib.h>
+#include <new>
+
+static void* counted_alloc(size_t size) {
+    profiler_count_allocation();
+    return malloc(size ? size : 1);
+}
+
+static void* counted_aligned_alloc(size_t size, std::align_val_t align) {
+    profiler_count_allocation();
+    size_t alignment = (size_t)align;
+    size = (size + alignment - 1) & ~(alignment - 1);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : alignment, alignment);
+#else
+    return aligned_alloc(alignment, size ? size : alignment);
+#endif
+}
+
+static void counted_aligned_free(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+void* operator new(size_t size) {
+    void* ptr = counted_alloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    void* ptr = counted_alloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+
+void* operator new(size_t size, std::align_val_t align) {
+    void* ptr = counted_aligned_alloc(size, align);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    void* ptr = counted_aligned_alloc(size, align);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return counted_aligned_alloc(size, align);
+}
+
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return counted_aligned_alloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { counted_aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { counted_aligned_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { counted_aligned_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { counted_aligned_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_aligned_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_aligned_free(ptr); }
+
+#endif // VEXIQ_PROFILE
@@ -0,0 +1,284 @@
+/*
+ * Raycasts Implementation
+ */
+
+#include "raycast.h"
+#include "sim_world.h"
+#include "profiler.h"
+#include <string.h>
+#include <cmath>
+
+// Rays per job chunk (a cast is a few microseconds)
+static const int SIM_RAY_GRAIN = 8;
+
+// Widest bounds growth the grid walk can cull for: bodies are binned grown by
+// BROADPHASE_MARGIN and may have moved SIM_CONTACT_REUSE_DISTANCE since, so
+// anything within this of the ray's center line is in a cell the line crosses.
+// Wider casts test every body.
+static const float SIM_RAY_GRID_RADIUS = BROADPHASE_MARGIN - SIM_CONTACT_REUSE_DISTANCE;
+
+struct RaycastJob {
+    SimWorld* world;
+    const SimRay* rays;
+    SimRayHit* hits;
+};
+
+static void set_hit(SimRayHit* hit, float distance, SimRayObject object, int index, int part) {
+    hit->distance = distance;
+    hit->object = (uint8_t)object;
+    hit->index = index;
+    hit->part = part;
+}
+
+// Floor (y = 0) and the inner faces of the walls
+static void cast_field(const SimWorld* world, const SimRay* ray, SimRayHit* hit) {
+    const float* o = ray->origin;
+    const float* d = ray->dir;
+    float r = ray->radius;
+
+    if (d[1] < 0.0f) {
+        float t = (r - o[1]) / d[1];
+        if (t >= 0.0f && t < hit->distance) set_hit(hit, t, SIM_RAY_FLOOR, -1, -1);
+    }
+
+    // The ray leaves the field box through the nearest wall plane ahead of it
+    float t_wall = hit->distance;
+    int wall = -1;
+    if (d[0] != 0.0f) {
+        float t = d[0] > 0.0f ? (world->field_half_width - r - o[0]) / d[0]
+                              : (-world->field_half_width + r - o[0]) / d[0];
+        if (t >= 0.0f && t < t_wall) { t_wall = t; wall = d[0] > 0.0f ? 1 : 0; }
+    }
+    if (d[2] != 0.0f) {
+        float t = d[2] > 0.0f ? (world->field_half_depth - r - o[2]) / d[2]
+                              : (-world->field_half_depth + r - o[2]) / d[2];
+        if (t >= 0.0f && t < t_wall) { t_wall = t; wall = d[2] > 0.0f ? 3 : 2; }
+    }
+    if (wall >= 0 && o[1] + d[1] * t_wall <= SIM_RAY_WALL_HEIGHT + r) {
+        set_hit(hit, t_wall, SIM_RAY_WALL, wall, -1);
+    }
+}
+
+// Capped vertical cylinder standing on the floor, grown by the ray radius
+static void cast_cylinder(const SceneCylinder* cyl, int index, const SimRay* ray, SimRayHit* hit) {
+    const float* o = ray->origin;
+    const float* d = ray->dir;
+    float radius = cyl->radius + ray->radius;
+
+    // Circle on the XZ plane
+    float fx = o[0] - cyl->x, fz = o[2] - cyl->z;
+    float a = d[0] * d[0] + d[2] * d[2];
+    float c = fx * fx + fz * fz - radius * radius;
+    float t0, t1;
+    if (a < 1e-12f) {
+        if (c > 0.0f) return;       // Vertical ray beside the cylinder
+        t0 = 0.0f;
+        t1 = hit->distance;
+    } else {
+        float b = fx * d[0] + fz * d[2];
+        float disc = b * b - a * c;
+        if (disc < 0.0f) return;
+        float root = sqrtf(disc);
+        t0 = (-b - root) / a;
+        t1 = (-b + root) / a;
+    }
+
+    // Height slab
+    float y0 = -ray->radius, y1 = cyl->height + ray->radius;
+    if (fabsf(d[1]) < 1e-8f) {
+        if (o[1] < y0 || o[1] > y1) return;
+    } else {
+        float ty0 = (y0 - o[1]) / d[1], ty1 = (y1 - o[1]) / d[1];
+        if (ty0 > ty1) { float t = ty0; ty0 = ty1; ty1 = t; }
+        t0 = fmaxf(t0, ty0);
+        t1 = fminf(t1, ty1);
+    }
+
+    t0 = fmaxf(t0, 0.0f);
+    if (t0 > t1 || t0 >= hit->distance) return;
+    set_hit(hit, t0, SIM_RAY_CYLINDER, index, -1);
+}
+
+// Parts of one robot, in its local frame
+static void cast_robot(const SimWorld* world, int index, const SimRay* ray, SimRayHit* hit) {
+    const RobotInstance& robot = world->robots[index];
+
+    // local = R_y^T (world - position), as sim_submodel_world_obb places it
+    float c = cosf(robot.rotation_y), s = sinf(robot.rotation_y);
+    float px = ray->origin[0] - robot.offset[0];
+    float py = ray->origin[1] - (robot.offset[1] + robot.ground_offset);
+    float pz = ray->origin[2] - robot.offset[2];
+    Vec3 origin = vec3(c * px - s * pz, py, s * px + c * pz);
+    Vec3 dir = vec3(c * ray->dir[0] - s * ray->dir[2], ray->dir[1], s * ray->dir[0] + c * ray->dir[2]);
+
+    uint32_t part_tests = 0;
+    float bounds_radius = ray->radius * RAY_BOUNDS_GROWTH;
+    for (int sm = 0; sm < robot.submodel_count; sm++) {
+        if (robot.submodel_bvh_root[sm] < 0) continue;
+        if (obb_raycast(&robot.submodel_obbs[sm], origin, dir, bounds_radius, hit->distance) < 0.0f) continue;
+
+        float t;
+        int part = part_bvh_raycast(&world->part_bvh, world->parts.collision, robot.submodel_bvh_root[sm],
+                                    origin, dir, ray->radius, hit->distance, &t, &part_tests);
+        if (part >= 0 && t <= hit->distance) set_hit(hit, t, SIM_RAY_ROBOT, index, part);
+    }
+}
+
+// Test one broad-phase body if its (grown) footprint is ahead of the ray
+static void cast_body(const SimWorld* world, const BroadphaseBody* body, const SimRay* ray, SimRayHit* hit) {
+    if (body->type == BROADPHASE_ROBOT && body->index == ray->ignore_robot) return;
+
+    // Footprint slab test on the XZ plane (the ray flattened to y = 0)
+    AABB footprint;
+    footprint.min = vec3(body->min_x, -1.0f, body->min_z);
+    footprint.max = vec3(body->max_x, 1.0f, body->max_z);
+    Vec3 origin = vec3(ray->origin[0], 0.0f, ray->origin[2]);
+    Vec3 dir = vec3(ray->dir[0], 0.0f, ray->dir[2]);
+    if (aabb_raycast(&footprint, origin, dir, ray->radius * RAY_BOUNDS_GROWTH, hit->distance) < 0.0f) return;
+
+    if (body->type == BROADPHASE_ROBOT) cast_robot(world, body->index, ray, hit);
+    else cast_cylinder(&world->scene.cylinders[body->index], body->index, ray, hit);
+}
+
+// tested: scratch bitset of (body_count + 31) / 32 words
+static void cast_ray(const SimWorld* world, const SimRay* ray, SimRayHit* hit, uint32_t* tested) {
+    set_hit(hit, ray->max_distance, SIM_RAY_NONE, -1, -1);
+    cast_field(world, ray, hit);
+
+    const Broadphase* bp = &world->broadphase;
+    int cells[BROADPHASE_MAX_RAY_CELLS];
+    float exits[BROADPHASE_MAX_RAY_CELLS];
+    int cell_count = 0;
+    if (ray->radius * RAY_BOUNDS_GROWTH <= SIM_RAY_GRID_RADIUS) {
+        cell_count = broadphase_ray_cells(bp, ray->origin[0], ray->origin[2], ray->dir[0], ray->dir[2],
+                                          hit->distance, cells, exits, BROADPHASE_MAX_RAY_CELLS);
+    }
+    if (cell_count == 0) {
+        for (int i = 0; i < bp->body_count; i++) cast_body(world, &bp->bodies[i], ray, hit);
+        return;
+    }
+
+    // Bodies spanning several cells are tested once
+    memset(tested, 0, ((bp->body_count + 31) / 32) * sizeof(uint32_t));
+    for (int k = 0; k < cell_count; k++) {
+        for (uint32_t e = bp->cell_start[cells[k]]; e < bp->cell_start[cells[k] + 1]; e++) {
+            uint32_t i = bp->entries[e];
+            if (tested[i >> 5] & (1u << (i & 31))) continue;
+            tested[i >> 5] |= 1u << (i & 31);
+            cast_body(world, &bp->bodies[i], ray, hit);
+        }
+        // Anything hit before the ray leaves this cell is in a cell already walked
+        if (hit->object != SIM_RAY_NONE && hit->distance <= exits[k]) break;
+    }
+}
+
+static void raycast_job(void* user_data, int begin, int end, int thread) {
+    RaycastJob* job = (RaycastJob*)user_data;
+    uint32_t* tested = job->world->ray_tested[thread].data();
+    for (int i = begin; i < end; i++) cast_ray(job->world, &job->rays[i], &job->hits[i], tested);
+}
+
+void sim_world_raycast(SimWorld* world, const SimRay* rays, int count, SimRayHit* hits) {
+    if (count <= 0) return;
+    sim_world_update_broadphase(world);
+    world->ray_tested.resize(job_system_thread_count(world->jobs));
+    for (std::vector<uint32_t>& tested : world->ray_tested) tested.resize((world->broadphase.body_count + 31) / 32);
+    RaycastJob job = { world, rays, hits };
+    job_system_parallel_for(world->jobs, count, SIM_RAY_GRAIN, raycast_job, &job);
+}
+
+void sim_world_ray_hit_color(const SimWorld* world, const SimRayHit* hit, float* rgb) {
+    float r = 0.0f, g = 0.0f, b = 0.0f;
+    switch (hit->object) {
+    case SIM_RAY_FLOOR:
+        r = g = b = 0.55f;          // Gray field tiles
+        break;
+    case SIM_RAY_WALL:
+        r = g = b = 0.85f;
+        break;
+    case SIM_RAY_CYLINDER: {
+        const SceneCylinder& cyl = world->scene.cylinders[hit->index];
+        r = cyl.r; g = cyl.g; b = cyl.b;
+        break;
+    }
+    case SIM_RAY_ROBOT: {
+        // Render table lives in the template of a shared world
+        const SimParts& parts = world->shared ? world->shared->parts : world->parts;
+        r = g = b = 0.5f;
+        if (hit->part >= 0 && (size_t)hit->part < parts.render.size() && parts.render[hit->part].has_color) {
+            const float* color = parts.render[hit->part].color;
+            r = color[0]; g = color[1]; b = color[2];
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    rgb[0] = r;
+    rgb[1] = g;
+    rgb[2] = b;
+}
+
+void sim_robot_sensor_pose(const RobotInstance* robot, const SimSensor* sensor,
+                           float* origin, float* dir, float* up) {
+    float p[3], d[3], u[3] = {0.0f, 1.0f, 0.0f};
+    memcpy(p, sensor->origin, sizeof(p));
+    memcpy(d, sensor->dir, sizeof(d));
+
+    // Follow the mounting submodel's joint
+    const SubmodelJoint* joint = sensor->submodel >= 0 ? &robot->submodel_joints[sensor->submodel] : nullptr;
+    if (joint && joint->version != 0) {
+        const float* jr = joint->rotation;
+        for (int a = 0; a < 3; a++) {
+            p[a] = jr[a * 3] * sensor->origin[0] + jr[a * 3 + 1] * sensor->origin[1] +
+                   jr[a * 3 + 2] * sensor->origin[2] + joint->translation[a];
+            d[a] = jr[a * 3] * sensor->dir[0] + jr[a * 3 + 1] * sensor->dir[1] + jr[a * 3 + 2] * sensor->dir[2];
+            u[a] = jr[a * 3 + 1];
+        }
+    }
+
+    // Robot-local to world: R_y, then the robot position
+    float c = cosf(robot->rotation_y), s = sinf(robot->rotation_y);
+    origin[0] = c * p[0] + s * p[2] + robot->offset[0];
+    origin[1] = p[1] + robot->offset[1] + robot->ground_offset;
+    origin[2] = -s * p[0] + c * p[2] + robot->offset[2];
+    dir[0] = c * d[0] + s * d[2];
+    dir[1] = d[1];
+    dir[2] = -s * d[0] + c * d[2];
+    if (up) {
+        up[0] = c * u[0] + s * u[2];
+        up[1] = u[1];
+        up[2] = -s * u[0] + c * u[2];
+    }
+}
+
+void sim_world_update_sensors(SimWorld* world) {
+    world->sensor_rays.clear();
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        RobotInstance& robot = world->robots[i];
+        if (robot.sensor_count == 0) continue;
+        sim_robot_update_joints(&robot);
+
+        for (int k = 0; k < robot.sensor_count; k++) {
+            const SimSensor& sensor = robot.sensors[k];
+            if (sensor.type == SIM_SENSOR_CAMERA) continue;
+            SimRay ray;
+            sim_robot_sensor_pose(&robot, &sensor, ray.origin, ray.dir, nullptr);
+            ray.max_distance = sensor.range;
+            ray.radius = sensor.radius;
+            ray.ignore_robot = (int)i;
+            world->sensor_rays.push_back(ray);
+        }
+    }
+    if (world->sensor_rays.empty()) return;
+
+    world->sensor_hits.resize(world->sensor_rays.size());
+    sim_world_raycast(world, world->sensor_rays.data(), (int)world->sensor_rays.size(), world->sensor_hits.data());
+
+    size_t next = 0;
+    for (RobotInstance& robot : world->robots) {
+        for (int k = 0; k < robot.sensor_count; k++) {
+            if (robot.sensors[k].type != SIM_SENSOR_CAMERA) robot.sensors[k].reading = world->sensor_hits[next++];
+        }
+    }
+}
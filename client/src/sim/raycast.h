@@ -0,0 +1,79 @@
+/*
+ * Raycasts
+ * Batched ray and shape casts against the field floor and walls, cylinders
+ * and robot parts, for simulated distance and optical sensors.
+ *
+ * The floor and walls are planes. Robots and cylinders are culled with the
+ * response broad phase: a ray walks the grid cells it crosses, nearest
+ * first, and stops once it has a hit closer than the next cell. Robots are
+ * then tested in their local frame, submodel OBB first, then the nearest
+ * part of the submodel's part BVH, so casts read the world but write none
+ * of its caches and a batch runs in parallel on the job system.
+ *
+ * A shape cast grows every box and cylinder by the ray's radius (a sphere
+ * swept along the ray, slightly conservative at box edges).
+ *
+ * Usage (between steps):
+ *   SimRay ray = {{x, y, z}, {dx, dy, dz}, 40.0f, 0.0f, -1};
+ *   SimRayHit hit;
+ *   sim_world_raycast(&world, &ray, 1, &hit);
+ *   if (hit.object == SIM_RAY_CYLINDER) ... hit.distance, hit.index
+ *
+ * Each robot's sensors (SimSensor, from its .config) are cast in one batch
+ * at the end of every sim_world_step; readings are in RobotInstance::sensors.
+ */
+
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include <stdint.h>
+
+struct SimWorld;
+struct RobotInstance;
+struct SimSensor;
+
+// Field walls are this tall (inches); rays passing above them leave the field
+#define SIM_RAY_WALL_HEIGHT 4.0f
+
+// What a ray hit
+enum SimRayObject {
+    SIM_RAY_NONE = 0,
+    SIM_RAY_FLOOR,
+    SIM_RAY_WALL,
+    SIM_RAY_CYLINDER,
+    SIM_RAY_ROBOT
+};
+
+struct SimRay {
+    float origin[3];          // World position (inches)
+    float dir[3];             // Unit direction
+    float max_distance;       // Inches
+    float radius;             // Shape cast radius (0 = thin ray)
+    int ignore_robot;         // Robot to pass through, e.g. the sensor's own (-1 = none)
+};
+
+struct SimRayHit {
+    float distance;           // Inches along the ray (max_distance when nothing was hit)
+    uint8_t object;           // SimRayObject
+    int index;                // Wall (0-3, BROADPHASE_WALL_* order), cylinder or robot (-1 = none)
+    int part;                 // Global part index of a robot hit (-1 = none)
+};
+
+// Cast count rays, nearest hit of each into hits. Rebuilds the broad phase
+// first if bodies moved out of it; must not run during a step.
+void sim_world_raycast(SimWorld* world, const SimRay* rays, int count, SimRayHit* hits);
+
+// Color (0-1) of what a hit sees, for optical sensors: the cylinder's or
+// part's color, field tile or wall gray, black for no hit
+void sim_world_ray_hit_color(const SimWorld* world, const SimRayHit* hit, float* rgb);
+
+// Cast every sensor of every robot in one batch and store the readings
+// (called by sim_world_step after the sync phase; cameras are skipped)
+void sim_world_update_sensors(SimWorld* world);
+
+// World pose of a robot's sensor: position, unit view direction and up
+// (up may be NULL). The robot's joints must be current (sim_robot_update_joints).
+void sim_robot_sensor_pose(const RobotInstance* robot, const SimSensor* sensor,
+                           float* origin, float* dir, float* up);
+
+#endif // RAYCAST_H
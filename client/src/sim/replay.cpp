@@ -0,0 +1,779 @@
+/*
+ * Match Replay Implementation
+ */
+
+#include "replay.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Quantization steps
+static const double REPLAY_POS_SCALE = 100.0;         // Units per inch
+static const double REPLAY_ANGLE_SCALE = 1000.0;      // Units per radian
+static const double REPLAY_MOTOR_POS_SCALE = 10.0;    // Units per degree
+static const double REPLAY_HUD_SCALE = 10.0;          // Units per percent or inch/s
+
+// Channels per robot group
+static const int REPLAY_MOTOR_CHANNELS = 1 + REPLAY_MAX_MOTORS * 4;            // count; port, speed, spinning, position
+static const int REPLAY_PNEUMATIC_CHANNELS = 1 + REPLAY_MAX_PNEUMATICS * 2;    // count; port, flags
+static_assert(REPLAY_MOTOR_CHANNELS <= 64 && REPLAY_PNEUMATIC_CHANNELS <= 64, "group masks are 64 bits");
+static const int REPLAY_CYLINDER_GROUP = 32;  // Cylinders per group (x, z each)
+static_assert(3 + ROBOTDEF_MAX_WHEELS <= 64 && REPLAY_CYLINDER_GROUP * 2 <= 64, "group masks are 64 bits");
+static const int REPLAY_HUD_CHANNELS = 4;     // Motor percent, wheel velocity (left, right)
+
+// =============================================================================
+// Channel layout
+// =============================================================================
+
+static void layout_add_group(ReplayLayout* layout, int count, bool linear) {
+    layout->group_first.push_back(layout->channel_count);
+    layout->group_count.push_back(count);
+    layout->linear.insert(layout->linear.end(), (size_t)count, linear ? 1 : 0);
+    layout->channel_count += count;
+}
+
+// Per robot: pose, motors, pneumatics; then the cylinders, REPLAY_CYLINDER_GROUP
+// per group; then the HUD group of each robot
+void replay_layout_build(ReplayLayout* layout, const uint32_t* wheel_counts, uint32_t robot_count,
+                         uint32_t cylinder_count, bool hud) {
+    layout->channel_count = 0;
+    layout->group_first.clear();
+    layout->group_count.clear();
+    layout->linear.clear();
+    layout->robot_first.clear();
+    layout->robot_wheels.clear();
+
+    for (uint32_t r = 0; r < robot_count; r++) {
+        layout->robot_first.push_back(layout->channel_count);
+        layout->robot_wheels.push_back((int)wheel_counts[r]);
+        layout_add_group(layout, 3 + (int)wheel_counts[r], true);
+        layout_add_group(layout, REPLAY_MOTOR_CHANNELS, false);
+        layout_add_group(layout, REPLAY_PNEUMATIC_CHANNELS, false);
+    }
+
+    // Motor positions move steadily while spinning, so they predict linearly too
+    for (uint32_t r = 0; r < robot_count; r++) {
+        int motors = layout->robot_first[r] + 3 + layout->robot_wheels[r];
+        for (int m = 0; m < REPLAY_MAX_MOTORS; m++) layout->linear[motors + 1 + m * 4 + 3] = 1;
+    }
+
+    layout->cylinder_first = layout->channel_count;
+    layout->cylinder_count = (int)cylinder_count;
+    for (uint32_t c = 0; c < cylinder_count; c += REPLAY_CYLINDER_GROUP) {
+        uint32_t group = std::min(cylinder_count - c, (uint32_t)REPLAY_CYLINDER_GROUP);
+        layout_add_group(layout, (int)group * 2, true);
+    }
+
+    layout->hud_first = hud ? layout->channel_count : -1;
+    for (uint32_t r = 0; hud && r < robot_count; r++) layout_add_group(layout, REPLAY_HUD_CHANNELS, false);
+}
+
+static int32_t quantize(double value, double scale) {
+    double q = floor(value * scale + 0.5);
+    if (q > 2147483647.0) q = 2147483647.0;
+    if (q < -2147483648.0) q = -2147483648.0;
+    return (int32_t)q;
+}
+
+// World state and actuators -> quantized channel values
+void replay_layout_store(const ReplayLayout* layout, const SimWorld* world, const ReplayActuators* actuators,
+                         int32_t* out) {
+    for (size_t r = 0; r < layout->robot_first.size(); r++) {
+        const RobotInstance& robot = world->robots[r];
+        int32_t* v = out + layout->robot_first[r];
+        *v++ = quantize(robot.drivetrain.pos_x, REPLAY_POS_SCALE);
+        *v++ = quantize(robot.drivetrain.pos_z, REPLAY_POS_SCALE);
+        *v++ = quantize(robot.drivetrain.heading, REPLAY_ANGLE_SCALE);
+        for (int w = 0; w < layout->robot_wheels[r]; w++) {
+            *v++ = quantize(robot.wheels[w].spin_angle, REPLAY_ANGLE_SCALE);
+        }
+
+        // Unused slots stay zero so they never register as changes
+        memset(v, 0, (REPLAY_MOTOR_CHANNELS + REPLAY_PNEUMATIC_CHANNELS) * sizeof(int32_t));
+        if (!actuators) continue;
+        const ReplayActuators& act = actuators[r];
+        int motor_count = std::min(std::max(act.motor_count, 0), REPLAY_MAX_MOTORS);
+        int pneumatic_count = std::min(std::max(act.pneumatic_count, 0), REPLAY_MAX_PNEUMATICS);
+        v[0] = motor_count;
+        for (int m = 0; m < motor_count; m++) {
+            int32_t* slot = v + 1 + m * 4;
+            slot[0] = act.motors[m].port;
+            slot[1] = act.motors[m].speed;
+            slot[2] = act.motors[m].spinning ? 1 : 0;
+            slot[3] = quantize(act.motors[m].position, REPLAY_MOTOR_POS_SCALE);
+        }
+        v += REPLAY_MOTOR_CHANNELS;
+        v[0] = pneumatic_count;
+        for (int p = 0; p < pneumatic_count; p++) {
+            int32_t* slot = v + 1 + p * 2;
+            slot[0] = act.pneumatics[p].port;
+            slot[1] = (act.pneumatics[p].extended ? 1 : 0) | (act.pneumatics[p].pump_on ? 2 : 0);
+        }
+    }
+
+    for (int c = 0; c < layout->cylinder_count; c++) {
+        out[layout->cylinder_first + c * 2] = quantize(world->scene.cylinders[c].x, REPLAY_POS_SCALE);
+        out[layout->cylinder_first + c * 2 + 1] = quantize(world->scene.cylinders[c].z, REPLAY_POS_SCALE);
+    }
+
+    if (layout->hud_first < 0) return;
+    for (size_t r = 0; r < layout->robot_first.size(); r++) {
+        const Drivetrain& dt = world->robots[r].drivetrain;
+        int32_t* v = out + layout->hud_first + r * REPLAY_HUD_CHANNELS;
+        v[0] = quantize(dt.left_motor_pct, REPLAY_HUD_SCALE);
+        v[1] = quantize(dt.right_motor_pct, REPLAY_HUD_SCALE);
+        v[2] = quantize(dt.left_wheel_vel, REPLAY_HUD_SCALE);
+        v[3] = quantize(dt.right_wheel_vel, REPLAY_HUD_SCALE);
+    }
+}
+
+// Quantized channel values -> frame
+void replay_layout_load(const ReplayLayout* layout, const int32_t* values, ReplayFrame* out) {
+    out->robots.resize(layout->robot_first.size());
+    for (size_t r = 0; r < layout->robot_first.size(); r++) {
+        ReplayRobotFrame& robot = out->robots[r];
+        const int32_t* v = values + layout->robot_first[r];
+        robot.x = (float)(*v++ / REPLAY_POS_SCALE);
+        robot.z = (float)(*v++ / REPLAY_POS_SCALE);
+        robot.heading = (float)(*v++ / REPLAY_ANGLE_SCALE);
+        memset(robot.wheel_spin, 0, sizeof(robot.wheel_spin));
+        for (int w = 0; w < layout->robot_wheels[r]; w++) robot.wheel_spin[w] = (float)(*v++ / REPLAY_ANGLE_SCALE);
+
+        ReplayActuators& act = robot.actuators;
+        memset(&act, 0, sizeof(act));
+        act.motor_count = std::min(std::max((int)v[0], 0), REPLAY_MAX_MOTORS);
+        for (int m = 0; m < act.motor_count; m++) {
+            const int32_t* slot = v + 1 + m * 4;
+            act.motors[m].port = slot[0];
+            act.motors[m].speed = slot[1];
+            act.motors[m].spinning = slot[2] != 0;
+            act.motors[m].position = (float)(slot[3] / REPLAY_MOTOR_POS_SCALE);
+        }
+        v += REPLAY_MOTOR_CHANNELS;
+        act.pneumatic_count = std::min(std::max((int)v[0], 0), REPLAY_MAX_PNEUMATICS);
+        for (int p = 0; p < act.pneumatic_count; p++) {
+            const int32_t* slot = v + 1 + p * 2;
+            act.pneumatics[p].port = slot[0];
+            act.pneumatics[p].extended = (slot[1] & 1) != 0;
+            act.pneumatics[p].pump_on = (slot[1] & 2) != 0;
+        }
+    }
+
+    out->cylinders.resize((size_t)layout->cylinder_count * 2);
+    for (int c = 0; c < layout->cylinder_count * 2; c++) {
+        out->cylinders[c] = (float)(values[layout->cylinder_first + c] / REPLAY_POS_SCALE);
+    }
+
+    out->hud = layout->hud_first >= 0;
+    for (size_t r = 0; r < layout->robot_first.size(); r++) {
+        ReplayRobotFrame& robot = out->robots[r];
+        const int32_t* v = out->hud ? values + layout->hud_first + r * REPLAY_HUD_CHANNELS : NULL;
+        robot.motor_pct[0] = v ? (float)(v[0] / REPLAY_HUD_SCALE) : 0.0f;
+        robot.motor_pct[1] = v ? (float)(v[1] / REPLAY_HUD_SCALE) : 0.0f;
+        robot.wheel_vel[0] = v ? (float)(v[2] / REPLAY_HUD_SCALE) : 0.0f;
+        robot.wheel_vel[1] = v ? (float)(v[3] / REPLAY_HUD_SCALE) : 0.0f;
+    }
+}
+
+// =============================================================================
+// Frame coding
+// A keyframe is every channel as a zigzag varint. A delta frame is the number
+// of groups with a misprediction, then per group its index gap, a 64-bit
+// channel mask and the residuals of the masked channels (all varints).
+// =============================================================================
+
+static void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool get_varint(const uint8_t** p, const uint8_t* end, uint64_t* out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*p >= end) return false;
+        uint8_t byte = *(*p)++;
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Advance values/previous to the predicted next frame (previous gets the
+// current values)
+static void predict(const ReplayLayout* layout, std::vector<int32_t>& values, std::vector<int32_t>& previous) {
+    for (int i = 0; i < layout->channel_count; i++) {
+        int32_t current = values[i];
+        int64_t predicted = layout->linear[i] ? 2 * (int64_t)current - previous[i] : current;
+        values[i] = (int32_t)predicted;
+        previous[i] = current;
+    }
+}
+
+static void encode_keyframe(const ReplayLayout* layout, const int32_t* q, std::vector<int32_t>& values,
+                            std::vector<int32_t>& previous, std::vector<uint8_t>& out) {
+    for (int i = 0; i < layout->channel_count; i++) put_varint(out, zigzag(q[i]));
+    values.assign(q, q + layout->channel_count);
+    previous = values;
+}
+
+// Mask of the channels of group g the prediction got wrong
+static uint64_t mispredicted(const ReplayLayout* layout, const int32_t* q, const std::vector<int32_t>& values, size_t g) {
+    uint64_t mask = 0;
+    for (int c = 0; c < layout->group_count[g]; c++) {
+        int i = layout->group_first[g] + c;
+        if (q[i] != values[i]) mask |= 1ull << c;
+    }
+    return mask;
+}
+
+static void encode_delta(const ReplayLayout* layout, const int32_t* q, std::vector<int32_t>& values,
+                         std::vector<int32_t>& previous, std::vector<uint8_t>& out) {
+    predict(layout, values, previous);
+
+    int changed = 0;
+    for (size_t g = 0; g < layout->group_first.size(); g++) {
+        if (mispredicted(layout, q, values, g)) changed++;
+    }
+
+    put_varint(out, (uint64_t)changed);
+    size_t next_group = 0;
+    for (size_t g = 0; g < layout->group_first.size(); g++) {
+        uint64_t mask = mispredicted(layout, q, values, g);
+        if (!mask) continue;
+        put_varint(out, g - next_group);
+        put_varint(out, mask);
+        for (int c = 0; c < layout->group_count[g]; c++) {
+            int i = layout->group_first[g] + c;
+            if (mask & (1ull << c)) put_varint(out, zigzag((int64_t)q[i] - values[i]));
+        }
+        next_group = g + 1;
+    }
+    values.assign(q, q + layout->channel_count);
+}
+
+static bool decode_keyframe(const ReplayLayout* layout, const uint8_t** p, const uint8_t* end,
+                            std::vector<int32_t>& values, std::vector<int32_t>& previous) {
+    values.resize(layout->channel_count);
+    for (int i = 0; i < layout->channel_count; i++) {
+        uint64_t v;
+        if (!get_varint(p, end, &v)) return false;
+        values[i] = (int32_t)unzigzag(v);
+    }
+    previous = values;
+    return true;
+}
+
+static bool decode_delta(const ReplayLayout* layout, const uint8_t** p, const uint8_t* end,
+                         std::vector<int32_t>& values, std::vector<int32_t>& previous) {
+    predict(layout, values, previous);
+
+    uint64_t changed;
+    if (!get_varint(p, end, &changed)) return false;
+    uint64_t group = 0;
+    for (uint64_t k = 0; k < changed; k++) {
+        uint64_t gap, mask;
+        if (!get_varint(p, end, &gap) || !get_varint(p, end, &mask)) return false;
+        group += gap;
+        if (group >= layout->group_first.size()) return false;
+        for (int c = 0; c < layout->group_count[group]; c++) {
+            if (!(mask & (1ull << c))) continue;
+            uint64_t residual;
+            if (!get_varint(p, end, &residual)) return false;
+            int i = layout->group_first[group] + c;
+            values[i] = (int32_t)((int64_t)values[i] + unzigzag(residual));
+        }
+        group++;
+    }
+    return true;
+}
+
+void replay_encode_frame(const ReplayLayout* layout, const int32_t* q, bool keyframe, std::vector<int32_t>& values,
+                         std::vector<int32_t>& previous, std::vector<uint8_t>& out) {
+    if (keyframe) {
+        encode_keyframe(layout, q, values, previous, out);
+    } else {
+        encode_delta(layout, q, values, previous, out);
+    }
+}
+
+bool replay_decode_frame(const ReplayLayout* layout, const uint8_t** p, const uint8_t* end, bool keyframe,
+                         std::vector<int32_t>& values, std::vector<int32_t>& previous) {
+    return keyframe ? decode_keyframe(layout, p, end, values, previous)
+                    : decode_delta(layout, p, end, values, previous);
+}
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+struct ReplayWriter {
+    FILE* file;
+    std::string path;
+    ReplayLayout layout;
+    uint32_t keyframe_interval;
+    float dt;
+
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable wake;
+    bool quit = false;
+    std::vector<int32_t> queue;            // Quantized frames waiting (guarded by lock)
+    std::vector<int32_t> store;            // Quantization scratch (recording thread)
+
+    // Encoder state (writer thread)
+    std::vector<int32_t> pending;          // Frames taken from the queue
+    std::vector<int32_t> values, previous;
+    std::vector<uint8_t> block;
+    uint32_t block_first = 0;
+    uint32_t block_frames = 0;
+    uint32_t frame_count = 0;
+    uint64_t offset = 0;                   // File size so far
+    std::vector<ReplayIndexEntry> index;
+    bool failed = false;
+};
+
+static void writer_flush_block(ReplayWriter* writer) {
+    if (writer->block_frames == 0) return;
+    ReplayBlockHeader header;
+    header.magic = REPLAY_BLOCK_MAGIC;
+    header.first_frame = writer->block_first;
+    header.frame_count = writer->block_frames;
+    header.payload_size = (uint32_t)writer->block.size();
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1 ||
+        fwrite(writer->block.data(), 1, writer->block.size(), writer->file) != writer->block.size()) {
+        writer->failed = true;
+    }
+    fflush(writer->file);  // Whole blocks reach the disk, so a cut-short file stays readable
+
+    ReplayIndexEntry entry = { writer->block_first, writer->block_frames, writer->offset };
+    writer->index.push_back(entry);
+    writer->offset += sizeof(header) + writer->block.size();
+    writer->block_first += writer->block_frames;
+    writer->block_frames = 0;
+    writer->block.clear();
+}
+
+static void writer_encode(ReplayWriter* writer, const int32_t* q) {
+    replay_encode_frame(&writer->layout, q, writer->block_frames == 0, writer->values, writer->previous,
+                        writer->block);
+    writer->block_frames++;
+    writer->frame_count++;
+    if (writer->block_frames >= writer->keyframe_interval) writer_flush_block(writer);
+}
+
+static void writer_main(ReplayWriter* writer) {
+    size_t channels = (size_t)writer->layout.channel_count;
+    for (;;) {
+        bool quit;
+        {
+            std::unique_lock<std::mutex> guard(writer->lock);
+            writer->wake.wait(guard, [writer] { return writer->quit || !writer->queue.empty(); });
+            std::swap(writer->queue, writer->pending);
+            quit = writer->quit;
+        }
+        for (size_t i = 0; channels > 0 && i + channels <= writer->pending.size(); i += channels) {
+            writer_encode(writer, &writer->pending[i]);
+        }
+        writer->pending.clear();
+        if (quit) break;
+    }
+    writer_flush_block(writer);
+}
+
+ReplayWriter* replay_writer_open(const char* path, const SimWorld* world, const char* scene_path, float dt) {
+    if (!path || !world || dt <= 0.0f) return NULL;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "[Replay] Failed to create %s\n", path);
+        return NULL;
+    }
+
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.dt = dt;
+    header.robot_count = (uint32_t)world->robots.size();
+    header.cylinder_count = world->scene.cylinder_count;
+    header.keyframe_interval = (uint32_t)std::max(1.0f, floorf(REPLAY_KEYFRAME_SECONDS / dt + 0.5f));
+    header.start_time = world->time;
+    snprintf(header.scene_path, sizeof(header.scene_path), "%s", scene_path ? scene_path : "");
+
+    std::vector<ReplayRobotInfo> robots(world->robots.size());
+    std::vector<uint32_t> wheel_counts(world->robots.size());
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        const RobotInstance& robot = world->robots[i];
+        memset(&robots[i], 0, sizeof(ReplayRobotInfo));
+        snprintf(robots[i].mpd_file, sizeof(robots[i].mpd_file), "%s",
+                 world->scene.robots[robot.scene_index].mpd_file);
+        robots[i].wheel_count = (uint32_t)robot.wheel_count;
+        wheel_counts[i] = (uint32_t)robot.wheel_count;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        (!robots.empty() && fwrite(robots.data(), sizeof(ReplayRobotInfo), robots.size(), file) != robots.size())) {
+        fprintf(stderr, "[Replay] Failed to write %s\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    ReplayWriter* writer = new ReplayWriter();
+    writer->file = file;
+    writer->path = path;
+    writer->dt = dt;
+    writer->keyframe_interval = header.keyframe_interval;
+    writer->offset = sizeof(header) + robots.size() * sizeof(ReplayRobotInfo);
+    replay_layout_build(&writer->layout, wheel_counts.data(), header.robot_count, header.cylinder_count, false);
+    writer->store.resize(writer->layout.channel_count);
+
+    try {
+        writer->thread = std::thread(writer_main, writer);
+    } catch (const std::system_error&) {
+        fprintf(stderr, "[Replay] Failed to start the writer thread\n");
+        fclose(file);
+        delete writer;
+        return NULL;
+    }
+
+    printf("[Replay] Recording to %s (%zu robots, %u cylinders, keyframe every %u frames)\n",
+           path, robots.size(), header.cylinder_count, header.keyframe_interval);
+    return writer;
+}
+
+void replay_writer_frame(ReplayWriter* writer, const SimWorld* world, const ReplayActuators* actuators) {
+    if (!writer || world->robots.size() != writer->layout.robot_first.size()) return;
+    replay_layout_store(&writer->layout, world, actuators, writer->store.data());
+    {
+        std::lock_guard<std::mutex> guard(writer->lock);
+        writer->queue.insert(writer->queue.end(), writer->store.begin(), writer->store.end());
+    }
+    writer->wake.notify_one();
+}
+
+bool replay_writer_close(ReplayWriter* writer) {
+    if (!writer) return true;
+    {
+        std::lock_guard<std::mutex> guard(writer->lock);
+        writer->quit = true;
+    }
+    writer->wake.notify_one();
+    writer->thread.join();
+
+    ReplayTrailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    trailer.index_offset = writer->offset;
+    trailer.block_count = (uint32_t)writer->index.size();
+    trailer.frame_count = writer->frame_count;
+    trailer.magic = REPLAY_INDEX_MAGIC;
+    if ((!writer->index.empty() &&
+         fwrite(writer->index.data(), sizeof(ReplayIndexEntry), writer->index.size(), writer->file) !=
+             writer->index.size()) ||
+        fwrite(&trailer, sizeof(trailer), 1, writer->file) != 1) {
+        writer->failed = true;
+    }
+    uint64_t file_size = writer->offset + writer->index.size() * sizeof(ReplayIndexEntry) + sizeof(trailer);
+    if (fclose(writer->file) != 0) writer->failed = true;
+
+    bool ok = !writer->failed;
+    if (ok) {
+        printf("[Replay] Wrote %u frames (%.1f s) to %s: %.1f KB\n", writer->frame_count,
+               writer->frame_count * writer->dt, writer->path.c_str(), file_size / 1024.0);
+    } else {
+        fprintf(stderr, "[Replay] Write error, %s is incomplete\n", writer->path.c_str());
+    }
+    delete writer;
+    return ok;
+}
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+static bool map_file(ReplayReader* reader, const char* path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    reader->file_handle = file;
+    reader->mapping_handle = mapping;
+    reader->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (data == MAP_FAILED) return false;
+    reader->size = (size_t)st.st_size;
+#endif
+    reader->data = (const uint8_t*)data;
+    return true;
+}
+
+// Block at offset if it is complete and continues the frame sequence
+static bool valid_block(const ReplayReader* reader, uint64_t offset, uint32_t first_frame) {
+    if (offset + sizeof(ReplayBlockHeader) > reader->size) return false;
+    const ReplayBlockHeader* block = (const ReplayBlockHeader*)(reader->data + offset);
+    return block->magic == REPLAY_BLOCK_MAGIC && block->first_frame == first_frame && block->frame_count > 0 &&
+           block->frame_count <= reader->header->keyframe_interval &&
+           offset + sizeof(ReplayBlockHeader) + block->payload_size <= reader->size;
+}
+
+// Block index from the trailer, or rebuilt by walking the blocks
+static bool load_index(ReplayReader* reader, size_t blocks_start, const char* path) {
+    reader->index.clear();
+    reader->frame_count = 0;
+
+    if (reader->size >= blocks_start + sizeof(ReplayTrailer)) {
+        const ReplayTrailer* trailer = (const ReplayTrailer*)(reader->data + reader->size - sizeof(ReplayTrailer));
+        uint64_t index_bytes = (uint64_t)trailer->block_count * sizeof(ReplayIndexEntry);
+        if (trailer->magic == REPLAY_INDEX_MAGIC && trailer->index_offset >= blocks_start &&
+            trailer->index_offset + index_bytes + sizeof(ReplayTrailer) == reader->size) {
+            const ReplayIndexEntry* entries = (const ReplayIndexEntry*)(reader->data + trailer->index_offset);
+            for (uint32_t i = 0; i < trailer->block_count; i++) {
+                if (!valid_block(reader, entries[i].offset, reader->frame_count) ||
+                    ((const ReplayBlockHeader*)(reader->data + entries[i].offset))->frame_count !=
+                        entries[i].frame_count) {
+                    return false;
+                }
+                reader->index.push_back(entries[i]);
+                reader->frame_count += entries[i].frame_count;
+            }
+            return reader->frame_count == trailer->frame_count;
+        }
+    }
+
+    uint64_t offset = blocks_start;
+    while (valid_block(reader, offset, reader->frame_count)) {
+        const ReplayBlockHeader* block = (const ReplayBlockHeader*)(reader->data + offset);
+        ReplayIndexEntry entry = { block->first_frame, block->frame_count, offset };
+        reader->index.push_back(entry);
+        reader->frame_count += block->frame_count;
+        offset += sizeof(ReplayBlockHeader) + block->payload_size;
+    }
+    printf("[Replay] %s has no index (recording cut short?), recovered %u frames\n", path, reader->frame_count);
+    return true;
+}
+
+bool replay_open(ReplayReader* reader, const char* path) {
+    reader->data = NULL;
+    reader->size = 0;
+    reader->header = NULL;
+    reader->robots = NULL;
+    reader->file_handle = NULL;
+    reader->mapping_handle = NULL;
+    reader->index.clear();
+    reader->frame_count = 0;
+    reader->cursor_block = -1;
+    reader->cursor_frame = 0;
+    reader->cursor_pos = 0;
+
+    if (!map_file(reader, path)) {
+        fprintf(stderr, "[Replay] Can't open %s\n", path);
+        return false;
+    }
+
+    const ReplayHeader* header = (const ReplayHeader*)reader->data;
+    size_t blocks_start = sizeof(ReplayHeader);
+    bool valid = reader->size >= sizeof(ReplayHeader) && header->magic == REPLAY_MAGIC &&
+                 header->version == REPLAY_VERSION && header->dt > 0.0f && header->keyframe_interval > 0 &&
+                 header->cylinder_count <= reader->size / 2;   // Keyframes hold a byte or more per channel
+    if (valid) {
+        blocks_start += header->robot_count * sizeof(ReplayRobotInfo);
+        valid = reader->size >= blocks_start;
+    }
+    std::vector<uint32_t> wheel_counts;
+    if (valid) {
+        reader->header = header;
+        reader->robots = (const ReplayRobotInfo*)(reader->data + sizeof(ReplayHeader));
+        for (uint32_t i = 0; i < header->robot_count && valid; i++) {
+            valid = reader->robots[i].wheel_count <= ROBOTDEF_MAX_WHEELS &&
+                    memchr(reader->robots[i].mpd_file, '\0', sizeof(reader->robots[i].mpd_file)) != NULL;
+            wheel_counts.push_back(reader->robots[i].wheel_count);
+        }
+        valid = valid && memchr(header->scene_path, '\0', sizeof(header->scene_path)) != NULL;
+    }
+    if (valid) valid = load_index(reader, blocks_start, path);
+
+    if (!valid) {
+        fprintf(stderr, "[Replay] Not a valid recording: %s\n", path);
+        replay_close(reader);
+        return false;
+    }
+
+    replay_layout_build(&reader->layout, wheel_counts.data(), header->robot_count, header->cylinder_count, false);
+    printf("[Replay] %s: %u frames (%.1f s at %.0f Hz), %u robots, %u cylinders, scene %s\n", path,
+           reader->frame_count, replay_duration(reader), 1.0 / header->dt, header->robot_count,
+           header->cylinder_count, header->scene_path);
+    return true;
+}
+
+void replay_close(ReplayReader* reader) {
+    if (reader->data) {
+#ifdef _WIN32
+        UnmapViewOfFile(reader->data);
+        if (reader->mapping_handle) CloseHandle((HANDLE)reader->mapping_handle);
+        if (reader->file_handle) CloseHandle((HANDLE)reader->file_handle);
+#else
+        munmap((void*)reader->data, reader->size);
+#endif
+    }
+    reader->data = NULL;
+    reader->size = 0;
+    reader->header = NULL;
+    reader->robots = NULL;
+    reader->file_handle = NULL;
+    reader->mapping_handle = NULL;
+    reader->index.clear();
+    reader->frame_count = 0;
+    reader->cursor_block = -1;
+}
+
+double replay_duration(const ReplayReader* reader) {
+    if (!reader->header || reader->frame_count == 0) return 0.0;
+    return (reader->frame_count - 1) * (double)reader->header->dt;
+}
+
+uint32_t replay_frame_at(const ReplayReader* reader, double time) {
+    if (!reader->header || reader->frame_count == 0) return 0;
+    double frame = floor((time - reader->header->start_time) / reader->header->dt + 1e-6);
+    if (frame < 0.0) return 0;
+    if (frame >= (double)(reader->frame_count - 1)) return reader->frame_count - 1;
+    return (uint32_t)frame;
+}
+
+bool replay_read_frame(ReplayReader* reader, uint32_t frame, ReplayFrame* out) {
+    if (!reader->header || frame >= reader->frame_count) return false;
+
+    // Block holding frame (first_frame ascending)
+    auto it = std::upper_bound(reader->index.begin(), reader->index.end(), frame,
+                               [](uint32_t f, const ReplayIndexEntry& entry) { return f < entry.first_frame; });
+    int block = (int)(it - reader->index.begin()) - 1;
+    const ReplayIndexEntry& entry = reader->index[block];
+    const ReplayBlockHeader* header = (const ReplayBlockHeader*)(reader->data + entry.offset);
+    const uint8_t* payload = reader->data + entry.offset + sizeof(ReplayBlockHeader);
+    const uint8_t* end = payload + header->payload_size;
+
+    // Continue from the cursor when it is earlier in the same block, else
+    // start over at the block's keyframe
+    const uint8_t* p;
+    if (reader->cursor_block == block && reader->cursor_frame <= frame) {
+        p = reader->data + reader->cursor_pos;
+    } else {
+        p = payload;
+        reader->cursor_block = -1;
+        if (!decode_keyframe(&reader->layout, &p, end, reader->values, reader->previous)) return false;
+        reader->cursor_block = block;
+        reader->cursor_frame = entry.first_frame;
+    }
+    while (reader->cursor_frame < frame) {
+        if (!decode_delta(&reader->layout, &p, end, reader->values, reader->previous)) {
+            reader->cursor_block = -1;
+            return false;
+        }
+        reader->cursor_frame++;
+    }
+    reader->cursor_pos = (size_t)(p - reader->data);
+
+    out->frame = frame;
+    out->time = reader->header->start_time + frame * (double)reader->header->dt;
+    replay_layout_load(&reader->layout, reader->values.data(), out);
+    return true;
+}
+
+bool replay_robots_match(const ReplayRobotInfo* robots, uint32_t robot_count, uint32_t cylinder_count,
+                         const SimWorld* world) {
+    if (robot_count != world->robots.size() || cylinder_count != world->scene.cylinder_count) return false;
+    for (uint32_t i = 0; i < robot_count; i++) {
+        const RobotInstance& robot = world->robots[i];
+        if (strcmp(robots[i].mpd_file, world->scene.robots[robot.scene_index].mpd_file) != 0 ||
+            robots[i].wheel_count != (uint32_t)robot.wheel_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool replay_matches_world(const ReplayReader* reader, const SimWorld* world) {
+    return reader->header &&
+           replay_robots_match(reader->robots, reader->header->robot_count, reader->header->cylinder_count, world);
+}
+
+void replay_apply_frame(const ReplayFrame* frame, SimWorld* world) {
+    size_t robot_count = std::min(frame->robots.size(), world->robots.size());
+    for (size_t i = 0; i < robot_count; i++) {
+        RobotInstance& robot = world->robots[i];
+        const ReplayRobotFrame& state = frame->robots[i];
+        robot.drivetrain.pos_x = state.x;
+        robot.drivetrain.pos_z = state.z;
+        robot.drivetrain.heading = state.heading;
+        robot.offset[0] = state.x;
+        robot.offset[2] = state.z;
+        robot.rotation_y = state.heading;
+        for (int w = 0; w < robot.wheel_count; w++) robot.wheels[w].spin_angle = state.wheel_spin[w];
+        if (frame->hud) {
+            robot.drivetrain.left_motor_pct = state.motor_pct[0];
+            robot.drivetrain.right_motor_pct = state.motor_pct[1];
+            robot.drivetrain.left_wheel_vel = state.wheel_vel[0];
+            robot.drivetrain.right_wheel_vel = state.wheel_vel[1];
+        }
+    }
+
+    uint32_t cylinder_count = std::min((uint32_t)(frame->cylinders.size() / 2), world->scene.cylinder_count);
+    for (uint32_t c = 0; c < cylinder_count; c++) {
+        world->scene.cylinders[c].x = frame->cylinders[c * 2];
+        world->scene.cylinders[c].z = frame->cylinders[c * 2 + 1];
+    }
+}
@@ -0,0 +1,231 @@
+/*
+ * Simulation Thread Implementation
+ */
+
+#include "sim_thread.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// State of one robot after a step
+struct SimRobotSnapshot {
+    Drivetrain drivetrain;
+    float wheel_spin[ROBOTDEF_MAX_WHEELS];
+    uint32_t joint_first;                  // First of its angles in SimSnapshot::joint_angles
+};
+
+// Published state after a step
+struct SimSnapshot {
+    double time;                           // Simulated seconds
+    double wall_time;                      // When it was published (sim_clock)
+    std::vector<SimRobotSnapshot> robots;  // Indexed like SimWorld::robots
+    std::vector<float> joint_angles;       // Of each robot's moving submodels (RobotInstance::joint_order)
+    std::vector<float> cylinders;          // x, z per cylinder
+    SimStepStats stats;                    // Counters of the step
+};
+
+struct SimThread {
+    SimWorld* world;
+    float dt;
+    SimThreadControlFn control;
+    void* user_data;
+    std::thread thread;
+
+    std::mutex lock;
+    std::condition_variable wake;          // Interrupts the step sleep on stop
+    bool quit = false;
+    SimSnapshot snapshots[2];              // Guarded by lock
+    int newest = 0;
+    SimSnapshot scratch;                   // Filled by the sim thread outside the lock
+    std::atomic<float> step_rate{0.0f};
+
+    SimSnapshot render_prev, render_next;  // Render thread copies
+};
+
+static double sim_clock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void capture_snapshot(const SimWorld* world, SimSnapshot* snapshot) {
+    snapshot->time = world->time;
+    snapshot->stats = world->stats;
+    snapshot->robots.resize(world->robots.size());
+    snapshot->joint_angles.clear();
+    for (size_t i = 0; i < world->robots.size(); i++) {
+        const RobotInstance& robot = world->robots[i];
+        SimRobotSnapshot& out = snapshot->robots[i];
+        out.drivetrain = robot.drivetrain;
+        for (int w = 0; w < robot.wheel_count; w++) out.wheel_spin[w] = robot.wheels[w].spin_angle;
+        out.joint_first = (uint32_t)snapshot->joint_angles.size();
+        for (int k = 0; k < robot.joint_order_count; k++) {
+            snapshot->joint_angles.push_back(robot.submodel_joints[robot.joint_order[k]].angle);
+        }
+    }
+    snapshot->cylinders.resize(world->scene.cylinder_count * 2);
+    for (uint32_t c = 0; c < world->scene.cylinder_count; c++) {
+        snapshot->cylinders[c * 2] = world->scene.cylinders[c].x;
+        snapshot->cylinders[c * 2 + 1] = world->scene.cylinders[c].z;
+    }
+}
+
+// Swap the scratch snapshot in as the newest one
+static void publish_snapshot(SimThread* thread) {
+    thread->scratch.wall_time = sim_clock();
+    std::lock_guard<std::mutex> guard(thread->lock);
+    int older = 1 - thread->newest;
+    std::swap(thread->snapshots[older], thread->scratch);
+    thread->newest = older;
+}
+
+static void sim_thread_main(SimThread* thread) {
+    profiler_set_thread_name("sim");
+    double next = sim_clock();
+    double rate_start = next;
+    int rate_steps = 0;
+
+    for (;;) {
+        if (thread->control) thread->control(thread->user_data, thread->world, thread->dt);
+        sim_world_step(thread->world, thread->dt);
+        capture_snapshot(thread->world, &thread->scratch);
+        publish_snapshot(thread);
+
+        double now = sim_clock();
+        rate_steps++;
+        if (now - rate_start >= 0.5) {
+            thread->step_rate.store((float)(rate_steps / (now - rate_start)), std::memory_order_relaxed);
+            rate_start = now;
+            rate_steps = 0;
+        }
+
+        // Sleep until the next step is due; after a long stall (debugger,
+        // slow program tick) drop the backlog instead of fast-forwarding it
+        next += thread->dt;
+        if (now - next > SIM_THREAD_MAX_LAG) next = now;
+
+        std::unique_lock<std::mutex> guard(thread->lock);
+        auto deadline = std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(next)));
+        thread->wake.wait_until(guard, deadline, [thread] { return thread->quit; });
+        if (thread->quit) break;
+    }
+}
+
+SimThread* sim_thread_start(SimWorld* world, float rate_hz, SimThreadControlFn control, void* user_data) {
+    if (!world) return NULL;
+    if (rate_hz <= 0.0f) rate_hz = SIM_THREAD_DEFAULT_RATE;
+
+    SimThread* thread = new SimThread();
+    thread->world = world;
+    thread->dt = 1.0f / rate_hz;
+    thread->control = control;
+    thread->user_data = user_data;
+
+    // Both snapshots start at the current state so the first frame has something to draw
+    capture_snapshot(world, &thread->snapshots[0]);
+    thread->snapshots[0].wall_time = sim_clock();
+    thread->snapshots[1] = thread->snapshots[0];
+
+    try {
+        thread->thread = std::thread(sim_thread_main, thread);
+    } catch (const std::system_error&) {
+        fprintf(stderr, "[SimThread] Failed to start simulation thread\n");
+        delete thread;
+        return NULL;
+    }
+
+    printf("[SimThread] Stepping at %.0f Hz (dt=%.5f s)\n", rate_hz, thread->dt);
+    return thread;
+}
+
+void sim_thread_stop(SimThread* thread) {
+    if (!thread) return;
+    {
+        std::lock_guard<std::mutex> guard(thread->lock);
+        thread->quit = true;
+    }
+    thread->wake.notify_all();
+    thread->thread.join();
+    delete thread;
+}
+
+// Shortest signed difference b - a of two angles (radians)
+static float angle_delta(float a, float b) {
+    float d = fmodf(b - a, 6.28318530718f);
+    if (d > 3.14159265359f) d -= 6.28318530718f;
+    if (d < -3.14159265359f) d += 6.28318530718f;
+    return d;
+}
+
+double sim_thread_interpolate(SimThread* thread, SimWorld* render_world) {
+    {
+        std::lock_guard<std::mutex> guard(thread->lock);
+        thread->render_prev = thread->snapshots[1 - thread->newest];
+        thread->render_next = thread->snapshots[thread->newest];
+    }
+    const SimSnapshot& prev = thread->render_prev;
+    const SimSnapshot& next = thread->render_next;
+
+    // Blend from prev to next over one step after next was published
+    float t = (float)((sim_clock() - next.wall_time) / thread->dt);
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+
+    size_t robot_count = render_world->robots.size();
+    if (robot_count > next.robots.size()) robot_count = next.robots.size();
+    if (robot_count > prev.robots.size()) robot_count = prev.robots.size();
+    for (size_t i = 0; i < robot_count; i++) {
+        RobotInstance& robot = render_world->robots[i];
+        const SimRobotSnapshot& a = prev.robots[i];
+        const SimRobotSnapshot& b = next.robots[i];
+
+        // Telemetry from the newest step, pose blended
+        robot.drivetrain = b.drivetrain;
+        robot.drivetrain.pos_x = a.drivetrain.pos_x + (b.drivetrain.pos_x - a.drivetrain.pos_x) * t;
+        robot.drivetrain.pos_z = a.drivetrain.pos_z + (b.drivetrain.pos_z - a.drivetrain.pos_z) * t;
+        robot.drivetrain.heading = a.drivetrain.heading + angle_delta(a.drivetrain.heading, b.drivetrain.heading) * t;
+        robot.offset[0] = robot.drivetrain.pos_x;
+        robot.offset[2] = robot.drivetrain.pos_z;
+        robot.rotation_y = robot.drivetrain.heading;
+        for (int w = 0; w < robot.wheel_count; w++) {
+            robot.wheels[w].spin_angle = a.wheel_spin[w] + angle_delta(a.wheel_spin[w], b.wheel_spin[w]) * t;
+        }
+        size_t joints = (size_t)robot.joint_order_count;
+        if (a.joint_first + joints > prev.joint_angles.size() || b.joint_first + joints > next.joint_angles.size()) {
+            joints = 0;
+        }
+        const float* a_angles = prev.joint_angles.data() + a.joint_first;
+        const float* b_angles = next.joint_angles.data() + b.joint_first;
+        for (size_t k = 0; k < joints; k++) {
+            float angle = a_angles[k] + (b_angles[k] - a_angles[k]) * t;
+            sim_world_set_joint_angle(render_world, (int)i, robot.joint_order[k], angle);
+        }
+    }
+
+    uint32_t cylinder_count = render_world->scene.cylinder_count;
+    if (cylinder_count * 2 > next.cylinders.size()) cylinder_count = (uint32_t)(next.cylinders.size() / 2);
+    if (cylinder_count * 2 > prev.cylinders.size()) cylinder_count = (uint32_t)(prev.cylinders.size() / 2);
+    for (uint32_t c = 0; c < cylinder_count; c++) {
+        SceneCylinder* cyl = &render_world->scene.cylinders[c];
+        cyl->x = prev.cylinders[c * 2] + (next.cylinders[c * 2] - prev.cylinders[c * 2]) * t;
+        cyl->z = prev.cylinders[c * 2 + 1] + (next.cylinders[c * 2 + 1] - prev.cylinders[c * 2 + 1]) * t;
+    }
+
+    render_world->stats = next.stats;
+    return prev.time + (next.time - prev.time) * t;
+}
+
+float sim_thread_dt(const SimThread* thread) {
+    return thread->dt;
+}
+
+float sim_thread_step_rate(const SimThread* thread) {
+    return thread->step_rate.load(std::memory_order_relaxed);
+}
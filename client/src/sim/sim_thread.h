@@ -0,0 +1,62 @@
+/*
+ * Simulation Thread
+ * Steps a world at a fixed rate on its own thread and publishes robot and
+ * cylinder state snapshots for a render thread to interpolate.
+ *
+ * Physics never sees the frame time: every step is 1/rate_hz seconds, so
+ * robot programs and collision response behave the same whether frames take
+ * 7 ms or 33 ms, and vsync stalls no longer slow the simulation. After each
+ * step the thread publishes a snapshot (drivetrain state, wheel spin,
+ * cylinder positions and step counters); the two newest are kept.
+ * sim_thread_interpolate() blends them by how far wall time has advanced into
+ * the next step, so the picture runs one step behind the simulation but moves
+ * smoothly at any frame rate.
+ *
+ * The stepped world belongs to the thread from sim_thread_start() until
+ * sim_thread_stop(). The render thread poses its own world (normally the
+ * template a shared sim world was created from, which has the render tables)
+ * from snapshots and never touches the stepped one.
+ *
+ * Usage:
+ *   sim_world_create_shared(&sim, &world, &scene);
+ *   SimThread* thread = sim_thread_start(&sim, 240.0f, control_fn, user_data);
+ *   while (running) {
+ *       sim_thread_interpolate(thread, &world);   // once per frame
+ *       draw(&world);
+ *   }
+ *   sim_thread_stop(thread);
+ */
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "sim_world.h"
+
+#define SIM_THREAD_DEFAULT_RATE 240.0f
+#define SIM_THREAD_MAX_LAG 0.1   // Seconds behind wall time before the thread stops catching up
+
+// Called on the simulation thread before every step (set motors, tick robot programs)
+typedef void (*SimThreadControlFn)(void* user_data, SimWorld* world, float dt);
+
+struct SimThread;
+
+// Start stepping world at rate_hz (<= 0 = SIM_THREAD_DEFAULT_RATE).
+// control may be NULL. Returns NULL if the thread can't be started.
+SimThread* sim_thread_start(SimWorld* world, float rate_hz, SimThreadControlFn control, void* user_data);
+
+// Stop and join the thread (NULL is ignored); world is the caller's again
+void sim_thread_stop(SimThread* thread);
+
+// Pose render_world's robots and cylinders between the two newest snapshots
+// and copy the newest step's counters to render_world->stats.
+// render_world must hold the same robots and cylinders as the stepped world.
+// Returns the simulated time shown.
+double sim_thread_interpolate(SimThread* thread, SimWorld* render_world);
+
+// Fixed step in seconds
+float sim_thread_dt(const SimThread* thread);
+
+// Physics steps per wall second over roughly the last half second
+float sim_thread_step_rate(const SimThread* thread);
+
+#endif // SIM_THREAD_H
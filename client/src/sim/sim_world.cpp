@@ -0,0 +1,2619 @@
+/*
+ * Simulation World Implementation
+ *
+ * Loading, hierarchical OBB collision (submodel broad-phase, part
+ * narrow-phase), collision response and cylinder physics.
+ */
+
+#include "sim_world.h"
+#include "../render/mpd_loader.h"
+#include "../render/glb_loader.h"
+#include "../render/mesh_cache.h"
+#include "../render/load_jobs.h"
+#include "profiler.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>  // std::fill
+#include <cfloat>  // FLT_MAX
+#include <cmath>   // cosf, sinf
+
+#ifdef _WIN32
+#define PATH_SEP "\\"
+#else
+#define PATH_SEP "/"
+#endif
+
+// Degrees to radians conversion
+#define DEG_TO_RAD_CONST (3.14159265359f / 180.0f)
+
+// Load arena chunk (part names and lookups; grows for large robots)
+#define SIM_LOAD_ARENA_SIZE (64 * 1024)
+
+// Convert .dat part name to .glb path (copied into the load arena)
+static const char* part_name_to_glb(Arena* load, const char* part_name) {
+    char* name = arena_strdup(load, part_name);
+    // Replace .dat with .glb (case insensitive)
+    char* ext = NULL;
+    for (char* p = strstr(name, ".dat"); p; p = strstr(p + 1, ".dat")) ext = p;
+    if (!ext) {
+        for (char* p = strstr(name, ".DAT"); p; p = strstr(p + 1, ".DAT")) ext = p;
+    }
+    if (ext) strcpy(ext, ".glb");
+    return name;
+}
+
+// Orders load-arena strings by content
+struct CStringLess {
+    bool operator()(const char* a, const char* b) const { return strcmp(a, b) < 0; }
+};
+
+// Interned id of a part number ("228-2500-208.dat" and "228-2500-208c01.dat" -> "228-2500-208")
+static int intern_part_number(SimWorld* world, const char* part_name) {
+    std::string number(part_name);
+    // Strip .dat extension
+    size_t dot = number.rfind('.');
+    if (dot != std::string::npos) number.resize(dot);
+    // Strip c## suffix (LDraw composite parts)
+    size_t len = number.size();
+    if (len > 3 && number[len-3] == 'c' &&
+        isdigit((unsigned char)number[len-2]) && isdigit((unsigned char)number[len-1])) {
+        number.resize(len - 3);
+    }
+
+    auto it = world->part_number_ids.find(number);
+    if (it != world->part_number_ids.end()) return it->second;
+    int id = (int)world->part_numbers.size();
+    world->part_numbers.push_back(number);
+    world->part_number_ids.emplace(number, id);
+    return id;
+}
+
+// Compute ground offset for a robot from the bounding boxes of its parts
+// Finds the minimum Y value across parts[first .. end)
+static float compute_ground_offset(const std::vector<PartInfo>& parts, size_t first, size_t end) {
+    float min_y = FLT_MAX;
+
+    for (size_t pi = first; pi < end && pi < parts.size(); pi++) {
+        const PartInfo& part = parts[pi];
+
+        // Transform local bounding box to world space using the same transform as rendering
+        // Apply C*M*C rotation (flip Y and Z)
+        float d = part.rotation[3], e = part.rotation[4], f = part.rotation[5];
+        float d2 = -d, e2 = e,  f2 = f;  // Only need row 2 for Y calculation
+
+        // Transform all 8 corners of bounding box to find true minimum Y
+        float min_x = part.min_bounds[0], max_x = part.max_bounds[0];
+        float min_y_local = part.min_bounds[1], max_y_local = part.max_bounds[1];
+        float min_z = part.min_bounds[2], max_z = part.max_bounds[2];
+
+        float corners[8][3];
+        int idx = 0;
+        for (int xi = 0; xi < 2; xi++) {
+            for (int yi = 0; yi < 2; yi++) {
+                for (int zi = 0; zi < 2; zi++) {
+                    corners[idx][0] = (xi == 0) ? min_x : max_x;
+                    corners[idx][1] = (yi == 0) ? min_y_local : max_y_local;
+                    corners[idx][2] = (zi == 0) ? min_z : max_z;
+                    idx++;
+                }
+            }
+        }
+
+        // Transform each corner and find minimum Y
+        for (int ci = 0; ci < 8; ci++) {
+            float lx = corners[ci][0], ly = corners[ci][1], lz = corners[ci][2];
+
+            // Rotated point (using transformed rotation matrix)
+            float ry = d2 * lx + e2 * ly + f2 * lz;
+
+            // World Y = rotated Y + translated Y (without ground offset)
+            float world_y = ry + (-part.position[1] * LDU_SCALE);
+
+            if (world_y < min_y) {
+                min_y = world_y;
+            }
+        }
+    }
+
+    // Return offset to lift robot so min_y becomes 0
+    return (min_y == FLT_MAX) ? 0.0f : -min_y;
+}
+
+// Compute a part's local OBB in robot-local OpenGL coordinates
+// This transforms the asset's mesh-space OBB by the part's LDraw transform,
+// converts to OpenGL coordinates, and makes it relative to the robot's rotation center
+static void compute_part_local_obb(const PartInfo* part, const SimPartAsset* asset, PartCollision* collision,
+                                   const float* rotation_center_ldu) {
+    // LDraw rotation matrix (row-major)
+    float a = part->rotation[0], b = part->rotation[1], c = part->rotation[2];
+    float d = part->rotation[3], e = part->rotation[4], f = part->rotation[5];
+    float g = part->rotation[6], h = part->rotation[7], i = part->rotation[8];
+
+    // Convert rotation from LDraw to OpenGL: C*M*C where C = diag(1,-1,-1)
+    float a2 = a,  b2 = -b, c2 = -c;
+    float d2 = -d, e2 = e,  f2 = f;
+    float g2 = -g, h2 = h,  i2 = i;
+
+    // Store converted rotation in OBB (row-major)
+    collision->local_obb.rotation[0] = a2; collision->local_obb.rotation[1] = b2; collision->local_obb.rotation[2] = c2;
+    collision->local_obb.rotation[3] = d2; collision->local_obb.rotation[4] = e2; collision->local_obb.rotation[5] = f2;
+    collision->local_obb.rotation[6] = g2; collision->local_obb.rotation[7] = h2; collision->local_obb.rotation[8] = i2;
+
+    // Half extents don't change - they're in local mesh space
+    collision->local_obb.half_extents = vec3(asset->half_extents[0], asset->half_extents[1], asset->half_extents[2]);
+
+    // Center of mesh bounds (in mesh local space)
+    Vec3 mesh_center = vec3(asset->center[0], asset->center[1], asset->center[2]);
+
+    // Transform mesh center by part rotation (in OpenGL space)
+    float cx = a2 * mesh_center.x + b2 * mesh_center.y + c2 * mesh_center.z;
+    float cy = d2 * mesh_center.x + e2 * mesh_center.y + f2 * mesh_center.z;
+    float cz = g2 * mesh_center.x + h2 * mesh_center.y + i2 * mesh_center.z;
+
+    // Part position converted from LDraw to OpenGL, relative to rotation center
+    float px = (part->position[0] - rotation_center_ldu[0]) * LDU_SCALE;
+    float py = -(part->position[1] - rotation_center_ldu[1]) * LDU_SCALE;  // Y flipped
+    float pz = -(part->position[2] - rotation_center_ldu[2]) * LDU_SCALE;  // Z flipped
+
+    // Final center = part position + rotated mesh center
+    collision->local_obb.center.x = px + cx;
+    collision->local_obb.center.y = py + cy;
+    collision->local_obb.center.z = pz + cz;
+}
+
+// Compute submodel OBB by combining all part OBBs in that submodel
+// Uses AABB encompassing all parts, then creates OBB with identity rotation
+static void compute_submodel_obb(RobotInstance* robot, int submodel_idx,
+                                  const std::vector<PartCollision>& parts) {
+    if (submodel_idx < 0 || submodel_idx >= robot->submodel_count) return;
+
+    int start = robot->submodel_part_start[submodel_idx];
+    int count = robot->submodel_part_count[submodel_idx];
+
+    if (count == 0) {
+        // Empty submodel
+        robot->submodel_obbs[submodel_idx].center = vec3(0, 0, 0);
+        robot->submodel_obbs[submodel_idx].half_extents = vec3(0, 0, 0);
+        return;
+    }
+
+    // Find AABB encompassing all parts in this submodel
+    float min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
+    float max_x = -FLT_MAX, max_y = -FLT_MAX, max_z = -FLT_MAX;
+
+    for (int i = 0; i < count; i++) {
+        size_t part_idx = robot->parts_start_index + start + i;
+        if (part_idx >= parts.size()) continue;
+
+        const PartCollision& part = parts[part_idx];
+
+        // Get corners of part OBB
+        Vec3 corners[8];
+        obb_get_corners(&part.local_obb, corners);
+
+        for (int c = 0; c < 8; c++) {
+            if (corners[c].x < min_x) min_x = corners[c].x;
+            if (corners[c].y < min_y) min_y = corners[c].y;
+            if (corners[c].z < min_z) min_z = corners[c].z;
+            if (corners[c].x > max_x) max_x = corners[c].x;
+            if (corners[c].y > max_y) max_y = corners[c].y;
+            if (corners[c].z > max_z) max_z = corners[c].z;
+        }
+    }
+
+    // Create AABB-style OBB (identity rotation)
+    OBB* obb = &robot->submodel_obbs[submodel_idx];
+    obb->center.x = (min_x + max_x) * 0.5f;
+    obb->center.y = (min_y + max_y) * 0.5f;
+    obb->center.z = (min_z + max_z) * 0.5f;
+    obb->half_extents.x = (max_x - min_x) * 0.5f;
+    obb->half_extents.y = (max_y - min_y) * 0.5f;
+    obb->half_extents.z = (max_z - min_z) * 0.5f;
+
+    // Identity rotation (submodel OBB is axis-aligned in robot local space)
+    obb->rotation[0] = 1; obb->rotation[1] = 0; obb->rotation[2] = 0;
+    obb->rotation[3] = 0; obb->rotation[4] = 1; obb->rotation[5] = 0;
+    obb->rotation[6] = 0; obb->rotation[7] = 0; obb->rotation[8] = 1;
+}
+
+// =============================================================================
+// Transform Cache
+// Part world matrices and OBBs are rebuilt lazily: a robot's pose_version is
+// bumped only when its offset/rotation actually change, and each part
+// remembers which version its cached world data was built for.
+// =============================================================================
+
+// Build a part's robot-local model matrix (column-major, OpenGL coordinates)
+// Converts LDraw position/rotation to OpenGL, applies wheel spin, and makes
+// the position relative to the robot's rotation center.
+// World matrix = robot Y rotation + translation applied to this matrix.
+static void build_part_local_matrix(const PartInfo* part, const RobotInstance* robot,
+                                    const WheelAssembly* wheel, float* out) {
+    // LDraw rotation matrix is row-major: [a b c] [d e f] [g h i]
+    const float* rot = part->rotation;
+    float a = rot[0], b = rot[1], c = rot[2];
+    float d = rot[3], e = rot[4], f = rot[5];
+    float g = rot[6], h = rot[7], i = rot[8];
+
+    // Apply wheel spin rotation if present (before robot rotation)
+    // Only rotate the orientation matrix - wheels spin in place, position doesn't change
+    if (wheel && wheel->spin_angle != 0.0f) {
+        // Rotation axis (already normalized)
+        float ax = wheel->spin_axis[0];
+        float ay = wheel->spin_axis[1];
+        float az = wheel->spin_axis[2];
+
+        float cos_a = cosf(wheel->spin_angle);
+        float sin_a = sinf(wheel->spin_angle);
+        float one_minus_cos = 1.0f - cos_a;
+
+        // Rotate the orientation matrix using Rodrigues' formula
+        // For each column of the rotation matrix, rotate it around the axis
+        // Column 0 (a, d, g)
+        float c0_cross_x = ay * g - az * d;
+        float c0_cross_y = az * a - ax * g;
+        float c0_cross_z = ax * d - ay * a;
+        float c0_dot = ax * a + ay * d + az * g;
+        float na = a * cos_a + c0_cross_x * sin_a + ax * c0_dot * one_minus_cos;
+        float nd = d * cos_a + c0_cross_y * sin_a + ay * c0_dot * one_minus_cos;
+        float ng = g * cos_a + c0_cross_z * sin_a + az * c0_dot * one_minus_cos;
+
+        // Column 1 (b, e, h)
+        float c1_cross_x = ay * h - az * e;
+        float c1_cross_y = az * b - ax * h;
+        float c1_cross_z = ax * e - ay * b;
+        float c1_dot = ax * b + ay * e + az * h;
+        float nb = b * cos_a + c1_cross_x * sin_a + ax * c1_dot * one_minus_cos;
+        float ne = e * cos_a + c1_cross_y * sin_a + ay * c1_dot * one_minus_cos;
+        float nh = h * cos_a + c1_cross_z * sin_a + az * c1_dot * one_minus_cos;
+
+        // Column 2 (c, f, i)
+        float c2_cross_x = ay * i - az * f;
+        float c2_cross_y = az * c - ax * i;
+        float c2_cross_z = ax * f - ay * c;
+        float c2_dot = ax * c + ay * f + az * i;
+        float nc = c * cos_a + c2_cross_x * sin_a + ax * c2_dot * one_minus_cos;
+        float nf = f * cos_a + c2_cross_y * sin_a + ay * c2_dot * one_minus_cos;
+        float ni = i * cos_a + c2_cross_z * sin_a + az * c2_dot * one_minus_cos;
+
+        a = na; b = nb; c = nc;
+        d = nd; e = ne; f = nf;
+        g = ng; h = nh; i = ni;
+    }
+
+    // Convert from LDraw to OpenGL coordinates
+    // LDraw: Y-down, Z-back; OpenGL: Y-up, Z-front
+    // Apply coordinate change: C * M * C where C = diag(1, -1, -1)
+    // (the robot's LDraw Y rotation becomes an OpenGL Y rotation under C,
+    //  so it can be applied afterwards in world space)
+    float a2 = a,  b2 = -b, c2 = -c;
+    float d2 = -d, e2 = e,  f2 = f;
+    float g2 = -g, h2 = h,  i2 = i;
+
+    // Position relative to the rotation center, in OpenGL coordinates
+    float px = part->position[0];
+    float py = part->position[1];
+    float pz = part->position[2];
+    if (robot) {
+        px -= robot->rotation_center[0];
+        py -= robot->rotation_center[1];
+        pz -= robot->rotation_center[2];
+    }
+
+    // OpenGL column-major matrix
+    out[0]  = a2; out[1]  = d2; out[2]  = g2; out[3]  = 0;
+    out[4]  = b2; out[5]  = e2; out[6]  = h2; out[7]  = 0;
+    out[8]  = c2; out[9]  = f2; out[10] = i2; out[11] = 0;
+    out[12] = px * LDU_SCALE;
+    out[13] = -py * LDU_SCALE;
+    out[14] = -pz * LDU_SCALE;
+    out[15] = 1;
+}
+
+uint32_t sim_robot_update_transform(RobotInstance* robot) {
+    float y = robot->offset[1] + robot->ground_offset;
+    if (robot->pose_version != 0 &&
+        robot->pose_x == robot->offset[0] && robot->pose_y == y &&
+        robot->pose_z == robot->offset[2] && robot->pose_rotation_y == robot->rotation_y) {
+        return robot->pose_version;
+    }
+
+    robot->pose_x = robot->offset[0];
+    robot->pose_y = y;
+    robot->pose_z = robot->offset[2];
+    robot->pose_rotation_y = robot->rotation_y;
+    mat3_rotation_y(robot->rotation_y, robot->world_rotation);
+
+    // Skip 0 on wrap - it marks cache entries as never built
+    robot->pose_version++;
+    if (robot->pose_version == 0) robot->pose_version = 1;
+    return robot->pose_version;
+}
+
+void sim_robot_update_joints(RobotInstance* robot) {
+    if (!robot->joints_dirty) return;
+    robot->joints_dirty = false;
+
+    // Parents come first, so a moved parent is rebuilt before its children
+    uint8_t* moved = robot->joint_moved.data();
+    std::fill(robot->joint_moved.begin(), robot->joint_moved.end(), 0);
+    for (int k = 0; k < robot->joint_order_count; k++) {
+        int sm = robot->joint_order[k];
+        SubmodelJoint* joint = &robot->submodel_joints[sm];
+        bool parent_moved = joint->parent >= 0 && moved[joint->parent];
+        if (!joint->dirty && !parent_moved) continue;
+        joint->dirty = false;
+
+        // Own rotation about the pivot: p' = R (p - o) + o
+        float rotation[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+        if (joint->axis[0] != 0.0f || joint->axis[1] != 0.0f || joint->axis[2] != 0.0f) {
+            mat3_rotation_axis(joint->axis, joint->angle, rotation);
+        }
+        const float* o = joint->origin;
+        float translation[3];
+        for (int r = 0; r < 3; r++) {
+            translation[r] = o[r] - (rotation[r * 3] * o[0] + rotation[r * 3 + 1] * o[1] + rotation[r * 3 + 2] * o[2]);
+        }
+
+        // Then the parent's transform
+        if (joint->parent >= 0) {
+            const SubmodelJoint* parent = &robot->submodel_joints[joint->parent];
+            mat3_multiply(parent->rotation, rotation, joint->rotation);
+            const float* pr = parent->rotation;
+            for (int r = 0; r < 3; r++) {
+                joint->translation[r] = pr[r * 3] * translation[0] + pr[r * 3 + 1] * translation[1] +
+                                        pr[r * 3 + 2] * translation[2] + parent->translation[r];
+            }
+        } else {
+            memcpy(joint->rotation, rotation, sizeof(rotation));
+            memcpy(joint->translation, translation, sizeof(translation));
+        }
+
+        // Skip 0 on wrap - it marks the rest pose
+        joint->version++;
+        if (joint->version == 0) joint->version = 1;
+        moved[sm] = true;
+    }
+}
+
+// Apply a submodel's joint transform to a robot-local model matrix (column-major)
+static void apply_joint_matrix(const SubmodelJoint* joint, float* m) {
+    const float* r = joint->rotation;  // row-major
+    for (int col = 0; col < 4; col++) {
+        float x = m[col * 4 + 0], y = m[col * 4 + 1], z = m[col * 4 + 2];
+        m[col * 4 + 0] = r[0] * x + r[1] * y + r[2] * z;
+        m[col * 4 + 1] = r[3] * x + r[4] * y + r[5] * z;
+        m[col * 4 + 2] = r[6] * x + r[7] * y + r[8] * z;
+    }
+    m[12] += joint->translation[0];
+    m[13] += joint->translation[1];
+    m[14] += joint->translation[2];
+}
+
+const OBB* sim_submodel_world_obb(RobotInstance* robot, int submodel_idx) {
+    uint32_t version = sim_robot_update_transform(robot);
+    if (robot->submodel_obb_version[submodel_idx] != version) {
+        Vec3 pos = vec3(robot->pose_x, robot->pose_y, robot->pose_z);
+        obb_transform_matrix(&robot->submodel_obbs[submodel_idx], pos, robot->world_rotation,
+                             &robot->submodel_world_obbs[submodel_idx]);
+        robot->submodel_obb_version[submodel_idx] = version;
+    }
+    return &robot->submodel_world_obbs[submodel_idx];
+}
+
+const OBB* sim_part_world_obb(RobotInstance* robot, PartCollision* part) {
+    uint32_t version = sim_robot_update_transform(robot);
+    if (part->obb_version != version) {
+        Vec3 pos = vec3(robot->pose_x, robot->pose_y, robot->pose_z);
+        obb_transform_matrix(&part->local_obb, pos, robot->world_rotation, &part->world_obb);
+        part->obb_version = version;
+    }
+    return &part->world_obb;
+}
+
+const float* sim_part_world_matrix(SimWorld* world, size_t part_index) {
+    PartTransform* part = &world->parts.transforms[part_index];
+    RobotInstance* robot = nullptr;
+    const WheelAssembly* wheel = nullptr;
+    if (part->robot_index >= 0 && part->robot_index < (int)world->robots.size()) {
+        robot = &world->robots[part->robot_index];
+        // Get wheel assembly if this is a wheel part
+        if (part->wheel_index >= 0 && part->wheel_index < robot->wheel_count) {
+            wheel = &robot->wheels[part->wheel_index];
+        }
+    }
+
+    // Parts of a moved submodel follow its joint
+    const SubmodelJoint* joint = nullptr;
+    if (robot && robot->joint_order_count > 0) {
+        sim_robot_update_joints(robot);
+        int sm = world->parts.collision[part_index].submodel_index;
+        if (sm >= 0 && robot->submodel_joints[sm].version != part->joint_version) joint = &robot->submodel_joints[sm];
+    }
+
+    // Wheel parts rebuild their local matrix when the spin angle changes
+    bool local_changed = false;
+    if ((wheel && part->local_spin != wheel->spin_angle) || joint) {
+        build_part_local_matrix(&world->parts.info[part_index], robot, wheel, part->local_matrix);
+        int sm = world->parts.collision[part_index].submodel_index;
+        if (sm >= 0 && robot->submodel_joints[sm].version != 0) {
+            apply_joint_matrix(&robot->submodel_joints[sm], part->local_matrix);
+        }
+        if (sm >= 0) part->joint_version = robot->submodel_joints[sm].version;
+        if (wheel) part->local_spin = wheel->spin_angle;
+        local_changed = true;
+    }
+
+    if (!robot) {
+        return part->local_matrix;
+    }
+
+    uint32_t version = sim_robot_update_transform(robot);
+    if (part->matrix_version == version && !local_changed) {
+        return part->world_matrix;
+    }
+
+    // world = [R_y | robot position] * local
+    const float* r = robot->world_rotation;  // row-major
+    const float* l = part->local_matrix;     // column-major
+    float* m = part->world_matrix;
+    for (int col = 0; col < 3; col++) {
+        float x = l[col * 4 + 0], y = l[col * 4 + 1], z = l[col * 4 + 2];
+        m[col * 4 + 0] = r[0] * x + r[1] * y + r[2] * z;
+        m[col * 4 + 1] = r[3] * x + r[4] * y + r[5] * z;
+        m[col * 4 + 2] = r[6] * x + r[7] * y + r[8] * z;
+        m[col * 4 + 3] = 0.0f;
+    }
+    float tx = l[12], ty = l[13], tz = l[14];
+    m[12] = r[0] * tx + r[1] * ty + r[2] * tz + robot->pose_x;
+    m[13] = r[3] * tx + r[4] * ty + r[5] * tz + robot->pose_y;
+    m[14] = r[6] * tx + r[7] * ty + r[8] * tz + robot->pose_z;
+    m[15] = 1.0f;
+
+    part->matrix_version = version;
+    return part->world_matrix;
+}
+
+// =============================================================================
+// Submodel Joints
+// A joint angle change only marks the joint dirty. The next step rebuilds the
+// transforms of the dirty submodels and their children, then refits just
+// those submodels: part local OBBs from their rest pose, the submodel's part
+// tree and its OBB. The robot footprint follows at the next broad-phase build
+// (shape_version tells the contact cache it changed).
+// =============================================================================
+
+static void refit_robot_joints(SimWorld* world, RobotInstance* robot) {
+    if (robot->joint_order_count == 0) return;
+    sim_robot_update_joints(robot);
+
+    const std::vector<OBB>& rest_obbs = world->shared ? world->shared->parts.rest_obbs : world->parts.rest_obbs;
+    std::vector<PartCollision>& parts = world->parts.collision;
+    for (int k = 0; k < robot->joint_order_count; k++) {
+        int sm = robot->joint_order[k];
+        SubmodelJoint* joint = &robot->submodel_joints[sm];
+        if (joint->refit_version == joint->version) continue;
+        joint->refit_version = joint->version;
+
+        Vec3 translation = vec3(joint->translation[0], joint->translation[1], joint->translation[2]);
+        size_t first = robot->parts_start_index + robot->submodel_part_start[sm];
+        for (int i = 0; i < robot->submodel_part_count[sm]; i++) {
+            PartCollision& part = parts[first + i];
+            obb_transform_matrix(&rest_obbs[first + i], translation, joint->rotation, &part.local_obb);
+            part.obb_version = 0;
+        }
+
+        int root = robot->submodel_bvh_root[sm];
+        if (root >= 0) {
+            part_bvh_refit(&world->part_bvh, parts, root);
+            const AABB& bounds = world->part_bvh.nodes[root].bounds;
+            obb_from_bounds(&robot->submodel_obbs[sm], bounds.min, bounds.max);
+        }
+        robot->submodel_obb_version[sm] = 0;
+        robot->shape_version++;
+    }
+}
+
+// LDraw submodel and part names ignore case
+static bool names_equal(const char* a, const char* b) {
+    while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) { a++; b++; }
+    return *a == '\0' && *b == '\0';
+}
+
+// Match a robotdef submodel name to a loaded one
+static int find_submodel(const RobotNames* names, int submodel_count, const char* name) {
+    for (int sm = 0; sm < submodel_count; sm++) {
+        if (names_equal(names->submodel_names[sm].c_str(), name)) return sm;
+    }
+    return -1;
+}
+
+// Robotdef pivots are LDU relative to their submodel, whose position is
+// relative to its parent (placements are assumed unrotated)
+static void robotdef_submodel_origin(const RobotDef* def, const RobotDefSubmodel* sub, float* out) {
+    out[0] = sub->rotation_origin[0];
+    out[1] = sub->rotation_origin[1];
+    out[2] = sub->rotation_origin[2];
+    for (int depth = 0; sub && depth <= def->submodel_count; depth++) {   // Bounded against parent cycles
+        out[0] += sub->position[0];
+        out[1] += sub->position[1];
+        out[2] += sub->position[2];
+        sub = sub->parent[0] ? robotdef_get_submodel(def, sub->parent) : nullptr;
+    }
+}
+
+// Set up the joints of a loaded robot from its robotdef (def NULL = all rigid)
+static void setup_submodel_joints(RobotInstance* robot, const RobotNames* names, const RobotDef* def) {
+    static const float identity[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    for (int sm = 0; sm < robot->submodel_count; sm++) {
+        SubmodelJoint* joint = &robot->submodel_joints[sm];
+        memset(joint, 0, sizeof(*joint));
+        joint->parent = -1;
+        memcpy(joint->rotation, identity, sizeof(identity));
+    }
+    robot->joint_order_count = 0;
+    robot->joints_dirty = false;
+    if (!def) return;
+
+    std::vector<uint8_t> jointed(robot->submodel_count, 0);
+    for (int d = 0; d < def->submodel_count; d++) {
+        const RobotDefSubmodel* sub = &def->submodels[d];
+        int sm = find_submodel(names, robot->submodel_count, sub->name);
+        if (sm < 0) continue;
+        SubmodelJoint* joint = &robot->submodel_joints[sm];
+        if (sub->parent[0]) {
+            int parent = find_submodel(names, robot->submodel_count, sub->parent);
+            if (parent != sm) joint->parent = parent;
+        }
+
+        float length = sqrtf(sub->rotation_axis[0] * sub->rotation_axis[0] +
+                             sub->rotation_axis[1] * sub->rotation_axis[1] +
+                             sub->rotation_axis[2] * sub->rotation_axis[2]);
+        if (!sub->has_kinematics || length <= 0.0f) continue;
+
+        // LDraw (Y down, Z back) to robot-local OpenGL, like part positions
+        float origin[3];
+        robotdef_submodel_origin(def, sub, origin);
+        joint->axis[0] = sub->rotation_axis[0] / length;
+        joint->axis[1] = -sub->rotation_axis[1] / length;
+        joint->axis[2] = -sub->rotation_axis[2] / length;
+        joint->origin[0] = (origin[0] - robot->rotation_center[0]) * LDU_SCALE;
+        joint->origin[1] = -(origin[1] - robot->rotation_center[1]) * LDU_SCALE;
+        joint->origin[2] = -(origin[2] - robot->rotation_center[2]) * LDU_SCALE;
+        if (sub->rotation_limits[0] < sub->rotation_limits[1]) {
+            joint->min_angle = sub->rotation_limits[0] * DEG_TO_RAD_CONST;
+            joint->max_angle = sub->rotation_limits[1] * DEG_TO_RAD_CONST;
+        } else {
+            joint->min_angle = -FLT_MAX;  // No limits given
+            joint->max_angle = FLT_MAX;
+        }
+        jointed[sm] = true;
+    }
+
+    for (int m = 0; m < def->motor_count; m++) {
+        int sm = find_submodel(names, robot->submodel_count, def->motors[m].submodel);
+        if (sm >= 0 && jointed[sm] && def->motors[m].port > 0) robot->submodel_joints[sm].motor_port = def->motors[m].port;
+    }
+
+    // Moving submodels (a joint or a jointed ancestor), parents first
+    std::vector<int> depth(robot->submodel_count, 0);
+    for (int sm = 0; sm < robot->submodel_count; sm++) {
+        bool moving = jointed[sm];
+        for (int p = robot->submodel_joints[sm].parent; p >= 0; p = robot->submodel_joints[p].parent) {
+            if (++depth[sm] > robot->submodel_count) {  // Parent cycle: hang it off the body
+                robot->submodel_joints[sm].parent = -1;
+                depth[sm] = 0;
+                moving = jointed[sm];
+                break;
+            }
+            moving |= jointed[p];
+        }
+        if (moving) robot->joint_order[robot->joint_order_count++] = sm;
+    }
+    std::stable_sort(robot->joint_order.begin(), robot->joint_order.begin() + robot->joint_order_count,
+                     [&depth](int a, int b) { return depth[a] < depth[b]; });
+}
+
+// =============================================================================
+// Sensors
+// Config sensors that see along a ray (distance, color/optical) are mounted
+// on their sensor part: the ray starts at the part's center and points
+// along the config direction, or straight ahead (+Z) since sensor part
+// geometry doesn't say which way the sensor faces. The part is looked up in
+// the named submodel, then in the whole robot (main-model parts and nested
+// submodels are folded away by the MPD loader). Cameras are mounted the same
+// way but only rendered, by the client.
+// =============================================================================
+
+// Sensor part looked up when the config names none (cameras: "", no default)
+static const char* default_sensor_part(SimSensorType type) {
+    if (type == SIM_SENSOR_CAMERA) return "";
+    return type == SIM_SENSOR_DISTANCE ? "228-3011" : "228-3012";
+}
+
+// Part of robot with the given part number, preferring submodel sm (-1 =
+// anywhere) and skipping parts other sensors already use; -1 if none
+static int find_sensor_part(const SimWorld* world, const RobotInstance* robot, int sm, const char* part_number,
+                            const int* used, int used_count) {
+    for (int pass = sm >= 0 ? 0 : 1; pass < 2; pass++) {
+        size_t first = robot->parts_start_index + (pass == 0 ? robot->submodel_part_start[sm] : 0);
+        size_t count = pass == 0 ? (size_t)robot->submodel_part_count[sm] : robot->parts_count;
+        for (size_t i = first; i < first + count; i++) {
+            int part_id = world->parts.info[i].part_id;
+            if (part_id < 0 || !names_equal(world->part_numbers[part_id].c_str(), part_number)) continue;
+            bool taken = false;
+            for (int u = 0; u < used_count; u++) taken |= used[u] == (int)i;
+            if (!taken) return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void setup_robot_sensors(SimWorld* world, RobotInstance* robot, const RobotNames* names) {
+    robot->sensor_count = 0;
+    const RobotConfig* config = &robot->motor_config;
+    int used_parts[SIM_MAX_ROBOT_SENSORS];
+    for (int k = 0; k < config->sensor_count; k++) {
+        const RobotConfigSensor* entry = &config->sensors[k];
+        SimSensorType type;
+        if (strstr(entry->name, "distance")) type = SIM_SENSOR_DISTANCE;
+        else if (strstr(entry->name, "color") || strstr(entry->name, "optical")) type = SIM_SENSOR_OPTICAL;
+        else if (strstr(entry->name, "camera") || strstr(entry->name, "vision")) type = SIM_SENSOR_CAMERA;
+        else continue;  // Bumpers, touch LEDs, gyros: nothing to cast
+        if (entry->port <= 0) continue;
+
+        // Mount on the sensor part, else the named submodel's center
+        int sm = find_submodel(names, robot->submodel_count, entry->submodel);
+        const char* part_number = entry->part[0] ? entry->part : default_sensor_part(type);
+        int part = part_number[0] ? find_sensor_part(world, robot, sm, part_number, used_parts, robot->sensor_count) : -1;
+        if (part < 0 && sm < 0) {
+            printf("  Sensor %s: no part %s or submodel %s, skipped\n", entry->name,
+                   part_number[0] ? part_number : "(none)", entry->submodel);
+            continue;
+        }
+
+        SimSensor* sensor = &robot->sensors[robot->sensor_count];
+        used_parts[robot->sensor_count++] = part;
+        sensor->port = entry->port;
+        sensor->type = type;
+        sensor->submodel = part >= 0 ? world->parts.collision[part].submodel_index : sm;
+        const OBB* mount = part >= 0 ? &world->parts.rest_obbs[part] : &robot->submodel_obbs[sm];
+        sensor->origin[0] = mount->center.x + entry->offset[0] * LDU_SCALE;
+        sensor->origin[1] = mount->center.y - entry->offset[1] * LDU_SCALE;
+        sensor->origin[2] = mount->center.z - entry->offset[2] * LDU_SCALE;
+
+        // LDraw direction (Y down, Z back) to robot-local OpenGL
+        float dir[3] = {entry->direction[0], -entry->direction[1], -entry->direction[2]};
+        float length = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+        if (length <= 0.0f) {
+            dir[0] = 0.0f; dir[1] = 0.0f; dir[2] = 1.0f;
+            length = 1.0f;
+        }
+        for (int a = 0; a < 3; a++) sensor->dir[a] = dir[a] / length;
+
+        bool distance = type == SIM_SENSOR_DISTANCE;
+        float default_range = type == SIM_SENSOR_CAMERA ? SIM_SENSOR_CAMERA_RANGE
+                            : (distance ? SIM_SENSOR_DISTANCE_RANGE : SIM_SENSOR_OPTICAL_RANGE);
+        sensor->range = entry->range_mm > 0.0f ? entry->range_mm / 25.4f : default_range;
+        sensor->radius = distance ? SIM_SENSOR_DISTANCE_RADIUS : 0.0f;
+        sensor->fov = (entry->fov_deg > 0.0f ? entry->fov_deg : SIM_SENSOR_CAMERA_FOV) * DEG_TO_RAD_CONST;
+        sensor->reading = SimRayHit{sensor->range, (uint8_t)SIM_RAY_NONE, -1, -1};
+    }
+    if (robot->sensor_count > 0) printf("  Sensors: %d\n", robot->sensor_count);
+}
+
+// =============================================================================
+// Broad Phase
+// Robots (union of submodel OBB footprints) and cylinders are binned into a
+// uniform grid; the narrow-phase passes below only visit candidate pairs.
+// =============================================================================
+
+// Robots per job in the parallel step phases. Light phases (integration,
+// pose sync) cost well under a microsecond per robot; heavy ones refresh
+// submodel OBBs or descend part trees.
+static const int SIM_JOB_GRAIN_LIGHT = 16;
+static const int SIM_JOB_GRAIN_HEAVY = 2;
+
+// Union of a robot's submodel OBB footprints (robot has submodels)
+static void robot_footprint(RobotInstance* robot, AABB* bounds) {
+    obb_get_enclosing_aabb(sim_submodel_world_obb(robot, 0), bounds);
+    for (int sm = 1; sm < robot->submodel_count; sm++) {
+        AABB sm_aabb;
+        obb_get_enclosing_aabb(sim_submodel_world_obb(robot, sm), &sm_aabb);
+        bounds->min.x = fminf(bounds->min.x, sm_aabb.min.x);
+        bounds->min.z = fminf(bounds->min.z, sm_aabb.min.z);
+        bounds->max.x = fmaxf(bounds->max.x, sm_aabb.max.x);
+        bounds->max.z = fmaxf(bounds->max.z, sm_aabb.max.z);
+    }
+}
+
+// Robot footprints into world->robot_bounds
+static void robot_bounds_job(void* user_data, int begin, int end, int) {
+    SimWorld* world = (SimWorld*)user_data;
+    for (int i = begin; i < end; i++) {
+        RobotInstance* robot = &world->robots[i];
+        if (robot->submodel_count == 0) continue;
+        robot_footprint(robot, &world->robot_bounds[i]);
+    }
+}
+
+// Fill the broad phase with all robots (first) and cylinders
+// Robot footprints (the submodel OBB refresh) are computed in parallel, then
+// bodies are added in index order so pairs match the serial build.
+// The pairs are sorted into the response's contact lists and the body poses
+// kept, so the next steps can reuse them (see contacts_reusable).
+static void build_broadphase(SimWorld* world) {
+    Broadphase* bp = &world->broadphase;
+    std::vector<RobotInstance>& robots = world->robots;
+    const Scene* scene = &world->scene;
+
+    world->robot_bounds.resize(robots.size());
+    job_system_parallel_for(world->jobs, (int)robots.size(), SIM_JOB_GRAIN_HEAVY, robot_bounds_job, world);
+
+    broadphase_begin(bp, world->field_half_width, world->field_half_depth);
+    for (size_t i = 0; i < robots.size(); i++) {
+        if (robots[i].submodel_count == 0) continue;
+        const AABB& bounds = world->robot_bounds[i];
+        broadphase_add(bp, BROADPHASE_ROBOT, (int)i, bounds.min.x, bounds.min.z, bounds.max.x, bounds.max.z);
+    }
+
+    for (uint32_t c = 0; c < scene->cylinder_count; c++) {
+        const SceneCylinder& cyl = scene->cylinders[c];
+        broadphase_add(bp, BROADPHASE_CYLINDER, (int)c,
+                       cyl.x - cyl.radius, cyl.z - cyl.radius, cyl.x + cyl.radius, cyl.z + cyl.radius);
+    }
+
+    broadphase_build(bp);
+
+    world->robot_contacts.clear();
+    world->cylinder_contacts.clear();
+    for (int p = 0; p < bp->pair_count; p++) {
+        const BroadphaseBody* a = &bp->bodies[bp->pairs[p].a];
+        const BroadphaseBody* b = &bp->bodies[bp->pairs[p].b];
+        if (a->type != BROADPHASE_ROBOT) continue;
+        if (b->type == BROADPHASE_ROBOT) world->robot_contacts.push_back(p);
+        else world->cylinder_contacts.push_back(p);
+    }
+
+    world->wall_bodies.clear();
+    world->contact_poses.resize(bp->body_count);
+    for (int i = 0; i < bp->body_count; i++) {
+        const BroadphaseBody* body = &bp->bodies[i];
+        SimContactPose& pose = world->contact_poses[i];
+        if (body->type == BROADPHASE_ROBOT) {
+            const RobotInstance& robot = robots[body->index];
+            const AABB& bounds = world->robot_bounds[body->index];
+            pose.x = robot.offset[0];
+            pose.z = robot.offset[2];
+            pose.rotation = robot.rotation_y;
+            float dx = fmaxf(fabsf(bounds.min.x - pose.x), fabsf(bounds.max.x - pose.x));
+            float dz = fmaxf(fabsf(bounds.min.z - pose.z), fabsf(bounds.max.z - pose.z));
+            pose.radius = sqrtf(dx * dx + dz * dz);
+            pose.shape_version = robot.shape_version;
+            if (body->walls != 0) world->wall_bodies.push_back(i);
+        } else {
+            pose.x = scene->cylinders[body->index].x;
+            pose.z = scene->cylinders[body->index].z;
+            pose.rotation = 0.0f;
+            pose.radius = 0.0f;
+            pose.shape_version = 0;
+        }
+    }
+    world->contacts_cached = true;
+}
+
+// True if the broad phase still covers every contact: no body has moved
+// SIM_CONTACT_REUSE_DISTANCE since it was built (a robot's turn counts as the
+// arc its furthest corner swept) and no robot's submodels were refit, so the
+// grown bounds still enclose them
+static bool contacts_reusable(const SimWorld* world) {
+    if (!world->contacts_cached) return false;
+    const Broadphase* bp = &world->broadphase;
+    for (int i = 0; i < bp->body_count; i++) {
+        const BroadphaseBody* body = &bp->bodies[i];
+        const SimContactPose& pose = world->contact_poses[i];
+        float x, z, turn = 0.0f;
+        if (body->type == BROADPHASE_ROBOT) {
+            const RobotInstance& robot = world->robots[body->index];
+            if (robot.shape_version != pose.shape_version) return false;
+            x = robot.offset[0];
+            z = robot.offset[2];
+            turn = fabsf(remainderf(robot.rotation_y - pose.rotation, 6.28318530718f)) * pose.radius;
+        } else {
+            x = world->scene.cylinders[body->index].x;
+            z = world->scene.cylinders[body->index].z;
+        }
+        float dx = x - pose.x, dz = z - pose.z;
+        if (sqrtf(dx * dx + dz * dz) + turn > SIM_CONTACT_REUSE_DISTANCE) return false;
+    }
+    return true;
+}
+
+void sim_world_update_broadphase(SimWorld* world) {
+    if (!contacts_reusable(world)) build_broadphase(world);
+}
+
+// Step counters
+// Response phases count into their job thread's slot; the slots and the part
+// test counts of each thread's PartBvhHits are summed into world->stats.
+
+static void stats_begin(SimWorld* world) {
+    world->thread_stats.assign(world->bvh_hits.size(), SimStepStats{});
+    for (PartBvhHits& hits : world->bvh_hits) hits.part_tests = 0;
+}
+
+static void stats_end(SimWorld* world) {
+    SimStepStats total = {};
+    for (const SimStepStats& stats : world->thread_stats) {
+        total.broadphase_pairs += stats.broadphase_pairs;
+        total.broadphase_builds += stats.broadphase_builds;
+        total.submodel_tests += stats.submodel_tests;
+        total.submodel_hits += stats.submodel_hits;
+        total.corrections += stats.corrections;
+        total.response_iterations += stats.response_iterations;
+        total.cylinders_moved += stats.cylinders_moved;
+    }
+    for (const PartBvhHits& hits : world->bvh_hits) total.part_tests += hits.part_tests;
+    world->stats = total;
+}
+
+// Counters of the calling (serial) phase
+static SimStepStats* serial_stats(SimWorld* world) {
+    return &world->thread_stats[0];
+}
+
+// Hierarchical collision detection between two robots
+// Returns true if any collision detected, updates collision states
+static bool check_robot_robot_collision(
+    PartBvh* bvh, PartBvhHits* hits,
+    RobotInstance* robot_a, int robot_a_idx,
+    RobotInstance* robot_b, int robot_b_idx,
+    SimParts& parts)
+{
+    bool any_collision = false;
+
+    // Reset collision states for both robots
+    for (int sm = 0; sm < robot_a->submodel_count; sm++) {
+        robot_a->submodel_collision_state[sm] = COLLISION_NONE;
+    }
+    for (int sm = 0; sm < robot_b->submodel_count; sm++) {
+        robot_b->submodel_collision_state[sm] = COLLISION_NONE;
+    }
+
+    // Check submodel-submodel collisions (Level 1)
+    for (int sm_a = 0; sm_a < robot_a->submodel_count; sm_a++) {
+        const OBB& world_obb_a = *sim_submodel_world_obb(robot_a, sm_a);
+
+        for (int sm_b = 0; sm_b < robot_b->submodel_count; sm_b++) {
+            const OBB& world_obb_b = *sim_submodel_world_obb(robot_b, sm_b);
+
+            if (obb_intersects_obb(&world_obb_a, &world_obb_b)) {
+                // Submodels intersect - mark as yellow (checking parts)
+                robot_a->submodel_collision_state[sm_a] = COLLISION_SUBMODEL;
+                robot_b->submodel_collision_state[sm_b] = COLLISION_SUBMODEL;
+                any_collision = true;
+
+                // Level 2: Check part-part collisions within these submodels (BVH vs BVH)
+                int hit_count = part_bvh_query_pairs(bvh, parts.collision,
+                                                     robot_a, robot_a->submodel_bvh_root[sm_a],
+                                                     robot_b, robot_b->submodel_bvh_root[sm_b], hits);
+                for (int h = 0; h < hit_count; h++) {
+                    // Part collision - mark as red
+                    parts.collision_state[hits->pairs[h].a] = COLLISION_PART;
+                    parts.collision_state[hits->pairs[h].b] = COLLISION_PART;
+                }
+            }
+        }
+    }
+
+    return any_collision;
+}
+
+// Check robot collision against field walls (AABB)
+// wall_mask: BROADPHASE_WALL_* flags of walls the robot may touch
+static bool check_robot_wall_collision(
+    PartBvh* bvh, PartBvhHits* hits,
+    RobotInstance* robot, int robot_idx,
+    SimParts& parts,
+    float field_half_width, float field_half_depth, uint8_t wall_mask)
+{
+    bool any_collision = false;
+
+    // Create AABBs for each wall
+    AABB walls[4];
+    // Left wall (min X)
+    walls[0].min = vec3(-field_half_width - 1.0f, 0.0f, -field_half_depth);
+    walls[0].max = vec3(-field_half_width, 10.0f, field_half_depth);
+    // Right wall (max X)
+    walls[1].min = vec3(field_half_width, 0.0f, -field_half_depth);
+    walls[1].max = vec3(field_half_width + 1.0f, 10.0f, field_half_depth);
+    // Back wall (min Z)
+    walls[2].min = vec3(-field_half_width, 0.0f, -field_half_depth - 1.0f);
+    walls[2].max = vec3(field_half_width, 10.0f, -field_half_depth);
+    // Front wall (max Z)
+    walls[3].min = vec3(-field_half_width, 0.0f, field_half_depth);
+    walls[3].max = vec3(field_half_width, 10.0f, field_half_depth + 1.0f);
+
+    // Check each submodel against walls
+    for (int sm = 0; sm < robot->submodel_count; sm++) {
+        const OBB& world_obb = *sim_submodel_world_obb(robot, sm);
+
+        for (int w = 0; w < 4; w++) {
+            if (!(wall_mask & (1 << w))) continue;
+            if (obb_intersects_aabb(&world_obb, &walls[w])) {
+                // Submodel hits wall - mark as checking
+                if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
+                    robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
+                }
+                any_collision = true;
+
+                // Check parts in this submodel
+                int hit_count = part_bvh_query_aabb(bvh, parts.collision, robot, robot->submodel_bvh_root[sm],
+                                                    &walls[w], hits);
+                for (int h = 0; h < hit_count; h++) {
+                    parts.collision_state[hits->parts[h]] = COLLISION_EXTERNAL;
+                }
+            }
+        }
+    }
+
+    return any_collision;
+}
+
+// Check robot collision against a cylinder
+static bool check_robot_cylinder_collision(
+    PartBvh* bvh, PartBvhHits* hits,
+    RobotInstance* robot, int robot_idx,
+    SimParts& parts,
+    const SceneCylinder& cyl)
+{
+    bool any_collision = false;
+
+    // Check each submodel against this cylinder
+    for (int sm = 0; sm < robot->submodel_count; sm++) {
+        const OBB& world_obb = *sim_submodel_world_obb(robot, sm);
+
+        if (obb_intersects_circle(&world_obb, cyl.x, cyl.z, cyl.radius)) {
+            // Submodel hits cylinder - mark as checking
+            if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
+                robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
+            }
+            any_collision = true;
+
+            // Check parts in this submodel
+            int hit_count = part_bvh_query_circle(bvh, parts.collision, robot, robot->submodel_bvh_root[sm],
+                                                  cyl.x, cyl.z, cyl.radius, hits);
+            for (int h = 0; h < hit_count; h++) {
+                parts.collision_state[hits->parts[h]] = COLLISION_EXTERNAL;
+            }
+        }
+    }
+
+    return any_collision;
+}
+
+// Reset all collision states for all robots
+static void reset_collision_states(std::vector<RobotInstance>& robots, SimParts& parts) {
+    for (auto& robot : robots) {
+        for (int sm = 0; sm < robot.submodel_count; sm++) {
+            robot.submodel_collision_state[sm] = COLLISION_NONE;
+        }
+    }
+    std::fill(parts.collision_state.begin(), parts.collision_state.end(), (uint8_t)COLLISION_NONE);
+}
+
+// Run full hierarchical collision detection
+static void run_hierarchical_collision_detection(SimWorld* world) {
+    Broadphase* bp = &world->broadphase;
+    PartBvh* bvh = &world->part_bvh;
+    PartBvhHits* hits = &world->bvh_hits[0];
+    std::vector<RobotInstance>& robots = world->robots;
+    SimParts& parts = world->parts;
+    const Scene* scene = &world->scene;
+
+    // Reset all collision states
+    reset_collision_states(robots, parts);
+
+    for (RobotInstance& robot : robots) refit_robot_joints(world, &robot);
+    build_broadphase(world);
+
+    // Check robot-robot collisions
+    for (int p = 0; p < bp->pair_count; p++) {
+        const BroadphaseBody* a = &bp->bodies[bp->pairs[p].a];
+        const BroadphaseBody* b = &bp->bodies[bp->pairs[p].b];
+        if (a->type != BROADPHASE_ROBOT || b->type != BROADPHASE_ROBOT) continue;
+        check_robot_robot_collision(bvh, hits, &robots[a->index], a->index, &robots[b->index], b->index, parts);
+    }
+
+    // Check robot-wall collisions
+    for (int i = 0; i < bp->body_count; i++) {
+        const BroadphaseBody* body = &bp->bodies[i];
+        if (body->type != BROADPHASE_ROBOT || body->walls == 0) continue;
+        check_robot_wall_collision(bvh, hits, &robots[body->index], body->index, parts,
+                                   world->field_half_width, world->field_half_depth, body->walls);
+    }
+
+    // Check robot-cylinder collisions
+    for (int p = 0; p < bp->pair_count; p++) {
+        const BroadphaseBody* a = &bp->bodies[bp->pairs[p].a];
+        const BroadphaseBody* b = &bp->bodies[bp->pairs[p].b];
+        if (a->type != BROADPHASE_ROBOT || b->type != BROADPHASE_CYLINDER) continue;
+        check_robot_cylinder_collision(bvh, hits, &robots[a->index], a->index, parts, scene->cylinders[b->index]);
+    }
+}
+
+// =============================================================================
+// Collision Response Functions (Hierarchical: submodel broad-phase, part narrow-phase)
+// =============================================================================
+
+// Collision dead zone - only correct if penetration exceeds this threshold
+// This breaks the feedback loop that causes jitter
+static const float COLLISION_TOLERANCE = 0.15f;  // 0.15 inches - acceptable penetration
+
+// Sleep states (SIM_SLEEP_*)
+
+static void wake_robot(RobotInstance* robot) {
+    robot->asleep = false;
+    robot->still_time = 0.0f;
+}
+
+static void wake_cylinder(SceneCylinder* cyl) {
+    cyl->asleep = false;
+    cyl->still_time = 0.0f;
+}
+
+static bool any_cylinder_awake(const SceneCylinder* cylinders, uint32_t count) {
+    for (uint32_t c = 0; c < count; c++) {
+        if (!cylinders[c].asleep) return true;
+    }
+    return false;
+}
+
+// True if any robot or cylinder is awake (bodies only sleep with world->sleeping)
+static bool any_body_awake(const SimWorld* world) {
+    for (const RobotInstance& robot : world->robots) {
+        if (!robot.asleep) return true;
+    }
+    return any_cylinder_awake(world->scene.cylinders, world->scene.cylinder_count);
+}
+
+// Apply wall collision response using hierarchical detection
+// Broad phase: submodel OBBs, Narrow phase: part OBBs
+// wall_mask: BROADPHASE_WALL_* flags of walls the robot may touch
+// Returns true if the robot was moved
+static bool apply_wall_collision_response(
+    PartBvh* bvh, PartBvhHits* hits, SimStepStats* stats,
+    RobotInstance* robot,
+    SimParts& parts,
+    float field_half_width, float field_half_depth, uint8_t wall_mask)
+{
+    // Create wall AABBs
+    AABB walls[4];
+    walls[0].min = vec3(-field_half_width - 1.0f, 0.0f, -field_half_depth);  // Left
+    walls[0].max = vec3(-field_half_width, 10.0f, field_half_depth);
+    walls[1].min = vec3(field_half_width, 0.0f, -field_half_depth);          // Right
+    walls[1].max = vec3(field_half_width + 1.0f, 10.0f, field_half_depth);
+    walls[2].min = vec3(-field_half_width, 0.0f, -field_half_depth - 1.0f);  // Back
+    walls[2].max = vec3(field_half_width, 10.0f, -field_half_depth);
+    walls[3].min = vec3(-field_half_width, 0.0f, field_half_depth);          // Front
+    walls[3].max = vec3(field_half_width, 10.0f, field_half_depth + 1.0f);
+
+    float max_push_x = 0.0f, max_push_z = 0.0f;
+
+    // For each submodel (broad phase)
+    for (int sm = 0; sm < robot->submodel_count; sm++) {
+        const OBB& world_submodel_obb = *sim_submodel_world_obb(robot, sm);
+
+        for (int w = 0; w < 4; w++) {
+            if (!(wall_mask & (1 << w))) continue;
+
+            // Broad phase: does submodel OBB hit this wall?
+            stats->submodel_tests++;
+            if (!obb_intersects_aabb(&world_submodel_obb, &walls[w])) continue;
+            stats->submodel_hits++;
+
+            // Mark submodel as colliding (for visualization)
+            if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
+                robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
+            }
+
+            // Narrow phase: parts in this submodel that hit the wall (BVH descent)
+            int hit_count = part_bvh_query_aabb(bvh, parts.collision, robot, robot->submodel_bvh_root[sm],
+                                                &walls[w], hits);
+            for (int h = 0; h < hit_count; h++) {
+                const OBB& world_part_obb = *sim_part_world_obb(robot, &parts.collision[hits->parts[h]]);
+
+                // Mark part as colliding (for visualization)
+                parts.collision_state[hits->parts[h]] = COLLISION_EXTERNAL;
+
+                // Part actually hits wall - calculate penetration
+                AABB part_aabb;
+                obb_get_enclosing_aabb(&world_part_obb, &part_aabb);
+
+                float push_x = 0.0f, push_z = 0.0f;
+                float penetration = 0.0f;
+                if (w == 0 && part_aabb.min.x < -field_half_width) {  // Left
+                    penetration = -field_half_width - part_aabb.min.x;
+                    if (penetration > COLLISION_TOLERANCE) push_x = penetration - COLLISION_TOLERANCE;
+                } else if (w == 1 && part_aabb.max.x > field_half_width) {  // Right
+                    penetration = part_aabb.max.x - field_half_width;
+                    if (penetration > COLLISION_TOLERANCE) push_x = -(penetration - COLLISION_TOLERANCE);
+                } else if (w == 2 && part_aabb.min.z < -field_half_depth) {  // Back
+                    penetration = -field_half_depth - part_aabb.min.z;
+                    if (penetration > COLLISION_TOLERANCE) push_z = penetration - COLLISION_TOLERANCE;
+                } else if (w == 3 && part_aabb.max.z > field_half_depth) {  // Front
+                    penetration = part_aabb.max.z - field_half_depth;
+                    if (penetration > COLLISION_TOLERANCE) push_z = -(penetration - COLLISION_TOLERANCE);
+                }
+
+                // Track maximum penetration
+                if (fabsf(push_x) > fabsf(max_push_x)) max_push_x = push_x;
+                if (fabsf(push_z) > fabsf(max_push_z)) max_push_z = push_z;
+            }
+        }
+    }
+
+    // Apply the maximum push needed (position correction only)
+    if (max_push_x != 0.0f || max_push_z != 0.0f) {
+        stats->corrections++;
+        robot->step_contacts |= SIM_CONTACT_WALL;
+        robot->drivetrain.pos_x += max_push_x;
+        robot->drivetrain.pos_z += max_push_z;
+        robot->offset[0] = robot->drivetrain.pos_x;
+        robot->offset[2] = robot->drivetrain.pos_z;
+        return true;
+    }
+    return false;
+}
+
+// Apply robot-robot collision response using hierarchical detection
+// Returns true if the robots were moved
+static bool apply_robot_collision_response(
+    SimStepStats* stats,
+    RobotInstance* robot_a,
+    RobotInstance* robot_b,
+    SimParts& parts)
+{
+    (void)parts;  // No longer used - submodel-level collision only for performance
+
+    float total_push_x = 0.0f, total_push_z = 0.0f;
+    int collision_count = 0;
+
+    // Submodel-level collision only (no part drilling for performance)
+    // This is O(s1 * s2) instead of O(s1 * s2 * p1 * p2) when parts are checked
+    for (int sm_a = 0; sm_a < robot_a->submodel_count; sm_a++) {
+        const OBB& world_sm_a = *sim_submodel_world_obb(robot_a, sm_a);
+
+        for (int sm_b = 0; sm_b < robot_b->submodel_count; sm_b++) {
+            const OBB& world_sm_b = *sim_submodel_world_obb(robot_b, sm_b);
+
+            // Do submodel OBBs intersect?
+            stats->submodel_tests++;
+            if (!obb_intersects_obb(&world_sm_a, &world_sm_b)) continue;
+            stats->submodel_hits++;
+
+            // Mark submodels as colliding (for visualization)
+            robot_a->submodel_collision_state[sm_a] = COLLISION_SUBMODEL;
+            robot_b->submodel_collision_state[sm_b] = COLLISION_SUBMODEL;
+
+            // Use submodel AABBs for collision response (fast approximation)
+            AABB aabb_a, aabb_b;
+            obb_get_enclosing_aabb(&world_sm_a, &aabb_a);
+            obb_get_enclosing_aabb(&world_sm_b, &aabb_b);
+
+            // Calculate overlap
+            float overlap_x = fminf(aabb_a.max.x, aabb_b.max.x) - fmaxf(aabb_a.min.x, aabb_b.min.x);
+            float overlap_z = fminf(aabb_a.max.z, aabb_b.max.z) - fmaxf(aabb_a.min.z, aabb_b.min.z);
+
+            if (overlap_x > 0 && overlap_z > 0) {
+                // Push along axis of minimum penetration
+                float center_a_x = (aabb_a.min.x + aabb_a.max.x) * 0.5f;
+                float center_a_z = (aabb_a.min.z + aabb_a.max.z) * 0.5f;
+                float center_b_x = (aabb_b.min.x + aabb_b.max.x) * 0.5f;
+                float center_b_z = (aabb_b.min.z + aabb_b.max.z) * 0.5f;
+
+                float penetration = fminf(overlap_x, overlap_z);
+                // Only correct if penetration exceeds tolerance
+                if (penetration > COLLISION_TOLERANCE) {
+                    float push = penetration - COLLISION_TOLERANCE;
+                    if (overlap_x < overlap_z) {
+                        total_push_x += (center_a_x < center_b_x) ? -push : push;
+                    } else {
+                        total_push_z += (center_a_z < center_b_z) ? -push : push;
+                    }
+                    collision_count++;
+                }
+            }
+        }
+    }
+
+    // Apply averaged push (split between both robots) - position correction only
+    if (collision_count > 0) {
+        stats->corrections++;
+        float push_x = (total_push_x / collision_count) * 0.5f;
+        float push_z = (total_push_z / collision_count) * 0.5f;
+
+        robot_a->step_contacts |= SIM_CONTACT_ROBOT;
+        robot_b->step_contacts |= SIM_CONTACT_ROBOT;
+        if (fabsf(push_x) > SIM_SLEEP_WAKE_DISTANCE || fabsf(push_z) > SIM_SLEEP_WAKE_DISTANCE) {
+            wake_robot(robot_a);
+            wake_robot(robot_b);
+        }
+
+        robot_a->drivetrain.pos_x += push_x;
+        robot_a->drivetrain.pos_z += push_z;
+        robot_a->offset[0] = robot_a->drivetrain.pos_x;
+        robot_a->offset[2] = robot_a->drivetrain.pos_z;
+
+        robot_b->drivetrain.pos_x -= push_x;
+        robot_b->drivetrain.pos_z -= push_z;
+        robot_b->offset[0] = robot_b->drivetrain.pos_x;
+        robot_b->offset[2] = robot_b->drivetrain.pos_z;
+        return true;
+    }
+    return false;
+}
+
+// Apply cylinder collision response using hierarchical detection
+// Cylinders are light movable objects that get pushed by the robot
+// Returns true if the cylinder was moved (a velocity transfer alone doesn't count)
+static bool apply_cylinder_collision_response(
+    PartBvh* bvh, PartBvhHits* hits, SimStepStats* stats,
+    RobotInstance* robot,
+    SimParts& parts,
+    SceneCylinder& cyl)  // Non-const to modify cylinder position
+{
+    float max_penetration = 0.0f;
+    float contact_nx = 0.0f, contact_nz = 0.0f;
+    bool any_contact = false;
+
+    // For each submodel (broad phase)
+    for (int sm = 0; sm < robot->submodel_count; sm++) {
+        const OBB& world_sm = *sim_submodel_world_obb(robot, sm);
+
+        // Broad phase: does submodel OBB hit cylinder?
+        stats->submodel_tests++;
+        if (!obb_intersects_circle(&world_sm, cyl.x, cyl.z, cyl.radius)) continue;
+        stats->submodel_hits++;
+
+        // Mark submodel as colliding (for visualization)
+        if (robot->submodel_collision_state[sm] < COLLISION_SUBMODEL) {
+            robot->submodel_collision_state[sm] = COLLISION_SUBMODEL;
+        }
+
+        // Narrow phase: parts in this submodel that hit the cylinder (BVH descent)
+        int hit_count = part_bvh_query_circle(bvh, parts.collision, robot, robot->submodel_bvh_root[sm],
+                                              cyl.x, cyl.z, cyl.radius, hits);
+        for (int h = 0; h < hit_count; h++) {
+            const OBB& world_part = *sim_part_world_obb(robot, &parts.collision[hits->parts[h]]);
+
+            // Mark part as colliding (for visualization)
+            parts.collision_state[hits->parts[h]] = COLLISION_EXTERNAL;
+
+            // Part hits cylinder - calculate penetration
+            AABB part_aabb;
+            obb_get_enclosing_aabb(&world_part, &part_aabb);
+
+            float part_cx = (part_aabb.min.x + part_aabb.max.x) * 0.5f;
+            float part_cz = (part_aabb.min.z + part_aabb.max.z) * 0.5f;
+            float part_rx = (part_aabb.max.x - part_aabb.min.x) * 0.5f;
+            float part_rz = (part_aabb.max.z - part_aabb.min.z) * 0.5f;
+            float part_radius = sqrtf(part_rx * part_rx + part_rz * part_rz) * 0.5f;
+
+            float dx = part_cx - cyl.x;
+            float dz = part_cz - cyl.z;
+            float dist = sqrtf(dx * dx + dz * dz);
+
+            float combined_radius = cyl.radius + part_radius;
+            if (dist < combined_radius && dist > 0.001f) {
+                float penetration = combined_radius - dist;
+
+                // Track contact direction (from cylinder toward robot)
+                if (!any_contact || penetration > max_penetration) {
+                    contact_nx = dx / dist;  // Points from cylinder to robot
+                    contact_nz = dz / dist;
+                }
+                any_contact = true;
+
+                // Track max penetration
+                if (penetration > max_penetration) {
+                    max_penetration = penetration;
+                }
+            }
+        }
+    }
+
+    // If contact, transfer momentum to cylinder (push it away)
+    if (any_contact && max_penetration > 0.01f) {
+        stats->corrections++;
+        robot->step_contacts |= SIM_CONTACT_CYLINDER;
+
+        // Get robot velocity toward cylinder
+        float robot_vel_into = robot->drivetrain.vel_x * (-contact_nx) + robot->drivetrain.vel_z * (-contact_nz);
+        if (robot_vel_into > SIM_SLEEP_LINEAR_SPEED || max_penetration - COLLISION_TOLERANCE > SIM_SLEEP_WAKE_DISTANCE) {
+            wake_cylinder(&cyl);
+        }
+
+        // Transfer velocity to cylinder (push it away)
+        if (robot_vel_into > 0) {
+            // Match cylinder velocity to robot's (smooth push, no bounce)
+            cyl.vel_x = -contact_nx * robot_vel_into * 0.8f;
+            cyl.vel_z = -contact_nz * robot_vel_into * 0.8f;
+        }
+
+        // Position correction with tolerance
+        if (max_penetration > COLLISION_TOLERANCE) {
+            float correction = max_penetration - COLLISION_TOLERANCE;
+            cyl.x -= contact_nx * correction;
+            cyl.z -= contact_nz * correction;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Update cylinder physics (friction, position integration, cylinder-cylinder collision)
+// sleeping: let resting cylinders sleep (sleeping ones are skipped until pushed)
+static void update_cylinder_physics(Broadphase* bp, SceneCylinder* cylinders, uint32_t cylinder_count,
+                                    float dt_sec, float field_half_width, float field_half_depth, bool sleeping) {
+    const float CYLINDER_FRICTION = 0.85f;  // Friction damping per frame
+    const float WALL_BOUNCE = 0.0f;         // No bounce off walls (soft stop)
+    const float CYLINDER_TOLERANCE = 0.1f;  // Allow slight overlap before correcting
+
+    // Cylinder-cylinder collision (candidate pairs from the broad phase)
+    broadphase_begin(bp, field_half_width, field_half_depth);
+    if (sleeping && !any_cylinder_awake(cylinders, cylinder_count)) return;
+    for (uint32_t c = 0; c < cylinder_count; c++) {
+        const SceneCylinder& cyl = cylinders[c];
+        broadphase_add(bp, BROADPHASE_CYLINDER, (int)c,
+                       cyl.x - cyl.radius, cyl.z - cyl.radius, cyl.x + cyl.radius, cyl.z + cyl.radius);
+    }
+    broadphase_build(bp);
+
+    for (int p = 0; p < bp->pair_count; p++) {
+        SceneCylinder& a = cylinders[bp->bodies[bp->pairs[p].a].index];
+        SceneCylinder& b = cylinders[bp->bodies[bp->pairs[p].b].index];
+        if (a.asleep && b.asleep) continue;
+
+        float dx = b.x - a.x;
+        float dz = b.z - a.z;
+        float dist = sqrtf(dx * dx + dz * dz);
+        float min_dist = a.radius + b.radius;
+
+        if (dist < min_dist && dist > 0.001f) {
+            float overlap = min_dist - dist;
+            float nx = dx / dist;
+            float nz = dz / dist;
+            float total_mass = a.mass + b.mass;
+            float a_ratio = b.mass / total_mass;
+            float b_ratio = a.mass / total_mass;
+
+            // Always cancel approaching velocity immediately (prevents bounce buildup)
+            float rel_vel = (b.vel_x - a.vel_x) * nx + (b.vel_z - a.vel_z) * nz;
+            if (rel_vel < 0 || overlap - CYLINDER_TOLERANCE > SIM_SLEEP_WAKE_DISTANCE) {
+                wake_cylinder(&a);
+                wake_cylinder(&b);
+            }
+            if (rel_vel < 0) {
+                // Cancel relative velocity completely - no bounce
+                a.vel_x += rel_vel * nx * a_ratio;
+                a.vel_z += rel_vel * nz * a_ratio;
+                b.vel_x -= rel_vel * nx * b_ratio;
+                b.vel_z -= rel_vel * nz * b_ratio;
+            }
+
+            // Position correction only if exceeds tolerance
+            if (overlap > CYLINDER_TOLERANCE) {
+                float correction = overlap - CYLINDER_TOLERANCE;
+                a.x -= nx * correction * a_ratio;
+                a.z -= nz * correction * a_ratio;
+                b.x += nx * correction * b_ratio;
+                b.z += nz * correction * b_ratio;
+            }
+        }
+    }
+
+    // Apply friction and integrate position
+    for (uint32_t c = 0; c < cylinder_count; c++) {
+        SceneCylinder& cyl = cylinders[c];
+        if (cyl.asleep) continue;
+
+        // Apply friction (damping)
+        cyl.vel_x *= CYLINDER_FRICTION;
+        cyl.vel_z *= CYLINDER_FRICTION;
+
+        // Stop if very slow
+        if (fabsf(cyl.vel_x) < 0.1f) cyl.vel_x = 0.0f;
+        if (fabsf(cyl.vel_z) < 0.1f) cyl.vel_z = 0.0f;
+
+        // Integrate position
+        cyl.x += cyl.vel_x * dt_sec;
+        cyl.z += cyl.vel_z * dt_sec;
+
+        // Cylinder-wall collision with bounce
+        float bound_x = field_half_width - cyl.radius;
+        float bound_z = field_half_depth - cyl.radius;
+
+        if (cyl.x < -bound_x) {
+            cyl.x = -bound_x;
+            cyl.vel_x = -cyl.vel_x * WALL_BOUNCE;
+        } else if (cyl.x > bound_x) {
+            cyl.x = bound_x;
+            cyl.vel_x = -cyl.vel_x * WALL_BOUNCE;
+        }
+
+        if (cyl.z < -bound_z) {
+            cyl.z = -bound_z;
+            cyl.vel_z = -cyl.vel_z * WALL_BOUNCE;
+        } else if (cyl.z > bound_z) {
+            cyl.z = bound_z;
+            cyl.vel_z = -cyl.vel_z * WALL_BOUNCE;
+        }
+
+        // Sleep after resting long enough (pushes reset still_time)
+        if (!sleeping) continue;
+        if (fabsf(cyl.vel_x) < SIM_SLEEP_LINEAR_SPEED && fabsf(cyl.vel_z) < SIM_SLEEP_LINEAR_SPEED) {
+            cyl.still_time += dt_sec;
+            if (cyl.still_time >= SIM_SLEEP_SECONDS) {
+                cyl.asleep = true;
+                cyl.vel_x = 0.0f;
+                cyl.vel_z = 0.0f;
+            }
+        } else {
+            cyl.still_time = 0.0f;
+        }
+    }
+}
+
+struct WallResponseJob {
+    SimWorld* world;
+    int pass;
+};
+
+// Wall response for world->wall_bodies[begin..end): each robot only moves itself
+// Pass 0 tests every awake robot, later passes the ones the previous pass moved.
+static void wall_response_job(void* user_data, int begin, int end, int thread) {
+    WallResponseJob* job = (WallResponseJob*)user_data;
+    SimWorld* world = job->world;
+    for (int k = begin; k < end; k++) {
+        int body_idx = world->wall_bodies[k];
+        const BroadphaseBody* body = &world->broadphase.bodies[body_idx];
+        RobotInstance* robot = &world->robots[body->index];
+        world->wall_corrected[k] = 0;
+        if (robot->asleep) continue;
+        if (job->pass > 0 && world->body_moved_pass[body_idx] < job->pass - 1) continue;
+        world->wall_corrected[k] = apply_wall_collision_response(
+            &world->part_bvh, &world->bvh_hits[thread], &world->thread_stats[thread], robot,
+            world->parts, world->field_half_width, world->field_half_depth, body->walls) ? 1 : 0;
+    }
+}
+
+// True if pass must test the pair: every pair on pass 0, then only pairs with
+// a body moved since the start of the previous pass
+static bool pair_needs_test(const SimWorld* world, const BroadphasePair& pair, int pass) {
+    if (pass == 0) return true;
+    return world->body_moved_pass[pair.a] >= pass - 1 || world->body_moved_pass[pair.b] >= pass - 1;
+}
+
+// Run all collision responses (hierarchical: submodel broad-phase, part narrow-phase)
+// Uses sub-stepping to resolve collisions iteratively and prevent jitter
+// The broad phase is kept across steps until a body has moved further than
+// SIM_CONTACT_REUSE_DISTANCE; its margin covers the contacts that appear
+// meanwhile. The first pass tests every candidate pair, each later pass only
+// the pairs whose bodies the previous one moved, until a pass moves nothing.
+// Robot-robot and robot-cylinder responses couple bodies and run serially in
+// pair order; wall responses touch one robot each and run in parallel.
+// Pairs of sleeping bodies are skipped; a push wakes the body it moves.
+static void run_collision_response(SimWorld* world) {
+    Broadphase* bp = &world->broadphase;
+    PartBvh* bvh = &world->part_bvh;
+    PartBvhHits* hits = &world->bvh_hits[0];
+    std::vector<RobotInstance>& robots = world->robots;
+    SimParts& parts = world->parts;
+    Scene* scene = &world->scene;  // Cylinders move
+    SimStepStats* stats = serial_stats(world);
+
+    // Resting bodies were resolved before they fell asleep
+    if (!any_body_awake(world)) return;
+
+    if (!contacts_reusable(world)) {
+        build_broadphase(world);
+        stats->broadphase_builds++;
+    }
+    stats->broadphase_pairs += (uint32_t)bp->pair_count;
+
+    // Nothing close enough to touch: skip the solver
+    if (world->robot_contacts.empty() && world->cylinder_contacts.empty() && world->wall_bodies.empty()) return;
+
+    world->body_moved_pass.assign(bp->body_count, -1);
+    world->wall_corrected.resize(world->wall_bodies.size());
+    WallResponseJob wall_job = { world, 0 };
+
+    for (int pass = 0; pass < SIM_RESPONSE_ITERATIONS; pass++) {
+        stats->response_iterations++;
+        bool moved = false;
+
+        // Robot-robot collision response
+        for (int p : world->robot_contacts) {
+            const BroadphasePair& pair = bp->pairs[p];
+            const BroadphaseBody* a = &bp->bodies[pair.a];
+            const BroadphaseBody* b = &bp->bodies[pair.b];
+            if (robots[a->index].asleep && robots[b->index].asleep) continue;
+            if (!pair_needs_test(world, pair, pass)) continue;
+            if (apply_robot_collision_response(stats, &robots[a->index], &robots[b->index], parts)) {
+                world->body_moved_pass[pair.a] = pass;
+                world->body_moved_pass[pair.b] = pass;
+                moved = true;
+            }
+        }
+
+        // Robot-wall collision response (only robots reaching a field edge)
+        wall_job.pass = pass;
+        job_system_parallel_for(world->jobs, (int)world->wall_bodies.size(), SIM_JOB_GRAIN_HEAVY,
+                                wall_response_job, &wall_job);
+        for (size_t k = 0; k < world->wall_bodies.size(); k++) {
+            if (!world->wall_corrected[k]) continue;
+            world->body_moved_pass[world->wall_bodies[k]] = pass;
+            moved = true;
+        }
+
+        // Robot-cylinder collision response
+        for (int p : world->cylinder_contacts) {
+            const BroadphasePair& pair = bp->pairs[p];
+            const BroadphaseBody* a = &bp->bodies[pair.a];
+            const BroadphaseBody* b = &bp->bodies[pair.b];
+            if (robots[a->index].asleep && scene->cylinders[b->index].asleep) continue;
+            if (!pair_needs_test(world, pair, pass)) continue;
+            if (apply_cylinder_collision_response(bvh, hits, stats, &robots[a->index], parts,
+                                                  scene->cylinders[b->index])) {
+                world->body_moved_pass[pair.b] = pass;
+                moved = true;
+            }
+        }
+
+        if (!moved) break;
+    }
+}
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+// Release all part tables
+static void sim_parts_clear(SimParts* parts) {
+    parts->transforms.clear();
+    parts->rest_obbs.clear();
+    parts->collision.clear();
+    parts->render.clear();
+    parts->collision_state.clear();
+    parts->info.clear();
+}
+
+// Bounds of an asset and the mesh-space OBB every part instance transforms
+static void set_asset_bounds(SimPartAsset* asset, const float* min_bounds, const float* max_bounds) {
+    float radius_sq = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        asset->min_bounds[k] = min_bounds[k];
+        asset->max_bounds[k] = max_bounds[k];
+        asset->center[k] = (min_bounds[k] + max_bounds[k]) * 0.5f;
+        asset->half_extents[k] = (max_bounds[k] - min_bounds[k]) * 0.5f;
+        radius_sq += asset->half_extents[k] * asset->half_extents[k];
+    }
+    asset->bound_radius = sqrtf(radius_sq);
+}
+
+// Parse the MPD of every scene robot (one job per robot)
+struct MpdLoadJobs {
+    const SimWorld* world;
+    const char* models_dir;
+    std::vector<MpdDocument>* docs;
+    std::vector<uint8_t>* loaded;
+};
+
+static void mpd_load_job(void* user_data, int index) {
+    MpdLoadJobs* jobs = (MpdLoadJobs*)user_data;
+    char mpd_path[1024];
+    snprintf(mpd_path, sizeof(mpd_path), "%s" PATH_SEP "robots" PATH_SEP "%s",
+             jobs->models_dir, jobs->world->scene.robots[index].mpd_file);
+    (*jobs->loaded)[index] = mpd_load(mpd_path, &(*jobs->docs)[index]) ? 1 : 0;
+}
+
+// Decode every unique part mesh (one job per GLB)
+struct MeshLoadJobs {
+    const char* models_dir;
+    const MeshCache* mesh_cache;
+    const char* const* names;
+    const int* cache_parts;   // Mesh cache entry of each name (-1 = not in the part index)
+    std::vector<MeshData>* meshes;
+};
+
+static void mesh_load_job(void* user_data, int index) {
+    MeshLoadJobs* jobs = (MeshLoadJobs*)user_data;
+    const char* glb_name = jobs->names[index];
+    MeshData* mesh = &(*jobs->meshes)[index];
+    if (jobs->cache_parts[index] >= 0) {
+        mesh_cache_get(jobs->mesh_cache, jobs->cache_parts[index], mesh);
+        return;
+    }
+
+    char glb_path[1024];
+    snprintf(glb_path, sizeof(glb_path), "%s" PATH_SEP "parts" PATH_SEP "%s",
+             jobs->models_dir, glb_name);
+    if (!mesh_cache_load(jobs->mesh_cache, glb_path, glb_name, mesh)) {
+        memset(mesh, 0, sizeof(MeshData));
+    }
+}
+
+// Load the unique part meshes of all documents on the worker pool, then
+// build assets (and call the resolver) on this thread in first-use order.
+// Fills doc_assets[d][name_id] with the asset index of each interned part name.
+// Part names resolve through the mesh cache's part index; only names it
+// lacks (no cache, or a cache missing some GLBs) build a file name, kept in
+// the load arena with the other lookup scratch.
+// known: assets kept from a previous load by GLB name (sim_world_reload),
+// taken over without loading or resolving them again
+static void load_part_assets(SimWorld* world, const char* models_dir,
+                             const std::vector<MpdDocument>& docs,
+                             const std::vector<uint8_t>& docs_loaded,
+                             const SimAssetResolver* resolver, const SimKnownAssets* known, Arena* load,
+                             std::vector<std::vector<int>>* doc_assets) {
+    // Unique GLBs in first-use order; each document name is looked up once
+    const MeshCache* cache = &world->mesh_cache;
+    ArenaVector<const char*> names{ArenaAllocator<const char*>(load)};
+    ArenaVector<int> name_parts{ArenaAllocator<int>(load)};    // Mesh cache entry per name (-1 = none)
+    ArenaVector<int> part_names{ArenaAllocator<int>(load)};    // Mesh cache entry -> index into names
+    part_names.assign(cache->data ? cache->header->entry_count : 0, -1);
+    std::map<const char*, int, CStringLess, ArenaAllocator<std::pair<const char* const, int>>> seen{
+        CStringLess(), ArenaAllocator<std::pair<const char* const, int>>(load)};
+    const int NAME_UNSEEN = -1, NAME_MISSING = -2;
+    std::vector<std::vector<int>> doc_names(docs.size());  // name_id -> index into names
+    for (size_t d = 0; d < docs.size(); d++) {
+        if (!docs_loaded[d]) continue;
+        doc_names[d].assign(docs[d].name_count, NAME_UNSEEN);
+        for (uint32_t i = 0; i < docs[d].part_count; i++) {
+            uint32_t name_id = docs[d].parts[i].name_id;
+            if (doc_names[d][name_id] != NAME_UNSEEN) continue;
+            const char* part_name = mpd_part_name(&docs[d], name_id);
+            int part = mesh_cache_find_part(cache, part_name);
+            if (part >= 0) {
+                if (part_names[part] < 0) {
+                    part_names[part] = (int)names.size();
+                    names.push_back(cache->entries[part].glb_name);
+                    name_parts.push_back(part);
+                }
+                doc_names[d][name_id] = part_names[part];
+                continue;
+            }
+            if (cache->complete) {
+                doc_names[d][name_id] = NAME_MISSING;   // No GLB to open
+                continue;
+            }
+            const char* glb_name = part_name_to_glb(load, part_name);
+            auto it = seen.emplace(glb_name, (int)names.size());
+            if (it.second) {
+                names.push_back(glb_name);
+                name_parts.push_back(-1);
+            }
+            doc_names[d][name_id] = it.first->second;
+        }
+    }
+
+    // Only names no earlier load resolved are read
+    ArenaVector<const char*> load_names{ArenaAllocator<const char*>(load)};
+    ArenaVector<int> load_parts{ArenaAllocator<int>(load)};
+    ArenaVector<const SimPartAsset*> known_assets{ArenaAllocator<const SimPartAsset*>(load)};
+    known_assets.assign(names.size(), nullptr);
+    for (size_t n = 0; n < names.size(); n++) {
+        if (known) {
+            auto it = known->find(names[n]);
+            if (it != known->end()) known_assets[n] = &it->second;
+        }
+        if (!known_assets[n]) {
+            load_names.push_back(names[n]);
+            load_parts.push_back(name_parts[n]);
+        }
+    }
+
+    std::vector<MeshData> meshes(load_names.size());
+    MeshLoadJobs jobs = { models_dir, cache, load_names.data(), load_parts.data(), &meshes };
+    load_jobs_run((int)load_names.size(), mesh_load_job, &jobs, load_jobs_thread_count());
+
+    bool deferred = resolver && resolver->deferred;
+    size_t next_loaded = 0;
+    ArenaVector<int> name_assets{ArenaAllocator<int>(load)};   // Asset index per name (-1 = miss)
+    name_assets.assign(names.size(), -1);
+    for (size_t n = 0; n < names.size(); n++) {
+        if (known_assets[n]) {
+            name_assets[n] = (int)world->assets.size();
+            world->asset_index[names[n]] = name_assets[n];
+            world->assets.push_back(*known_assets[n]);
+            continue;
+        }
+        MeshData* mesh_data = &meshes[next_loaded++];
+        bool loaded = mesh_data->vertex_count > 0;
+
+        SimPartAsset asset;
+        memset(&asset, 0, sizeof(asset));
+        asset.mesh_id = -1;
+        if (loaded) {
+            set_asset_bounds(&asset, mesh_data->min_bounds, mesh_data->max_bounds);
+            asset.triangle_count = mesh_data_triangle_count(mesh_data);
+            if (resolver && !deferred) {
+                loaded = resolver->resolve(resolver->user_data, names[n], mesh_data, &asset);
+            }
+        }
+
+        if (!loaded) {
+            // File not found - store a miss
+            mesh_data_free(mesh_data);
+            world->asset_index[names[n]] = -1;
+            continue;
+        }
+
+        name_assets[n] = (int)world->assets.size();
+        world->asset_index[names[n]] = name_assets[n];
+        world->assets.push_back(asset);
+        if (deferred) {
+            SimPendingMesh pending;
+            pending.glb_name = names[n];
+            pending.mesh = *mesh_data;
+            world->pending_meshes.push_back(pending);
+        } else {
+            mesh_data_free(mesh_data);
+        }
+    }
+
+    doc_assets->assign(docs.size(), std::vector<int>());
+    for (size_t d = 0; d < docs.size(); d++) {
+        (*doc_assets)[d].resize(doc_names[d].size());
+        for (size_t n = 0; n < doc_names[d].size(); n++) {
+            int name = doc_names[d][n];
+            (*doc_assets)[d][n] = name >= 0 ? name_assets[name] : -1;
+        }
+    }
+}
+
+// Put a robot at its scene pose, at rest: drivetrain, wheel spin, cached
+// transforms, collision states and contact counts start over
+static void place_robot(RobotInstance* robot, const SceneRobot* scene_robot, float friction_coeff) {
+    robot->offset[0] = scene_robot->x;
+    robot->offset[1] = scene_robot->y;
+    robot->offset[2] = scene_robot->z;
+    robot->rotation_y = scene_robot->rotation_y * DEG_TO_RAD_CONST;
+
+    drivetrain_init(&robot->drivetrain);
+    // Ackermann geometry from the robotdef, else the defaults
+    if (robot->wheelbase > 0.0f) robot->drivetrain.config.wheelbase = robot->wheelbase * LDU_SCALE;
+    if (robot->max_steer_angle > 0.0f) robot->drivetrain.config.max_steer_angle = robot->max_steer_angle * DEG_TO_RAD_CONST;
+    drivetrain_set_position(&robot->drivetrain, scene_robot->x, scene_robot->z, robot->rotation_y);
+    drivetrain_set_friction(&robot->drivetrain, friction_coeff);
+
+    for (int w = 0; w < robot->wheel_count; w++) robot->wheels[w].spin_angle = 0.0f;
+    robot->pose_version = 0;
+    std::fill(robot->submodel_obb_version.begin(), robot->submodel_obb_version.end(), 0u);
+    std::fill(robot->submodel_collision_state.begin(), robot->submodel_collision_state.end(), (uint8_t)COLLISION_NONE);
+    robot->step_contacts = 0;
+    robot->wall_contact_steps = 0;
+    robot->robot_contact_steps = 0;
+    robot->cylinder_contact_steps = 0;
+    wake_robot(robot);
+}
+
+// Load one scene robot (robotdef, config) and its parts from its parsed MPD
+// part_assets: asset index of each of the document's part names
+static bool load_robot(SimWorld* world, uint32_t scene_index, const char* models_dir,
+                       const MpdDocument* doc_ptr, bool doc_loaded, const std::vector<int>& part_assets) {
+    const SceneRobot* scene_robot = &world->scene.robots[scene_index];
+    SimParts& parts = world->parts;
+
+    // Build full path to MPD file
+    char mpd_path[1024];
+    snprintf(mpd_path, sizeof(mpd_path), "%s" PATH_SEP "robots" PATH_SEP "%s",
+             models_dir, scene_robot->mpd_file);
+
+    printf("\nLoading robot %u: %s at (%.1f, %.1f, %.1f) rot=%.1f°\n",
+           scene_index, scene_robot->mpd_file,
+           scene_robot->x, scene_robot->y, scene_robot->z, scene_robot->rotation_y);
+
+    if (!doc_loaded) {
+        fprintf(stderr, "  Failed to load: %s\n", mpd_path);
+        return false;
+    }
+    const MpdDocument& doc = *doc_ptr;
+
+    // Create robot instance
+    RobotInstance robot = {};
+    robot.ground_offset = 0.0f;  // Will compute after loading parts
+    robot.scene_index = (int)scene_index;
+    robot_config_init(&robot.motor_config);
+    robot.has_robotdef = false;
+    robot.rotation_center[0] = 0.0f;
+    robot.rotation_center[1] = 0.0f;
+    robot.rotation_center[2] = 0.0f;
+    robot.rotation_axis[0] = 0.0f;
+    robot.rotation_axis[1] = 1.0f;  // Default: vertical rotation
+    robot.rotation_axis[2] = 0.0f;
+    robot.track_width = 0.0f;
+    robot.wheelbase = 0.0f;
+    robot.max_steer_angle = 0.0f;
+    robot.drive_type = DRIVETRAIN_TANK;
+
+    // Try to load robotdef file (kept for the submodel joints)
+    char robotdef_path[1024];
+    RobotDef def;
+    bool def_loaded = false;
+    {
+        // Replace .mpd extension with .robotdef
+        strncpy(robotdef_path, mpd_path, sizeof(robotdef_path) - 1);
+        robotdef_path[sizeof(robotdef_path) - 1] = '\0';
+        char* ext = strrchr(robotdef_path, '.');
+        if (ext) {
+            strcpy(ext, ".robotdef");
+        } else {
+            strncat(robotdef_path, ".robotdef", sizeof(robotdef_path) - strlen(robotdef_path) - 1);
+        }
+
+        def_loaded = robotdef_load(robotdef_path, &def);
+        if (def_loaded) {
+            robot.has_robotdef = true;
+            // Store rotation center (in LDU - will convert during rendering)
+            robot.rotation_center[0] = def.drivetrain.rotation_center[0];
+            robot.rotation_center[1] = def.drivetrain.rotation_center[1];
+            robot.rotation_center[2] = def.drivetrain.rotation_center[2];
+            // Store rotation axis
+            robot.rotation_axis[0] = def.drivetrain.rotation_axis[0];
+            robot.rotation_axis[1] = def.drivetrain.rotation_axis[1];
+            robot.rotation_axis[2] = def.drivetrain.rotation_axis[2];
+            robot.track_width = def.drivetrain.track_width;
+            robot.wheelbase = def.drivetrain.wheelbase;
+            robot.max_steer_angle = def.drivetrain.max_steer_angle;
+            robot.drive_type = drive_model_type(def.drivetrain.type);
+
+            // Load wheel assemblies
+            robot.wheel_count = def.wheel_count;
+            for (int w = 0; w < def.wheel_count && w < ROBOTDEF_MAX_WHEELS; w++) {
+                const RobotDefWheelAssembly* src = &def.wheel_assemblies[w];
+                WheelAssembly* dst = &robot.wheels[w];
+                dst->world_position[0] = src->world_position[0];
+                dst->world_position[1] = src->world_position[1];
+                dst->world_position[2] = src->world_position[2];
+                dst->spin_axis[0] = src->spin_axis[0];
+                dst->spin_axis[1] = src->spin_axis[1];
+                dst->spin_axis[2] = src->spin_axis[2];
+                dst->diameter_mm = src->outer_diameter_mm;
+                dst->spin_angle = 0.0f;
+                dst->is_left = src->is_left;
+                dst->part_count = src->part_count;
+                for (int p = 0; p < src->part_count && p < ROBOTDEF_MAX_WHEEL_PARTS; p++) {
+                    dst->part_ids[p] = intern_part_number(world, src->part_numbers[p]);
+                }
+            }
+
+            printf("  Loaded robotdef: rotation_center=[%.1f, %.1f, %.1f] LDU, rotation_axis=[%.1f, %.1f, %.1f], track_width=%.1f LDU, wheels=%d\n",
+                   robot.rotation_center[0], robot.rotation_center[1], robot.rotation_center[2],
+                   robot.rotation_axis[0], robot.rotation_axis[1], robot.rotation_axis[2],
+                   robot.track_width, robot.wheel_count);
+        } else {
+            printf("  No robotdef found (tried: %s)\n", robotdef_path);
+        }
+    }
+
+    // Drivetrain at the scene pose, sized by the robotdef
+    place_robot(&robot, scene_robot, world->scene.physics.friction_coeff);
+
+    // Load config file if specified in scene
+    if (scene_robot->config_file[0] != '\0') {
+        char config_path[1024];
+        snprintf(config_path, sizeof(config_path), "%s" PATH_SEP "robots" PATH_SEP "%s",
+                 models_dir, scene_robot->config_file);
+        if (robot_config_load(config_path, &robot.motor_config)) {
+            printf("  Loaded config: %s\n", scene_robot->config_file);
+        } else {
+            fprintf(stderr, "  Failed to load config: %s\n", config_path);
+        }
+    }
+
+    int current_robot_index = (int)world->robots.size();
+    world->robots.push_back(robot);
+    world->robot_names.emplace_back();
+
+    // Part number id of each interned part name
+    std::vector<int> part_ids(doc.name_count);
+    for (uint32_t n = 0; n < doc.name_count; n++) {
+        part_ids[n] = intern_part_number(world, mpd_part_name(&doc, n));
+    }
+
+    uint32_t submodel_count = doc.submodel_count;
+
+    // Resolve meshes for all parts in this robot
+    size_t robot_part_start = parts.size();
+    for (uint32_t i = 0; i < doc.part_count; i++) {
+        const MpdPart* part = &doc.parts[i];
+        int asset_index = part_assets[part->name_id];
+        if (asset_index < 0) continue;
+        const SimPartAsset* asset = &world->assets[asset_index];
+
+        PartInfo info;
+        memset(&info, 0, sizeof(info));
+        info.asset_index = asset_index;
+        info.part_id = part_ids[part->name_id];
+        memcpy(info.min_bounds, asset->min_bounds, sizeof(info.min_bounds));
+        memcpy(info.max_bounds, asset->max_bounds, sizeof(info.max_bounds));
+        info.position[0] = part->x;
+        info.position[1] = part->y;
+        info.position[2] = part->z;
+        memcpy(info.rotation, part->rotation, 9 * sizeof(float));
+
+        PartRender render;
+        memset(&render, 0, sizeof(render));
+        render.mesh_id = asset->mesh_id;
+        // Get color from LDraw color code
+        ldraw_get_color(part->color_code, &render.color[0], &render.color[1], &render.color[2]);
+        // Color 16 means "main color" - use default, don't override
+        render.has_color = (part->color_code != 16);
+        memcpy(render.bound_center, asset->center, sizeof(render.bound_center));
+        render.bound_radius = asset->bound_radius;
+
+        PartTransform transform;
+        memset(&transform, 0, sizeof(transform));
+        transform.robot_index = current_robot_index;
+        transform.wheel_index = -1;
+
+        // Store submodel index from MPD for hierarchical collision
+        PartCollision collision;
+        memset(&collision, 0, sizeof(collision));
+        collision.submodel_index = part->submodel_index;
+        if (collision.submodel_index >= (int)submodel_count) collision.submodel_index = (int)submodel_count - 1;
+
+        parts.info.push_back(info);
+        parts.render.push_back(render);
+        parts.transforms.push_back(transform);
+        parts.collision.push_back(collision);
+        parts.collision_state.push_back(COLLISION_NONE);
+        world->total_triangles += asset->triangle_count;
+    }
+
+    // Store submodel info from MPD before freeing it
+    RobotInstance& r = world->robots[current_robot_index];
+    r.submodel_count = (int)submodel_count;
+    r.parts_start_index = robot_part_start;
+    r.parts_count = parts.size() - robot_part_start;
+
+    // Initialize submodel tracking arrays
+    r.submodel_obbs.assign(submodel_count, OBB{});
+    r.submodel_collision_state.assign(submodel_count, COLLISION_NONE);
+    r.submodel_part_start.assign(submodel_count, 0);
+    r.submodel_part_count.assign(submodel_count, 0);
+    r.submodel_bvh_root.assign(submodel_count, -1);
+    r.submodel_joints.assign(submodel_count, SubmodelJoint{});
+    r.joint_order.assign(submodel_count, 0);
+    r.joint_moved.assign(submodel_count, 0);
+    r.submodel_world_obbs.assign(submodel_count, OBB{});
+    r.submodel_obb_version.assign(submodel_count, 0);
+
+    // Copy submodel names and part ranges from MPD
+    std::vector<std::string>& submodel_names = world->robot_names[current_robot_index].submodel_names;
+    submodel_names.resize(submodel_count);
+    for (uint32_t sm = 0; sm < submodel_count; sm++) {
+        submodel_names[sm] = doc.submodels[sm].name;
+        r.submodel_part_start[sm] = (int)doc.submodels[sm].part_start;
+        r.submodel_part_count[sm] = (int)doc.submodels[sm].part_count;
+    }
+
+    // Compute local OBBs and robot-local matrices for all parts in this robot
+    for (size_t pi = robot_part_start; pi < parts.size(); pi++) {
+        compute_part_local_obb(&parts.info[pi], &world->assets[parts.info[pi].asset_index], &parts.collision[pi],
+                               r.rotation_center);
+        build_part_local_matrix(&parts.info[pi], &r, nullptr, parts.transforms[pi].local_matrix);
+        parts.rest_obbs.push_back(parts.collision[pi].local_obb);
+    }
+
+    // Compute submodel OBBs from part OBBs, and a part BVH per submodel
+    for (int sm = 0; sm < r.submodel_count; sm++) {
+        compute_submodel_obb(&r, sm, parts.collision);
+        r.submodel_bvh_root[sm] = part_bvh_build(&world->part_bvh, parts.collision,
+                                                 r.parts_start_index + r.submodel_part_start[sm],
+                                                 r.submodel_part_count[sm]);
+    }
+
+    printf("  Submodels: %d, Parts with OBBs: %zu\n",
+           r.submodel_count, parts.size() - robot_part_start);
+
+    setup_submodel_joints(&r, &world->robot_names[current_robot_index], def_loaded ? &def : nullptr);
+    if (def_loaded) robotdef_free(&def);
+    if (r.joint_order_count > 0) printf("  Moving submodels: %d\n", r.joint_order_count);
+    setup_robot_sensors(world, &r, &world->robot_names[current_robot_index]);
+
+    // Compute ground offset for this robot
+    r.ground_offset = compute_ground_offset(parts.info, robot_part_start, parts.size());
+
+    // Adjust ground offset for rotation center Y position
+    // Rendering applies: wy = wy - pivot_gl_y + ground_offset
+    // The pivot_gl_y offset shifts all parts, so ground_offset must compensate
+    float pivot_gl_y = -r.rotation_center[1] * LDU_SCALE;
+    r.ground_offset += pivot_gl_y;
+
+    // Match parts to wheel assemblies by part number
+    int wheel_parts_matched = 0;
+    // Note: For now, use wheel 0 for left side, wheel 2 for right side (first of each)
+    // This makes all same-side wheels spin together (correct for tank drive)
+    int left_wheel_idx = -1, right_wheel_idx = -1;
+    for (int wi = 0; wi < r.wheel_count; wi++) {
+        if (r.wheels[wi].is_left && left_wheel_idx < 0) left_wheel_idx = wi;
+        if (!r.wheels[wi].is_left && right_wheel_idx < 0) right_wheel_idx = wi;
+    }
+
+    for (size_t pi = robot_part_start; pi < parts.size(); pi++) {
+        const PartInfo& p = parts.info[pi];
+        int& wheel_index = parts.transforms[pi].wheel_index;
+        // Check all wheels for matching part number
+        for (int wi = 0; wi < r.wheel_count; wi++) {
+            WheelAssembly& w = r.wheels[wi];
+            for (int wpi = 0; wpi < w.part_count; wpi++) {
+                if (p.part_id == w.part_ids[wpi]) {
+                    // Assign to left or right wheel based on part X position
+                    // Negative X = left side, Positive X = right side
+                    wheel_index = (p.position[0] < 0) ? left_wheel_idx : right_wheel_idx;
+                    if (wheel_index >= 0) wheel_parts_matched++;
+                    break;
+                }
+            }
+            if (wheel_index >= 0) break;
+        }
+    }
+
+    printf("  Loaded %zu parts, ground offset: %.3f inches (pivot_y: %.3f), wheel parts: %d\n",
+           parts.size() - robot_part_start,
+           r.ground_offset,
+           pivot_gl_y,
+           wheel_parts_matched);
+
+    return true;
+}
+
+// =============================================================================
+// Public API
+// =============================================================================
+
+// Drop meshes still waiting for a deferred resolver and unmap the cache
+static void release_pending_meshes(SimWorld* world) {
+    for (SimPendingMesh& pending : world->pending_meshes) {
+        mesh_data_free(&pending.mesh);
+    }
+    world->pending_meshes.clear();
+    world->pending_next = 0;
+    mesh_cache_close(&world->mesh_cache);
+}
+
+// Release robots, part tables, trees and interned names
+static void clear_world(SimWorld* world) {
+    world->robots.clear();
+    world->robot_names.clear();
+    sim_parts_clear(&world->parts);
+    world->assets.clear();
+    world->asset_index.clear();
+    world->part_numbers.clear();
+    world->part_number_ids.clear();
+    part_bvh_clear(&world->part_bvh);
+    for (DriveBatch& batch : world->drive_batches) drive_batch_clear(&batch);
+    world->contacts_cached = false;
+}
+
+static bool create_world(SimWorld* world, const Scene* scene, const char* models_dir,
+                         const SimAssetResolver* resolver, const SimKnownAssets* known) {
+    if (!world || !scene || !models_dir) return false;
+
+    if (resolver && !resolver->resolve) {
+        resolver = nullptr;
+    }
+
+    if (!scene_copy(&world->scene, scene)) return false;
+    world->shared = nullptr;
+    clear_world(world);
+    sim_world_wake_all(world);
+    world->field_half_width = SIM_FIELD_WIDTH / 2.0f;
+    world->field_half_depth = SIM_FIELD_DEPTH / 2.0f;
+    world->time = 0.0;
+    world->step_count = 0;
+    world->total_triangles = 0;
+    world->stats = SimStepStats{};
+    if (world->bvh_hits.empty()) sim_world_set_threads(world, 0);  // Not configured yet
+
+    release_pending_meshes(world);
+
+    // Scratch that lives until the robots are built
+    Arena load;
+    arena_init(&load, "load", SIM_LOAD_ARENA_SIZE);
+
+    // Parse all robot documents in parallel
+    uint32_t robot_count = world->scene.robot_count;
+    std::vector<MpdDocument> docs(robot_count);
+    std::vector<uint8_t> docs_loaded(robot_count, 0);
+    MpdLoadJobs mpd_jobs = { world, models_dir, &docs, &docs_loaded };
+    load_jobs_run((int)robot_count, mpd_load_job, &mpd_jobs, load_jobs_thread_count());
+
+    // Part meshes are read from the cooked cache, mapped only while loading
+    // (or until a deferred resolver has taken every mesh)
+    mesh_cache_prepare(&world->mesh_cache, models_dir);
+    std::vector<std::vector<int>> doc_assets;
+    load_part_assets(world, models_dir, docs, docs_loaded, resolver, known, &load, &doc_assets);
+
+    for (uint32_t i = 0; i < robot_count; i++) {
+        load_robot(world, i, models_dir, &docs[i], docs_loaded[i] != 0, doc_assets[i]);
+        if (docs_loaded[i]) mpd_free(&docs[i]);
+    }
+
+    sim_world_update_drivetrains(world);
+
+    if (world->pending_meshes.empty()) {
+        mesh_cache_close(&world->mesh_cache);
+    }
+#ifdef VEXIQ_PROFILE
+    arena_report(&load);
+#endif
+    arena_destroy(&load);
+    return true;
+}
+
+bool sim_world_create(SimWorld* world, const Scene* scene, const char* models_dir,
+                      const SimAssetResolver* resolver) {
+    return create_world(world, scene, models_dir, resolver, nullptr);
+}
+
+bool sim_world_reload(SimWorld* world, const Scene* scene, const char* models_dir,
+                      const SimAssetResolver* resolver) {
+    if (!world || !scene || !models_dir || world->shared) return false;
+
+    // Keep every resolved asset; meshes still pending (and misses) load again
+    size_t resolved = world->pending_meshes.empty() ? world->assets.size() : world->pending_next;
+    SimKnownAssets known;
+    for (const auto& entry : world->asset_index) {
+        if (entry.second >= 0 && (size_t)entry.second < resolved) known.emplace(entry.first, world->assets[entry.second]);
+    }
+
+    // New parts resolve right away: a reload adds few, and pending meshes are
+    // indexed like assets, which now start with the kept ones
+    SimAssetResolver immediate;
+    if (resolver) {
+        immediate = *resolver;
+        immediate.deferred = false;
+        resolver = &immediate;
+    }
+    size_t kept = known.size();
+    bool created = create_world(world, scene, models_dir, resolver, &known);
+    printf("[Sim] Reloaded %zu robots: %zu part meshes kept, %zu loaded\n", world->robots.size(),
+           kept, world->assets.size() > kept ? world->assets.size() - kept : (size_t)0);
+    return created;
+}
+
+bool sim_world_apply_scene(SimWorld* world, const Scene* scene, const SceneDiff* diff) {
+    if (!world || !scene || !diff || (diff->flags & SCENE_DIFF_ROBOTS)) return false;
+    if (scene->robot_count != world->scene.robot_count) return false;
+
+    uint32_t kept_cylinders = world->scene.cylinder_count;
+    if (!scene_resize_cylinders(&world->scene, scene->cylinder_count)) return false;
+
+    memcpy(world->scene.name, scene->name, sizeof(world->scene.name));
+    world->scene.physics = scene->physics;
+    memcpy(world->scene.robots, scene->robots, sizeof(SceneRobot) * scene->robot_count);
+
+    for (RobotInstance& robot : world->robots) {
+        if (diff->robot_moved[robot.scene_index]) {
+            place_robot(&robot, &scene->robots[robot.scene_index], scene->physics.friction_coeff);
+        } else {
+            drivetrain_set_friction(&robot.drivetrain, scene->physics.friction_coeff);
+        }
+    }
+    sim_world_update_drivetrains(world);
+
+    // Edited and new cylinders start over at their scene pose; the rest stay where they were pushed
+    for (uint32_t c = 0; c < scene->cylinder_count; c++) {
+        if (c >= kept_cylinders || diff->cylinder_changed[c]) {
+            world->scene.cylinders[c] = scene->cylinders[c];
+            wake_cylinder(&world->scene.cylinders[c]);
+        }
+    }
+    world->contacts_cached = false;
+    return true;
+}
+
+bool sim_world_create_shared(SimWorld* world, const SimWorld* source, const Scene* scene) {
+    if (!world || !source || !scene || source->shared) return false;
+
+    // Robots are matched to the template by scene index
+    if (scene->robot_count != source->scene.robot_count) return false;
+    for (uint32_t i = 0; i < scene->robot_count; i++) {
+        if (strcmp(scene->robots[i].mpd_file, source->scene.robots[i].mpd_file) != 0) return false;
+    }
+
+    release_pending_meshes(world);
+    clear_world(world);
+    if (!scene_copy(&world->scene, scene)) return false;
+    sim_world_wake_all(world);
+    world->shared = source;
+    world->field_half_width = source->field_half_width;
+    world->field_half_depth = source->field_half_depth;
+    world->time = 0.0;
+    world->step_count = 0;
+    world->total_triangles = source->total_triangles;
+    world->stats = SimStepStats{};
+    if (world->bvh_hits.empty()) sim_world_set_threads(world, 0);  // Not configured yet
+
+    // Copy only what a step writes; every cache starts stale
+    world->robots = source->robots;
+    for (RobotInstance& robot : world->robots) {
+        place_robot(&robot, &scene->robots[robot.scene_index], scene->physics.friction_coeff);
+    }
+    sim_world_update_drivetrains(world);
+    world->parts.collision = source->parts.collision;
+    for (PartCollision& part : world->parts.collision) part.obb_version = 0;
+    world->parts.collision_state.assign(world->parts.collision.size(), (uint8_t)COLLISION_NONE);
+    world->part_bvh = source->part_bvh;
+    for (PartBvhNode& node : world->part_bvh.nodes) node.obb_version = 0;
+    std::fill(world->part_bvh.leaf_batch_version.begin(), world->part_bvh.leaf_batch_version.end(), 0u);
+    return true;
+}
+
+void sim_world_destroy(SimWorld* world) {
+    if (!world) return;
+    world->shared = nullptr;
+    release_pending_meshes(world);
+    clear_world(world);
+    job_system_destroy(world->jobs);
+    world->jobs = nullptr;
+    world->bvh_hits.clear();
+    world->thread_stats.clear();
+    broadphase_free(&world->broadphase);
+    broadphase_free(&world->cylinder_broadphase);
+    scene_free(&world->scene);
+}
+
+void sim_world_set_threads(SimWorld* world, int thread_count) {
+    job_system_destroy(world->jobs);
+    world->jobs = nullptr;
+    if (thread_count <= 0) thread_count = job_system_default_threads();
+    if (thread_count > 1) world->jobs = job_system_create(thread_count);
+    world->bvh_hits.resize(job_system_thread_count(world->jobs));
+}
+
+int sim_world_resolve_meshes(SimWorld* world, const SimAssetResolver* resolver, int max_count) {
+    if (!world || world->pending_meshes.empty()) return 0;
+
+    size_t first = world->pending_next;
+    size_t end = world->pending_meshes.size();
+    if (max_count > 0 && first + (size_t)max_count < end) end = first + (size_t)max_count;
+
+    for (size_t a = first; a < end; a++) {
+        SimPendingMesh* pending = &world->pending_meshes[a];
+        SimPartAsset* asset = &world->assets[a];
+        if (resolver && resolver->resolve &&
+            !resolver->resolve(resolver->user_data, pending->glb_name.c_str(), &pending->mesh, asset)) {
+            asset->mesh_id = -1;
+        }
+        mesh_data_free(&pending->mesh);
+    }
+    world->pending_next = end;
+
+    // Hand the new mesh handles to their parts
+    for (size_t pi = 0; pi < world->parts.size(); pi++) {
+        int asset_index = world->parts.info[pi].asset_index;
+        if (asset_index >= (int)first && asset_index < (int)end) {
+            world->parts.render[pi].mesh_id = world->assets[asset_index].mesh_id;
+        }
+    }
+
+    if (world->pending_next == world->pending_meshes.size()) {
+        printf("Resolved %zu deferred part meshes\n", world->pending_meshes.size());
+        release_pending_meshes(world);
+    }
+    return (int)(end - first);
+}
+
+bool sim_world_meshes_pending(const SimWorld* world) {
+    return world && world->pending_next < world->pending_meshes.size();
+}
+
+// Per-step parallel job arguments
+struct SimStepJob {
+    SimWorld* world;
+    float dt;
+};
+
+// Motors below 1% brake like motors that are off (see drive_step)
+static bool robot_motors_on(const RobotInstance& robot) {
+    return fabsf(robot.drivetrain.left_motor_pct) >= 1.0f || fabsf(robot.drivetrain.right_motor_pct) >= 1.0f ||
+           fabsf(robot.drivetrain.strafe_motor_pct) >= 1.0f;
+}
+
+// Step the robots of one drive batch (begin/end index the batch)
+template <DrivetrainType Type>
+static void integrate_job(void* user_data, int begin, int end, int) {
+    SimStepJob* step = (SimStepJob*)user_data;
+    const DriveBatch& batch = step->world->drive_batches[drive_model_index(Type)];
+    for (int k = begin; k < end; k++) {
+        RobotInstance& robot = step->world->robots[batch.robots[k]];
+        if (robot.asleep && robot_motors_on(robot)) wake_robot(&robot);
+        if (!robot.asleep) drive_step<Type>(&robot.drivetrain, drive_batch_coeffs(batch, k), step->dt);
+        refit_robot_joints(step->world, &robot);
+    }
+}
+
+template <DrivetrainType Type>
+static void integrate_batch(SimWorld* world, SimStepJob* step) {
+    int count = (int)world->drive_batches[drive_model_index(Type)].robots.size();
+    if (count > 0) job_system_parallel_for(world->jobs, count, SIM_JOB_GRAIN_LIGHT, integrate_job<Type>, step);
+}
+
+void sim_world_update_drivetrains(SimWorld* world) {
+    for (DriveBatch& batch : world->drive_batches) drive_batch_clear(&batch);
+    for (size_t r = 0; r < world->robots.size(); r++) {
+        const RobotInstance& robot = world->robots[r];
+        drive_batch_add(&world->drive_batches[drive_model_index(robot.drive_type)], (int)r, &robot.drivetrain);
+    }
+}
+
+// Put a robot to sleep after resting long enough with its motors off
+static void update_robot_sleep(RobotInstance& robot, float dt) {
+    Drivetrain& drivetrain = robot.drivetrain;
+    bool still = !robot_motors_on(robot) &&
+                 fabsf(drivetrain.vel_x) < SIM_SLEEP_LINEAR_SPEED && fabsf(drivetrain.vel_z) < SIM_SLEEP_LINEAR_SPEED &&
+                 fabsf(drivetrain.angular_vel) < SIM_SLEEP_ANGULAR_SPEED;
+    if (!still) {
+        robot.still_time = 0.0f;
+        return;
+    }
+    robot.still_time += dt;
+    if (robot.still_time < SIM_SLEEP_SECONDS) return;
+
+    robot.asleep = true;
+    drivetrain.vel_x = 0.0f;
+    drivetrain.vel_z = 0.0f;
+    drivetrain.angular_vel = 0.0f;
+    drivetrain.yaw_slip = 0.0f;
+    drivetrain.linear_velocity = 0.0f;
+    drivetrain.left_wheel_vel = 0.0f;
+    drivetrain.right_wheel_vel = 0.0f;
+}
+
+// Sync drivetrain pose back to the robot for rendering, spin its wheels
+// and count contacts
+static void sync_robot(RobotInstance& robot, float dt, bool sleeping) {
+    robot.offset[0] = robot.drivetrain.pos_x;
+    robot.offset[2] = robot.drivetrain.pos_z;
+    robot.rotation_y = robot.drivetrain.heading;
+    if (sleeping && !robot.asleep) update_robot_sleep(robot, dt);
+
+    // Count the contacts of this step's collision response
+    if (robot.step_contacts & SIM_CONTACT_WALL) robot.wall_contact_steps++;
+    if (robot.step_contacts & SIM_CONTACT_ROBOT) robot.robot_contact_steps++;
+    if (robot.step_contacts & SIM_CONTACT_CYLINDER) robot.cylinder_contact_steps++;
+    robot.step_contacts = 0;
+    if (robot.asleep) return;   // Wheels are not turning
+
+    // Update wheel spin angles based on drivetrain velocity
+    for (int w = 0; w < robot.wheel_count; w++) {
+        WheelAssembly& wheel = robot.wheels[w];
+        // Get wheel velocity (left or right side)
+        float wheel_vel = wheel.is_left ?
+            robot.drivetrain.left_velocity :
+            robot.drivetrain.right_velocity;
+        // Convert diameter mm to radius in inches
+        float radius_in = (wheel.diameter_mm / 25.4f) / 2.0f;
+        if (radius_in > 0.0f) {
+            // Angular velocity = linear velocity / radius
+            float angular_vel = wheel_vel / radius_in;
+            // Account for spin axis direction: if axis points in negative
+            // principal direction, negate to keep consistent visual rotation
+            float ax = fabsf(wheel.spin_axis[0]);
+            float ay = fabsf(wheel.spin_axis[1]);
+            float az = fabsf(wheel.spin_axis[2]);
+            if (ax >= ay && ax >= az) {
+                if (wheel.spin_axis[0] < 0) angular_vel = -angular_vel;
+            } else if (ay >= ax && ay >= az) {
+                if (wheel.spin_axis[1] < 0) angular_vel = -angular_vel;
+            } else {
+                if (wheel.spin_axis[2] < 0) angular_vel = -angular_vel;
+            }
+            // During turning (opposite velocities), flip spin direction
+            if (robot.drivetrain.left_velocity * robot.drivetrain.right_velocity < 0) {
+                angular_vel = -angular_vel;
+            }
+            wheel.spin_angle += angular_vel * dt;
+            // Keep angle in reasonable range
+            while (wheel.spin_angle > 6.28318f) wheel.spin_angle -= 6.28318f;
+            while (wheel.spin_angle < -6.28318f) wheel.spin_angle += 6.28318f;
+        }
+    }
+}
+
+static void sync_job(void* user_data, int begin, int end, int) {
+    SimStepJob* step = (SimStepJob*)user_data;
+    for (int i = begin; i < end; i++) {
+        sync_robot(step->world->robots[i], step->dt, step->world->sleeping);
+    }
+}
+
+void sim_world_step(SimWorld* world, float dt) {
+    PROFILE_ZONE("step");
+    int robot_count = (int)world->robots.size();
+    SimStepJob step = { world, dt };
+    stats_begin(world);
+
+    // Cylinder positions before the step, to count the ones that moved
+    std::vector<float>& cylinder_start = world->cylinder_start;
+    cylinder_start.resize(world->scene.cylinder_count * 2);
+    for (uint32_t c = 0; c < world->scene.cylinder_count; c++) {
+        cylinder_start[c * 2] = world->scene.cylinders[c].x;
+        cylinder_start[c * 2 + 1] = world->scene.cylinders[c].z;
+    }
+
+    // =====================================================================
+    // Physics update order (a barrier between phases):
+    // 1. Update drivetrain physics, refit moved submodels    - parallel per robot, one drive type at a time
+    // 2. Apply OBB-based collision response                  - see run_collision_response
+    // 3. Sync positions for rendering, spin wheels           - parallel per robot
+    // 4. Cast sensors                                        - see sim_world_update_sensors
+    // Parallel phases only write their own robot, so results are bit-identical
+    // for any thread count.
+    // =====================================================================
+
+    // Step 1: Update drivetrain physics
+    {
+        PROFILE_ZONE("drivetrain");
+        integrate_batch<DRIVETRAIN_TANK>(world, &step);
+        integrate_batch<DRIVETRAIN_MECANUM>(world, &step);
+        integrate_batch<DRIVETRAIN_OMNI>(world, &step);
+        integrate_batch<DRIVETRAIN_ACKERMANN>(world, &step);
+    }
+
+    // Step 2: Apply collision response (walls, robots, cylinders)
+    {
+        PROFILE_ZONE("collision");
+        run_collision_response(world);
+    }
+
+    // Step 2b: Update cylinder physics (friction, position)
+    {
+        PROFILE_ZONE("cylinders");
+        update_cylinder_physics(&world->cylinder_broadphase, world->scene.cylinders, world->scene.cylinder_count, dt,
+                                world->field_half_width, world->field_half_depth, world->sleeping);
+        serial_stats(world)->broadphase_pairs += (uint32_t)world->cylinder_broadphase.pair_count;
+        for (uint32_t c = 0; c < world->scene.cylinder_count; c++) {
+            const SceneCylinder& cyl = world->scene.cylinders[c];
+            if (cyl.x != cylinder_start[c * 2] || cyl.z != cylinder_start[c * 2 + 1]) serial_stats(world)->cylinders_moved++;
+        }
+    }
+
+    // Step 3: Sync drivetrain positions back to robot for rendering
+    {
+        PROFILE_ZONE("sync");
+        job_system_parallel_for(world->jobs, robot_count, SIM_JOB_GRAIN_LIGHT, sync_job, &step);
+    }
+
+    // Step 4: Cast robot sensors at the new poses
+    {
+        PROFILE_ZONE("sensors");
+        sim_world_update_sensors(world);
+    }
+
+    stats_end(world);
+    for (const RobotInstance& robot : world->robots) world->stats.robots_asleep += robot.asleep ? 1 : 0;
+    for (uint32_t c = 0; c < world->scene.cylinder_count; c++) {
+        world->stats.cylinders_asleep += world->scene.cylinders[c].asleep ? 1 : 0;
+    }
+    world->time += dt;
+    world->step_count++;
+}
+
+void sim_world_set_sleeping(SimWorld* world, bool enabled) {
+    world->sleeping = enabled;
+    if (!enabled) sim_world_wake_all(world);
+}
+
+void sim_world_wake_all(SimWorld* world) {
+    for (RobotInstance& robot : world->robots) wake_robot(&robot);
+    for (uint32_t c = 0; c < world->scene.cylinder_count; c++) wake_cylinder(&world->scene.cylinders[c]);
+}
+
+void sim_world_set_motors(SimWorld* world, int robot_index, float left_pct, float right_pct) {
+    if (robot_index < 0 || robot_index >= (int)world->robots.size()) return;
+    drivetrain_set_motors(&world->robots[robot_index].drivetrain, left_pct, right_pct);
+}
+
+void sim_world_set_strafe(SimWorld* world, int robot_index, float strafe_pct) {
+    if (robot_index < 0 || robot_index >= (int)world->robots.size()) return;
+    drivetrain_set_strafe(&world->robots[robot_index].drivetrain, strafe_pct);
+}
+
+bool sim_world_set_joint_angle(SimWorld* world, int robot_index, int submodel, float angle) {
+    if (robot_index < 0 || robot_index >= (int)world->robots.size()) return false;
+    RobotInstance& robot = world->robots[robot_index];
+    if (submodel < 0 || submodel >= robot.submodel_count) return false;
+    SubmodelJoint* joint = &robot.submodel_joints[submodel];
+    if (joint->axis[0] == 0.0f && joint->axis[1] == 0.0f && joint->axis[2] == 0.0f) return false;
+
+    if (angle < joint->min_angle) angle = joint->min_angle;
+    if (angle > joint->max_angle) angle = joint->max_angle;
+    if (angle != joint->angle) {
+        joint->angle = angle;
+        joint->dirty = true;
+        robot.joints_dirty = true;
+        wake_robot(&robot);
+    }
+    return true;
+}
+
+int sim_world_find_submodel(const SimWorld* world, int robot_index, const char* name) {
+    if (robot_index < 0 || robot_index >= (int)world->robots.size() || !name) return -1;
+    const SimWorld* names = world->shared ? world->shared : world;
+    return find_submodel(&names->robot_names[robot_index], world->robots[robot_index].submodel_count, name);
+}
+
+void sim_world_detect_collisions(SimWorld* world) {
+    PROFILE_ZONE("detect");
+    run_hierarchical_collision_detection(world);
+}
+
+void sim_world_collision_response(SimWorld* world) {
+    stats_begin(world);
+    run_collision_response(world);
+    stats_end(world);
+}
+
+bool sim_world_check_robot_pair(SimWorld* world, int robot_a, int robot_b) {
+    int robot_count = (int)world->robots.size();
+    if (robot_a < 0 || robot_a >= robot_count || robot_b < 0 || robot_b >= robot_count || robot_a == robot_b) {
+        return false;
+    }
+    return check_robot_robot_collision(&world->part_bvh, &world->bvh_hits[0], &world->robots[robot_a], robot_a,
+                                       &world->robots[robot_b], robot_b, world->parts);
+}
+
+void sim_cylinders_update(Broadphase* bp, SceneCylinder* cylinders, uint32_t count, float dt,
+                          float field_half_width, float field_half_depth) {
+    update_cylinder_physics(bp, cylinders, count, dt, field_half_width, field_half_depth, true);
+}
+
+bool sim_world_robot_footprint(SimWorld* world, int robot_index, AABB* bounds) {
+    if (robot_index < 0 || robot_index >= (int)world->robots.size()) return false;
+    RobotInstance* robot = &world->robots[robot_index];
+    if (robot->submodel_count == 0) return false;
+    robot_footprint(robot, bounds);
+    return true;
+}
+
+bool sim_world_push_cylinder(SimWorld* world, SceneCylinder* cyl) {
+    SimStepStats stats = {};
+    float x = cyl->x, z = cyl->z, vel_x = cyl->vel_x, vel_z = cyl->vel_z;
+    for (RobotInstance& robot : world->robots) {
+        if (robot.submodel_count == 0) continue;
+        apply_cylinder_collision_response(&world->part_bvh, &world->bvh_hits[0], &stats, &robot, world->parts, *cyl);
+    }
+    return cyl->x != x || cyl->z != z || cyl->vel_x != vel_x || cyl->vel_z != vel_z;
+}
+
+int sim_world_robot_count(const SimWorld* world) {
+    return (int)world->robots.size();
+}
+
+bool sim_world_get_robot_pose(const SimWorld* world, int robot_index,
+                              float* x, float* z, float* heading) {
+    if (robot_index < 0 || robot_index >= (int)world->robots.size()) return false;
+    const Drivetrain* dt = &world->robots[robot_index].drivetrain;
+    if (x) *x = dt->pos_x;
+    if (z) *z = dt->pos_z;
+    if (heading) *heading = dt->heading;
+    return true;
+}
+
+uint32_t sim_world_cylinder_count(const SimWorld* world) {
+    return world->scene.cylinder_count;
+}
+
+const SceneCylinder* sim_world_get_cylinder(const SimWorld* world, uint32_t index) {
+    if (index >= world->scene.cylinder_count) return nullptr;
+    return &world->scene.cylinders[index];
+}
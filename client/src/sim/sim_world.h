@@ -0,0 +1,526 @@
+/*
+ * Simulation World
+ * Robot, part and cylinder physics state for one scene, independent of
+ * rendering, windowing and the Python bridge.
+ *
+ * Owns everything needed to step a match:
+ *   - Robots loaded from the scene (MPD + robotdef + config)
+ *   - Per-part local OBBs and per-submodel OBBs for hierarchical collision
+ *   - A part BVH per submodel for the narrow phase, refit when its joint moves
+ *   - Submodel joints from robotdef kinematics (arms, claws) driven by angle
+ *   - Drivetrain physics (one batched kernel per robotdef drive type, see
+ *     physics/drive_models.h), collision response and cylinder physics
+ *   - A uniform-grid broad phase shared by the robot, wall and cylinder passes
+ *   - Sleep states for parked robots and resting cylinders
+ *   - Distance and optical sensors from the robot config, cast each step (sim/raycast.h)
+ *
+ * Part meshes come from the cooked mesh cache (models/parts.meshcache, see
+ * render/mesh_cache.h) or their GLB files. MPD documents and the unique part
+ * meshes are loaded on a worker pool (render/load_jobs.h); per-robot step
+ * phases run on a persistent work-stealing pool (sim/job_system.h). An optional
+ * callback, always called on the creating thread, lets the GUI turn each
+ * mesh into its own render handle; headless tools only use bounds.
+ *
+ * A deferred resolver leaves meshes pending so the first frame can be drawn
+ * before they are all uploaded (parts keep mesh_id = -1 until resolved):
+ *   while (sim_world_meshes_pending(&world)) {
+ *       sim_world_resolve_meshes(&world, &resolver, 16);  // once per frame
+ *   }
+ *
+ * Usage:
+ *   SimWorld world;
+ *   sim_world_create(&world, &scene, models_dir, NULL);  // NULL = bounds only, no render meshes
+ *   sim_world_set_motors(&world, 0, 50.0f, 50.0f);
+ *   sim_world_step(&world, 1.0f / 60.0f);
+ *   sim_world_destroy(&world);
+ *
+ * Batch runs load a scene once and step many copies of it:
+ *   sim_world_create(&templ, &scene, models_dir, NULL);
+ *   sim_world_create_shared(&run, &templ, &run_scene);   // per run, no I/O
+ */
+
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+#include "../physics/broadphase.h"
+#include "../physics/drive_models.h"
+#include "../physics/drivetrain.h"
+#include "../physics/obb.h"
+#include "../physics/robotdef.h"
+#include "../physics/robot_config.h"
+#include "../scene/scene.h"
+#include "../scene/scene_reload.h"
+#include "../render/glb_loader.h"
+#include "../render/mesh_cache.h"
+#include "part_bvh.h"
+#include "job_system.h"
+#include "raycast.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// World scale: 1 unit = 1 inch
+// VEX IQ field is 8ft x 6ft = 96" x 72"
+#define SIM_FIELD_WIDTH 96.0f
+#define SIM_FIELD_DEPTH 72.0f
+
+// Wheel assembly for a robot (runtime data)
+struct WheelAssembly {
+    float world_position[3];   // LDU - center of wheel
+    float spin_axis[3];        // Rotation axis (normalized)
+    float diameter_mm;         // For calculating spin rate
+    float spin_angle;          // Current rotation angle (radians)
+    int part_ids[ROBOTDEF_MAX_WHEEL_PARTS];   // Interned part numbers (SimWorld::part_numbers)
+    int part_count;
+    bool is_left;
+};
+
+// Collision state for hierarchical detection
+enum CollisionState {
+    COLLISION_NONE = 0,       // No collision (green)
+    COLLISION_SUBMODEL = 1,   // Submodel boundary hit (yellow)
+    COLLISION_PART = 2,       // Part collision (red)
+    COLLISION_EXTERNAL = 3    // External object (orange)
+};
+
+// Contacts a robot had during one step (RobotInstance::step_contacts)
+#define SIM_CONTACT_WALL     0x01   // Pushed back from a field wall
+#define SIM_CONTACT_ROBOT    0x02   // Pushed apart from another robot
+#define SIM_CONTACT_CYLINDER 0x04   // Pushed a cylinder
+
+// Collision response passes per step, at most. The first pass tests every
+// candidate pair; each later pass re-tests only the pairs with a body the
+// previous pass moved, and the response stops once a pass moves nothing.
+#define SIM_RESPONSE_ITERATIONS 4
+
+// The response broad phase is kept across steps (warm start) while no body
+// has moved further than this since it was built. Half of BROADPHASE_MARGIN:
+// the rest still covers bodies pushed together within a step.
+#define SIM_CONTACT_REUSE_DISTANCE (BROADPHASE_MARGIN * 0.5f)
+
+// Sleeping: a robot with its motors off, or a cylinder, that stays under
+// these speeds for SIM_SLEEP_SECONDS goes to sleep. Sleeping bodies are not
+// integrated, pairs of sleeping bodies are not tested, and a step with every
+// body asleep skips collision response and cylinder physics. A body wakes
+// when its motors are turned on or a push moves it further than
+// SIM_SLEEP_WAKE_DISTANCE (shorter pushes, e.g. resting contacts at the
+// penetration tolerance, don't keep bodies awake).
+#define SIM_SLEEP_SECONDS 0.5f
+#define SIM_SLEEP_LINEAR_SPEED 0.05f     // inches/s
+#define SIM_SLEEP_ANGULAR_SPEED 0.005f   // radians/s
+#define SIM_SLEEP_WAKE_DISTANCE 0.001f   // inches
+
+// Work counters of one step (SimWorld::stats), for the HUD, the headless
+// summary and benchmarks. Counted per job thread and summed at the end of the
+// step, so they cost a few adds per test and stay exact with parallel phases.
+struct SimStepStats {
+    uint32_t broadphase_pairs;     // Candidate pairs of the response and cylinder passes
+    uint32_t broadphase_builds;    // Response broad-phase rebuilds (0 = cached pairs reused)
+    uint32_t submodel_tests;       // Submodel OBB tests against walls, robots and cylinders
+    uint32_t submodel_hits;        // Submodel tests that overlapped
+    uint32_t part_tests;           // Part OBB tests in part tree leaves (SAT / circle)
+    uint32_t corrections;          // Wall, robot and cylinder contacts that moved something
+    uint32_t response_iterations;  // Response passes run (at most SIM_RESPONSE_ITERATIONS)
+    uint32_t cylinders_moved;      // Cylinders whose position changed
+    uint32_t robots_asleep;        // Robots asleep after the step
+    uint32_t cylinders_asleep;     // Cylinders asleep after the step
+};
+
+// Joint of one submodel (robotdef kinematics), in robot-local OpenGL coordinates
+// Joints form a tree: a child follows its parent's transform, then rotates
+// about its own axis. Transforms are rebuilt lazily (sim_robot_update_joints)
+// and collision bounds refit only for submodels whose transform changed.
+struct SubmodelJoint {
+    int parent;               // Parent submodel (-1 = robot body)
+    float axis[3];            // Unit rotation axis (0 = rigid: follows its parent only)
+    float origin[3];          // Pivot (inches, relative to the rotation center)
+    float min_angle, max_angle;  // Radians
+    int motor_port;           // Motor driving the joint (0 = none)
+    float angle;              // Radians (sim_world_set_joint_angle)
+    bool dirty;               // angle changed since the transform was built
+    float rotation[9];        // Rest pose -> current pose, parents included (row-major)
+    float translation[3];
+    uint32_t version;         // Bumped whenever rotation/translation change (0 = rest pose)
+    uint32_t refit_version;   // version the collision bounds were refit for
+};
+
+// Simulated sensors (robot config sensors section); read from the last step
+#define SIM_MAX_ROBOT_SENSORS ROBOT_CONFIG_MAX_SENSORS
+#define SIM_SENSOR_DISTANCE_RANGE 39.37f   // Inches (1000 mm)
+#define SIM_SENSOR_DISTANCE_RADIUS 0.25f   // Shape cast radius approximating the beam (inches)
+#define SIM_SENSOR_OPTICAL_RANGE 3.94f     // Inches (100 mm proximity)
+#define SIM_SENSOR_CAMERA_FOV 60.0f        // Degrees, vertical
+#define SIM_SENSOR_CAMERA_RANGE 200.0f     // Inches (far plane)
+
+enum SimSensorType {
+    SIM_SENSOR_DISTANCE,
+    SIM_SENSOR_OPTICAL,         // Color / optical sensor: proximity and color of what it sees
+    SIM_SENSOR_CAMERA           // Rendered by the client (render/offscreen.h), never cast
+};
+
+// Sensor mounted on a robot, in robot-local OpenGL coordinates at rest pose
+struct SimSensor {
+    int port;
+    SimSensorType type;
+    int submodel;               // Mounting submodel, the ray follows its joint (-1 = robot body)
+    float origin[3];            // Ray origin (inches, relative to the rotation center)
+    float dir[3];               // Unit ray direction
+    float range;                // Inches
+    float radius;               // Shape cast radius (inches)
+    float fov;                  // Cameras: vertical field of view (radians)
+    SimRayHit reading;          // Last step's hit (object SIM_RAY_NONE: nothing in range)
+};
+
+// Robot instance (loaded from scene)
+struct RobotInstance {
+    float offset[3];      // World position offset (inches)
+    float rotation_y;     // Rotation around Y axis (radians)
+    float ground_offset;  // Computed ground offset for this robot
+    Drivetrain drivetrain; // Physics drivetrain for this robot
+    DrivetrainType drive_type; // Drive model (robotdef; unknown = tank)
+
+    int scene_index;          // Index into Scene::robots this robot was loaded from
+    RobotConfig motor_config; // Motor port assignments
+
+    // From robotdef
+    float rotation_center[3];  // Drivetrain center in LDU (converted to world coords for rotation)
+    float rotation_axis[3];    // Rotation axis (default: [0,1,0] = vertical)
+    float track_width;         // Track width in LDU
+    float wheelbase;           // Ackermann axle spacing in LDU (0 = default)
+    float max_steer_angle;     // Ackermann steer limit in degrees (0 = default)
+    bool has_robotdef;         // Whether robotdef was loaded
+
+    // Wheel assemblies
+    WheelAssembly wheels[ROBOTDEF_MAX_WHEELS];
+    int wheel_count;
+
+    // Hierarchical OBB collision data (in robot-local OpenGL coordinates).
+    // Per-submodel arrays all hold submodel_count entries (every MPD
+    // submodel), indexed by submodel index.
+    std::vector<OBB> submodel_obbs;                  // OBBs for each submodel
+    std::vector<uint8_t> submodel_collision_state;   // CollisionState per submodel (debug coloring)
+    int submodel_count;
+
+    // Part indices for each submodel (for hierarchical lookup)
+    std::vector<int> submodel_part_start;  // First part index for this submodel
+    std::vector<int> submodel_part_count;  // Number of parts in this submodel
+    std::vector<int> submodel_bvh_root;    // Part BVH root node (-1 = no parts)
+
+    // Submodel joints: joint_order lists the submodels that can move (a joint
+    // or a moving ancestor), parents first
+    std::vector<SubmodelJoint> submodel_joints;
+    std::vector<int> joint_order;          // joint_order_count entries used
+    int joint_order_count;
+    std::vector<uint8_t> joint_moved;      // Scratch of sim_robot_update_joints
+    bool joints_dirty;             // Some joint angle changed (see sim_robot_update_joints)
+    uint32_t shape_version;        // Bumped whenever a submodel's bounds are refit
+
+    // Sensors cast at the end of every step (sim_world_update_sensors)
+    SimSensor sensors[SIM_MAX_ROBOT_SENSORS];
+    int sensor_count;
+
+    // First part index in global parts array (for this robot)
+    size_t parts_start_index;
+    size_t parts_count;
+
+    // Cached world transform (see sim_robot_update_transform)
+    float pose_x, pose_y, pose_z;  // World position the cache was built for (y includes ground offset)
+    float pose_rotation_y;
+    float world_rotation[9];       // Y rotation (row-major)
+    uint32_t pose_version;         // Bumped whenever the pose changes (0 = never built)
+    std::vector<OBB> submodel_world_obbs;
+    std::vector<uint32_t> submodel_obb_version;
+
+    // Contact statistics: steps with at least one contact of each kind
+    uint8_t step_contacts;            // SIM_CONTACT_* flags of the step in progress
+    uint32_t wall_contact_steps;
+    uint32_t robot_contact_steps;
+    uint32_t cylinder_contact_steps;
+
+    // Sleep state (SIM_SLEEP_*)
+    float still_time;                 // Seconds at rest with motors off
+    bool asleep;                      // Skips integration until woken
+};
+
+// Part tables (structure of arrays). Every table has one entry per part and
+// is indexed by part index; each pass only touches the tables it needs.
+// Physics steps read PartCollision, rendering reads PartTransform and
+// PartRender, and PartInfo holds load-time and debug data. Shared worlds
+// (sim_world_create_shared) only have the tables a step writes.
+
+// Model matrices (render)
+struct PartTransform {
+    float world_matrix[16];   // Cached world model matrix (column-major, OpenGL space)
+    uint32_t matrix_version;  // Robot pose_version of world_matrix (0 = stale)
+    float local_spin;         // Wheel spin angle local_matrix was built with
+    float local_matrix[16];   // Robot-local model matrix
+    int robot_index;          // Which robot this part belongs to (-1 = no robot)
+    int wheel_index;          // Which wheel assembly this part belongs to (-1 = not a wheel)
+    uint32_t joint_version;   // Submodel joint version local_matrix was built with
+};
+
+// Collision bounds (physics)
+struct PartCollision {
+    OBB world_obb;            // Cached world-space OBB
+    uint32_t obb_version;     // Robot pose_version of world_obb (0 = stale)
+    int submodel_index;       // Which submodel this part belongs to (-1 = none)
+    OBB local_obb;            // OBB in robot-local OpenGL coordinates (joints applied)
+};
+
+// Draw parameters (render)
+struct PartRender {
+    int mesh_id;              // Handle returned by the asset resolver (-1 = none)
+    float color[3];           // RGB color (0-1)
+    bool has_color;           // Whether to apply color override
+    float bound_center[3];    // Mesh bounds center (GLB space), for culling
+    float bound_radius;       // Mesh bounds half diagonal
+};
+
+// Load-time and debug data (cold)
+struct PartInfo {
+    int asset_index;          // Index into SimWorld::assets
+    int part_id;              // Interned part number for wheel matching (SimWorld::part_numbers)
+    float min_bounds[3];      // Mesh bounding box (GLB/OpenGL space)
+    float max_bounds[3];
+    float position[3];        // Position in LDraw units (before robot offset)
+    float rotation[9];        // 3x3 rotation matrix (row-major)
+};
+
+struct SimParts {
+    std::vector<PartTransform> transforms;
+    std::vector<PartCollision> collision;
+    std::vector<PartRender> render;
+    std::vector<uint8_t> collision_state;  // CollisionState per part (debug coloring)
+    std::vector<PartInfo> info;
+    std::vector<OBB> rest_obbs;            // local_obb with every joint at rest (read when a joint moves)
+
+    size_t size() const { return collision.size(); }
+};
+
+// Debug names of a robot's submodels (cold, indexed like SimWorld::robots)
+struct RobotNames {
+    std::vector<std::string> submodel_names;
+};
+
+// Pose of a response broad-phase body when the broad phase was built
+struct SimContactPose {
+    float x, z;
+    float rotation;           // Robots: rotation_y (radians)
+    float radius;             // Robots: furthest footprint corner from (x, z)
+    uint32_t shape_version;   // Robots: RobotInstance::shape_version
+};
+
+// Resolved part asset (one per unique GLB file)
+struct SimPartAsset {
+    int mesh_id;              // Caller-defined mesh handle (-1 = no render mesh)
+    float min_bounds[3];
+    float max_bounds[3];
+    float center[3];          // Mesh-space OBB (bounds center and half extents), computed once
+    float half_extents[3];
+    float bound_radius;       // Bounding sphere around center
+    uint32_t triangle_count;
+};
+
+// Turn a loaded part mesh into a render mesh handle (out->mesh_id).
+// glb_name: part file name, mesh: geometry (only valid during the call);
+// out already holds the mesh bounds and triangle count.
+// Returns false to skip the part.
+typedef bool (*SimResolvePartFn)(void* user_data, const char* glb_name,
+                                 const MeshData* mesh, SimPartAsset* out);
+
+struct SimAssetResolver {
+    SimResolvePartFn resolve;
+    void* user_data;
+    bool deferred;            // Keep meshes pending for sim_world_resolve_meshes()
+};
+
+// Loaded mesh waiting for a deferred resolver
+struct SimPendingMesh {
+    std::string glb_name;
+    MeshData mesh;            // May borrow from SimWorld::mesh_cache
+};
+
+// Assets of an earlier load, reused by GLB name (sim_world_reload)
+typedef std::map<std::string, SimPartAsset, std::less<>> SimKnownAssets;
+
+// Simulation world
+struct SimWorld {
+    Scene scene = {};                     // Copy of the scene; cylinders are simulated in place
+    const SimWorld* shared = nullptr;     // Template of a shared world (holds its read-only tables)
+    std::vector<RobotInstance> robots;
+    std::vector<RobotNames> robot_names;        // Cold per-robot debug data
+    SimParts parts;
+    std::vector<SimPartAsset> assets;           // Unique resolved part assets
+    std::map<std::string, int, std::less<>> asset_index;   // GLB name -> index into assets (-1 = missing)
+    std::vector<std::string> part_numbers;      // Interned part numbers (no extension or c## suffix)
+    std::unordered_map<std::string, int> part_number_ids;  // Part number -> index into part_numbers
+
+    // Deferred mesh resolution (indexed like assets)
+    std::vector<SimPendingMesh> pending_meshes;
+    size_t pending_next = 0;                    // First asset not yet resolved
+    MeshCache mesh_cache = {};                  // Mapped while pending meshes borrow from it
+
+    float field_half_width;
+    float field_half_depth;
+    Broadphase broadphase = {};           // Response candidate pairs (cached across steps)
+    Broadphase cylinder_broadphase = {};  // Scratch candidate pairs of the cylinder pass
+    PartBvh part_bvh;       // Narrow-phase trees for all submodels
+
+    // Parallel step phases (jobs NULL = serial)
+    JobSystem* jobs = nullptr;
+    std::vector<PartBvhHits> bvh_hits;          // Part tree query results per job thread
+    std::vector<SimStepStats> thread_stats;     // Step counters per job thread (summed into stats)
+    std::vector<AABB> robot_bounds;             // Broad-phase robot footprints (indexed like robots)
+    std::vector<int> wall_bodies;               // Broad-phase robots reaching a wall
+    DriveBatch drive_batches[DRIVE_MODEL_COUNT];  // Robots by drive_model_index(drive_type)
+
+    // Response contacts (run_collision_response)
+    bool contacts_cached = false;               // broadphase holds reusable pairs
+    std::vector<SimContactPose> contact_poses;  // Per broad-phase body, at the build
+    std::vector<int> robot_contacts;            // Robot-robot pair indices of broadphase
+    std::vector<int> cylinder_contacts;         // Robot-cylinder pair indices of broadphase
+    std::vector<int> body_moved_pass;           // Per broad-phase body: last pass that moved it (-1 = none)
+    std::vector<uint8_t> wall_corrected;        // Per wall_bodies entry: corrected this pass
+    std::vector<float> cylinder_start;          // Cylinder x, z before the step (stats)
+
+    // Sensor casts of the step (sim_world_update_sensors), indexed alike
+    std::vector<SimRay> sensor_rays;
+    std::vector<SimRayHit> sensor_hits;
+    std::vector<std::vector<uint32_t>> ray_tested;  // Per job thread: bodies one ray has tested (bitset)
+    bool sleeping = true;                       // Resting bodies sleep (sim_world_set_sleeping)
+
+    double time;           // Simulated seconds since create
+    uint64_t step_count;
+    uint32_t total_triangles;
+    SimStepStats stats;    // Counters of the last step (or sim_world_collision_response)
+};
+
+// Load all robots of a scene. models_dir contains robots/ and parts/.
+// resolver may be NULL to read part bounds only (no render meshes).
+// Returns false only on invalid arguments; robots that fail to load are skipped.
+bool sim_world_create(SimWorld* world, const Scene* scene, const char* models_dir,
+                      const SimAssetResolver* resolver);
+
+// Create a physics-only world for scene from a template loaded by
+// sim_world_create (scene must place the same MPDs in the same order; poses,
+// physics and cylinders may differ). Robots, part collision data and part
+// trees are copied since a step writes their caches; part info, render
+// tables, assets and names stay in source, which must outlive world.
+// Nothing is read from disk. Returns false if the robots don't match.
+bool sim_world_create_shared(SimWorld* world, const SimWorld* source, const Scene* scene);
+
+// Rebuild a world loaded by sim_world_create for an edited scene. Robots
+// are loaded again from their MPDs, but part meshes the world already has
+// keep their assets and render handles: only parts new to the world are
+// read (from the mesh cache) and resolved, immediately even with a deferred
+// resolver. Shared worlds made from it must be created again.
+bool sim_world_reload(SimWorld* world, const Scene* scene, const char* models_dir,
+                      const SimAssetResolver* resolver);
+
+// Apply an edit that keeps the scene's robots (no SCENE_DIFF_ROBOTS) in place
+// of a reload: physics parameters, moved robots (placed at rest at their new
+// pose) and edited, added or removed cylinders. Works on template and shared
+// worlds alike. Returns false if the edit needs sim_world_reload.
+bool sim_world_apply_scene(SimWorld* world, const Scene* scene, const SceneDiff* diff);
+
+// Release all world state
+void sim_world_destroy(SimWorld* world);
+
+// Resolve up to max_count pending meshes (<= 0 = all) with a deferred resolver
+// and give their parts mesh handles. Returns the number resolved.
+int sim_world_resolve_meshes(SimWorld* world, const SimAssetResolver* resolver, int max_count);
+
+// True while a deferred resolver still has meshes to resolve
+bool sim_world_meshes_pending(const SimWorld* world);
+
+// Advance physics by dt seconds: drivetrains, collision response,
+// cylinder physics, then pose sync and wheel spin
+void sim_world_step(SimWorld* world, float dt);
+
+// Threads for the parallel step phases (<= 0 = hardware threads, 1 = serial)
+// sim_world_create uses hardware threads unless this was called before.
+// Results are bit-identical for any thread count.
+void sim_world_set_threads(SimWorld* world, int thread_count);
+
+// Enable or disable sleep states (enabled by default; disabling wakes every body)
+void sim_world_set_sleeping(SimWorld* world, bool enabled);
+
+// Wake every robot and cylinder, e.g. after moving them directly
+void sim_world_wake_all(SimWorld* world);
+
+// Set drivetrain motor percentages (-100 to 100) for a robot
+void sim_world_set_motors(SimWorld* world, int robot_index, float left_pct, float right_pct);
+
+// Set the sideways command (-100 to 100) of a mecanum or omni robot
+void sim_world_set_strafe(SimWorld* world, int robot_index, float strafe_pct);
+
+// Rebuild the drive batches from the robots' drivetrains, after changing a
+// DrivetrainConfig or friction directly (create and restore do this)
+void sim_world_update_drivetrains(SimWorld* world);
+
+// Set a submodel joint's angle (radians, clamped to its limits); the
+// submodel and its children are refit on the next step. Returns false if the
+// submodel has no joint.
+bool sim_world_set_joint_angle(SimWorld* world, int robot_index, int submodel, float angle);
+
+// Submodel index of a robot by name (e.g. "Arm.ldr"), -1 if not found
+int sim_world_find_submodel(const SimWorld* world, int robot_index, const char* name);
+
+// Make sure world->broadphase holds every robot and cylinder near its current
+// pose, rebuilding it if some body left its cached bounds (queries between
+// steps, such as raycasts, cull with it)
+void sim_world_update_broadphase(SimWorld* world);
+
+// Run hierarchical collision detection and update collision states
+// (debug visualization only - does not affect physics)
+void sim_world_detect_collisions(SimWorld* world);
+
+// Single phases of sim_world_step, for benchmarks and tools
+// Collision response of all robots and cylinders (SIM_RESPONSE_ITERATIONS
+// passes); fills world->stats like a step
+void sim_world_collision_response(SimWorld* world);
+
+// Hierarchical part test of two robots; updates their debug collision states
+bool sim_world_check_robot_pair(SimWorld* world, int robot_a, int robot_b);
+
+// Cylinder friction, integration, cylinder-cylinder and wall contacts for any
+// cylinder array (bp is scratch, zeroed or from an earlier call); resting
+// cylinders sleep as in a world step
+void sim_cylinders_update(Broadphase* bp, SceneCylinder* cylinders, uint32_t count, float dt,
+                          float field_half_width, float field_half_depth);
+
+// Robot-cylinder response for a cylinder simulated outside the world (the GPU
+// game-piece field): every robot it touches pushes it, robots don't move.
+// Returns true if the cylinder's position or velocity changed.
+bool sim_world_push_cylinder(SimWorld* world, SceneCylinder* cyl);
+
+// Floor footprint of a robot (union of its submodel OBBs, x/z in inches)
+// Returns false for an invalid index or a robot without collision bounds
+bool sim_world_robot_footprint(SimWorld* world, int robot_index, AABB* bounds);
+
+// Robot pose queries (x/z in inches, heading in radians)
+int sim_world_robot_count(const SimWorld* world);
+bool sim_world_get_robot_pose(const SimWorld* world, int robot_index,
+                              float* x, float* z, float* heading);
+
+// Cylinder state queries (positions are simulated in world->scene)
+uint32_t sim_world_cylinder_count(const SimWorld* world);
+const SceneCylinder* sim_world_get_cylinder(const SimWorld* world, uint32_t index);
+
+// Refresh a robot's cached world transform if its pose changed
+// Returns the current pose version
+uint32_t sim_robot_update_transform(RobotInstance* robot);
+
+// Rebuild the joint transforms of submodels whose angle (or a parent's) changed
+void sim_robot_update_joints(RobotInstance* robot);
+
+// Cached world-space OBBs and part model matrix (column-major 4x4).
+// Each is recomputed at most once per robot pose change.
+const OBB* sim_submodel_world_obb(RobotInstance* robot, int submodel_idx);
+const OBB* sim_part_world_obb(RobotInstance* robot, PartCollision* part);
+const float* sim_part_world_matrix(SimWorld* world, size_t part_index);
+
+#endif // SIM_WORLD_H
@@ -0,0 +1,209 @@
+/*
+ * World Snapshots Implementation
+ */
+
+#include "snapshot.h"
+#include <string.h>
+
+// Sections are 8-byte aligned so every struct can be read in place
+static size_t align8(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+static size_t robots_offset() {
+    return align8(sizeof(SimSnapshotHeader));
+}
+
+// Joint angles of every submodel, then their collision states
+static size_t joints_offset(const SimSnapshotHeader* header) {
+    return robots_offset() + align8(header->robot_count * sizeof(SimRobotState));
+}
+
+static size_t submodel_states_offset(const SimSnapshotHeader* header) {
+    return joints_offset(header) + align8(header->submodel_count * sizeof(float));
+}
+
+static size_t cylinders_offset(const SimSnapshotHeader* header) {
+    return submodel_states_offset(header) + align8(header->submodel_count);
+}
+
+static size_t parts_offset(const SimSnapshotHeader* header) {
+    return cylinders_offset(header) + align8(header->cylinder_count * sizeof(SceneCylinder));
+}
+
+static uint32_t total_submodels(const SimWorld* world) {
+    uint32_t count = 0;
+    for (const RobotInstance& robot : world->robots) count += (uint32_t)robot.submodel_count;
+    return count;
+}
+
+// Header of a snapshot of world (time and counters left out)
+static void fill_counts(const SimWorld* world, SimSnapshotHeader* header) {
+    header->robot_count = (uint32_t)world->robots.size();
+    header->cylinder_count = world->scene.cylinder_count;
+    header->part_count = (uint32_t)world->parts.collision_state.size();
+    header->submodel_count = total_submodels(world);
+}
+
+size_t sim_world_state_size(const SimWorld* world) {
+    SimSnapshotHeader header;
+    fill_counts(world, &header);
+    return parts_offset(&header) + align8(header.part_count);
+}
+
+void sim_world_save_state(const SimWorld* world, void* state, uint64_t tag) {
+    uint8_t* out = (uint8_t*)state;
+    SimSnapshotHeader* header = (SimSnapshotHeader*)out;
+    header->time = world->time;
+    header->step_count = world->step_count;
+    header->tag = tag;
+    header->stats = world->stats;
+    fill_counts(world, header);
+
+    SimRobotState* robots = (SimRobotState*)(out + robots_offset());
+    float* joint_angles = (float*)(out + joints_offset(header));
+    uint8_t* submodel_states = out + submodel_states_offset(header);
+    for (uint32_t r = 0; r < header->robot_count; r++) {
+        const RobotInstance& robot = world->robots[r];
+        SimRobotState& saved = robots[r];
+        saved.drivetrain = robot.drivetrain;
+        memcpy(saved.offset, robot.offset, sizeof(saved.offset));
+        saved.rotation_y = robot.rotation_y;
+        for (int w = 0; w < ROBOTDEF_MAX_WHEELS; w++) {
+            saved.wheel_spin[w] = w < robot.wheel_count ? robot.wheels[w].spin_angle : 0.0f;
+        }
+        for (int sm = 0; sm < robot.submodel_count; sm++) joint_angles[sm] = robot.submodel_joints[sm].angle;
+        saved.wall_contact_steps = robot.wall_contact_steps;
+        saved.robot_contact_steps = robot.robot_contact_steps;
+        saved.cylinder_contact_steps = robot.cylinder_contact_steps;
+        saved.still_time = robot.still_time;
+        saved.asleep = robot.asleep;
+        saved.step_contacts = robot.step_contacts;
+        if (robot.submodel_count > 0) memcpy(submodel_states, robot.submodel_collision_state.data(), robot.submodel_count);
+        joint_angles += robot.submodel_count;
+        submodel_states += robot.submodel_count;
+    }
+
+    if (header->cylinder_count > 0) {
+        memcpy(out + cylinders_offset(header), world->scene.cylinders, header->cylinder_count * sizeof(SceneCylinder));
+    }
+    if (header->part_count > 0) {
+        memcpy(out + parts_offset(header), world->parts.collision_state.data(), header->part_count);
+    }
+}
+
+bool sim_world_restore_state(SimWorld* world, const void* state) {
+    const uint8_t* in = (const uint8_t*)state;
+    const SimSnapshotHeader* header = (const SimSnapshotHeader*)in;
+    if (header->robot_count != world->robots.size() || header->cylinder_count != world->scene.cylinder_count ||
+        header->part_count != world->parts.collision_state.size() || header->submodel_count != total_submodels(world)) {
+        return false;
+    }
+
+    world->time = header->time;
+    world->step_count = header->step_count;
+    world->stats = header->stats;
+
+    // Pose caches are keyed on the pose itself, so they rebuild on next use;
+    // moved joints are refit on the next step
+    const SimRobotState* robots = (const SimRobotState*)(in + robots_offset());
+    const float* joint_angles = (const float*)(in + joints_offset(header));
+    const uint8_t* submodel_states = in + submodel_states_offset(header);
+    for (uint32_t r = 0; r < header->robot_count; r++) {
+        RobotInstance& robot = world->robots[r];
+        const SimRobotState& saved = robots[r];
+        robot.drivetrain = saved.drivetrain;
+        memcpy(robot.offset, saved.offset, sizeof(robot.offset));
+        robot.rotation_y = saved.rotation_y;
+        for (int w = 0; w < robot.wheel_count; w++) robot.wheels[w].spin_angle = saved.wheel_spin[w];
+        for (int k = 0; k < robot.joint_order_count; k++) {
+            int sm = robot.joint_order[k];
+            sim_world_set_joint_angle(world, (int)r, sm, joint_angles[sm]);
+        }
+        robot.wall_contact_steps = saved.wall_contact_steps;
+        robot.robot_contact_steps = saved.robot_contact_steps;
+        robot.cylinder_contact_steps = saved.cylinder_contact_steps;
+        robot.still_time = saved.still_time;
+        robot.asleep = saved.asleep;
+        robot.step_contacts = saved.step_contacts;
+        if (robot.submodel_count > 0) memcpy(robot.submodel_collision_state.data(), submodel_states, robot.submodel_count);
+        joint_angles += robot.submodel_count;
+        submodel_states += robot.submodel_count;
+    }
+
+    if (header->cylinder_count > 0) {
+        memcpy(world->scene.cylinders, in + cylinders_offset(header), header->cylinder_count * sizeof(SceneCylinder));
+    }
+    if (header->part_count > 0) {
+        memcpy(world->parts.collision_state.data(), in + parts_offset(header), header->part_count);
+    }
+    sim_world_update_drivetrains(world);   // Saved drivetrains carry their own config
+    return true;
+}
+
+// =============================================================================
+// Snapshot ring
+// =============================================================================
+
+static uint8_t* ring_slot(SimSnapshotRing* ring, int slot) {
+    return (uint8_t*)ring->buffer.data() + (size_t)slot * ring->stride;
+}
+
+static const uint8_t* ring_slot(const SimSnapshotRing* ring, int slot) {
+    return (const uint8_t*)ring->buffer.data() + (size_t)slot * ring->stride;
+}
+
+// Slot of the snapshot age steps before the newest (age < count)
+static int ring_age_slot(const SimSnapshotRing* ring, int age) {
+    return (ring->newest - age + ring->capacity) % ring->capacity;
+}
+
+bool sim_snapshot_ring_init(SimSnapshotRing* ring, const SimWorld* world, int capacity) {
+    ring->buffer.clear();
+    ring->stride = 0;
+    ring->capacity = 0;
+    ring->count = 0;
+    ring->newest = 0;
+    if (!world || capacity <= 0) return false;
+
+    ring->stride = sim_world_state_size(world);
+    ring->capacity = capacity;
+    ring->buffer.assign(ring->stride / sizeof(uint64_t) * (size_t)capacity, 0);
+    return true;
+}
+
+void sim_snapshot_ring_free(SimSnapshotRing* ring) {
+    std::vector<uint64_t>().swap(ring->buffer);
+    ring->stride = 0;
+    ring->capacity = 0;
+    ring->count = 0;
+    ring->newest = 0;
+}
+
+void sim_snapshot_ring_push(SimSnapshotRing* ring, const SimWorld* world, uint64_t tag) {
+    if (ring->capacity == 0 || sim_world_state_size(world) != ring->stride) return;
+    ring->newest = (ring->newest + 1) % ring->capacity;
+    if (ring->count < ring->capacity) ring->count++;
+    sim_world_save_state(world, ring_slot(ring, ring->newest), tag);
+}
+
+const SimSnapshotHeader* sim_snapshot_ring_get(const SimSnapshotRing* ring, int age) {
+    if (age < 0 || age >= ring->count) return NULL;
+    return (const SimSnapshotHeader*)ring_slot(ring, ring_age_slot(ring, age));
+}
+
+int sim_snapshot_ring_find(const SimSnapshotRing* ring, double time) {
+    if (ring->count == 0) return -1;
+    for (int age = 0; age < ring->count; age++) {
+        if (sim_snapshot_ring_get(ring, age)->time <= time) return age;
+    }
+    return ring->count - 1;
+}
+
+bool sim_snapshot_ring_rewind(SimSnapshotRing* ring, int age, SimWorld* world) {
+    const SimSnapshotHeader* header = sim_snapshot_ring_get(ring, age);
+    if (!header || !sim_world_restore_state(world, header)) return false;
+    ring->newest = ring_age_slot(ring, age + 1);
+    ring->count -= age + 1;
+    return true;
+}
@@ -0,0 +1,104 @@
+/*
+ * World Snapshots
+ * Save and restore the mutable state of a SimWorld, for rewinding a match
+ * and branching what-if runs from the middle of one.
+ *
+ * A snapshot is one flat buffer of plain structs: a header (time, step
+ * count, counters), then per robot its drivetrain, pose, wheel spin, contact
+ * counters and sleep state, the joint angles and debug collision states of
+ * every robot's submodels, the scene's cylinders and the per-part debug
+ * collision states. Geometry, part tables, trees and
+ * assets never change during a step and are not copied, so a save or
+ * restore is a few KB of memcpy and cheap enough for every step.
+ *
+ * A snapshot restores into the world it came from or any world with the
+ * same robots and cylinder count, e.g. another sim_world_create_shared copy
+ * of the same template, so a batch tool can fork many runs from one
+ * mid-match state:
+ *   std::vector<uint8_t> state(sim_world_state_size(&world));
+ *   sim_world_save_state(&world, state.data(), 0);
+ *   for each run: sim_world_restore_state(&run, state.data()); step run...
+ *
+ * A ring keeps the last capacity snapshots in one preallocated buffer:
+ *   SimSnapshotRing ring;
+ *   sim_snapshot_ring_init(&ring, &world, 600);        // 10 s at 60 Hz
+ *   each step: sim_snapshot_ring_push(&ring, &world, tick); sim_world_step(&world, dt);
+ *   sim_snapshot_ring_rewind(&ring, sim_snapshot_ring_find(&ring, world.time - 5.0), &world);
+ *   sim_snapshot_ring_free(&ring);
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "sim_world.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Start of a snapshot buffer (followed by the robot, cylinder and part states)
+struct SimSnapshotHeader {
+    double time;                  // SimWorld::time
+    uint64_t step_count;
+    uint64_t tag;                 // Caller-defined (the GUI stores the robot programs' tick)
+    SimStepStats stats;
+    uint32_t robot_count;
+    uint32_t cylinder_count;
+    uint32_t part_count;
+    uint32_t submodel_count;      // Of all robots (robot by robot)
+};
+
+// Mutable state of one robot
+struct SimRobotState {
+    Drivetrain drivetrain;
+    float offset[3];
+    float rotation_y;
+    float wheel_spin[ROBOTDEF_MAX_WHEELS];
+    uint32_t wall_contact_steps;
+    uint32_t robot_contact_steps;
+    uint32_t cylinder_contact_steps;
+    float still_time;
+    bool asleep;
+    uint8_t step_contacts;
+};
+
+// Bytes of one snapshot of world
+size_t sim_world_state_size(const SimWorld* world);
+
+// Copy world's mutable state into state (sim_world_state_size bytes, 8-byte aligned)
+void sim_world_save_state(const SimWorld* world, void* state, uint64_t tag);
+
+// Overwrite world's mutable state from a saved one. Returns false (world
+// unchanged) if world doesn't have the snapshot's robot, submodel, cylinder
+// and part counts.
+bool sim_world_restore_state(SimWorld* world, const void* state);
+
+// Last capacity snapshots, oldest overwritten first
+struct SimSnapshotRing {
+    std::vector<uint64_t> buffer;   // capacity slots of stride bytes
+    size_t stride;
+    int capacity;
+    int count;                      // Snapshots held
+    int newest;                     // Slot of the newest one
+};
+
+// Allocate capacity snapshots of world's size. Returns false on invalid arguments.
+bool sim_snapshot_ring_init(SimSnapshotRing* ring, const SimWorld* world, int capacity);
+
+void sim_snapshot_ring_free(SimSnapshotRing* ring);
+
+// Save world as the newest snapshot (world must keep the size the ring was made for)
+void sim_snapshot_ring_push(SimSnapshotRing* ring, const SimWorld* world, uint64_t tag);
+
+// Snapshot age steps before the newest (0 = newest), NULL if not held
+const SimSnapshotHeader* sim_snapshot_ring_get(const SimSnapshotRing* ring, int age);
+
+// Age of the newest snapshot taken at or before time (the oldest one if
+// none is that old), -1 if the ring is empty
+int sim_snapshot_ring_find(const SimSnapshotRing* ring, double time);
+
+// Restore the snapshot age steps back and drop it and the newer ones, so the
+// run branches from there (the next push saves it again). Returns false if
+// it isn't held or doesn't fit world.
+bool sim_snapshot_ring_rewind(SimSnapshotRing* ring, int age, SimWorld* world);
+
+#endif // SNAPSHOT_H
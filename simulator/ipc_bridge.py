@@ -8,7 +8,9 @@ Protocol:
 ---------
 C++ → Python (stdin):
     {"type":"gamepad","axes":{"A":0,"B":0,"C":0,"D":0},"buttons":{...}}
-    {"type":"tick","dt":0.016}
+    {"type":"tick","dt":0.016,"seq":1,"sensors":[[4,3,152.4,1.0,0.0,0.0],...]}
+        sensors (optional): [port, object, distance_mm, r, g, b] per simulated
+        distance/optical sensor; object is vex_stub.SENSOR_OBJECT_* (0 = nothing)
     {"type":"shutdown"}
 
 Python → C++ (stdout):
@@ -17,8 +19,41 @@ Python → C++ (stdout):
     {"type":"ready"}
     {"type":"status","message":"Robot running"}
 
+Binary framing (--binary):
+    The per-frame gamepad/tick/state messages use compact binary frames
+    instead (layout in client/src/ipc/python_bridge.h):
+        u8 magic (0xB1), u8 type, u16 payload length (LE), payload
+    The "ready" message carries "protocol":"binary" to confirm. Other
+    messages stay JSON lines, and JSON input is still accepted. Robot code
+    print() output goes to stderr so it cannot split a frame.
+    Robot camera images (CAMERA frames) exist only in binary framing.
+
+Lockstep (--lockstep):
+    Robot code runs on simulated time (vex_stub.SimClock): each tick
+    advances the clock by dt, waits for the robot threads to block again,
+    then replies with the state and the tick's seq. Headless runs become
+    reproducible and can go faster than real time.
+
+Worker mode (--worker):
+    A pre-warmed pool process (client/src/ipc/python_pool.h). It imports
+    everything, announces itself and waits for a program:
+        Python → C++  {"type":"worker_ready"}
+        C++ → Python  {"type":"load","path":"robot.iqpython","lockstep":false}
+    The program then runs exactly as above until C++ sends
+        C++ → Python  {"type":"unload"}
+    which stops the robot threads at their next wait(), resets the vex stub
+    and sends worker_ready again. A worker whose robot code cannot be
+    stopped (never waits) exits instead and the pool replaces it.
+
+Embedded (vexiq_sim built with VEXIQ_EMBED_PYTHON):
+    No process and no pipe: the simulator runs embedded_main() in a
+    sub-interpreter on a thread per robot (client/src/ipc/python_embed.h).
+    EmbeddedBridge reads gamepad/tick input from and writes state into the
+    bridge's C structs through the built-in _vexiq_embed module.
+
 Usage:
-    python ipc_bridge.py <file.iqpython>
+    python ipc_bridge.py <file.iqpython> [--binary] [--lockstep]
+    python ipc_bridge.py --worker [--binary]
 """
 
 import sys
@@ -27,6 +62,7 @@ import json
 import threading
 import time
 import select
+import struct
 from pathlib import Path
 
 # Add simulator directory to path
@@ -35,25 +71,68 @@ sys.path.insert(0, str(Path(__file__).parent))
 from iqpython_parser import parse_iqpython, describe_robot, RobotConfig
 import vex_stub
 
+# Binary frame constants (must match client/src/ipc/python_bridge.h)
+FRAME_MAGIC = 0xB1
+FRAME_HEADER = struct.Struct('<BBH')
+FRAME_GAMEPAD = 1
+FRAME_TICK = 2
+FRAME_STATE = 3
+FRAME_CAMERA = 4
+
+GAMEPAD_PAYLOAD = struct.Struct('<4bB')
+TICK_PAYLOAD = struct.Struct('<fI')
+TICK_SENSOR = struct.Struct('<BBfBBB')
+STATE_COUNTS = struct.Struct('<BB')
+STATE_MOTOR = struct.Struct('<BBff')
+STATE_PNEUMATIC = struct.Struct('<BB')
+STATE_SEQ = struct.Struct('<I')
+CAMERA_HEADER = struct.Struct('<BHHI')
+
+GAMEPAD_BUTTONS = ("LUp", "LDown", "RUp", "RDown", "EUp", "EDown", "FUp", "FDown")
+
 
 class IPCBridge:
     """Bridge between C++ client and Python robot harness."""
 
-    def __init__(self, iqpython_path: str):
+    def __init__(self, iqpython_path: str, binary: bool = False, lockstep: bool = False):
         self.iqpython_path = Path(iqpython_path)
         self.config: RobotConfig = None
+        self.binary = binary
+        self.lockstep = lockstep
+        self._clock: vex_stub.SimClock = None
+        self._warned_stall = False
         self._running = False
         self._robot_thread = None
         self._controller: vex_stub.Controller = None
+        self._out = sys.__stdout__.buffer  # The real pipe, even after the redirect below
+        self._out_lock = threading.Lock()
+        self._in_buffer = bytearray()
+
+        if binary:
+            # Keep robot code print() off the IPC pipe
+            sys.stdout = sys.stderr
+
+    def _write(self, data: bytes):
+        """Write raw bytes to C++ (robot thread and main loop both send)."""
+        with self._out_lock:
+            self._out.write(data)
+            self._out.flush()
 
     def send_message(self, msg: dict):
         """Send a JSON message to C++ via stdout."""
         try:
             json_str = json.dumps(msg, separators=(',', ':'))
-            print(json_str, flush=True)
+            self._write(json_str.encode('utf-8') + b'\n')
         except Exception as e:
             self.log_error(f"Failed to send message: {e}")
 
+    def send_frame(self, frame_type: int, payload: bytes):
+        """Send a binary frame to C++ via stdout."""
+        try:
+            self._write(FRAME_HEADER.pack(FRAME_MAGIC, frame_type, len(payload)) + payload)
+        except Exception as e:
+            self.log_error(f"Failed to send frame: {e}")
+
     def log_error(self, msg: str):
         """Log error to stderr (not stdout which is for IPC)."""
         print(f"[IPC ERROR] {msg}", file=sys.stderr, flush=True)
@@ -73,6 +152,7 @@ class IPCBridge:
         self.send_message({
             "type": "ready",
             "project": self.config.project_name,
+            "protocol": "binary" if self.binary else "json",
             "motors": [{"port": m.port, "name": m.name} for m in self.config.motors],
             "motor_groups": [{"name": mg.name, "ports": mg.ports} for mg in self.config.motor_groups],
             "pneumatics": [{"port": p.port, "name": p.name} for p in self.config.pneumatics],
@@ -101,8 +181,54 @@ class IPCBridge:
         self._controller.buttonFUp.set_pressed(buttons.get("FUp", False))
         self._controller.buttonFDown.set_pressed(buttons.get("FDown", False))
 
+    def handle_gamepad_frame(self, payload: bytes):
+        """Handle a binary gamepad frame (same effect as handle_gamepad)."""
+        self.handle_gamepad_bits(*GAMEPAD_PAYLOAD.unpack_from(payload))
+
+    def handle_gamepad_bits(self, a: int, b: int, c: int, d: int, bits: int):
+        """Handle gamepad axes plus a button bit mask (GAMEPAD_BUTTONS order)."""
+        self.handle_gamepad({
+            "axes": {"A": a, "B": b, "C": c, "D": d},
+            "buttons": {name: bool(bits & (1 << i)) for i, name in enumerate(GAMEPAD_BUTTONS)},
+        })
+
+    def send_state_frame(self, seq: int):
+        """Send motor/pneumatic state as one binary frame."""
+        motors = vex_stub.Motor.get_all_instances()
+        pneumatics = vex_stub.Pneumatic.get_all_instances()
+
+        parts = [STATE_COUNTS.pack(len(motors), len(pneumatics))]
+        for port, motor in motors.items():
+            parts.append(STATE_MOTOR.pack(port, 1 if motor._spinning else 0,
+                                          motor.wheel_velocity, motor._position))
+        for port, pneu in pneumatics.items():
+            flags = (1 if pneu._extended else 0) | (2 if pneu._pump_on else 0)
+            parts.append(STATE_PNEUMATIC.pack(port, flags))
+        parts.append(STATE_SEQ.pack(seq & 0xFFFFFFFF))
+
+        self.send_frame(FRAME_STATE, b''.join(parts))
+
     def handle_tick(self, data: dict):
-        """Handle tick - send motor/pneumatic state back to C++."""
+        """Handle tick - update sensor readings, send motor/pneumatic state back to C++."""
+        sensors = data.get("sensors")
+        if sensors is not None:
+            vex_stub.set_sensor_readings(sensors)
+
+        if self._clock:
+            # Run robot code up to the new simulated time before sampling
+            if not self._clock.advance(float(data.get("dt", 0.0))) and not self._warned_stall:
+                self.log_error("Robot code did not reach a wait() within a tick; "
+                               "lockstep results depend on timing")
+                self._warned_stall = True
+
+        self.send_state(int(data.get("seq", 0)))
+
+    def send_state(self, seq: int):
+        """Send motor/pneumatic state for the tick seq."""
+        if self.binary:
+            self.send_state_frame(seq)
+            return
+
         # Collect motor states
         # Use wheel_velocity (logical wheel direction) not actual_velocity (physical motor direction)
         # The 'reversed' flag on motors compensates for physical mounting, but drivetrain
@@ -128,8 +254,70 @@ class IPCBridge:
             "type": "state",
             "motors": motors,
             "pneumatics": pneumatics,
+            "seq": seq,
         })
 
+    @staticmethod
+    def parse_tick_sensors(payload: bytes):
+        """Sensor readings after a TICK frame's dt/seq (None if the frame has none)."""
+        offset = TICK_PAYLOAD.size
+        if len(payload) <= offset:
+            return None
+        count = payload[offset]
+        offset += 1
+        sensors = []
+        for _ in range(count):
+            if offset + TICK_SENSOR.size > len(payload):
+                break
+            port, obj, distance, r, g, b = TICK_SENSOR.unpack_from(payload, offset)
+            sensors.append((port, obj, distance, r / 255.0, g / 255.0, b / 255.0))
+            offset += TICK_SENSOR.size
+        return sensors
+
+    def process_frame(self, frame_type: int, payload: bytes):
+        """Process a binary frame from C++."""
+        try:
+            if frame_type == FRAME_GAMEPAD:
+                self.handle_gamepad_frame(payload)
+            elif frame_type == FRAME_TICK:
+                if len(payload) >= TICK_PAYLOAD.size:
+                    dt, seq = TICK_PAYLOAD.unpack_from(payload)
+                else:
+                    dt, seq = struct.unpack_from('<f', payload)[0], 0  # No sequence number
+                self.handle_tick({"dt": dt, "seq": seq, "sensors": self.parse_tick_sensors(payload)})
+            elif frame_type == FRAME_CAMERA:
+                port, width, height, frame = CAMERA_HEADER.unpack_from(payload)
+                vex_stub.set_camera_image(port, width, height, frame, payload[CAMERA_HEADER.size:])
+            else:
+                self.log_error(f"Unknown frame type: {frame_type}")
+        except Exception as e:
+            self.log_error(f"Error processing frame: {e}")
+
+    def process_input(self, data: bytes):
+        """Split stdin data into binary frames and JSON lines."""
+        buf = self._in_buffer
+        buf.extend(data)
+        pos = 0
+        while pos < len(buf):
+            if buf[pos] == FRAME_MAGIC:
+                if len(buf) - pos < FRAME_HEADER.size:
+                    break
+                _, frame_type, length = FRAME_HEADER.unpack_from(buf, pos)
+                end = pos + FRAME_HEADER.size + length
+                if end > len(buf):
+                    break
+                self.process_frame(frame_type, bytes(buf[pos + FRAME_HEADER.size:end]))
+                pos = end
+            else:
+                newline = buf.find(b'\n', pos)
+                if newline < 0:
+                    break
+                line = buf[pos:newline].decode('utf-8', errors='replace').strip()
+                if line:
+                    self.process_message(line)
+                pos = newline + 1
+        del buf[:pos]
+
     def process_message(self, line: str):
         """Process a JSON message from C++."""
         try:
@@ -142,6 +330,8 @@ class IPCBridge:
                 self.handle_tick(msg)
             elif msg_type == "shutdown":
                 self._running = False
+            elif msg_type == "unload":
+                self._running = False  # Worker mode: back to the pool
             else:
                 self.log_error(f"Unknown message type: {msg_type}")
 
@@ -152,9 +342,6 @@ class IPCBridge:
 
     def execute_robot_code(self):
         """Execute the robot code from the .iqpython file."""
-        # Reset all stub state
-        vex_stub.reset_all()
-
         # Create a namespace for the robot code
         robot_globals = {
             '__name__': '__main__',
@@ -176,42 +363,70 @@ class IPCBridge:
             # Execute the robot code (may block forever with while True loop)
             exec(self.config.python_code, robot_globals)
 
+        except vex_stub.ProgramStopped:
+            pass  # Unloaded by the pool
         except Exception as e:
             self.log_error(f"Robot code error: {e}")
             self.send_message({"type": "error", "message": str(e)})
             import traceback
             traceback.print_exc(file=sys.stderr)
+        finally:
+            if self._clock:
+                self._clock.unregister_thread()
+
+    def run(self, pending: bytes = b'', pooled: bool = False):
+        """Main run loop.
 
-    def run(self):
-        """Main run loop."""
+        pending: stdin bytes already read (worker mode)
+        pooled: return to the worker loop on unload instead of shutting down
+        Returns stdin bytes read past the final message.
+        """
         self.load()
 
+        # Reset all stub state
+        vex_stub.reset_all()
+        if self.lockstep:
+            self._clock = vex_stub.use_sim_clock()
+            self._clock.register_thread()
+
         # Start robot code in a separate thread
         self._running = True
         self._robot_thread = threading.Thread(target=self.execute_robot_code, daemon=True)
         self._robot_thread.start()
 
-        # Give robot code a moment to initialize
-        time.sleep(0.2)
+        # Give robot code a moment to initialize (lockstep ticks wait for it instead)
+        if not self.lockstep:
+            time.sleep(0.2)
+
+        pending = self.serve(pending)
 
-        # Main loop - read stdin for messages
+        self._running = False
+        if not pooled:
+            self.send_message({"type": "shutdown"})
+            self.log_info("Bridge shutdown")
+        return pending
+
+    def serve(self, pending: bytes = b''):
+        """Read stdin for messages (raw bytes: frames and lines) until shutdown.
+
+        Returns stdin bytes read past the final message.
+        """
+        stdin_fd = sys.stdin.fileno()
+        if pending:
+            self.process_input(pending)
         while self._running:
             try:
                 # Non-blocking read with timeout
-                if sys.platform == 'win32':
-                    # Windows: use a simple blocking read with timeout via thread
-                    line = sys.stdin.readline()
-                    if not line:
-                        break
-                    self.process_message(line.strip())
-                else:
+                if sys.platform != 'win32':
                     # Unix: use select for non-blocking
-                    ready, _, _ = select.select([sys.stdin], [], [], 0.01)
-                    if ready:
-                        line = sys.stdin.readline()
-                        if not line:
-                            break
-                        self.process_message(line.strip())
+                    ready, _, _ = select.select([stdin_fd], [], [], 0.01)
+                    if not ready:
+                        continue
+                # Windows: blocking read (pipes can't be selected)
+                data = os.read(stdin_fd, 4096)
+                if not data:
+                    break
+                self.process_input(data)
 
             except KeyboardInterrupt:
                 break
@@ -219,14 +434,140 @@ class IPCBridge:
                 self.log_error(f"Main loop error: {e}")
                 break
 
-        self._running = False
-        self.send_message({"type": "shutdown"})
-        self.log_info("Bridge shutdown")
+        return bytes(self._in_buffer)
+
+
+def read_line(stdin_fd: int, buf: bytearray):
+    """Block until buf holds a complete line; return it (None at EOF)."""
+    while True:
+        newline = buf.find(b'\n')
+        if newline >= 0:
+            line = bytes(buf[:newline])
+            del buf[:newline + 1]
+            return line
+        data = os.read(stdin_fd, 4096)
+        if not data:
+            return None
+        buf.extend(data)
+
+
+def worker_main(binary: bool):
+    """Pre-warmed pool worker: run programs sent by the simulator, one at a time."""
+    out = sys.__stdout__.buffer
+    stdin_fd = sys.stdin.fileno()
+    buf = bytearray()
+
+    def announce():
+        out.write(b'{"type":"worker_ready"}\n')
+        out.flush()
+
+    announce()
+    while True:
+        line = read_line(stdin_fd, buf)
+        if line is None:
+            return
+        try:
+            msg = json.loads(line.decode('utf-8', errors='replace'))
+        except json.JSONDecodeError:
+            continue
+        msg_type = msg.get("type", "")
+        if msg_type == "shutdown":
+            return
+        if msg_type != "load":
+            continue  # Stray per-frame traffic from the previous run
+
+        bridge = IPCBridge(msg.get("path", ""), binary=binary, lockstep=bool(msg.get("lockstep")))
+        try:
+            buf = bytearray(bridge.run(bytes(buf), pooled=True))
+        except Exception as e:
+            bridge.log_error(f"Worker run failed: {e}")
+            bridge.send_message({"type": "error", "message": str(e)})
+
+        threads = [bridge._robot_thread] if bridge._robot_thread else []
+        if not vex_stub.stop_program(threads):
+            bridge.log_error("Robot code did not stop (no wait() in its loop); retiring worker")
+            os._exit(0)  # Daemon robot threads can't be joined; the pool respawns
+        vex_stub.reset_all()
+        announce()
+
+
+class EmbeddedBridge(IPCBridge):
+    """In-process harness: same robot handling, _vexiq_embed instead of stdin/stdout."""
+
+    def __init__(self, iqpython_path: str, lockstep: bool = False):
+        super().__init__(iqpython_path, binary=False, lockstep=lockstep)
+        import _vexiq_embed
+        self._embed = _vexiq_embed
+        vex_stub.set_camera_source(_vexiq_embed.camera)
+
+    def send_message(self, msg: dict):
+        """Hand ready/status/error/shutdown to the bridge (no JSON)."""
+        msg_type = msg.get("type", "")
+        text = self.config.project_name if msg_type == "ready" else msg.get("message", "")
+        self._embed.post(msg_type, str(text))
+
+    def send_state(self, seq: int):
+        """Write motor/pneumatic state straight into the bridge's RobotState."""
+        motors = [(port, motor._spinning, motor.wheel_velocity, motor._position)
+                  for port, motor in vex_stub.Motor.get_all_instances().items()]
+        pneumatics = [(port, pneu._extended, pneu._pump_on)
+                      for port, pneu in vex_stub.Pneumatic.get_all_instances().items()]
+        self._embed.set_state(seq, motors, pneumatics)
+
+    def serve(self, pending: bytes = b''):
+        """Wait for input from the simulator thread until the bridge stops."""
+        while self._running:
+            # Blocks with the GIL released; None on timeout
+            event = self._embed.wait(0.05)
+            if event is None:
+                continue
+            stop, gamepad, tick = event
+            if stop:
+                break
+            try:
+                if gamepad is not None:
+                    self.handle_gamepad_bits(*gamepad)
+                if tick is not None:
+                    self.handle_tick({"dt": tick[0], "seq": tick[1], "sensors": tick[2]})
+            except Exception as e:
+                self.log_error(f"Error processing input: {e}")
+        return b''
+
+
+def embedded_main(iqpython_path: str, lockstep: bool) -> bool:
+    """Run one robot program in the simulator process until it stops the bridge.
+
+    Returns False if the robot threads could not be stopped (the caller then
+    cannot end this interpreter).
+    """
+    bridge = EmbeddedBridge(iqpython_path, lockstep=lockstep)
+    try:
+        bridge.run()
+    except Exception as e:
+        bridge.log_error(f"Embedded run failed: {e}")
+        bridge._embed.post("error", str(e))
+        bridge._embed.post("shutdown", "")
+
+    threads = [bridge._robot_thread] if bridge._robot_thread else []
+    if not vex_stub.stop_program(threads):
+        bridge.log_error("Robot code did not stop (no wait() in its loop)")
+        return False
+    return True
 
 
 def main():
     """Main entry point."""
-    if len(sys.argv) < 2:
+    args = [a for a in sys.argv[1:] if not a.startswith('--')]
+    binary = '--binary' in sys.argv[1:]
+    lockstep = '--lockstep' in sys.argv[1:]
+
+    if '--worker' in sys.argv[1:]:
+        if binary:
+            sys.stdout = sys.stderr  # Robot code print() stays off the pipe
+        worker_main(binary)
+        return
+
+    if not args:
         # Try to find an .iqpython file
         search_paths = [
             Path(__file__).parent.parent,
@@ -242,16 +583,16 @@ def main():
                     break
 
         if not iqpython_file:
-            print("Usage: python ipc_bridge.py <file.iqpython>", file=sys.stderr)
+            print("Usage: python ipc_bridge.py <file.iqpython> [--binary] [--lockstep]", file=sys.stderr)
             sys.exit(1)
     else:
-        iqpython_file = Path(sys.argv[1])
+        iqpython_file = Path(args[0])
 
     if not iqpython_file.exists():
         print(f"Error: File not found: {iqpython_file}", file=sys.stderr)
         sys.exit(1)
 
-    bridge = IPCBridge(str(iqpython_file))
+    bridge = IPCBridge(str(iqpython_file), binary=binary, lockstep=lockstep)
     bridge.run()
 
 
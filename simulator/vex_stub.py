@@ -41,6 +41,112 @@ BRAKE = "brake"
 HOLD = "hold"
 
 
+# ============================================================
+# CLOCK - Wall time by default, simulated time in lockstep runs
+# ============================================================
+
+class SimClock:
+    """Simulated time driven by simulator ticks.
+
+    wait()/sleep() block until advance() has moved time past their deadline.
+    advance() returns once every registered robot thread is blocked again,
+    so state sampled after it is the same on every run.
+    """
+
+    def __init__(self):
+        self._cond = threading.Condition()
+        self._now = 0.0
+        self._active = 0          # Registered threads currently running
+        self._sleepers: list = [] # [deadline, woken] entries
+
+    def now(self) -> float:
+        """Simulated seconds since start."""
+        return self._now
+
+    def register_thread(self):
+        """Count a robot thread (call before starting it)."""
+        with self._cond:
+            self._active += 1
+
+    def unregister_thread(self):
+        """Robot thread finished."""
+        with self._cond:
+            self._active -= 1
+            self._cond.notify_all()
+
+    def sleep(self, seconds: float):
+        """Block the calling robot thread for simulated seconds."""
+        with self._cond:
+            entry = [self._now + max(seconds, 0.0), False]
+            self._sleepers.append(entry)
+            self._active -= 1
+            self._cond.notify_all()
+            while not entry[1]:
+                if _stop.is_set():
+                    # Running again until the thread unwinds and unregisters
+                    self._sleepers.remove(entry)
+                    self._active += 1
+                    raise ProgramStopped()
+                self._cond.wait()
+
+    def wake_all(self):
+        """Wake every sleeper so it can notice stop_program()."""
+        with self._cond:
+            self._cond.notify_all()
+
+    def advance(self, dt: float, timeout: float = 0.5) -> bool:
+        """Advance time by dt and wait (up to timeout wall seconds) for
+        woken threads to block again. Returns False on timeout."""
+        with self._cond:
+            # Threads still running (e.g. just started) block at the current time first
+            if not self._cond.wait_for(lambda: self._active <= 0, timeout):
+                return False
+
+            self._now += dt
+            pending = []
+            for entry in self._sleepers:
+                if entry[0] <= self._now + 1e-9:
+                    entry[1] = True
+                    self._active += 1
+                else:
+                    pending.append(entry)
+            self._sleepers = pending
+            self._cond.notify_all()
+            return self._cond.wait_for(lambda: self._active <= 0, timeout)
+
+
+_clock: Optional[SimClock] = None
+
+# Set by stop_program(); wait() raises ProgramStopped while it is set
+_stop = threading.Event()
+
+
+class ProgramStopped(BaseException):
+    """Raised inside robot threads blocked in wait() when the program is
+    stopped. Derives from BaseException so robot code's `except Exception`
+    does not swallow it."""
+
+
+def use_sim_clock() -> SimClock:
+    """Switch wait()/timers to simulated time (lockstep mode)."""
+    global _clock
+    _clock = SimClock()
+    return _clock
+
+
+def _now() -> float:
+    return _clock.now() if _clock else time.time()
+
+
+def _sleep(seconds: float):
+    if _stop.is_set():
+        raise ProgramStopped()
+    if _clock:
+        _clock.sleep(seconds)
+    elif _stop.wait(seconds):
+        raise ProgramStopped()
+
+
 # ============================================================
 # PORTS - Enum for port numbers
 # ============================================================
@@ -164,7 +270,7 @@ class Motor:
             duration = 1
 
         if wait_for:
-            time.sleep(duration)
+            _sleep(duration)
             self.stop()
 
     def stop(self, brake_mode=None):
@@ -369,7 +475,7 @@ class DriveTrain:
             duration = 1
 
         if wait_for:
-            time.sleep(duration)
+            _sleep(duration)
             self.stop()
 
     def turn(self, direction=RIGHT):
@@ -392,7 +498,7 @@ class DriveTrain:
         duration = angle / 90  # ~90 deg/sec at 50% speed
 
         if wait_for:
-            time.sleep(duration)
+            _sleep(duration)
             self.stop()
 
     def stop(self, brake_mode=None):
@@ -440,15 +546,15 @@ class BrainTimer:
     """Mock Brain timer."""
 
     def __init__(self):
-        self._start_time = time.time()
+        self._start_time = _now()
 
     def system(self) -> float:
         """Get system time in ms."""
-        return (time.time() - self._start_time) * 1000
+        return (_now() - self._start_time) * 1000
 
     def clear(self):
         """Reset timer."""
-        self._start_time = time.time()
+        self._start_time = _now()
 
 
 class Brain:
@@ -483,7 +589,7 @@ class Inertial:
         """Calibrate the sensor."""
         self._calibrating = True
         # Simulate brief calibration
-        time.sleep(0.1)
+        _sleep(0.1)
         self._calibrating = False
 
     def is_calibrating(self) -> bool:
@@ -505,6 +611,179 @@ class Inertial:
         return random.uniform(-1, 1)
 
 
+# ============================================================
+# DISTANCE / COLOR / OPTICAL SENSORS
+# ============================================================
+# Readings are cast by the simulator each step (client/src/sim/raycast.h)
+# and arrive with every tick; sensors on a port the robot's .config doesn't
+# list see nothing.
+
+SENSOR_OBJECT_NONE = 0
+SENSOR_OBJECT_FLOOR = 1
+SENSOR_OBJECT_WALL = 2
+SENSOR_OBJECT_CYLINDER = 3
+SENSOR_OBJECT_ROBOT = 4
+
+# Reported by object_distance() when nothing is in range
+_NO_OBJECT_DISTANCE_MM = 9999.0
+
+# port -> (object, distance_mm, (r, g, b))
+_sensor_readings: dict[int, tuple] = {}
+
+
+def set_sensor_readings(readings):
+    """Replace the sensor readings: (port, object, distance_mm, r, g, b) per sensor."""
+    global _sensor_readings
+    _sensor_readings = {int(r[0]): (int(r[1]), float(r[2]), (float(r[3]), float(r[4]), float(r[5])))
+                        for r in readings}
+
+
+def _sensor_reading(port: int) -> tuple:
+    return _sensor_readings.get(port, (SENSOR_OBJECT_NONE, -1.0, (0.0, 0.0, 0.0)))
+
+
+class Color:
+    """VEX color constants."""
+    BLACK = "black"
+    WHITE = "white"
+    RED = "red"
+    GREEN = "green"
+    BLUE = "blue"
+    YELLOW = "yellow"
+    ORANGE = "orange"
+    PURPLE = "purple"
+    TRANSPARENT = "transparent"
+
+
+def _named_color(rgb: tuple):
+    """Closest VEX color to an RGB color (0-1)."""
+    import colorsys
+    h, l, s = colorsys.rgb_to_hls(*rgb)
+    if s < 0.25:
+        return Color.WHITE if l >= 0.5 else Color.BLACK
+    hue = h * 360.0
+    for limit, name in ((15, Color.RED), (45, Color.ORANGE), (70, Color.YELLOW), (170, Color.GREEN),
+                        (260, Color.BLUE), (330, Color.PURPLE)):
+        if hue < limit:
+            return name
+    return Color.RED
+
+
+class DistanceSensor:
+    """Mock distance sensor, reading the simulated ray cast."""
+
+    def __init__(self, port: int):
+        self.port = port
+
+    def object_distance(self, unit=MM) -> float:
+        """Distance to the object in front of the sensor."""
+        obj, distance, _ = _sensor_reading(self.port)
+        if obj == SENSOR_OBJECT_NONE:
+            distance = _NO_OBJECT_DISTANCE_MM
+        return distance / 25.4 if unit == INCHES else distance
+
+    def is_object_detected(self) -> bool:
+        """Check if an object is in range."""
+        return _sensor_reading(self.port)[0] != SENSOR_OBJECT_NONE
+
+    def changed(self, callback: Callable):
+        """Register a change callback (not simulated)."""
+        pass
+
+
+Distance = DistanceSensor
+
+
+class ColorSensor:
+    """Mock color / optical sensor, reading the simulated ray cast."""
+
+    def __init__(self, port: int, *args):
+        self.port = port
+        self._light = 0
+
+    def color(self):
+        """Color of the object in front of the sensor."""
+        obj, _, rgb = _sensor_reading(self.port)
+        return _named_color(rgb) if obj != SENSOR_OBJECT_NONE else Color.TRANSPARENT
+
+    def is_near_object(self) -> bool:
+        """Check if an object is close to the sensor."""
+        return _sensor_reading(self.port)[0] != SENSOR_OBJECT_NONE
+
+    def brightness(self) -> float:
+        """Brightness of what the sensor sees (percent)."""
+        obj, _, rgb = _sensor_reading(self.port)
+        return max(rgb) * 100.0 if obj != SENSOR_OBJECT_NONE else 0.0
+
+    def hue(self) -> float:
+        """Hue of what the sensor sees (0-359 degrees)."""
+        import colorsys
+        obj, _, rgb = _sensor_reading(self.port)
+        return colorsys.rgb_to_hsv(*rgb)[0] * 360.0 if obj != SENSOR_OBJECT_NONE else 0.0
+
+    def set_light(self, value, unit=PERCENT):
+        """Set the sensor LED (no effect on readings)."""
+        self._light = value
+
+
+Optical = ColorSensor
+
+
+# ============================================================
+# ROBOT CAMERAS
+# ============================================================
+# Images rendered by the simulator from the "camera"/"vision" sensors of
+# the robot's .config (client/src/render/offscreen.h), RGB rows top to
+# bottom. Subprocess runs receive them as CAMERA frames; embedded runs pull
+# the latest one from the simulator on request.
+
+# port -> (width, height, frame, rgb bytes)
+_camera_images: dict[int, tuple] = {}
+_camera_source = None   # Embedded: callable(port) -> (width, height, frame, rgb) or None
+
+
+def set_camera_image(port: int, width: int, height: int, frame: int, rgb: bytes):
+    """Store the latest image of the camera on port."""
+    _camera_images[int(port)] = (int(width), int(height), int(frame), bytes(rgb))
+
+
+def set_camera_source(source):
+    """Read camera images through source(port) instead of set_camera_image."""
+    global _camera_source
+    _camera_source = source
+
+
+def _camera_image(port: int):
+    if _camera_source is not None:
+        return _camera_source(port)
+    return _camera_images.get(port)
+
+
+class Camera:
+    """Robot-mounted camera returning the latest simulated image."""
+
+    def __init__(self, port: int):
+        self.port = port
+
+    def image(self):
+        """(width, height, rgb bytes) of the latest image, or None before the first."""
+        image = _camera_image(self.port)
+        return None if image is None else (image[0], image[1], image[3])
+
+    def frame(self) -> int:
+        """Number of the latest image (-1 before the first)."""
+        image = _camera_image(self.port)
+        return -1 if image is None else image[2]
+
+    def pixel(self, x: int, y: int) -> tuple:
+        """(r, g, b) of a pixel of the latest image (0-255), black before the first."""
+        image = _camera_image(self.port)
+        if image is None or not (0 <= x < image[0] and 0 <= y < image[1]):
+            return (0, 0, 0)
+        i = (y * image[0] + x) * 3
+        return tuple(image[3][i:i + 3])
+
+
 # ============================================================
 # SMARTDRIVE CLASS (Drivetrain with inertial)
 # ============================================================
@@ -636,9 +915,9 @@ class Pneumatic:
 def wait(duration: float, unit=MSEC):
     """Wait for specified duration."""
     if unit == MSEC:
-        time.sleep(duration / 1000)
+        _sleep(duration / 1000)
     elif unit == SECONDS:
-        time.sleep(duration)
+        _sleep(duration)
 
 
 def sleep(duration: float, unit=MSEC):
@@ -649,11 +928,26 @@ def sleep(duration: float, unit=MSEC):
 class Thread:
     """Mock Thread class matching VEX API."""
 
+    _instances: list['Thread'] = []
+
     def __init__(self, callback: Callable):
         self._callback = callback
-        self._thread = threading.Thread(target=callback, daemon=True)
+        clock = _clock
+        if clock:
+            clock.register_thread()
+        self._thread = threading.Thread(target=self._run, args=(clock,), daemon=True)
+        Thread._instances.append(self)
         self._thread.start()
 
+    def _run(self, clock: Optional[SimClock]):
+        try:
+            self._callback()
+        except ProgramStopped:
+            pass
+        finally:
+            if clock:
+                clock.unregister_thread()
+
     def stop(self):
         """Stop the thread (not directly supported, thread must check a flag)."""
         pass
@@ -692,13 +986,35 @@ class urandom:
 # RESET FUNCTION - Clear all state
 # ============================================================
 
+def stop_program(threads: list, timeout: float = 1.0) -> bool:
+    """Stop running robot code: threads blocked in (or next calling) wait()
+    raise ProgramStopped. Joins threads (plus every vex Thread) and returns
+    True if all of them exited within timeout; code that never waits can't
+    be stopped."""
+    _stop.set()
+    if _clock:
+        _clock.wake_all()
+
+    deadline = time.time() + timeout
+    for thread in list(threads) + [t._thread for t in Thread._instances]:
+        thread.join(max(deadline - time.time(), 0.0))
+    return not any(t.is_alive() for t in threads) and \
+        not any(t._thread.is_alive() for t in Thread._instances)
+
+
 def reset_all():
     """Reset all mock state. Call before loading new robot code."""
+    global _clock
+    _clock = None
+    _stop.clear()
+    Thread._instances.clear()
     Motor._instances.clear()
     Controller._instance = None
     DriveTrain._instance = None
     Brain._instance = None
     MotorGroup._instances.clear()
     Pneumatic._instances.clear()
+    _sensor_readings.clear()
+    _camera_images.clear()
     CallbackRegistry._motor_callbacks.clear()
     CallbackRegistry._brain_callbacks.clear()